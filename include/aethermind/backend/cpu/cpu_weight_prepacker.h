@@ -8,21 +8,118 @@
 #include "aethermind/base/tensor.h"
 #include "aethermind/operators/op_type.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace aethermind {
 
+/// Byte layout of a kQuantizedInt8 or kQuantizedInt4 artifact for an
+/// [out_features, in_features] weight. Each row is split into groups of
+/// `group_size` input features (the last one may be shorter) sharing one
+/// float32 scale, and values are symmetric: w ~= q * scale. INT8 rows hold
+/// one int8 per feature; INT4 rows pack two per byte, the even feature in
+/// the low nibble. The rows come first, followed by the row-major
+/// [out_features, groups_per_row] scale table at `scales_offset`.
+struct CpuQuantizedWeightLayout {
+    static constexpr size_t kScalesAlignment = 64;
+
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t group_size = 0;
+    size_t groups_per_row = 0;
+    size_t row_bytes = 0;
+    size_t scales_offset = 0;
+    size_t nbytes = 0;
+
+    /// `group_size` 0 means one group per row, i.e. per-output-channel scales.
+    AM_NODISCARD static StatusOr<CpuQuantizedWeightLayout> Make(WeightFormat format,
+                                                                int64_t rows,
+                                                                int64_t cols,
+                                                                size_t group_size) noexcept;
+};
+
+/// Reconstruction error of a quantized weight against its source values.
+struct WeightQuantizationError {
+    float max_abs_error = 0.0F;
+    float rms_error = 0.0F;
+};
+
 class CpuWeightPrepacker {
 public:
+    /// Version of the packed byte layout this prepacker produces. Bump it
+    /// whenever Pack changes its output, so on-disk packed-weight caches
+    /// written by older builds are rebuilt instead of reused. Version 1 keeps
+    /// every weight in its logical row-major layout; version 2 adds the
+    /// CpuQuantizedWeightLayout artifacts of PackQuantized.
+    static constexpr uint32_t kFormatVersion = 2;
+    /// Every artifact's storage, packed or aliased, starts on at least this
+    /// boundary, so kernels may use aligned vector loads on it.
+    static constexpr size_t kStorageAlignment = 64;
+    /// Elements per GGML Q8_0/Q4_0 block, the group size of every artifact
+    /// PackQuantizedBlocks produces.
+    static constexpr size_t kGgmlBlockSize = 32;
+
     AM_NODISCARD StatusOr<std::unique_ptr<PackedWeights>> Pack(
             OpType op_type,
             const Tensor& logical_weight,
             const KernelSelector& selector) const noexcept;
 
+    /// Copies `logical_weight` into packed storage. The Pack* methods write
+    /// into `storage` when it is given, e.g. a PackedWeightArena slot, and
+    /// allocate otherwise; a given buffer must be writable, hold exactly the
+    /// packed byte count and be aligned as the layout requires.
     AM_NODISCARD StatusOr<std::unique_ptr<PackedWeights>> Pack(
+            OpType op_type,
+            TensorView logical_weight,
+            const KernelSelector& selector,
+            Buffer storage = {}) const noexcept;
+
+    /// Quantizes a rank-2 float32, float16 or bfloat16 weight into the
+    /// CpuQuantizedWeightLayout of `selector.weight_format`, which must be
+    /// kQuantizedInt8 or kQuantizedInt4. When `error` is non-null it receives
+    /// the reconstruction error over every element.
+    AM_NODISCARD StatusOr<std::unique_ptr<PackedWeights>> PackQuantized(
+            OpType op_type,
+            TensorView logical_weight,
+            const KernelSelector& selector,
+            size_t group_size,
+            WeightQuantizationError* error = nullptr,
+            Buffer storage = {}) const noexcept;
+
+    /// Converts a [rows, cols] weight quantized ahead of time in 32-element
+    /// blocks, each a little-endian float16 scale and its levels, into the
+    /// CpuQuantizedWeightLayout of `selector.weight_format` with a group
+    /// size of 32. kQuantizedInt8 reads GGML Q8_0 blocks and kQuantizedInt4
+    /// reads Q4_0 blocks. Levels and scales carry over exactly, so nothing
+    /// is requantized; Q4_0 levels span [-8, 7].
+    AM_NODISCARD StatusOr<std::unique_ptr<PackedWeights>> PackQuantizedBlocks(
+            OpType op_type,
+            const std::byte* blocks,
+            size_t nbytes,
+            int64_t rows,
+            int64_t cols,
+            const KernelSelector& selector,
+            Buffer storage = {}) const noexcept;
+
+    /// Whether the packed layout for `selector` is byte-identical to
+    /// `logical_weight`, so Alias can wrap it instead of Pack copying it:
+    /// the view is contiguous, already of the selector's weight dtype and
+    /// its data starts on a kStorageAlignment boundary.
+    AM_NODISCARD bool CanAlias(
             OpType op_type,
             TensorView logical_weight,
             const KernelSelector& selector) const noexcept;
+
+    /// Wraps `logical_weight` as packed weights without copying. `owner`
+    /// keeps the bytes alive for as long as the artifact exists, typically
+    /// the checkpoint mapping behind the view. Requires CanAlias. The storage
+    /// is read-only: its mutable_data() is nullptr.
+    AM_NODISCARD StatusOr<std::unique_ptr<PackedWeights>> Alias(
+            OpType op_type,
+            TensorView logical_weight,
+            const KernelSelector& selector,
+            std::shared_ptr<const void> owner) const noexcept;
 };
 
 }// namespace aethermind
@@ -25,19 +25,39 @@ enum class ExecPhase : uint8_t {
 enum class WeightFormat : uint8_t {
     kPlain = 0,
     kPacked,
+    /// CpuQuantizedWeightLayout artifacts. Storage only for now: no kernel
+    /// consumes them, so ExecutionPlanBuilder rejects nodes of these formats
+    /// with Unimplemented.
     kQuantizedInt8,
     kQuantizedInt4,
 };
 
+/// Order of the KV cache planes a kernel reads or writes. Head-major keeps
+/// each head's tokens contiguous ([layer][head][token][dim]) for decode scans;
+/// token-major keeps each token's heads contiguous ([layer][token][head][dim])
+/// for cheap appends. Kernels that do not touch the KV cache use kAny.
+enum class KVLayoutOrder : uint8_t {
+    kAny = 0,
+    kHeadMajor,
+    kTokenMajor,
+};
+
 AM_NODISCARD const char* ToString(IsaLevel isa) noexcept;
 AM_NODISCARD const char* ToString(ExecPhase phase) noexcept;
 AM_NODISCARD const char* ToString(WeightFormat format) noexcept;
+AM_NODISCARD const char* ToString(KVLayoutOrder order) noexcept;
 
 AM_NODISCARD inline bool PhaseMatches(ExecPhase candidate,
                                       ExecPhase request) noexcept {
     return candidate == request || candidate == ExecPhase::kBoth;
 }
 
+AM_NODISCARD inline bool KVLayoutMatches(KVLayoutOrder candidate,
+                                         KVLayoutOrder request) noexcept {
+    return candidate == request || candidate == KVLayoutOrder::kAny ||
+           request == KVLayoutOrder::kAny;
+}
+
 struct KernelSelector {
     DeviceType device_type = DeviceType::kUndefined;
     DataType act_dtype{};
@@ -45,6 +65,7 @@ struct KernelSelector {
     WeightFormat weight_format = WeightFormat::kPlain;
     IsaLevel isa = IsaLevel::kScalar;
     ExecPhase phase = ExecPhase::kBoth;
+    KVLayoutOrder kv_layout = KVLayoutOrder::kAny;
 
     friend bool operator==(const KernelSelector& lhs, const KernelSelector& rhs) noexcept {
         return lhs.device_type == rhs.device_type &&
@@ -52,7 +73,8 @@ struct KernelSelector {
                lhs.weight_dtype == rhs.weight_dtype &&
                lhs.weight_format == rhs.weight_format &&
                lhs.isa == rhs.isa &&
-               lhs.phase == rhs.phase;
+               lhs.phase == rhs.phase &&
+               lhs.kv_layout == rhs.kv_layout;
     }
 
     friend bool operator!=(const KernelSelector& lhs, const KernelSelector& rhs) {
@@ -67,6 +89,7 @@ AM_NODISCARD inline bool SelectorMatches(const KernelSelector& candidate,
            candidate.weight_dtype == request.weight_dtype &&
            candidate.weight_format == request.weight_format &&
            PhaseMatches(candidate.phase, request.phase) &&
+           KVLayoutMatches(candidate.kv_layout, request.kv_layout) &&
            candidate.isa <= request.isa;
 }
 
@@ -84,6 +107,7 @@ struct std::hash<aethermind::KernelSelector> {
         seed = aethermind::hash_combine(seed, static_cast<std::size_t>(s.weight_format));
         seed = aethermind::hash_combine(seed, static_cast<std::size_t>(s.isa));
         seed = aethermind::hash_combine(seed, static_cast<std::size_t>(s.phase));
+        seed = aethermind::hash_combine(seed, static_cast<std::size_t>(s.kv_layout));
         return seed;
     }
 };
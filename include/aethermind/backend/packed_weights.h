@@ -5,6 +5,8 @@
 #include "aethermind/memory/buffer.h"
 #include "aethermind/operators/op_type.h"
 
+#include <utility>
+
 namespace aethermind {
 
 // Packed weight artifacts are owned by ModelInstance backend sidecars.
@@ -19,6 +21,36 @@ public:
     AM_NODISCARD virtual const Buffer& storage() const noexcept = 0;
 };
 
+// Read-only artifact over a finished buffer. Prepackers return it for the
+// buffers they pack into or alias, and the packed-weight cache for the
+// buffers it maps.
+class BufferPackedWeights final : public PackedWeights {
+public:
+    BufferPackedWeights(OpType op_type,
+                        KernelSelector selector,
+                        Buffer storage) noexcept
+        : op_type_(op_type),
+          selector_(selector),
+          storage_(std::move(storage)) {}
+
+    AM_NODISCARD OpType op_type() const noexcept override {
+        return op_type_;
+    }
+
+    AM_NODISCARD const KernelSelector& selector() const noexcept override {
+        return selector_;
+    }
+
+    AM_NODISCARD const Buffer& storage() const noexcept override {
+        return storage_;
+    }
+
+private:
+    OpType op_type_ = OpType::kUnknown;
+    KernelSelector selector_{};
+    Buffer storage_{};
+};
+
 }// namespace aethermind
 
 #endif
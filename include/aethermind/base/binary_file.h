@@ -0,0 +1,76 @@
+#ifndef AETHERMIND_BASE_BINARY_FILE_H
+#define AETHERMIND_BASE_BINARY_FILE_H
+
+/// @file binary_file.h
+/// @brief Field-by-field record encoding and atomic publishing for the
+/// runtime's on-disk formats.
+///
+/// A format describes each record with a visitor, `visit(record, fn)`, that
+/// calls `fn` on every field in on-disk order. Records are encoded as those
+/// fields back to back in host byte order, without padding, so the file
+/// layout does not depend on the struct layout.
+#include "aethermind/base/status.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace aethermind {
+
+/// @brief Encoded size of a `Record` whose fields `visit` enumerates.
+template<typename Record, typename Visitor>
+constexpr size_t EncodedFieldBytes(Visitor visit) noexcept {
+    const Record record{};
+    size_t bytes = 0;
+    visit(record, [&](const auto& field) { bytes += sizeof(field); });
+    return bytes;
+}
+
+/// @brief Writes the fields of `record` to `out` and returns the end of the
+/// encoded bytes. `out` must hold EncodedFieldBytes<Record>(visit) bytes.
+template<typename Record, typename Visitor>
+std::byte* EncodeFields(const Record& record, Visitor visit, std::byte* out) noexcept {
+    visit(record, [&](const auto& field) {
+        std::memcpy(out, &field, sizeof(field));
+        out += sizeof(field);
+    });
+    return out;
+}
+
+/// @brief Appends the fields of `record` to `out`.
+template<typename Record, typename Visitor>
+void AppendFields(const Record& record, Visitor visit, std::vector<std::byte>& out) {
+    visit(record, [&](const auto& field) {
+        const auto* bytes = reinterpret_cast<const std::byte*>(&field);
+        out.insert(out.end(), bytes, bytes + sizeof(field));
+    });
+}
+
+/// @brief Reads the fields of `record` from `in` and returns the end of the
+/// decoded bytes. `in` must hold EncodedFieldBytes<Record>(visit) bytes.
+template<typename Record, typename Visitor>
+const std::byte* DecodeFields(Record& record, Visitor visit, const std::byte* in) noexcept {
+    visit(record, [&](auto& field) {
+        std::memcpy(&field, in, sizeof(field));
+        in += sizeof(field);
+    });
+    return in;
+}
+
+/// @brief Publishes a file at `path` atomically.
+///
+/// `write` fills a file staged next to `path` under a per-process name,
+/// which is then renamed into place, so concurrent writers and crashes never
+/// expose a partial file. On any failure the staged file is removed and
+/// `path` is left untouched. `description` names the file in error messages.
+Status WriteFileAtomically(const std::filesystem::path& path,
+                           std::string_view description,
+                           const std::function<Status(std::ofstream&)>& write);
+
+}// namespace aethermind
+
+#endif
@@ -11,21 +11,30 @@
 
 namespace aethermind {
 
+/// @brief Returns the OS page size, or 4096 if it cannot be queried.
+AM_NODISCARD size_t PageSize() noexcept;
+
 /// @brief Read-only memory-mapped file backed by mmap(2).
 ///
 /// Move-only RAII wrapper. The mapping is released on destruction or
 /// move-assignment. Provides byte-level access to the mapped region and
-/// an optional posix_madvise hint for OS read-ahead optimization.
+/// an optional madvise hint for OS read-ahead optimization.
 /// @note Not thread-safe. Concurrent access requires external synchronization.
 class MemoryMappedFile {
 public:
-    /// @brief OS-level access-pattern hints forwarded to posix_madvise.
+    /// @brief OS-level access-pattern hints forwarded to madvise.
     enum class Advice {
         kNormal,
         kRandom,
         kSequential,
         kWillNeed,
+        /// Unmaps the pages from this process; they stay in the page cache
+        /// and fault back in from it.
         kDontNeed,
+        /// Also reclaims the clean file pages no other process maps, so they
+        /// leave the page cache and fault back in from disk. Falls back to
+        /// kDontNeed on kernels without MADV_PAGEOUT.
+        kPageOut,
     };
 
     MemoryMappedFile() noexcept = default;
@@ -45,11 +54,20 @@ public:
     /// @brief Applies an OS-level access-pattern hint to the entire mapped range.
     /// @param advice The access-pattern hint to apply.
     /// @return Ok on success; kInvalidArgument if the mapping is invalid,
-    ///         kInternal if posix_madvise fails.
+    ///         kInternal if madvise fails.
     /// @note This is an optimization hint only; callers must not rely on it
     ///       for correctness.
     AM_NODISCARD Status Advise(Advice advice) const;
 
+    /// @brief Applies an access-pattern hint to `[offset, offset + length)`.
+    ///
+    /// The range is widened to whole pages, so a hint may also reach the
+    /// neighbouring bytes that share its first and last page.
+    /// @return Ok on success (including an empty range); kInvalidArgument if
+    ///         the mapping is invalid or the range exceeds it, kInternal if
+    ///         madvise fails.
+    AM_NODISCARD Status AdviseRange(size_t offset, size_t length, Advice advice) const;
+
     AM_NODISCARD const void* data() const noexcept {
         return data_;
     }
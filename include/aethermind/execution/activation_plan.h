@@ -0,0 +1,53 @@
+#ifndef AETHERMIND_EXECUTION_ACTIVATION_PLAN_H
+#define AETHERMIND_EXECUTION_ACTIVATION_PLAN_H
+
+#include "aethermind/base/macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aethermind {
+
+/// Arena slice assigned to one intermediate activation, identified by the
+/// step/output port that produces it.
+///
+/// Activations written in place over an input report the offset of that input.
+struct PlannedActivation {
+    size_t producer_step = 0;
+    uint32_t output_port = 0;
+    size_t bytes = 0;
+    size_t offset = 0;
+};
+
+/// Runtime activation memory plan for one lowered graph.
+///
+/// All intermediate activations share one arena of `total_bytes`. Callers
+/// build StepTensorBindings by slicing the arena at each activation offset;
+/// consumers read an activation through the binding of its producer.
+/// Activations are sorted by (producer_step, output_port) so that Find() can
+/// locate an entry in O(log N).
+struct ActivationPlan {
+    std::vector<PlannedActivation> activations{};
+
+    /// Peak arena size with liveness-based reuse and in-place aliasing.
+    size_t total_bytes = 0;
+
+    /// Arena size if every activation had its own slice.
+    size_t naive_total_bytes = 0;
+
+    /// Alignment the arena base pointer must satisfy.
+    size_t required_alignment = 1;
+
+    AM_NODISCARD bool empty() const noexcept;
+    AM_NODISCARD size_t size() const noexcept;
+
+    /// Returns the activation produced at `step_index`/`output_port`, or
+    /// nullptr if that output is not planned (model inputs, state outputs).
+    AM_NODISCARD const PlannedActivation* Find(size_t step_index,
+                                               uint32_t output_port) const noexcept;
+};
+
+}// namespace aethermind
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef AETHERMIND_EXECUTION_CHUNKED_PREFILL_H
+#define AETHERMIND_EXECUTION_CHUNKED_PREFILL_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/execution/execution_plan_family.h"
+#include "aethermind/execution/runtime_binding_context.h"
+
+#include <cstddef>
+
+namespace aethermind {
+
+/// Prompt positions [begin, begin + num_tokens) processed by one prefill step.
+struct PrefillChunk {
+    size_t begin = 0;
+    size_t num_tokens = 0;
+
+    AM_NODISCARD size_t end() const noexcept {
+        return begin + num_tokens;
+    }
+};
+
+/// Resumable prefill of one session in fixed-size chunks.
+///
+/// Each RunNextChunk() executes the plan bucket that covers the chunk and then
+/// commits its KV entries with KVCacheView::CommitUntil(), so the next chunk
+/// attends over every earlier prompt position. Activations and workspace are
+/// sized by the chunk rather than by the prompt when the family is built with
+/// `PlanBucketConfig::max_prefill_tokens == chunk_tokens`.
+///
+/// Progress lives in this object, so a scheduler may run decode steps of other
+/// sessions between two chunks. The caller binds the chunk's token slice
+/// (StepTensorBinding) before each RunNextChunk().
+class ChunkedPrefill {
+public:
+    /// @param prompt_len   Prompt tokens to prefill. Must be non-zero.
+    /// @param chunk_tokens Maximum tokens per chunk. Must be non-zero.
+    /// @param start_pos    Prompt tokens already committed, e.g. a reused prefix.
+    AM_NODISCARD static StatusOr<ChunkedPrefill> Create(size_t prompt_len,
+                                                        size_t chunk_tokens,
+                                                        size_t start_pos = 0);
+
+    AM_NODISCARD bool done() const noexcept;
+
+    /// Returns the chunk the next RunNextChunk() processes; empty once done().
+    AM_NODISCARD PrefillChunk next_chunk() const noexcept;
+
+    AM_NODISCARD size_t prompt_len() const noexcept;
+    AM_NODISCARD size_t chunk_tokens() const noexcept;
+    AM_NODISCARD size_t committed_tokens() const noexcept;
+
+    /// Number of chunks still to run.
+    AM_NODISCARD size_t remaining_chunks() const noexcept;
+
+    /// Runs next_chunk() through `family` and commits it to the bound KV cache.
+    ///
+    /// Publishes the chunk as RuntimeSequenceState::current_pos/step_tokens
+    /// while it runs. Fails with FailedPrecondition when prefill is done, no
+    /// KVCacheView is bound, or the view's committed position disagrees with
+    /// this prefill. Nothing is committed when execution fails, so the chunk
+    /// can be retried.
+    AM_NODISCARD Status RunNextChunk(const ExecutionPlanFamily& family,
+                                     RuntimeBindingContext& bindings) noexcept;
+
+private:
+    ChunkedPrefill(size_t prompt_len, size_t chunk_tokens, size_t start_pos) noexcept
+        : prompt_len_(prompt_len), chunk_tokens_(chunk_tokens), committed_(start_pos) {}
+
+    size_t prompt_len_ = 0;
+    size_t chunk_tokens_ = 0;
+    size_t committed_ = 0;
+};
+
+}// namespace aethermind
+
+#endif
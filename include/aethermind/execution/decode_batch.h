@@ -0,0 +1,87 @@
+#ifndef AETHERMIND_EXECUTION_DECODE_BATCH_H
+#define AETHERMIND_EXECUTION_DECODE_BATCH_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/execution/execution_plan_family.h"
+#include "aethermind/execution/runtime_binding_context.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace aethermind {
+
+/// Continuous-batching decode loop: the set of sessions whose next token is
+/// produced by one shared `[B, hidden]` step.
+///
+/// Sessions join once their prefill is committed and may join or leave
+/// between any two RunStep() calls; rows are packed in join order, so a
+/// Leave() shifts later sessions up by one row. Each session keeps its own
+/// KVCacheView and position, exposed to kernels as a DecodeBatchBinding.
+///
+/// Run the step through a family built by
+/// ExecutionPlanBuilder::BuildDecodeBatched(); the caller binds the B input
+/// tokens (StepTensorBinding) in row order before each RunStep().
+class DecodeBatch {
+public:
+    /// @param max_batch Most sessions decoded by one step. Must be non-zero.
+    AM_NODISCARD static StatusOr<DecodeBatch> Create(size_t max_batch);
+
+    /// Adds a session at the end of the batch.
+    ///
+    /// Fails with FailedPrecondition when `view` is invalid, the prompt is not
+    /// fully prefilled, or `state.current_pos` disagrees with the view's
+    /// committed position; with AlreadyExists for a duplicate `session_id`;
+    /// and with ResourceExhausted when the batch is full.
+    AM_NODISCARD Status Join(uint64_t session_id,
+                             const KVCacheView& view,
+                             const RuntimeSequenceState& state);
+
+    /// Removes a session; its KV reservation is left to the caller.
+    AM_NODISCARD Status Leave(uint64_t session_id);
+
+    AM_NODISCARD bool Contains(uint64_t session_id) const noexcept;
+
+    /// Row of `session_id` in the next step, or NotFound.
+    AM_NODISCARD StatusOr<size_t> Row(uint64_t session_id) const noexcept;
+
+    AM_NODISCARD StatusOr<RuntimeSequenceState> sequence_state(uint64_t session_id) const noexcept;
+
+    AM_NODISCARD std::span<const uint64_t> session_ids() const noexcept;
+    AM_NODISCARD std::span<const KVCacheView> kv_cache_views() const noexcept;
+
+    AM_NODISCARD size_t size() const noexcept;
+    AM_NODISCARD bool empty() const noexcept;
+    AM_NODISCARD size_t max_batch() const noexcept;
+
+    /// Decodes one token for every session through `family`, then commits it
+    /// to each session's KV cache and advances its sequence state.
+    ///
+    /// Binds the batch with RuntimeBindingContext::SetDecodeBatchBinding() and
+    /// publishes the batch size as RuntimeSequenceState::step_tokens while the
+    /// step runs. Blocks for the new positions are mapped before execution,
+    /// so a full KV pool fails with ResourceExhausted before any kernel runs.
+    /// Every row is validated before any is committed, so nothing is
+    /// committed when execution fails or a session's view went stale during
+    /// the step, and the step can be retried.
+    AM_NODISCARD Status RunStep(const ExecutionPlanFamily& family,
+                                RuntimeBindingContext& bindings) noexcept;
+
+private:
+    explicit DecodeBatch(size_t max_batch) noexcept : max_batch_(max_batch) {}
+
+    size_t max_batch_ = 0;
+    std::vector<uint64_t> session_ids_{};
+    std::vector<KVCacheView> views_{};
+    std::vector<RuntimeSequenceState> states_{};
+    // Decode position and sampling seed of every row during RunStep(); bound
+    // to kernels. Sized by Join() and Leave() so RunStep() never allocates.
+    std::vector<size_t> positions_{};
+    std::vector<uint64_t> sampling_seeds_{};
+};
+
+}// namespace aethermind
+
+#endif
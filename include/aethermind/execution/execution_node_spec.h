@@ -3,6 +3,7 @@
 
 #include "aethermind/backend/kernel_selector.h"
 #include "aethermind/dtypes/data_type.h"
+#include "aethermind/graph/graph_types.h"
 #include "aethermind/operators/op_params.h"
 #include "aethermind/operators/op_type.h"
 #include "aethermind/runtime/workspace.h"
@@ -11,6 +12,8 @@
 #include "aethermind/base/device.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace aethermind {
@@ -23,6 +26,15 @@ struct ExecutionPlanNodeSpec {
     WeightFormat weight_format = WeightFormat::kPlain;
     IsaLevel isa = IsaLevel::kScalar;
     ExecPhase phase = ExecPhase::kBoth;
+    /// KV plane order the kernel requires. Plan building fills kAny on
+    /// attention and KV update nodes with the runtime KV cache order.
+    KVLayoutOrder kv_layout = KVLayoutOrder::kAny;
+    /// Decoder layer and role of the node's weight input, filled by lowering
+    /// from its WeightBinding. Plan building resolves packed weights of
+    /// projection roles by this pair rather than by selector, so every layer
+    /// binds its own artifact.
+    std::optional<uint32_t> decoder_layer_index{};
+    std::optional<TransformerWeightRole> weight_role{};
     WorkspaceRequirement workspace_requirement{};
     /// Complete schema-port-ordered input specs, including state ports that
     /// do not contribute to runtime tensor bindings. Use MakeCompactInputSpecs
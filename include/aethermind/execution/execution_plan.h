@@ -9,6 +9,8 @@
 #include "aethermind/shape_inference/shape_constraint.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace aethermind {
@@ -22,24 +24,38 @@ struct ExecutionStep {
     std::vector<TensorSpec> output_specs{};
     std::vector<ShapeConstraint> runtime_checks{};
     const char* debug_name = nullptr;
+    /// Decoder layer the step belongs to; empty for steps outside the layer
+    /// stack (embedding, final norm, lm_head) and for hand-built plans.
+    std::optional<uint32_t> decoder_layer_index{};
 };
 
 class ExecutionPlan {
 public:
     AM_NODISCARD static StatusOr<ExecutionPlan> Create(
             std::vector<ExecutionStep> steps,
-            StateAliasPlan state_alias_plan = {});
+            StateAliasPlan state_alias_plan = {},
+            WorkspacePlanLayout workspace_layout = {});
 
     AM_NODISCARD const std::vector<ExecutionStep>& steps() const noexcept;
     AM_NODISCARD size_t size() const noexcept;
 
     AM_NODISCARD const StateAliasPlan& state_alias_plan() const noexcept;
 
+    /// Size and alignment of the workspace arena the step offsets were planned into.
+    AM_NODISCARD const WorkspacePlanLayout& workspace_layout() const noexcept;
+
+    /// Process-unique identity assigned by Create(). Copies share the id of
+    /// their source, so per-session caches keyed by it (ShapeCheckCache)
+    /// stay valid for any plan with the same steps.
+    AM_NODISCARD uint64_t id() const noexcept;
+
 private:
     Status AddStep(ExecutionStep step);
 
     std::vector<ExecutionStep> steps_{};
     StateAliasPlan state_alias_plan_{};
+    WorkspacePlanLayout workspace_layout_{};
+    uint64_t id_ = 0;
 };
 
 }// namespace aethermind
@@ -2,8 +2,10 @@
 #define AETHERMIND_BACKEND_EXECUTION_PLAN_BUILDER_H
 
 #include "aethermind/backend/kernel_selector.h"
+#include "aethermind/execution/activation_plan.h"
 #include "aethermind/execution/execution_node_spec.h"
 #include "aethermind/execution/execution_plan.h"
+#include "aethermind/execution/execution_plan_family.h"
 #include "aethermind/model/model_instance.h"
 #include "aethermind/runtime/runtime_context.h"
 
@@ -38,6 +40,46 @@ public:
             RuntimeContext& runtime,
             const ModelInstance& model_instance,
             const LoweredGraph& lowered);
+
+    /// Builds one ExecutionPlan per token-count bucket described by `config`.
+    /// Each bucket folds its sequence dimension where the range is exact,
+    /// drops runtime checks it discharges for the whole range, and resolves
+    /// kernels with the bucket phase (kDecode for one token, kPrefill above).
+    AM_NODISCARD static StatusOr<ExecutionPlanFamily> BuildBucketed(
+            RuntimeContext& runtime,
+            const LoweredGraph& lowered,
+            const PlanBucketConfig& config);
+
+    AM_NODISCARD static StatusOr<ExecutionPlanFamily> BuildBucketed(
+            RuntimeContext& runtime,
+            const ModelInstance& model_instance,
+            const LoweredGraph& lowered,
+            const PlanBucketConfig& config);
+
+    /// Builds the decode family described by `config`, whose buckets serve
+    /// batches of sessions that each contribute one token. Every bucket
+    /// resolves kernels with ExecPhase::kDecode, so row b of a step is
+    /// treated as its own sequence rather than as prompt position b.
+    AM_NODISCARD static StatusOr<ExecutionPlanFamily> BuildDecodeBatched(
+            RuntimeContext& runtime,
+            const LoweredGraph& lowered,
+            const DecodeBatchConfig& config);
+
+    AM_NODISCARD static StatusOr<ExecutionPlanFamily> BuildDecodeBatched(
+            RuntimeContext& runtime,
+            const ModelInstance& model_instance,
+            const LoweredGraph& lowered,
+            const DecodeBatchConfig& config);
+
+    /// Places the intermediate activations of `lowered` in one arena sized
+    /// for steps of up to `max_tokens` tokens, e.g. the largest bucket of a
+    /// family built from it. `seq_len` is resolved as in PlanBucketConfig.
+    /// Fails with InvalidArgument when an activation has another symbolic
+    /// dimension; see PlanActivationBuffers().
+    AM_NODISCARD static StatusOr<ActivationPlan> PlanActivations(
+            const LoweredGraph& lowered,
+            size_t max_tokens,
+            ShapeSymbol seq_len = ShapeSymbol::Unknown());
 };
 
 }// namespace aethermind
@@ -0,0 +1,98 @@
+#ifndef AETHERMIND_EXECUTION_EXECUTION_PLAN_FAMILY_H
+#define AETHERMIND_EXECUTION_EXECUTION_PLAN_FAMILY_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/execution/execution_plan.h"
+#include "aethermind/shape_inference/shape_symbol.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace aethermind {
+
+class SymbolConstraintSolver;
+
+/// Describes how ExecutionPlanBuilder::BuildBucketed() partitions the token
+/// count axis into specialized plans.
+///
+/// Buckets are inclusive token ranges. The optional decode bucket covers
+/// exactly one token; prefill buckets follow as [2, min_prefill_bucket],
+/// (min_prefill_bucket, 2 * min_prefill_bucket], ... until
+/// `max_prefill_tokens` is covered.
+struct PlanBucketConfig {
+    /// Symbolic sequence-length dimension shared by the lowered token inputs.
+    /// Unknown() derives it from dimension 0 of the first model input.
+    ShapeSymbol seq_len = ShapeSymbol::Unknown();
+
+    /// Emits a dedicated single-token plan selected with ExecPhase::kDecode.
+    bool include_decode = true;
+
+    /// Upper bound of the first prefill bucket. Must be a power of two >= 2.
+    size_t min_prefill_bucket = 16;
+
+    /// Largest prompt chunk the family must serve. Must be non-zero.
+    size_t max_prefill_tokens = 0;
+
+    /// Symbol facts proven for the model, e.g. that a weight dimension equals
+    /// the hidden size. Runtime checks they discharge are compiled out of
+    /// every bucket; checks they contradict fail the build. Borrowed for the
+    /// duration of BuildBucketed(); nullptr uses only the bucket ranges.
+    const SymbolConstraintSolver* proven_facts = nullptr;
+};
+
+/// Describes the decode-only family built by
+/// ExecutionPlanBuilder::BuildDecodeBatched(). Its token axis counts sessions:
+/// a DecodeBatch step feeds one token for each of B sessions as a `[B, hidden]`
+/// activation, so weights stream once per step instead of once per session.
+///
+/// Buckets are [1, 1], [2, 2], [3, 4], [5, 8], ... until `max_batch` is
+/// covered, all selecting kernels with ExecPhase::kDecode.
+struct DecodeBatchConfig {
+    /// Symbolic token-count dimension shared by the lowered token inputs.
+    /// Unknown() derives it from dimension 0 of the first model input.
+    ShapeSymbol seq_len = ShapeSymbol::Unknown();
+
+    /// Largest number of sessions decoded by one step. Must be non-zero.
+    size_t max_batch = 0;
+};
+
+/// One ExecutionPlan specialized for token counts in [min_tokens, max_tokens].
+///
+/// Exact buckets (min_tokens == max_tokens) carry static sequence dimensions in
+/// their TensorSpecs. Every bucket drops the runtime checks it can discharge
+/// for its whole token range, and selects kernels with the bucket phase.
+struct ExecutionPlanBucket {
+    size_t min_tokens = 0;
+    size_t max_tokens = 0;
+    ExecutionPlan plan{};
+
+    AM_NODISCARD bool Contains(size_t num_tokens) const noexcept {
+        return num_tokens >= min_tokens && num_tokens <= max_tokens;
+    }
+};
+
+/// Immutable set of shape-bucketed ExecutionPlans compiled from one lowered
+/// graph. The runtime picks the smallest bucket that covers the current token
+/// count, so decode never pays for prefill-shaped plans and vice versa.
+class ExecutionPlanFamily {
+public:
+    /// Validates that buckets are non-empty ranges that do not overlap and
+    /// stores them sorted by token range.
+    AM_NODISCARD static StatusOr<ExecutionPlanFamily> Create(
+            std::vector<ExecutionPlanBucket> buckets);
+
+    /// Returns the plan of the smallest bucket covering `num_tokens`.
+    AM_NODISCARD StatusOr<const ExecutionPlan*> Select(size_t num_tokens) const noexcept;
+
+    AM_NODISCARD const std::vector<ExecutionPlanBucket>& buckets() const noexcept;
+    AM_NODISCARD size_t size() const noexcept;
+    AM_NODISCARD size_t max_tokens() const noexcept;
+
+private:
+    std::vector<ExecutionPlanBucket> buckets_{};
+};
+
+}// namespace aethermind
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "aethermind/base/status.h"
 #include "aethermind/execution/execution_plan.h"
+#include "aethermind/execution/execution_plan_family.h"
 #include "aethermind/execution/runtime_binding_context.h"
 
 namespace aethermind {
@@ -11,6 +12,11 @@ class Executor {
 public:
     AM_NODISCARD static Status Execute(const ExecutionPlan& plan,
                                        RuntimeBindingContext& bindings) noexcept;
+
+    /// Runs the smallest plan bucket of `family` that covers `num_tokens`.
+    AM_NODISCARD static Status Execute(const ExecutionPlanFamily& family,
+                                       size_t num_tokens,
+                                       RuntimeBindingContext& bindings) noexcept;
 };
 
 }// namespace aethermind
@@ -0,0 +1,268 @@
+#ifndef AETHERMIND_EXECUTION_GENERATION_SESSION_H
+#define AETHERMIND_EXECUTION_GENERATION_SESSION_H
+
+#include "aethermind/backend/kernel_selector.h"
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/base/tensor_view.h"
+#include "aethermind/execution/activation_plan.h"
+#include "aethermind/execution/execution_plan_family.h"
+#include "aethermind/execution/runtime_binding_context.h"
+#include "aethermind/graph/compilation/graph_lowering.h"
+#include "aethermind/memory/buffer.h"
+#include "aethermind/model/model_instance.h"
+#include "aethermind/runtime/runtime_context.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace aethermind {
+
+/// Per-request sampling limits of GenerationSession::Generate().
+struct GenerationConfig {
+    /// Tokens to generate, including the one produced by prefill. 0 returns
+    /// without running any plan.
+    size_t max_new_tokens = 0;
+
+    /// Generation stops after emitting this token; it is part of the output.
+    std::optional<int64_t> eos_token_id{};
+
+    /// Prompt tokens per prefill step; 0 uses the largest prefill bucket.
+    size_t prefill_chunk_tokens = 0;
+
+    /// Session key of Sample operators in the plan; the same seed and prompt
+    /// reproduce the same tokens.
+    uint64_t seed = 0;
+};
+
+enum class FinishReason : uint8_t {
+    kEos = 0,
+    kLength,
+    /// The token callback asked to stop.
+    kCancelled,
+};
+
+struct GenerationStats {
+    size_t prompt_tokens = 0;
+    size_t generated_tokens = 0;
+    /// From the start of prefill until the first token was emitted.
+    double ttft_ms = 0.0;
+    /// Tokens emitted after the first per second since it was emitted; 0 when
+    /// prefill produced the only token.
+    double decode_tokens_per_second = 0.0;
+    double total_ms = 0.0;
+    /// Times the step tensor binder ran during this Generate().
+    size_t tensor_bind_calls = 0;
+    /// Speculative decoding: tokens the draft proposed and how many of them
+    /// the target accepted.
+    size_t draft_tokens = 0;
+    size_t accepted_draft_tokens = 0;
+};
+
+struct GenerationResult {
+    std::vector<int64_t> tokens{};
+    FinishReason finish_reason = FinishReason::kLength;
+    GenerationStats stats{};
+};
+
+/// Token-level I/O of one plan execution. The session owns the storage:
+/// `token_ids` and `position_ids` are Int64 `[num_tokens]` and filled before
+/// the step runs; the plan writes the next token of every row to
+/// `output_tokens`, Int64 `[num_tokens]`. Data pointers stay fixed for the
+/// session's lifetime, so views bound once remain valid for later steps with
+/// the same shape.
+struct GenerationStepIO {
+    ExecPhase phase = ExecPhase::kDecode;
+    size_t num_tokens = 0;
+    TensorView token_ids{};
+    TensorView position_ids{};
+    MutableTensorView output_tokens{};
+    /// With GenerationSessionOptions::plan_activations, the session's
+    /// activation plan and the arena it was allocated for; binders place
+    /// each intermediate at `activation_arena + Find(step, port)->offset`.
+    /// The arena is sized for the family's largest bucket and never moves.
+    /// Null otherwise.
+    const ActivationPlan* activation_plan = nullptr;
+    std::byte* activation_arena = nullptr;
+};
+
+/// Installs the StepTensorBindings that route GenerationStepIO through the
+/// plan. Called only when the step shape changes, i.e. once per distinct
+/// prefill chunk size and once for the whole decode loop.
+using StepTensorBinder = std::function<Status(const GenerationStepIO&, RuntimeBindingContext&)>;
+
+/// Receives each generated token as soon as it is produced. Returning false
+/// stops generation with FinishReason::kCancelled.
+using TokenCallback = std::function<bool(int64_t token)>;
+
+struct SpeculativeConfig {
+    /// Tokens the draft proposes per round. The target verifies them together
+    /// with the last accepted token, so its largest bucket must serve
+    /// `num_draft_tokens + 1` tokens.
+    size_t num_draft_tokens = 4;
+};
+
+struct GenerationSessionOptions {
+    /// Largest prefill bucket and the upper bound for prefill chunks.
+    size_t max_prefill_tokens = 0;
+    size_t min_prefill_bucket = 16;
+
+    /// Temp buffers allocated once on the CPU allocator and bound for every
+    /// step; 0 leaves the kind unbound.
+    size_t hidden_state_bytes = 0;
+    size_t logits_bytes = 0;
+    size_t scratch_bytes = 0;
+
+    /// Plans every intermediate activation of the lowered graph into one
+    /// arena with PlanActivationBuffers() and hands it to the binder through
+    /// GenerationStepIO. Only the overloads that lower from a LoweredGraph
+    /// can plan; the family overload rejects it.
+    bool plan_activations = false;
+
+    /// Borrowed; must outlive the session.
+    WorkspaceArena* workspace_arena = nullptr;
+    RuntimeShapeCheckMode shape_check_mode = RuntimeShapeCheckMode::kEveryStep;
+
+    /// Symbol facts proven for the model; runtime checks they discharge are
+    /// compiled out of every plan. Only read while a LoweredGraph overload of
+    /// Create() builds the family. See PlanBucketConfig::proven_facts.
+    const SymbolConstraintSolver* proven_shape_facts = nullptr;
+
+    StepTensorBinder binder{};
+};
+
+/// End-to-end token generation over one model: a prefill family and the
+/// decode plan selected from it, compiled once and reused for every request.
+///
+/// Generate() reserves a KV view from the runtime's KVCacheManager and binds
+/// it once, prefills the prompt in chunks, then loops single-token decode
+/// steps through the cached decode plan. Temp buffers and step tensors are
+/// bound up front, so a decode step only rewrites the input token and its
+/// position before Executor::Execute().
+///
+/// One request runs at a time; sessions that interleave requests use
+/// SessionScheduler and DecodeBatch instead.
+class GenerationSession {
+public:
+    /// Compiles the prefill/decode family for a graph lowered from
+    /// ModelGraphBuilder output.
+    AM_NODISCARD static StatusOr<GenerationSession> Create(RuntimeContext& runtime,
+                                                           const LoweredGraph& lowered,
+                                                           GenerationSessionOptions options);
+
+    AM_NODISCARD static StatusOr<GenerationSession> Create(RuntimeContext& runtime,
+                                                           const ModelInstance& model_instance,
+                                                           const LoweredGraph& lowered,
+                                                           GenerationSessionOptions options);
+
+    /// Adopts an already built family. It must contain a one-token bucket
+    /// and `options.plan_activations` must be false.
+    AM_NODISCARD static StatusOr<GenerationSession> Create(RuntimeContext& runtime,
+                                                           ExecutionPlanFamily family,
+                                                           GenerationSessionOptions options);
+
+    /// Generates up to `config.max_new_tokens` tokens after `prompt`,
+    /// reporting each to `on_token` as it is produced.
+    ///
+    /// Fails with InvalidArgument for an empty prompt or a chunk size the
+    /// family cannot serve, and with the KVCacheManager's status when the
+    /// request does not fit the cache. The KV reservation is released on
+    /// every path.
+    AM_NODISCARD StatusOr<GenerationResult> Generate(std::span<const int64_t> prompt,
+                                                     const GenerationConfig& config,
+                                                     const TokenCallback& on_token = {});
+
+    /// Greedy speculative decoding: `draft` proposes up to
+    /// `num_draft_tokens` tokens with its decode plan, and this session scores
+    /// the last accepted token plus every draft in one multi-token step over
+    /// its KV cache. The longest prefix of drafts matching the target's own
+    /// argmax is accepted along with the target's next token; the draft's
+    /// rejected positions are rolled back with KVCacheView::RollbackTo().
+    ///
+    /// Emits exactly the tokens Generate() would, in fewer target passes.
+    /// Both sessions reserve KV for the request, and the draft must use the
+    /// same vocabulary. Fails with FailedPrecondition when either KV cache is
+    /// a sliding window, whose ring cannot hold unverified drafts.
+    AM_NODISCARD StatusOr<GenerationResult> GenerateSpeculative(GenerationSession& draft,
+                                                                std::span<const int64_t> prompt,
+                                                                const GenerationConfig& config,
+                                                                const SpeculativeConfig& speculative,
+                                                                const TokenCallback& on_token = {});
+
+    AM_NODISCARD const ExecutionPlanFamily& family() const noexcept;
+    AM_NODISCARD const ExecutionPlan& decode_plan() const noexcept;
+    /// Empty unless the session was created with `plan_activations`.
+    AM_NODISCARD const ActivationPlan& activation_plan() const noexcept;
+
+private:
+    // Session-owned step I/O; heap-allocated so bound views survive moves.
+    struct StepBuffers {
+        std::vector<int64_t> token_ids{};
+        std::vector<int64_t> position_ids{};
+        std::vector<int64_t> output_tokens{};
+        int64_t shape[1] = {0};
+        int64_t strides[1] = {1};
+        // Shape the current StepTensorBindings were installed for.
+        std::optional<std::pair<ExecPhase, size_t>> bound{};
+    };
+
+    GenerationSession(KVCacheManager& manager,
+                      ExecutionPlanFamily family,
+                      GenerationSessionOptions options) noexcept;
+
+    // Shared tail of every Create(); `lowered` is null for adopted families.
+    AM_NODISCARD static StatusOr<GenerationSession> Build(RuntimeContext& runtime,
+                                                          ExecutionPlanFamily family,
+                                                          GenerationSessionOptions options,
+                                                          const LoweredGraph* lowered);
+
+    AM_NODISCARD Status BindTempBuffers(RuntimeContext& runtime);
+    AM_NODISCARD Status AllocateActivationArena(RuntimeContext& runtime, const LoweredGraph& lowered);
+    // Runs the binder when the step shape differs from the bound one.
+    AM_NODISCARD Status BindStep(ExecPhase phase, size_t num_tokens, GenerationStats& stats);
+    // Returns the prefill chunk size for `config`.
+    AM_NODISCARD StatusOr<size_t> ValidateRequest(std::span<const int64_t> prompt,
+                                                  const GenerationConfig& config) const;
+    AM_NODISCARD Status BeginRequest(size_t prompt_len, const GenerationConfig& config);
+    AM_NODISCARD Status EndRequest();
+    // Prefills the prompt and returns the first generated token.
+    AM_NODISCARD StatusOr<int64_t> Prefill(std::span<const int64_t> prompt,
+                                           size_t chunk_tokens,
+                                           GenerationStats& stats);
+    // Runs `tokens` at the current position without committing them; the
+    // plan's choices are left in the output buffer.
+    AM_NODISCARD Status RunStep(std::span<const int64_t> tokens, GenerationStats& stats);
+    AM_NODISCARD Status Commit(size_t num_tokens);
+    AM_NODISCARD Status Rollback(size_t pos);
+    AM_NODISCARD StatusOr<GenerationResult> Run(std::span<const int64_t> prompt,
+                                                const GenerationConfig& config,
+                                                size_t chunk_tokens,
+                                                const TokenCallback& on_token);
+    AM_NODISCARD StatusOr<GenerationResult> RunSpeculative(GenerationSession& draft,
+                                                           std::span<const int64_t> prompt,
+                                                           const GenerationConfig& config,
+                                                           size_t chunk_tokens,
+                                                           size_t draft_chunk_tokens,
+                                                           size_t num_draft_tokens,
+                                                           const TokenCallback& on_token);
+
+    KVCacheManager* manager_ = nullptr;
+    ExecutionPlanFamily family_;
+    const ExecutionPlan* decode_plan_ = nullptr;
+    GenerationSessionOptions options_{};
+    std::vector<Buffer> temp_buffers_{};
+    ActivationPlan activation_plan_{};
+    Buffer activation_arena_{};
+    std::unique_ptr<StepBuffers> io_{};
+    RuntimeBindingContext bindings_{};
+};
+
+}// namespace aethermind
+
+#endif
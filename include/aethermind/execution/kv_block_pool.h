@@ -0,0 +1,65 @@
+#ifndef AETHERMIND_EXECUTION_KV_BLOCK_POOL_H
+#define AETHERMIND_EXECUTION_KV_BLOCK_POOL_H
+
+#include "aethermind/base/macros.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace aethermind {
+
+/// Lock-free free list of fixed-size KV blocks shared by every session of a
+/// paged KVCacheManager.
+///
+/// Free blocks form a Treiber stack whose head packs the top block id with a
+/// modification tag, so a block that is popped and pushed back between a
+/// reader's load and its compare-exchange cannot corrupt the list.
+///
+/// Blocks are reference counted so that sessions can share immutable prefix
+/// blocks: Allocate() hands out one reference, Retain() adds one, and the
+/// block returns to the free list when Release() drops the last one.
+class KVBlockPool {
+public:
+    static constexpr uint32_t kInvalidBlock = std::numeric_limits<uint32_t>::max();
+
+    KVBlockPool() = default;
+    KVBlockPool(const KVBlockPool&) = delete;
+    KVBlockPool& operator=(const KVBlockPool&) = delete;
+
+    /// Makes blocks [0, num_blocks) free. Not thread-safe; call before sharing.
+    void Reset(size_t num_blocks);
+
+    /// Pops a free block holding one reference, or returns kInvalidBlock when
+    /// the pool is exhausted.
+    AM_NODISCARD uint32_t Allocate() noexcept;
+
+    /// Adds a reference to an allocated block. The caller must already hold one.
+    void Retain(uint32_t block) noexcept;
+
+    /// Drops a reference; the last one pushes the block back to the free list.
+    void Release(uint32_t block) noexcept;
+
+    /// Current references to `block`; 0 while it is free.
+    AM_NODISCARD uint32_t ref_count(uint32_t block) const noexcept;
+
+    AM_NODISCARD size_t num_blocks() const noexcept;
+    AM_NODISCARD size_t free_blocks() const noexcept;
+
+private:
+    static constexpr uint64_t Pack(uint32_t block, uint32_t tag) noexcept {
+        return (static_cast<uint64_t>(tag) << 32) | block;
+    }
+
+    std::atomic<uint64_t> head_{Pack(kInvalidBlock, 0)};
+    std::unique_ptr<std::atomic<uint32_t>[]> next_{};
+    std::unique_ptr<std::atomic<uint32_t>[]> refs_{};
+    size_t num_blocks_ = 0;
+    std::atomic<size_t> free_blocks_{0};
+};
+
+}// namespace aethermind
+
+#endif
@@ -2,36 +2,250 @@
 #define AETHERMIND_EXECUTION_KV_CACHE_MANAGER_H
 
 #include "aethermind/execution/kv_cache_view.h"
+#include "aethermind/execution/kv_prefix_cache.h"
+#include "aethermind/execution/kv_snapshot.h"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <span>
+#include <vector>
 
 namespace aethermind {
 
+/// Snapshot of KVCacheManager slot usage. Counters are read independently, so
+/// a snapshot taken while sessions come and go may be momentarily inconsistent.
+struct KVCacheOccupancy {
+    size_t num_slots = 0;
+    size_t active_slots = 0;
+    size_t peak_active_slots = 0;
+    /// Sum of token_capacity() over active reservations.
+    size_t reserved_tokens = 0;
+    /// num_slots * per-slot max_tokens.
+    size_t capacity_tokens = 0;
+    /// Paged mode only: blocks in the shared pool and how many are unmapped.
+    size_t total_blocks = 0;
+    size_t free_blocks = 0;
+    /// Paged mode only: blocks held by the prefix cache.
+    size_t cached_blocks = 0;
+    /// Disk offload only: blocks of parked sessions stored in the spill file.
+    size_t offloaded_blocks = 0;
+};
+
+/// Owns the KV planes and carves them into `num_slots` fixed-size session
+/// slots of `max_tokens` each.
+///
+/// Slot claims are lock-free: a session claims a slot with a compare-exchange
+/// on its `in_use` flag, so concurrent sessions can reserve and release from
+/// different threads. Every reservation and release bumps the slot
+/// generation, which turns views of earlier sessions stale. Dense reservation
+/// never blocks; in paged mode a reservation that finds the block pool empty
+/// evicts from the prefix cache, which takes the cache's mutex.
+///
+/// In paged mode (InitPaged) the planes instead hold a shared pool of
+/// fixed-size token blocks. Slots own no memory of their own: each session maps
+/// blocks into its block table as positions are committed, so short sessions
+/// leave room for more concurrent ones. Full prompt blocks can be published to
+/// a KVPrefixCache so later sessions with the same prefix skip its prefill.
+/// With EnableDiskOffload() the pool gains a disk tier: idle sessions can be
+/// parked on a local spill file and prefetched back before they run again.
+///
+/// Layout, planes and slot state live in one heap allocation, so moving the
+/// manager keeps its views and pending prefetches valid.
 class KVCacheManager {
 public:
+    /// Dense cache of `num_slots` slots of `max_tokens` tokens. `order`
+    /// selects the plane order of every mode; plan building advertises it to
+    /// the kernel selector so attention kernels for that order resolve.
     Status Init(size_t num_layers,
                 size_t num_kv_heads,
                 size_t max_tokens,
                 size_t head_dim,
                 DataType kv_dtype,
-                size_t alignment = 64);
+                size_t alignment = 64,
+                size_t num_slots = 1,
+                KVLayoutOrder order = KVLayoutOrder::kHeadMajor);
 
+    /// Dense variant of Init() whose slots are rings of `window_tokens`
+    /// rows: sessions may reserve any length and keep their last
+    /// `window_tokens` tokens. Chunked prefill needs a window of at least the
+    /// attention window plus the largest chunk minus one.
+    Status InitSlidingWindow(size_t num_layers,
+                             size_t num_kv_heads,
+                             size_t window_tokens,
+                             size_t head_dim,
+                             DataType kv_dtype,
+                             size_t alignment = 64,
+                             size_t num_slots = 1,
+                             KVLayoutOrder order = KVLayoutOrder::kHeadMajor);
+
+    /// Paged variant of Init(): allocates `num_blocks` blocks of
+    /// `block_tokens` tokens shared by `num_slots` sessions of at most
+    /// `max_tokens` tokens each.
+    Status InitPaged(size_t num_layers,
+                     size_t num_kv_heads,
+                     size_t max_tokens,
+                     size_t head_dim,
+                     DataType kv_dtype,
+                     size_t block_tokens,
+                     size_t num_blocks,
+                     size_t alignment = 64,
+                     size_t num_slots = 1,
+                     KVLayoutOrder order = KVLayoutOrder::kHeadMajor);
+
+    /// Reserves a free slot with the prompt already committed. Fails with
+    /// ResourceExhausted when every slot is in use or, in paged mode, when the
+    /// block pool cannot back the prompt.
     AM_NODISCARD StatusOr<KVCacheView> ReserveForSession(size_t prompt_len,
                                                          size_t max_new_tokens) noexcept;
+
+    /// Reserves the same capacity as ReserveForSession() but commits no
+    /// prompt tokens; ChunkedPrefill commits them one chunk at a time.
+    AM_NODISCARD StatusOr<KVCacheView> ReserveForChunkedPrefill(size_t prompt_len,
+                                                                size_t max_new_tokens) noexcept;
+    /// Paged mode: reserves like ReserveForChunkedPrefill() and maps the
+    /// longest cached prefix of `prompt_tokens`, leaving those tokens
+    /// committed. At least the last prompt token is left to prefill so the
+    /// session still produces logits. Dense managers commit nothing.
+    AM_NODISCARD StatusOr<KVCacheView> ReserveWithPrefix(std::span<const int32_t> prompt_tokens,
+                                                         size_t max_new_tokens);
+
+    /// Publishes the full committed blocks of `prompt_tokens` to the prefix
+    /// cache. No-op for dense managers.
+    Status PublishPrefix(const KVCacheView& view, std::span<const int32_t> prompt_tokens);
+
+    /// Saves the resident committed KV rows of `view` with `state` to `path`
+    /// so the session can be released while idle. See SaveKVSnapshot().
+    Status SaveSession(const KVCacheView& view,
+                       const RuntimeSequenceState& state,
+                       const std::filesystem::path& path,
+                       const KVSnapshotOptions& options = {}) const;
+
+    /// Reserves a slot, maps the snapshot at `path` and writes its rows back,
+    /// leaving them committed, so the session resumes without re-running
+    /// prefill. The slot keeps the saved prompt length and has room for
+    /// `max_new_tokens` beyond the saved position. The snapshot must match
+    /// this manager's layer, head and head_dim counts; a wrapped sliding
+    /// window restores only into a sliding-window manager. On success `state`
+    /// receives the saved sequence state.
+    AM_NODISCARD StatusOr<KVCacheView> RestoreSession(const std::filesystem::path& path,
+                                                      size_t max_new_tokens,
+                                                      RuntimeSequenceState* state = nullptr);
+
+    /// Paged mode: adds a disk tier backed by a spill file created at `path`.
+    /// Must be called before any session is reserved; fails with
+    /// FailedPrecondition while sessions are active.
+    Status EnableDiskOffload(const std::filesystem::path& path);
+
+    /// Moves the private blocks of an idle session to the spill file and
+    /// returns them to the pool; blocks shared with the prefix cache stay in
+    /// RAM. Returns the number of blocks offloaded. The session's views fail
+    /// with FailedPrecondition until PrefetchSession() completes; the session
+    /// can still be reset or released while parked.
+    AM_NODISCARD StatusOr<size_t> OffloadSession(KVCacheView& view);
+
+    /// Blocks of `view`'s session that other holders, such as the prefix
+    /// cache, also map. OffloadSession() leaves exactly these in RAM. 0 for
+    /// dense, stale or foreign views.
+    AM_NODISCARD size_t SharedBlocks(const KVCacheView& view) const noexcept;
+
+    /// Starts reading the offloaded blocks of `view`'s session back into the
+    /// pool on another thread. The session must not be used, and the manager
+    /// must stay alive, until the returned future is ready. Fails with
+    /// ResourceExhausted when the pool cannot hold the blocks; blocks not yet
+    /// restored then stay on disk and the prefetch may be retried.
+    AM_NODISCARD std::future<Status> PrefetchSession(KVCacheView& view);
+
     Status ResetSession(KVCacheView& view) noexcept;
     Status ReleaseSession(KVCacheView& view) noexcept;
 
+    /// Admission-control units a session reserved with these lengths holds
+    /// once its reservation is fully used: pool blocks when paged, otherwise
+    /// its whole slot as one unit. Fails like ReserveForSession() when the
+    /// lengths can never be reserved.
+    AM_NODISCARD StatusOr<size_t> ProjectedBlocks(size_t prompt_len,
+                                                  size_t max_new_tokens) const noexcept;
+    /// Units available to ProjectedBlocks(): pool blocks when paged, slots
+    /// otherwise.
+    AM_NODISCARD size_t BlockBudget() const noexcept;
+    AM_NODISCARD bool disk_offload_enabled() const noexcept;
+
     AM_NODISCARD const KVCacheLayout& layout() const noexcept;
+    /// Per-session token capacity of one slot; the ring size for sliding windows.
     AM_NODISCARD size_t capacity_tokens() const noexcept;
+    AM_NODISCARD size_t num_slots() const noexcept;
+    AM_NODISCARD size_t active_sessions() const noexcept;
+    AM_NODISCARD KVCacheOccupancy Occupancy() const noexcept;
+    /// Prefix cache of a paged manager, or null.
+    AM_NODISCARD KVPrefixCache* prefix_cache() const noexcept;
     AM_NODISCARD size_t total_bytes() const noexcept;
     AM_NODISCARD bool is_initialized() const noexcept;
 
 private:
+    struct SlotPool {
+        explicit SlotPool(size_t num_slots) : slots(num_slots) {}
+
+        // Disk offload: bytes of one block in each plane and the key/value
+        // and scale regions of physical block `block`, in spill record order.
+        AM_NODISCARD size_t SpillBlockBytes() const noexcept;
+        AM_NODISCARD std::vector<std::span<std::byte>> BlockRegions(uint32_t block) noexcept;
+        // Reads every offloaded block of `slot` back into the pool.
+        Status LoadOffloadedBlocks(SessionKVSlot& slot);
+
+        /// Views point here, so neither may move once sessions exist.
+        KVCacheLayout layout{};
+        KVCacheStorage storage{};
+        size_t total_bytes = 0;
+        bool initialized = false;
+        std::vector<SessionKVSlot> slots;
+        std::atomic<size_t> active{0};
+        std::atomic<size_t> peak_active{0};
+        std::atomic<size_t> reserved_tokens{0};
+        /// Slot the next reservation probes first, spreading concurrent claims.
+        std::atomic<size_t> next_probe{0};
+        KVBlockPool blocks;
+        /// Declared after `blocks`: releases its references before the pool dies.
+        std::unique_ptr<KVPrefixCache> prefix_cache;
+        /// Disk tier of the block pool; null until EnableDiskOffload().
+        std::unique_ptr<KVSpillFile> spill_file;
+    };
+
+    Status InitDense(size_t num_layers,
+                     size_t num_kv_heads,
+                     size_t max_tokens,
+                     size_t head_dim,
+                     DataType kv_dtype,
+                     size_t alignment,
+                     size_t num_slots,
+                     bool sliding_window,
+                     KVLayoutOrder order);
+    Status InitLayout(size_t num_layers,
+                      size_t num_kv_heads,
+                      size_t max_tokens,
+                      size_t head_dim,
+                      DataType kv_dtype,
+                      size_t alignment,
+                      size_t num_slots);
+    // Plane strides for `order` over regions of `region_tokens` tokens: a
+    // slot when dense, a block when paged.
+    Status InitStrides(size_t region_tokens, KVLayoutOrder order);
     Status AllocateStorage(size_t bytes_per_plane, size_t alignment);
+    // Scaled dtypes: zeroed per-row key/value scales for `num_walk_blocks`
+    // walk blocks.
+    Status AllocateScales(size_t num_walk_blocks);
+
+    // Paged mode: returns the blocks mapped past `keep_tokens` to the pool
+    // and frees their spill records.
+    void UnmapBlocks(SessionKVSlot& slot, size_t keep_tokens) noexcept;
+
+    AM_NODISCARD StatusOr<KVCacheView> ReserveSlot(size_t prompt_len,
+                                                   size_t max_new_tokens,
+                                                   size_t committed_tokens) noexcept;
+
+    AM_NODISCARD Status ValidateOwnedView(const KVCacheView& view, const char* action) const noexcept;
 
-    KVCacheLayout layout_{};
-    KVCacheStorage storage_{};
-    SessionKVSlot slot_{};
-    size_t total_bytes_ = 0;
-    bool initialized_ = false;
+    /// Null until Init*() starts; initialized once it succeeds.
+    std::unique_ptr<SlotPool> pool_{};
 };
 
 }// namespace aethermind
@@ -1,13 +1,23 @@
 #ifndef AETHERMIND_EXECUTION_KV_CACHE_VIEW_H
 #define AETHERMIND_EXECUTION_KV_CACHE_VIEW_H
 
+#include "aethermind/backend/kernel_selector.h"
 #include "aethermind/base/status.h"
 #include "aethermind/memory/buffer.h"
 #include "aethermind/dtypes/data_type.h"
 #include "aethermind/base/macros.h"
+#include "aethermind/execution/kv_block_pool.h"
+#include "aethermind/execution/kv_spill_file.h"
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
 
 namespace aethermind {
 
+class KVPrefixCache;
+
 struct KVCacheLayout {
     size_t num_layers = 0;
     size_t num_kv_heads = 0;
@@ -20,8 +30,46 @@ struct KVCacheLayout {
     DataType kv_dtype{};
     size_t alignment = 64;
 
+    /// Plane order. Head-major regions are [layer][head][tokens][head_dim];
+    /// token-major ones are [layer][tokens][head][head_dim]. The strides
+    /// above always describe the chosen order.
+    KVLayoutOrder order = KVLayoutOrder::kHeadMajor;
+
+    /// Tokens per block in paged mode; 0 selects the dense layout, where each
+    /// session owns a contiguous region of `max_tokens` tokens per layer.
+    /// Paged planes are arrays of `num_blocks` blocks, each holding
+    /// `block_tokens` tokens of every layer and head; `head_stride` and
+    /// `layer_stride` then describe one block and `max_tokens` caps a single
+    /// session.
+    size_t block_tokens = 0;
+    size_t num_blocks = 0;
+    /// Aligned bytes of one block in each plane (paged mode only).
+    size_t block_stride = 0;
+    /// Dense ring buffer: position p lives in row `p % max_tokens`, so a
+    /// session keeps only its last `max_tokens` tokens and may run past them.
+    /// Positions stay absolute (RoPE and commits use them unchanged).
+    bool sliding_window = false;
+    /// Tokens per walk block when `kv_dtype` is a scaled storage dtype
+    /// (INT8); 0 otherwise. Kernels walk a dense INT8 slot in blocks of this
+    /// many rows, and each block's per-row scales are stored together.
+    /// Equals `block_tokens` when paged.
+    size_t walk_block_tokens = 0;
+
+    AM_NODISCARD bool paged() const noexcept {
+        return block_tokens != 0;
+    }
+    AM_NODISCARD bool scaled() const noexcept {
+        return walk_block_tokens != 0;
+    }
+    /// Per-row scales held by one walk block in each scale array.
+    AM_NODISCARD size_t WalkBlockScaleEntries() const noexcept {
+        return num_layers * num_kv_heads * walk_block_tokens;
+    }
+
     AM_NODISCARD size_t ElementBytes() const noexcept;
     AM_NODISCARD Status Validate() const noexcept;
+    /// Byte offset of an element. In paged mode `seq_pos` is the position
+    /// inside a block and the offset is relative to the block base.
     AM_NODISCARD StatusOr<size_t> Offset(size_t layer_idx,
                                          size_t kv_head_idx,
                                          size_t seq_pos,
@@ -34,16 +82,67 @@ struct KVCacheStorage {
     Buffer value_buffer{};
     DataType kv_dtype{};
     size_t alignment = 64;
+    /// Shared block allocator in paged mode; null for dense layouts.
+    KVBlockPool* block_pool = nullptr;
+    /// Paged mode: evicted when the pool runs dry. May be null.
+    KVPrefixCache* prefix_cache = nullptr;
+    /// Scaled dtypes: one scale per token row, fixed when the row is written,
+    /// indexed as `((block * num_layers + layer) * num_kv_heads + head) *
+    /// walk_block_tokens + row % walk_block_tokens`. A walk block is a
+    /// physical block when paged and a `walk_block_tokens` span of a slot
+    /// otherwise, so a paged block's scales move with it. 0 marks an
+    /// unwritten row.
+    std::vector<float> key_scales{};
+    std::vector<float> value_scales{};
 
     AM_NODISCARD bool is_initialized() const noexcept;
 };
 
+/// One session's region of the KV planes.
+///
+/// `generation` and `in_use` are atomic because a slot released by one
+/// session may be reserved by another thread while stale views still point at
+/// it; every other field is owned by the session holding the reservation.
 struct SessionKVSlot {
-    uint64_t generation = 0;
-    bool in_use = false;
+    std::atomic<uint64_t> generation{0};
+    std::atomic<bool> in_use{false};
+    size_t slot_index = 0;
+    /// Byte offset of this slot's region inside each KV plane.
+    size_t base_offset = 0;
     size_t capacity_tokens = 0;
     size_t prompt_len = 0;
     size_t current_pos = 0;
+    /// Paged mode: physical block of each logical block of this session,
+    /// KVBlockPool::kInvalidBlock while unmapped. Sized once at Init. The
+    /// session holds one pool reference per mapped block; blocks shared with
+    /// the prefix cache are copied before the first write.
+    std::vector<uint32_t> block_table{};
+    /// Paged mode with disk offload: spill record of each logical block whose
+    /// data was moved to disk, KVSpillFile::kInvalidRecord while it is in
+    /// RAM. With `block_table` this forms the session's residency map.
+    std::vector<uint32_t> spill_table{};
+    /// Blocks of this session on disk; its views refuse access until a
+    /// prefetch brings them back.
+    size_t offloaded_blocks = 0;
+};
+
+/// Committed tokens of one (layer, kv_head) inside one block, as seen by
+/// attention kernels that walk a session's history block by block.
+struct KVCacheBlock {
+    const void* key = nullptr;
+    const void* value = nullptr;
+    /// Sequence position of the first token in the block.
+    size_t first_pos = 0;
+    /// Committed tokens in the block, starting at `first_pos`.
+    size_t num_tokens = 0;
+    /// Bytes between consecutive tokens.
+    size_t token_stride = 0;
+    /// Storage dtype; INT8 elements of token `t` dequantize as
+    /// `q * key_scales[t]` (values likewise).
+    DataType kv_dtype{};
+    /// Per-token scales of the block's tokens; null for unscaled dtypes.
+    const float* key_scales = nullptr;
+    const float* value_scales = nullptr;
 };
 
 class KVCacheView {
@@ -59,8 +158,19 @@ public:
     AM_NODISCARD size_t num_layers() const noexcept;
     AM_NODISCARD size_t num_kv_heads() const noexcept;
     AM_NODISCARD size_t head_dim() const noexcept;
+    /// Storage dtype of the KV planes, or undefined when unbound.
+    AM_NODISCARD DataType kv_dtype() const noexcept;
     AM_NODISCARD size_t token_capacity() const noexcept;
     AM_NODISCARD size_t committed_tokens() const noexcept;
+    /// First committed position still resident; non-zero only for sliding
+    /// windows that have wrapped.
+    AM_NODISCARD size_t window_begin() const noexcept;
+
+    /// Index of the manager slot backing this view, or 0 when invalid.
+    AM_NODISCARD size_t slot_index() const noexcept;
+    /// Paged mode: pool blocks mapped in the session's block table, shared
+    /// ones included; 0 for dense views.
+    AM_NODISCARD size_t num_mapped_blocks() const noexcept;
 
     AM_NODISCARD Status ValidateWrite(size_t layer_idx,
                                       size_t kv_head_idx,
@@ -88,16 +198,83 @@ public:
                                                  size_t seq_pos,
                                                  size_t dim_idx = 0) const noexcept;
 
+    /// Quantizes one token of `head_dim` floats into the key and value planes
+    /// at `seq_pos`, converting to the storage dtype. INT8 rows get their
+    /// own scale, so rows already written are never touched.
+    AM_NODISCARD Status WriteToken(size_t layer_idx,
+                                   size_t kv_head_idx,
+                                   size_t seq_pos,
+                                   std::span<const float> key,
+                                   std::span<const float> value) noexcept;
+
+    /// Dequantizes one committed token into `key` and `value`.
+    AM_NODISCARD Status ReadToken(size_t layer_idx,
+                                  size_t kv_head_idx,
+                                  size_t seq_pos,
+                                  std::span<float> key,
+                                  std::span<float> value) const noexcept;
+
+    /// Tokens per block: the layout block size when paged, the walk block
+    /// for dense INT8, the ring size for sliding windows, otherwise the whole
+    /// session capacity (one block).
+    AM_NODISCARD size_t block_tokens() const noexcept;
+    /// Blocks overlapping the resident committed range
+    /// [window_begin(), committed_tokens()).
+    AM_NODISCARD size_t num_committed_blocks() const noexcept;
+    /// Blocks overlapping the positions resident once [0, seq_end) is
+    /// written: the last `max_tokens()` of them for a sliding window.
+    AM_NODISCARD size_t NumBlocksUntil(size_t seq_end) const noexcept;
+
+    /// Returns resident committed block `block_index` of (`layer_idx`,
+    /// `kv_head_idx`), oldest first. A wrapped sliding window yields the tail
+    /// of the ring before its head, so kernels see positions in order.
+    AM_NODISCARD StatusOr<KVCacheBlock> CommittedBlock(size_t layer_idx,
+                                                       size_t kv_head_idx,
+                                                       size_t block_index) const noexcept;
+
+    /// Like CommittedBlock() over the history ending at `seq_end`, which may
+    /// run past committed_tokens() into rows the current step has written
+    /// but not committed yet, e.g. the token being decoded. Those rows must
+    /// be reserved; their contents are the caller's responsibility.
+    AM_NODISCARD StatusOr<KVCacheBlock> BlockUntil(size_t layer_idx,
+                                                   size_t kv_head_idx,
+                                                   size_t block_index,
+                                                   size_t seq_end) const noexcept;
+
+    /// Maps blocks so that positions [0, seq_end) are writable. Dense views
+    /// only validate capacity. Fails with ResourceExhausted when the shared
+    /// block pool has no free block.
+    AM_NODISCARD Status ReserveTokens(size_t seq_end) noexcept;
+
+    /// Commits positions up to `new_pos`, mapping their blocks if needed.
     AM_NODISCARD Status CommitUntil(size_t new_pos) noexcept;
+
+    /// Moves the committed position back to `new_pos`, discarding later
+    /// tokens, e.g. drafts rejected by speculative decoding. Paged blocks stay
+    /// mapped for the tokens that overwrite them. Fails with
+    /// FailedPrecondition once a sliding window has wrapped, because the
+    /// discarded tokens already replaced rows that would become visible again.
+    AM_NODISCARD Status RollbackTo(size_t new_pos) noexcept;
     void Invalidate() noexcept;
 
 private:
+    friend class KVCacheManager;
+
     AM_NODISCARD bool IsSlotAlive() const noexcept;
     AM_NODISCARD Status ValidateBaseState() const noexcept;
+    // First position still resident once [0, seq_end) is written.
+    AM_NODISCARD size_t WindowBeginAt(size_t seq_end) const noexcept;
     AM_NODISCARD StatusOr<size_t> Offset(size_t layer_idx,
                                          size_t kv_head_idx,
                                          size_t seq_pos,
                                          size_t dim_idx) const noexcept;
+    // Paged mode: allocates blocks for every unmapped position below seq_end.
+    AM_NODISCARD Status MapBlocks(size_t seq_end) noexcept;
+    // Paged mode: maps the block of seq_pos and copies it if it is shared.
+    AM_NODISCARD Status PrepareBlockForWrite(size_t seq_pos) noexcept;
+    AM_NODISCARD StatusOr<uint32_t> AllocateBlock() noexcept;
+    // Scaled dtypes: index of the scale of (layer, head, seq_pos).
+    AM_NODISCARD size_t ScaleIndex(size_t layer_idx, size_t kv_head_idx, size_t seq_pos) const noexcept;
 
     const KVCacheLayout* layout_ = nullptr;
     KVCacheStorage* storage_ = nullptr;
@@ -0,0 +1,65 @@
+#ifndef AETHERMIND_EXECUTION_KV_DECODE_ATTENTION_H
+#define AETHERMIND_EXECUTION_KV_DECODE_ATTENTION_H
+
+#include "aethermind/execution/kv_cache_view.h"
+
+#include <cstddef>
+#include <span>
+
+namespace aethermind {
+
+/// Single-query attention of one query head over the committed history of one
+/// KV head: `softmax(q . k_t * softmax_scale) . v_t`.
+///
+/// Walks the history block by block through KVCacheView::BlockUntil() up to
+/// committed_tokens() with an online softmax, so paged sessions need no
+/// gather. Keys and values are
+/// read in their storage dtype and dequantized inside the dot products; INT8
+/// row scales are applied once per score and once per value row.
+///
+/// @param query `head_dim` floats.
+/// @param output `head_dim` floats, overwritten.
+/// @return FailedPrecondition when the session has no committed tokens.
+AM_NODISCARD Status DecodeAttention(const KVCacheView& view,
+                                    size_t layer_idx,
+                                    size_t kv_head_idx,
+                                    std::span<const float> query,
+                                    float softmax_scale,
+                                    std::span<float> output) noexcept;
+
+/// DecodeAttention() over positions [0, seq_end) instead of the committed
+/// history. A decode step writes its token's K/V at `current_pos` before
+/// committing it, so attending with `seq_end = current_pos + 1` lets the
+/// token see itself; blocks are read through KVCacheView::BlockUntil() up to
+/// `seq_end`.
+AM_NODISCARD Status DecodeAttention(const KVCacheView& view,
+                                    size_t layer_idx,
+                                    size_t kv_head_idx,
+                                    size_t seq_end,
+                                    std::span<const float> query,
+                                    float softmax_scale,
+                                    std::span<float> output) noexcept;
+
+/// Varlen decode attention over a batch of sessions: row b of `queries` holds
+/// the `num_q_heads` query heads of `views[b]` decoded at `positions[b]`, and
+/// attends over positions [0, positions[b]] of its own session, whatever its
+/// length, including the just-written, not yet committed row at
+/// `positions[b]`. Pass DecodeBatchBinding::positions. Query heads map onto
+/// KV heads in groups of `num_q_heads / num_kv_heads`.
+///
+/// @param queries `views.size() * num_q_heads * head_dim` floats, row-major.
+/// @param output Same shape as `queries`, overwritten.
+/// @return InvalidArgument when the views disagree on KV head count or
+///         head_dim, `positions` does not hold one entry per view, or
+///         `num_q_heads` is not a multiple of the KV head count.
+AM_NODISCARD Status BatchedDecodeAttention(std::span<const KVCacheView> views,
+                                           std::span<const size_t> positions,
+                                           size_t layer_idx,
+                                           size_t num_q_heads,
+                                           std::span<const float> queries,
+                                           float softmax_scale,
+                                           std::span<float> output) noexcept;
+
+}// namespace aethermind
+
+#endif
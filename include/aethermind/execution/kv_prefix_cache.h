@@ -0,0 +1,78 @@
+#ifndef AETHERMIND_EXECUTION_KV_PREFIX_CACHE_H
+#define AETHERMIND_EXECUTION_KV_PREFIX_CACHE_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/execution/kv_block_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace aethermind {
+
+/// Radix tree over prompt token ids whose edges are full KV blocks.
+///
+/// Each node owns one immutable block of `block_tokens` tokens and is keyed by
+/// an XXH3 hash chained from its parent, so a node identifies its whole prefix.
+/// The tree holds one pool reference per cached block; sessions that reuse a
+/// prefix add their own, and KVCacheView copies a shared block before writing
+/// into it. Blocks that only the tree references are evicted in LRU order,
+/// leaves first.
+///
+/// All methods are thread-safe.
+class KVPrefixCache {
+public:
+    KVPrefixCache(KVBlockPool* pool, size_t block_tokens) noexcept;
+    ~KVPrefixCache();
+
+    KVPrefixCache(const KVPrefixCache&) = delete;
+    KVPrefixCache& operator=(const KVPrefixCache&) = delete;
+
+    /// Returns the blocks of the longest cached prefix of `tokens`, in order.
+    /// The caller receives one reference per returned block.
+    AM_NODISCARD std::vector<uint32_t> Acquire(std::span<const int32_t> tokens);
+
+    /// Caches the full blocks of `tokens`; `blocks[i]` holds tokens
+    /// [i * block_tokens, (i + 1) * block_tokens). Blocks of prefixes already
+    /// cached are left with their owner. Returns the number of blocks added.
+    size_t Insert(std::span<const int32_t> tokens, std::span<const uint32_t> blocks);
+
+    /// Evicts up to `num_blocks` least recently used blocks that no session
+    /// references. Returns the number of blocks returned to the pool.
+    size_t Evict(size_t num_blocks);
+
+    AM_NODISCARD size_t block_tokens() const noexcept;
+    AM_NODISCARD size_t num_cached_blocks() const noexcept;
+    /// Blocks handed out by Acquire() since construction.
+    AM_NODISCARD size_t hit_blocks() const noexcept;
+
+private:
+    struct Node {
+        uint64_t hash = 0;
+        std::vector<int32_t> tokens{};
+        uint32_t block = KVBlockPool::kInvalidBlock;
+        uint64_t last_access = 0;
+        Node* parent = nullptr;
+        std::unordered_map<uint64_t, std::unique_ptr<Node>> children{};
+    };
+
+    AM_NODISCARD uint64_t HashBlock(uint64_t parent_hash, std::span<const int32_t> tokens) const noexcept;
+    AM_NODISCARD Node* FindChild(Node& parent, uint64_t hash, std::span<const int32_t> tokens) const noexcept;
+    void ReleaseSubtree(Node& node) noexcept;
+
+    KVBlockPool* pool_ = nullptr;
+    size_t block_tokens_ = 0;
+    mutable std::mutex mutex_;
+    Node root_{};
+    uint64_t clock_ = 0;
+    size_t num_cached_blocks_ = 0;
+    size_t hit_blocks_ = 0;
+};
+
+}// namespace aethermind
+
+#endif
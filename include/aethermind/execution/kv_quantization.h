@@ -0,0 +1,81 @@
+#ifndef AETHERMIND_EXECUTION_KV_QUANTIZATION_H
+#define AETHERMIND_EXECUTION_KV_QUANTIZATION_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/dtypes/bfloat16.h"
+#include "aethermind/dtypes/data_type.h"
+#include "aethermind/dtypes/float8_e4m3fn.h"
+#include "aethermind/dtypes/float8_e5m2.h"
+#include "aethermind/dtypes/half.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace aethermind {
+
+/// Tokens per walk block of a dense INT8 KV layout; paged layouts walk their
+/// own blocks instead. Every token row has its own scale.
+inline constexpr size_t kKVDenseWalkBlockTokens = 32;
+
+/// Largest INT8 magnitude used by symmetric KV quantization.
+inline constexpr float kKVInt8MaxValue = 127.0F;
+
+/// KV storage dtypes KVCacheView converts to and from float32: the float32,
+/// float16 and bfloat16 activation types, INT8 with per-token-row
+/// scales, and unscaled FP8 (E4M3FN, E5M2).
+AM_NODISCARD bool IsSupportedKVStorageDType(const DataType& dtype) noexcept;
+
+/// True for storage dtypes that carry a per-row scale (INT8).
+AM_NODISCARD bool IsScaledKVStorageDType(const DataType& dtype) noexcept;
+
+/// Invokes `fn` with a value-initialized element of the C++ type that stores
+/// `dtype`. Kernels use it to hoist the dtype switch out of their inner loop
+/// and dequantize on the fly. Returns InvalidArgument for other dtypes.
+template<typename Fn>
+Status VisitKVStorageType(const DataType& dtype, Fn&& fn) {
+    if (dtype == DataType::Float32()) {
+        return fn(float{});
+    }
+    if (dtype == DataType::Float(16)) {
+        return fn(Half{});
+    }
+    if (dtype == DataType::BFloat(16)) {
+        return fn(BFloat16{});
+    }
+    if (dtype == DataType::Int(8)) {
+        return fn(int8_t{});
+    }
+    if (dtype == DataType::Float8E4M3FN()) {
+        return fn(Float8_e4m3fn{});
+    }
+    if (dtype == DataType::Float8E5M2()) {
+        return fn(Float8_e5m2{});
+    }
+    return Status::InvalidArgument("Unsupported KV storage dtype");
+}
+
+/// Reads one stored element as float. `scale` is ignored by unscaled types.
+template<typename T>
+AM_NODISCARD inline float LoadKVElement(const T* row, size_t i, float scale) noexcept {
+    if constexpr (std::is_same_v<T, int8_t>) {
+        return static_cast<float>(row[i]) * scale;
+    } else {
+        return static_cast<float>(row[i]);
+    }
+}
+
+/// Returns the INT8 scale that represents `values` without clipping.
+AM_NODISCARD float ComputeKVInt8Scale(std::span<const float> values) noexcept;
+
+/// Converts `src` to `dtype` in `dst`, dividing by `scale` for INT8.
+Status QuantizeKVRow(const DataType& dtype, std::span<const float> src, float scale, void* dst) noexcept;
+
+/// Converts `src` of `dtype` to float32 in `dst`, multiplying by `scale` for INT8.
+Status DequantizeKVRow(const DataType& dtype, const void* src, float scale, std::span<float> dst) noexcept;
+
+}// namespace aethermind
+
+#endif
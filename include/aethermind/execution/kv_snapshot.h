@@ -0,0 +1,86 @@
+#ifndef AETHERMIND_EXECUTION_KV_SNAPSHOT_H
+#define AETHERMIND_EXECUTION_KV_SNAPSHOT_H
+
+#include "aethermind/base/mmap_file.h"
+#include "aethermind/execution/kv_cache_view.h"
+#include "aethermind/execution/runtime_binding_context.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace aethermind {
+
+/// Storage options of a session snapshot file.
+struct KVSnapshotOptions {
+    /// Element dtype of the saved rows; undefined keeps the cache dtype. Any
+    /// KV storage dtype is accepted, so a float32 cache can be saved as
+    /// float16, FP8 or INT8 (one scale per row) to shrink idle sessions.
+    DataType storage_dtype{};
+};
+
+/// Header at the start of a snapshot file. On disk its fields are packed in
+/// declaration order with no padding (the dtype as code, bits, lanes) and
+/// zero-filled to kKVSnapshotHeaderBytes, so no uninitialized bytes reach
+/// the file. The payload follows as one record per (layer, kv_head,
+/// position) in that order, covering the resident committed range
+/// [window_begin, committed_tokens). A record is the key row then the value
+/// row, each preceded by a float scale when `storage_dtype` is scaled.
+struct KVSnapshotHeader {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t num_layers = 0;
+    uint64_t num_kv_heads = 0;
+    uint64_t head_dim = 0;
+    DLDataType storage_dtype{};
+    uint64_t window_begin = 0;
+    uint64_t committed_tokens = 0;
+    uint64_t prompt_len = 0;
+    uint64_t generated_len = 0;
+    uint8_t prefill_done = 0;
+};
+
+/// Bytes the header occupies on disk; the payload starts here.
+inline constexpr size_t kKVSnapshotHeaderBytes = 72;
+
+/// Writes the committed KV rows of `view` and its sequence state to `path`.
+/// The file is staged next to `path` under a per-process name and renamed
+/// into place, so concurrent savers and crashes never expose a truncated
+/// snapshot. The staging file is removed when saving fails.
+Status SaveKVSnapshot(const KVCacheView& view,
+                      const RuntimeSequenceState& state,
+                      const std::filesystem::path& path,
+                      const KVSnapshotOptions& options = {});
+
+/// Read-only, memory-mapped snapshot file. Rows are dequantized on demand,
+/// so restoring touches each page once.
+class KVSnapshot {
+public:
+    AM_NODISCARD static StatusOr<KVSnapshot> Open(const std::filesystem::path& path);
+
+    AM_NODISCARD const KVSnapshotHeader& header() const noexcept {
+        return header_;
+    }
+
+    /// Sequence state at save time, with nothing prepared or in flight.
+    AM_NODISCARD RuntimeSequenceState sequence_state() const noexcept;
+
+    /// Dequantizes saved token `seq_pos` of (`layer_idx`, `kv_head_idx`).
+    AM_NODISCARD Status ReadToken(size_t layer_idx,
+                                  size_t kv_head_idx,
+                                  size_t seq_pos,
+                                  std::span<float> key,
+                                  std::span<float> value) const noexcept;
+
+private:
+    KVSnapshot(MemoryMappedFile file, const KVSnapshotHeader& header) noexcept;
+
+    MemoryMappedFile file_;
+    KVSnapshotHeader header_{};
+    size_t row_bytes_ = 0;
+    size_t scale_bytes_ = 0;
+};
+
+}// namespace aethermind
+
+#endif
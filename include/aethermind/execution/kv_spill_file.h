@@ -0,0 +1,71 @@
+#ifndef AETHERMIND_EXECUTION_KV_SPILL_FILE_H
+#define AETHERMIND_EXECUTION_KV_SPILL_FILE_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace aethermind {
+
+/// Disk tier of a paged KV cache: a file of fixed-size records, each holding
+/// one offloaded KV block, accessed with pread/pwrite.
+///
+/// The file is unlinked as soon as it is created, so its space returns to the
+/// filesystem when the spill file is destroyed, even after a crash. Records
+/// are recycled through a free list; reads and writes of different records
+/// may run concurrently.
+class KVSpillFile {
+public:
+    static constexpr uint32_t kInvalidRecord = std::numeric_limits<uint32_t>::max();
+
+    ~KVSpillFile();
+    KVSpillFile(const KVSpillFile&) = delete;
+    KVSpillFile& operator=(const KVSpillFile&) = delete;
+
+    /// Creates an empty spill file at `path` holding at most `max_records`
+    /// records of `record_bytes`. The free list is sized for all of them up
+    /// front, so Free() never allocates.
+    AM_NODISCARD static StatusOr<std::unique_ptr<KVSpillFile>> Create(const std::filesystem::path& path,
+                                                                      size_t record_bytes,
+                                                                      uint32_t max_records);
+
+    /// Stores the concatenation of `parts` (exactly record_bytes() in total)
+    /// in a free record and returns its index. Fails with ResourceExhausted
+    /// once all `max_records` records hold a block.
+    AM_NODISCARD StatusOr<uint32_t> Write(std::span<const std::span<const std::byte>> parts);
+
+    /// Reads record `record` back into the concatenation of `parts`.
+    AM_NODISCARD Status Read(uint32_t record, std::span<const std::span<std::byte>> parts) const;
+
+    /// Returns `record` to the free list.
+    void Free(uint32_t record) noexcept;
+
+    AM_NODISCARD size_t record_bytes() const noexcept {
+        return record_bytes_;
+    }
+    /// Records currently holding a block.
+    AM_NODISCARD size_t num_records() const noexcept;
+
+private:
+    KVSpillFile(int fd, size_t record_bytes, uint32_t max_records) noexcept
+        : fd_(fd), record_bytes_(record_bytes), max_records_(max_records) {}
+
+    int fd_ = -1;
+    size_t record_bytes_ = 0;
+    uint32_t max_records_ = 0;
+    mutable std::mutex mutex_;
+    std::vector<uint32_t> free_records_{};
+    uint32_t next_record_ = 0;
+};
+
+}// namespace aethermind
+
+#endif
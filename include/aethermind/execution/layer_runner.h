@@ -14,14 +14,20 @@ public:
                                    RuntimeBindingContext& bindings) noexcept;
 
 private:
-    AM_NODISCARD static Status RunStep(size_t step_index,
+    AM_NODISCARD static Status RunStep(uint64_t plan_id,
+                                       size_t step_index,
                                        const ExecutionStep& step,
                                        RuntimeBindingContext& bindings,
                                        const StateAliasPlan& alias_plan) noexcept;
 
-    AM_NODISCARD static Status ValidateStateAliasesForStep(
+    AM_NODISCARD static Status ValidateRuntimeChecksForStep(
+            uint64_t plan_id,
             size_t step_index,
             const ExecutionStep& step,
+            RuntimeBindingContext& bindings) noexcept;
+
+    AM_NODISCARD static Status ValidateStateAliasesForStep(
+            size_t step_index,
             const StateAliasPlan& alias_plan,
             const RuntimeBindingContext& bindings) noexcept;
 };
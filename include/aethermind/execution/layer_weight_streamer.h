@@ -0,0 +1,99 @@
+#ifndef AETHERMIND_EXECUTION_LAYER_WEIGHT_STREAMER_H
+#define AETHERMIND_EXECUTION_LAYER_WEIGHT_STREAMER_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/execution/runtime_binding_context.h"
+#include "aethermind/model/resolved_model_weights.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aethermind {
+
+struct LayerWeightStreamerOptions {
+    /// Decoder layers ahead of the executing one whose weights are requested
+    /// with kWillNeed. Clamped to the number of layers minus one.
+    size_t lookahead_layers = 1;
+    /// Reclaims the pages of layers outside the window with kPageOut, so the
+    /// resident set stays near lookahead_layers + 1 layers.
+    bool evict_finished_layers = true;
+};
+
+/// Streams decoder-layer weights of a memory-mapped checkpoint through RAM
+/// for models larger than it.
+///
+/// Installed as the LayerExecutionObserver of a RuntimeBindingContext, it
+/// hands every layer transition to a background thread, which advises the
+/// byte ranges of the next layers with kWillNeed and those of layers that
+/// have run with kPageOut. Page faults of the executing layer then hit
+/// pages the kernel has already read ahead sequentially. Layer windows wrap,
+/// so while the last layer runs the first ones are fetched for the next
+/// token.
+///
+/// Transitions arriving faster than the thread advises them are coalesced
+/// into the latest one. Hints only affect paging: weights of storage without
+/// a file mapping, or packed copies of the checkpoint, are left alone.
+class LayerWeightStreamer final : public LayerExecutionObserver {
+public:
+    ~LayerWeightStreamer() override;
+    LayerWeightStreamer(const LayerWeightStreamer&) = delete;
+    LayerWeightStreamer& operator=(const LayerWeightStreamer&) = delete;
+
+    /// Collects the per-layer byte ranges of `weights` and starts the advice
+    /// thread. The ranges keep their storage alive.
+    AM_NODISCARD static StatusOr<std::unique_ptr<LayerWeightStreamer>> Create(
+            const ResolvedModelWeights& weights,
+            LayerWeightStreamerOptions options = {});
+
+    void OnLayerBegin(uint32_t layer_index) noexcept override;
+
+    /// Blocks until every transition reported so far has been advised.
+    void WaitIdle();
+
+    /// First failed hint, or Ok. Failures never stop streaming.
+    AM_NODISCARD Status status() const;
+
+    AM_NODISCARD size_t num_layers() const noexcept {
+        return layer_ranges_.size();
+    }
+
+private:
+    struct WeightRange {
+        std::shared_ptr<const RawStorage> storage{};
+        const std::byte* data = nullptr;
+        size_t bytes = 0;
+    };
+
+    LayerWeightStreamer(std::vector<std::vector<WeightRange>> layer_ranges,
+                        LayerWeightStreamerOptions options) noexcept;
+
+    void WorkerLoop();
+    void AdviseWindow(uint32_t layer);
+    void AdviseLayer(size_t layer, MemoryMappedFile::Advice advice);
+
+    std::vector<std::vector<WeightRange>> layer_ranges_;
+    LayerWeightStreamerOptions options_;
+
+    // Owned by the worker thread.
+    std::vector<bool> advised_{};
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    uint64_t requested_generation_ = 0;
+    uint64_t advised_generation_ = 0;
+    uint32_t target_layer_ = 0;
+    bool stop_ = false;
+    Status first_error_ = Status::Ok();
+    std::thread worker_;
+};
+
+}// namespace aethermind
+
+#endif
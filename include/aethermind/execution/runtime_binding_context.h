@@ -4,11 +4,14 @@
 #include "aethermind/base/status.h"
 #include "aethermind/base/tensor_view.h"
 #include "aethermind/execution/kv_cache_view.h"
+#include "aethermind/execution/shape_check_cache.h"
 #include "aethermind/runtime/workspace.h"
 #include "aethermind/base/macros.h"
 #include "workspace_arena.h"
 
 #include <array>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace aethermind {
@@ -35,6 +38,31 @@ struct RuntimeSequenceState {
     size_t prompt_len = 0;
     size_t generated_len = 0;
     size_t current_pos = 0;
+    /// Tokens fed to the plan being executed. They occupy positions
+    /// [current_pos, current_pos + step_tokens) and are not yet committed to
+    /// the KV cache; attention covers the committed prefix plus these tokens.
+    size_t step_tokens = 0;
+    /// Key of the session's sampling stream. Sample draws the token that
+    /// follows position p from counter p of this stream.
+    uint64_t sampling_seed = 0;
+};
+
+/// Sessions decoded together by one batched step. Row b of the step's
+/// `[B, hidden]` activations belongs to `kv_cache_views[b]` and is decoded at
+/// position `positions[b]`, which is not yet committed in that view.
+struct DecodeBatchBinding {
+    std::span<KVCacheView> kv_cache_views{};
+    std::span<const size_t> positions{};
+    /// RuntimeSequenceState::sampling_seed of every row; empty means 0.
+    std::span<const uint64_t> sampling_seeds{};
+
+    AM_NODISCARD size_t batch_size() const noexcept {
+        return kv_cache_views.size();
+    }
+
+    AM_NODISCARD bool valid() const noexcept {
+        return !kv_cache_views.empty() && kv_cache_views.size() == positions.size();
+    }
 };
 
 /// Per-step tensor binding passed to the executor before Execute().
@@ -46,6 +74,16 @@ struct StepTensorBinding {
     std::vector<MutableTensorView> outputs;
 };
 
+/// Notified by LayerRunner as execution enters each decoder layer. Called on
+/// the executing thread between steps, so implementations must return
+/// quickly and hand any real work to another thread.
+class LayerExecutionObserver {
+public:
+    virtual ~LayerExecutionObserver() = default;
+
+    virtual void OnLayerBegin(uint32_t layer_index) noexcept = 0;
+};
+
 class RuntimeBindingContext {
 public:
     RuntimeBindingContext() = default;
@@ -63,10 +101,22 @@ public:
 
     AM_NODISCARD const KVCacheView& kv_cache_view() const noexcept;
 
+    AM_NODISCARD KVCacheView& mutable_kv_cache_view() noexcept;
+
     AM_NODISCARD bool HasKVCacheView() const noexcept;
 
     void ClearKVCacheView() noexcept;
 
+    /// Binds the sessions of a batched decode step. The spans are borrowed
+    /// and must outlive the Execute() call they are bound for.
+    void SetDecodeBatchBinding(const DecodeBatchBinding& binding) noexcept;
+
+    AM_NODISCARD const DecodeBatchBinding& decode_batch_binding() const noexcept;
+
+    AM_NODISCARD bool HasDecodeBatchBinding() const noexcept;
+
+    void ClearDecodeBatchBinding() noexcept;
+
     void SetTempBufferBinding(TempBufferKind kind,
                               const TempBufferBinding& binding) noexcept;
 
@@ -89,6 +139,22 @@ public:
     AM_NODISCARD StatusOr<const StepTensorBinding*> GetStepTensorBinding(
             size_t step_index) const noexcept;
 
+    void SetShapeCheckMode(RuntimeShapeCheckMode mode) noexcept;
+
+    AM_NODISCARD RuntimeShapeCheckMode shape_check_mode() const noexcept;
+
+    /// Shape signatures verified in RuntimeShapeCheckMode::kCached. Survives
+    /// Reset() because a verified signature stays valid across sequences.
+    AM_NODISCARD ShapeCheckCache& mutable_shape_check_cache() noexcept;
+
+    AM_NODISCARD const ShapeCheckCache& shape_check_cache() const noexcept;
+
+    /// Borrowed observer of decoder-layer transitions, or nullptr. Survives
+    /// Reset() like the workspace arena.
+    void SetLayerObserver(LayerExecutionObserver* observer) noexcept;
+
+    AM_NODISCARD LayerExecutionObserver* layer_observer() const noexcept;
+
     void Reset() noexcept;
 
 private:
@@ -98,9 +164,13 @@ private:
 
     WorkspaceArena* workspace_arena_ = nullptr;
     KVCacheView kv_cache_view_{};
+    DecodeBatchBinding decode_batch_{};
     std::array<TempBufferBinding, static_cast<size_t>(TempBufferKind::kCount)> temp_buffers_{};
     RuntimeSequenceState sequence_state_{};
     std::vector<StepTensorBinding> step_tensor_bindings_{};
+    RuntimeShapeCheckMode shape_check_mode_ = RuntimeShapeCheckMode::kEveryStep;
+    ShapeCheckCache shape_check_cache_{};
+    LayerExecutionObserver* layer_observer_ = nullptr;
 };
 
 }// namespace aethermind
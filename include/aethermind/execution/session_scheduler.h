@@ -0,0 +1,166 @@
+#ifndef AETHERMIND_EXECUTION_SESSION_SCHEDULER_H
+#define AETHERMIND_EXECUTION_SESSION_SCHEDULER_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/status.h"
+#include "aethermind/execution/kv_cache_manager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <unordered_map>
+#include <vector>
+
+namespace aethermind {
+
+/// How SessionScheduler frees KV memory held by a lower-priority session.
+enum class PreemptionMode : uint8_t {
+    /// Park the victim's private blocks on the disk tier. It keeps its slot
+    /// and resumes after a prefetch without recomputing anything. Falls back
+    /// to kRecompute when the manager has no disk tier.
+    kSwap = 0,
+    /// Release the victim's reservation and requeue it. Its prompt and the
+    /// tokens it generated are prefilled again when it is readmitted.
+    kRecompute,
+};
+
+struct SessionSchedulerOptions {
+    /// Sessions that may run a prefill chunk in one iteration. Decode steps
+    /// of running sessions are always scheduled, so a burst of new prompts
+    /// delays decoding by at most this many chunks per token.
+    size_t max_prefills_per_step = 1;
+
+    /// Most sessions decoded by one iteration, e.g. DecodeBatch::max_batch();
+    /// 0 means unbounded.
+    size_t max_decode_batch = 0;
+
+    PreemptionMode preemption = PreemptionMode::kSwap;
+};
+
+/// One generation request as seen by admission control.
+struct ScheduleRequest {
+    uint64_t session_id = 0;
+    size_t prompt_len = 0;
+    size_t max_new_tokens = 0;
+    /// Larger values are admitted first and preempted last.
+    int32_t priority = 0;
+};
+
+enum class SessionPhase : uint8_t {
+    /// Submitted or preempted with kRecompute; holds no KV memory.
+    kWaiting = 0,
+    /// Holds a KV reservation; prefilling or decoding.
+    kRunning,
+    /// Preempted with kSwap; its private blocks are on disk.
+    kSwapped,
+    /// Swapped blocks are being prefetched back into the pool.
+    kResuming,
+};
+
+/// Work for one engine iteration, produced by SessionScheduler::Schedule().
+struct SchedulePlan {
+    /// Sessions to decode one token each, e.g. as one DecodeBatch step.
+    std::vector<uint64_t> decode;
+    /// Sessions to run their next prefill chunk.
+    std::vector<uint64_t> prefill;
+    /// Sessions preempted while building this plan. Their views are no
+    /// longer usable and they must leave any DecodeBatch.
+    std::vector<uint64_t> preempted;
+};
+
+/// KV-memory-aware admission and preemption for the sessions of one
+/// KVCacheManager.
+///
+/// Admission reserves the blocks a request needs for its whole lifetime,
+/// KVCacheManager::ProjectedBlocks(prompt_len, max_new_tokens), against
+/// KVCacheManager::BlockBudget(). Admitted sessions therefore never hit
+/// ResourceExhausted mid-generation. Requests that do not fit wait in
+/// priority order, FIFO within a priority. A waiting request with a higher
+/// priority than some running session preempts the lowest-priority, most
+/// recently admitted running sessions until it fits.
+///
+/// The scheduler owns the KV reservations it makes: view() hands them to the
+/// engine, and Finish() releases them. It is not thread-safe; one engine
+/// loop drives it.
+class SessionScheduler {
+public:
+    explicit SessionScheduler(KVCacheManager& manager,
+                              SessionSchedulerOptions options = {}) noexcept;
+
+    SessionScheduler(const SessionScheduler&) = delete;
+    SessionScheduler& operator=(const SessionScheduler&) = delete;
+    ~SessionScheduler();
+
+    /// Queues a request. Fails with AlreadyExists for a known session and
+    /// with ResourceExhausted when the request alone exceeds the KV budget.
+    AM_NODISCARD Status Submit(const ScheduleRequest& request);
+
+    /// Plans the next iteration: every running session that is decoding,
+    /// then at most `max_prefills_per_step` prefilling sessions, admitting
+    /// swapped and waiting sessions as the budget allows.
+    AM_NODISCARD StatusOr<SchedulePlan> Schedule();
+
+    /// Drops a session in any phase and releases its KV reservation.
+    AM_NODISCARD Status Finish(uint64_t session_id);
+
+    /// KV view of a running session. Stays valid until the session is
+    /// preempted or finished.
+    AM_NODISCARD StatusOr<KVCacheView*> view(uint64_t session_id) noexcept;
+
+    AM_NODISCARD StatusOr<SessionPhase> phase(uint64_t session_id) const noexcept;
+
+    /// Current request of a session. A session preempted with kRecompute
+    /// has its generated tokens folded into `prompt_len`.
+    AM_NODISCARD StatusOr<ScheduleRequest> request(uint64_t session_id) const noexcept;
+
+    /// Budget units held by running and resuming sessions, plus the blocks
+    /// swapped sessions keep mapped because the prefix cache shares them.
+    AM_NODISCARD size_t reserved_blocks() const noexcept;
+    AM_NODISCARD size_t num_sessions() const noexcept;
+
+private:
+    struct Session {
+        ScheduleRequest request{};
+        SessionPhase phase = SessionPhase::kWaiting;
+        KVCacheView view{};
+        size_t projected_blocks = 0;
+        // Swapped: blocks that stayed mapped because the prefix cache shares
+        // them. They remain counted in reserved_blocks_.
+        size_t pinned_blocks = 0;
+        // Submission order; breaks priority ties.
+        uint64_t arrival = 0;
+        std::future<Status> prefetch{};
+    };
+
+    AM_NODISCARD bool Fits(size_t blocks) const noexcept;
+    // Budget units admitting or resuming `session` adds to reserved_blocks_.
+    AM_NODISCARD static size_t BlocksToAdmit(const Session& session) noexcept;
+    // Moves a session that leaves RAM to kSwapped, keeping only the blocks
+    // it still maps reserved.
+    void Park(Session& session) noexcept;
+    // Budget units preempting `victim` returns: a swap keeps the blocks the
+    // prefix cache shares, while a release (`need_slot`) frees them all.
+    AM_NODISCARD size_t BlocksFreedBy(const Session& victim, bool need_slot) const noexcept;
+    // Whether Preempt() would swap a victim out rather than release it.
+    AM_NODISCARD bool PreemptsBySwap(bool need_slot) const noexcept;
+    AM_NODISCARD bool IsPrefilling(const Session& session) const noexcept;
+    AM_NODISCARD bool IsDecoding(const Session& session) const noexcept;
+    // Sessions in `phase`, highest priority first, then oldest first.
+    AM_NODISCARD std::vector<Session*> SessionsIn(SessionPhase phase);
+    AM_NODISCARD Status PollPrefetches();
+    // Preempts running sessions below `priority` until `blocks` fit.
+    AM_NODISCARD Status PreemptFor(int32_t priority, size_t blocks, bool need_slot,
+                                   SchedulePlan& plan);
+    AM_NODISCARD Status Preempt(Session& victim, bool need_slot);
+    AM_NODISCARD Status Admit(Session& session);
+
+    KVCacheManager* manager_ = nullptr;
+    SessionSchedulerOptions options_{};
+    std::unordered_map<uint64_t, Session> sessions_{};
+    size_t reserved_blocks_ = 0;
+    uint64_t next_arrival_ = 0;
+};
+
+}// namespace aethermind
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef AETHERMIND_EXECUTION_SHAPE_CHECK_CACHE_H
+#define AETHERMIND_EXECUTION_SHAPE_CHECK_CACHE_H
+
+#include "aethermind/base/macros.h"
+#include "aethermind/base/tensor_view.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace aethermind {
+
+/// How LayerRunner validates ExecutionStep::runtime_checks.
+enum class RuntimeShapeCheckMode : uint8_t {
+    /// Evaluate every check before every step run.
+    kEveryStep = 0,
+    /// Evaluate a step's checks once per shape signature (the ranks and dims
+    /// of all bound inputs and outputs) and skip them while it repeats.
+    kCached,
+};
+
+/// Memoizes which step shape signatures already passed their runtime checks.
+///
+/// Shape constraints only read ranks and dims, so a signature that passed
+/// once passes again. Each step remembers its last kWays verified
+/// signatures, keyed by ExecutionPlan::id(), so a session alternating
+/// between prefill and decode plans of one family keeps hitting.
+///
+/// Reserve() sizes the signature storage when a step is bound; lookups and
+/// updates afterwards never allocate, which keeps them on LayerRunner's
+/// noexcept path.
+class ShapeCheckCache {
+public:
+    /// Signatures remembered per step; the oldest is replaced beyond this.
+    static constexpr size_t kWays = 4;
+
+    /// Makes room for the signature of `inputs`/`outputs` at `step_index`.
+    void Reserve(size_t step_index,
+                 std::span<const TensorView> inputs,
+                 std::span<const MutableTensorView> outputs);
+
+    /// Returns true if `inputs`/`outputs` match a signature verified for
+    /// `step_index` of plan `plan_id`. Updates hit/miss counters.
+    AM_NODISCARD bool IsVerified(uint64_t plan_id,
+                                 size_t step_index,
+                                 std::span<const TensorView> inputs,
+                                 std::span<const MutableTensorView> outputs) noexcept;
+
+    /// Records that `inputs`/`outputs` passed the runtime checks of the step.
+    /// A signature larger than the reserved storage is not remembered.
+    void MarkVerified(uint64_t plan_id,
+                      size_t step_index,
+                      std::span<const TensorView> inputs,
+                      std::span<const MutableTensorView> outputs) noexcept;
+
+    void Clear() noexcept;
+
+    AM_NODISCARD size_t hit_count() const noexcept;
+    AM_NODISCARD size_t miss_count() const noexcept;
+
+private:
+    struct Way {
+        uint64_t plan_id = 0;
+        /// Used prefix of `signature`; 0 means the way is empty.
+        size_t length = 0;
+        /// Sized by Reserve() and only overwritten in place afterwards.
+        std::vector<int64_t> signature{};
+    };
+
+    struct StepEntry {
+        std::array<Way, kWays> ways{};
+        size_t next = 0;
+    };
+
+    std::vector<StepEntry> steps_{};
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+}// namespace aethermind
+
+#endif
@@ -10,6 +10,16 @@
 
 namespace aethermind {
 
+/// Storage that an aliased input/output port pair shares at runtime.
+enum class StateAliasKind : uint8_t {
+    /// KV cache update: both ports refer to the session KVCacheView storage.
+    kKVCache = 0,
+    /// In-place activation: the output is written over a dead activation
+    /// input. Only emitted for elementwise operators, whose schema ports all
+    /// contribute tensor specs, so the ports also index StepTensorBinding.
+    kActivation,
+};
+
 /// Runtime resolved state alias record.
 /// It uses step/port coordinates rather than GraphValueId, so the executor can
 /// query aliases without depending on ModelGraph lowering artifacts.
@@ -17,6 +27,7 @@ struct ResolvedStateAlias {
     size_t step_index = 0;
     uint32_t input_port = 0;
     uint32_t output_port = 0;
+    StateAliasKind kind = StateAliasKind::kKVCache;
 };
 
 /// Runtime state alias plan carried by ExecutionPlan and queried by step.
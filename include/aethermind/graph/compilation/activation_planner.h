@@ -0,0 +1,68 @@
+#ifndef AETHERMIND_GRAPH_COMPILATION_ACTIVATION_PLANNER_H
+#define AETHERMIND_GRAPH_COMPILATION_ACTIVATION_PLANNER_H
+
+/// @file activation_planner.h
+/// @brief Lowering-time memory planning for intermediate activations.
+///
+/// AddInPlaceActivationAliases() marks elementwise steps that can overwrite a
+/// dead input; PlanActivationBuffers() places every intermediate activation in
+/// one arena, sharing bytes between values whose live ranges do not overlap.
+#include "aethermind/execution/activation_plan.h"
+#include "aethermind/graph/compilation/graph_lowering.h"
+#include "aethermind/shape_inference/shape_symbol.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aethermind {
+
+/// @brief Concrete upper bound used to size activations with a symbolic dimension.
+struct ActivationSymbolBound {
+    ShapeSymbol symbol = ShapeSymbol::Unknown();
+    int64_t max_value = 0;
+};
+
+/// @brief Knobs for PlanActivationBuffers().
+struct ActivationPlannerConfig {
+    /// Upper bounds for every symbolic dimension that appears in an
+    /// intermediate activation, e.g. the sequence symbol bound to the largest
+    /// prefill chunk.
+    std::vector<ActivationSymbolBound> symbol_bounds{};
+
+    /// Alignment of each activation slice. Must be a non-zero power of two.
+    size_t alignment = 64;
+};
+
+/// @brief Appends kActivation state aliases for steps that can run in place.
+///
+/// A step qualifies when its operator supports in-place activation (see
+/// SupportsInPlaceActivation()) and one of its activation inputs:
+/// - is produced by an earlier step,
+/// - has the same TensorSpec as the step output,
+/// - is neither a model output nor part of a state alias, and
+/// - has no consumer after this step.
+/// At most one alias is emitted per step; the first qualifying port wins.
+///
+/// @param lowered Graph to annotate. Existing aliases are preserved.
+/// @return Ok, or an error when an operator schema cannot be found.
+AM_NODISCARD Status AddInPlaceActivationAliases(LoweredGraph& lowered);
+
+/// @brief Places every intermediate activation of a lowered graph in one arena.
+///
+/// Each activation output port of each step is live from its producing step
+/// to its last consumer, or to the end of the graph for model outputs. An
+/// output aliased in place over an input inherits that input's slice.
+/// Slices are placed with PlanWorkspaceRequirementsForLiveRanges().
+///
+/// @param lowered Graph to plan. kActivation aliases are honored.
+/// @param config Symbol bounds and slice alignment.
+/// @return ActivationPlan, or InvalidArgument when an activation dimension is
+/// unknown or symbolic without a bound.
+AM_NODISCARD StatusOr<ActivationPlan> PlanActivationBuffers(
+        const LoweredGraph& lowered,
+        const ActivationPlannerConfig& config = {});
+
+}// namespace aethermind
+
+#endif
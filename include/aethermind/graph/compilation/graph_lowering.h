@@ -14,6 +14,7 @@
 #include "aethermind/graph/graph.h"
 #include "aethermind/base/macros.h"
 
+#include <optional>
 #include <vector>
 
 namespace aethermind {
@@ -27,6 +28,9 @@ struct GraphLoweringConfig {
     IsaLevel isa = IsaLevel::kScalar;
     WeightFormat weight_format = WeightFormat::kPlain;
     ExecPhase phase = ExecPhase::kBoth;
+    /// Emits kActivation state aliases for elementwise steps that can write
+    /// their output over a dead activation input. See AddInPlaceActivationAliases().
+    bool in_place_activations = false;
 };
 
 /// @brief Records a constant binding discovered during lowering for one input
@@ -45,8 +49,11 @@ struct LoweredConstantBinding {
 /// state ports that do not contribute to compact runtime tensor specs.
 /// `constant_bindings` captures ConstantValue payloads encountered on input
 /// ports so backend lowering can resolve them without revisiting the graph.
+/// `decoder_layer_index` mirrors GraphNode::decoder_layer_index so planners
+/// can reason about layer boundaries.
 struct LoweredStepBinding {
     GraphNodeId node{};
+    std::optional<uint32_t> decoder_layer_index{};
     std::vector<GraphValueId> input_values{};
     std::vector<GraphValueId> output_values{};
     std::vector<LoweredConstantBinding> constant_bindings{};
@@ -59,6 +66,7 @@ struct LoweredStepBinding {
 struct LoweredStateAlias {
     GraphValueId input{};
     GraphValueId output{};
+    StateAliasKind kind = StateAliasKind::kKVCache;
 };
 
 /// @brief Direct 1:1 lowering artifact from semantic ModelGraph to execution
@@ -96,6 +104,7 @@ AM_NODISCARD StatusOr<LoweredGraph> LowerModelGraph(
 ///   .step_index  = step whose bindings contain both values,
 ///   .input_port  = port index of input in that step's input_values,
 ///   .output_port = port index of output in that step's output_values,
+///   .kind        = state_aliases[i].kind,
 /// }.
 ///
 /// @param lowered LoweredGraph whose state aliases should be resolved.
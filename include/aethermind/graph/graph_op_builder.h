@@ -252,6 +252,25 @@ StatusOr<GraphValueId> AddArgmax(ModelGraph& graph,
                                  int64_t axis,
                                  std::string name = {});
 
+/// @brief Builds a Sample node drawing one token id per row of `input`
+///        along its last axis.
+///
+/// Output dtype (int64) and reduced shape are derived by operator semantic
+/// analysis; the caller must not supply an output spec.
+///
+/// @param graph Graph to mutate.
+/// @param decoder_layer_index Decoder layer index assigned to the new node.
+/// @param input Value id of the logits tensor.
+/// @param params Temperature, top-k, top-p and seed of the sampler.
+/// @param name Debug name for the new node.
+/// @return Value id of the sampled tokens, or an error status on validation
+///         failure.
+StatusOr<GraphValueId> AddSample(ModelGraph& graph,
+                                 std::optional<uint32_t> decoder_layer_index,
+                                 GraphValueId input,
+                                 const SampleParams& params,
+                                 std::string name = {});
+
 /// @brief Builds a semantic Reshape node.
 ///
 /// The output shape is derived entirely by InferReshape from `target_shape`
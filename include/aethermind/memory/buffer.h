@@ -49,6 +49,11 @@ public:
         return handle_.alignment();
     }
 
+    /// Whether the bytes may only be read; mutable_data() is then nullptr.
+    AM_NODISCARD bool read_only() const noexcept {
+        return handle_.read_only();
+    }
+
     BufferImpl(const BufferImpl&) = delete;
     BufferImpl(BufferImpl&&) noexcept = delete;
     BufferImpl& operator=(const BufferImpl&) = delete;
@@ -94,6 +99,10 @@ public:
         return impl_->alignment();
     }
 
+    AM_NODISCARD bool read_only() const noexcept {
+        return impl_->read_only();
+    }
+
     AM_NODISCARD uint32_t use_count() const noexcept {
         return impl_->use_count();
     }
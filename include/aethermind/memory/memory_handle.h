@@ -7,6 +7,10 @@
 
 #include "aethermind/base/device.h"
 
+#include <memory>
+#include <new>
+#include <utility>
+
 namespace aethermind {
 
 using memory_deleter_fn = void (*)(void* deleter_ctx, void* ptr);
@@ -30,6 +34,45 @@ public:
           alignment_(alignment),
           device_(device) {}
 
+    /// Wraps bytes the holder must never write, e.g. a read-only file
+    /// mapping. The mutable get() yields nullptr for such handles.
+    static MemoryHandle ReadOnly(const void* data,
+                                 void* deleter_ctx,
+                                 memory_deleter_fn deleter,
+                                 Device device,
+                                 size_t alignment = 0) noexcept {
+        MemoryHandle handle(const_cast<void*>(data), deleter_ctx, deleter, device, alignment);
+        handle.read_only_ = true;
+        return handle;
+    }
+
+    /// Wraps bytes kept alive by `owner`, e.g. a shared mapping. The handle
+    /// holds one reference and drops it on reset. Returns an empty handle if
+    /// `data` is null or that reference cannot be allocated.
+    static MemoryHandle Shared(void* data,
+                               std::shared_ptr<const void> owner,
+                               Device device,
+                               size_t alignment = 0) noexcept {
+        if (data == nullptr) {
+            return MemoryHandle{};
+        }
+        auto* owner_ref = new (std::nothrow) std::shared_ptr<const void>(std::move(owner));
+        if (owner_ref == nullptr) {
+            return MemoryHandle{};
+        }
+        return MemoryHandle(data, owner_ref, &ReleaseSharedOwner, device, alignment);
+    }
+
+    /// Read-only counterpart of Shared().
+    static MemoryHandle SharedReadOnly(const void* data,
+                                       std::shared_ptr<const void> owner,
+                                       Device device,
+                                       size_t alignment = 0) noexcept {
+        MemoryHandle handle = Shared(const_cast<void*>(data), std::move(owner), device, alignment);
+        handle.read_only_ = static_cast<bool>(handle);
+        return handle;
+    }
+
     ~MemoryHandle() noexcept {
         reset();
     }
@@ -47,7 +90,7 @@ public:
     }
 
     AM_NODISCARD void* get() noexcept {
-        return data_;
+        return read_only_ ? nullptr : data_;
     }
 
     AM_NODISCARD const void* get() const noexcept {
@@ -62,6 +105,10 @@ public:
         return alignment_;
     }
 
+    AM_NODISCARD bool read_only() const noexcept {
+        return read_only_;
+    }
+
     AM_NODISCARD void* context() const noexcept {
         return ctx_;
     }
@@ -84,6 +131,7 @@ public:
         deleter_ = nullptr;
         device_ = Device(kUndefined);
         alignment_ = 0;
+        read_only_ = false;
     }
 
     void swap(MemoryHandle& other) noexcept {
@@ -92,14 +140,20 @@ public:
         std::swap(deleter_, other.deleter_);
         std::swap(device_, other.device_);
         std::swap(alignment_, other.alignment_);
+        std::swap(read_only_, other.read_only_);
     }
 
 private:
+    static void ReleaseSharedOwner(void* deleter_ctx, void*) noexcept {
+        delete static_cast<std::shared_ptr<const void>*>(deleter_ctx);
+    }
+
     void* data_ = nullptr;
     void* ctx_ = nullptr;
     memory_deleter_fn deleter_ = nullptr;
     size_t alignment_ = 0;
     Device device_{kUndefined};
+    bool read_only_ = false;
 };
 
 inline bool operator==(const MemoryHandle& h, std::nullptr_t) noexcept {
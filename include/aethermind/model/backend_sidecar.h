@@ -1,24 +1,43 @@
 #ifndef AETHERMIND_MODEL_BACKEND_SIDECAR_H
 #define AETHERMIND_MODEL_BACKEND_SIDECAR_H
 
+#include "aethermind/backend/kernel_registry.h"
 #include "aethermind/backend/kernel_selector.h"
 #include "aethermind/backend/packed_weights.h"
 #include "aethermind/base/status.h"
+#include "aethermind/model/weight_quantization_policy.h"
 #include "aethermind/operators/op_type.h"
 
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace aethermind {
 
 class BackendSidecar {
 public:
+    /// Stores `packed_weights` under its (op_type, selector) pair only.
+    /// Rejects a second artifact for the same pair with AlreadyExists.
     Status Store(std::unique_ptr<PackedWeights> packed_weights) noexcept;
 
+    /// Stores the packed weight of one linear projection under its decoder
+    /// layer and role; lm_head has no layer and every other role needs one.
+    /// Many layers share a selector, so only the first artifact stored for
+    /// an (op_type, selector) pair also answers the pair's `Find`.
+    Status Store(std::optional<uint32_t> decoder_layer_index,
+                 WeightRole role,
+                 std::unique_ptr<PackedWeights> packed_weights) noexcept;
+
     AM_NODISCARD const PackedWeights* Find(
             OpType op_type,
             const KernelSelector& selector) const noexcept;
 
+    /// Returns the weight stored for `role` of `decoder_layer_index`, or
+    /// nullptr. Constant time: layers index a flat table of role slots.
+    AM_NODISCARD const PackedWeights* Find(std::optional<uint32_t> decoder_layer_index,
+                                           WeightRole role) const noexcept;
+
     AM_NODISCARD size_t size() const noexcept {
         return packed_weights_.size();
     }
@@ -28,7 +47,14 @@ public:
     }
 
 private:
+    /// Role slots per decoder layer: every role but kLmHead.
+    static constexpr size_t kLayerRoles = static_cast<size_t>(WeightRole::kLmHead);
+
     std::vector<std::unique_ptr<PackedWeights>> packed_weights_{};
+    std::unordered_map<RegistrationKey, const PackedWeights*, RegistrationKeyHash> by_selector_{};
+    /// `layer * kLayerRoles + role`, grown as layers are stored.
+    std::vector<const PackedWeights*> layer_weights_{};
+    const PackedWeights* lm_head_ = nullptr;
 };
 
 }// namespace aethermind
@@ -0,0 +1,156 @@
+#ifndef AETHERMIND_MODEL_FORMATS_GGUF_GGUF_READER_H
+#define AETHERMIND_MODEL_FORMATS_GGUF_GGUF_READER_H
+
+#include "aethermind/base/status.h"
+#include "aethermind/model/formats/hf/hf_model_config.h"
+#include "aethermind/model/raw_weight.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace aethermind {
+
+/// Value types of GGUF metadata entries, numbered as in the file.
+enum class GgufValueType : uint32_t {
+    kUInt8 = 0,
+    kInt8 = 1,
+    kUInt16 = 2,
+    kInt16 = 3,
+    kUInt32 = 4,
+    kInt32 = 5,
+    kFloat32 = 6,
+    kBool = 7,
+    kString = 8,
+    kArray = 9,
+    kUInt64 = 10,
+    kInt64 = 11,
+    kFloat64 = 12,
+};
+
+/// GGML tensor types a GGUF file may declare, numbered as `ggml_type`.
+enum class GgufTensorType : uint32_t {
+    kF32 = 0,
+    kF16 = 1,
+    kQ4_0 = 2,
+    kQ4_1 = 3,
+    kQ5_0 = 6,
+    kQ5_1 = 7,
+    kQ8_0 = 8,
+    kQ8_1 = 9,
+    kQ2_K = 10,
+    kQ3_K = 11,
+    kQ4_K = 12,
+    kQ5_K = 13,
+    kQ6_K = 14,
+    kQ8_K = 15,
+    kBF16 = 30,
+};
+
+AM_NODISCARD const char* ToString(GgufTensorType type) noexcept;
+
+/// One metadata entry. Integers widen to int64/uint64 by signedness and
+/// floats to double. Arrays keep only their element type and length, which
+/// is all the loader reads from them (e.g. the vocabulary size).
+struct GgufMetadataValue {
+    GgufValueType type = GgufValueType::kUInt8;
+    std::variant<uint64_t, int64_t, double, bool, std::string> scalar{};
+    GgufValueType array_type = GgufValueType::kUInt8;
+    uint64_t array_length = 0;
+};
+
+/// One entry of the tensor-info table. `shape` is row-major; GGUF lists
+/// dimensions innermost first, so it is the file's order reversed.
+struct GgufTensorInfo {
+    std::string name{};
+    GgufTensorType type = GgufTensorType::kF32;
+    std::vector<int64_t> shape{};
+    /// Offset from the start of the aligned tensor data section.
+    uint64_t offset = 0;
+    size_t bytes = 0;
+};
+
+/// Reads a single-file GGUF (version 2 or 3) checkpoint, the
+/// llama.cpp counterpart of HfDirectoryReader.
+///
+/// `Open` maps the file once and parses its header, metadata and tensor
+/// table; later calls read nothing more from disk. Tensors are exposed as
+/// RawWeightViews over that one mapping under the Hugging Face names the
+/// rest of the loader resolves, so GGUF and safetensors checkpoints share
+/// validation, resolution and prepacking.
+///
+/// F32, F16 and BF16 tensors become dense views. Q8_0 and Q4_0 tensors keep
+/// their blocks as kGgmlQ8_0/kGgmlQ4_0 views, which the prepacker converts
+/// losslessly into the INT8/INT4 CpuQuantizedWeightLayout. A Q8_0 or Q4_0
+/// `token_embd` (and so a tied lm_head) is the exception: embeddings are
+/// gathered rather than packed, so it is decoded once into a float32 heap
+/// copy. Other block-quantized types (K-quants, Q4_1, Q5_x) are listed by
+/// `Tensors()` but rejected by `LoadRawWeightTable()`.
+///
+/// llama.cpp's converter reorders the rows of llama attn_q/attn_k weights
+/// so RoPE rotates adjacent pairs instead of the two head halves. Those
+/// views keep the file's bytes and record the head count in
+/// RawWeightView::interleaved_rope_heads; prepacking restores the Hugging
+/// Face row order.
+class GgufReader {
+public:
+    /// Maps and parses the GGUF file at `path`.
+    ///
+    /// @return A reader over the mapped file, or an error if the file is
+    /// missing, truncated, of an unsupported version, or declares unknown
+    /// tensor types or tensors outside the data section.
+    AM_NODISCARD static StatusOr<GgufReader> Open(const std::filesystem::path& path);
+
+    AM_NODISCARD const std::filesystem::path& path() const noexcept {
+        return path_;
+    }
+
+    AM_NODISCARD uint32_t version() const noexcept {
+        return version_;
+    }
+
+    /// Tensor infos in file order.
+    AM_NODISCARD const std::vector<GgufTensorInfo>& Tensors() const noexcept {
+        return tensors_;
+    }
+
+    /// Returns the metadata entry named `key`, or nullptr.
+    AM_NODISCARD const GgufMetadataValue* FindMetadata(std::string_view key) const;
+
+    /// Maps `general.architecture` and its `<arch>.*` hyperparameters onto
+    /// HfModelConfig. The vocabulary size falls back to the length of
+    /// `tokenizer.ggml.tokens`, and embeddings count as tied when the file
+    /// has no `output.weight` tensor.
+    AM_NODISCARD StatusOr<HfModelConfig> ParseConfig() const;
+
+    /// Returns zero-copy views of every tensor, keyed by its Hugging Face
+    /// name where one is known and by its GGUF name otherwise.
+    AM_NODISCARD StatusOr<RawWeightTable> LoadRawWeightTable() const;
+
+    /// Fingerprint of the checkpoint, for keying caches derived from it.
+    ///
+    /// Hashes the header, metadata and tensor table plus the file's size and
+    /// modification time; tensor data is not read.
+    AM_NODISCARD StatusOr<uint64_t> ComputeFingerprint() const;
+
+private:
+    GgufReader() = default;
+
+    std::filesystem::path path_{};
+    uint32_t version_ = 0;
+    std::shared_ptr<const RawStorage> storage_{};
+    const std::byte* file_data_ = nullptr;
+    size_t data_offset_ = 0;
+    std::unordered_map<std::string, GgufMetadataValue> metadata_{};
+    std::vector<GgufTensorInfo> tensors_{};
+};
+
+}// namespace aethermind
+
+#endif
@@ -5,6 +5,7 @@
 #include "aethermind/model/formats/hf/hf_model_config.h"
 #include "aethermind/model/raw_weight.h"
 
+#include <cstdint>
 #include <filesystem>
 #include <utility>
 
@@ -81,6 +82,15 @@ public:
     /// indexed tensor must be present exactly once.
     AM_NODISCARD StatusOr<RawWeightTable> LoadRawWeightTable() const;
 
+    /// Fingerprint of the checkpoint this reader loads, for keying caches
+    /// derived from it.
+    ///
+    /// Hashes `config.json` plus the name, size and modification time of every
+    /// weight file. Weight contents are not read, so a checkpoint must be
+    /// replaced rather than edited in place, the same rule the mmap path
+    /// already imposes.
+    AM_NODISCARD StatusOr<uint64_t> ComputeFingerprint() const;
+
 private:
     explicit HfDirectoryReader(HfDirectoryDescriptor dir_desc) noexcept
         : dir_desc_(std::move(dir_desc)) {}
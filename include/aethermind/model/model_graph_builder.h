@@ -5,14 +5,20 @@
 #include "aethermind/graph/graph.h"
 #include "aethermind/model/formats/hf/hf_model_config.h"
 #include "aethermind/model/resolved_model_weights.h"
+#include "aethermind/operators/op_params.h"
+
+#include <optional>
 
 namespace aethermind {
 
 class ModelGraphBuilder {
 public:
+    /// Builds the decoder graph ending in greedy Argmax, or in a Sample node
+    /// with `sampling` when it is set.
     AM_NODISCARD static StatusOr<ModelGraph> BuildLlamaDense(
             const HfModelConfig& config,
-            const ResolvedModelWeights& weights);
+            const ResolvedModelWeights& weights,
+            const std::optional<SampleParams>& sampling = std::nullopt);
 };
 
 }// namespace aethermind
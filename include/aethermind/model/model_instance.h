@@ -4,6 +4,10 @@
 #include "aethermind/model/backend_sidecar.h"
 #include "aethermind/model/formats/hf/hf_model_config.h"
 #include "aethermind/model/resolved_model_weights.h"
+#include "aethermind/model/weight_quantization_policy.h"
+
+#include <optional>
+#include <vector>
 
 namespace aethermind {
 
@@ -23,12 +27,28 @@ public:
             OpType op_type,
             const KernelSelector& selector) const noexcept;
 
+    /// Packed weight of `role` in `decoder_layer_index`; see BackendSidecar.
+    AM_NODISCARD const PackedWeights* FindPackedWeights(
+            std::optional<uint32_t> decoder_layer_index,
+            WeightRole role) const noexcept;
+
     Status StorePackedWeights(std::unique_ptr<PackedWeights> packed_weights) noexcept;
 
+    Status StorePackedWeights(std::optional<uint32_t> decoder_layer_index,
+                              WeightRole role,
+                              std::unique_ptr<PackedWeights> packed_weights) noexcept;
+
+    /// Error of every weight quantized while this instance was packed. Empty
+    /// when nothing was quantized or the packed weights came from a cache.
+    AM_NODISCARD const std::vector<WeightQuantizationReport>& GetWeightQuantizationReports() const noexcept;
+
+    void SetWeightQuantizationReports(std::vector<WeightQuantizationReport> reports) noexcept;
+
 private:
     BackendSidecar backend_sidecar_{};
     HfModelConfig config_{};
     ResolvedModelWeights resolved_weights_{};
+    std::vector<WeightQuantizationReport> quantization_reports_{};
 };
 
 }// namespace aethermind
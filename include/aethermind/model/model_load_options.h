@@ -1,12 +1,35 @@
 #ifndef AETHERMIND_MODEL_MODEL_LOAD_OPTIONS_H
 #define AETHERMIND_MODEL_MODEL_LOAD_OPTIONS_H
 
+#include "aethermind/model/weight_quantization_policy.h"
+
+#include <cstddef>
 #include <filesystem>
 
 namespace aethermind {
 
 struct ModelLoadOptions {
+    /// Hugging Face model directory, or a single checkpoint file ending in
+    /// `.gguf`.
     std::filesystem::path model_dir{};
+    /// Worker threads for prefaulting and prepacking weights; 0 uses the
+    /// hardware concurrency and 1 loads serially on the calling thread.
+    size_t num_threads = 0;
+    /// Faults the checkpoint mapping in before prepacking. Turn off when the
+    /// weights do not fit in memory and pages should be read on demand.
+    bool prefault_weights = true;
+    /// Directory of on-disk packed-weight caches keyed by checkpoint
+    /// fingerprint and packing format version; empty disables the cache. A
+    /// matching cache is mapped in place of packing, and a miss writes one.
+    std::filesystem::path packed_weight_cache_dir{};
+    /// Packs and quantizes weights directly into one huge-page-backed
+    /// PackedWeightArena laid out in execution order. Weights aliased to the
+    /// checkpoint mapping stay there either way. Turn off to give each packed
+    /// weight its own allocation; weights mapped from the cache never use it.
+    bool packed_weight_arena = true;
+    /// Quantization applied to linear weights while they are packed. The
+    /// per-weight error lands in ModelInstance::GetWeightQuantizationReports.
+    WeightQuantizationPolicy quantization{};
 };
 
 }// namespace aethermind
@@ -0,0 +1,89 @@
+#ifndef AETHERMIND_MODEL_PACKED_WEIGHT_ARENA_H
+#define AETHERMIND_MODEL_PACKED_WEIGHT_ARENA_H
+
+#include "aethermind/base/status.h"
+#include "aethermind/memory/buffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace aethermind {
+
+/// Pages behind a PackedWeightArena, best first.
+enum class PackedWeightArenaBacking : uint8_t {
+    /// Explicit 2 MB pages from the hugetlbfs pool (MAP_HUGETLB).
+    kHugeTlb = 0,
+    /// 2 MB-aligned anonymous memory advised MADV_HUGEPAGE, which the kernel
+    /// backs with transparent huge pages when it has them.
+    kTransparentHugePages,
+    /// Base pages only; the platform offers no huge-page hint.
+    kBasePages,
+};
+
+AM_NODISCARD const char* ToString(PackedWeightArenaBacking backing) noexcept;
+
+/// One contiguous, huge-page-backed block of slots for packed weights.
+///
+/// The loader sizes it from its prepack requests in request order, which is
+/// the order a forward pass reads them: layer 0 q/k/v/o/gate/up/down, then
+/// layer 1, ..., then lm_head. It then packs each weight straight into its
+/// slot, so no heap copy of the model ever exists next to the arena.
+/// Streaming weights front to back touches each page once, sequentially, so
+/// the hardware prefetcher runs ahead of the kernels and a 2 MB TLB entry
+/// covers what would take 512 base pages.
+class PackedWeightArena {
+public:
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+    /// Every slot starts on a cache line, which is all packed layouts
+    /// require of their base.
+    static constexpr size_t kSlotAlignment = 64;
+
+    /// Maps one arena holding a slot of `slot_sizes[i]` bytes per artifact,
+    /// back to back in the given order. The mapping is rounded up to whole
+    /// huge pages and prefers explicit huge pages over transparent ones.
+    /// Nothing is faulted in until the slots are written.
+    ///
+    /// @return The arena, or ResourceExhausted when the sizes overflow or
+    /// the mapping cannot be made.
+    AM_NODISCARD static StatusOr<PackedWeightArena> Create(std::span<const size_t> slot_sizes);
+
+    /// Start of the first slot; null for an empty arena.
+    AM_NODISCARD const std::byte* data() const noexcept;
+
+    /// Bytes from `data()` to the end of the last slot.
+    AM_NODISCARD size_t size() const noexcept {
+        return size_;
+    }
+
+    AM_NODISCARD size_t num_slots() const noexcept {
+        return offsets_.size();
+    }
+
+    AM_NODISCARD PackedWeightArenaBacking backing() const noexcept {
+        return backing_;
+    }
+
+    /// Writable storage of `slot_sizes[index]` bytes at the slot's offset.
+    /// It holds a reference to the mapping, so it may outlive the arena.
+    /// Uninitialized when `index` is out of range, the arena is empty, or
+    /// the mapping reference cannot be allocated.
+    AM_NODISCARD Buffer Slot(size_t index) const;
+
+private:
+    struct Mapping;
+
+    PackedWeightArena() = default;
+
+    std::shared_ptr<Mapping> mapping_{};
+    size_t size_ = 0;
+    PackedWeightArenaBacking backing_ = PackedWeightArenaBacking::kBasePages;
+    std::vector<size_t> offsets_{};
+    std::vector<size_t> slot_sizes_{};
+};
+
+}// namespace aethermind
+
+#endif
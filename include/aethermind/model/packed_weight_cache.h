@@ -0,0 +1,78 @@
+#ifndef AETHERMIND_MODEL_PACKED_WEIGHT_CACHE_H
+#define AETHERMIND_MODEL_PACKED_WEIGHT_CACHE_H
+
+#include "aethermind/backend/cpu/cpu_weight_prepacker.h"
+#include "aethermind/backend/packed_weights.h"
+#include "aethermind/base/status.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace aethermind {
+
+/// Identity of a packed-weight cache file. A file is reused only when both
+/// fields match the running loader; each entry also records the selector it
+/// was packed for.
+struct PackedWeightCacheKey {
+    uint64_t checkpoint_fingerprint = 0;
+    uint32_t pack_format_version = 0;
+};
+
+/// Header at the start of a cache file, followed by `num_entries`
+/// PackedWeightCacheEntry records. Both are encoded field by field in
+/// declaration order, without padding. Every payload starts on a
+/// kPackedWeightCacheAlignment boundary of the file, so the mapped payloads
+/// are page-aligned.
+struct PackedWeightCacheHeader {
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t checkpoint_fingerprint = 0;
+    uint32_t pack_format_version = 0;
+    uint32_t num_entries = 0;
+};
+
+/// One packed artifact: its sidecar key, the payload's byte range and, for a
+/// quantized artifact, its reconstruction error (zero otherwise).
+struct PackedWeightCacheEntry {
+    uint32_t op_type = 0;
+    uint8_t device_type = 0;
+    uint8_t weight_format = 0;
+    uint8_t isa = 0;
+    uint8_t phase = 0;
+    uint8_t kv_layout = 0;
+    DLDataType act_dtype{};
+    DLDataType weight_dtype{};
+    uint64_t offset = 0;
+    uint64_t nbytes = 0;
+    float max_abs_error = 0.0F;
+    float rms_error = 0.0F;
+};
+
+inline constexpr size_t kPackedWeightCacheAlignment = 4096;
+
+/// Writes `weights` to `path` under `key`. The file is staged next to `path`
+/// under a per-process name and renamed into place, so concurrent writers
+/// and crashes never expose a partial cache. `errors` is either empty or
+/// holds the quantization error of each artifact, zero for unquantized ones.
+Status SavePackedWeightCache(std::span<const PackedWeights* const> weights,
+                             const PackedWeightCacheKey& key,
+                             const std::filesystem::path& path,
+                             std::span<const WeightQuantizationError> errors = {});
+
+/// Maps the cache at `path` read-only and returns its artifacts in file
+/// order. Their storage aliases the mapping, which stays alive while any of
+/// them does, so every process loading the same file shares its page-cache
+/// pages and nothing is copied; the storage is read-only. Returns
+/// kFailedPrecondition when the file was written for a different key. When
+/// `errors` is non-null it receives the recorded error of each artifact.
+AM_NODISCARD StatusOr<std::vector<std::unique_ptr<PackedWeights>>> LoadPackedWeightCache(
+        const std::filesystem::path& path,
+        const PackedWeightCacheKey& key,
+        std::vector<WeightQuantizationError>* errors = nullptr);
+
+}// namespace aethermind
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef AETHERMIND_MODEL_PARALLEL_LOAD_H
+#define AETHERMIND_MODEL_PARALLEL_LOAD_H
+
+#include "aethermind/base/status.h"
+#include "aethermind/model/raw_weight.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace aethermind {
+
+/// Number of worker threads a load step uses when `requested` threads were
+/// asked for; 0 selects the hardware concurrency, and the result is never 0.
+AM_NODISCARD size_t ResolveLoadThreadCount(size_t requested) noexcept;
+
+/// Runs `task(0)` .. `task(num_tasks - 1)` on up to `num_threads` threads,
+/// the calling thread included.
+///
+/// Tasks are claimed in index order and report failures as Status; a task
+/// that throws std::bad_alloc fails with ResourceExhausted. After the first
+/// failure no new task is started, but every task with a lower index has
+/// already been claimed and runs to completion, so the returned error is
+/// always that of the lowest failing index regardless of scheduling.
+Status RunLoadTasks(size_t num_tasks,
+                    size_t num_threads,
+                    const std::function<Status(size_t)>& task);
+
+/// Faults every page behind `raw_weights` into memory on `num_threads`
+/// threads.
+///
+/// Work is partitioned per storage (one safetensors shard each) and per
+/// tensor, in file order, with large tensors split into fixed-size chunks so
+/// a single embedding or lm_head does not serialize the pass. Page faults
+/// on a cold mapping are the dominant load cost; taking them up front in
+/// parallel keeps prepacking and the first forward pass from paying them
+/// one page at a time.
+Status PrefaultRawWeights(const RawWeightTable& raw_weights, size_t num_threads);
+
+}// namespace aethermind
+
+#endif
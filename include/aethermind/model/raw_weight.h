@@ -1,6 +1,8 @@
 #ifndef AETHERMIND_MODEL_RAW_WEIGHT_H
 #define AETHERMIND_MODEL_RAW_WEIGHT_H
 
+#include "aethermind/base/mmap_file.h"
+#include "aethermind/base/status.h"
 #include "aethermind/dtypes/data_type.h"
 
 #include <cstddef>
@@ -14,8 +16,45 @@ namespace aethermind {
 
 struct RawStorage {
     virtual ~RawStorage() = default;
+
+    /// Applies an access-pattern hint to `bytes` bytes at `data`, which must
+    /// lie inside this storage. Storage without a file mapping behind it has
+    /// nothing to page and ignores the hint.
+    AM_NODISCARD virtual Status Advise(const std::byte* /*data*/,
+                                       size_t /*bytes*/,
+                                       MemoryMappedFile::Advice /*advice*/) const {
+        return Status::Ok();
+    }
 };
 
+/// How a RawWeightView's bytes encode its elements. Block-quantized
+/// encodings split every row of a [rows, cols] weight into blocks of
+/// kRawWeightBlockSize elements, each a little-endian float16 scale followed
+/// by its levels, as GGUF stores them; `dtype` is then the level type.
+enum class RawWeightEncoding : uint8_t {
+    kDense = 0,
+    /// 32 int8 levels per block; w = scale * q.
+    kGgmlQ8_0,
+    /// 16 bytes of unsigned nibbles per block, element j in the low nibble
+    /// of byte j and element j + 16 in its high nibble; w = scale * (q - 8).
+    kGgmlQ4_0,
+};
+
+inline constexpr size_t kRawWeightBlockSize = 32;
+
+/// Bytes of one block of `encoding`, or 0 for kDense.
+AM_NODISCARD constexpr size_t RawWeightBlockBytes(RawWeightEncoding encoding) noexcept {
+    switch (encoding) {
+        case RawWeightEncoding::kDense:
+            return 0;
+        case RawWeightEncoding::kGgmlQ8_0:
+            return sizeof(uint16_t) + kRawWeightBlockSize;
+        case RawWeightEncoding::kGgmlQ4_0:
+            return sizeof(uint16_t) + kRawWeightBlockSize / 2;
+    }
+    return 0;
+}
+
 struct RawWeightView {
     const std::byte* data = nullptr;
     size_t bytes = 0;
@@ -23,11 +62,21 @@ struct RawWeightView {
     std::vector<int64_t> shape{};
     std::shared_ptr<const RawStorage> storage{};
     bool is_contiguous = true;
+    RawWeightEncoding encoding = RawWeightEncoding::kDense;
+    /// Non-zero for llama.cpp attn_q/attn_k weights: the rows of each of
+    /// this many heads are interleaved so RoPE rotates adjacent pairs. Row
+    /// `2 * i + s` of a head holds Hugging Face row `s * head_dim / 2 + i`;
+    /// prepacking restores that order.
+    size_t interleaved_rope_heads = 0;
 
     AM_NODISCARD bool IsValid() const noexcept {
         return storage != nullptr && dtype.bits() > 0 && (data != nullptr || bytes == 0);
     }
 
+    AM_NODISCARD bool IsBlockQuantized() const noexcept {
+        return encoding != RawWeightEncoding::kDense;
+    }
+
     AM_NODISCARD bool IsAligned(size_t alignment) const noexcept {
         return alignment != 0 && data != nullptr &&
                reinterpret_cast<std::uintptr_t>(data) % alignment == 0;
@@ -2,11 +2,17 @@
 #define AETHERMIND_MODEL_WEIGHT_PREPACK_PLANNER_H
 
 #include "aethermind/backend/kernel_selector.h"
+#include "aethermind/backend/packed_weights.h"
 #include "aethermind/base/status.h"
 #include "aethermind/model/formats/hf/hf_model_config.h"
 #include "aethermind/model/resolved_model_weights.h"
+#include "aethermind/model/weight_quantization_policy.h"
 #include "aethermind/operators/op_type.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace aethermind {
@@ -21,22 +27,53 @@ public:
         OpType op_type{};
         RawWeightView raw_weight;
         KernelSelector selector;
+        WeightRole role = WeightRole::kQProj;
+        std::optional<uint32_t> decoder_layer_index{};
+        // Quantized requests carry an INT8/INT4 selector matching the scheme.
+        WeightQuantConfig quantization{};
     };
 
     // Generates a list of tensors that require weight prepacking.
     // Embeddings, RMSNorm, and final_norm are intentionally excluded;
     // only linear projection weights (q/k/v/o/gate/up/down/lm_head) are requested.
+    // With tie_word_embeddings and no lm_head tensor, lm_head is packed from
+    // the token embedding.
+    // Each request is quantized as `policy` resolves it for its layer and role,
+    // except block-quantized checkpoint weights, which are converted to the
+    // INT8/INT4 layout of their own format as they are.
     static StatusOr<std::vector<Request>> BuildRequests(
             const HfModelConfig& config,
             const ResolvedModelWeights& resolved_weights,
             const Backend& backend,
-            const KernelRegistry& registry);
+            const KernelRegistry& registry,
+            const WeightQuantizationPolicy& policy = {});
 
-    // Executes prepack for every request and stores the resulting
-    // PackedWeights artifacts into the ModelInstance backend sidecar.
+    // Packs every request, in request order, on up to `num_threads` threads
+    // and returns one artifact per request. Weights the prepacker can alias
+    // are wrapped in place and share the raw weight's storage, and quantized
+    // requests are quantized as they are packed. With `use_arena` every other
+    // weight is packed directly into its slot of one PackedWeightArena, laid
+    // out in request order, which is the order a forward pass reads them.
+    // When `reports` is non-null it receives the error of every quantized
+    // weight, in request order.
+    static StatusOr<std::vector<std::unique_ptr<PackedWeights>>> Prepack(
+            const std::vector<Request>& requests,
+            size_t num_threads = 1,
+            std::vector<WeightQuantizationReport>* reports = nullptr,
+            bool use_arena = false);
+
+    // Stores `packed[i]`, the artifact of `requests[i]`, in the sidecar under
+    // that request's decoder layer and role.
+    static Status Store(
+            ModelInstance& model_instance,
+            const std::vector<Request>& requests,
+            std::vector<std::unique_ptr<PackedWeights>> packed);
+
+    // Prepacks every request into an arena and stores the artifacts.
     static Status PrepackAndStore(
             ModelInstance& model_instance,
-            const std::vector<Request>& requests);
+            const std::vector<Request>& requests,
+            size_t num_threads = 1);
 };
 
 }// namespace aethermind
@@ -0,0 +1,93 @@
+#ifndef AETHERMIND_MODEL_WEIGHT_QUANTIZATION_POLICY_H
+#define AETHERMIND_MODEL_WEIGHT_QUANTIZATION_POLICY_H
+
+#include "aethermind/backend/cpu/cpu_weight_prepacker.h"
+#include "aethermind/base/status.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace aethermind {
+
+/// Linear weight a prepack request packs, within its decoder layer or
+/// model-level for kLmHead.
+enum class WeightRole : uint8_t {
+    kQProj = 0,
+    kKProj,
+    kVProj,
+    kOProj,
+    kGateProj,
+    kUpProj,
+    kDownProj,
+    kLmHead,
+};
+
+AM_NODISCARD const char* ToString(WeightRole role) noexcept;
+
+enum class WeightQuantScheme : uint8_t {
+    kNone = 0,
+    /// Symmetric INT8 with one scale per output channel.
+    kInt8PerChannel,
+    /// Symmetric INT4 with one scale per `group_size` input features.
+    kInt4Grouped,
+};
+
+AM_NODISCARD const char* ToString(WeightQuantScheme scheme) noexcept;
+
+struct WeightQuantConfig {
+    WeightQuantScheme scheme = WeightQuantScheme::kNone;
+    /// Input features sharing one scale; used by kInt4Grouped only.
+    uint32_t group_size = 128;
+
+    AM_NODISCARD friend bool operator==(const WeightQuantConfig& lhs,
+                                        const WeightQuantConfig& rhs) noexcept = default;
+};
+
+/// Replaces the config of the weights it matches. Empty fields match every
+/// layer or role; lm_head has no decoder layer, so overrides naming a layer
+/// never match it.
+struct WeightQuantOverride {
+    std::optional<uint32_t> decoder_layer_index{};
+    std::optional<WeightRole> role{};
+    WeightQuantConfig config{};
+};
+
+/// How the loader quantizes linear weights while packing them. The default
+/// policy packs every weight at its checkpoint precision. lm_head is
+/// resolved from `lm_head` rather than `default_config`, so it stays at
+/// high precision unless asked for; embeddings and norms are never packed
+/// and so never quantized.
+///
+/// Quantized artifacts are stored in the sidecar and reported, but are not
+/// executable yet: no kernel reads kQuantizedInt8/kQuantizedInt4 weights,
+/// and execution plans naming those formats fail with Unimplemented.
+struct WeightQuantizationPolicy {
+    WeightQuantConfig default_config{};
+    WeightQuantConfig lm_head{};
+    /// Applied in order; the last matching override wins.
+    std::vector<WeightQuantOverride> overrides{};
+
+    AM_NODISCARD WeightQuantConfig Resolve(std::optional<uint32_t> decoder_layer_index,
+                                           WeightRole role) const noexcept;
+
+    /// Rejects INT4 configs with a zero group size.
+    AM_NODISCARD Status Validate() const;
+
+    /// Folds every field into `seed`, so packed-weight caches written under
+    /// another policy are not reused.
+    AM_NODISCARD uint64_t Hash(uint64_t seed) const noexcept;
+};
+
+/// Error of one weight the loader quantized.
+struct WeightQuantizationReport {
+    std::optional<uint32_t> decoder_layer_index{};
+    WeightRole role = WeightRole::kQProj;
+    WeightQuantConfig config{};
+    WeightQuantizationError error{};
+};
+
+}// namespace aethermind
+
+#endif
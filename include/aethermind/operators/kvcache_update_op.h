@@ -12,17 +12,37 @@ namespace aethermind {
 
 /// @brief Supported dtype set for the KVCacheUpdate operator.
 ///
-/// All four tensor inputs (k, v, k_cache_in, v_cache_in) must share the same
-/// dtype from this set. Mixed dtypes between activations and cache are
-/// rejected: no implicit conversion policy is declared by the operator params.
-/// If mixed cache dtype becomes a real requirement, add an explicit conversion
-/// policy instead of silently accepting arbitrary combinations.
+/// k and v must share one dtype from this set. The caches either use the same
+/// dtype or one of kKVCacheUpdateQuantizedCacheDTypes; no other mixed
+/// combination is accepted.
 inline const std::array<DataType, 3> kKVCacheUpdateSupportedDTypes = {
         DataType::Float32(),
         DataType::Float(16),
         DataType::BFloat(16),
 };
 
+/// @brief Quantized cache storage dtypes KVCacheUpdate may write into.
+///
+/// This is the one explicit conversion policy of the operator: k/v rows are
+/// quantized on write (INT8 with one scale per token row, FP8 without
+/// scales). Both caches must use the same storage dtype.
+inline const std::array<DataType, 3> kKVCacheUpdateQuantizedCacheDTypes = {
+        DataType::Int(8),
+        DataType::Float8E4M3FN(),
+        DataType::Float8E5M2(),
+};
+
+/// @brief Checks whether a cache dtype is a quantized KV storage dtype.
+///
+/// @param dtype The data type to check.
+/// @return True if `dtype` is in kKVCacheUpdateQuantizedCacheDTypes.
+inline bool IsKVCacheUpdateQuantizedCacheDType(const DataType& dtype) noexcept {
+    return std::ranges::any_of(kKVCacheUpdateQuantizedCacheDTypes,
+                               [&](const DataType& supported) {
+                                   return dtype == supported;
+                               });
+}
+
 /// @brief Checks whether a dtype is supported by the KVCacheUpdate operator.
 ///
 /// @param dtype The data type to check.
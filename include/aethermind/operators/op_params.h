@@ -205,6 +205,24 @@ struct ReorderParams {
     friend bool operator==(const ReorderParams&, const ReorderParams&) = default;
 };
 
+/// @brief Semantic parameters for OpType::kSample.
+///
+/// Draws one token id per row of the last-axis logits: logits are divided by
+/// `temperature`, restricted to the `top_k` largest (0 keeps the whole
+/// vocabulary), then to the smallest prefix whose probability mass reaches
+/// `top_p`, and sampled from the renormalized remainder. `temperature == 0`
+/// is greedy decoding and matches Argmax.
+///
+/// The random stream is keyed by `seed` and the session's sampling seed and
+/// indexed by token position, so replaying a position replays its token.
+struct SampleParams {
+    float temperature = 1.0F;
+    int64_t top_k = 0;
+    float top_p = 1.0F;
+    uint64_t seed = 0;
+    friend bool operator==(const SampleParams&, const SampleParams&) = default;
+};
+
 /// @brief Typed variant over all per-operator parameter structs.
 using OpParams = std::variant<std::monostate,
                               EmbeddingParams,
@@ -222,7 +240,8 @@ using OpParams = std::variant<std::monostate,
                               ArgmaxParams,
                               ReshapeParams,
                               PermuteParams,
-                              ReorderParams>;
+                              ReorderParams,
+                              SampleParams>;
 
 }// namespace aethermind
 
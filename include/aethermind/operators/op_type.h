@@ -37,6 +37,7 @@ enum class OpType : uint16_t {
     kReshape,
     kPermute,
     kReorder,
+    kSample,
 };
 
 /// @brief Returns a human-readable name for an operator type.
@@ -75,6 +75,7 @@ StatusOr<InferenceResult> InferAttention(const OpParams& params, std::span<const
 StatusOr<InferenceResult> InferKVCacheUpdate(const OpParams& params, std::span<const TensorSpec> inputs);
 StatusOr<InferenceResult> InferSoftmax(const OpParams& params, std::span<const TensorSpec> inputs);
 StatusOr<InferenceResult> InferArgmax(const OpParams& params, std::span<const TensorSpec> inputs);
+StatusOr<InferenceResult> InferSample(const OpParams& params, std::span<const TensorSpec> inputs);
 StatusOr<InferenceResult> InferAdd(const OpParams& params, std::span<const TensorSpec> inputs);
 StatusOr<InferenceResult> InferSilu(const OpParams& params, std::span<const TensorSpec> inputs);
 StatusOr<InferenceResult> InferSiluMul(const OpParams& params, std::span<const TensorSpec> inputs);
@@ -71,6 +71,10 @@ struct OperatorTraits {
     /// @brief Whether graph lowering may evaluate the operator at compile time.
     /// Requires has_side_effects = false and deterministic = true.
     bool compile_time_evaluable = false;
+    /// @brief Whether each output element depends only on the input elements
+    /// at the same index. Such operators may write their output over a
+    /// same-shaped activation input that is dead afterwards.
+    bool elementwise = false;
 };
 
 /// @brief Associates an operator type with its port layout and semantic traits.
@@ -128,6 +132,12 @@ AM_NODISCARD bool IsPureOperator(const OperatorSchema& schema) noexcept;
 /// @param schema Schema to inspect.
 /// @return True when the operator is pure and marked compile-time evaluable.
 AM_NODISCARD bool IsCompileTimeEvaluable(const OperatorSchema& schema) noexcept;
+/// @brief Tests whether an operator output may alias one of its activation inputs.
+///
+/// @param schema Schema to inspect.
+/// @return True when the operator is pure, elementwise, and every input port
+/// contributes a tensor spec.
+AM_NODISCARD bool SupportsInPlaceActivation(const OperatorSchema& schema) noexcept;
 
 /// @brief Looks up an operator schema in the static registry.
 ///
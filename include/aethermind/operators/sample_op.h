@@ -0,0 +1,79 @@
+#ifndef AETHERMIND_OPERATORS_SAMPLE_OP_H
+#define AETHERMIND_OPERATORS_SAMPLE_OP_H
+
+/// @file sample_op.h
+/// @brief Token sampling semantics and executable operator declaration.
+
+#include "aethermind/operators/op_params.h"
+#include "aethermind/operators/operator.h"
+
+#include <cstdint>
+
+namespace aethermind {
+
+struct StepTensorBinding;
+
+/// @brief Layout of KernelContext::attrs for Sample kernels.
+///
+/// Row r of the bound logits draws from counter `counter + r` of the random
+/// stream keyed by (`seed`, `stream`). SampleOp fills `stream` and `counter`
+/// from the session's RuntimeSequenceState on every Run().
+struct SampleKernelAttrs {
+    float temperature = 1.0F;
+    float top_p = 1.0F;
+    int64_t top_k = 0;
+    uint64_t seed = 0;
+    uint64_t stream = 0;
+    uint64_t counter = 0;
+};
+
+/// @brief Checks the SampleParams ranges shared by inference and kernels.
+///
+/// @param params Parameters to validate.
+/// @return InvalidArgument for a negative or non-finite temperature, a
+///         positive temperature whose reciprocal overflows, a negative
+///         top_k, or top_p outside (0, 1].
+Status ValidateSampleParams(const SampleParams& params) noexcept;
+
+/// @brief Draws one token id per row of float32 logits.
+///
+/// Rows of a non-batched step occupy positions `current_pos + r`; rows of a
+/// DecodeBatchBinding step are sampled one session at a time with that
+/// session's seed and position.
+class SampleOp final : public Operator {
+public:
+    using Params = SampleParams;
+
+    explicit SampleOp(Params params) noexcept : params_(params) {}
+
+    AM_NODISCARD OpType Type() const noexcept override {
+        return OpType::kSample;
+    }
+
+    AM_NODISCARD const char* Name() const noexcept override {
+        return "Sample";
+    }
+
+    Status Prepare(OperatorContext& ctx) override;
+
+    AM_NODISCARD Status Run(KernelContext& ctx,
+                            const RuntimeBindingContext& bindings,
+                            size_t step_index) const noexcept override;
+
+    AM_NODISCARD const ResolvedKernel& GetResolvedKernel() const noexcept override {
+        return resolved_kernel_;
+    }
+
+private:
+    AM_NODISCARD Status RunDecodeBatch(KernelContext& ctx,
+                                       const RuntimeBindingContext& bindings,
+                                       const StepTensorBinding& binding,
+                                       SampleKernelAttrs attrs) const noexcept;
+
+    Params params_{};
+    ResolvedKernel resolved_kernel_{};
+};
+
+}// namespace aethermind
+
+#endif
@@ -1,9 +1,11 @@
 #ifndef AETHERMIND_RUNTIME_RUNTIME_OPTIONS_H
 #define AETHERMIND_RUNTIME_RUNTIME_OPTIONS_H
 
+#include "aethermind/backend/kernel_selector.h"
 #include "aethermind/dtypes/data_type.h"
 
 #include <cstddef>
+#include <filesystem>
 
 namespace aethermind {
 
@@ -42,6 +44,19 @@ struct KVCacheRuntimeOptions {
     size_t head_dim = 0;
     DataType kv_dtype{};
     size_t alignment = 64;
+    /// Concurrent sessions served from one set of KV planes.
+    size_t num_slots = 1;
+    /// Non-zero selects the paged layout: `num_blocks` blocks of
+    /// `block_tokens` tokens shared by every slot.
+    size_t block_tokens = 0;
+    size_t num_blocks = 0;
+    /// Dense slots become rings of `max_tokens` rows (ignored when paged).
+    bool sliding_window = false;
+    /// Plane order: head-major favours decode scans, token-major prefill appends.
+    KVLayoutOrder layout_order = KVLayoutOrder::kHeadMajor;
+    /// Paged mode: non-empty adds a disk tier for parked sessions, spilled to
+    /// a file created at this path.
+    std::filesystem::path offload_path{};
 };
 
 struct RuntimeOptions {
@@ -9,6 +9,8 @@
 /// Architecture:
 /// - `WorkspaceRequirement`: Describes what a step or operator needs
 /// - `PlanWorkspaceRequirements()`: Plans offsets for all requirements into a unified layout
+/// - `PlanWorkspaceRequirementsWithReuse()`: Lifetime-aware variant that lets
+///   requirements with disjoint live ranges share offsets
 /// - `WorkspaceBinding`: Actual slice handed to a kernel at execution time
 /// - `WorkspacePlanLayout`: Summary of the total workspace size and alignment needs
 ///
@@ -25,7 +27,10 @@
 #include "utils/overflow_check.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <span>
+#include <vector>
 
 namespace aethermind {
 
@@ -103,6 +108,17 @@ struct WorkspacePlanLayout {
     /// The WorkspaceArena base pointer should satisfy this alignment.
     /// Used when allocating the underlying scratch buffer.
     size_t required_alignment = 1;
+
+    /// Bytes the same requirements would need if every slice were stacked
+    /// sequentially. Equals `total_bytes` for PlanWorkspaceRequirements();
+    /// PlanWorkspaceRequirementsWithReuse() reports it to measure the saving.
+    size_t naive_total_bytes = 0;
+};
+
+/// Inclusive range of plan steps during which a workspace slice holds live data.
+struct WorkspaceLiveRange {
+    size_t first_step = 0;
+    size_t last_step = 0;
 };
 
 /// Checks if an alignment value is valid for workspace planning.
@@ -212,9 +228,56 @@ AM_NODISCARD inline StatusOr<WorkspacePlanLayout> PlanWorkspaceRequirements(
         layout.total_bytes = next_total;
     }
 
+    layout.naive_total_bytes = layout.total_bytes;
     return layout;
 }
 
+/// Derives the live range of each requirement from its step position and lifetime.
+///
+/// Requirement `i` belongs to plan step `i`. Live ranges are:
+/// - kPerOperator: only its own step.
+/// - kPerLayer: from its step to the last consecutive step of the same decoder
+///   layer, or to the end of the plan when `step_layers` has no annotation.
+/// - kPerToken, kPerSequence, kPersistent, kNone with non-zero bytes, and any
+///   requirement with `reusable == false`: the whole plan.
+///
+/// \param requirements Workspace needs in plan step order.
+/// \param step_layers Optional decoder layer index per step; empty means unknown.
+/// \return One live range per requirement, or InvalidArgument when
+///         `step_layers` is non-empty and does not match `requirements`.
+AM_NODISCARD StatusOr<std::vector<WorkspaceLiveRange>> ComputeWorkspaceLiveRanges(
+        std::span<const WorkspaceRequirement> requirements,
+        std::span<const std::optional<uint32_t>> step_layers = {});
+
+/// Plans offsets so requirements whose live ranges never overlap share bytes.
+///
+/// Requirements live across every step are stacked first in input order,
+/// exactly as PlanWorkspaceRequirements() would place them. The remaining
+/// requirements are placed largest first into the tightest gap between
+/// slices whose live ranges overlap theirs (best-fit interval coloring).
+/// `total_bytes` is the peak footprint; `naive_total_bytes` is the
+/// sequential footprint of the same requirements.
+///
+/// Zero-byte requirements receive offset 0. Offsets are left unchanged when
+/// an error is returned.
+///
+/// \param requirements Slices to place. `offset` is filled.
+/// \param ranges Inclusive live range of each requirement, same length.
+AM_NODISCARD StatusOr<WorkspacePlanLayout> PlanWorkspaceRequirementsForLiveRanges(
+        std::span<WorkspaceRequirement> requirements,
+        std::span<const WorkspaceLiveRange> ranges);
+
+/// Lifetime-aware workspace planning for one ExecutionPlan.
+///
+/// Derives live ranges with ComputeWorkspaceLiveRanges() and places them with
+/// PlanWorkspaceRequirementsForLiveRanges().
+///
+/// \param requirements List of workspace needs in plan step order. `offset` is filled.
+/// \param step_layers Optional decoder layer index per step, see ComputeWorkspaceLiveRanges().
+AM_NODISCARD StatusOr<WorkspacePlanLayout> PlanWorkspaceRequirementsWithReuse(
+        std::span<WorkspaceRequirement> requirements,
+        std::span<const std::optional<uint32_t>> step_layers = {});
+
 }// namespace aethermind
 
 #endif
@@ -5,6 +5,7 @@
 #include "aethermind/base/tensor_view.h"
 #include "aethermind/shape_inference/shape_constraint.h"
 #include "aethermind/shape_inference/shape_symbol.h"
+#include "aethermind/shape_inference/symbol_constraint_solver.h"
 
 #include <span>
 
@@ -23,6 +24,22 @@ AM_NODISCARD ShapeConstraintEvaluationResult EvaluateShapeConstraint(
         std::span<const SymbolicShape> inputs,
         std::span<const SymbolicShape> outputs);
 
+/// @brief Evaluates a shape constraint against symbolic shapes under solver facts.
+///
+/// Symbols bound to a static value by `solver` are substituted first, and
+/// dimension equality is decided by the solver's equality classes, so a
+/// constraint deferred by the plain symbolic overload can be discharged here.
+/// @param constraint The shape constraint to evaluate.
+/// @param inputs     Symbolic shapes of operator inputs.
+/// @param outputs    Symbolic shapes of operator outputs.
+/// @param solver     Equality and static-binding facts proven at plan time.
+/// @return kSatisfied, kViolated, or kDeferred.
+AM_NODISCARD ShapeConstraintEvaluationResult EvaluateShapeConstraint(
+        const ShapeConstraint& constraint,
+        std::span<const SymbolicShape> inputs,
+        std::span<const SymbolicShape> outputs,
+        const SymbolConstraintSolver& solver);
+
 /// @brief Evaluates a shape constraint against concrete runtime tensor views.
 /// @param constraint The shape constraint to evaluate.
 /// @param inputs     Concrete runtime input tensor views.
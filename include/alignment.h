@@ -18,6 +18,11 @@ constexpr size_t gAlignment = 64;
 constexpr size_t gPagesize = 4096;
 constexpr size_t gAlloc_threshold_thp = static_cast<size_t>(2) * 1024 * 1024;
 
+/// Rounds `value` up to a multiple of `alignment`, which must be non-zero.
+constexpr size_t AlignUp(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
 }// namespace aethermind
 
 #endif// AETHERMIND_ALIGNMENT_H
@@ -48,6 +48,15 @@ inline uint64_t twang_mix64(uint64_t key) noexcept {
     return key;
 }
 
+/// @brief Folds a byte range into a running 64-bit hash.
+/// @param hash Running hash, used as the XXH3 seed.
+/// @param data Bytes to hash; may be null when `size` is zero.
+/// @param size Number of bytes at `data`.
+/// @return The updated hash.
+inline uint64_t HashBytes(uint64_t hash, const void* data, size_t size) noexcept {
+    return xxh3::XXH3_64bits_withSeed(static_cast<const unsigned char*>(data), size, hash);
+}
+
 /// @brief Combines one hash value into an existing seed.
 /// @tparam T Type convertible to `size_t`.
 /// @param seed Existing combined hash seed.
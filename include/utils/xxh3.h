@@ -374,6 +374,29 @@ consteval uint64_t XXH3_64bits_withSeed_const(const T* input, size_t len,
             });
 }
 
+/// @brief Computes an XXH3 64-bit hash with a caller-provided seed at run time.
+/// @tparam T Byte-like input element type.
+/// @param input Pointer to the input bytes.
+/// @param len Number of input bytes.
+/// @param seed Seed mixed into the hash computation.
+/// @return The XXH3 64-bit hash; equal to XXH3_64bits_withSeed_const() for the same input.
+/// @pre `input` points to at least `len` readable bytes when `len` is non-zero.
+template<ByteType T>
+constexpr uint64_t XXH3_64bits_withSeed(const T* input, size_t len,
+                                        uint64_t seed) noexcept {
+    return XXH3_64bits_internal(
+            input, len, seed, kSecret, sizeof(kSecret),
+            [](const T* input, size_t len, uint64_t seed, const void*,
+               size_t) constexpr noexcept {
+                uint8_t secret[SECRET_DEFAULT_SIZE];
+                for (size_t i = 0; i < SECRET_DEFAULT_SIZE; i += 16) {
+                    writeLE64(secret + i, readLE64(kSecret + i) + seed);
+                    writeLE64(secret + i + 8, readLE64(kSecret + i + 8) - seed);
+                }
+                return hashLong_64b_internal(input, len, secret, sizeof(secret));
+            });
+}
+
 /// @}
 
 /// @name Contiguous-byte-container interfaces
@@ -1,9 +1,18 @@
 #include "aethermind/backend/cpu/cpu_weight_prepacker.h"
 #include "aethermind/base/tensor_view.h"
+#include "aethermind/dtypes/bfloat16.h"
+#include "aethermind/dtypes/half.h"
+#include "utils/overflow_check.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <new>
+#include <string>
+#include <vector>
 
 namespace aethermind {
 
@@ -15,7 +24,7 @@ void FreePackedCpuBuffer(void*, void* ptr) noexcept {
 
 Buffer AllocateCpuPackedBuffer(size_t nbytes, size_t alignment) {
     void* data = nullptr;
-    const size_t effective_alignment = alignment == 0 ? 64 : alignment;
+    const size_t effective_alignment = std::max(alignment, CpuWeightPrepacker::kStorageAlignment);
     const int rc = posix_memalign(&data, effective_alignment, nbytes == 0 ? 1 : nbytes);
     if (rc != 0 || data == nullptr) {
         return {};
@@ -29,35 +38,109 @@ Buffer AllocateCpuPackedBuffer(size_t nbytes, size_t alignment) {
                                effective_alignment)};
 }
 
-class CpuPackedWeights final : public PackedWeights {
-public:
-    CpuPackedWeights(OpType op_type,
-                     KernelSelector selector,
-                     Buffer storage) noexcept
-        : op_type_(op_type),
-          selector_(selector),
-          storage_(std::move(storage)) {}
-
-    AM_NODISCARD OpType op_type() const noexcept override {
-        return op_type_;
+// Hands back the caller's `storage` when it can hold `nbytes` packed at
+// `alignment`, and a fresh allocation when none was given.
+StatusOr<Buffer> PrepareCpuPackedBuffer(Buffer storage, size_t nbytes, size_t alignment) {
+    if (!storage.is_initialized()) {
+        storage = AllocateCpuPackedBuffer(nbytes, alignment);
+        if (!storage.is_initialized()) {
+            return Status::ResourceExhausted("Failed to allocate packed CPU weight storage");
+        }
+        return storage;
+    }
+    const size_t required = std::max(alignment, CpuWeightPrepacker::kStorageAlignment);
+    if (storage.nbytes() != nbytes || storage.mutable_data() == nullptr ||
+        reinterpret_cast<std::uintptr_t>(storage.data()) % required != 0) {
+        return Status::InvalidArgument("Packed CPU weight storage must be writable, hold " + std::to_string(nbytes) +
+                                       " bytes and start on a " + std::to_string(required) + "-byte boundary");
     }
+    return storage;
+}
 
-    AM_NODISCARD const KernelSelector& selector() const noexcept override {
-        return selector_;
+template<typename T>
+void LoadRowAsFloat(const void* data, int64_t row, const TensorView& view, float* dst) noexcept {
+    const T* base = static_cast<const T*>(data) + row * view.stride(0);
+    const int64_t col_stride = view.stride(1);
+    for (int64_t col = 0; col < view.dim(1); ++col) {
+        dst[col] = static_cast<float>(base[col * col_stride]);
     }
+}
+
+using LoadRowFn = void (*)(const void*, int64_t, const TensorView&, float*) noexcept;
 
-    AM_NODISCARD const Buffer& storage() const noexcept override {
-        return storage_;
+LoadRowFn SelectRowLoader(const DataType& dtype) noexcept {
+    if (dtype == DataType::Float32()) {
+        return &LoadRowAsFloat<float>;
     }
+    if (dtype == DataType::Float(16)) {
+        return &LoadRowAsFloat<Half>;
+    }
+    if (dtype == DataType::BFloat(16)) {
+        return &LoadRowAsFloat<BFloat16>;
+    }
+    return nullptr;
+}
 
-private:
-    OpType op_type_ = OpType::kUnknown;
-    KernelSelector selector_{};
-    Buffer storage_{};
-};
+// Quantizes one group symmetrically, storing signed values and returning
+// the scale. Accumulates the reconstruction error of every element.
+float QuantizeGroup(const float* values,
+                    size_t count,
+                    float max_level,
+                    int8_t* quantized,
+                    float& max_abs_error,
+                    double& sum_sq_error) noexcept {
+    float amax = 0.0F;
+    for (size_t i = 0; i < count; ++i) {
+        amax = std::max(amax, std::fabs(values[i]));
+    }
+    const float scale = amax / max_level;
+    const float inv_scale = scale > 0.0F ? 1.0F / scale : 0.0F;
+    for (size_t i = 0; i < count; ++i) {
+        const float level = std::clamp(std::nearbyint(values[i] * inv_scale), -max_level, max_level);
+        quantized[i] = static_cast<int8_t>(level);
+        const float error = std::fabs(values[i] - level * scale);
+        max_abs_error = std::max(max_abs_error, error);
+        sum_sq_error += static_cast<double>(error) * error;
+    }
+    return scale;
+}
 
 }// namespace
 
+StatusOr<CpuQuantizedWeightLayout> CpuQuantizedWeightLayout::Make(WeightFormat format,
+                                                                  int64_t rows,
+                                                                  int64_t cols,
+                                                                  size_t group_size) noexcept {
+    if (format != WeightFormat::kQuantizedInt8 && format != WeightFormat::kQuantizedInt4) {
+        return Status::InvalidArgument("Quantized weight layout requires an INT8 or INT4 weight format");
+    }
+    if (rows <= 0 || cols <= 0) {
+        return Status::InvalidArgument("Quantized weight layout requires a non-empty [rows, cols] weight");
+    }
+
+    CpuQuantizedWeightLayout layout;
+    layout.rows = static_cast<size_t>(rows);
+    layout.cols = static_cast<size_t>(cols);
+    layout.group_size = group_size == 0 ? layout.cols : std::min(group_size, layout.cols);
+    layout.groups_per_row = (layout.cols + layout.group_size - 1) / layout.group_size;
+    layout.row_bytes = format == WeightFormat::kQuantizedInt8 ? layout.cols : (layout.cols + 1) / 2;
+
+    size_t data_bytes = 0;
+    size_t num_scales = 0;
+    size_t scale_bytes = 0;
+    if (CheckOverflowMul(layout.rows, layout.row_bytes, &data_bytes) ||
+        CheckOverflowMul(layout.rows, layout.groups_per_row, &num_scales) ||
+        CheckOverflowMul(num_scales, sizeof(float), &scale_bytes) ||
+        CheckOverflowAdd(data_bytes, kScalesAlignment - 1, &layout.scales_offset)) {
+        return Status::Overflow("Quantized weight layout size overflowed size_t");
+    }
+    layout.scales_offset = layout.scales_offset / kScalesAlignment * kScalesAlignment;
+    if (CheckOverflowAdd(layout.scales_offset, scale_bytes, &layout.nbytes)) {
+        return Status::Overflow("Quantized weight layout size overflowed size_t");
+    }
+    return layout;
+}
+
 StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::Pack(
         OpType op_type,
         const Tensor& logical_weight,
@@ -88,7 +171,8 @@ StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::Pack(
 StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::Pack(
         OpType op_type,
         TensorView logical_weight,
-        const KernelSelector& selector) const noexcept {
+        const KernelSelector& selector,
+        Buffer storage) const noexcept {
     if (op_type == OpType::kUnknown) {
         return Status::InvalidArgument("CpuWeightPrepacker requires a concrete op type");
     }
@@ -106,16 +190,201 @@ StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::Pack(
     }
 
     const size_t packed_nbytes = logical_weight.logical_nbytes();
-    Buffer packed_storage = AllocateCpuPackedBuffer(packed_nbytes, logical_weight.alignment());
-    if (!packed_storage.is_initialized()) {
-        return Status::ResourceExhausted("Failed to allocate packed CPU weight storage");
-    }
+    AM_ASSIGN_OR_RETURN(Buffer packed_storage,
+                        PrepareCpuPackedBuffer(std::move(storage), packed_nbytes, logical_weight.alignment()));
 
     if (packed_nbytes > 0) {
         std::memcpy(packed_storage.mutable_data(), logical_weight.data(), packed_nbytes);
     }
 
-    return std::make_unique<CpuPackedWeights>(op_type, selector, std::move(packed_storage));
+    return std::make_unique<BufferPackedWeights>(op_type, selector, std::move(packed_storage));
+}
+
+StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::PackQuantized(
+        OpType op_type,
+        TensorView logical_weight,
+        const KernelSelector& selector,
+        size_t group_size,
+        WeightQuantizationError* error,
+        Buffer storage) const noexcept {
+    if (op_type == OpType::kUnknown) {
+        return Status::InvalidArgument("CpuWeightPrepacker requires a concrete op type");
+    }
+
+    if (selector.device_type != DeviceType::kCPU) {
+        return Status::InvalidArgument("CpuWeightPrepacker only supports CPU selectors");
+    }
+
+    if (!logical_weight.is_valid() || logical_weight.rank() != 2) {
+        return Status::InvalidArgument("CpuWeightPrepacker quantizes valid rank-2 weights only");
+    }
+
+    const LoadRowFn load_row = SelectRowLoader(logical_weight.dtype());
+    if (load_row == nullptr) {
+        return Status::InvalidArgument("CpuWeightPrepacker quantizes float32, float16 or bfloat16 weights only");
+    }
+
+    AM_ASSIGN_OR_RETURN(const CpuQuantizedWeightLayout layout,
+                        CpuQuantizedWeightLayout::Make(selector.weight_format,
+                                                       logical_weight.dim(0),
+                                                       logical_weight.dim(1),
+                                                       group_size));
+    AM_ASSIGN_OR_RETURN(Buffer packed_storage,
+                        PrepareCpuPackedBuffer(std::move(storage), layout.nbytes,
+                                               CpuQuantizedWeightLayout::kScalesAlignment));
+
+    const bool is_int4 = selector.weight_format == WeightFormat::kQuantizedInt4;
+    const float max_level = is_int4 ? 7.0F : 127.0F;
+    auto* bytes = static_cast<std::byte*>(packed_storage.mutable_data());
+    std::memset(bytes, 0, layout.nbytes);
+    auto* scales = reinterpret_cast<float*>(bytes + layout.scales_offset);
+
+    std::vector<float> row_values;
+    std::vector<int8_t> row_levels;
+    try {
+        row_values.resize(layout.cols);
+        row_levels.resize(layout.cols);
+    } catch (const std::bad_alloc&) {
+        return Status::ResourceExhausted("Failed to allocate weight quantization scratch");
+    }
+
+    float max_abs_error = 0.0F;
+    double sum_sq_error = 0.0;
+    for (size_t row = 0; row < layout.rows; ++row) {
+        load_row(logical_weight.data(), static_cast<int64_t>(row), logical_weight, row_values.data());
+        for (size_t group = 0; group < layout.groups_per_row; ++group) {
+            const size_t begin = group * layout.group_size;
+            const size_t count = std::min(layout.group_size, layout.cols - begin);
+            scales[row * layout.groups_per_row + group] =
+                    QuantizeGroup(row_values.data() + begin, count, max_level,
+                                  row_levels.data() + begin, max_abs_error, sum_sq_error);
+        }
+
+        std::byte* dst = bytes + row * layout.row_bytes;
+        if (!is_int4) {
+            std::memcpy(dst, row_levels.data(), layout.cols);
+            continue;
+        }
+        for (size_t col = 0; col < layout.cols; ++col) {
+            const auto nibble = static_cast<uint8_t>(row_levels[col]) & 0x0FU;
+            dst[col / 2] |= static_cast<std::byte>(col % 2 == 0 ? nibble : nibble << 4U);
+        }
+    }
+
+    if (error != nullptr) {
+        const double numel = static_cast<double>(layout.rows) * static_cast<double>(layout.cols);
+        *error = WeightQuantizationError{
+                .max_abs_error = max_abs_error,
+                .rms_error = static_cast<float>(std::sqrt(sum_sq_error / numel)),
+        };
+    }
+    return std::make_unique<BufferPackedWeights>(op_type, selector, std::move(packed_storage));
+}
+
+StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::PackQuantizedBlocks(
+        OpType op_type,
+        const std::byte* blocks,
+        size_t nbytes,
+        int64_t rows,
+        int64_t cols,
+        const KernelSelector& selector,
+        Buffer storage) const noexcept {
+    if (op_type == OpType::kUnknown) {
+        return Status::InvalidArgument("CpuWeightPrepacker requires a concrete op type");
+    }
+
+    if (selector.device_type != DeviceType::kCPU) {
+        return Status::InvalidArgument("CpuWeightPrepacker only supports CPU selectors");
+    }
+
+    if (blocks == nullptr || cols % static_cast<int64_t>(kGgmlBlockSize) != 0) {
+        return Status::InvalidArgument("CpuWeightPrepacker requires rows made of whole 32-element blocks");
+    }
+
+    AM_ASSIGN_OR_RETURN(const CpuQuantizedWeightLayout layout,
+                        CpuQuantizedWeightLayout::Make(selector.weight_format, rows, cols, kGgmlBlockSize));
+    const bool is_int4 = selector.weight_format == WeightFormat::kQuantizedInt4;
+    const size_t block_bytes = sizeof(uint16_t) + (is_int4 ? kGgmlBlockSize / 2 : kGgmlBlockSize);
+    size_t expected_bytes = 0;
+    if (CheckOverflowMul(layout.rows * layout.groups_per_row, block_bytes, &expected_bytes) ||
+        nbytes != expected_bytes) {
+        return Status::InvalidArgument("CpuWeightPrepacker block-quantized weight has " + std::to_string(nbytes) +
+                                       " bytes; expected " + std::to_string(expected_bytes));
+    }
+
+    AM_ASSIGN_OR_RETURN(Buffer packed_storage,
+                        PrepareCpuPackedBuffer(std::move(storage), layout.nbytes,
+                                               CpuQuantizedWeightLayout::kScalesAlignment));
+
+    auto* bytes = static_cast<std::byte*>(packed_storage.mutable_data());
+    std::memset(bytes, 0, layout.nbytes);
+    auto* scales = reinterpret_cast<float*>(bytes + layout.scales_offset);
+    const std::byte* block = blocks;
+    for (size_t row = 0; row < layout.rows; ++row) {
+        std::byte* dst = bytes + row * layout.row_bytes;
+        for (size_t group = 0; group < layout.groups_per_row; ++group, block += block_bytes) {
+            const auto scale_bits = static_cast<uint16_t>(std::to_integer<uint16_t>(block[0]) |
+                                                          std::to_integer<uint16_t>(block[1]) << 8U);
+            scales[row * layout.groups_per_row + group] = static_cast<float>(Half(scale_bits, Half::from_bits()));
+            const std::byte* levels = block + sizeof(uint16_t);
+            if (!is_int4) {
+                std::memcpy(dst + group * kGgmlBlockSize, levels, kGgmlBlockSize);
+                continue;
+            }
+            // Q4_0 stores element j and j + 16 in one byte as unsigned q + 8;
+            // the layout wants adjacent elements in one byte as signed nibbles.
+            std::byte* group_dst = dst + group * kGgmlBlockSize / 2;
+            for (size_t j = 0; j < kGgmlBlockSize; j += 2) {
+                const auto level = [&](size_t element) {
+                    const auto packed = std::to_integer<uint8_t>(levels[element % (kGgmlBlockSize / 2)]);
+                    const uint8_t q = element < kGgmlBlockSize / 2 ? packed & 0x0FU : packed >> 4U;
+                    return static_cast<uint8_t>(q - 8U) & 0x0FU;
+                };
+                group_dst[j / 2] = static_cast<std::byte>(level(j) | level(j + 1) << 4U);
+            }
+        }
+    }
+    return std::make_unique<BufferPackedWeights>(op_type, selector, std::move(packed_storage));
+}
+
+bool CpuWeightPrepacker::CanAlias(OpType op_type,
+                                  TensorView logical_weight,
+                                  const KernelSelector& selector) const noexcept {
+    if (op_type == OpType::kUnknown || selector.device_type != DeviceType::kCPU ||
+        selector.weight_format != WeightFormat::kPacked) {
+        return false;
+    }
+    if (!logical_weight.is_valid() || !logical_weight.is_contiguous() ||
+        logical_weight.data() == nullptr || logical_weight.dtype() != selector.weight_dtype) {
+        return false;
+    }
+    const size_t alignment = std::max(kStorageAlignment, logical_weight.alignment());
+    return reinterpret_cast<std::uintptr_t>(logical_weight.data()) % alignment == 0;
+}
+
+StatusOr<std::unique_ptr<PackedWeights>> CpuWeightPrepacker::Alias(
+        OpType op_type,
+        TensorView logical_weight,
+        const KernelSelector& selector,
+        std::shared_ptr<const void> owner) const noexcept {
+    if (!CanAlias(op_type, logical_weight, selector)) {
+        return Status::InvalidArgument("CpuWeightPrepacker cannot alias a weight whose packed layout differs");
+    }
+    if (owner == nullptr) {
+        return Status::InvalidArgument("CpuWeightPrepacker requires an owner for aliased weight bytes");
+    }
+
+    // The buffer holds one reference to the bytes' owner. Aliased bytes are
+    // usually a read-only mapping; kernels only read them.
+    MemoryHandle handle = MemoryHandle::SharedReadOnly(logical_weight.data(),
+                                                       std::move(owner),
+                                                       Device::CPU(),
+                                                       std::max(kStorageAlignment, logical_weight.alignment()));
+    if (!handle) {
+        return Status::ResourceExhausted("Failed to allocate aliased CPU weight storage");
+    }
+    Buffer aliased_storage(logical_weight.logical_nbytes(), std::move(handle));
+    return std::make_unique<BufferPackedWeights>(op_type, selector, std::move(aliased_storage));
 }
 
 }// namespace aethermind
@@ -0,0 +1,156 @@
+#include "aethermind/backend/kernel_context.h"
+#include "aethermind/backend/kernel_static_registration.h"
+#include "aethermind/operators/sample_op.h"
+#include "sample_internal.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+
+namespace aethermind::cpu::detail {
+
+namespace {
+
+const SampleParams* GetParams(const void* kernel_params) noexcept {
+    return static_cast<const SampleParams*>(kernel_params);
+}
+
+Status ValidateSampleEntry(const KernelContext& ctx, SampleFp32KernelArgs& args) noexcept {
+    if (ctx.attrs.size() != sizeof(SampleKernelAttrs)) {
+        return Status::InvalidArgument("SampleKernelEntry requires SampleKernelAttrs in KernelContext.attrs");
+    }
+    SampleKernelAttrs attrs;
+    std::memcpy(&attrs, ctx.attrs.data(), sizeof(attrs));
+    AM_RETURN_IF_ERROR(ValidateSampleParams(aethermind::SampleParams{
+            .temperature = attrs.temperature,
+            .top_k = attrs.top_k,
+            .top_p = attrs.top_p,
+    }));
+
+    const SampleParams* params = GetParams(ctx.kernel_params);
+    if (params == nullptr) {
+        return Status::InvalidArgument("SampleKernelEntry requires SampleParams in KernelContext.kernel_params");
+    }
+
+    const TensorView& logits = params->logits;
+    const MutableTensorView& output = params->output;
+    if (!logits.is_valid()) {
+        return Status::InvalidArgument("SampleKernelEntry requires a valid logits TensorView");
+    }
+    if (!output.is_valid()) {
+        return Status::InvalidArgument("SampleKernelEntry requires a valid output MutableTensorView");
+    }
+    if (logits.dtype() != DataType::Float32()) {
+        return Status::InvalidArgument("SampleKernelEntry requires float32 logits");
+    }
+    if (output.dtype() != DataType::Int(64)) {
+        return Status::InvalidArgument("SampleKernelEntry requires int64 output");
+    }
+    if (logits.rank() < 1 || !logits.is_contiguous() || !output.is_contiguous()) {
+        return Status::InvalidArgument("SampleKernelEntry requires contiguous logits and output");
+    }
+
+    const int64_t vocab_size = logits.dim(logits.rank() - 1);
+    if (vocab_size <= 0 || static_cast<uint64_t>(vocab_size) > std::numeric_limits<uint32_t>::max()) {
+        return Status::InvalidArgument("SampleKernelEntry requires a vocabulary of 1 to 2^32 - 1 entries");
+    }
+    const int64_t rows = logits.numel() / vocab_size;
+    if (output.numel() != rows) {
+        return Status::InvalidArgument("SampleKernelEntry output must hold one token per logits row");
+    }
+    if (rows > 0 && (logits.data() == nullptr || output.data() == nullptr)) {
+        return Status::InvalidArgument("SampleKernelEntry requires non-null logits and output data");
+    }
+
+    args = SampleFp32KernelArgs{
+            .logits = logits.data<float>(),
+            .output = output.data<int64_t>(),
+            .rows = rows,
+            .vocab_size = vocab_size,
+            .temperature = attrs.temperature,
+            .top_p = attrs.top_p,
+            .top_k = attrs.top_k,
+            .seed = attrs.seed,
+            .stream = attrs.stream,
+            .counter = attrs.counter,
+    };
+    return Status::Ok();
+}
+
+Status BuildSampleParams(std::span<const TensorView> inputs,
+                         std::span<const MutableTensorView> outputs,
+                         void* params_buffer) noexcept {
+    if (inputs.size() != 1 || outputs.size() != 1) {
+        return Status::InvalidArgument("Sample requires 1 input and 1 output");
+    }
+    ::new (params_buffer) SampleParams{
+            .logits = inputs[0],
+            .output = outputs[0],
+    };
+    return Status::Ok();
+}
+
+Status SampleKernelEntry_FP32_Scalar(const KernelContext& ctx) noexcept {
+    SampleFp32KernelArgs args;
+    AM_RETURN_IF_ERROR(ValidateSampleEntry(ctx, args));
+    if (args.rows == 0) {
+        return Status::Ok();
+    }
+    return SampleKernel_CPU_FP32(args, SampleFp32Ops{
+                                               .max = &MaxFp32_Scalar,
+                                               .collect_greater = &CollectGreaterFp32_Scalar,
+                                       });
+}
+
+Status SampleKernelEntry_FP32_AVX2(const KernelContext& ctx) noexcept {
+    SampleFp32KernelArgs args;
+    AM_RETURN_IF_ERROR(ValidateSampleEntry(ctx, args));
+    if (args.rows == 0) {
+        return Status::Ok();
+    }
+    return SampleKernel_CPU_FP32(args, SampleFp32Ops{
+                                               .max = &MaxFp32_AVX2,
+                                               .collect_greater = &CollectGreaterFp32_AVX2,
+                                       });
+}
+
+}// namespace
+
+AM_REGISTER_KERNEL(SampleFp32Scalar,
+                   KernelDescriptor{
+                           .op_type = OpType::kSample,
+                           .selector = KernelSelector{
+                                   .device_type = DeviceType::kCPU,
+                                   .act_dtype = DataType::Float32(),
+                                   .weight_dtype = DataType::Float32(),
+                                   .weight_format = WeightFormat::kPlain,
+                                   .isa = IsaLevel::kScalar,
+                                   .phase = ExecPhase::kBoth,
+                           },
+                           .kernel_func = &SampleKernelEntry_FP32_Scalar,
+                           .name = "cpu::sample_f32_scalar",
+                           .priority = 10,
+                           .params_builder = &BuildSampleParams,
+                           .params_size = sizeof(SampleParams),
+                   });
+
+AM_REGISTER_KERNEL(SampleFp32Avx2,
+                   KernelDescriptor{
+                           .op_type = OpType::kSample,
+                           .selector = KernelSelector{
+                                   .device_type = DeviceType::kCPU,
+                                   .act_dtype = DataType::Float32(),
+                                   .weight_dtype = DataType::Float32(),
+                                   .weight_format = WeightFormat::kPlain,
+                                   .isa = IsaLevel::kAVX2,
+                                   .phase = ExecPhase::kBoth,
+                           },
+                           .kernel_func = &SampleKernelEntry_FP32_AVX2,
+                           .name = "cpu::sample_f32_avx2",
+                           .priority = 20,
+                           .params_builder = &BuildSampleParams,
+                           .params_size = sizeof(SampleParams),
+                   });
+
+}// namespace aethermind::cpu::detail
@@ -0,0 +1,200 @@
+#include "sample_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <new>
+#include <vector>
+
+namespace aethermind::cpu::detail {
+namespace {
+
+// Nucleus sampling without top_k starts from this many candidates and
+// doubles them until their mass reaches top_p; real distributions rarely
+// need a second round, so the vocabulary is never fully sorted.
+constexpr size_t kInitialNucleusCandidates = 64;
+
+uint64_t Mix64(uint64_t z) noexcept {
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1) from the top 24 bits, exactly representable in float.
+float ToUniform(uint64_t bits) noexcept {
+    return static_cast<float>(bits >> 40) * 0x1.0p-24F;
+}
+
+// Selection copy of the row, reused as candidate weights once the threshold
+// is known, plus the candidate indices. Grown on demand and kept per thread.
+struct SampleScratch {
+    std::vector<float> values;
+    std::vector<uint32_t> indices;
+};
+
+SampleScratch& ThreadScratch() {
+    thread_local SampleScratch scratch;
+    return scratch;
+}
+
+int64_t ArgmaxRow(const float* logits, size_t n, const SampleFp32Ops& ops) noexcept {
+    const float max_logit = ops.max(logits, n);
+    const auto it = std::find(logits, logits + n, max_logit);
+    return it == logits + n ? 0 : static_cast<int64_t>(it - logits);
+}
+
+// Leaves the indices of the `count` largest logits in scratch.indices,
+// ordered by logit descending and index ascending on ties. nth_element finds
+// the count-th largest value in O(n); one compaction pass then gathers the
+// candidates, so only `count` entries are ever sorted.
+void SelectTopK(const float* logits, size_t n, size_t count,
+                const SampleFp32Ops& ops, SampleScratch& scratch) {
+    scratch.values.assign(logits, logits + n);
+    std::nth_element(scratch.values.begin(),
+                     scratch.values.begin() + static_cast<std::ptrdiff_t>(count - 1),
+                     scratch.values.end(),
+                     std::greater<>());
+    const float threshold = scratch.values[count - 1];
+
+    // At most count - 1 values exceed the count-th largest.
+    scratch.indices.resize(count);
+    size_t found = ops.collect_greater(logits, n, threshold, scratch.indices.data());
+    for (size_t i = 0; found < count && i < n; ++i) {
+        if (logits[i] == threshold) {
+            scratch.indices[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    std::sort(scratch.indices.begin(), scratch.indices.begin() + static_cast<std::ptrdiff_t>(count),
+              [logits](uint32_t lhs, uint32_t rhs) {
+                  return logits[lhs] > logits[rhs] || (logits[lhs] == logits[rhs] && lhs < rhs);
+              });
+}
+
+// Inverse CDF over `weights[0, n)` whose sum is `total`.
+size_t PickWeighted(const float* weights, size_t n, double total, float uniform) noexcept {
+    const double target = static_cast<double>(uniform) * total;
+    double cumulative = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        cumulative += static_cast<double>(weights[i]);
+        if (cumulative > target) {
+            return i;
+        }
+    }
+    return n - 1;
+}
+
+int64_t SampleRow(const float* logits, size_t n, const SampleFp32KernelArgs& args,
+                  uint64_t counter, const SampleFp32Ops& ops, SampleScratch& scratch) {
+    if (args.temperature == 0.0F || args.top_k == 1) {
+        return ArgmaxRow(logits, n, ops);
+    }
+
+    const float inv_temperature = 1.0F / args.temperature;
+    const float max_logit = ops.max(logits, n);
+    const float uniform = ToUniform(SampleRandomBits(args.seed, args.stream, counter));
+    const size_t top_k = args.top_k == 0 ? n : std::min(static_cast<size_t>(args.top_k), n);
+    const bool nucleus = args.top_p < 1.0F;
+
+    // Whole vocabulary: one exp pass and an inverse-CDF scan, no selection.
+    if (top_k == n && !nucleus) {
+        scratch.values.resize(n);
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            scratch.values[i] = std::exp((logits[i] - max_logit) * inv_temperature);
+            total += static_cast<double>(scratch.values[i]);
+        }
+        return static_cast<int64_t>(PickWeighted(scratch.values.data(), n, total, uniform));
+    }
+
+    // Without top_k the nucleus is cut from the mass of the whole vocabulary.
+    double vocab_mass = 0.0;
+    if (top_k == n) {
+        for (size_t i = 0; i < n; ++i) {
+            vocab_mass += static_cast<double>(std::exp((logits[i] - max_logit) * inv_temperature));
+        }
+    }
+
+    size_t count = top_k < n ? top_k : std::min(n, kInitialNucleusCandidates);
+    size_t kept = 0;
+    double kept_mass = 0.0;
+    while (kept == 0) {
+        SelectTopK(logits, n, count, ops, scratch);
+        float* weights = scratch.values.data();
+        double candidate_mass = 0.0;
+        for (size_t j = 0; j < count; ++j) {
+            weights[j] = std::exp((logits[scratch.indices[j]] - max_logit) * inv_temperature);
+            candidate_mass += static_cast<double>(weights[j]);
+        }
+        if (!nucleus) {
+            kept = count;
+            kept_mass = candidate_mass;
+            break;
+        }
+
+        const double limit = static_cast<double>(args.top_p) *
+                             (top_k == n ? vocab_mass : candidate_mass);
+        double cumulative = 0.0;
+        for (size_t j = 0; j < count; ++j) {
+            cumulative += static_cast<double>(weights[j]);
+            if (cumulative >= limit) {
+                kept = j + 1;
+                kept_mass = cumulative;
+                break;
+            }
+        }
+        if (kept == 0) {
+            if (count == top_k) {
+                kept = count;
+                kept_mass = candidate_mass;
+            } else {
+                count = std::min(top_k, count * 2);
+            }
+        }
+    }
+
+    const size_t pick = PickWeighted(scratch.values.data(), kept, kept_mass, uniform);
+    return static_cast<int64_t>(scratch.indices[pick]);
+}
+
+}// namespace
+
+uint64_t SampleRandomBits(uint64_t seed, uint64_t stream, uint64_t counter) noexcept {
+    return Mix64(Mix64(Mix64(seed) ^ stream) ^ counter);
+}
+
+float MaxFp32_Scalar(const float* values, size_t n) noexcept {
+    float result = values[0];
+    for (size_t i = 1; i < n; ++i) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+size_t CollectGreaterFp32_Scalar(const float* values, size_t n, float threshold,
+                                 uint32_t* indices) noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (values[i] > threshold) {
+            indices[count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return count;
+}
+
+Status SampleKernel_CPU_FP32(const SampleFp32KernelArgs& args, const SampleFp32Ops& ops) noexcept {
+    const auto vocab = static_cast<size_t>(args.vocab_size);
+    try {
+        SampleScratch& scratch = ThreadScratch();
+        for (int64_t row = 0; row < args.rows; ++row) {
+            const float* logits = args.logits + static_cast<size_t>(row) * vocab;
+            args.output[row] = SampleRow(logits, vocab, args,
+                                         args.counter + static_cast<uint64_t>(row), ops, scratch);
+        }
+    } catch (const std::bad_alloc&) {
+        return Status::ResourceExhausted("Sample kernel could not allocate its selection scratch");
+    }
+    return Status::Ok();
+}
+
+}// namespace aethermind::cpu::detail
@@ -0,0 +1,73 @@
+#include "sample_internal.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace aethermind::cpu::detail {
+
+#if defined(__AVX2__)
+float MaxFp32_AVX2(const float* values, size_t n) noexcept {
+    if (n < 32) {
+        return MaxFp32_Scalar(values, n);
+    }
+    __m256 vmax0 = _mm256_loadu_ps(values);
+    __m256 vmax1 = _mm256_loadu_ps(values + 8);
+    __m256 vmax2 = _mm256_loadu_ps(values + 16);
+    __m256 vmax3 = _mm256_loadu_ps(values + 24);
+    size_t i = 32;
+    for (; i + 32 <= n; i += 32) {
+        vmax0 = _mm256_max_ps(vmax0, _mm256_loadu_ps(values + i));
+        vmax1 = _mm256_max_ps(vmax1, _mm256_loadu_ps(values + i + 8));
+        vmax2 = _mm256_max_ps(vmax2, _mm256_loadu_ps(values + i + 16));
+        vmax3 = _mm256_max_ps(vmax3, _mm256_loadu_ps(values + i + 24));
+    }
+    __m256 vmax = _mm256_max_ps(_mm256_max_ps(vmax0, vmax1), _mm256_max_ps(vmax2, vmax3));
+    __m128 vhalf = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+    vhalf = _mm_max_ps(vhalf, _mm_movehl_ps(vhalf, vhalf));
+    vhalf = _mm_max_ss(vhalf, _mm_shuffle_ps(vhalf, vhalf, 1));
+    float result = _mm_cvtss_f32(vhalf);
+    for (; i < n; ++i) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+// Compares eight logits per instruction and walks the set bits of the mask;
+// below-threshold blocks, almost all of a large vocabulary, cost one compare
+// and one branch.
+size_t CollectGreaterFp32_AVX2(const float* values, size_t n, float threshold,
+                               uint32_t* indices) noexcept {
+    const __m256 vthreshold = _mm256_set1_ps(threshold);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 greater = _mm256_cmp_ps(_mm256_loadu_ps(values + i), vthreshold, _CMP_GT_OQ);
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(greater));
+        while (mask != 0) {
+            indices[count++] = static_cast<uint32_t>(i) + static_cast<uint32_t>(std::countr_zero(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; i < n; ++i) {
+        if (values[i] > threshold) {
+            indices[count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return count;
+}
+#else
+float MaxFp32_AVX2(const float* values, size_t n) noexcept {
+    return MaxFp32_Scalar(values, n);
+}
+
+size_t CollectGreaterFp32_AVX2(const float* values, size_t n, float threshold,
+                               uint32_t* indices) noexcept {
+    return CollectGreaterFp32_Scalar(values, n, threshold, indices);
+}
+#endif
+
+}// namespace aethermind::cpu::detail
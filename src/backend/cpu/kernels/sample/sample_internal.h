@@ -0,0 +1,66 @@
+/// Internal declarations for the CPU Sample kernel.
+///
+/// The row driver (SampleKernel_CPU_FP32) is shared by every ISA; only the
+/// two vocabulary-wide passes it spends its time in, the running maximum and
+/// the above-threshold index compaction, are specialized per ISA and handed
+/// in through SampleFp32Ops.
+
+#ifndef AETHERMIND_BACKEND_CPU_KERNELS_SAMPLE_INTERNAL_H
+#define AETHERMIND_BACKEND_CPU_KERNELS_SAMPLE_INTERNAL_H
+
+#include "aethermind/base/status.h"
+#include "aethermind/base/tensor_view.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aethermind::cpu::detail {
+
+/// Backend-internal params struct built by BuildSampleParams.
+struct SampleParams {
+    TensorView logits{};
+    MutableTensorView output{};
+};
+
+struct SampleFp32KernelArgs {
+    const float* logits{};
+    int64_t* output{};
+    int64_t rows{};
+    int64_t vocab_size{};
+    float temperature{1.0F};
+    float top_p{1.0F};
+    int64_t top_k{};
+    uint64_t seed{};
+    uint64_t stream{};
+    uint64_t counter{};
+};
+
+struct SampleFp32Ops {
+    /// Largest of `n > 0` values.
+    float (*max)(const float* values, size_t n) noexcept = nullptr;
+    /// Writes, in ascending order, the indices of values strictly greater
+    /// than `threshold` and returns their count.
+    size_t (*collect_greater)(const float* values, size_t n, float threshold,
+                              uint32_t* indices) noexcept = nullptr;
+};
+
+float MaxFp32_Scalar(const float* values, size_t n) noexcept;
+size_t CollectGreaterFp32_Scalar(const float* values, size_t n, float threshold,
+                                 uint32_t* indices) noexcept;
+float MaxFp32_AVX2(const float* values, size_t n) noexcept;
+size_t CollectGreaterFp32_AVX2(const float* values, size_t n, float threshold,
+                               uint32_t* indices) noexcept;
+
+/// Uniform bits for counter `counter` of the stream keyed by (`seed`,
+/// `stream`); a stateless SplitMix64 finalizer chain, so any position can be
+/// replayed without generating the ones before it.
+uint64_t SampleRandomBits(uint64_t seed, uint64_t stream, uint64_t counter) noexcept;
+
+/// Samples every row of already-validated arguments: contiguous
+/// `[rows, vocab_size]` logits with `0 < vocab_size <= UINT32_MAX` and
+/// parameters accepted by ValidateSampleParams.
+Status SampleKernel_CPU_FP32(const SampleFp32KernelArgs& args, const SampleFp32Ops& ops) noexcept;
+
+}// namespace aethermind::cpu::detail
+
+#endif// AETHERMIND_BACKEND_CPU_KERNELS_SAMPLE_INTERNAL_H
@@ -47,6 +47,19 @@ const char* ToString(WeightFormat format) noexcept {
     }
 }
 
+const char* ToString(KVLayoutOrder order) noexcept {
+    switch (order) {
+        case KVLayoutOrder::kAny:
+            return "Any";
+        case KVLayoutOrder::kHeadMajor:
+            return "HeadMajor";
+        case KVLayoutOrder::kTokenMajor:
+            return "TokenMajor";
+        default:
+            return "Unknown";
+    }
+}
+
 std::string ToString(const KernelSelector& selector) {
     return std::string("KernelSelector{device=") +
            DeviceType2Str(selector.device_type) +
@@ -62,6 +75,8 @@ std::string ToString(const KernelSelector& selector) {
            ToString(selector.isa) +
            ", phase=" +
            ToString(selector.phase) +
+           ", kv_layout=" +
+           ToString(selector.kv_layout) +
            "}";
 }
 
@@ -0,0 +1,38 @@
+#include "aethermind/base/binary_file.h"
+
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+namespace aethermind {
+
+Status WriteFileAtomically(const std::filesystem::path& path,
+                           std::string_view description,
+                           const std::function<Status(std::ofstream&)>& write) {
+    std::filesystem::path staging = path;
+    staging += ".tmp." + std::to_string(getpid());
+    std::ofstream out(staging, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return Status::Internal("Failed to open " + std::string(description) + " file: " + staging.string());
+    }
+    Status status = write(out);
+    out.close();
+    if (status.ok() && !out) {
+        status = Status::Internal("Failed to write " + std::string(description) + " file: " + staging.string());
+    }
+    if (status.ok()) {
+        std::error_code error;
+        std::filesystem::rename(staging, path, error);
+        if (error) {
+            status = Status::Internal("Failed to publish " + std::string(description) + " file '" +
+                                      path.string() + "': " + error.message());
+        }
+    }
+    if (!status.ok()) {
+        std::error_code ignored;
+        std::filesystem::remove(staging, ignored);
+    }
+    return status;
+}
+
+}// namespace aethermind
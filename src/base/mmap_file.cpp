@@ -1,6 +1,7 @@
 #include "aethermind/base/mmap_file.h"
 #include "utils/logging.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdint>
 #include <fcntl.h>
@@ -56,24 +57,57 @@ Status CloseBeforeReturn(ScopedFd& fd, const std::filesystem::path& path, const
                             "; original status: " + status.ToString());
 }
 
-int ToPosixAdvice(MemoryMappedFile::Advice advice) noexcept {
+// madvise rather than posix_madvise: glibc ignores POSIX_MADV_DONTNEED on
+// Linux, because MADV_DONTNEED discards anonymous memory.
+int ToMadvise(MemoryMappedFile::Advice advice) noexcept {
     switch (advice) {
         case MemoryMappedFile::Advice::kNormal:
-            return POSIX_MADV_NORMAL;
+            return MADV_NORMAL;
         case MemoryMappedFile::Advice::kRandom:
-            return POSIX_MADV_RANDOM;
+            return MADV_RANDOM;
         case MemoryMappedFile::Advice::kSequential:
-            return POSIX_MADV_SEQUENTIAL;
+            return MADV_SEQUENTIAL;
         case MemoryMappedFile::Advice::kWillNeed:
-            return POSIX_MADV_WILLNEED;
+            return MADV_WILLNEED;
         case MemoryMappedFile::Advice::kDontNeed:
-            return POSIX_MADV_DONTNEED;
+            return MADV_DONTNEED;
+        case MemoryMappedFile::Advice::kPageOut:
+#ifdef MADV_PAGEOUT
+            return MADV_PAGEOUT;
+#else
+            return MADV_DONTNEED;
+#endif
     }
-    return POSIX_MADV_NORMAL;
+    return MADV_NORMAL;
+}
+
+Status Madvise(void* addr, size_t length, MemoryMappedFile::Advice advice) {
+    if (madvise(addr, length, ToMadvise(advice)) == 0) {
+        return Status::Ok();
+    }
+    int error_number = errno;
+    // Kernels before 5.4 lack MADV_PAGEOUT; dropping the mapping still
+    // releases the process's share of the pages.
+    if (error_number == EINVAL && advice == MemoryMappedFile::Advice::kPageOut) {
+        if (madvise(addr, length, MADV_DONTNEED) == 0) {
+            return Status::Ok();
+        }
+        error_number = errno;
+    }
+    return Status::Internal(std::string("madvise failed: ") +
+                            std::error_code(error_number, std::generic_category()).message());
 }
 
 }// namespace
 
+size_t PageSize() noexcept {
+    static const size_t page_size = [] {
+        const long value = sysconf(_SC_PAGESIZE);
+        return value > 0 ? static_cast<size_t>(value) : size_t{4096};
+    }();
+    return page_size;
+}
+
 MemoryMappedFile::~MemoryMappedFile() {
     if (data_ != nullptr) {
         const int ret = munmap(data_, size_);
@@ -106,11 +140,26 @@ Status MemoryMappedFile::Advise(Advice advice) const {
         return Status::InvalidArgument("Cannot advise an invalid memory mapping");
     }
 
-    if (const int error_number = posix_madvise(data_, size_, ToPosixAdvice(advice)); error_number != 0) {
-        return Status::Internal(std::string("posix_madvise failed: ") +
-                                std::error_code(error_number, std::generic_category()).message());
+    return Madvise(data_, size_, advice);
+}
+
+Status MemoryMappedFile::AdviseRange(size_t offset, size_t length, Advice advice) const {
+    if (data_ == nullptr || size_ == 0) {
+        return Status::InvalidArgument("Cannot advise an invalid memory mapping");
     }
-    return Status::Ok();
+    if (offset > size_ || length > size_ - offset) {
+        return Status::InvalidArgument("Advised range exceeds the memory mapping");
+    }
+    if (length == 0) {
+        return Status::Ok();
+    }
+
+    // mmap returns a page-aligned base, so page-aligning the offsets aligns
+    // the addresses madvise requires.
+    const size_t page_size = PageSize();
+    const size_t begin = offset / page_size * page_size;
+    const size_t end = std::min(size_, (offset + length + page_size - 1) / page_size * page_size);
+    return Madvise(static_cast<std::byte*>(data_) + begin, end - begin, advice);
 }
 
 StatusOr<MemoryMappedFile> MemoryMappedFile::Map(const std::filesystem::path& path) {
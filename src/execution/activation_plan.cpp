@@ -0,0 +1,30 @@
+#include "aethermind/execution/activation_plan.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace aethermind {
+
+bool ActivationPlan::empty() const noexcept {
+    return activations.empty();
+}
+
+size_t ActivationPlan::size() const noexcept {
+    return activations.size();
+}
+
+const PlannedActivation* ActivationPlan::Find(size_t step_index,
+                                              uint32_t output_port) const noexcept {
+    const auto it = std::lower_bound(
+            activations.begin(), activations.end(), std::pair{step_index, output_port},
+            [](const PlannedActivation& a, const std::pair<size_t, uint32_t>& key) noexcept {
+                return std::pair{a.producer_step, a.output_port} < key;
+            });
+    if (it == activations.end() || it->producer_step != step_index ||
+        it->output_port != output_port) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+}// namespace aethermind
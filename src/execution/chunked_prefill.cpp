@@ -0,0 +1,86 @@
+#include "aethermind/execution/chunked_prefill.h"
+#include "aethermind/execution/executor.h"
+
+#include <algorithm>
+#include <string>
+
+namespace aethermind {
+
+StatusOr<ChunkedPrefill> ChunkedPrefill::Create(size_t prompt_len,
+                                                size_t chunk_tokens,
+                                                size_t start_pos) {
+    if (prompt_len == 0) {
+        return Status::InvalidArgument("Chunked prefill requires a non-empty prompt");
+    }
+    if (chunk_tokens == 0) {
+        return Status::InvalidArgument("Chunked prefill chunk size must be non-zero");
+    }
+    if (start_pos > prompt_len) {
+        return Status::OutOfRange("Chunked prefill start position exceeds the prompt length");
+    }
+    return ChunkedPrefill(prompt_len, chunk_tokens, start_pos);
+}
+
+bool ChunkedPrefill::done() const noexcept {
+    return committed_ == prompt_len_;
+}
+
+PrefillChunk ChunkedPrefill::next_chunk() const noexcept {
+    return PrefillChunk{
+            .begin = committed_,
+            .num_tokens = std::min(chunk_tokens_, prompt_len_ - committed_),
+    };
+}
+
+size_t ChunkedPrefill::prompt_len() const noexcept {
+    return prompt_len_;
+}
+
+size_t ChunkedPrefill::chunk_tokens() const noexcept {
+    return chunk_tokens_;
+}
+
+size_t ChunkedPrefill::committed_tokens() const noexcept {
+    return committed_;
+}
+
+size_t ChunkedPrefill::remaining_chunks() const noexcept {
+    const size_t remaining = prompt_len_ - committed_;
+    return (remaining + chunk_tokens_ - 1) / chunk_tokens_;
+}
+
+Status ChunkedPrefill::RunNextChunk(const ExecutionPlanFamily& family,
+                                    RuntimeBindingContext& bindings) noexcept {
+    if (done()) {
+        return Status::FailedPrecondition("Chunked prefill has already committed the whole prompt");
+    }
+    if (!bindings.HasKVCacheView()) {
+        return Status::FailedPrecondition("Chunked prefill requires a valid KVCacheView");
+    }
+    if (bindings.kv_cache_view().committed_tokens() != committed_) {
+        return Status::FailedPrecondition(
+                "KVCacheView committed position " +
+                std::to_string(bindings.kv_cache_view().committed_tokens()) +
+                " does not match chunked prefill progress " + std::to_string(committed_));
+    }
+
+    const PrefillChunk chunk = next_chunk();
+    RuntimeSequenceState& sequence = bindings.mutable_sequence_state();
+    sequence.prepared = true;
+    sequence.prefill_done = false;
+    sequence.prompt_len = prompt_len_;
+    sequence.current_pos = chunk.begin;
+    sequence.step_tokens = chunk.num_tokens;
+
+    const Status status = Executor::Execute(family, chunk.num_tokens, bindings);
+    sequence.step_tokens = 0;
+    AM_RETURN_IF_ERROR(status);
+
+    AM_RETURN_IF_ERROR(bindings.mutable_kv_cache_view().CommitUntil(chunk.end()));
+    committed_ = chunk.end();
+    sequence.current_pos = committed_;
+    sequence.prefill_done = done();
+    return Status::Ok();
+}
+
+}// namespace aethermind
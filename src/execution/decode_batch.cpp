@@ -0,0 +1,153 @@
+#include "aethermind/execution/decode_batch.h"
+#include "aethermind/execution/executor.h"
+
+#include <algorithm>
+#include <span>
+#include <string>
+
+namespace aethermind {
+
+StatusOr<DecodeBatch> DecodeBatch::Create(size_t max_batch) {
+    if (max_batch == 0) {
+        return Status::InvalidArgument("Decode batch size limit must be non-zero");
+    }
+    return DecodeBatch(max_batch);
+}
+
+Status DecodeBatch::Join(uint64_t session_id,
+                         const KVCacheView& view,
+                         const RuntimeSequenceState& state) {
+    if (!view.valid()) {
+        return Status::FailedPrecondition("Cannot add a session without a valid KVCacheView to a decode batch");
+    }
+    if (!state.prefill_done || state.step_tokens != 0) {
+        return Status::FailedPrecondition("Only sessions with a committed prompt can join a decode batch");
+    }
+    if (view.committed_tokens() != state.current_pos) {
+        return Status::FailedPrecondition(
+                "KVCacheView committed position " + std::to_string(view.committed_tokens()) +
+                " does not match session position " + std::to_string(state.current_pos));
+    }
+    if (Contains(session_id)) {
+        return Status::AlreadyExists("Session " + std::to_string(session_id) +
+                                     " is already in the decode batch");
+    }
+    if (size() == max_batch_) {
+        return Status::ResourceExhausted("Decode batch is full");
+    }
+
+    // Row storage for RunStep() grows first; a throw below leaves it merely
+    // oversized.
+    positions_.resize(size() + 1);
+    sampling_seeds_.resize(size() + 1);
+    session_ids_.push_back(session_id);
+    views_.push_back(view);
+    states_.push_back(state);
+    states_.back().prepared = true;
+    return Status::Ok();
+}
+
+Status DecodeBatch::Leave(uint64_t session_id) {
+    AM_ASSIGN_OR_RETURN(const size_t row, Row(session_id));
+    const auto offset = static_cast<std::ptrdiff_t>(row);
+    session_ids_.erase(session_ids_.begin() + offset);
+    views_.erase(views_.begin() + offset);
+    states_.erase(states_.begin() + offset);
+    positions_.resize(size());
+    sampling_seeds_.resize(size());
+    return Status::Ok();
+}
+
+bool DecodeBatch::Contains(uint64_t session_id) const noexcept {
+    return std::ranges::find(session_ids_, session_id) != session_ids_.end();
+}
+
+StatusOr<size_t> DecodeBatch::Row(uint64_t session_id) const noexcept {
+    const auto it = std::ranges::find(session_ids_, session_id);
+    if (it == session_ids_.end()) {
+        return Status::NotFound("Session " + std::to_string(session_id) + " is not in the decode batch");
+    }
+    return static_cast<size_t>(it - session_ids_.begin());
+}
+
+StatusOr<RuntimeSequenceState> DecodeBatch::sequence_state(uint64_t session_id) const noexcept {
+    AM_ASSIGN_OR_RETURN(const size_t row, Row(session_id));
+    return states_[row];
+}
+
+std::span<const uint64_t> DecodeBatch::session_ids() const noexcept {
+    return session_ids_;
+}
+
+std::span<const KVCacheView> DecodeBatch::kv_cache_views() const noexcept {
+    return views_;
+}
+
+size_t DecodeBatch::size() const noexcept {
+    return session_ids_.size();
+}
+
+bool DecodeBatch::empty() const noexcept {
+    return session_ids_.empty();
+}
+
+size_t DecodeBatch::max_batch() const noexcept {
+    return max_batch_;
+}
+
+Status DecodeBatch::RunStep(const ExecutionPlanFamily& family,
+                            RuntimeBindingContext& bindings) noexcept {
+    if (empty()) {
+        return Status::FailedPrecondition("Decode batch has no sessions");
+    }
+
+    for (size_t row = 0; row < size(); ++row) {
+        KVCacheView& view = views_[row];
+        const size_t pos = states_[row].current_pos;
+        if (view.committed_tokens() != pos) {
+            return Status::FailedPrecondition(
+                    "Session " + std::to_string(session_ids_[row]) +
+                    " KV cache moved outside the decode batch");
+        }
+        AM_RETURN_IF_ERROR(view.ReserveTokens(pos + 1));
+        positions_[row] = pos;
+        sampling_seeds_[row] = states_[row].sampling_seed;
+    }
+
+    bindings.SetDecodeBatchBinding(DecodeBatchBinding{
+            .kv_cache_views = views_,
+            .positions = std::span<const size_t>(positions_).first(size()),
+            .sampling_seeds = std::span<const uint64_t>(sampling_seeds_).first(size()),
+    });
+    RuntimeSequenceState& sequence = bindings.mutable_sequence_state();
+    sequence.prepared = true;
+    sequence.prefill_done = true;
+    sequence.step_tokens = size();
+
+    const Status status = Executor::Execute(family, size(), bindings);
+    sequence.step_tokens = 0;
+    bindings.ClearDecodeBatchBinding();
+    AM_RETURN_IF_ERROR(status);
+
+    // Validate every row before committing any, so a session that went stale
+    // or moved during the step leaves the whole batch uncommitted.
+    for (size_t row = 0; row < size(); ++row) {
+        KVCacheView& view = views_[row];
+        if (view.committed_tokens() != positions_[row]) {
+            return Status::FailedPrecondition(
+                    "Session " + std::to_string(session_ids_[row]) +
+                    " KV cache moved during the decode step");
+        }
+        AM_RETURN_IF_ERROR(view.ReserveTokens(positions_[row] + 1));
+    }
+    for (size_t row = 0; row < size(); ++row) {
+        // Cannot fail: the row is valid and its block is already mapped.
+        (void) views_[row].CommitUntil(positions_[row] + 1);
+        RuntimeSequenceState& state = states_[row];
+        state.current_pos = positions_[row] + 1;
+        ++state.generated_len;
+    }
+    return Status::Ok();
+}
+
+}// namespace aethermind
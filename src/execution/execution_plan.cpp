@@ -1,13 +1,25 @@
 #include "aethermind/execution/execution_plan.h"
 
+#include <atomic>
 #include <utility>
 
 namespace aethermind {
+namespace {
+
+uint64_t NextPlanId() noexcept {
+    static std::atomic<uint64_t> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+}// namespace
 
 StatusOr<ExecutionPlan> ExecutionPlan::Create(std::vector<ExecutionStep> steps,
-                                              StateAliasPlan state_alias_plan) {
+                                              StateAliasPlan state_alias_plan,
+                                              WorkspacePlanLayout workspace_layout) {
     ExecutionPlan plan;
     plan.state_alias_plan_ = std::move(state_alias_plan);
+    plan.workspace_layout_ = workspace_layout;
+    plan.id_ = NextPlanId();
     plan.steps_.reserve(steps.size());
 
     for (ExecutionStep& step: steps) {
@@ -44,4 +56,12 @@ const StateAliasPlan& ExecutionPlan::state_alias_plan() const noexcept {
     return state_alias_plan_;
 }
 
+const WorkspacePlanLayout& ExecutionPlan::workspace_layout() const noexcept {
+    return workspace_layout_;
+}
+
+uint64_t ExecutionPlan::id() const noexcept {
+    return id_;
+}
+
 }// namespace aethermind
@@ -1,11 +1,19 @@
 #include "aethermind/execution/execution_plan_builder.h"
 #include "aethermind/backend/packed_weights.h"
+#include "aethermind/graph/compilation/activation_planner.h"
 #include "aethermind/graph/compilation/graph_lowering.h"
 #include "aethermind/model/model_instance.h"
 #include "aethermind/operators/function_operator.h"
 #include "aethermind/operators/operator_inference.h"
 #include "aethermind/operators/operator_registry.h"
 #include "aethermind/operators/operator_schema.h"
+#include "aethermind/shape_inference/shape_constraint_evaluator.h"
+#include "utils/overflow_check.h"
+
+#include <bit>
+#include <limits>
+#include <optional>
+#include <string>
 
 namespace aethermind {
 namespace {
@@ -18,9 +26,58 @@ KernelSelector MakeSelectorForNode(const ExecutionPlanNodeSpec& node) noexcept {
             .weight_format = node.weight_format,
             .isa = node.isa,
             .phase = node.phase,
+            .kv_layout = node.kv_layout,
     };
 }
 
+bool AccessesKVCache(OpType op_type) noexcept {
+    return op_type == OpType::kAttention || op_type == OpType::kKVCacheUpdate;
+}
+
+// KV plane order of the runtime's cache, or kAny when it has none.
+KVLayoutOrder RuntimeKVLayout(const RuntimeContext& runtime) noexcept {
+    const KVCacheManager* manager = runtime.GetKVCacheManager();
+    return manager != nullptr && manager->is_initialized() ? manager->layout().order
+                                                           : KVLayoutOrder::kAny;
+}
+
+// The prepacker can produce kQuantizedInt8/kQuantizedInt4 artifacts, either
+// from a quantization policy or from a block-quantized GGUF checkpoint, but no
+// kernel reads them yet; fail the plan instead of binding weights nothing
+// can execute.
+Status CheckWeightFormatIsExecutable(OpType op_type, WeightFormat weight_format) {
+    if (weight_format == WeightFormat::kQuantizedInt8 || weight_format == WeightFormat::kQuantizedInt4) {
+        return Status::Unimplemented(std::string("No kernel executes ") + ToString(weight_format) +
+                                     " weights of " + ToString(op_type) + " yet");
+    }
+    return Status::Ok();
+}
+
+// Sidecar role of a linear projection weight; other roles are never packed
+// per layer.
+std::optional<WeightRole> ToPackedWeightRole(TransformerWeightRole role) noexcept {
+    switch (role) {
+        case TransformerWeightRole::kAttentionQ:
+            return WeightRole::kQProj;
+        case TransformerWeightRole::kAttentionK:
+            return WeightRole::kKProj;
+        case TransformerWeightRole::kAttentionV:
+            return WeightRole::kVProj;
+        case TransformerWeightRole::kAttentionO:
+            return WeightRole::kOProj;
+        case TransformerWeightRole::kMlpGate:
+            return WeightRole::kGateProj;
+        case TransformerWeightRole::kMlpUp:
+            return WeightRole::kUpProj;
+        case TransformerWeightRole::kMlpDown:
+            return WeightRole::kDownProj;
+        case TransformerWeightRole::kLmHead:
+            return WeightRole::kLmHead;
+        default:
+            return std::nullopt;
+    }
+}
+
 StatusOr<const void*> ResolvePackedWeightsForNode(const ModelInstance* model_instance,
                                                   const ExecutionPlanNodeSpec& node) noexcept {
     if (node.weight_format != WeightFormat::kPacked) {
@@ -31,13 +88,150 @@ StatusOr<const void*> ResolvePackedWeightsForNode(const ModelInstance* model_ins
     }
 
     const auto selector = MakeSelectorForNode(node);
-    const auto* packed_weights = model_instance->FindPackedWeights(node.op_type, selector);
+    const std::optional<WeightRole> role =
+            node.weight_role.has_value() ? ToPackedWeightRole(*node.weight_role) : std::nullopt;
+    if (!role.has_value()) {
+        // Op-level artifacts, e.g. norm weights, are keyed by selector only.
+        const auto* packed_weights = model_instance->FindPackedWeights(node.op_type, selector);
+        if (packed_weights == nullptr) {
+            return Status::NotFound("Packed weights not found for ExecutionPlan node");
+        }
+        return packed_weights->storage().data();
+    }
+
+    const auto* packed_weights = model_instance->FindPackedWeights(node.decoder_layer_index, *role);
     if (packed_weights == nullptr) {
-        return Status::NotFound("Packed weights not found for ExecutionPlan node");
+        return Status::NotFound(std::string("Packed weights not found for ") + ToString(*role) +
+                                (node.decoder_layer_index.has_value()
+                                         ? " of decoder layer " + std::to_string(*node.decoder_layer_index)
+                                         : std::string()));
+    }
+    AM_RETURN_IF_ERROR(CheckWeightFormatIsExecutable(node.op_type, packed_weights->selector().weight_format));
+    if (packed_weights->op_type() != node.op_type || packed_weights->selector() != selector) {
+        return Status::FailedPrecondition(std::string("Packed weights of ") + ToString(*role) +
+                                          " were packed for a different kernel than the ExecutionPlan node");
     }
     return packed_weights->storage().data();
 }
 
+// Bucket-specific rewrite applied to lowered nodes while building one member
+// of an ExecutionPlanFamily. `seq_len` is the graph's symbolic token-count
+// dimension; every bucket serves token counts in [min_tokens, max_tokens].
+struct PlanSpecialization {
+    ShapeSymbol seq_len{};
+    size_t min_tokens = 0;
+    size_t max_tokens = 0;
+    ExecPhase phase = ExecPhase::kBoth;
+    /// Caller-proven symbol facts; see PlanBucketConfig::proven_facts.
+    const SymbolConstraintSolver* proven_facts = nullptr;
+
+    AM_NODISCARD bool exact() const noexcept {
+        return min_tokens == max_tokens;
+    }
+};
+
+void SpecializeShape(SymbolicShape& shape, const PlanSpecialization& specialization) {
+    if (!shape.IsRanked()) {
+        return;
+    }
+    const ShapeSymbol folded =
+            ShapeSymbol::CreateFromValue(static_cast<int64_t>(specialization.max_tokens));
+    for (size_t i = 0; i < *shape.rank(); ++i) {
+        if (shape[i] == specialization.seq_len) {
+            shape[i] = folded;
+        }
+    }
+}
+
+// Only exact buckets fold the sequence symbol into a static dimension; ranged
+// prefill buckets keep it symbolic so one plan serves every length in range.
+// Nodes lowered with an explicit phase keep it; kBoth nodes adopt the bucket
+// phase so the kernel selector can pick decode- or prefill-specific kernels.
+ExecutionPlanNodeSpec SpecializeNode(const ExecutionPlanNodeSpec& node,
+                                     const PlanSpecialization& specialization) {
+    ExecutionPlanNodeSpec specialized = node;
+    if (specialized.phase == ExecPhase::kBoth) {
+        specialized.phase = specialization.phase;
+    }
+    if (specialization.exact()) {
+        for (TensorSpec& spec: specialized.input_specs) {
+            SpecializeShape(spec.shape, specialization);
+        }
+        for (TensorSpec& spec: specialized.output_specs) {
+            SpecializeShape(spec.shape, specialization);
+        }
+    }
+    return specialized;
+}
+
+const SymbolicShape* FindPortShape(const TensorPort& port,
+                                   std::span<const SymbolicShape> inputs,
+                                   std::span<const SymbolicShape> outputs) noexcept {
+    const auto shapes = port.direction == TensorPortType::kInput ? inputs : outputs;
+    return port.tensor_idx < shapes.size() ? &shapes[port.tensor_idx] : nullptr;
+}
+
+// A bucket never serves zero tokens, so positivity of the sequence dimension
+// holds for every member of its range even when the dimension stays symbolic.
+bool IsDischargedBySequenceRange(const ShapeConstraint& check,
+                                 std::span<const SymbolicShape> inputs,
+                                 std::span<const SymbolicShape> outputs,
+                                 const PlanSpecialization& specialization) noexcept {
+    const auto* positive = std::get_if<DimPositiveConstraint>(&check.condition);
+    if (positive == nullptr || specialization.min_tokens == 0) {
+        return false;
+    }
+    const SymbolicShape* shape = FindPortShape(positive->dim.tensor_port, inputs, outputs);
+    if (shape == nullptr || !shape->IsRanked() || positive->dim.dim_index >= *shape->rank()) {
+        return false;
+    }
+    return (*shape)[positive->dim.dim_index] == specialization.seq_len;
+}
+
+std::vector<SymbolicShape> CollectShapes(std::span<const TensorSpec> specs) {
+    std::vector<SymbolicShape> shapes;
+    shapes.reserve(specs.size());
+    for (const TensorSpec& spec: specs) {
+        shapes.push_back(spec.shape);
+    }
+    return shapes;
+}
+
+// Re-evaluates deferred runtime checks against the bucket-specialized specs.
+// Checks proven for the bucket are dropped from the plan; checks disproven
+// make the bucket unbuildable; the rest stay deferred to execution time.
+Status FoldRuntimeChecks(const PlanSpecialization& specialization,
+                         std::span<const TensorSpec> input_specs,
+                         std::span<const TensorSpec> output_specs,
+                         std::vector<ShapeConstraint>& checks) {
+    if (checks.empty() || (input_specs.empty() && output_specs.empty())) {
+        return Status::Ok();
+    }
+
+    const std::vector<SymbolicShape> inputs = CollectShapes(input_specs);
+    const std::vector<SymbolicShape> outputs = CollectShapes(output_specs);
+
+    std::vector<ShapeConstraint> remaining;
+    for (ShapeConstraint& check: checks) {
+        const auto result = specialization.proven_facts != nullptr
+                                    ? EvaluateShapeConstraint(check, inputs, outputs, *specialization.proven_facts)
+                                    : EvaluateShapeConstraint(check, inputs, outputs);
+        if (result == ShapeConstraintEvaluationResult::kViolated) {
+            return Status::InvalidArgument(
+                    "Runtime shape constraint is violated for plan bucket ending at " +
+                    std::to_string(specialization.max_tokens) + " tokens: " +
+                    check.error_context);
+        }
+        if (result == ShapeConstraintEvaluationResult::kSatisfied ||
+            IsDischargedBySequenceRange(check, inputs, outputs, specialization)) {
+            continue;
+        }
+        remaining.push_back(std::move(check));
+    }
+    checks = std::move(remaining);
+    return Status::Ok();
+}
+
 struct PreparedOperator {
     OperatorPtr op{};
     std::vector<TensorSpec> compact_input_specs{};
@@ -202,24 +396,49 @@ StatusOr<PreparedOperator> CreateAndPrepareOperator(Backend& backend,
 StatusOr<ExecutionPlan> BuildExecutionPlan(RuntimeContext& runtime,
                                            const ModelInstance* model_instance,
                                            const std::vector<ExecutionPlanNodeSpec>& nodes,
+                                           std::span<const std::optional<uint32_t>> step_layers,
                                            StateAliasPlan state_alias_plan,
-                                           bool trusted) {
+                                           bool trusted,
+                                           const PlanSpecialization* specialization = nullptr) {
     std::vector<WorkspaceRequirement> workspace_requirements;
     workspace_requirements.reserve(nodes.size());
     for (const ExecutionPlanNodeSpec& node: nodes) {
         workspace_requirements.push_back(node.workspace_requirement);
     }
 
-    if (const auto layout = PlanWorkspaceRequirements(
-                std::span(workspace_requirements));
-        !layout.ok()) {
-        return layout.status();
-    }
+    // Steps whose scratch is never live at the same time share offsets, so
+    // the arena is sized by peak usage rather than by the number of layers.
+    AM_ASSIGN_OR_RETURN(const WorkspacePlanLayout workspace_layout,
+                        PlanWorkspaceRequirementsWithReuse(
+                                std::span(workspace_requirements), step_layers));
 
+    const KVLayoutOrder kv_layout = RuntimeKVLayout(runtime);
     std::vector<ExecutionStep> steps;
     steps.reserve(nodes.size());
     for (size_t index = 0; index < nodes.size(); ++index) {
-        const auto& node = nodes[index];
+        std::optional<ExecutionPlanNodeSpec> specialized;
+        if (specialization != nullptr) {
+            specialized = SpecializeNode(nodes[index], *specialization);
+        }
+        if (nodes[index].kv_layout == KVLayoutOrder::kAny && kv_layout != KVLayoutOrder::kAny &&
+            AccessesKVCache(nodes[index].op_type)) {
+            if (!specialized.has_value()) {
+                specialized = nodes[index];
+            }
+            specialized->kv_layout = kv_layout;
+        }
+        const auto& node = specialized.has_value() ? *specialized : nodes[index];
+        AM_RETURN_IF_ERROR(CheckWeightFormatIsExecutable(node.op_type, node.weight_format));
+
+        // Packed weights are stored under the lowered node's selector; bucket
+        // specialization only changes how kernels are resolved. They are bound
+        // before the kernel so a quantized artifact reports itself rather than
+        // the kernel lookup it would fail.
+        const auto packed_weights =
+                ResolvePackedWeightsForNode(model_instance, nodes[index]);
+        if (!packed_weights.ok()) {
+            return packed_weights.status();
+        }
 
         auto backend = runtime.GetBackend(node.device_type);
         if (!backend.ok()) {
@@ -233,6 +452,12 @@ StatusOr<ExecutionPlan> BuildExecutionPlan(RuntimeContext& runtime,
         }
 
         PreparedOperator prepared = prepared_operator.value();
+        if (specialization != nullptr) {
+            AM_RETURN_IF_ERROR(FoldRuntimeChecks(*specialization,
+                                                 prepared.compact_input_specs,
+                                                 prepared.output_specs,
+                                                 prepared.runtime_checks));
+        }
         OperatorPtr op = std::move(prepared.op);
         if (op == nullptr) {
             const auto resolved =
@@ -247,12 +472,6 @@ StatusOr<ExecutionPlan> BuildExecutionPlan(RuntimeContext& runtime,
                     resolved->debug_name);
         }
 
-        const auto packed_weights =
-                ResolvePackedWeightsForNode(model_instance, node);
-        if (!packed_weights.ok()) {
-            return packed_weights.status();
-        }
-
         steps.push_back({
                 .selector = MakeSelectorForNode(node),
                 .op = std::move(op),
@@ -262,10 +481,154 @@ StatusOr<ExecutionPlan> BuildExecutionPlan(RuntimeContext& runtime,
                 .output_specs = std::move(prepared.output_specs),
                 .runtime_checks = std::move(prepared.runtime_checks),
                 .debug_name = nullptr,
+                .decoder_layer_index = index < step_layers.size() ? step_layers[index] : std::nullopt,
         });
     }
 
-    return ExecutionPlan::Create(std::move(steps), std::move(state_alias_plan));
+    return ExecutionPlan::Create(std::move(steps), std::move(state_alias_plan),
+                                 workspace_layout);
+}
+
+// Decoder layer of each lowered step, used to bound kPerLayer workspace live
+// ranges. Empty when the bindings do not line up with the steps.
+std::vector<std::optional<uint32_t>> CollectStepLayers(const LoweredGraph& lowered) {
+    std::vector<std::optional<uint32_t>> layers;
+    if (lowered.step_bindings.size() != lowered.steps.size()) {
+        return layers;
+    }
+    layers.reserve(lowered.step_bindings.size());
+    for (const LoweredStepBinding& binding: lowered.step_bindings) {
+        layers.push_back(binding.decoder_layer_index);
+    }
+    return layers;
+}
+
+// The token inputs of a lowered model share one symbolic sequence dimension.
+// Unless `configured` names it, recover it from dimension 0 of the first model input as seen by its first
+// consumer step.
+StatusOr<ShapeSymbol> ResolveSequenceSymbol(const LoweredGraph& lowered,
+                                            ShapeSymbol configured) {
+    if (!configured.IsUnknown()) {
+        if (!configured.IsSymbolic()) {
+            return Status::InvalidArgument(
+                    "Bucket config seq_len must be a symbolic dimension");
+        }
+        return configured;
+    }
+
+    if (lowered.model_inputs.empty()) {
+        return Status::InvalidArgument(
+                "Cannot derive the sequence dimension of a LoweredGraph without model inputs");
+    }
+
+    const GraphValueId token_input = lowered.model_inputs.front();
+    const size_t num_steps = std::min(lowered.steps.size(), lowered.step_bindings.size());
+    for (size_t i = 0; i < num_steps; ++i) {
+        const auto& input_values = lowered.step_bindings[i].input_values;
+        const auto& input_specs = lowered.steps[i].input_specs;
+        for (size_t port = 0; port < input_values.size() && port < input_specs.size(); ++port) {
+            if (input_values[port] != token_input) {
+                continue;
+            }
+            const SymbolicShape& shape = input_specs[port].shape;
+            if (!shape.IsRanked() || *shape.rank() == 0 || !shape[0].IsSymbolic()) {
+                return Status::InvalidArgument(
+                        "First model input dimension 0 is not a symbolic sequence length");
+            }
+            return shape[0];
+        }
+    }
+    return Status::NotFound("First model input is not consumed by any lowered step");
+}
+
+StatusOr<std::vector<PlanSpecialization>> MakeBucketSpecializations(
+        const PlanBucketConfig& config,
+        ShapeSymbol seq_len) {
+    if (config.max_prefill_tokens == 0) {
+        return Status::InvalidArgument("PlanBucketConfig.max_prefill_tokens must be non-zero");
+    }
+    if (config.min_prefill_bucket < 2 ||
+        !std::has_single_bit(config.min_prefill_bucket)) {
+        return Status::InvalidArgument(
+                "PlanBucketConfig.min_prefill_bucket must be a power of two >= 2");
+    }
+
+    std::vector<PlanSpecialization> buckets;
+    size_t next_min = 1;
+    if (config.include_decode) {
+        buckets.push_back({.seq_len = seq_len,
+                           .min_tokens = 1,
+                           .max_tokens = 1,
+                           .phase = ExecPhase::kDecode,
+                           .proven_facts = config.proven_facts});
+        next_min = 2;
+    }
+
+    size_t upper = config.min_prefill_bucket;
+    while (true) {
+        buckets.push_back({.seq_len = seq_len,
+                           .min_tokens = next_min,
+                           .max_tokens = upper,
+                           .phase = ExecPhase::kPrefill,
+                           .proven_facts = config.proven_facts});
+        if (upper >= config.max_prefill_tokens) {
+            break;
+        }
+        next_min = upper + 1;
+        if (CheckOverflowMul(upper, size_t{2}, &upper)) {
+            return Status::Overflow("Prefill bucket upper bound overflowed size_t");
+        }
+    }
+    return buckets;
+}
+
+// Exact buckets for batches of one and two sessions, then power-of-two ranges.
+StatusOr<std::vector<PlanSpecialization>> MakeDecodeBatchSpecializations(
+        const DecodeBatchConfig& config,
+        ShapeSymbol seq_len) {
+    if (config.max_batch == 0) {
+        return Status::InvalidArgument("DecodeBatchConfig.max_batch must be non-zero");
+    }
+
+    std::vector<PlanSpecialization> buckets;
+    size_t next_min = 1;
+    size_t upper = 1;
+    while (true) {
+        buckets.push_back({.seq_len = seq_len,
+                           .min_tokens = next_min,
+                           .max_tokens = upper,
+                           .phase = ExecPhase::kDecode});
+        if (upper >= config.max_batch) {
+            break;
+        }
+        next_min = upper + 1;
+        if (CheckOverflowMul(upper, size_t{2}, &upper)) {
+            return Status::Overflow("Decode batch bucket upper bound overflowed size_t");
+        }
+    }
+    return buckets;
+}
+
+StatusOr<ExecutionPlanFamily> BuildExecutionPlanFamily(
+        RuntimeContext& runtime,
+        const ModelInstance* model_instance,
+        const LoweredGraph& lowered,
+        const std::vector<PlanSpecialization>& specializations) {
+    AM_ASSIGN_OR_RETURN(const StateAliasPlan alias_plan, ResolveStateAliases(lowered));
+    const std::vector<std::optional<uint32_t>> step_layers = CollectStepLayers(lowered);
+
+    std::vector<ExecutionPlanBucket> buckets;
+    buckets.reserve(specializations.size());
+    for (const PlanSpecialization& specialization: specializations) {
+        AM_ASSIGN_OR_RETURN(ExecutionPlan plan,
+                            BuildExecutionPlan(runtime, model_instance, lowered.steps,
+                                               step_layers, alias_plan, /*trusted=*/true,
+                                               &specialization));
+        buckets.push_back({.min_tokens = specialization.min_tokens,
+                           .max_tokens = specialization.max_tokens,
+                           .plan = std::move(plan)});
+    }
+    return ExecutionPlanFamily::Create(std::move(buckets));
 }
 
 }// namespace
@@ -291,7 +654,7 @@ StatusOr<ResolvedKernel> ExecutionPlanBuilder::ResolveKernelForNode(
 StatusOr<ExecutionPlan> ExecutionPlanBuilder::Build(
         RuntimeContext& runtime,
         const std::vector<ExecutionPlanNodeSpec>& nodes) {
-    return BuildExecutionPlan(runtime, nullptr, nodes,
+    return BuildExecutionPlan(runtime, nullptr, nodes, {},
                               StateAliasPlan{}, /*trusted=*/false);
 }
 
@@ -299,7 +662,7 @@ StatusOr<ExecutionPlan> ExecutionPlanBuilder::Build(
         RuntimeContext& runtime,
         const ModelInstance& model_instance,
         const std::vector<ExecutionPlanNodeSpec>& nodes) {
-    return BuildExecutionPlan(runtime, &model_instance, nodes,
+    return BuildExecutionPlan(runtime, &model_instance, nodes, {},
                               StateAliasPlan{}, /*trusted=*/false);
 }
 
@@ -308,7 +671,8 @@ StatusOr<ExecutionPlan> ExecutionPlanBuilder::Build(
         const LoweredGraph& lowered) {
     StatusOr<StateAliasPlan> alias_plan = ResolveStateAliases(lowered);
     AM_RETURN_IF_ERROR(alias_plan.status());
-    return BuildExecutionPlan(runtime, nullptr, lowered.steps,
+    const std::vector<std::optional<uint32_t>> step_layers = CollectStepLayers(lowered);
+    return BuildExecutionPlan(runtime, nullptr, lowered.steps, step_layers,
                               std::move(alias_plan).value(), /*trusted=*/true);
 }
 
@@ -318,8 +682,64 @@ StatusOr<ExecutionPlan> ExecutionPlanBuilder::Build(
         const LoweredGraph& lowered) {
     StatusOr<StateAliasPlan> alias_plan = ResolveStateAliases(lowered);
     AM_RETURN_IF_ERROR(alias_plan.status());
-    return BuildExecutionPlan(runtime, &model_instance, lowered.steps,
+    const std::vector<std::optional<uint32_t>> step_layers = CollectStepLayers(lowered);
+    return BuildExecutionPlan(runtime, &model_instance, lowered.steps, step_layers,
                               std::move(alias_plan).value(), /*trusted=*/true);
 }
 
+StatusOr<ExecutionPlanFamily> ExecutionPlanBuilder::BuildBucketed(
+        RuntimeContext& runtime,
+        const LoweredGraph& lowered,
+        const PlanBucketConfig& config) {
+    AM_ASSIGN_OR_RETURN(const ShapeSymbol seq_len, ResolveSequenceSymbol(lowered, config.seq_len));
+    AM_ASSIGN_OR_RETURN(const std::vector<PlanSpecialization> specializations,
+                        MakeBucketSpecializations(config, seq_len));
+    return BuildExecutionPlanFamily(runtime, nullptr, lowered, specializations);
+}
+
+StatusOr<ExecutionPlanFamily> ExecutionPlanBuilder::BuildBucketed(
+        RuntimeContext& runtime,
+        const ModelInstance& model_instance,
+        const LoweredGraph& lowered,
+        const PlanBucketConfig& config) {
+    AM_ASSIGN_OR_RETURN(const ShapeSymbol seq_len, ResolveSequenceSymbol(lowered, config.seq_len));
+    AM_ASSIGN_OR_RETURN(const std::vector<PlanSpecialization> specializations,
+                        MakeBucketSpecializations(config, seq_len));
+    return BuildExecutionPlanFamily(runtime, &model_instance, lowered, specializations);
+}
+
+StatusOr<ExecutionPlanFamily> ExecutionPlanBuilder::BuildDecodeBatched(
+        RuntimeContext& runtime,
+        const LoweredGraph& lowered,
+        const DecodeBatchConfig& config) {
+    AM_ASSIGN_OR_RETURN(const ShapeSymbol seq_len, ResolveSequenceSymbol(lowered, config.seq_len));
+    AM_ASSIGN_OR_RETURN(const std::vector<PlanSpecialization> specializations,
+                        MakeDecodeBatchSpecializations(config, seq_len));
+    return BuildExecutionPlanFamily(runtime, nullptr, lowered, specializations);
+}
+
+StatusOr<ExecutionPlanFamily> ExecutionPlanBuilder::BuildDecodeBatched(
+        RuntimeContext& runtime,
+        const ModelInstance& model_instance,
+        const LoweredGraph& lowered,
+        const DecodeBatchConfig& config) {
+    AM_ASSIGN_OR_RETURN(const ShapeSymbol seq_len, ResolveSequenceSymbol(lowered, config.seq_len));
+    AM_ASSIGN_OR_RETURN(const std::vector<PlanSpecialization> specializations,
+                        MakeDecodeBatchSpecializations(config, seq_len));
+    return BuildExecutionPlanFamily(runtime, &model_instance, lowered, specializations);
+}
+
+StatusOr<ActivationPlan> ExecutionPlanBuilder::PlanActivations(
+        const LoweredGraph& lowered,
+        size_t max_tokens,
+        ShapeSymbol seq_len) {
+    if (max_tokens == 0 || max_tokens > static_cast<size_t>(std::numeric_limits<int64_t>::max())) {
+        return Status::InvalidArgument("Activation planning requires a positive token bound");
+    }
+    AM_ASSIGN_OR_RETURN(const ShapeSymbol resolved, ResolveSequenceSymbol(lowered, seq_len));
+    ActivationPlannerConfig config;
+    config.symbol_bounds.push_back({.symbol = resolved, .max_value = static_cast<int64_t>(max_tokens)});
+    return PlanActivationBuffers(lowered, config);
+}
+
 }// namespace aethermind
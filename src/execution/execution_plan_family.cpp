@@ -0,0 +1,66 @@
+#include "aethermind/execution/execution_plan_family.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace aethermind {
+
+StatusOr<ExecutionPlanFamily> ExecutionPlanFamily::Create(
+        std::vector<ExecutionPlanBucket> buckets) {
+    if (buckets.empty()) {
+        return Status::InvalidArgument("ExecutionPlanFamily requires at least one bucket");
+    }
+
+    for (const ExecutionPlanBucket& bucket: buckets) {
+        if (bucket.min_tokens == 0 || bucket.min_tokens > bucket.max_tokens) {
+            return Status::InvalidArgument(
+                    "ExecutionPlanFamily bucket must cover a non-empty token range starting at 1 or later");
+        }
+    }
+
+    std::sort(buckets.begin(), buckets.end(),
+              [](const ExecutionPlanBucket& lhs, const ExecutionPlanBucket& rhs) noexcept {
+                  return lhs.max_tokens < rhs.max_tokens;
+              });
+
+    for (size_t i = 1; i < buckets.size(); ++i) {
+        if (buckets[i].min_tokens <= buckets[i - 1].max_tokens) {
+            return Status::InvalidArgument(
+                    "ExecutionPlanFamily buckets must not overlap; bucket ending at " +
+                    std::to_string(buckets[i].max_tokens) + " overlaps its predecessor");
+        }
+    }
+
+    ExecutionPlanFamily family;
+    family.buckets_ = std::move(buckets);
+    return family;
+}
+
+StatusOr<const ExecutionPlan*> ExecutionPlanFamily::Select(size_t num_tokens) const noexcept {
+    // Buckets are sorted by max_tokens, so the first bucket whose upper bound
+    // reaches num_tokens is the smallest candidate.
+    const auto it = std::lower_bound(
+            buckets_.begin(), buckets_.end(), num_tokens,
+            [](const ExecutionPlanBucket& bucket, size_t tokens) noexcept {
+                return bucket.max_tokens < tokens;
+            });
+    if (it == buckets_.end() || !it->Contains(num_tokens)) {
+        return Status::OutOfRange("No ExecutionPlan bucket covers the requested token count");
+    }
+    return &it->plan;
+}
+
+const std::vector<ExecutionPlanBucket>& ExecutionPlanFamily::buckets() const noexcept {
+    return buckets_;
+}
+
+size_t ExecutionPlanFamily::size() const noexcept {
+    return buckets_.size();
+}
+
+size_t ExecutionPlanFamily::max_tokens() const noexcept {
+    return buckets_.empty() ? 0 : buckets_.back().max_tokens;
+}
+
+}// namespace aethermind
@@ -10,4 +10,14 @@ Status Executor::Execute(const ExecutionPlan& plan,
     return LayerRunner::Run(plan, bindings);
 }
 
+Status Executor::Execute(const ExecutionPlanFamily& family,
+                         size_t num_tokens,
+                         RuntimeBindingContext& bindings) noexcept {
+    const StatusOr<const ExecutionPlan*> plan = family.Select(num_tokens);
+    if (!plan.ok()) {
+        return plan.status();
+    }
+    return LayerRunner::Run(*plan.value(), bindings);
+}
+
 }// namespace aethermind
@@ -0,0 +1,471 @@
+#include "aethermind/execution/generation_session.h"
+#include "aethermind/execution/chunked_prefill.h"
+#include "aethermind/execution/execution_plan_builder.h"
+#include "aethermind/execution/executor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace aethermind {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double MillisecondsBetween(Clock::time_point begin, Clock::time_point end) noexcept {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+PlanBucketConfig MakeBucketConfig(const GenerationSessionOptions& options) noexcept {
+    return PlanBucketConfig{
+            .include_decode = true,
+            .min_prefill_bucket = options.min_prefill_bucket,
+            .max_prefill_tokens = options.max_prefill_tokens,
+            .proven_facts = options.proven_shape_facts,
+    };
+}
+
+// Collects emitted tokens and decides when generation stops.
+class TokenSink {
+public:
+    TokenSink(const GenerationConfig& config, const TokenCallback& on_token)
+        : config_(config), on_token_(on_token) {
+        result.tokens.reserve(config.max_new_tokens);
+    }
+
+    // Returns false once generation must stop after `token`.
+    bool Emit(int64_t token) {
+        result.tokens.push_back(token);
+        if (on_token_ && !on_token_(token)) {
+            result.finish_reason = FinishReason::kCancelled;
+            return false;
+        }
+        if (config_.eos_token_id.has_value() && token == *config_.eos_token_id) {
+            result.finish_reason = FinishReason::kEos;
+            return false;
+        }
+        if (result.tokens.size() == config_.max_new_tokens) {
+            result.finish_reason = FinishReason::kLength;
+            return false;
+        }
+        return true;
+    }
+
+    GenerationResult Finish(Clock::time_point start, Clock::time_point first_token) {
+        const Clock::time_point end = Clock::now();
+        GenerationStats& stats = result.stats;
+        stats.generated_tokens = result.tokens.size();
+        stats.ttft_ms = MillisecondsBetween(start, first_token);
+        stats.total_ms = MillisecondsBetween(start, end);
+        const double decode_ms = MillisecondsBetween(first_token, end);
+        if (stats.generated_tokens > 1 && decode_ms > 0.0) {
+            stats.decode_tokens_per_second =
+                    static_cast<double>(stats.generated_tokens - 1) * 1000.0 / decode_ms;
+        }
+        return std::move(result);
+    }
+
+    GenerationResult result{};
+
+private:
+    const GenerationConfig& config_;
+    const TokenCallback& on_token_;
+};
+
+}// namespace
+
+StatusOr<GenerationSession> GenerationSession::Create(RuntimeContext& runtime,
+                                                      const LoweredGraph& lowered,
+                                                      GenerationSessionOptions options) {
+    AM_ASSIGN_OR_RETURN(ExecutionPlanFamily family,
+                        ExecutionPlanBuilder::BuildBucketed(runtime, lowered, MakeBucketConfig(options)));
+    return Build(runtime, std::move(family), std::move(options), &lowered);
+}
+
+StatusOr<GenerationSession> GenerationSession::Create(RuntimeContext& runtime,
+                                                      const ModelInstance& model_instance,
+                                                      const LoweredGraph& lowered,
+                                                      GenerationSessionOptions options) {
+    AM_ASSIGN_OR_RETURN(ExecutionPlanFamily family,
+                        ExecutionPlanBuilder::BuildBucketed(runtime, model_instance, lowered,
+                                                            MakeBucketConfig(options)));
+    return Build(runtime, std::move(family), std::move(options), &lowered);
+}
+
+StatusOr<GenerationSession> GenerationSession::Create(RuntimeContext& runtime,
+                                                      ExecutionPlanFamily family,
+                                                      GenerationSessionOptions options) {
+    if (options.plan_activations) {
+        return Status::InvalidArgument("Generation session plans activations only from a LoweredGraph");
+    }
+    return Build(runtime, std::move(family), std::move(options), nullptr);
+}
+
+StatusOr<GenerationSession> GenerationSession::Build(RuntimeContext& runtime,
+                                                     ExecutionPlanFamily family,
+                                                     GenerationSessionOptions options,
+                                                     const LoweredGraph* lowered) {
+    KVCacheManager* manager = runtime.GetKVCacheManager();
+    if (manager == nullptr || !manager->is_initialized()) {
+        return Status::FailedPrecondition("Generation session requires an initialized KVCacheManager");
+    }
+    if (!options.binder) {
+        return Status::InvalidArgument("Generation session requires a step tensor binder");
+    }
+    if (family.buckets().front().max_tokens != 1) {
+        return Status::InvalidArgument("Generation session requires a dedicated one-token decode bucket");
+    }
+
+    GenerationSession session(*manager, std::move(family), std::move(options));
+    AM_ASSIGN_OR_RETURN(session.decode_plan_, session.family_.Select(1));
+    AM_RETURN_IF_ERROR(session.BindTempBuffers(runtime));
+    if (session.options_.plan_activations && lowered != nullptr) {
+        AM_RETURN_IF_ERROR(session.AllocateActivationArena(runtime, *lowered));
+    }
+    return session;
+}
+
+GenerationSession::GenerationSession(KVCacheManager& manager,
+                                     ExecutionPlanFamily family,
+                                     GenerationSessionOptions options) noexcept
+    : manager_(&manager),
+      family_(std::move(family)),
+      options_(std::move(options)),
+      io_(std::make_unique<StepBuffers>()),
+      bindings_(options_.workspace_arena) {
+    const size_t capacity = family_.max_tokens();
+    io_->token_ids.resize(capacity);
+    io_->position_ids.resize(capacity);
+    io_->output_tokens.resize(capacity);
+    bindings_.SetShapeCheckMode(options_.shape_check_mode);
+}
+
+Status GenerationSession::BindTempBuffers(RuntimeContext& runtime) {
+    const std::pair<TempBufferKind, size_t> requests[] = {
+            {TempBufferKind::kHiddenState, options_.hidden_state_bytes},
+            {TempBufferKind::kLogits, options_.logits_bytes},
+            {TempBufferKind::kScratch, options_.scratch_bytes},
+    };
+    Allocator& allocator = runtime.GetAllocator(Device::CPU());
+    for (const auto& [kind, bytes]: requests) {
+        if (bytes == 0) {
+            continue;
+        }
+        Buffer buffer = allocator.Allocate(bytes);
+        if (buffer.mutable_data() == nullptr) {
+            return Status::ResourceExhausted("Failed to allocate " + std::to_string(bytes) +
+                                             " bytes of generation temp buffer");
+        }
+        bindings_.SetTempBufferBinding(kind, TempBufferBinding{.data = buffer.mutable_data(), .size = bytes});
+        temp_buffers_.push_back(std::move(buffer));
+    }
+    return Status::Ok();
+}
+
+Status GenerationSession::AllocateActivationArena(RuntimeContext& runtime, const LoweredGraph& lowered) {
+    // Sized for the largest bucket, so every chunk and decode step slices the
+    // same bytes and bound views never need to move.
+    AM_ASSIGN_OR_RETURN(activation_plan_, ExecutionPlanBuilder::PlanActivations(lowered, family_.max_tokens()));
+    if (activation_plan_.total_bytes == 0) {
+        return Status::Ok();
+    }
+    Buffer arena = runtime.GetAllocator(Device::CPU()).Allocate(activation_plan_.total_bytes);
+    if (arena.mutable_data() == nullptr) {
+        return Status::ResourceExhausted("Failed to allocate " + std::to_string(activation_plan_.total_bytes) +
+                                         " bytes of generation activation arena");
+    }
+    if (reinterpret_cast<uintptr_t>(arena.mutable_data()) % activation_plan_.required_alignment != 0) {
+        return Status::Internal("Generation activation arena is not " +
+                                std::to_string(activation_plan_.required_alignment) + "-byte aligned");
+    }
+    activation_arena_ = std::move(arena);
+    return Status::Ok();
+}
+
+Status GenerationSession::BindStep(ExecPhase phase, size_t num_tokens, GenerationStats& stats) {
+    const std::pair<ExecPhase, size_t> shape{phase, num_tokens};
+    if (io_->bound == shape) {
+        return Status::Ok();
+    }
+    io_->bound.reset();
+    io_->shape[0] = static_cast<int64_t>(num_tokens);
+    GenerationStepIO step_io{
+            .phase = phase,
+            .num_tokens = num_tokens,
+            .token_ids = TensorView(io_->token_ids.data(), DataType::Int(64), io_->shape, io_->strides),
+            .position_ids = TensorView(io_->position_ids.data(), DataType::Int(64), io_->shape, io_->strides),
+            .output_tokens = MutableTensorView(io_->output_tokens.data(), DataType::Int(64),
+                                               io_->shape, io_->strides),
+    };
+    if (activation_arena_.is_initialized()) {
+        step_io.activation_plan = &activation_plan_;
+        step_io.activation_arena = static_cast<std::byte*>(activation_arena_.mutable_data());
+    }
+    ++stats.tensor_bind_calls;
+    AM_RETURN_IF_ERROR(options_.binder(step_io, bindings_));
+    io_->bound = shape;
+    return Status::Ok();
+}
+
+StatusOr<GenerationResult> GenerationSession::Generate(std::span<const int64_t> prompt,
+                                                       const GenerationConfig& config,
+                                                       const TokenCallback& on_token) {
+    AM_ASSIGN_OR_RETURN(const size_t chunk_tokens, ValidateRequest(prompt, config));
+    if (config.max_new_tokens == 0) {
+        GenerationResult result;
+        result.stats.prompt_tokens = prompt.size();
+        return result;
+    }
+
+    AM_RETURN_IF_ERROR(BeginRequest(prompt.size(), config));
+    StatusOr<GenerationResult> result = Run(prompt, config, chunk_tokens, on_token);
+    const Status ended = EndRequest();
+    if (result.ok() && !ended.ok()) {
+        return ended;
+    }
+    return result;
+}
+
+StatusOr<GenerationResult> GenerationSession::GenerateSpeculative(GenerationSession& draft,
+                                                                  std::span<const int64_t> prompt,
+                                                                  const GenerationConfig& config,
+                                                                  const SpeculativeConfig& speculative,
+                                                                  const TokenCallback& on_token) {
+    if (&draft == this) {
+        return Status::InvalidArgument("Speculative decoding requires a separate draft session");
+    }
+    if (speculative.num_draft_tokens == 0) {
+        return Status::InvalidArgument("Speculative decoding requires at least one draft token");
+    }
+    if (speculative.num_draft_tokens >= family_.max_tokens()) {
+        return Status::InvalidArgument("Target plans cannot verify " +
+                                       std::to_string(speculative.num_draft_tokens) +
+                                       " draft tokens in one step");
+    }
+    // Verification writes every draft before knowing which are accepted; in
+    // a ring those rows evict tokens still inside the attention window, and
+    // rolling the draft back past a wrap is impossible.
+    if (manager_->layout().sliding_window || draft.manager_->layout().sliding_window) {
+        return Status::FailedPrecondition("Speculative decoding does not support sliding-window KV caches");
+    }
+    AM_ASSIGN_OR_RETURN(const size_t chunk_tokens, ValidateRequest(prompt, config));
+    AM_ASSIGN_OR_RETURN(const size_t draft_chunk_tokens, draft.ValidateRequest(prompt, config));
+    if (config.max_new_tokens == 0) {
+        GenerationResult result;
+        result.stats.prompt_tokens = prompt.size();
+        return result;
+    }
+
+    AM_RETURN_IF_ERROR(BeginRequest(prompt.size(), config));
+    const Status draft_begun = draft.BeginRequest(prompt.size(), config);
+    if (!draft_begun.ok()) {
+        (void) EndRequest();
+        return draft_begun;
+    }
+    StatusOr<GenerationResult> result = RunSpeculative(draft, prompt, config, chunk_tokens,
+                                                       draft_chunk_tokens, speculative.num_draft_tokens,
+                                                       on_token);
+    const Status draft_ended = draft.EndRequest();
+    const Status ended = EndRequest();
+    if (!result.ok()) {
+        return result;
+    }
+    AM_RETURN_IF_ERROR(draft_ended);
+    AM_RETURN_IF_ERROR(ended);
+    return result;
+}
+
+StatusOr<size_t> GenerationSession::ValidateRequest(std::span<const int64_t> prompt,
+                                                    const GenerationConfig& config) const {
+    if (prompt.empty()) {
+        return Status::InvalidArgument("Generation requires a non-empty prompt");
+    }
+    const size_t chunk_tokens = config.prefill_chunk_tokens == 0 ? family_.max_tokens()
+                                                                 : config.prefill_chunk_tokens;
+    if (chunk_tokens > family_.max_tokens()) {
+        return Status::InvalidArgument("Prefill chunk of " + std::to_string(chunk_tokens) +
+                                       " tokens exceeds the largest plan bucket");
+    }
+    return chunk_tokens;
+}
+
+Status GenerationSession::BeginRequest(size_t prompt_len, const GenerationConfig& config) {
+    AM_ASSIGN_OR_RETURN(KVCacheView view,
+                        manager_->ReserveForChunkedPrefill(prompt_len, config.max_new_tokens));
+    bindings_.SetKVCacheView(view);
+    bindings_.ResetSequenceState();
+    bindings_.mutable_sequence_state().sampling_seed = config.seed;
+    return Status::Ok();
+}
+
+Status GenerationSession::EndRequest() {
+    bindings_.ResetSequenceState();
+    const Status released = manager_->ReleaseSession(bindings_.mutable_kv_cache_view());
+    bindings_.ClearKVCacheView();
+    return released;
+}
+
+StatusOr<int64_t> GenerationSession::Prefill(std::span<const int64_t> prompt,
+                                             size_t chunk_tokens,
+                                             GenerationStats& stats) {
+    AM_ASSIGN_OR_RETURN(ChunkedPrefill prefill, ChunkedPrefill::Create(prompt.size(), chunk_tokens));
+    int64_t token = 0;
+    while (!prefill.done()) {
+        const PrefillChunk chunk = prefill.next_chunk();
+        AM_RETURN_IF_ERROR(BindStep(ExecPhase::kPrefill, chunk.num_tokens, stats));
+        for (size_t i = 0; i < chunk.num_tokens; ++i) {
+            io_->token_ids[i] = prompt[chunk.begin + i];
+            io_->position_ids[i] = static_cast<int64_t>(chunk.begin + i);
+        }
+        AM_RETURN_IF_ERROR(prefill.RunNextChunk(family_, bindings_));
+        token = io_->output_tokens[chunk.num_tokens - 1];
+    }
+    bindings_.mutable_sequence_state().generated_len = 1;
+    return token;
+}
+
+Status GenerationSession::RunStep(std::span<const int64_t> tokens, GenerationStats& stats) {
+    // A single token takes the cached decode plan without a family lookup.
+    const bool decode = tokens.size() == 1;
+    AM_RETURN_IF_ERROR(BindStep(decode ? ExecPhase::kDecode : ExecPhase::kPrefill, tokens.size(), stats));
+    RuntimeSequenceState& sequence = bindings_.mutable_sequence_state();
+    const size_t pos = sequence.current_pos;
+    AM_RETURN_IF_ERROR(bindings_.mutable_kv_cache_view().ReserveTokens(pos + tokens.size()));
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        io_->token_ids[i] = tokens[i];
+        io_->position_ids[i] = static_cast<int64_t>(pos + i);
+    }
+    sequence.step_tokens = tokens.size();
+    const Status status = decode ? Executor::Execute(*decode_plan_, bindings_)
+                                 : Executor::Execute(family_, tokens.size(), bindings_);
+    sequence.step_tokens = 0;
+    return status;
+}
+
+Status GenerationSession::Commit(size_t num_tokens) {
+    RuntimeSequenceState& sequence = bindings_.mutable_sequence_state();
+    AM_RETURN_IF_ERROR(bindings_.mutable_kv_cache_view().CommitUntil(sequence.current_pos + num_tokens));
+    sequence.current_pos += num_tokens;
+    sequence.generated_len += num_tokens;
+    return Status::Ok();
+}
+
+Status GenerationSession::Rollback(size_t pos) {
+    RuntimeSequenceState& sequence = bindings_.mutable_sequence_state();
+    AM_RETURN_IF_ERROR(bindings_.mutable_kv_cache_view().RollbackTo(pos));
+    sequence.generated_len -= sequence.current_pos - pos;
+    sequence.current_pos = pos;
+    return Status::Ok();
+}
+
+StatusOr<GenerationResult> GenerationSession::Run(std::span<const int64_t> prompt,
+                                                  const GenerationConfig& config,
+                                                  size_t chunk_tokens,
+                                                  const TokenCallback& on_token) {
+    const Clock::time_point start = Clock::now();
+    TokenSink sink(config, on_token);
+    sink.result.stats.prompt_tokens = prompt.size();
+
+    AM_ASSIGN_OR_RETURN(int64_t token, Prefill(prompt, chunk_tokens, sink.result.stats));
+    const Clock::time_point first_token = Clock::now();
+    bool running = sink.Emit(token);
+
+    // Steady state: the decode plan, KV view and step tensors stay bound;
+    // each step only rewrites the fed token and its position.
+    while (running) {
+        AM_RETURN_IF_ERROR(RunStep(std::span<const int64_t>(&token, 1), sink.result.stats));
+        AM_RETURN_IF_ERROR(Commit(1));
+        token = io_->output_tokens[0];
+        running = sink.Emit(token);
+    }
+    return sink.Finish(start, first_token);
+}
+
+StatusOr<GenerationResult> GenerationSession::RunSpeculative(GenerationSession& draft,
+                                                             std::span<const int64_t> prompt,
+                                                             const GenerationConfig& config,
+                                                             size_t chunk_tokens,
+                                                             size_t draft_chunk_tokens,
+                                                             size_t num_draft_tokens,
+                                                             const TokenCallback& on_token) {
+    const Clock::time_point start = Clock::now();
+    TokenSink sink(config, on_token);
+    GenerationStats& stats = sink.result.stats;
+    stats.prompt_tokens = prompt.size();
+
+    AM_ASSIGN_OR_RETURN(const int64_t first, Prefill(prompt, chunk_tokens, stats));
+    GenerationStats draft_stats;
+    AM_RETURN_IF_ERROR(draft.Prefill(prompt, draft_chunk_tokens, draft_stats).status());
+    const Clock::time_point first_token = Clock::now();
+
+    // Token at every position: the prompt, then each emitted token.
+    std::vector<int64_t> history(prompt.begin(), prompt.end());
+    history.reserve(prompt.size() + config.max_new_tokens);
+    history.push_back(first);
+    bool running = sink.Emit(first);
+
+    std::vector<int64_t> verify;
+    verify.reserve(num_draft_tokens + 1);
+    const RuntimeSequenceState& target_state = bindings_.sequence_state();
+    const RuntimeSequenceState& draft_state = draft.bindings_.sequence_state();
+    while (running) {
+        // history.back() sits at `pos` and is not yet in either KV cache.
+        const size_t pos = target_state.current_pos;
+        const size_t remaining = config.max_new_tokens - sink.result.tokens.size();
+        const size_t k = std::min(num_draft_tokens, remaining - 1);
+        verify.assign(1, history.back());
+
+        if (k != 0) {
+            // The draft lags by the last token of a fully accepted round.
+            while (draft_state.current_pos < pos) {
+                const size_t behind = std::min(pos - draft_state.current_pos, draft.family_.max_tokens());
+                AM_RETURN_IF_ERROR(draft.RunStep(
+                        std::span<const int64_t>(history).subspan(draft_state.current_pos, behind), draft_stats));
+                AM_RETURN_IF_ERROR(draft.Commit(behind));
+            }
+            for (size_t i = 0; i < k; ++i) {
+                AM_RETURN_IF_ERROR(draft.RunStep(std::span<const int64_t>(&verify.back(), 1), draft_stats));
+                AM_RETURN_IF_ERROR(draft.Commit(1));
+                verify.push_back(draft.io_->output_tokens[0]);
+            }
+        }
+
+        // One pass scores the last token and every draft: output i is the
+        // target's choice after input i.
+        AM_RETURN_IF_ERROR(RunStep(verify, stats));
+        const int64_t* predicted = io_->output_tokens.data();
+        size_t accepted = 0;
+        while (accepted < k && verify[accepted + 1] == predicted[accepted]) {
+            ++accepted;
+        }
+        AM_RETURN_IF_ERROR(Commit(accepted + 1));
+        if (draft_state.current_pos > pos + accepted + 1) {
+            AM_RETURN_IF_ERROR(draft.Rollback(pos + accepted + 1));
+        }
+        stats.draft_tokens += k;
+        stats.accepted_draft_tokens += accepted;
+
+        // Accepted drafts equal the target's choices, so predicted[0..accepted]
+        // is exactly what plain decoding would emit.
+        for (size_t i = 0; i <= accepted && running; ++i) {
+            history.push_back(predicted[i]);
+            running = sink.Emit(predicted[i]);
+        }
+    }
+    return sink.Finish(start, first_token);
+}
+
+const ExecutionPlanFamily& GenerationSession::family() const noexcept {
+    return family_;
+}
+
+const ExecutionPlan& GenerationSession::decode_plan() const noexcept {
+    return *decode_plan_;
+}
+
+const ActivationPlan& GenerationSession::activation_plan() const noexcept {
+    return activation_plan_;
+}
+
+}// namespace aethermind
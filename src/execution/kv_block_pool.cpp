@@ -0,0 +1,76 @@
+#include "aethermind/execution/kv_block_pool.h"
+#include "utils/logging.h"
+
+namespace aethermind {
+
+void KVBlockPool::Reset(size_t num_blocks) {
+    num_blocks_ = num_blocks;
+    next_ = std::make_unique<std::atomic<uint32_t>[]>(num_blocks);
+    refs_ = std::make_unique<std::atomic<uint32_t>[]>(num_blocks);
+    for (size_t i = 0; i < num_blocks; ++i) {
+        refs_[i].store(0, std::memory_order_relaxed);
+        const size_t next = i + 1;
+        next_[i].store(next < num_blocks ? static_cast<uint32_t>(next) : kInvalidBlock,
+                       std::memory_order_relaxed);
+    }
+    head_.store(Pack(num_blocks > 0 ? 0 : kInvalidBlock, 0), std::memory_order_release);
+    free_blocks_.store(num_blocks, std::memory_order_release);
+}
+
+uint32_t KVBlockPool::Allocate() noexcept {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+        const auto block = static_cast<uint32_t>(head);
+        if (block == kInvalidBlock) {
+            return kInvalidBlock;
+        }
+        const uint32_t next = next_[block].load(std::memory_order_relaxed);
+        const auto tag = static_cast<uint32_t>(head >> 32);
+        if (head_.compare_exchange_weak(head, Pack(next, tag + 1),
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            free_blocks_.fetch_sub(1, std::memory_order_relaxed);
+            refs_[block].store(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+}
+
+void KVBlockPool::Retain(uint32_t block) noexcept {
+    AM_DCHECK(block < num_blocks_);
+    AM_DCHECK(refs_[block].load(std::memory_order_relaxed) > 0);
+    refs_[block].fetch_add(1, std::memory_order_relaxed);
+}
+
+void KVBlockPool::Release(uint32_t block) noexcept {
+    AM_DCHECK(block < num_blocks_);
+    if (refs_[block].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+        next_[block].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        const auto tag = static_cast<uint32_t>(head >> 32);
+        if (head_.compare_exchange_weak(head, Pack(block, tag + 1),
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            free_blocks_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+uint32_t KVBlockPool::ref_count(uint32_t block) const noexcept {
+    return block < num_blocks_ ? refs_[block].load(std::memory_order_acquire) : 0;
+}
+
+size_t KVBlockPool::num_blocks() const noexcept {
+    return num_blocks_;
+}
+
+size_t KVBlockPool::free_blocks() const noexcept {
+    return free_blocks_.load(std::memory_order_relaxed);
+}
+
+}// namespace aethermind
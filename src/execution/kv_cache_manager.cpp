@@ -1,8 +1,12 @@
 #include "aethermind/execution/kv_cache_manager.h"
+#include "aethermind/execution/kv_quantization.h"
 
 #include "aethermind/runtime/workspace.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <string>
+#include <vector>
 
 namespace aethermind {
 namespace {
@@ -39,10 +43,82 @@ Status KVCacheManager::AllocateStorage(size_t bytes_per_plane, size_t alignment)
         return value_buffer.status();
     }
 
-    storage_.key_buffer = key_buffer.value();
-    storage_.value_buffer = value_buffer.value();
-    storage_.kv_dtype = layout_.kv_dtype;
-    storage_.alignment = alignment;
+    pool_->storage.key_buffer = key_buffer.value();
+    pool_->storage.value_buffer = value_buffer.value();
+    pool_->storage.kv_dtype = pool_->layout.kv_dtype;
+    pool_->storage.alignment = alignment;
+    return Status::Ok();
+}
+
+Status KVCacheManager::AllocateScales(size_t num_walk_blocks) {
+    size_t entries = 0;
+    if (CheckOverflowMul(num_walk_blocks, pool_->layout.WalkBlockScaleEntries(), &entries)) {
+        return Status::Overflow("KV scale count overflowed size_t");
+    }
+    pool_->storage.key_scales.assign(entries, 0.0F);
+    pool_->storage.value_scales.assign(entries, 0.0F);
+    size_t scale_bytes = 0;
+    if (CheckOverflowMul(entries, 2 * sizeof(float), &scale_bytes) ||
+        CheckOverflowAdd(pool_->total_bytes, scale_bytes, &pool_->total_bytes)) {
+        return Status::Overflow("KV total bytes overflowed size_t");
+    }
+    return Status::Ok();
+}
+
+Status KVCacheManager::InitLayout(size_t num_layers,
+                                  size_t num_kv_heads,
+                                  size_t max_tokens,
+                                  size_t head_dim,
+                                  DataType kv_dtype,
+                                  size_t alignment,
+                                  size_t num_slots) {
+    pool_.reset();
+    if (num_slots == 0) {
+        return Status::InvalidArgument("KVCacheManager requires at least one session slot");
+    }
+    pool_ = std::make_unique<SlotPool>(num_slots);
+
+    pool_->layout.num_layers = num_layers;
+    pool_->layout.num_kv_heads = num_kv_heads;
+    pool_->layout.max_tokens = max_tokens;
+    pool_->layout.head_dim = head_dim;
+    pool_->layout.head_dim_stride = head_dim;
+    pool_->layout.kv_dtype = kv_dtype;
+    pool_->layout.alignment = alignment;
+
+    const size_t element_bytes = pool_->layout.ElementBytes();
+    if (element_bytes == 0) {
+        return Status::InvalidArgument("KV dtype must have non-zero element bytes");
+    }
+    if (!IsSupportedKVStorageDType(kv_dtype)) {
+        return Status::InvalidArgument(
+                "KV dtype must be float32, float16, bfloat16, int8, float8_e4m3fn or float8_e5m2");
+    }
+    if (CheckOverflowMul(pool_->layout.head_dim_stride, element_bytes, &pool_->layout.token_stride)) {
+        return Status::Overflow("KV layout stride computation overflowed size_t");
+    }
+    return Status::Ok();
+}
+
+Status KVCacheManager::InitStrides(size_t region_tokens, KVLayoutOrder order) {
+    if (order == KVLayoutOrder::kAny) {
+        return Status::InvalidArgument("KV layout order must be head-major or token-major");
+    }
+    pool_->layout.order = order;
+    // InitLayout leaves one token row of one head in token_stride.
+    const size_t row_bytes = pool_->layout.token_stride;
+    bool overflow = false;
+    if (order == KVLayoutOrder::kHeadMajor) {
+        overflow = CheckOverflowMul(region_tokens, row_bytes, &pool_->layout.head_stride) ||
+                   CheckOverflowMul(pool_->layout.num_kv_heads, pool_->layout.head_stride, &pool_->layout.layer_stride);
+    } else {
+        pool_->layout.head_stride = row_bytes;
+        overflow = CheckOverflowMul(pool_->layout.num_kv_heads, row_bytes, &pool_->layout.token_stride) ||
+                   CheckOverflowMul(region_tokens, pool_->layout.token_stride, &pool_->layout.layer_stride);
+    }
+    if (overflow) {
+        return Status::Overflow("KV layout stride computation overflowed size_t");
+    }
     return Status::Ok();
 }
 
@@ -51,58 +127,253 @@ Status KVCacheManager::Init(size_t num_layers,
                             size_t max_tokens,
                             size_t head_dim,
                             DataType kv_dtype,
-                            size_t alignment) {
-    layout_ = {};
-    storage_ = {};
-    slot_ = {};
-    total_bytes_ = 0;
-    initialized_ = false;
-
-    layout_.num_layers = num_layers;
-    layout_.num_kv_heads = num_kv_heads;
-    layout_.max_tokens = max_tokens;
-    layout_.head_dim = head_dim;
-    layout_.head_dim_stride = head_dim;
-    layout_.kv_dtype = kv_dtype;
-    layout_.alignment = alignment;
-
-    const size_t element_bytes = layout_.ElementBytes();
-    if (element_bytes == 0) {
-        return Status::InvalidArgument("KV dtype must have non-zero element bytes");
-    }
+                            size_t alignment,
+                            size_t num_slots,
+                            KVLayoutOrder order) {
+    return InitDense(num_layers, num_kv_heads, max_tokens, head_dim, kv_dtype, alignment, num_slots,
+                     false, order);
+}
 
-    if (CheckOverflowMul(layout_.head_dim_stride, element_bytes, &layout_.token_stride) ||
-        CheckOverflowMul(layout_.max_tokens, layout_.token_stride, &layout_.head_stride) ||
-        CheckOverflowMul(layout_.num_kv_heads, layout_.head_stride, &layout_.layer_stride)) {
-        return Status::Overflow("KV layout stride computation overflowed size_t");
+Status KVCacheManager::InitSlidingWindow(size_t num_layers,
+                                         size_t num_kv_heads,
+                                         size_t window_tokens,
+                                         size_t head_dim,
+                                         DataType kv_dtype,
+                                         size_t alignment,
+                                         size_t num_slots,
+                                         KVLayoutOrder order) {
+    return InitDense(num_layers, num_kv_heads, window_tokens, head_dim, kv_dtype, alignment, num_slots,
+                     true, order);
+}
+
+Status KVCacheManager::InitDense(size_t num_layers,
+                                 size_t num_kv_heads,
+                                 size_t max_tokens,
+                                 size_t head_dim,
+                                 DataType kv_dtype,
+                                 size_t alignment,
+                                 size_t num_slots,
+                                 bool sliding_window,
+                                 KVLayoutOrder order) {
+    AM_RETURN_IF_ERROR(InitLayout(num_layers, num_kv_heads, max_tokens, head_dim, kv_dtype,
+                                  alignment, num_slots));
+    pool_->layout.sliding_window = sliding_window;
+
+    AM_RETURN_IF_ERROR(InitStrides(pool_->layout.max_tokens, order));
+    if (IsScaledKVStorageDType(kv_dtype)) {
+        pool_->layout.walk_block_tokens = std::min(max_tokens, kKVDenseWalkBlockTokens);
+        // A ring must wrap on a walk-block boundary.
+        while (sliding_window && pool_->layout.walk_block_tokens > 1 &&
+               max_tokens % pool_->layout.walk_block_tokens != 0) {
+            --pool_->layout.walk_block_tokens;
+        }
     }
 
-    AM_RETURN_IF_ERROR(layout_.Validate());
+    AM_RETURN_IF_ERROR(pool_->layout.Validate());
 
-    const StatusOr<size_t> bytes_per_plane = layout_.BytesPerPlane();
+    const StatusOr<size_t> bytes_per_plane = pool_->layout.BytesPerPlane();
     if (!bytes_per_plane.ok()) {
         return bytes_per_plane.status();
     }
 
+    // Each slot starts on an aligned boundary of the shared plane.
+    AM_ASSIGN_OR_RETURN(const size_t slot_stride,
+                        AlignWorkspaceOffset(bytes_per_plane.value(), alignment));
+    size_t plane_bytes = 0;
     size_t total_bytes = 0;
-    if (CheckOverflowMul(bytes_per_plane.value(), size_t{2}, &total_bytes)) {
+    if (CheckOverflowMul(slot_stride, num_slots, &plane_bytes) ||
+        CheckOverflowMul(plane_bytes, size_t{2}, &total_bytes)) {
         return Status::Overflow("KV total bytes overflowed size_t");
     }
 
-    AM_RETURN_IF_ERROR(AllocateStorage(bytes_per_plane.value(), alignment));
+    AM_RETURN_IF_ERROR(AllocateStorage(plane_bytes, alignment));
+
+    if (pool_->layout.scaled()) {
+        const size_t walk_blocks_per_slot =
+                (max_tokens + pool_->layout.walk_block_tokens - 1) / pool_->layout.walk_block_tokens;
+        AM_RETURN_IF_ERROR(AllocateScales(num_slots * walk_blocks_per_slot));
+    }
+
+    for (size_t i = 0; i < num_slots; ++i) {
+        pool_->slots[i].slot_index = i;
+        pool_->slots[i].base_offset = i * slot_stride;
+    }
 
-    total_bytes_ = total_bytes;
-    initialized_ = true;
+    pool_->total_bytes += total_bytes;
+    pool_->initialized = true;
+    return Status::Ok();
+}
+
+Status KVCacheManager::InitPaged(size_t num_layers,
+                                 size_t num_kv_heads,
+                                 size_t max_tokens,
+                                 size_t head_dim,
+                                 DataType kv_dtype,
+                                 size_t block_tokens,
+                                 size_t num_blocks,
+                                 size_t alignment,
+                                 size_t num_slots,
+                                 KVLayoutOrder order) {
+    AM_RETURN_IF_ERROR(InitLayout(num_layers, num_kv_heads, max_tokens, head_dim, kv_dtype,
+                                  alignment, num_slots));
+
+    if (block_tokens == 0 || num_blocks == 0) {
+        return Status::InvalidArgument("Paged KV cache requires non-zero block_tokens and num_blocks");
+    }
+    if (num_blocks >= KVBlockPool::kInvalidBlock) {
+        return Status::OutOfRange("Paged KV cache num_blocks exceeds the block id range");
+    }
+
+    pool_->layout.block_tokens = block_tokens;
+    pool_->layout.num_blocks = num_blocks;
+    if (IsScaledKVStorageDType(kv_dtype)) {
+        pool_->layout.walk_block_tokens = block_tokens;
+    }
+    AM_RETURN_IF_ERROR(InitStrides(block_tokens, order));
+    size_t block_bytes = 0;
+    if (CheckOverflowMul(pool_->layout.num_layers, pool_->layout.layer_stride, &block_bytes)) {
+        return Status::Overflow("KV layout stride computation overflowed size_t");
+    }
+    // Every block starts on an aligned boundary so block pointers handed to
+    // kernels keep the plane alignment.
+    AM_ASSIGN_OR_RETURN(pool_->layout.block_stride, AlignWorkspaceOffset(block_bytes, alignment));
+
+    AM_RETURN_IF_ERROR(pool_->layout.Validate());
+    AM_ASSIGN_OR_RETURN(const size_t plane_bytes, pool_->layout.BytesPerPlane());
+    size_t total_bytes = 0;
+    if (CheckOverflowMul(plane_bytes, size_t{2}, &total_bytes)) {
+        return Status::Overflow("KV total bytes overflowed size_t");
+    }
+
+    AM_RETURN_IF_ERROR(AllocateStorage(plane_bytes, alignment));
+    if (pool_->layout.scaled()) {
+        AM_RETURN_IF_ERROR(AllocateScales(num_blocks));
+    }
+
+    pool_->blocks.Reset(num_blocks);
+    pool_->prefix_cache = std::make_unique<KVPrefixCache>(&pool_->blocks, block_tokens);
+    pool_->storage.block_pool = &pool_->blocks;
+    pool_->storage.prefix_cache = pool_->prefix_cache.get();
+    const size_t table_size = (max_tokens + block_tokens - 1) / block_tokens;
+    for (size_t i = 0; i < num_slots; ++i) {
+        pool_->slots[i].slot_index = i;
+        pool_->slots[i].block_table.assign(table_size, KVBlockPool::kInvalidBlock);
+    }
+
+    pool_->total_bytes += total_bytes;
+    pool_->initialized = true;
     return Status::Ok();
 }
 
 StatusOr<KVCacheView> KVCacheManager::ReserveForSession(size_t prompt_len,
                                                         size_t max_new_tokens) noexcept {
-    if (!initialized_) {
+    return ReserveSlot(prompt_len, max_new_tokens, prompt_len);
+}
+
+StatusOr<KVCacheView> KVCacheManager::ReserveForChunkedPrefill(size_t prompt_len,
+                                                               size_t max_new_tokens) noexcept {
+    return ReserveSlot(prompt_len, max_new_tokens, 0);
+}
+
+StatusOr<KVCacheView> KVCacheManager::ReserveWithPrefix(std::span<const int32_t> prompt_tokens,
+                                                        size_t max_new_tokens) {
+    AM_ASSIGN_OR_RETURN(KVCacheView view,
+                        ReserveSlot(prompt_tokens.size(), max_new_tokens, 0));
+    if (!pool_->layout.paged() || prompt_tokens.empty()) {
+        return view;
+    }
+
+    const std::vector<uint32_t> blocks = pool_->prefix_cache->Acquire(prompt_tokens);
+    SessionKVSlot& slot = *view.slot_;
+    std::ranges::copy(blocks, slot.block_table.begin());
+    slot.current_pos = std::min(blocks.size() * pool_->layout.block_tokens, prompt_tokens.size() - 1);
+    return view;
+}
+
+Status KVCacheManager::PublishPrefix(const KVCacheView& view,
+                                     std::span<const int32_t> prompt_tokens) {
+    AM_RETURN_IF_ERROR(ValidateOwnedView(view, "publish"));
+    if (!pool_->layout.paged()) {
+        return Status::Ok();
+    }
+
+    const SessionKVSlot& slot = *view.slot_;
+    const size_t num_tokens = std::min(prompt_tokens.size(), slot.current_pos);
+    const size_t num_blocks = num_tokens / pool_->layout.block_tokens;
+    pool_->prefix_cache->Insert(prompt_tokens.first(num_blocks * pool_->layout.block_tokens),
+                                std::span<const uint32_t>(slot.block_table).first(num_blocks));
+    return Status::Ok();
+}
+
+Status KVCacheManager::SaveSession(const KVCacheView& view,
+                                  const RuntimeSequenceState& state,
+                                  const std::filesystem::path& path,
+                                  const KVSnapshotOptions& options) const {
+    AM_RETURN_IF_ERROR(ValidateOwnedView(view, "save"));
+    return SaveKVSnapshot(view, state, path, options);
+}
+
+StatusOr<KVCacheView> KVCacheManager::RestoreSession(const std::filesystem::path& path,
+                                                     size_t max_new_tokens,
+                                                     RuntimeSequenceState* state) {
+    if (!is_initialized()) {
         return Status::FailedPrecondition("KVCacheManager is not initialized");
     }
-    if (slot_.in_use) {
-        return Status::FailedPrecondition("KVCacheManager already has an active session reservation");
+    AM_ASSIGN_OR_RETURN(const KVSnapshot snapshot, KVSnapshot::Open(path));
+    const KVSnapshotHeader& header = snapshot.header();
+    if (header.num_layers != pool_->layout.num_layers || header.num_kv_heads != pool_->layout.num_kv_heads ||
+        header.head_dim != pool_->layout.head_dim) {
+        return Status::InvalidArgument("KV snapshot shape does not match the cache layout");
+    }
+    if (header.window_begin != 0 && !pool_->layout.sliding_window) {
+        return Status::FailedPrecondition("KV snapshot of a wrapped sliding window needs a sliding-window cache");
+    }
+
+    const size_t committed = header.committed_tokens;
+    const size_t prompt_len = header.prompt_len;
+    size_t remaining_tokens = 0;
+    if (CheckOverflowAdd(std::max(committed, prompt_len) - prompt_len, max_new_tokens, &remaining_tokens)) {
+        return Status::Overflow("KV session reservation overflowed size_t");
+    }
+    AM_ASSIGN_OR_RETURN(KVCacheView view, ReserveSlot(prompt_len, remaining_tokens, 0));
+
+    // A smaller ring than the saved window keeps only the newest rows.
+    size_t first = header.window_begin;
+    if (pool_->layout.sliding_window && committed > pool_->layout.max_tokens) {
+        first = std::max(first, committed - pool_->layout.max_tokens);
+    }
+    std::vector<float> key(pool_->layout.head_dim);
+    std::vector<float> value(pool_->layout.head_dim);
+    Status restored = view.ReserveTokens(committed);
+    for (size_t layer = 0; restored.ok() && layer < pool_->layout.num_layers; ++layer) {
+        for (size_t head = 0; restored.ok() && head < pool_->layout.num_kv_heads; ++head) {
+            for (size_t pos = first; restored.ok() && pos < committed; ++pos) {
+                restored = snapshot.ReadToken(layer, head, pos, key, value);
+                if (restored.ok()) {
+                    restored = view.WriteToken(layer, head, pos, key, value);
+                }
+            }
+        }
+    }
+    if (restored.ok()) {
+        restored = view.CommitUntil(committed);
+    }
+    if (!restored.ok()) {
+        (void) ReleaseSession(view);
+        return restored;
+    }
+
+    if (state != nullptr) {
+        *state = snapshot.sequence_state();
+    }
+    return view;
+}
+
+StatusOr<KVCacheView> KVCacheManager::ReserveSlot(size_t prompt_len,
+                                                  size_t max_new_tokens,
+                                                  size_t committed_tokens) noexcept {
+    if (!is_initialized()) {
+        return Status::FailedPrecondition("KVCacheManager is not initialized");
     }
 
     size_t requested_tokens = 0;
@@ -112,51 +383,314 @@ StatusOr<KVCacheView> KVCacheManager::ReserveForSession(size_t prompt_len,
     if (requested_tokens == 0) {
         return Status::InvalidArgument("KV session reservation must request at least one token");
     }
-    if (requested_tokens > layout_.max_tokens) {
+    if (requested_tokens > pool_->layout.max_tokens && !pool_->layout.sliding_window) {
         return Status::OutOfRange("KV session reservation exceeds physical KV capacity");
     }
 
-    ++slot_.generation;
-    slot_.in_use = true;
-    slot_.capacity_tokens = requested_tokens;
-    slot_.prompt_len = prompt_len;
-    slot_.current_pos = prompt_len;
+    const size_t num_slots = pool_->slots.size();
+    const size_t first = pool_->next_probe.fetch_add(1, std::memory_order_relaxed) % num_slots;
+    for (size_t probe = 0; probe < num_slots; ++probe) {
+        SessionKVSlot& slot = pool_->slots[(first + probe) % num_slots];
+        bool expected = false;
+        if (!slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        slot.capacity_tokens = requested_tokens;
+        slot.prompt_len = prompt_len;
+        slot.current_pos = committed_tokens;
+        slot.generation.fetch_add(1, std::memory_order_acq_rel);
+        if (pool_->layout.scaled() && !pool_->layout.paged()) {
+            // Dense slots keep their row scales; a new session starts unscaled.
+            const size_t slot_entries = pool_->storage.key_scales.size() / pool_->slots.size();
+            for (std::vector<float>* scales: {&pool_->storage.key_scales, &pool_->storage.value_scales}) {
+                std::fill_n(scales->begin() + slot.slot_index * slot_entries, slot_entries, 0.0F);
+            }
+        }
+
+        KVCacheView view(&pool_->layout, &pool_->storage, &slot);
+        if (const Status mapped = view.MapBlocks(committed_tokens); !mapped.ok()) {
+            UnmapBlocks(slot, 0);
+            slot.capacity_tokens = 0;
+            slot.prompt_len = 0;
+            slot.current_pos = 0;
+            slot.generation.fetch_add(1, std::memory_order_acq_rel);
+            slot.in_use.store(false, std::memory_order_release);
+            return mapped;
+        }
 
-    return KVCacheView(&layout_, &storage_, &slot_);
+        const size_t active = pool_->active.fetch_add(1, std::memory_order_relaxed) + 1;
+        size_t peak = pool_->peak_active.load(std::memory_order_relaxed);
+        while (peak < active &&
+               !pool_->peak_active.compare_exchange_weak(peak, active, std::memory_order_relaxed)) {
+        }
+        pool_->reserved_tokens.fetch_add(requested_tokens, std::memory_order_relaxed);
+        return view;
+    }
+
+    if (num_slots == 1) {
+        return Status::FailedPrecondition("KVCacheManager already has an active session reservation");
+    }
+    return Status::ResourceExhausted("KVCacheManager has no free session slot");
 }
 
-Status KVCacheManager::ResetSession(KVCacheView& view) noexcept {
-    if (!initialized_) {
+Status KVCacheManager::ValidateOwnedView(const KVCacheView& view, const char* action) const noexcept {
+    if (!is_initialized()) {
         return Status::FailedPrecondition("KVCacheManager is not initialized");
     }
     if (!view.valid()) {
-        return Status::FailedPrecondition("Cannot reset an invalid or stale KVCacheView");
+        return Status::FailedPrecondition(std::string("Cannot ") + action +
+                                          " an invalid or stale KVCacheView");
     }
+    if (view.storage_ != &pool_->storage || view.slot_index() >= pool_->slots.size() ||
+        view.slot_ != &pool_->slots[view.slot_index()]) {
+        return Status::InvalidArgument(std::string("Cannot ") + action +
+                                       " a KVCacheView owned by another manager");
+    }
+    return Status::Ok();
+}
 
-    slot_.current_pos = slot_.prompt_len;
+Status KVCacheManager::ResetSession(KVCacheView& view) noexcept {
+    AM_RETURN_IF_ERROR(ValidateOwnedView(view, "reset"));
+    if (pool_->layout.sliding_window &&
+        view.slot_->current_pos > std::max(pool_->layout.max_tokens, view.slot_->prompt_len)) {
+        return Status::FailedPrecondition("Sliding-window KV session has overwritten its prompt");
+    }
+    view.slot_->current_pos = view.slot_->prompt_len;
+    UnmapBlocks(*view.slot_, view.slot_->prompt_len);
     return Status::Ok();
 }
 
-Status KVCacheManager::ReleaseSession(KVCacheView& view) noexcept {
-    if (!initialized_) {
+void KVCacheManager::UnmapBlocks(SessionKVSlot& slot, size_t keep_tokens) noexcept {
+    if (!pool_->layout.paged()) {
+        return;
+    }
+    const size_t keep_blocks = (keep_tokens + pool_->layout.block_tokens - 1) / pool_->layout.block_tokens;
+    for (size_t b = keep_blocks; b < slot.block_table.size(); ++b) {
+        if (slot.block_table[b] != KVBlockPool::kInvalidBlock) {
+            pool_->blocks.Release(slot.block_table[b]);
+            slot.block_table[b] = KVBlockPool::kInvalidBlock;
+        }
+    }
+    for (size_t b = keep_blocks; b < slot.spill_table.size(); ++b) {
+        if (slot.spill_table[b] != KVSpillFile::kInvalidRecord) {
+            pool_->spill_file->Free(slot.spill_table[b]);
+            slot.spill_table[b] = KVSpillFile::kInvalidRecord;
+            --slot.offloaded_blocks;
+        }
+    }
+}
+
+Status KVCacheManager::EnableDiskOffload(const std::filesystem::path& path) {
+    if (!is_initialized()) {
         return Status::FailedPrecondition("KVCacheManager is not initialized");
     }
-    if (!view.valid()) {
-        return Status::FailedPrecondition("Cannot release an invalid or stale KVCacheView");
+    if (!pool_->layout.paged()) {
+        return Status::FailedPrecondition("KV disk offload requires a paged KV cache");
+    }
+    if (pool_->spill_file != nullptr) {
+        return Status::FailedPrecondition("KV disk offload is already enabled");
+    }
+    // The spill tables below are written without synchronization, so no
+    // session may hold a slot yet.
+    if (active_sessions() != 0) {
+        return Status::FailedPrecondition("KV disk offload must be enabled before any session is reserved");
+    }
+
+    size_t record_bytes = 2 * pool_->SpillBlockBytes();
+    if (pool_->layout.scaled()) {
+        record_bytes += 2 * pool_->layout.WalkBlockScaleEntries() * sizeof(float);
     }
+    // Every spilled block is named by one spill-table entry, which bounds the
+    // records the file can ever hold at once.
+    size_t max_records = 0;
+    for (const SessionKVSlot& slot: pool_->slots) {
+        max_records += slot.block_table.size();
+    }
+    if (max_records >= KVSpillFile::kInvalidRecord) {
+        return Status::Overflow("KV block tables exceed the spill file record range");
+    }
+    AM_ASSIGN_OR_RETURN(pool_->spill_file,
+                        KVSpillFile::Create(path, record_bytes, static_cast<uint32_t>(max_records)));
+    for (SessionKVSlot& slot: pool_->slots) {
+        slot.spill_table.assign(slot.block_table.size(), KVSpillFile::kInvalidRecord);
+    }
+    return Status::Ok();
+}
 
-    slot_.in_use = false;
-    slot_.capacity_tokens = 0;
-    slot_.prompt_len = 0;
-    slot_.current_pos = 0;
-    ++slot_.generation;
+size_t KVCacheManager::SlotPool::SpillBlockBytes() const noexcept {
+    // The aligned tail of block_stride holds no data and is not spilled.
+    return layout.num_layers * layout.layer_stride;
+}
+
+std::vector<std::span<std::byte>> KVCacheManager::SlotPool::BlockRegions(uint32_t block) noexcept {
+    const size_t block_offset = block * layout.block_stride;
+    std::vector<std::span<std::byte>> regions;
+    for (Buffer* plane: {&storage.key_buffer, &storage.value_buffer}) {
+        regions.emplace_back(static_cast<std::byte*>(plane->mutable_data()) + block_offset, SpillBlockBytes());
+    }
+    if (layout.scaled()) {
+        const size_t block_entries = layout.WalkBlockScaleEntries();
+        for (std::vector<float>* scales: {&storage.key_scales, &storage.value_scales}) {
+            regions.push_back(std::as_writable_bytes(
+                    std::span<float>(*scales).subspan(block * block_entries, block_entries)));
+        }
+    }
+    return regions;
+}
+
+StatusOr<size_t> KVCacheManager::OffloadSession(KVCacheView& view) {
+    AM_RETURN_IF_ERROR(ValidateOwnedView(view, "offload"));
+    if (pool_->spill_file == nullptr) {
+        return Status::FailedPrecondition("KV disk offload is not enabled");
+    }
+
+    SessionKVSlot& slot = *view.slot_;
+    size_t offloaded = 0;
+    for (size_t b = 0; b < slot.block_table.size(); ++b) {
+        const uint32_t block = slot.block_table[b];
+        // Shared blocks would stay allocated by their other holders.
+        if (block == KVBlockPool::kInvalidBlock || pool_->blocks.ref_count(block) != 1) {
+            continue;
+        }
+        const std::vector<std::span<std::byte>> regions = pool_->BlockRegions(block);
+        const std::vector<std::span<const std::byte>> parts(regions.begin(), regions.end());
+        AM_ASSIGN_OR_RETURN(slot.spill_table[b], pool_->spill_file->Write(parts));
+        pool_->blocks.Release(block);
+        slot.block_table[b] = KVBlockPool::kInvalidBlock;
+        ++slot.offloaded_blocks;
+        ++offloaded;
+    }
+    return offloaded;
+}
+
+size_t KVCacheManager::SharedBlocks(const KVCacheView& view) const noexcept {
+    if (!ValidateOwnedView(view, "inspect").ok()) {
+        return 0;
+    }
+    return static_cast<size_t>(std::ranges::count_if(view.slot_->block_table, [&](uint32_t block) {
+        return block != KVBlockPool::kInvalidBlock && pool_->blocks.ref_count(block) != 1;
+    }));
+}
+
+std::future<Status> KVCacheManager::PrefetchSession(KVCacheView& view) {
+    Status status = ValidateOwnedView(view, "prefetch");
+    if (status.ok() && pool_->spill_file == nullptr) {
+        status = Status::FailedPrecondition("KV disk offload is not enabled");
+    }
+    if (!status.ok() || view.slot_->offloaded_blocks == 0) {
+        std::promise<Status> done;
+        done.set_value(std::move(status));
+        return done.get_future();
+    }
+    // Captures the heap pool, not the manager, so moving the manager is safe.
+    return std::async(std::launch::async, [pool = pool_.get(), slot = view.slot_] {
+        return pool->LoadOffloadedBlocks(*slot);
+    });
+}
+
+Status KVCacheManager::SlotPool::LoadOffloadedBlocks(SessionKVSlot& slot) {
+    KVCacheView loader(&layout, &storage, &slot);
+    for (size_t b = 0; b < slot.spill_table.size(); ++b) {
+        const uint32_t record = slot.spill_table[b];
+        if (record == KVSpillFile::kInvalidRecord) {
+            continue;
+        }
+        AM_ASSIGN_OR_RETURN(const uint32_t block, loader.AllocateBlock());
+        if (const Status read = spill_file->Read(record, BlockRegions(block)); !read.ok()) {
+            blocks.Release(block);
+            return read;
+        }
+        spill_file->Free(record);
+        slot.spill_table[b] = KVSpillFile::kInvalidRecord;
+        slot.block_table[b] = block;
+        --slot.offloaded_blocks;
+    }
+    return Status::Ok();
+}
+
+Status KVCacheManager::ReleaseSession(KVCacheView& view) noexcept {
+    AM_RETURN_IF_ERROR(ValidateOwnedView(view, "release"));
+
+    SessionKVSlot& slot = *view.slot_;
+    pool_->reserved_tokens.fetch_sub(slot.capacity_tokens, std::memory_order_relaxed);
+    pool_->active.fetch_sub(1, std::memory_order_relaxed);
+    UnmapBlocks(slot, 0);
+    slot.capacity_tokens = 0;
+    slot.prompt_len = 0;
+    slot.current_pos = 0;
+    // Bump the generation before publishing the slot as free so that no stale
+    // view can match the next session's generation.
+    slot.generation.fetch_add(1, std::memory_order_acq_rel);
+    slot.in_use.store(false, std::memory_order_release);
     view.Invalidate();
     return Status::Ok();
 }
 
-const KVCacheLayout& KVCacheManager::layout() const noexcept { return layout_; }
-size_t KVCacheManager::capacity_tokens() const noexcept { return layout_.max_tokens; }
-size_t KVCacheManager::total_bytes() const noexcept { return total_bytes_; }
-bool KVCacheManager::is_initialized() const noexcept { return initialized_; }
+StatusOr<size_t> KVCacheManager::ProjectedBlocks(size_t prompt_len,
+                                                 size_t max_new_tokens) const noexcept {
+    if (!is_initialized()) {
+        return Status::FailedPrecondition("KVCacheManager is not initialized");
+    }
+    size_t requested_tokens = 0;
+    if (CheckOverflowAdd(prompt_len, max_new_tokens, &requested_tokens)) {
+        return Status::Overflow("KV session reservation overflowed size_t");
+    }
+    if (requested_tokens == 0) {
+        return Status::InvalidArgument("KV session reservation must request at least one token");
+    }
+    if (requested_tokens > pool_->layout.max_tokens && !pool_->layout.sliding_window) {
+        return Status::OutOfRange("KV session reservation exceeds physical KV capacity");
+    }
+    if (!pool_->layout.paged()) {
+        return size_t{1};
+    }
+    return (requested_tokens + pool_->layout.block_tokens - 1) / pool_->layout.block_tokens;
+}
+
+size_t KVCacheManager::BlockBudget() const noexcept {
+    if (!is_initialized()) {
+        return 0;
+    }
+    return pool_->layout.paged() ? pool_->blocks.num_blocks() : pool_->slots.size();
+}
+
+bool KVCacheManager::disk_offload_enabled() const noexcept {
+    return is_initialized() && pool_->spill_file != nullptr;
+}
+
+const KVCacheLayout& KVCacheManager::layout() const noexcept {
+    static const KVCacheLayout kEmptyLayout{};
+    return pool_ != nullptr ? pool_->layout : kEmptyLayout;
+}
+size_t KVCacheManager::capacity_tokens() const noexcept { return layout().max_tokens; }
+size_t KVCacheManager::num_slots() const noexcept { return is_initialized() ? pool_->slots.size() : 0; }
+size_t KVCacheManager::total_bytes() const noexcept { return is_initialized() ? pool_->total_bytes : 0; }
+bool KVCacheManager::is_initialized() const noexcept { return pool_ != nullptr && pool_->initialized; }
+
+size_t KVCacheManager::active_sessions() const noexcept {
+    return is_initialized() ? pool_->active.load(std::memory_order_relaxed) : 0;
+}
+
+KVPrefixCache* KVCacheManager::prefix_cache() const noexcept {
+    return is_initialized() ? pool_->prefix_cache.get() : nullptr;
+}
+
+KVCacheOccupancy KVCacheManager::Occupancy() const noexcept {
+    if (!is_initialized()) {
+        return {};
+    }
+    return KVCacheOccupancy{
+            .num_slots = pool_->slots.size(),
+            .active_slots = pool_->active.load(std::memory_order_relaxed),
+            .peak_active_slots = pool_->peak_active.load(std::memory_order_relaxed),
+            .reserved_tokens = pool_->reserved_tokens.load(std::memory_order_relaxed),
+            .capacity_tokens = pool_->slots.size() * pool_->layout.max_tokens,
+            .total_blocks = pool_->blocks.num_blocks(),
+            .free_blocks = pool_->blocks.free_blocks(),
+            .cached_blocks = pool_->prefix_cache != nullptr ? pool_->prefix_cache->num_cached_blocks() : 0,
+            .offloaded_blocks = pool_->spill_file != nullptr ? pool_->spill_file->num_records() : 0,
+    };
+}
 
 }// namespace aethermind
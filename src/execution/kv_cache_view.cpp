@@ -1,6 +1,14 @@
 #include "aethermind/execution/kv_cache_view.h"
+#include "aethermind/execution/kv_prefix_cache.h"
+#include "aethermind/execution/kv_quantization.h"
 #include "aethermind/runtime/workspace.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
 namespace aethermind {
 namespace {
 
@@ -31,10 +39,27 @@ Status KVCacheLayout::Validate() const noexcept {
         return Status::InvalidArgument("KV layout dtype must be initialized");
     }
 
+    if (order == KVLayoutOrder::kAny) {
+        return Status::InvalidArgument("KV layout order must be head-major or token-major");
+    }
+
     if (head_dim_stride < head_dim) {
         return Status::InvalidArgument("KV head_dim_stride must be >= head_dim");
     }
 
+    if (paged() && (num_blocks == 0 || block_stride < num_layers * layer_stride)) {
+        return Status::InvalidArgument("Paged KV layout requires blocks covering every layer");
+    }
+
+    if (sliding_window && (paged() || (scaled() && max_tokens % walk_block_tokens != 0))) {
+        return Status::InvalidArgument("Sliding-window KV layout must be dense with whole walk blocks");
+    }
+
+    if (scaled() != IsScaledKVStorageDType(kv_dtype) ||
+        (paged() && scaled() && walk_block_tokens != block_tokens)) {
+        return Status::InvalidArgument("KV walk blocks must match the storage dtype and block size");
+    }
+
     return Status::Ok();
 }
 
@@ -45,7 +70,7 @@ StatusOr<size_t> KVCacheLayout::Offset(size_t layer_idx,
     AM_RETURN_IF_ERROR(Validate());
     AM_RETURN_IF_ERROR(ValidateIndexRange(layer_idx, num_layers, "layer"));
     AM_RETURN_IF_ERROR(ValidateIndexRange(kv_head_idx, num_kv_heads, "kv_head"));
-    AM_RETURN_IF_ERROR(ValidateIndexRange(seq_pos, max_tokens, "seq_pos"));
+    AM_RETURN_IF_ERROR(ValidateIndexRange(seq_pos, paged() ? block_tokens : max_tokens, "seq_pos"));
     AM_RETURN_IF_ERROR(ValidateIndexRange(dim_idx, head_dim, "dim"));
 
     size_t offset = 0;
@@ -77,7 +102,8 @@ StatusOr<size_t> KVCacheLayout::Offset(size_t layer_idx,
 StatusOr<size_t> KVCacheLayout::BytesPerPlane() const noexcept {
     AM_RETURN_IF_ERROR(Validate());
     size_t bytes = 0;
-    if (CheckOverflowMul(num_layers, layer_stride, &bytes)) {
+    if (paged() ? CheckOverflowMul(num_blocks, block_stride, &bytes)
+                : CheckOverflowMul(num_layers, layer_stride, &bytes)) {
         return Status::Overflow("KV bytes-per-plane overflowed size_t");
     }
     return bytes;
@@ -91,10 +117,11 @@ KVCacheView::KVCacheView(const KVCacheLayout* layout,
                          KVCacheStorage* storage,
                          SessionKVSlot* slot) noexcept
     : layout_(layout), storage_(storage), slot_(slot),
-      generation_(slot != nullptr ? slot->generation : 0) {}
+      generation_(slot != nullptr ? slot->generation.load(std::memory_order_acquire) : 0) {}
 
 bool KVCacheView::IsSlotAlive() const noexcept {
-    return slot_ != nullptr && slot_->in_use && slot_->generation == generation_;
+    return slot_ != nullptr && slot_->in_use.load(std::memory_order_acquire) &&
+           slot_->generation.load(std::memory_order_acquire) == generation_;
 }
 
 bool KVCacheView::valid() const noexcept {
@@ -121,6 +148,10 @@ size_t KVCacheView::head_dim() const noexcept {
     return layout_ != nullptr ? layout_->head_dim : 0;
 }
 
+DataType KVCacheView::kv_dtype() const noexcept {
+    return layout_ != nullptr ? layout_->kv_dtype : DataType{};
+}
+
 size_t KVCacheView::token_capacity() const noexcept {
     return valid() ? slot_->capacity_tokens : 0;
 }
@@ -129,6 +160,30 @@ size_t KVCacheView::committed_tokens() const noexcept {
     return current_pos();
 }
 
+size_t KVCacheView::window_begin() const noexcept {
+    return valid() ? WindowBeginAt(slot_->current_pos) : 0;
+}
+
+size_t KVCacheView::WindowBeginAt(size_t seq_end) const noexcept {
+    if (!layout_->sliding_window || seq_end <= layout_->max_tokens) {
+        return 0;
+    }
+    return seq_end - layout_->max_tokens;
+}
+
+size_t KVCacheView::slot_index() const noexcept {
+    return valid() ? slot_->slot_index : 0;
+}
+
+size_t KVCacheView::num_mapped_blocks() const noexcept {
+    if (!valid()) {
+        return 0;
+    }
+    return static_cast<size_t>(std::ranges::count_if(slot_->block_table, [](uint32_t block) {
+        return block != KVBlockPool::kInvalidBlock;
+    }));
+}
+
 Status KVCacheView::ValidateBaseState() const noexcept {
     if (layout_ == nullptr || storage_ == nullptr || slot_ == nullptr) {
         return Status::FailedPrecondition("KVCacheView is not bound to manager-owned state");
@@ -142,6 +197,10 @@ Status KVCacheView::ValidateBaseState() const noexcept {
         return Status::FailedPrecondition("KVCacheView is stale or released");
     }
 
+    if (slot_->offloaded_blocks != 0) {
+        return Status::FailedPrecondition("KV session is offloaded to disk and must be prefetched");
+    }
+
     return layout_->Validate();
 }
 
@@ -165,7 +224,14 @@ Status KVCacheView::ValidateWrite(size_t layer_idx,
         return Status::OutOfRange("KV write exceeds reserved session token capacity");
     }
 
-    if (seq_end > layout_->max_tokens) {
+    if (layout_->sliding_window) {
+        if (token_count > layout_->max_tokens) {
+            return Status::OutOfRange("KV write exceeds sliding window size");
+        }
+        if (seq_pos < window_begin()) {
+            return Status::OutOfRange("KV write precedes sliding window");
+        }
+    } else if (seq_end > layout_->max_tokens) {
         return Status::OutOfRange("KV write exceeds physical KV capacity");
     }
 
@@ -185,6 +251,9 @@ Status KVCacheView::ValidateRead(size_t layer_idx,
     if (seq_end > slot_->current_pos) {
         return Status::OutOfRange("KV read exceeds committed token range");
     }
+    if (seq_begin < window_begin()) {
+        return Status::OutOfRange("KV read precedes sliding window");
+    }
     return Status::Ok();
 }
 
@@ -193,7 +262,239 @@ StatusOr<size_t> KVCacheView::Offset(size_t layer_idx,
                                      size_t seq_pos,
                                      size_t dim_idx) const noexcept {
     AM_RETURN_IF_ERROR(ValidateBaseState());
-    return layout_->Offset(layer_idx, kv_head_idx, seq_pos, dim_idx);
+    if (!layout_->paged()) {
+        const size_t row = layout_->sliding_window ? seq_pos % layout_->max_tokens : seq_pos;
+        AM_ASSIGN_OR_RETURN(const size_t offset,
+                            layout_->Offset(layer_idx, kv_head_idx, row, dim_idx));
+        return slot_->base_offset + offset;
+    }
+
+    const size_t logical_block = seq_pos / layout_->block_tokens;
+    if (logical_block >= slot_->block_table.size() ||
+        slot_->block_table[logical_block] == KVBlockPool::kInvalidBlock) {
+        return Status::OutOfRange("KV position is not mapped to a block");
+    }
+    AM_ASSIGN_OR_RETURN(const size_t offset,
+                        layout_->Offset(layer_idx, kv_head_idx,
+                                        seq_pos % layout_->block_tokens, dim_idx));
+    return slot_->block_table[logical_block] * layout_->block_stride + offset;
+}
+
+Status KVCacheView::MapBlocks(size_t seq_end) noexcept {
+    if (!layout_->paged()) {
+        return Status::Ok();
+    }
+    if (storage_->block_pool == nullptr) {
+        return Status::FailedPrecondition("Paged KVCacheView has no block pool");
+    }
+
+    const size_t needed = (seq_end + layout_->block_tokens - 1) / layout_->block_tokens;
+    if (needed > slot_->block_table.size()) {
+        return Status::OutOfRange("KV block table is smaller than the requested range");
+    }
+    for (size_t b = 0; b < needed; ++b) {
+        uint32_t& entry = slot_->block_table[b];
+        if (entry != KVBlockPool::kInvalidBlock) {
+            continue;
+        }
+        AM_ASSIGN_OR_RETURN(entry, AllocateBlock());
+        if (layout_->scaled()) {
+            const size_t block_entries = layout_->WalkBlockScaleEntries();
+            for (std::vector<float>* scales: {&storage_->key_scales, &storage_->value_scales}) {
+                std::fill_n(scales->begin() + entry * block_entries, block_entries, 0.0F);
+            }
+        }
+    }
+    return Status::Ok();
+}
+
+StatusOr<uint32_t> KVCacheView::AllocateBlock() noexcept {
+    uint32_t block = storage_->block_pool->Allocate();
+    if (block == KVBlockPool::kInvalidBlock && storage_->prefix_cache != nullptr &&
+        storage_->prefix_cache->Evict(1) != 0) {
+        block = storage_->block_pool->Allocate();
+    }
+    if (block == KVBlockPool::kInvalidBlock) {
+        return Status::ResourceExhausted("KV block pool is exhausted");
+    }
+    return block;
+}
+
+Status KVCacheView::PrepareBlockForWrite(size_t seq_pos) noexcept {
+    AM_RETURN_IF_ERROR(MapBlocks(seq_pos + 1));
+    if (!layout_->paged()) {
+        return Status::Ok();
+    }
+
+    uint32_t& entry = slot_->block_table[seq_pos / layout_->block_tokens];
+    if (storage_->block_pool->ref_count(entry) <= 1) {
+        return Status::Ok();
+    }
+    // Copy-on-write: the block is shared with the prefix cache or another
+    // session, so this session diverges onto a private copy.
+    AM_ASSIGN_OR_RETURN(const uint32_t copy, AllocateBlock());
+    const size_t stride = layout_->block_stride;
+    for (Buffer* plane: {&storage_->key_buffer, &storage_->value_buffer}) {
+        auto* base = static_cast<std::byte*>(plane->mutable_data());
+        std::memcpy(base + copy * stride, base + entry * stride, stride);
+    }
+    if (layout_->scaled()) {
+        const size_t block_entries = layout_->WalkBlockScaleEntries();
+        for (std::vector<float>* scales: {&storage_->key_scales, &storage_->value_scales}) {
+            std::copy_n(scales->begin() + entry * block_entries, block_entries,
+                        scales->begin() + copy * block_entries);
+        }
+    }
+    storage_->block_pool->Release(entry);
+    entry = copy;
+    return Status::Ok();
+}
+
+size_t KVCacheView::ScaleIndex(size_t layer_idx, size_t kv_head_idx, size_t seq_pos) const noexcept {
+    const size_t walk_tokens = layout_->walk_block_tokens;
+    size_t walk_block = 0;
+    size_t row = layout_->sliding_window ? seq_pos % layout_->max_tokens : seq_pos;
+    if (layout_->paged()) {
+        walk_block = slot_->block_table[seq_pos / layout_->block_tokens];
+    } else {
+        const size_t walk_blocks_per_slot = (layout_->max_tokens + walk_tokens - 1) / walk_tokens;
+        walk_block = slot_->slot_index * walk_blocks_per_slot + row / walk_tokens;
+    }
+    return ((walk_block * layout_->num_layers + layer_idx) * layout_->num_kv_heads + kv_head_idx) * walk_tokens +
+           row % walk_tokens;
+}
+
+Status KVCacheView::WriteToken(size_t layer_idx,
+                               size_t kv_head_idx,
+                               size_t seq_pos,
+                               std::span<const float> key,
+                               std::span<const float> value) noexcept {
+    if (key.size() != head_dim() || value.size() != head_dim()) {
+        return Status::InvalidArgument("KV token rows must have head_dim elements");
+    }
+    AM_ASSIGN_OR_RETURN(void* key_dst, MutableKeyData(layer_idx, kv_head_idx, seq_pos));
+    AM_ASSIGN_OR_RETURN(void* value_dst, MutableValueData(layer_idx, kv_head_idx, seq_pos));
+    if (!layout_->scaled()) {
+        AM_RETURN_IF_ERROR(QuantizeKVRow(layout_->kv_dtype, key, 1.0F, key_dst));
+        return QuantizeKVRow(layout_->kv_dtype, value, 1.0F, value_dst);
+    }
+
+    // Each row keeps the scale it was quantized with, so a later outlier in
+    // the same block never requantizes (and compounds the error of) earlier rows.
+    const size_t scale_index = ScaleIndex(layer_idx, kv_head_idx, seq_pos);
+    float& key_scale = storage_->key_scales[scale_index];
+    float& value_scale = storage_->value_scales[scale_index];
+    key_scale = ComputeKVInt8Scale(key);
+    value_scale = ComputeKVInt8Scale(value);
+    AM_RETURN_IF_ERROR(QuantizeKVRow(layout_->kv_dtype, key, key_scale, key_dst));
+    return QuantizeKVRow(layout_->kv_dtype, value, value_scale, value_dst);
+}
+
+Status KVCacheView::ReadToken(size_t layer_idx,
+                              size_t kv_head_idx,
+                              size_t seq_pos,
+                              std::span<float> key,
+                              std::span<float> value) const noexcept {
+    if (key.size() != head_dim() || value.size() != head_dim()) {
+        return Status::InvalidArgument("KV token rows must have head_dim elements");
+    }
+    AM_ASSIGN_OR_RETURN(const void* key_src, KeyData(layer_idx, kv_head_idx, seq_pos));
+    AM_ASSIGN_OR_RETURN(const void* value_src, ValueData(layer_idx, kv_head_idx, seq_pos));
+    float key_scale = 1.0F;
+    float value_scale = 1.0F;
+    if (layout_->scaled()) {
+        const size_t scale_index = ScaleIndex(layer_idx, kv_head_idx, seq_pos);
+        key_scale = storage_->key_scales[scale_index];
+        value_scale = storage_->value_scales[scale_index];
+    }
+    AM_RETURN_IF_ERROR(DequantizeKVRow(layout_->kv_dtype, key_src, key_scale, key));
+    return DequantizeKVRow(layout_->kv_dtype, value_src, value_scale, value);
+}
+
+size_t KVCacheView::block_tokens() const noexcept {
+    if (layout_ == nullptr) {
+        return 0;
+    }
+    if (layout_->paged()) {
+        return layout_->block_tokens;
+    }
+    if (layout_->scaled()) {
+        return layout_->walk_block_tokens;
+    }
+    return layout_->sliding_window ? layout_->max_tokens : token_capacity();
+}
+
+size_t KVCacheView::num_committed_blocks() const noexcept {
+    return NumBlocksUntil(committed_tokens());
+}
+
+size_t KVCacheView::NumBlocksUntil(size_t seq_end) const noexcept {
+    const size_t tokens_per_block = block_tokens();
+    if (tokens_per_block == 0) {
+        return 0;
+    }
+    const size_t begin = WindowBeginAt(seq_end);
+    if (seq_end == begin) {
+        return 0;
+    }
+    return (seq_end - 1) / tokens_per_block - begin / tokens_per_block + 1;
+}
+
+StatusOr<KVCacheBlock> KVCacheView::CommittedBlock(size_t layer_idx,
+                                                   size_t kv_head_idx,
+                                                   size_t block_index) const noexcept {
+    AM_RETURN_IF_ERROR(ValidateBaseState());
+    return BlockUntil(layer_idx, kv_head_idx, block_index, slot_->current_pos);
+}
+
+StatusOr<KVCacheBlock> KVCacheView::BlockUntil(size_t layer_idx,
+                                               size_t kv_head_idx,
+                                               size_t block_index,
+                                               size_t seq_end) const noexcept {
+    AM_RETURN_IF_ERROR(ValidateBaseState());
+    AM_RETURN_IF_ERROR(ValidateIndexRange(layer_idx, layout_->num_layers, "layer"));
+    AM_RETURN_IF_ERROR(ValidateIndexRange(kv_head_idx, layout_->num_kv_heads, "kv_head"));
+    if (seq_end > slot_->capacity_tokens) {
+        return Status::OutOfRange("KV read exceeds reserved session token capacity");
+    }
+    const size_t begin = WindowBeginAt(seq_end);
+    if (begin < window_begin()) {
+        return Status::OutOfRange("KV read precedes sliding window");
+    }
+    if (block_index >= NumBlocksUntil(seq_end)) {
+        return Status::OutOfRange("KV block index exceeds committed blocks");
+    }
+
+    // Blocks are aligned to block_tokens() in position space; a ring size
+    // that is a multiple of the block size keeps each block contiguous.
+    const size_t tokens_per_block = block_tokens();
+    const size_t position_block = begin / tokens_per_block + block_index;
+    const size_t first_pos = std::max(begin, position_block * tokens_per_block);
+    const size_t end_pos = std::min(seq_end, (position_block + 1) * tokens_per_block);
+    AM_ASSIGN_OR_RETURN(const size_t offset, Offset(layer_idx, kv_head_idx, first_pos, 0));
+    KVCacheBlock block{
+            .key = static_cast<const std::byte*>(storage_->key_buffer.data()) + offset,
+            .value = static_cast<const std::byte*>(storage_->value_buffer.data()) + offset,
+            .first_pos = first_pos,
+            .num_tokens = end_pos - first_pos,
+            .token_stride = layout_->token_stride,
+            .kv_dtype = layout_->kv_dtype,
+    };
+    if (layout_->scaled()) {
+        // A block's row scales are contiguous as well.
+        const size_t scale_index = ScaleIndex(layer_idx, kv_head_idx, first_pos);
+        block.key_scales = storage_->key_scales.data() + scale_index;
+        block.value_scales = storage_->value_scales.data() + scale_index;
+    }
+    return block;
+}
+
+Status KVCacheView::ReserveTokens(size_t seq_end) noexcept {
+    AM_RETURN_IF_ERROR(ValidateBaseState());
+    if (seq_end > slot_->capacity_tokens) {
+        return Status::OutOfRange("KV reservation exceeds reserved session token capacity");
+    }
+    return MapBlocks(seq_end);
 }
 
 StatusOr<void*> KVCacheView::MutableKeyData(size_t layer_idx,
@@ -201,6 +502,7 @@ StatusOr<void*> KVCacheView::MutableKeyData(size_t layer_idx,
                                             size_t seq_pos,
                                             size_t dim_idx) noexcept {
     AM_RETURN_IF_ERROR(ValidateWrite(layer_idx, kv_head_idx, seq_pos, 1));
+    AM_RETURN_IF_ERROR(PrepareBlockForWrite(seq_pos));
     const StatusOr<size_t> offset = Offset(layer_idx, kv_head_idx, seq_pos, dim_idx);
     if (!offset.ok()) {
         return offset.status();
@@ -213,6 +515,7 @@ StatusOr<void*> KVCacheView::MutableValueData(size_t layer_idx,
                                               size_t seq_pos,
                                               size_t dim_idx) noexcept {
     AM_RETURN_IF_ERROR(ValidateWrite(layer_idx, kv_head_idx, seq_pos, 1));
+    AM_RETURN_IF_ERROR(PrepareBlockForWrite(seq_pos));
     const StatusOr<size_t> offset = Offset(layer_idx, kv_head_idx, seq_pos, dim_idx);
     if (!offset.ok()) {
         return offset.status();
@@ -252,6 +555,21 @@ Status KVCacheView::CommitUntil(size_t new_pos) noexcept {
     if (new_pos > slot_->capacity_tokens) {
         return Status::OutOfRange("KV commit exceeds reserved session token capacity");
     }
+    // Committed positions are always backed by a block.
+    AM_RETURN_IF_ERROR(MapBlocks(new_pos));
+    slot_->current_pos = new_pos;
+    return Status::Ok();
+}
+
+Status KVCacheView::RollbackTo(size_t new_pos) noexcept {
+    AM_RETURN_IF_ERROR(ValidateBaseState());
+    if (new_pos > slot_->current_pos) {
+        return Status::InvalidArgument("KV rollback position is past the committed position");
+    }
+    if (layout_->sliding_window && new_pos < slot_->current_pos &&
+        slot_->current_pos > layout_->max_tokens) {
+        return Status::FailedPrecondition("Sliding-window KV session has wrapped and cannot roll back");
+    }
     slot_->current_pos = new_pos;
     return Status::Ok();
 }
@@ -0,0 +1,117 @@
+#include "aethermind/execution/kv_decode_attention.h"
+#include "aethermind/execution/kv_quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aethermind {
+
+Status DecodeAttention(const KVCacheView& view,
+                       size_t layer_idx,
+                       size_t kv_head_idx,
+                       std::span<const float> query,
+                       float softmax_scale,
+                       std::span<float> output) noexcept {
+    return DecodeAttention(view, layer_idx, kv_head_idx, view.committed_tokens(), query, softmax_scale, output);
+}
+
+Status DecodeAttention(const KVCacheView& view,
+                       size_t layer_idx,
+                       size_t kv_head_idx,
+                       size_t seq_end,
+                       std::span<const float> query,
+                       float softmax_scale,
+                       std::span<float> output) noexcept {
+    const size_t head_dim = view.head_dim();
+    if (query.size() != head_dim || output.size() != head_dim) {
+        return Status::InvalidArgument("DecodeAttention query and output must have head_dim elements");
+    }
+    if (seq_end == 0) {
+        return Status::FailedPrecondition("DecodeAttention requires at least one KV token");
+    }
+
+    std::ranges::fill(output, 0.0F);
+    float running_max = -std::numeric_limits<float>::infinity();
+    float running_sum = 0.0F;
+    const size_t num_blocks = view.NumBlocksUntil(seq_end);
+    for (size_t b = 0; b < num_blocks; ++b) {
+        AM_ASSIGN_OR_RETURN(const KVCacheBlock block, view.BlockUntil(layer_idx, kv_head_idx, b, seq_end));
+        AM_RETURN_IF_ERROR(VisitKVStorageType(block.kv_dtype, [&]<typename T>(T) {
+            const auto* keys = static_cast<const std::byte*>(block.key);
+            const auto* values = static_cast<const std::byte*>(block.value);
+            for (size_t t = 0; t < block.num_tokens; ++t) {
+                const auto* key = reinterpret_cast<const T*>(keys + t * block.token_stride);
+                float dot = 0.0F;
+                for (size_t d = 0; d < head_dim; ++d) {
+                    dot += query[d] * LoadKVElement(key, d, 1.0F);
+                }
+                const float key_scale = block.key_scales != nullptr ? block.key_scales[t] : 1.0F;
+                const float score = dot * key_scale * softmax_scale;
+
+                const float new_max = std::max(running_max, score);
+                const float correction = std::exp(running_max - new_max);
+                const float weight = std::exp(score - new_max);
+                running_sum = running_sum * correction + weight;
+                running_max = new_max;
+
+                const auto* value = reinterpret_cast<const T*>(values + t * block.token_stride);
+                const float value_scale = block.value_scales != nullptr ? block.value_scales[t] : 1.0F;
+                const float value_weight = weight * value_scale;
+                for (size_t d = 0; d < head_dim; ++d) {
+                    output[d] = output[d] * correction + value_weight * LoadKVElement(value, d, 1.0F);
+                }
+            }
+            return Status::Ok();
+        }));
+    }
+
+    for (float& out: output) {
+        out /= running_sum;
+    }
+    return Status::Ok();
+}
+
+Status BatchedDecodeAttention(std::span<const KVCacheView> views,
+                              std::span<const size_t> positions,
+                              size_t layer_idx,
+                              size_t num_q_heads,
+                              std::span<const float> queries,
+                              float softmax_scale,
+                              std::span<float> output) noexcept {
+    if (views.empty()) {
+        return Status::InvalidArgument("BatchedDecodeAttention requires at least one session");
+    }
+    if (positions.size() != views.size()) {
+        return Status::InvalidArgument("BatchedDecodeAttention needs one position per session");
+    }
+    const size_t num_kv_heads = views.front().num_kv_heads();
+    const size_t head_dim = views.front().head_dim();
+    for (const KVCacheView& view: views) {
+        if (view.num_kv_heads() != num_kv_heads || view.head_dim() != head_dim) {
+            return Status::InvalidArgument("BatchedDecodeAttention sessions must share one KV geometry");
+        }
+    }
+    if (num_kv_heads == 0 || num_q_heads == 0 || num_q_heads % num_kv_heads != 0) {
+        return Status::InvalidArgument(
+                "BatchedDecodeAttention query heads must be a non-zero multiple of the KV heads");
+    }
+    const size_t row_elems = num_q_heads * head_dim;
+    if (queries.size() != views.size() * row_elems || output.size() != queries.size()) {
+        return Status::InvalidArgument(
+                "BatchedDecodeAttention queries and output must hold batch * num_q_heads * head_dim elements");
+    }
+
+    const size_t group = num_q_heads / num_kv_heads;
+    for (size_t b = 0; b < views.size(); ++b) {
+        for (size_t h = 0; h < num_q_heads; ++h) {
+            const size_t offset = b * row_elems + h * head_dim;
+            AM_RETURN_IF_ERROR(DecodeAttention(views[b], layer_idx, h / group, positions[b] + 1,
+                                               queries.subspan(offset, head_dim), softmax_scale,
+                                               output.subspan(offset, head_dim)));
+        }
+    }
+    return Status::Ok();
+}
+
+}// namespace aethermind
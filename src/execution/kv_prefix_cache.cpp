@@ -0,0 +1,150 @@
+#include "aethermind/execution/kv_prefix_cache.h"
+#include "utils/logging.h"
+#include "utils/xxh3.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+namespace aethermind {
+
+KVPrefixCache::KVPrefixCache(KVBlockPool* pool, size_t block_tokens) noexcept
+    : pool_(pool), block_tokens_(block_tokens) {
+    AM_DCHECK(pool_ != nullptr);
+    AM_DCHECK(block_tokens_ > 0);
+}
+
+KVPrefixCache::~KVPrefixCache() {
+    ReleaseSubtree(root_);
+}
+
+void KVPrefixCache::ReleaseSubtree(Node& node) noexcept {
+    for (auto& [hash, child]: node.children) {
+        ReleaseSubtree(*child);
+        pool_->Release(child->block);
+    }
+    node.children.clear();
+}
+
+uint64_t KVPrefixCache::HashBlock(uint64_t parent_hash,
+                                  std::span<const int32_t> tokens) const noexcept {
+    const std::span<const std::byte> bytes = std::as_bytes(tokens);
+    return xxh3::XXH3_64bits_withSeed(bytes.data(), bytes.size(), parent_hash);
+}
+
+KVPrefixCache::Node* KVPrefixCache::FindChild(Node& parent,
+                                              uint64_t hash,
+                                              std::span<const int32_t> tokens) const noexcept {
+    const auto it = parent.children.find(hash);
+    if (it == parent.children.end() || !std::ranges::equal(it->second->tokens, tokens)) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+std::vector<uint32_t> KVPrefixCache::Acquire(std::span<const int32_t> tokens) {
+    std::lock_guard lock(mutex_);
+    std::vector<uint32_t> blocks;
+    const uint64_t now = ++clock_;
+    Node* node = &root_;
+    for (size_t begin = 0; begin + block_tokens_ <= tokens.size(); begin += block_tokens_) {
+        const std::span<const int32_t> block_ids = tokens.subspan(begin, block_tokens_);
+        Node* child = FindChild(*node, HashBlock(node->hash, block_ids), block_ids);
+        if (child == nullptr) {
+            break;
+        }
+        pool_->Retain(child->block);
+        child->last_access = now;
+        blocks.push_back(child->block);
+        node = child;
+    }
+    hit_blocks_ += blocks.size();
+    return blocks;
+}
+
+size_t KVPrefixCache::Insert(std::span<const int32_t> tokens, std::span<const uint32_t> blocks) {
+    std::lock_guard lock(mutex_);
+    const uint64_t now = ++clock_;
+    const size_t num_full = std::min(tokens.size() / block_tokens_, blocks.size());
+    size_t added = 0;
+    Node* node = &root_;
+    for (size_t b = 0; b < num_full; ++b) {
+        const std::span<const int32_t> block_ids = tokens.subspan(b * block_tokens_, block_tokens_);
+        const uint64_t hash = HashBlock(node->hash, block_ids);
+        Node* child = FindChild(*node, hash, block_ids);
+        if (child == nullptr) {
+            // A different prefix with the same hash already owns this key.
+            if (node->children.contains(hash) || blocks[b] == KVBlockPool::kInvalidBlock) {
+                break;
+            }
+            auto created = std::make_unique<Node>();
+            created->hash = hash;
+            created->tokens.assign(block_ids.begin(), block_ids.end());
+            created->block = blocks[b];
+            created->parent = node;
+            pool_->Retain(blocks[b]);
+            child = created.get();
+            node->children.emplace(hash, std::move(created));
+            ++num_cached_blocks_;
+            ++added;
+        }
+        child->last_access = now;
+        node = child;
+    }
+    return added;
+}
+
+size_t KVPrefixCache::Evict(size_t num_blocks) {
+    std::lock_guard lock(mutex_);
+    const auto evictable = [this](const Node* node) noexcept {
+        return node->children.empty() && pool_->ref_count(node->block) == 1;
+    };
+    const auto older = [](const Node* lhs, const Node* rhs) noexcept {
+        return lhs->last_access > rhs->last_access;
+    };
+    std::priority_queue<Node*, std::vector<Node*>, decltype(older)> candidates(older);
+
+    std::vector<Node*> stack{&root_};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        for (auto& [hash, child]: node->children) {
+            if (evictable(child.get())) {
+                candidates.push(child.get());
+            } else {
+                stack.push_back(child.get());
+            }
+        }
+    }
+
+    size_t evicted = 0;
+    while (evicted < num_blocks && !candidates.empty()) {
+        Node* victim = candidates.top();
+        candidates.pop();
+        Node* parent = victim->parent;
+        pool_->Release(victim->block);
+        parent->children.erase(victim->hash);
+        --num_cached_blocks_;
+        ++evicted;
+        if (parent != &root_ && evictable(parent)) {
+            candidates.push(parent);
+        }
+    }
+    return evicted;
+}
+
+size_t KVPrefixCache::block_tokens() const noexcept {
+    return block_tokens_;
+}
+
+size_t KVPrefixCache::num_cached_blocks() const noexcept {
+    std::lock_guard lock(mutex_);
+    return num_cached_blocks_;
+}
+
+size_t KVPrefixCache::hit_blocks() const noexcept {
+    std::lock_guard lock(mutex_);
+    return hit_blocks_;
+}
+
+}// namespace aethermind
@@ -0,0 +1,63 @@
+#include "aethermind/execution/kv_quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aethermind {
+namespace {
+
+template<typename T>
+T StoreKVElement(float value, float inv_scale) noexcept {
+    if constexpr (std::is_same_v<T, int8_t>) {
+        const float q = std::nearbyint(value * inv_scale);
+        return static_cast<int8_t>(std::clamp(q, -kKVInt8MaxValue, kKVInt8MaxValue));
+    } else if constexpr (std::is_same_v<T, Float8_e4m3fn> || std::is_same_v<T, Float8_e5m2>) {
+        // FP8 formats have no usable infinity; saturate instead of producing NaN.
+        const float limit = static_cast<float>(std::numeric_limits<T>::max());
+        return T(std::clamp(value, -limit, limit));
+    } else {
+        return T(value);
+    }
+}
+
+}// namespace
+
+bool IsSupportedKVStorageDType(const DataType& dtype) noexcept {
+    return VisitKVStorageType(dtype, [](auto) { return Status::Ok(); }).ok();
+}
+
+bool IsScaledKVStorageDType(const DataType& dtype) noexcept {
+    return dtype == DataType::Int(8);
+}
+
+float ComputeKVInt8Scale(std::span<const float> values) noexcept {
+    float abs_max = 0.0F;
+    for (const float value: values) {
+        abs_max = std::max(abs_max, std::fabs(value));
+    }
+    return abs_max / kKVInt8MaxValue;
+}
+
+Status QuantizeKVRow(const DataType& dtype, std::span<const float> src, float scale, void* dst) noexcept {
+    const float inv_scale = scale > 0.0F ? 1.0F / scale : 0.0F;
+    return VisitKVStorageType(dtype, [&]<typename T>(T) {
+        T* out = static_cast<T*>(dst);
+        for (size_t i = 0; i < src.size(); ++i) {
+            out[i] = StoreKVElement<T>(src[i], inv_scale);
+        }
+        return Status::Ok();
+    });
+}
+
+Status DequantizeKVRow(const DataType& dtype, const void* src, float scale, std::span<float> dst) noexcept {
+    return VisitKVStorageType(dtype, [&]<typename T>(T) {
+        const T* in = static_cast<const T*>(src);
+        for (size_t i = 0; i < dst.size(); ++i) {
+            dst[i] = LoadKVElement(in, i, scale);
+        }
+        return Status::Ok();
+    });
+}
+
+}// namespace aethermind
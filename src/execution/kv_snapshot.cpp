@@ -0,0 +1,211 @@
+#include "aethermind/execution/kv_snapshot.h"
+#include "aethermind/base/binary_file.h"
+#include "aethermind/execution/kv_quantization.h"
+#include "utils/overflow_check.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aethermind {
+namespace {
+
+constexpr uint32_t kKVSnapshotMagic = 0x504E5341;// "ASNP"
+// Version 2 writes the header field by field instead of as a raw struct.
+constexpr uint32_t kKVSnapshotVersion = 2;
+
+size_t ScaleBytes(const DataType& dtype) noexcept {
+    return IsScaledKVStorageDType(dtype) ? sizeof(float) : 0;
+}
+
+size_t RecordBytes(size_t scale_bytes, size_t row_bytes) noexcept {
+    return 2 * (scale_bytes + row_bytes);
+}
+
+// Visits the header fields in their on-disk order.
+struct HeaderFields {
+    template<typename Header, typename Fn>
+    constexpr void operator()(Header& header, Fn&& fn) const {
+        fn(header.magic);
+        fn(header.version);
+        fn(header.num_layers);
+        fn(header.num_kv_heads);
+        fn(header.head_dim);
+        fn(header.storage_dtype.code);
+        fn(header.storage_dtype.bits);
+        fn(header.storage_dtype.lanes);
+        fn(header.window_begin);
+        fn(header.committed_tokens);
+        fn(header.prompt_len);
+        fn(header.generated_len);
+        fn(header.prefill_done);
+    }
+};
+
+static_assert(EncodedFieldBytes<KVSnapshotHeader>(HeaderFields{}) <= kKVSnapshotHeaderBytes,
+              "KV snapshot header fields outgrew the header");
+
+// Writes the header and every resident row of `view` to `out`.
+Status WriteSnapshot(const KVCacheView& view, const KVSnapshotHeader& header, std::ofstream& out) {
+    const DataType dtype(header.storage_dtype);
+    const size_t head_dim = header.head_dim;
+    const size_t scale_bytes = ScaleBytes(dtype);
+    const size_t row_bytes = head_dim * static_cast<size_t>(dtype.nbytes());
+    const size_t record_bytes = RecordBytes(scale_bytes, row_bytes);
+    const size_t num_tokens = header.committed_tokens - header.window_begin;
+
+    std::array<std::byte, kKVSnapshotHeaderBytes> header_bytes{};
+    EncodeFields(header, HeaderFields{}, header_bytes.data());
+    out.write(reinterpret_cast<const char*>(header_bytes.data()), header_bytes.size());
+
+    std::vector<float> rows[2] = {std::vector<float>(head_dim), std::vector<float>(head_dim)};
+    std::vector<std::byte> chunk(num_tokens * record_bytes);
+    for (size_t layer = 0; layer < header.num_layers; ++layer) {
+        for (size_t head = 0; head < header.num_kv_heads; ++head) {
+            std::byte* record = chunk.data();
+            for (size_t pos = header.window_begin; pos < header.committed_tokens; ++pos) {
+                AM_RETURN_IF_ERROR(view.ReadToken(layer, head, pos, rows[0], rows[1]));
+                for (const std::vector<float>& row: rows) {
+                    float scale = 1.0F;
+                    if (scale_bytes != 0) {
+                        scale = ComputeKVInt8Scale(row);
+                        std::memcpy(record, &scale, sizeof(scale));
+                        record += scale_bytes;
+                    }
+                    AM_RETURN_IF_ERROR(QuantizeKVRow(dtype, row, scale, record));
+                    record += row_bytes;
+                }
+            }
+            out.write(reinterpret_cast<const char*>(chunk.data()),
+                      static_cast<std::streamsize>(chunk.size()));
+        }
+    }
+    return Status::Ok();
+}
+
+}// namespace
+
+Status SaveKVSnapshot(const KVCacheView& view,
+                      const RuntimeSequenceState& state,
+                      const std::filesystem::path& path,
+                      const KVSnapshotOptions& options) {
+    if (!view.valid()) {
+        return Status::FailedPrecondition("Cannot snapshot an invalid KVCacheView");
+    }
+    if (state.step_tokens != 0) {
+        return Status::FailedPrecondition("Cannot snapshot a session with a step in flight");
+    }
+    if (state.current_pos != view.committed_tokens()) {
+        return Status::InvalidArgument("Sequence state does not match the committed KV range");
+    }
+
+    const DataType dtype = options.storage_dtype.IsUndefined() ? view.kv_dtype() : options.storage_dtype;
+    if (!IsSupportedKVStorageDType(dtype)) {
+        return Status::InvalidArgument("Unsupported KV snapshot storage dtype");
+    }
+
+    KVSnapshotHeader header;
+    header.magic = kKVSnapshotMagic;
+    header.version = kKVSnapshotVersion;
+    header.num_layers = view.num_layers();
+    header.num_kv_heads = view.num_kv_heads();
+    header.head_dim = view.head_dim();
+    header.storage_dtype = dtype;
+    header.window_begin = view.window_begin();
+    header.committed_tokens = view.committed_tokens();
+    header.prompt_len = state.prompt_len;
+    header.generated_len = state.generated_len;
+    header.prefill_done = state.prefill_done ? 1 : 0;
+
+    return WriteFileAtomically(path, "KV snapshot", [&](std::ofstream& out) {
+        return WriteSnapshot(view, header, out);
+    });
+}
+
+KVSnapshot::KVSnapshot(MemoryMappedFile file, const KVSnapshotHeader& header) noexcept
+    : file_(std::move(file)), header_(header),
+      row_bytes_(header.head_dim * static_cast<size_t>(DataType(header.storage_dtype).nbytes())),
+      scale_bytes_(ScaleBytes(DataType(header.storage_dtype))) {}
+
+StatusOr<KVSnapshot> KVSnapshot::Open(const std::filesystem::path& path) {
+    AM_ASSIGN_OR_RETURN(MemoryMappedFile file, MemoryMappedFile::Map(path));
+    if (file.size() < kKVSnapshotHeaderBytes) {
+        return Status::InvalidArgument("KV snapshot file is too small: " + path.string());
+    }
+
+    KVSnapshotHeader header;
+    DecodeFields(header, HeaderFields{}, file.ByteData());
+    if (header.magic != kKVSnapshotMagic) {
+        return Status::InvalidArgument("Not a KV snapshot file: " + path.string());
+    }
+    if (header.version != kKVSnapshotVersion) {
+        return Status::InvalidArgument("Unsupported KV snapshot version " +
+                                       std::to_string(header.version));
+    }
+    const DataType dtype(header.storage_dtype);
+    if (!IsSupportedKVStorageDType(dtype) || header.window_begin > header.committed_tokens ||
+        header.num_layers == 0 || header.num_kv_heads == 0 || header.head_dim == 0) {
+        return Status::InvalidArgument("Corrupt KV snapshot header: " + path.string());
+    }
+
+    size_t payload = RecordBytes(ScaleBytes(dtype), header.head_dim * static_cast<size_t>(dtype.nbytes()));
+    for (const uint64_t factor: {header.num_layers, header.num_kv_heads,
+                                 header.committed_tokens - header.window_begin}) {
+        if (CheckOverflowMul(payload, static_cast<size_t>(factor), &payload)) {
+            return Status::Overflow("KV snapshot payload size overflowed size_t");
+        }
+    }
+    if (file.size() - kKVSnapshotHeaderBytes != payload) {
+        return Status::InvalidArgument("KV snapshot payload size does not match its header: " +
+                                       path.string());
+    }
+    (void) file.Advise(MemoryMappedFile::Advice::kSequential);
+    return KVSnapshot(std::move(file), header);
+}
+
+RuntimeSequenceState KVSnapshot::sequence_state() const noexcept {
+    RuntimeSequenceState state;
+    state.prefill_done = header_.prefill_done != 0;
+    state.prompt_len = header_.prompt_len;
+    state.generated_len = header_.generated_len;
+    state.current_pos = header_.committed_tokens;
+    return state;
+}
+
+Status KVSnapshot::ReadToken(size_t layer_idx,
+                             size_t kv_head_idx,
+                             size_t seq_pos,
+                             std::span<float> key,
+                             std::span<float> value) const noexcept {
+    if (layer_idx >= header_.num_layers || kv_head_idx >= header_.num_kv_heads) {
+        return Status::OutOfRange("KV snapshot layer or kv_head index out of range");
+    }
+    if (seq_pos < header_.window_begin || seq_pos >= header_.committed_tokens) {
+        return Status::OutOfRange("KV snapshot does not hold the requested position");
+    }
+    if (key.size() != header_.head_dim || value.size() != header_.head_dim) {
+        return Status::InvalidArgument("KV token rows must have head_dim elements");
+    }
+
+    const size_t num_tokens = header_.committed_tokens - header_.window_begin;
+    const size_t index = (layer_idx * header_.num_kv_heads + kv_head_idx) * num_tokens +
+                         (seq_pos - header_.window_begin);
+    const std::byte* record = file_.ByteData() + kKVSnapshotHeaderBytes +
+                              index * RecordBytes(scale_bytes_, row_bytes_);
+    const DataType dtype(header_.storage_dtype);
+    for (const std::span<float> row: {key, value}) {
+        float scale = 1.0F;
+        if (scale_bytes_ != 0) {
+            std::memcpy(&scale, record, sizeof(scale));
+            record += scale_bytes_;
+        }
+        AM_RETURN_IF_ERROR(DequantizeKVRow(dtype, record, scale, row));
+        record += row_bytes_;
+    }
+    return Status::Ok();
+}
+
+}// namespace aethermind
@@ -0,0 +1,139 @@
+#include "aethermind/execution/kv_spill_file.h"
+#include "utils/logging.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+namespace aethermind {
+namespace {
+
+std::string ErrnoMessage(const char* operation, int error_number) {
+    return std::string(operation) + " failed for KV spill file: " +
+           std::error_code(error_number, std::generic_category()).message();
+}
+
+size_t TotalBytes(auto parts) noexcept {
+    size_t total = 0;
+    for (const auto& part: parts) {
+        total += part.size();
+    }
+    return total;
+}
+
+}// namespace
+
+KVSpillFile::~KVSpillFile() {
+    if (fd_ >= 0) {
+        const int ret = close(fd_);
+        AM_DCHECK(ret == 0, "close failed");
+    }
+}
+
+StatusOr<std::unique_ptr<KVSpillFile>> KVSpillFile::Create(const std::filesystem::path& path,
+                                                           size_t record_bytes,
+                                                           uint32_t max_records) {
+    if (record_bytes == 0) {
+        return Status::InvalidArgument("KV spill records must be non-empty");
+    }
+    if (max_records == kInvalidRecord) {
+        return Status::InvalidArgument("KV spill record count must leave room for kInvalidRecord");
+    }
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        const int error_number = errno;
+        if (error_number == EACCES || error_number == EPERM) {
+            return Status::PermissionDenied(ErrnoMessage("open", error_number));
+        }
+        return Status::Internal(ErrnoMessage("open", error_number));
+    }
+    std::unique_ptr<KVSpillFile> file(new KVSpillFile(fd, record_bytes, max_records));
+    file->free_records_.reserve(max_records);
+    if (unlink(path.c_str()) != 0) {
+        return Status::Internal(ErrnoMessage("unlink", errno));
+    }
+    return file;
+}
+
+StatusOr<uint32_t> KVSpillFile::Write(std::span<const std::span<const std::byte>> parts) {
+    if (TotalBytes(parts) != record_bytes_) {
+        return Status::InvalidArgument("KV spill write must fill exactly one record");
+    }
+
+    uint32_t record = kInvalidRecord;
+    {
+        std::lock_guard lock(mutex_);
+        if (!free_records_.empty()) {
+            record = free_records_.back();
+            free_records_.pop_back();
+        } else if (next_record_ < max_records_) {
+            record = next_record_++;
+        }
+    }
+    if (record == kInvalidRecord) {
+        return Status::ResourceExhausted("KV spill file has no free record");
+    }
+
+    auto offset = static_cast<off_t>(static_cast<size_t>(record) * record_bytes_);
+    for (const std::span<const std::byte> part: parts) {
+        size_t done = 0;
+        while (done < part.size()) {
+            const ssize_t n = pwrite(fd_, part.data() + done, part.size() - done, offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                const int error_number = errno;
+                Free(record);
+                if (error_number == ENOSPC) {
+                    return Status::ResourceExhausted(ErrnoMessage("pwrite", error_number));
+                }
+                return Status::Internal(ErrnoMessage("pwrite", error_number));
+            }
+            done += static_cast<size_t>(n);
+            offset += n;
+        }
+    }
+    return record;
+}
+
+Status KVSpillFile::Read(uint32_t record, std::span<const std::span<std::byte>> parts) const {
+    if (TotalBytes(parts) != record_bytes_) {
+        return Status::InvalidArgument("KV spill read must cover exactly one record");
+    }
+
+    auto offset = static_cast<off_t>(static_cast<size_t>(record) * record_bytes_);
+    for (const std::span<std::byte> part: parts) {
+        size_t done = 0;
+        while (done < part.size()) {
+            const ssize_t n = pread(fd_, part.data() + done, part.size() - done, offset);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                return Status::Internal(ErrnoMessage("pread", errno));
+            }
+            if (n == 0) {
+                return Status::OutOfRange("KV spill record lies past the end of the file");
+            }
+            done += static_cast<size_t>(n);
+            offset += n;
+        }
+    }
+    return Status::Ok();
+}
+
+void KVSpillFile::Free(uint32_t record) noexcept {
+    std::lock_guard lock(mutex_);
+    AM_DCHECK(free_records_.size() < free_records_.capacity(), "KV spill free list outgrew its reservation");
+    free_records_.push_back(record);
+}
+
+size_t KVSpillFile::num_records() const noexcept {
+    std::lock_guard lock(mutex_);
+    return next_record_ - free_records_.size();
+}
+
+}// namespace aethermind
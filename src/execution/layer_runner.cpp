@@ -3,6 +3,8 @@
 #include "aethermind/execution/runtime_binding_context.h"
 #include "aethermind/shape_inference/shape_constraint_evaluator.h"
 
+#include <optional>
+
 namespace aethermind {
 namespace {
 
@@ -25,8 +27,15 @@ Status LayerRunner::Run(const ExecutionPlan& plan,
                         RuntimeBindingContext& bindings) noexcept {
     const auto& steps = plan.steps();
     const auto& alias_plan = plan.state_alias_plan();
+    LayerExecutionObserver* observer = bindings.layer_observer();
+    std::optional<uint32_t> current_layer;
     for (size_t i = 0; i < steps.size(); ++i) {
-        if (const auto status = RunStep(i, steps[i], bindings, alias_plan);
+        if (observer != nullptr && steps[i].decoder_layer_index.has_value() &&
+            steps[i].decoder_layer_index != current_layer) {
+            current_layer = steps[i].decoder_layer_index;
+            observer->OnLayerBegin(*current_layer);
+        }
+        if (const auto status = RunStep(plan.id(), i, steps[i], bindings, alias_plan);
             !status.ok()) {
             return status;
         }
@@ -34,7 +43,8 @@ Status LayerRunner::Run(const ExecutionPlan& plan,
     return Status::Ok();
 }
 
-Status LayerRunner::RunStep(size_t step_index,
+Status LayerRunner::RunStep(uint64_t plan_id,
+                            size_t step_index,
                             const ExecutionStep& step,
                             RuntimeBindingContext& bindings,
                             const StateAliasPlan& alias_plan) noexcept {
@@ -43,7 +53,7 @@ Status LayerRunner::RunStep(size_t step_index,
     }
 
     AM_RETURN_IF_ERROR(ValidateStateAliasesForStep(
-            step_index, step, alias_plan, bindings));
+            step_index, alias_plan, bindings));
 
     const auto workspace_binding = bindings.BindWorkspace(step.workspace_requirement);
     if (!workspace_binding.ok()) {
@@ -54,21 +64,39 @@ Status LayerRunner::RunStep(size_t step_index,
     ctx.workspace_binding = workspace_binding.value();
 
     if (!step.runtime_checks.empty()) {
-        const auto tensor_binding = bindings.GetStepTensorBinding(step_index);
-        if (!tensor_binding.ok()) {
-            return tensor_binding.status();
-        }
-        AM_RETURN_IF_ERROR(ValidateShapeConstraints(step.runtime_checks,
-                                                    (*tensor_binding)->inputs,
-                                                    (*tensor_binding)->outputs));
+        AM_RETURN_IF_ERROR(ValidateRuntimeChecksForStep(plan_id, step_index, step, bindings));
     }
 
     return step.op->Run(ctx, bindings, step_index);
 }
 
+Status LayerRunner::ValidateRuntimeChecksForStep(uint64_t plan_id,
+                                                 size_t step_index,
+                                                 const ExecutionStep& step,
+                                                 RuntimeBindingContext& bindings) noexcept {
+    const auto tensor_binding = bindings.GetStepTensorBinding(step_index);
+    if (!tensor_binding.ok()) {
+        return tensor_binding.status();
+    }
+    const StepTensorBinding& binding = **tensor_binding;
+
+    if (bindings.shape_check_mode() != RuntimeShapeCheckMode::kCached) {
+        return ValidateShapeConstraints(step.runtime_checks, binding.inputs, binding.outputs);
+    }
+
+    ShapeCheckCache& cache = bindings.mutable_shape_check_cache();
+    if (cache.IsVerified(plan_id, step_index, binding.inputs, binding.outputs)) {
+        return Status::Ok();
+    }
+    AM_RETURN_IF_ERROR(ValidateShapeConstraints(step.runtime_checks, binding.inputs, binding.outputs));
+    // Only passing signatures are remembered, so a violation is reported on
+    // every run that repeats it.
+    cache.MarkVerified(plan_id, step_index, binding.inputs, binding.outputs);
+    return Status::Ok();
+}
+
 Status LayerRunner::ValidateStateAliasesForStep(
         size_t step_index,
-        const ExecutionStep& /*step*/,
         const StateAliasPlan& alias_plan,
         const RuntimeBindingContext& bindings) noexcept {
     const auto aliases = alias_plan.ForStep(step_index);
@@ -76,19 +104,35 @@ Status LayerRunner::ValidateStateAliasesForStep(
         return Status::Ok();
     }
 
-    // Phase 1: all state aliases are KV cache updates. The KVCacheView is the
-    // shared physical storage that the operator reads and writes in place, so
-    // its presence is the runtime invariant for must-alias state updates.
-    if (!bindings.HasKVCacheView()) {
-        return Status::InvalidArgument(
-                "State alias requires a valid KVCacheView");
-    }
-
-    // TODO: when non-KV-cache state aliases land (decode/streaming state) or
-    // activation-port aliases are introduced, extend validation here with
-    // StepTensorBinding pointer-comparison checks against aliases[i].
-    // input_port/output_port. The `step` parameter is reserved for that path.
+    for (const ResolvedStateAlias& alias: aliases) {
+        if (alias.kind == StateAliasKind::kKVCache) {
+            // The KVCacheView is the shared physical storage that the operator
+            // reads and writes in place, so its presence is the runtime
+            // invariant for must-alias KV cache updates.
+            if (!bindings.HasKVCacheView()) {
+                return Status::InvalidArgument(
+                        "State alias requires a valid KVCacheView");
+            }
+            continue;
+        }
 
+        // In-place activations: the binding must hand the kernel one buffer
+        // for both ports, otherwise the planned activation arena is violated.
+        const auto tensor_binding = bindings.GetStepTensorBinding(step_index);
+        if (!tensor_binding.ok()) {
+            return tensor_binding.status();
+        }
+        const StepTensorBinding& binding = **tensor_binding;
+        if (alias.input_port >= binding.inputs.size() ||
+            alias.output_port >= binding.outputs.size()) {
+            return Status::InvalidArgument(
+                    "Activation alias port is out of range for the step tensor binding");
+        }
+        if (binding.inputs[alias.input_port].data() != binding.outputs[alias.output_port].data()) {
+            return Status::InvalidArgument(
+                    "Activation alias requires the output to share storage with its input");
+        }
+    }
     return Status::Ok();
 }
 
@@ -0,0 +1,165 @@
+#include "aethermind/execution/layer_weight_streamer.h"
+
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <utility>
+
+namespace aethermind {
+
+LayerWeightStreamer::LayerWeightStreamer(std::vector<std::vector<WeightRange>> layer_ranges,
+                                         LayerWeightStreamerOptions options) noexcept
+    : layer_ranges_(std::move(layer_ranges)),
+      options_(options) {}
+
+LayerWeightStreamer::~LayerWeightStreamer() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+StatusOr<std::unique_ptr<LayerWeightStreamer>> LayerWeightStreamer::Create(
+        const ResolvedModelWeights& weights,
+        LayerWeightStreamerOptions options) {
+    if (weights.NumLayers() == 0) {
+        return Status::InvalidArgument("LayerWeightStreamer requires at least one decoder layer");
+    }
+    if (options.lookahead_layers == 0) {
+        return Status::InvalidArgument("LayerWeightStreamerOptions.lookahead_layers must be non-zero");
+    }
+    options.lookahead_layers = std::min(options.lookahead_layers, weights.NumLayers() - 1);
+
+    std::vector<std::vector<WeightRange>> layer_ranges;
+    layer_ranges.reserve(weights.NumLayers());
+    for (const DecoderLayerRawWeights& layer: weights.layers) {
+        std::vector<WeightRange> ranges;
+        for (const RawWeightView* view: {&layer.norm.input_rmsnorm, &layer.norm.post_attn_rmsnorm,
+                                         &layer.attn.q_proj, &layer.attn.k_proj, &layer.attn.v_proj,
+                                         &layer.attn.o_proj, &layer.mlp.gate_proj, &layer.mlp.up_proj,
+                                         &layer.mlp.down_proj}) {
+            if (view->storage != nullptr && view->data != nullptr && view->bytes > 0) {
+                ranges.push_back(WeightRange{.storage = view->storage, .data = view->data, .bytes = view->bytes});
+            }
+        }
+
+        // Checkpoints store a layer's tensors next to each other; merging
+        // touching ranges turns them into one hint per shard.
+        std::sort(ranges.begin(), ranges.end(), [](const WeightRange& lhs, const WeightRange& rhs) {
+            if (lhs.storage != rhs.storage) {
+                return std::less<>()(lhs.storage.get(), rhs.storage.get());
+            }
+            return std::less<>()(lhs.data, rhs.data);
+        });
+        std::vector<WeightRange> merged;
+        for (auto& range: ranges) {
+            if (!merged.empty() && merged.back().storage == range.storage &&
+                !std::less<>()(merged.back().data + merged.back().bytes, range.data)) {
+                const std::byte* end = std::max(merged.back().data + merged.back().bytes,
+                                                range.data + range.bytes,
+                                                std::less<>());
+                merged.back().bytes = static_cast<size_t>(end - merged.back().data);
+                continue;
+            }
+            merged.push_back(std::move(range));
+        }
+        layer_ranges.push_back(std::move(merged));
+    }
+
+    std::unique_ptr<LayerWeightStreamer> streamer(
+            new LayerWeightStreamer(std::move(layer_ranges), options));
+    streamer->advised_.assign(streamer->num_layers(), false);
+    try {
+        streamer->worker_ = std::thread(&LayerWeightStreamer::WorkerLoop, streamer.get());
+    } catch (const std::system_error& error) {
+        return Status::Internal(std::string("Failed to start the layer weight streamer: ") + error.what());
+    }
+    return streamer;
+}
+
+void LayerWeightStreamer::OnLayerBegin(uint32_t layer_index) noexcept {
+    if (layer_index >= num_layers()) {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        target_layer_ = layer_index;
+        ++requested_generation_;
+    }
+    work_cv_.notify_one();
+}
+
+void LayerWeightStreamer::WaitIdle() {
+    std::unique_lock lock(mutex_);
+    idle_cv_.wait(lock, [this] {
+        return advised_generation_ == requested_generation_;
+    });
+}
+
+Status LayerWeightStreamer::status() const {
+    std::lock_guard lock(mutex_);
+    return first_error_;
+}
+
+void LayerWeightStreamer::WorkerLoop() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this] {
+            return stop_ || advised_generation_ != requested_generation_;
+        });
+        if (stop_) {
+            return;
+        }
+        const uint64_t generation = requested_generation_;
+        const uint32_t layer = target_layer_;
+        lock.unlock();
+        AdviseWindow(layer);
+        lock.lock();
+        advised_generation_ = generation;
+        idle_cv_.notify_all();
+    }
+}
+
+void LayerWeightStreamer::AdviseWindow(uint32_t layer) {
+    const size_t n = num_layers();
+    const auto in_window = [&](size_t candidate) {
+        return (candidate + n - layer) % n <= options_.lookahead_layers;
+    };
+
+    // Evict first so the pages freed can absorb the read-ahead.
+    if (options_.evict_finished_layers) {
+        for (size_t candidate = 0; candidate < n; ++candidate) {
+            if (advised_[candidate] && !in_window(candidate)) {
+                AdviseLayer(candidate, MemoryMappedFile::Advice::kPageOut);
+                advised_[candidate] = false;
+            }
+        }
+    }
+    // The executing layer is already faulting its pages in; hinting it now
+    // would only race the kernels.
+    advised_[layer] = true;
+    for (size_t ahead = 1; ahead <= options_.lookahead_layers; ++ahead) {
+        const size_t next = (layer + ahead) % n;
+        if (!advised_[next]) {
+            AdviseLayer(next, MemoryMappedFile::Advice::kWillNeed);
+            advised_[next] = true;
+        }
+    }
+}
+
+void LayerWeightStreamer::AdviseLayer(size_t layer, MemoryMappedFile::Advice advice) {
+    for (const WeightRange& range: layer_ranges_[layer]) {
+        if (Status status = range.storage->Advise(range.data, range.bytes, advice); !status.ok()) {
+            std::lock_guard lock(mutex_);
+            if (first_error_.ok()) {
+                first_error_ = std::move(status);
+            }
+        }
+    }
+}
+
+}// namespace aethermind
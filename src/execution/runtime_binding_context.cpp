@@ -44,6 +44,10 @@ const KVCacheView& RuntimeBindingContext::kv_cache_view() const noexcept {
     return kv_cache_view_;
 }
 
+KVCacheView& RuntimeBindingContext::mutable_kv_cache_view() noexcept {
+    return kv_cache_view_;
+}
+
 bool RuntimeBindingContext::HasKVCacheView() const noexcept {
     return kv_cache_view_.valid();
 }
@@ -52,6 +56,22 @@ void RuntimeBindingContext::ClearKVCacheView() noexcept {
     kv_cache_view_ = {};
 }
 
+void RuntimeBindingContext::SetDecodeBatchBinding(const DecodeBatchBinding& binding) noexcept {
+    decode_batch_ = binding;
+}
+
+const DecodeBatchBinding& RuntimeBindingContext::decode_batch_binding() const noexcept {
+    return decode_batch_;
+}
+
+bool RuntimeBindingContext::HasDecodeBatchBinding() const noexcept {
+    return decode_batch_.valid();
+}
+
+void RuntimeBindingContext::ClearDecodeBatchBinding() noexcept {
+    decode_batch_ = {};
+}
+
 void RuntimeBindingContext::SetTempBufferBinding(
         TempBufferKind kind,
         const TempBufferBinding& binding) noexcept {
@@ -92,6 +112,8 @@ void RuntimeBindingContext::SetStepTensorBinding(size_t step_index,
     if (step_index >= step_tensor_bindings_.size()) {
         step_tensor_bindings_.resize(step_index + 1);
     }
+    // Sized here, off the execution path, so cached checks never allocate.
+    shape_check_cache_.Reserve(step_index, binding.inputs, binding.outputs);
     step_tensor_bindings_[step_index] = std::move(binding);
 }
 
@@ -110,11 +132,36 @@ StatusOr<const StepTensorBinding*> RuntimeBindingContext::GetStepTensorBinding(s
     return &binding;
 }
 
+void RuntimeBindingContext::SetShapeCheckMode(RuntimeShapeCheckMode mode) noexcept {
+    shape_check_mode_ = mode;
+}
+
+RuntimeShapeCheckMode RuntimeBindingContext::shape_check_mode() const noexcept {
+    return shape_check_mode_;
+}
+
+ShapeCheckCache& RuntimeBindingContext::mutable_shape_check_cache() noexcept {
+    return shape_check_cache_;
+}
+
+const ShapeCheckCache& RuntimeBindingContext::shape_check_cache() const noexcept {
+    return shape_check_cache_;
+}
+
+void RuntimeBindingContext::SetLayerObserver(LayerExecutionObserver* observer) noexcept {
+    layer_observer_ = observer;
+}
+
+LayerExecutionObserver* RuntimeBindingContext::layer_observer() const noexcept {
+    return layer_observer_;
+}
+
 void RuntimeBindingContext::Reset() noexcept {
     if (workspace_arena_ != nullptr) {
         workspace_arena_->Reset();
     }
     ClearKVCacheView();
+    ClearDecodeBatchBinding();
     ClearAllTempBufferBindings();
     ResetSequenceState();
 }
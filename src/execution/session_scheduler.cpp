@@ -0,0 +1,311 @@
+#include "aethermind/execution/session_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace aethermind {
+namespace {
+
+std::string SessionName(uint64_t session_id) {
+    return "Session " + std::to_string(session_id);
+}
+
+}// namespace
+
+SessionScheduler::SessionScheduler(KVCacheManager& manager,
+                                   SessionSchedulerOptions options) noexcept
+    : manager_(&manager), options_(options) {}
+
+SessionScheduler::~SessionScheduler() {
+    for (auto& [id, session]: sessions_) {
+        if (session.phase == SessionPhase::kResuming) {
+            session.prefetch.wait();
+        }
+        if (session.phase != SessionPhase::kWaiting) {
+            (void) manager_->ReleaseSession(session.view);
+        }
+    }
+}
+
+Status SessionScheduler::Submit(const ScheduleRequest& request) {
+    if (sessions_.contains(request.session_id)) {
+        return Status::AlreadyExists(SessionName(request.session_id) + " is already scheduled");
+    }
+    AM_ASSIGN_OR_RETURN(const size_t blocks,
+                        manager_->ProjectedBlocks(request.prompt_len, request.max_new_tokens));
+    if (blocks > manager_->BlockBudget()) {
+        return Status::ResourceExhausted(SessionName(request.session_id) +
+                                         " needs more KV blocks than the cache holds");
+    }
+    sessions_.emplace(request.session_id, Session{
+                                                  .request = request,
+                                                  .projected_blocks = blocks,
+                                                  .arrival = next_arrival_++,
+                                          });
+    return Status::Ok();
+}
+
+StatusOr<SchedulePlan> SessionScheduler::Schedule() {
+    AM_RETURN_IF_ERROR(PollPrefetches());
+
+    SchedulePlan plan;
+    size_t prefilling = 0;
+    for (const Session* session: SessionsIn(SessionPhase::kRunning)) {
+        prefilling += IsPrefilling(*session) ? 1 : 0;
+    }
+    size_t prefill_quota = options_.max_prefills_per_step - std::min(prefilling, options_.max_prefills_per_step);
+
+    std::vector<Session*> candidates = SessionsIn(SessionPhase::kSwapped);
+    std::vector<Session*> waiting = SessionsIn(SessionPhase::kWaiting);
+    candidates.insert(candidates.end(), waiting.begin(), waiting.end());
+    std::ranges::stable_sort(candidates, [](const Session* a, const Session* b) {
+        return a->request.priority > b->request.priority;
+    });
+
+    for (Session* candidate: candidates) {
+        // Swapped sessions already own a slot and resume without prefill.
+        const bool resume = candidate->phase == SessionPhase::kSwapped;
+        if (!resume && prefill_quota == 0) {
+            continue;
+        }
+        const bool need_slot = !resume;
+        const size_t blocks = BlocksToAdmit(*candidate);
+        const auto admissible = [&] {
+            return Fits(blocks) && (!need_slot || manager_->active_sessions() < manager_->num_slots());
+        };
+        if (!admissible()) {
+            AM_RETURN_IF_ERROR(PreemptFor(candidate->request.priority, blocks, need_slot, plan));
+        }
+        // Lower-priority requests must not overtake one that is blocked.
+        if (!admissible()) {
+            break;
+        }
+
+        if (resume) {
+            candidate->prefetch = manager_->PrefetchSession(candidate->view);
+            candidate->phase = SessionPhase::kResuming;
+            reserved_blocks_ += blocks;
+            candidate->pinned_blocks = 0;
+            continue;
+        }
+        const Status admitted = Admit(*candidate);
+        if (admitted.code() == StatusCode::kResourceExhausted) {
+            break;
+        }
+        AM_RETURN_IF_ERROR(admitted);
+        --prefill_quota;
+    }
+
+    for (const Session* session: SessionsIn(SessionPhase::kRunning)) {
+        if (IsDecoding(*session) &&
+            (options_.max_decode_batch == 0 || plan.decode.size() < options_.max_decode_batch)) {
+            plan.decode.push_back(session->request.session_id);
+        } else if (IsPrefilling(*session) && plan.prefill.size() < options_.max_prefills_per_step) {
+            plan.prefill.push_back(session->request.session_id);
+        }
+    }
+    return plan;
+}
+
+Status SessionScheduler::Finish(uint64_t session_id) {
+    const auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return Status::NotFound(SessionName(session_id) + " is not scheduled");
+    }
+    Session& session = it->second;
+    if (session.phase == SessionPhase::kResuming) {
+        session.prefetch.wait();
+    }
+    if (session.phase == SessionPhase::kRunning || session.phase == SessionPhase::kResuming) {
+        reserved_blocks_ -= session.projected_blocks;
+    } else if (session.phase == SessionPhase::kSwapped) {
+        reserved_blocks_ -= session.pinned_blocks;
+    }
+    Status status = Status::Ok();
+    if (session.phase != SessionPhase::kWaiting) {
+        status = manager_->ReleaseSession(session.view);
+    }
+    sessions_.erase(it);
+    return status;
+}
+
+StatusOr<KVCacheView*> SessionScheduler::view(uint64_t session_id) noexcept {
+    const auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return Status::NotFound(SessionName(session_id) + " is not scheduled");
+    }
+    if (it->second.phase != SessionPhase::kRunning) {
+        return Status::FailedPrecondition(SessionName(session_id) + " is not running");
+    }
+    return &it->second.view;
+}
+
+StatusOr<SessionPhase> SessionScheduler::phase(uint64_t session_id) const noexcept {
+    const auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return Status::NotFound(SessionName(session_id) + " is not scheduled");
+    }
+    return it->second.phase;
+}
+
+StatusOr<ScheduleRequest> SessionScheduler::request(uint64_t session_id) const noexcept {
+    const auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return Status::NotFound(SessionName(session_id) + " is not scheduled");
+    }
+    return it->second.request;
+}
+
+size_t SessionScheduler::reserved_blocks() const noexcept {
+    return reserved_blocks_;
+}
+
+size_t SessionScheduler::num_sessions() const noexcept {
+    return sessions_.size();
+}
+
+bool SessionScheduler::Fits(size_t blocks) const noexcept {
+    return reserved_blocks_ + blocks <= manager_->BlockBudget();
+}
+
+size_t SessionScheduler::BlocksToAdmit(const Session& session) noexcept {
+    return session.phase == SessionPhase::kSwapped ? session.projected_blocks - session.pinned_blocks
+                                                   : session.projected_blocks;
+}
+
+void SessionScheduler::Park(Session& session) noexcept {
+    // Blocks shared with the prefix cache are not offloaded and stay mapped;
+    // only the rest of the projection is freed.
+    session.pinned_blocks = std::min(session.view.num_mapped_blocks(), session.projected_blocks);
+    reserved_blocks_ -= session.projected_blocks - session.pinned_blocks;
+    session.phase = SessionPhase::kSwapped;
+}
+
+bool SessionScheduler::PreemptsBySwap(bool need_slot) const noexcept {
+    return options_.preemption == PreemptionMode::kSwap && manager_->disk_offload_enabled() && !need_slot;
+}
+
+size_t SessionScheduler::BlocksFreedBy(const Session& victim, bool need_slot) const noexcept {
+    if (!PreemptsBySwap(need_slot)) {
+        return victim.projected_blocks;
+    }
+    // Mirrors Park(): the blocks still mapped after the offload stay reserved.
+    return victim.projected_blocks - std::min(manager_->SharedBlocks(victim.view), victim.projected_blocks);
+}
+
+bool SessionScheduler::IsPrefilling(const Session& session) const noexcept {
+    return session.view.committed_tokens() < session.request.prompt_len;
+}
+
+bool SessionScheduler::IsDecoding(const Session& session) const noexcept {
+    const size_t committed = session.view.committed_tokens();
+    return committed >= session.request.prompt_len &&
+           committed < session.request.prompt_len + session.request.max_new_tokens;
+}
+
+std::vector<SessionScheduler::Session*> SessionScheduler::SessionsIn(SessionPhase phase) {
+    std::vector<Session*> matching;
+    for (auto& [id, session]: sessions_) {
+        if (session.phase == phase) {
+            matching.push_back(&session);
+        }
+    }
+    std::ranges::sort(matching, [](const Session* a, const Session* b) {
+        if (a->request.priority != b->request.priority) {
+            return a->request.priority > b->request.priority;
+        }
+        return a->arrival < b->arrival;
+    });
+    return matching;
+}
+
+Status SessionScheduler::PollPrefetches() {
+    for (Session* session: SessionsIn(SessionPhase::kResuming)) {
+        if (session->prefetch.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            continue;
+        }
+        const Status status = session->prefetch.get();
+        if (status.ok()) {
+            session->phase = SessionPhase::kRunning;
+            continue;
+        }
+        // Blocks not yet restored stay on disk; the resume is retried later.
+        Park(*session);
+        if (status.code() != StatusCode::kResourceExhausted) {
+            return status;
+        }
+    }
+    return Status::Ok();
+}
+
+Status SessionScheduler::PreemptFor(int32_t priority,
+                                    size_t blocks,
+                                    bool need_slot,
+                                    SchedulePlan& plan) {
+    std::vector<Session*> victims;
+    for (Session* session: SessionsIn(SessionPhase::kRunning)) {
+        if (session->request.priority < priority) {
+            victims.push_back(session);
+        }
+    }
+    // Lowest priority first; within a priority the newest admission, which
+    // has the least progress to lose.
+    std::ranges::reverse(victims);
+
+    // Only the first victim may have to give up its slot; once one is
+    // released the rest are preempted as Preempt() would pick for them.
+    const bool slot_free = manager_->active_sessions() < manager_->num_slots();
+    size_t reclaimable = 0;
+    bool freed_slot = slot_free;
+    for (const Session* victim: victims) {
+        const bool release_slot = need_slot && !freed_slot;
+        reclaimable += BlocksFreedBy(*victim, release_slot);
+        freed_slot = freed_slot || release_slot;
+    }
+    if (!Fits(blocks) && reserved_blocks_ - reclaimable + blocks > manager_->BlockBudget()) {
+        return Status::Ok();
+    }
+    if (need_slot && !slot_free && victims.empty()) {
+        return Status::Ok();
+    }
+
+    for (Session* victim: victims) {
+        const bool slot_ok = !need_slot || manager_->active_sessions() < manager_->num_slots();
+        if (Fits(blocks) && slot_ok) {
+            break;
+        }
+        AM_RETURN_IF_ERROR(Preempt(*victim, need_slot && !slot_ok));
+        plan.preempted.push_back(victim->request.session_id);
+    }
+    return Status::Ok();
+}
+
+Status SessionScheduler::Preempt(Session& victim, bool need_slot) {
+    if (PreemptsBySwap(need_slot)) {
+        AM_RETURN_IF_ERROR(manager_->OffloadSession(victim.view).status());
+        Park(victim);
+        return Status::Ok();
+    }
+    const size_t committed = victim.view.committed_tokens();
+    AM_RETURN_IF_ERROR(manager_->ReleaseSession(victim.view));
+    ScheduleRequest& request = victim.request;
+    if (committed > request.prompt_len) {
+        request.max_new_tokens -= committed - request.prompt_len;
+        request.prompt_len = committed;
+    }
+    victim.phase = SessionPhase::kWaiting;
+    reserved_blocks_ -= victim.projected_blocks;
+    return Status::Ok();
+}
+
+Status SessionScheduler::Admit(Session& session) {
+    AM_ASSIGN_OR_RETURN(session.view,
+                        manager_->ReserveForChunkedPrefill(session.request.prompt_len,
+                                                           session.request.max_new_tokens));
+    session.phase = SessionPhase::kRunning;
+    reserved_blocks_ += session.projected_blocks;
+    return Status::Ok();
+}
+
+}// namespace aethermind
@@ -0,0 +1,136 @@
+#include "aethermind/execution/shape_check_cache.h"
+
+#include <algorithm>
+
+namespace aethermind {
+namespace {
+
+// Signature layout: [num_inputs, num_outputs, rank, dims..., rank, dims...].
+// The leading counts and per-tensor ranks make the encoding unambiguous.
+template<typename View>
+size_t TensorsLength(std::span<const View> tensors) noexcept {
+    size_t length = 0;
+    for (const View& tensor: tensors) {
+        length += 1 + tensor.shape().size();
+    }
+    return length;
+}
+
+size_t SignatureLength(std::span<const TensorView> inputs,
+                       std::span<const MutableTensorView> outputs) noexcept {
+    return 2 + TensorsLength(inputs) + TensorsLength(outputs);
+}
+
+template<typename View>
+bool MatchTensors(std::span<const View> tensors, const int64_t* signature, size_t& pos) noexcept {
+    for (const View& tensor: tensors) {
+        const IntArrayView shape = tensor.shape();
+        if (signature[pos] != static_cast<int64_t>(shape.size())) {
+            return false;
+        }
+        ++pos;
+        if (!std::equal(shape.begin(), shape.end(), signature + pos)) {
+            return false;
+        }
+        pos += shape.size();
+    }
+    return true;
+}
+
+template<typename View>
+void WriteTensors(std::span<const View> tensors, int64_t* signature, size_t& pos) noexcept {
+    for (const View& tensor: tensors) {
+        const IntArrayView shape = tensor.shape();
+        signature[pos++] = static_cast<int64_t>(shape.size());
+        std::copy(shape.begin(), shape.end(), signature + pos);
+        pos += shape.size();
+    }
+}
+
+}// namespace
+
+void ShapeCheckCache::Reserve(size_t step_index,
+                              std::span<const TensorView> inputs,
+                              std::span<const MutableTensorView> outputs) {
+    if (step_index >= steps_.size()) {
+        steps_.resize(step_index + 1);
+    }
+    const size_t length = SignatureLength(inputs, outputs);
+    for (Way& way: steps_[step_index].ways) {
+        if (way.signature.size() < length) {
+            way.signature.resize(length);
+        }
+    }
+}
+
+bool ShapeCheckCache::IsVerified(uint64_t plan_id,
+                                 size_t step_index,
+                                 std::span<const TensorView> inputs,
+                                 std::span<const MutableTensorView> outputs) noexcept {
+    if (step_index < steps_.size()) {
+        // A signature's length is fixed by the counts and ranks it encodes,
+        // so comparing lengths first rules out reading past a stored one.
+        const size_t length = SignatureLength(inputs, outputs);
+        for (const Way& way: steps_[step_index].ways) {
+            if (way.length != length || way.plan_id != plan_id) {
+                continue;
+            }
+            const int64_t* signature = way.signature.data();
+            size_t pos = 2;
+            if (signature[0] == static_cast<int64_t>(inputs.size()) &&
+                signature[1] == static_cast<int64_t>(outputs.size()) &&
+                MatchTensors(inputs, signature, pos) && MatchTensors(outputs, signature, pos)) {
+                ++hits_;
+                return true;
+            }
+        }
+    }
+    ++misses_;
+    return false;
+}
+
+void ShapeCheckCache::MarkVerified(uint64_t plan_id,
+                                   size_t step_index,
+                                   std::span<const TensorView> inputs,
+                                   std::span<const MutableTensorView> outputs) noexcept {
+    if (step_index >= steps_.size()) {
+        return;
+    }
+    StepEntry& entry = steps_[step_index];
+    Way& way = entry.ways[entry.next];
+    const size_t length = SignatureLength(inputs, outputs);
+    if (way.signature.size() < length) {
+        return;
+    }
+    entry.next = (entry.next + 1) % kWays;
+
+    int64_t* signature = way.signature.data();
+    signature[0] = static_cast<int64_t>(inputs.size());
+    signature[1] = static_cast<int64_t>(outputs.size());
+    size_t pos = 2;
+    WriteTensors(inputs, signature, pos);
+    WriteTensors(outputs, signature, pos);
+    way.plan_id = plan_id;
+    way.length = length;
+}
+
+void ShapeCheckCache::Clear() noexcept {
+    for (StepEntry& entry: steps_) {
+        for (Way& way: entry.ways) {
+            way.length = 0;
+        }
+        entry.next = 0;
+    }
+    hits_ = 0;
+    misses_ = 0;
+}
+
+size_t ShapeCheckCache::hit_count() const noexcept {
+    return hits_;
+}
+
+size_t ShapeCheckCache::miss_count() const noexcept {
+    return misses_;
+}
+
+}// namespace aethermind
@@ -0,0 +1,256 @@
+#include "aethermind/graph/compilation/activation_planner.h"
+#include "aethermind/operators/operator_schema.h"
+#include "aethermind/runtime/workspace.h"
+#include "utils/overflow_check.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace aethermind {
+namespace {
+
+constexpr size_t kNoStep = std::numeric_limits<size_t>::max();
+
+// How one graph value is produced and consumed by the lowered steps.
+struct ValueUse {
+    size_t producer_step = kNoStep;
+    size_t last_use_step = kNoStep;
+    bool model_output = false;
+    bool kv_cache_state = false;
+    bool in_place_input = false;
+    bool in_place_output = false;
+};
+
+size_t CountValues(const LoweredGraph& lowered) noexcept {
+    uint32_t max_index = 0;
+    const auto visit = [&](GraphValueId value) noexcept {
+        max_index = std::max(max_index, value.index);
+    };
+    for (const LoweredStepBinding& binding: lowered.step_bindings) {
+        std::ranges::for_each(binding.input_values, visit);
+        std::ranges::for_each(binding.output_values, visit);
+    }
+    std::ranges::for_each(lowered.model_inputs, visit);
+    std::ranges::for_each(lowered.model_outputs, visit);
+    for (const LoweredStateAlias& alias: lowered.state_aliases) {
+        visit(alias.input);
+        visit(alias.output);
+    }
+    return static_cast<size_t>(max_index) + 1;
+}
+
+StatusOr<std::vector<ValueUse>> AnalyzeValueUses(const LoweredGraph& lowered) {
+    if (lowered.step_bindings.size() != lowered.steps.size()) {
+        return Status::InvalidArgument(
+                "Activation planning requires one step binding per lowered step");
+    }
+
+    std::vector<ValueUse> uses(CountValues(lowered));
+    for (size_t s = 0; s < lowered.step_bindings.size(); ++s) {
+        const LoweredStepBinding& binding = lowered.step_bindings[s];
+        for (const GraphValueId value: binding.input_values) {
+            uses[value.index].last_use_step = s;
+        }
+        for (const GraphValueId value: binding.output_values) {
+            uses[value.index].producer_step = s;
+        }
+    }
+    for (const GraphValueId value: lowered.model_outputs) {
+        uses[value.index].model_output = true;
+    }
+    for (const LoweredStateAlias& alias: lowered.state_aliases) {
+        if (alias.kind == StateAliasKind::kActivation) {
+            uses[alias.input.index].in_place_input = true;
+            uses[alias.output.index].in_place_output = true;
+        } else {
+            uses[alias.input.index].kv_cache_state = true;
+            uses[alias.output.index].kv_cache_state = true;
+        }
+    }
+    return uses;
+}
+
+std::optional<uint32_t> FindActivationOutputPort(const OperatorSchema& schema) noexcept {
+    for (const OperatorOutputPort& port: schema.output_ports) {
+        if (port.kind == OperatorPortKind::kActivation) {
+            return port.index;
+        }
+    }
+    return std::nullopt;
+}
+
+StatusOr<int64_t> ResolveDimUpperBound(const ShapeSymbol& dim,
+                                       const ActivationPlannerConfig& config) {
+    if (dim.IsStatic()) {
+        return dim.GetStaticValue();
+    }
+    if (dim.IsSymbolic()) {
+        for (const ActivationSymbolBound& bound: config.symbol_bounds) {
+            if (bound.symbol == dim && bound.max_value >= 0) {
+                return bound.max_value;
+            }
+        }
+    }
+    return Status::InvalidArgument(
+            "Activation planning requires a static size or symbol bound for every dimension");
+}
+
+StatusOr<size_t> CountActivationBytes(const TensorSpec& spec,
+                                      const ActivationPlannerConfig& config) {
+    if (!spec.shape.IsRanked()) {
+        return Status::InvalidArgument("Activation planning requires ranked activations");
+    }
+    if (spec.dtype.nbytes() <= 0) {
+        return Status::InvalidArgument("Activation planning requires a sized dtype");
+    }
+
+    size_t bytes = static_cast<size_t>(spec.dtype.nbytes());
+    for (const ShapeSymbol& dim: spec.shape) {
+        AM_ASSIGN_OR_RETURN(const int64_t extent, ResolveDimUpperBound(dim, config));
+        if (CheckOverflowMul(bytes, static_cast<size_t>(extent), &bytes)) {
+            return Status::Overflow("Activation byte size overflowed size_t");
+        }
+    }
+    return bytes;
+}
+
+}// namespace
+
+Status AddInPlaceActivationAliases(LoweredGraph& lowered) {
+    AM_ASSIGN_OR_RETURN(std::vector<ValueUse> uses, AnalyzeValueUses(lowered));
+
+    for (size_t s = 0; s < lowered.steps.size(); ++s) {
+        const ExecutionPlanNodeSpec& step = lowered.steps[s];
+        const LoweredStepBinding& binding = lowered.step_bindings[s];
+        AM_ASSIGN_OR_RETURN(const OperatorSchema schema, GetOperatorSchema(step.op_type));
+        if (!SupportsInPlaceActivation(schema)) {
+            continue;
+        }
+
+        const std::optional<uint32_t> output_port = FindActivationOutputPort(schema);
+        if (!output_port.has_value() || *output_port >= binding.output_values.size() ||
+            *output_port >= step.output_specs.size()) {
+            continue;
+        }
+        const GraphValueId output = binding.output_values[*output_port];
+        if (uses[output.index].in_place_output) {
+            continue;
+        }
+
+        for (const OperatorInputPort& port: schema.input_ports) {
+            if (port.kind != OperatorPortKind::kActivation ||
+                port.index >= binding.input_values.size() ||
+                port.index >= step.input_specs.size()) {
+                continue;
+            }
+
+            const GraphValueId input = binding.input_values[port.index];
+            ValueUse& use = uses[input.index];
+            if (use.producer_step == kNoStep || use.producer_step >= s ||
+                use.last_use_step != s || use.model_output || use.kv_cache_state ||
+                use.in_place_input) {
+                continue;
+            }
+            // Broadcast inputs or dtype changes cannot share the output slice.
+            if (step.input_specs[port.index] != step.output_specs[*output_port]) {
+                continue;
+            }
+
+            lowered.state_aliases.push_back(LoweredStateAlias{
+                    .input = input,
+                    .output = output,
+                    .kind = StateAliasKind::kActivation,
+            });
+            use.in_place_input = true;
+            uses[output.index].in_place_output = true;
+            break;
+        }
+    }
+    return Status::Ok();
+}
+
+StatusOr<ActivationPlan> PlanActivationBuffers(const LoweredGraph& lowered,
+                                               const ActivationPlannerConfig& config) {
+    if (!IsValidWorkspaceAlignment(config.alignment)) {
+        return Status::InvalidArgument(
+                "Activation alignment must be a non-zero power of two");
+    }
+    AM_ASSIGN_OR_RETURN(const std::vector<ValueUse> uses, AnalyzeValueUses(lowered));
+
+    std::vector<std::optional<GraphValueId>> in_place_source(uses.size());
+    for (const LoweredStateAlias& alias: lowered.state_aliases) {
+        if (alias.kind == StateAliasKind::kActivation) {
+            in_place_source[alias.output.index] = alias.input;
+        }
+    }
+
+    const size_t last_step = lowered.steps.empty() ? 0 : lowered.steps.size() - 1;
+    constexpr size_t kNoBuffer = std::numeric_limits<size_t>::max();
+    std::vector<size_t> buffer_of(uses.size(), kNoBuffer);
+    std::vector<WorkspaceRequirement> buffers;
+    std::vector<WorkspaceLiveRange> ranges;
+    std::vector<WorkspaceRequirement> naive;
+    std::vector<size_t> activation_buffer;
+
+    ActivationPlan plan;
+    for (size_t s = 0; s < lowered.steps.size(); ++s) {
+        const ExecutionPlanNodeSpec& step = lowered.steps[s];
+        const LoweredStepBinding& binding = lowered.step_bindings[s];
+        AM_ASSIGN_OR_RETURN(const OperatorSchema schema, GetOperatorSchema(step.op_type));
+
+        for (const OperatorOutputPort& port: schema.output_ports) {
+            if (port.kind != OperatorPortKind::kActivation ||
+                port.index >= binding.output_values.size() ||
+                port.index >= step.output_specs.size()) {
+                continue;
+            }
+
+            const GraphValueId value = binding.output_values[port.index];
+            const ValueUse& use = uses[value.index];
+            AM_ASSIGN_OR_RETURN(const size_t bytes,
+                                CountActivationBytes(step.output_specs[port.index], config));
+            const size_t end = use.model_output
+                                       ? last_step
+                                       : std::max(s, use.last_use_step == kNoStep ? s : use.last_use_step);
+
+            size_t buffer = kNoBuffer;
+            if (const auto& source = in_place_source[value.index]; source.has_value()) {
+                buffer = buffer_of[source->index];
+            }
+            if (buffer == kNoBuffer) {
+                buffer = buffers.size();
+                buffers.push_back({.bytes = bytes, .alignment = config.alignment});
+                ranges.push_back({.first_step = s, .last_step = end});
+            } else {
+                // The output overwrites its dead input, so the input's slice
+                // stays live until the output's last consumer.
+                buffers[buffer].bytes = std::max(buffers[buffer].bytes, bytes);
+                ranges[buffer].last_step = std::max(ranges[buffer].last_step, end);
+            }
+
+            buffer_of[value.index] = buffer;
+            activation_buffer.push_back(buffer);
+            naive.push_back({.bytes = bytes, .alignment = config.alignment});
+            plan.activations.push_back({.producer_step = s,
+                                        .output_port = port.index,
+                                        .bytes = bytes});
+        }
+    }
+
+    AM_ASSIGN_OR_RETURN(const WorkspacePlanLayout layout,
+                        PlanWorkspaceRequirementsForLiveRanges(buffers, ranges));
+    AM_ASSIGN_OR_RETURN(const WorkspacePlanLayout naive_layout,
+                        PlanWorkspaceRequirements(naive));
+
+    for (size_t i = 0; i < plan.activations.size(); ++i) {
+        plan.activations[i].offset = buffers[activation_buffer[i]].offset;
+    }
+    plan.total_bytes = layout.total_bytes;
+    plan.naive_total_bytes = naive_layout.total_bytes;
+    plan.required_alignment = config.alignment;
+    return plan;
+}
+
+}// namespace aethermind
@@ -1,4 +1,5 @@
 #include "aethermind/graph/compilation/graph_lowering.h"
+#include "aethermind/graph/compilation/activation_planner.h"
 #include "aethermind/operators/operator_schema.h"
 #include "utils/variant_utils.h"
 
@@ -109,11 +110,12 @@ StatusOr<LoweredGraph> LowerModelGraph(const ModelGraph& graph,
                 .weight_format = config.weight_format,
                 .isa = config.isa,
                 .phase = config.phase,
+                .decoder_layer_index = node.decoder_layer_index,
                 .attrs = node.attrs.bytes,
                 .op_params = node.op_params,
         };
 
-        LoweredStepBinding binding{.node = node_id};
+        LoweredStepBinding binding{.node = node_id, .decoder_layer_index = node.decoder_layer_index};
         binding.input_values.reserve(node.inputs.size());
         binding.output_values.reserve(node.outputs.size());
         step.output_specs.reserve(schema.output_ports.size());
@@ -138,6 +140,12 @@ StatusOr<LoweredGraph> LowerModelGraph(const ModelGraph& graph,
                                                    .binding = cv.binding,
                                            });
                                },
+                               [&](const WeightValue& wv) {
+                                   if (const auto* role = std::get_if<TransformerWeightRole>(
+                                               &wv.binding.semantic_role)) {
+                                       step.weight_role = *role;
+                                   }
+                               },
                                [](const auto&) {},
                        },
                        value.payload);
@@ -159,6 +167,10 @@ StatusOr<LoweredGraph> LowerModelGraph(const ModelGraph& graph,
         lowered.step_bindings.push_back(std::move(binding));
     }
 
+    if (config.in_place_activations) {
+        AM_RETURN_IF_ERROR(AddInPlaceActivationAliases(lowered));
+    }
+
     return lowered;
 }
 
@@ -180,6 +192,7 @@ StatusOr<StateAliasPlan> ResolveStateAliases(const LoweredGraph& lowered) {
                         .step_index = s,
                         .input_port = static_cast<uint32_t>(input_it - binding.input_values.begin()),
                         .output_port = static_cast<uint32_t>(output_it - binding.output_values.begin()),
+                        .kind = alias.kind,
                 });
                 found = true;
                 break;
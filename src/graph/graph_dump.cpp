@@ -276,6 +276,12 @@ void DumpOpParams(const OpParams& params, std::ostream& os) {
             [&](const ReorderParams&) {
                 DumpEmptyParams("ReorderParams", os);
             },
+            [&](const SampleParams& p) {
+                os << "SampleParams{temperature=" << p.temperature
+                   << ", top_k=" << p.top_k
+                   << ", top_p=" << p.top_p
+                   << ", seed=" << p.seed << '}';
+            },
     };
     std::visit(visitor, params);
 }
@@ -346,6 +346,24 @@ StatusOr<GraphValueId> AddArgmax(ModelGraph& graph,
     return OnlyOneOutput(node);
 }
 
+StatusOr<GraphValueId> AddSample(ModelGraph& graph,
+                                 std::optional<uint32_t> decoder_layer_index,
+                                 GraphValueId input,
+                                 const SampleParams& params,
+                                 std::string name) {
+    // Output desc is built first for the same reason as in AddArgmax.
+    NodeOutputDesc output_desc{.payload = ActivationValue{}, .name = name};
+    AM_ASSIGN_OR_RETURN(AddedNode node,
+                        graph.AddNode(OpType::kSample,
+                                      decoder_layer_index,
+                                      {input},
+                                      {std::move(output_desc)},
+                                      params,
+                                      {},
+                                      std::move(name)));
+    return OnlyOneOutput(node);
+}
+
 StatusOr<GraphValueId> AddReshape(ModelGraph& graph,
                                   std::optional<uint32_t> decoder_layer_index,
                                   GraphValueId input,
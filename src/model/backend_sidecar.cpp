@@ -1,5 +1,7 @@
 #include "aethermind/model/backend_sidecar.h"
 
+#include <string>
+
 namespace aethermind {
 
 Status BackendSidecar::Store(std::unique_ptr<PackedWeights> packed_weights) noexcept {
@@ -7,7 +9,9 @@ Status BackendSidecar::Store(std::unique_ptr<PackedWeights> packed_weights) noex
         return Status::InvalidArgument("BackendSidecar cannot store null packed weights");
     }
 
-    if (Find(packed_weights->op_type(), packed_weights->selector()) != nullptr) {
+    const auto [it, inserted] = by_selector_.try_emplace(
+            RegistrationKey{packed_weights->op_type(), packed_weights->selector()}, packed_weights.get());
+    if (!inserted) {
         return Status::AlreadyExists(
                 "Packed weights already exist for the requested op/selector");
     }
@@ -16,15 +20,57 @@ Status BackendSidecar::Store(std::unique_ptr<PackedWeights> packed_weights) noex
     return Status::Ok();
 }
 
+Status BackendSidecar::Store(std::optional<uint32_t> decoder_layer_index,
+                             WeightRole role,
+                             std::unique_ptr<PackedWeights> packed_weights) noexcept {
+    if (packed_weights == nullptr) {
+        return Status::InvalidArgument("BackendSidecar cannot store null packed weights");
+    }
+    if ((role == WeightRole::kLmHead) == decoder_layer_index.has_value()) {
+        return Status::InvalidArgument(std::string("Packed ") + ToString(role) +
+                                       (decoder_layer_index.has_value() ? " cannot have" : " needs") +
+                                       " a decoder layer");
+    }
+
+    const PackedWeights** slot = &lm_head_;
+    if (decoder_layer_index.has_value()) {
+        const size_t index = *decoder_layer_index * kLayerRoles + static_cast<size_t>(role);
+        if (index >= layer_weights_.size()) {
+            layer_weights_.resize((*decoder_layer_index + 1) * kLayerRoles, nullptr);
+        }
+        slot = &layer_weights_[index];
+    }
+    if (*slot != nullptr) {
+        return Status::AlreadyExists(std::string("Packed weights already exist for ") + ToString(role) +
+                                     (decoder_layer_index.has_value()
+                                              ? " of layer " + std::to_string(*decoder_layer_index)
+                                              : std::string()));
+    }
+
+    *slot = packed_weights.get();
+    by_selector_.try_emplace(RegistrationKey{packed_weights->op_type(), packed_weights->selector()},
+                             packed_weights.get());
+    packed_weights_.push_back(std::move(packed_weights));
+    return Status::Ok();
+}
+
 const PackedWeights* BackendSidecar::Find(
         OpType op_type,
         const KernelSelector& selector) const noexcept {
-    for (const auto& packed_weights: packed_weights_) {
-        if (packed_weights->op_type() == op_type && packed_weights->selector() == selector) {
-            return packed_weights.get();
-        }
+    const auto it = by_selector_.find(RegistrationKey{op_type, selector});
+    return it == by_selector_.end() ? nullptr : it->second;
+}
+
+const PackedWeights* BackendSidecar::Find(std::optional<uint32_t> decoder_layer_index,
+                                          WeightRole role) const noexcept {
+    if (!decoder_layer_index.has_value()) {
+        return role == WeightRole::kLmHead ? lm_head_ : nullptr;
+    }
+    if (role == WeightRole::kLmHead) {
+        return nullptr;
     }
-    return nullptr;
+    const size_t index = *decoder_layer_index * kLayerRoles + static_cast<size_t>(role);
+    return index < layer_weights_.size() ? layer_weights_[index] : nullptr;
 }
 
 }// namespace aethermind
@@ -0,0 +1,771 @@
+#include "aethermind/model/formats/gguf/gguf_reader.h"
+#include "aethermind/base/mmap_file.h"
+#include "aethermind/dtypes/half.h"
+#include "aethermind/model/formats/hf/hf_utils.h"
+#include "utils/hash.h"
+#include "utils/overflow_check.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Implements the GGUF front-end. The whole file is mapped once; the header,
+// metadata and tensor table are parsed eagerly so a malformed checkpoint is
+// rejected by Open, and tensors are handed out as views into the mapping.
+namespace aethermind {
+namespace {
+
+// "GGUF" read as a little-endian u32.
+constexpr uint32_t kGgufMagic = 0x46554747;
+constexpr uint64_t kDefaultAlignment = 32;
+constexpr uint32_t kMaxTensorDims = 4;
+// Folded into the fingerprint; bump it when the views LoadRawWeightTable
+// hands out change, so packed-weight caches built from older ones miss.
+constexpr uint64_t kLoadRevision = 2;
+
+class MappedGgufStorage final : public RawStorage {
+public:
+    explicit MappedGgufStorage(MemoryMappedFile mmap) noexcept
+        : mmap_(std::move(mmap)) {}
+
+    AM_NODISCARD const std::byte* data() const noexcept {
+        return mmap_.ByteData();
+    }
+
+    AM_NODISCARD size_t size() const noexcept {
+        return mmap_.size();
+    }
+
+    AM_NODISCARD Status Advise(const std::byte* data,
+                               size_t bytes,
+                               MemoryMappedFile::Advice advice) const override {
+        const std::byte* begin = mmap_.ByteData();
+        if (std::less<>()(data, begin) || std::less<>()(begin + mmap_.size(), data)) {
+            return Status::InvalidArgument("Advised range is outside the GGUF mapping");
+        }
+        return mmap_.AdviseRange(static_cast<size_t>(data - begin), bytes, advice);
+    }
+
+private:
+    // As with safetensors, the file must not be truncated while mapped.
+    MemoryMappedFile mmap_;
+};
+
+// Heap copy of a tensor the reader decodes at load instead of viewing the
+// mapping.
+class DecodedGgufStorage final : public RawStorage {
+public:
+    explicit DecodedGgufStorage(size_t num_elements) : values_(num_elements) {}
+
+    AM_NODISCARD float* data() noexcept {
+        return values_.data();
+    }
+
+private:
+    std::vector<float> values_;
+};
+
+// Expands Q8_0/Q4_0 blocks into float32 values; `view` must be a rank-2
+// block-quantized view whose size the parser already checked.
+RawWeightView DequantizeBlocks(const RawWeightView& view) {
+    const auto rows = static_cast<size_t>(view.shape[0]);
+    const auto cols = static_cast<size_t>(view.shape[1]);
+    const size_t block_bytes = RawWeightBlockBytes(view.encoding);
+    auto storage = std::make_shared<DecodedGgufStorage>(rows * cols);
+    float* dst = storage->data();
+    const std::byte* block = view.data;
+    for (size_t i = 0; i < rows * cols; i += kRawWeightBlockSize, block += block_bytes) {
+        const auto scale_bits = static_cast<uint16_t>(std::to_integer<uint16_t>(block[0]) |
+                                                      std::to_integer<uint16_t>(block[1]) << 8U);
+        const auto scale = static_cast<float>(Half(scale_bits, Half::from_bits()));
+        const std::byte* levels = block + sizeof(uint16_t);
+        for (size_t j = 0; j < kRawWeightBlockSize; ++j) {
+            int level = 0;
+            if (view.encoding == RawWeightEncoding::kGgmlQ8_0) {
+                level = static_cast<int8_t>(std::to_integer<uint8_t>(levels[j]));
+            } else {
+                const auto packed = std::to_integer<uint8_t>(levels[j % (kRawWeightBlockSize / 2)]);
+                level = (j < kRawWeightBlockSize / 2 ? packed & 0x0F : packed >> 4) - 8;
+            }
+            dst[i + j] = scale * static_cast<float>(level);
+        }
+    }
+    return RawWeightView{
+            .data = reinterpret_cast<const std::byte*>(dst),
+            .bytes = rows * cols * sizeof(float),
+            .dtype = DataType::Float32(),
+            .shape = view.shape,
+            .storage = std::move(storage),
+    };
+}
+
+// Bounds-checked little-endian reads over the mapped header.
+class GgufCursor {
+public:
+    GgufCursor(const std::byte* data, size_t size) noexcept
+        : data_(data), size_(size) {}
+
+    AM_NODISCARD size_t offset() const noexcept {
+        return offset_;
+    }
+
+    AM_NODISCARD size_t remaining() const noexcept {
+        return size_ - offset_;
+    }
+
+    StatusOr<uint64_t> ReadUnsigned(size_t width) {
+        if (remaining() < width) {
+            return Truncated();
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < width; ++i) {
+            value |= static_cast<uint64_t>(std::to_integer<uint8_t>(data_[offset_ + i])) << (i * 8U);
+        }
+        offset_ += width;
+        return value;
+    }
+
+    StatusOr<std::string> ReadString() {
+        AM_ASSIGN_OR_RETURN(const uint64_t length, ReadUnsigned(sizeof(uint64_t)));
+        if (length > remaining()) {
+            return Truncated();
+        }
+        std::string value(reinterpret_cast<const char*>(data_ + offset_), static_cast<size_t>(length));
+        offset_ += static_cast<size_t>(length);
+        return value;
+    }
+
+    Status Skip(uint64_t bytes) {
+        if (bytes > remaining()) {
+            return Truncated();
+        }
+        offset_ += static_cast<size_t>(bytes);
+        return Status::Ok();
+    }
+
+    AM_NODISCARD Status Truncated() const {
+        return Status::InvalidArgument("GGUF file is truncated at byte " + std::to_string(offset_));
+    }
+
+private:
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+};
+
+// Byte width of a fixed-size value type, or 0 for strings, arrays and
+// unknown ids.
+size_t ScalarWidth(GgufValueType type) noexcept {
+    switch (type) {
+        case GgufValueType::kUInt8:
+        case GgufValueType::kInt8:
+        case GgufValueType::kBool:
+            return 1;
+        case GgufValueType::kUInt16:
+        case GgufValueType::kInt16:
+            return 2;
+        case GgufValueType::kUInt32:
+        case GgufValueType::kInt32:
+        case GgufValueType::kFloat32:
+            return 4;
+        case GgufValueType::kUInt64:
+        case GgufValueType::kInt64:
+        case GgufValueType::kFloat64:
+            return 8;
+        case GgufValueType::kString:
+        case GgufValueType::kArray:
+            return 0;
+    }
+    return 0;
+}
+
+bool IsKnownValueType(uint32_t id) noexcept {
+    return id <= static_cast<uint32_t>(GgufValueType::kFloat64);
+}
+
+StatusOr<GgufValueType> ReadValueType(GgufCursor& cursor) {
+    AM_ASSIGN_OR_RETURN(const uint64_t id, cursor.ReadUnsigned(sizeof(uint32_t)));
+    if (!IsKnownValueType(static_cast<uint32_t>(id))) {
+        return Status::InvalidArgument("GGUF metadata has unknown value type " + std::to_string(id));
+    }
+    return static_cast<GgufValueType>(id);
+}
+
+Status SkipValue(GgufCursor& cursor, GgufValueType type, uint32_t depth);
+
+Status SkipArray(GgufCursor& cursor, uint32_t depth) {
+    if (depth > 8) {
+        return Status::InvalidArgument("GGUF metadata arrays are nested too deeply");
+    }
+    AM_ASSIGN_OR_RETURN(const GgufValueType element_type, ReadValueType(cursor));
+    AM_ASSIGN_OR_RETURN(const uint64_t length, cursor.ReadUnsigned(sizeof(uint64_t)));
+    if (const size_t width = ScalarWidth(element_type); width > 0) {
+        uint64_t bytes = 0;
+        if (CheckOverflowMul(length, static_cast<uint64_t>(width), &bytes)) {
+            return cursor.Truncated();
+        }
+        return cursor.Skip(bytes);
+    }
+    // Every string or nested array takes at least 8 bytes, which bounds the
+    // loop by the file size rather than by an untrusted length.
+    if (length > cursor.remaining() / sizeof(uint64_t)) {
+        return cursor.Truncated();
+    }
+    for (uint64_t i = 0; i < length; ++i) {
+        AM_RETURN_IF_ERROR(SkipValue(cursor, element_type, depth + 1));
+    }
+    return Status::Ok();
+}
+
+Status SkipValue(GgufCursor& cursor, GgufValueType type, uint32_t depth) {
+    if (type == GgufValueType::kArray) {
+        return SkipArray(cursor, depth);
+    }
+    if (type == GgufValueType::kString) {
+        AM_ASSIGN_OR_RETURN(const uint64_t length, cursor.ReadUnsigned(sizeof(uint64_t)));
+        return cursor.Skip(length);
+    }
+    return cursor.Skip(ScalarWidth(type));
+}
+
+StatusOr<GgufMetadataValue> ReadValue(GgufCursor& cursor, GgufValueType type) {
+    GgufMetadataValue value{.type = type};
+    switch (type) {
+        case GgufValueType::kString: {
+            AM_ASSIGN_OR_RETURN(value.scalar, cursor.ReadString());
+            return value;
+        }
+        case GgufValueType::kArray: {
+            GgufCursor header = cursor;
+            AM_ASSIGN_OR_RETURN(value.array_type, ReadValueType(header));
+            AM_ASSIGN_OR_RETURN(value.array_length, header.ReadUnsigned(sizeof(uint64_t)));
+            AM_RETURN_IF_ERROR(SkipArray(cursor, 0));
+            return value;
+        }
+        default:
+            break;
+    }
+
+    const size_t width = ScalarWidth(type);
+    AM_ASSIGN_OR_RETURN(const uint64_t raw, cursor.ReadUnsigned(width));
+    switch (type) {
+        case GgufValueType::kInt8:
+        case GgufValueType::kInt16:
+        case GgufValueType::kInt32:
+        case GgufValueType::kInt64: {
+            const unsigned shift = 64U - static_cast<unsigned>(width) * 8U;
+            value.scalar = static_cast<int64_t>(raw << shift) >> shift;
+            break;
+        }
+        case GgufValueType::kFloat32:
+            value.scalar = static_cast<double>(std::bit_cast<float>(static_cast<uint32_t>(raw)));
+            break;
+        case GgufValueType::kFloat64:
+            value.scalar = std::bit_cast<double>(raw);
+            break;
+        case GgufValueType::kBool:
+            value.scalar = raw != 0;
+            break;
+        default:
+            value.scalar = raw;
+            break;
+    }
+    return value;
+}
+
+struct TensorTypeTraits {
+    size_t block_size = 1;
+    size_t block_bytes = 0;
+};
+
+std::optional<TensorTypeTraits> GetTensorTypeTraits(uint32_t id) noexcept {
+    switch (static_cast<GgufTensorType>(id)) {
+        case GgufTensorType::kF32:
+            return TensorTypeTraits{1, 4};
+        case GgufTensorType::kF16:
+        case GgufTensorType::kBF16:
+            return TensorTypeTraits{1, 2};
+        case GgufTensorType::kQ4_0:
+            return TensorTypeTraits{32, 18};
+        case GgufTensorType::kQ4_1:
+            return TensorTypeTraits{32, 20};
+        case GgufTensorType::kQ5_0:
+            return TensorTypeTraits{32, 22};
+        case GgufTensorType::kQ5_1:
+            return TensorTypeTraits{32, 24};
+        case GgufTensorType::kQ8_0:
+            return TensorTypeTraits{32, 34};
+        case GgufTensorType::kQ8_1:
+            return TensorTypeTraits{32, 36};
+        case GgufTensorType::kQ2_K:
+            return TensorTypeTraits{256, 84};
+        case GgufTensorType::kQ3_K:
+            return TensorTypeTraits{256, 110};
+        case GgufTensorType::kQ4_K:
+            return TensorTypeTraits{256, 144};
+        case GgufTensorType::kQ5_K:
+            return TensorTypeTraits{256, 176};
+        case GgufTensorType::kQ6_K:
+            return TensorTypeTraits{256, 210};
+        case GgufTensorType::kQ8_K:
+            return TensorTypeTraits{256, 292};
+    }
+    return std::nullopt;
+}
+
+StatusOr<GgufTensorInfo> ReadTensorInfo(GgufCursor& cursor) {
+    GgufTensorInfo info;
+    AM_ASSIGN_OR_RETURN(info.name, cursor.ReadString());
+    AM_ASSIGN_OR_RETURN(const uint64_t num_dims, cursor.ReadUnsigned(sizeof(uint32_t)));
+    if (num_dims == 0 || num_dims > kMaxTensorDims) {
+        return Status::InvalidArgument("GGUF tensor '" + info.name + "' has " + std::to_string(num_dims) +
+                                       " dimensions; expected 1 to " + std::to_string(kMaxTensorDims));
+    }
+
+    info.shape.resize(num_dims);
+    uint64_t numel = 1;
+    for (uint64_t i = 0; i < num_dims; ++i) {
+        AM_ASSIGN_OR_RETURN(const uint64_t dim, cursor.ReadUnsigned(sizeof(uint64_t)));
+        if (dim == 0 || dim > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ||
+            CheckOverflowMul(numel, dim, &numel)) {
+            return Status::InvalidArgument("GGUF tensor '" + info.name + "' has an invalid shape");
+        }
+        info.shape[num_dims - 1 - i] = static_cast<int64_t>(dim);
+    }
+
+    AM_ASSIGN_OR_RETURN(const uint64_t type_id, cursor.ReadUnsigned(sizeof(uint32_t)));
+    const auto traits = GetTensorTypeTraits(static_cast<uint32_t>(type_id));
+    if (!traits.has_value()) {
+        return Status::InvalidArgument("GGUF tensor '" + info.name + "' has unknown GGML type " +
+                                       std::to_string(type_id));
+    }
+    info.type = static_cast<GgufTensorType>(type_id);
+
+    // Blocks never straddle rows, so the innermost dimension holds whole blocks.
+    if (static_cast<uint64_t>(info.shape.back()) % traits->block_size != 0) {
+        return Status::InvalidArgument("GGUF tensor '" + info.name + "' of type " + ToString(info.type) +
+                                       " has a row length that is not a multiple of its block size " +
+                                       std::to_string(traits->block_size));
+    }
+    uint64_t bytes = 0;
+    if (CheckOverflowMul(numel / traits->block_size, static_cast<uint64_t>(traits->block_bytes), &bytes) ||
+        bytes > std::numeric_limits<size_t>::max()) {
+        return Status::InvalidArgument("GGUF tensor '" + info.name + "' is too large");
+    }
+    info.bytes = static_cast<size_t>(bytes);
+
+    AM_ASSIGN_OR_RETURN(info.offset, cursor.ReadUnsigned(sizeof(uint64_t)));
+    return info;
+}
+
+struct ParsedGguf {
+    uint32_t version = 0;
+    std::unordered_map<std::string, GgufMetadataValue> metadata{};
+    std::vector<GgufTensorInfo> tensors{};
+    size_t data_offset = 0;
+};
+
+StatusOr<ParsedGguf> ParseGguf(const std::byte* data, size_t size) {
+    GgufCursor cursor(data, size);
+    ParsedGguf parsed;
+
+    AM_ASSIGN_OR_RETURN(const uint64_t magic, cursor.ReadUnsigned(sizeof(uint32_t)));
+    if (magic != kGgufMagic) {
+        return Status::InvalidArgument("File is not GGUF: bad magic");
+    }
+    AM_ASSIGN_OR_RETURN(const uint64_t version, cursor.ReadUnsigned(sizeof(uint32_t)));
+    if (version != 2 && version != 3) {
+        return Status::Unimplemented("Unsupported GGUF version " + std::to_string(version) +
+                                     "; expected 2 or 3");
+    }
+    parsed.version = static_cast<uint32_t>(version);
+
+    AM_ASSIGN_OR_RETURN(const uint64_t tensor_count, cursor.ReadUnsigned(sizeof(uint64_t)));
+    AM_ASSIGN_OR_RETURN(const uint64_t kv_count, cursor.ReadUnsigned(sizeof(uint64_t)));
+    // A key/value pair takes at least 12 bytes and a tensor info at least 24,
+    // so counts beyond that cannot be satisfied by the rest of the file.
+    if (kv_count > cursor.remaining() / 12 || tensor_count > cursor.remaining() / 24) {
+        return cursor.Truncated();
+    }
+
+    parsed.metadata.reserve(static_cast<size_t>(kv_count));
+    for (uint64_t i = 0; i < kv_count; ++i) {
+        AM_ASSIGN_OR_RETURN(std::string key, cursor.ReadString());
+        AM_ASSIGN_OR_RETURN(const GgufValueType type, ReadValueType(cursor));
+        AM_ASSIGN_OR_RETURN(GgufMetadataValue value, ReadValue(cursor, type));
+        if (!parsed.metadata.emplace(key, std::move(value)).second) {
+            return Status::InvalidArgument("GGUF metadata key '" + key + "' is duplicated");
+        }
+    }
+
+    uint64_t alignment = kDefaultAlignment;
+    if (const auto it = parsed.metadata.find("general.alignment"); it != parsed.metadata.end()) {
+        const auto* value = std::get_if<uint64_t>(&it->second.scalar);
+        if (value == nullptr || *value == 0 || !std::has_single_bit(*value)) {
+            return Status::InvalidArgument("GGUF metadata 'general.alignment' must be a power of two");
+        }
+        alignment = *value;
+    }
+
+    parsed.tensors.reserve(static_cast<size_t>(tensor_count));
+    std::unordered_map<std::string_view, size_t> seen;
+    for (uint64_t i = 0; i < tensor_count; ++i) {
+        AM_ASSIGN_OR_RETURN(GgufTensorInfo info, ReadTensorInfo(cursor));
+        if (info.offset % alignment != 0) {
+            return Status::InvalidArgument("GGUF tensor '" + info.name + "' is not aligned to " +
+                                           std::to_string(alignment) + " bytes");
+        }
+        parsed.tensors.push_back(std::move(info));
+    }
+    for (size_t i = 0; i < parsed.tensors.size(); ++i) {
+        if (!seen.emplace(parsed.tensors[i].name, i).second) {
+            return Status::InvalidArgument("GGUF tensor '" + parsed.tensors[i].name + "' is duplicated");
+        }
+    }
+
+    const uint64_t header_end = cursor.offset();
+    const uint64_t data_offset = (header_end + alignment - 1) / alignment * alignment;
+    parsed.data_offset = static_cast<size_t>(std::min<uint64_t>(data_offset, size));
+    if (parsed.tensors.empty()) {
+        return parsed;
+    }
+    if (data_offset > size) {
+        return cursor.Truncated();
+    }
+    const uint64_t data_bytes = size - data_offset;
+    for (const GgufTensorInfo& info: parsed.tensors) {
+        if (info.offset > data_bytes || info.bytes > data_bytes - info.offset) {
+            return Status::InvalidArgument("GGUF tensor '" + info.name + "' extends past the end of the file");
+        }
+    }
+    return parsed;
+}
+
+// Copies an integer entry into `out`, leaving it unchanged when absent.
+Status ReadIntMetadata(const GgufReader& reader, const std::string& key, int64_t& out) {
+    const GgufMetadataValue* value = reader.FindMetadata(key);
+    if (value == nullptr) {
+        return Status::Ok();
+    }
+    if (const auto* unsigned_value = std::get_if<uint64_t>(&value->scalar);
+        unsigned_value != nullptr && value->type != GgufValueType::kArray) {
+        if (*unsigned_value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            return Status::InvalidArgument("GGUF metadata '" + key + "' is out of range");
+        }
+        out = static_cast<int64_t>(*unsigned_value);
+        return Status::Ok();
+    }
+    if (const auto* signed_value = std::get_if<int64_t>(&value->scalar)) {
+        out = *signed_value;
+        return Status::Ok();
+    }
+    return Status::InvalidArgument("GGUF metadata '" + key + "' must be an integer");
+}
+
+// Copies a float (or integer) entry into `out`, leaving it unchanged when absent.
+Status ReadDoubleMetadata(const GgufReader& reader, const std::string& key, double& out) {
+    const GgufMetadataValue* value = reader.FindMetadata(key);
+    if (value == nullptr) {
+        return Status::Ok();
+    }
+    if (const auto* double_value = std::get_if<double>(&value->scalar)) {
+        out = *double_value;
+        return Status::Ok();
+    }
+    int64_t int_value = 0;
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, key, int_value));
+    out = static_cast<double>(int_value);
+    return Status::Ok();
+}
+
+StatusOr<const std::string*> FindStringMetadata(const GgufReader& reader, const std::string& key) {
+    const GgufMetadataValue* value = reader.FindMetadata(key);
+    if (value == nullptr) {
+        return static_cast<const std::string*>(nullptr);
+    }
+    const auto* string_value = std::get_if<std::string>(&value->scalar);
+    if (string_value == nullptr || value->type != GgufValueType::kString) {
+        return Status::InvalidArgument("GGUF metadata '" + key + "' must be a string");
+    }
+    return string_value;
+}
+
+StatusOr<HfModelConfig> ParseConfigMetadata(const GgufReader& reader) {
+    AM_ASSIGN_OR_RETURN(const std::string* arch, FindStringMetadata(reader, "general.architecture"));
+    if (arch == nullptr || arch->empty()) {
+        return Status::InvalidArgument("GGUF metadata is missing 'general.architecture'");
+    }
+
+    HfModelConfig config{};
+    config.model_type = *arch;
+    if (*arch == "llama") {
+        config.architectures = {"LlamaForCausalLM"};
+    }
+
+    const std::string prefix = *arch + ".";
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "embedding_length", config.hidden_size));
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "feed_forward_length", config.intermediate_size));
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "block_count", config.num_hidden_layers));
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "attention.head_count", config.num_attention_heads));
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "attention.head_count_kv", config.num_key_value_heads));
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "context_length", config.max_position_embeddings));
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "attention.key_length", config.head_dim));
+    AM_RETURN_IF_ERROR(ReadDoubleMetadata(reader, prefix + "attention.layer_norm_rms_epsilon", config.rms_norm_eps));
+    AM_RETURN_IF_ERROR(ReadDoubleMetadata(reader, prefix + "rope.freq_base", config.rope.theta));
+
+    AM_ASSIGN_OR_RETURN(const std::string* scaling_type, FindStringMetadata(reader, prefix + "rope.scaling.type"));
+    if (scaling_type != nullptr && *scaling_type != "none") {
+        config.rope.scaling_type = ParseRopeScalingType(*scaling_type);
+        double factor = 0.0;
+        AM_RETURN_IF_ERROR(ReadDoubleMetadata(reader, prefix + "rope.scaling.factor", factor));
+        if (factor != 0.0) {
+            config.rope.scaling_factor = factor;
+        }
+    }
+
+    AM_RETURN_IF_ERROR(ReadIntMetadata(reader, prefix + "vocab_size", config.vocab_size));
+    if (config.vocab_size == 0) {
+        if (const GgufMetadataValue* tokens = reader.FindMetadata("tokenizer.ggml.tokens");
+            tokens != nullptr && tokens->type == GgufValueType::kArray) {
+            config.vocab_size = static_cast<int64_t>(tokens->array_length);
+        }
+    }
+
+    if (config.num_key_value_heads <= 0) {
+        config.num_key_value_heads = config.num_attention_heads;
+    }
+    config.tie_word_embeddings = std::ranges::none_of(reader.Tensors(), [](const GgufTensorInfo& info) {
+        return info.name == "output.weight";
+    });
+    return config;
+}
+
+// Renames llama.cpp tensors to the Hugging Face names the resolver expects;
+// names without a counterpart are returned unchanged.
+std::string ToHfTensorName(std::string_view name) {
+    constexpr std::pair<std::string_view, std::string_view> kModelTensors[] = {
+            {"token_embd", "model.embed_tokens"},
+            {"output_norm", "model.norm"},
+            {"output", "lm_head"},
+    };
+    constexpr std::pair<std::string_view, std::string_view> kLayerTensors[] = {
+            {"attn_norm", "input_layernorm"},
+            {"ffn_norm", "post_attention_layernorm"},
+            {"attn_q", "self_attn.q_proj"},
+            {"attn_k", "self_attn.k_proj"},
+            {"attn_v", "self_attn.v_proj"},
+            {"attn_output", "self_attn.o_proj"},
+            {"ffn_gate", "mlp.gate_proj"},
+            {"ffn_up", "mlp.up_proj"},
+            {"ffn_down", "mlp.down_proj"},
+    };
+
+    const size_t dot = name.rfind('.');
+    if (dot == std::string_view::npos) {
+        return std::string(name);
+    }
+    const std::string_view stem = name.substr(0, dot);
+    const std::string_view suffix = name.substr(dot);
+
+    for (const auto& [gguf, hf]: kModelTensors) {
+        if (stem == gguf) {
+            return std::string(hf) + std::string(suffix);
+        }
+    }
+
+    constexpr std::string_view kLayerPrefix = "blk.";
+    if (!stem.starts_with(kLayerPrefix)) {
+        return std::string(name);
+    }
+    const std::string_view rest = stem.substr(kLayerPrefix.size());
+    const size_t layer_end = rest.find('.');
+    if (layer_end == 0 || layer_end == std::string_view::npos) {
+        return std::string(name);
+    }
+    const std::string_view layer = rest.substr(0, layer_end);
+    if (!std::ranges::all_of(layer, [](char c) { return c >= '0' && c <= '9'; })) {
+        return std::string(name);
+    }
+    const std::string_view component = rest.substr(layer_end + 1);
+    for (const auto& [gguf, hf]: kLayerTensors) {
+        if (component == gguf) {
+            return "model.layers." + std::string(layer) + "." + std::string(hf) + std::string(suffix);
+        }
+    }
+    return std::string(name);
+}
+
+}// namespace
+
+const char* ToString(GgufTensorType type) noexcept {
+    switch (type) {
+        case GgufTensorType::kF32:
+            return "F32";
+        case GgufTensorType::kF16:
+            return "F16";
+        case GgufTensorType::kQ4_0:
+            return "Q4_0";
+        case GgufTensorType::kQ4_1:
+            return "Q4_1";
+        case GgufTensorType::kQ5_0:
+            return "Q5_0";
+        case GgufTensorType::kQ5_1:
+            return "Q5_1";
+        case GgufTensorType::kQ8_0:
+            return "Q8_0";
+        case GgufTensorType::kQ8_1:
+            return "Q8_1";
+        case GgufTensorType::kQ2_K:
+            return "Q2_K";
+        case GgufTensorType::kQ3_K:
+            return "Q3_K";
+        case GgufTensorType::kQ4_K:
+            return "Q4_K";
+        case GgufTensorType::kQ5_K:
+            return "Q5_K";
+        case GgufTensorType::kQ6_K:
+            return "Q6_K";
+        case GgufTensorType::kQ8_K:
+            return "Q8_K";
+        case GgufTensorType::kBF16:
+            return "BF16";
+    }
+    return "Unknown";
+}
+
+StatusOr<GgufReader> GgufReader::Open(const std::filesystem::path& path) {
+    if (path.empty()) {
+        return Status::InvalidArgument("GGUF file path must not be empty");
+    }
+
+    auto mmap = MemoryMappedFile::Map(path);
+    if (!mmap.ok()) {
+        return mmap.status();
+    }
+    auto storage = std::make_shared<MappedGgufStorage>(std::move(*mmap));
+
+    auto parsed = ParseGguf(storage->data(), storage->size());
+    if (!parsed.ok()) {
+        return parsed.status().WithMessage(hf::FormatPathMessage(parsed.status().message(), path));
+    }
+
+    GgufReader reader;
+    reader.path_ = path;
+    reader.version_ = parsed->version;
+    reader.file_data_ = storage->data();
+    reader.data_offset_ = parsed->data_offset;
+    reader.metadata_ = std::move(parsed->metadata);
+    reader.tensors_ = std::move(parsed->tensors);
+    reader.storage_ = std::move(storage);
+    return reader;
+}
+
+const GgufMetadataValue* GgufReader::FindMetadata(std::string_view key) const {
+    const auto it = metadata_.find(std::string(key));
+    return it == metadata_.end() ? nullptr : &it->second;
+}
+
+StatusOr<HfModelConfig> GgufReader::ParseConfig() const {
+    auto config = ParseConfigMetadata(*this);
+    if (!config.ok()) {
+        return config.status().WithMessage(hf::FormatPathMessage(config.status().message(), path_));
+    }
+    return config;
+}
+
+StatusOr<RawWeightTable> GgufReader::LoadRawWeightTable() const {
+    // llama.cpp permutes the rows of llama attn_q/attn_k per attention head.
+    size_t q_heads = 0;
+    size_t k_heads = 0;
+    AM_ASSIGN_OR_RETURN(const std::string* arch, FindStringMetadata(*this, "general.architecture"));
+    if (arch != nullptr && *arch == "llama") {
+        AM_ASSIGN_OR_RETURN(const HfModelConfig config, ParseConfig());
+        q_heads = static_cast<size_t>(std::max<int64_t>(config.num_attention_heads, 0));
+        k_heads = static_cast<size_t>(std::max<int64_t>(config.num_key_value_heads, 0));
+    }
+
+    RawWeightTable raw_weights;
+    raw_weights.reserve(tensors_.size());
+    for (const GgufTensorInfo& info: tensors_) {
+        RawWeightView view{
+                .data = file_data_ + data_offset_ + info.offset,
+                .bytes = info.bytes,
+                .dtype = {},
+                .shape = info.shape,
+                .storage = storage_,
+        };
+        switch (info.type) {
+            case GgufTensorType::kF32:
+                view.dtype = DataType::Float32();
+                break;
+            case GgufTensorType::kF16:
+                view.dtype = DataType::Float(16);
+                break;
+            case GgufTensorType::kBF16:
+                view.dtype = DataType::BFloat(16);
+                break;
+            case GgufTensorType::kQ8_0:
+                view.dtype = DataType::Int(8);
+                view.encoding = RawWeightEncoding::kGgmlQ8_0;
+                break;
+            case GgufTensorType::kQ4_0:
+                view.dtype = DataType::Int(4);
+                view.encoding = RawWeightEncoding::kGgmlQ4_0;
+                break;
+            default:
+                return Status::Unimplemented(hf::FormatPathMessage(
+                        "GGUF tensor '" + info.name + "' has type " + ToString(info.type) +
+                                "; supported types are F32, F16, BF16, Q8_0 and Q4_0",
+                        path_));
+        }
+
+        std::string name = ToHfTensorName(info.name);
+        // Embeddings are gathered row by row rather than packed, so quantized
+        // ones are decoded once here.
+        if (name == "model.embed_tokens.weight" && view.IsBlockQuantized() && view.shape.size() == 2) {
+            view = DequantizeBlocks(view);
+        }
+        const bool is_q = name.ends_with(".self_attn.q_proj.weight");
+        if ((is_q || name.ends_with(".self_attn.k_proj.weight")) && (is_q ? q_heads : k_heads) != 0) {
+            const size_t heads = is_q ? q_heads : k_heads;
+            if (view.shape.empty() || static_cast<size_t>(view.shape[0]) % (2 * heads) != 0) {
+                return Status::InvalidArgument(hf::FormatPathMessage(
+                        "GGUF tensor '" + info.name + "' rows do not split into " + std::to_string(heads) +
+                                " rotary heads",
+                        path_));
+            }
+            view.interleaved_rope_heads = heads;
+        }
+        if (!raw_weights.emplace(name, std::move(view)).second) {
+            return Status::AlreadyExists(hf::FormatPathMessage(
+                    "GGUF tensors map to the same name '" + name + "'", path_));
+        }
+    }
+    return raw_weights;
+}
+
+StatusOr<uint64_t> GgufReader::ComputeFingerprint() const {
+    std::error_code error;
+    const uint64_t file_size = std::filesystem::file_size(path_, error);
+    if (error) {
+        return Status::Internal(hf::FormatPathMessage("Failed to stat GGUF file", path_));
+    }
+    const auto write_time = std::filesystem::last_write_time(path_, error);
+    if (error) {
+        return Status::Internal(hf::FormatPathMessage("Failed to read GGUF file modification time", path_));
+    }
+    const int64_t write_ticks = write_time.time_since_epoch().count();
+
+    uint64_t hash = HashBytes(kLoadRevision, file_data_, data_offset_);
+    hash = HashBytes(hash, &file_size, sizeof(file_size));
+    return HashBytes(hash, &write_ticks, sizeof(write_ticks));
+}
+
+}// namespace aethermind
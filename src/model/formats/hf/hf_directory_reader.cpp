@@ -3,7 +3,9 @@
 #include "aethermind/model/formats/hf/hf_safetensors_file.h"
 #include "aethermind/model/formats/hf/hf_safetensors_index.h"
 #include "aethermind/model/formats/hf/hf_utils.h"
+#include "utils/hash.h"
 
+#include <chrono>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -411,6 +413,26 @@ StatusOr<RawWeightTable> LoadShardedRawWeightTable(const HfDirectoryDescriptor&
     return raw_weights;
 }
 
+// Folds a weight file's name, size and modification time into `hash`.
+Status HashWeightFileStat(const std::filesystem::path& path, uint64_t& hash) {
+    std::error_code error;
+    const uint64_t file_size = std::filesystem::file_size(path, error);
+    if (error) {
+        return Status::Internal(hf::FormatPathMessage("Failed to stat HF weight file", path));
+    }
+    const auto write_time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return Status::Internal(hf::FormatPathMessage("Failed to read HF weight file modification time", path));
+    }
+    const int64_t write_ticks = write_time.time_since_epoch().count();
+
+    const std::string name = path.filename().string();
+    hash = HashBytes(hash, name.data(), name.size());
+    hash = HashBytes(hash, &file_size, sizeof(file_size));
+    hash = HashBytes(hash, &write_ticks, sizeof(write_ticks));
+    return Status::Ok();
+}
+
 }// namespace
 
 StatusOr<HfDirectoryReader> HfDirectoryReader::Open(const std::filesystem::path& model_dir) {
@@ -449,6 +471,29 @@ StatusOr<RawWeightTable> HfDirectoryReader::LoadRawWeightTable() const {
             hf::FormatPathMessage("Unknown HF safetensors directory layout", dir_desc_.model_dir));
 }
 
+StatusOr<uint64_t> HfDirectoryReader::ComputeFingerprint() const {
+    AM_ASSIGN_OR_RETURN(const std::string config_text, hf::ReadFileText(dir_desc_.config_path));
+    uint64_t hash = HashBytes(0, config_text.data(), config_text.size());
+
+    if (dir_desc_.IsSingleFile()) {
+        AM_RETURN_IF_ERROR(HashWeightFileStat(dir_desc_.safetensors_path, hash));
+        return hash;
+    }
+
+    if (dir_desc_.IsSharded()) {
+        AM_RETURN_IF_ERROR(HashWeightFileStat(dir_desc_.safetensors_index_path, hash));
+        AM_ASSIGN_OR_RETURN(const HfSafetensorsIndex index,
+                            HfSafetensorsIndex::Load(dir_desc_.safetensors_index_path));
+        for (const auto& shard_filename: index.UniqueShardFilenames()) {
+            AM_RETURN_IF_ERROR(HashWeightFileStat(dir_desc_.model_dir / shard_filename, hash));
+        }
+        return hash;
+    }
+
+    return Status::FailedPrecondition(
+            hf::FormatPathMessage("Unknown HF safetensors directory layout", dir_desc_.model_dir));
+}
+
 StatusOr<HfDirectoryDescriptor> HfDirectoryReader::InspectDirectory(const std::filesystem::path& model_dir) {
     // Reject an empty path before filesystem probing so the caller gets a usage
     // error instead of a platform-dependent filesystem diagnostic.
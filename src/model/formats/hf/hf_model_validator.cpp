@@ -61,6 +61,33 @@ std::string ShapeToString(const std::vector<int64_t>& shape) {
     return result;
 }
 
+// Block-quantized rows hold whole blocks, so the byte size follows from the
+// block count rather than from an element size.
+Status ValidateBlockQuantizedBytes(const RawWeightView& view, std::string_view weight_name, uint64_t numel) {
+    if (view.shape.back() % static_cast<int64_t>(kRawWeightBlockSize) != 0) {
+        return Status::InvalidArgument(
+                std::string("Weight '") + std::string(weight_name) + "' is block-quantized but its shape " +
+                ShapeToString(view.shape) + " does not split into rows of whole " +
+                std::to_string(kRawWeightBlockSize) + "-element blocks");
+    }
+
+    size_t expected_bytes = 0;
+    if (CheckOverflowMul(numel / kRawWeightBlockSize, RawWeightBlockBytes(view.encoding), &expected_bytes)) {
+        return Status::InvalidArgument(std::string("Weight '") + std::string(weight_name) +
+                                       "' byte size overflows size_t");
+    }
+
+    if (view.bytes != expected_bytes) {
+        return Status::InvalidArgument(
+                std::string("Weight '") + std::string(weight_name) +
+                "' byte size mismatch: shape " + ShapeToString(view.shape) +
+                " in " + std::to_string(RawWeightBlockBytes(view.encoding)) + "-byte blocks" +
+                " = " + std::to_string(expected_bytes) +
+                " but view reports " + std::to_string(view.bytes));
+    }
+    return Status::Ok();
+}
+
 Status ValidateWeightViewIntegrity(const RawWeightView& view, std::string_view weight_name) {
     if (!view.IsValid()) {
         return Status::InvalidArgument(std::string("Weight '") + std::string(weight_name) +
@@ -97,6 +124,10 @@ Status ValidateWeightViewIntegrity(const RawWeightView& view, std::string_view w
                                        "' is an empty tensor");
     }
 
+    if (view.IsBlockQuantized()) {
+        return ValidateBlockQuantizedBytes(view, weight_name, numel);
+    }
+
     const auto itemsize = static_cast<size_t>(view.dtype.nbytes());
     if (itemsize == 0) {
         return Status::InvalidArgument(std::string("Weight '") + std::string(weight_name) +
@@ -389,6 +420,11 @@ bool IsSupportedWeightDType(const DataType& dtype) {
 }
 
 Status ValidateWeightDType(const RawWeightView& view, std::string_view weight_name) {
+    if (view.IsBlockQuantized()) {
+        return Status::InvalidArgument(
+                "Invalid tensor dtype: tensor=" + std::string(weight_name) +
+                ", block-quantized weights are only supported for linear projections");
+    }
     if (!IsSupportedWeightDType(view.dtype)) {
         return Status::InvalidArgument(
                 "Invalid tensor dtype: tensor=" + std::string(weight_name) +
@@ -397,6 +433,15 @@ Status ValidateWeightDType(const RawWeightView& view, std::string_view weight_na
     return Status::Ok();
 }
 
+// Linear weights are packed rather than read in place, so they may also be
+// block-quantized.
+Status ValidateLinearWeightDType(const RawWeightView& view, std::string_view weight_name) {
+    if (view.IsBlockQuantized()) {
+        return Status::Ok();
+    }
+    return ValidateWeightDType(view, weight_name);
+}
+
 Status ExpectRank(const RawWeightView& view, int64_t expected_rank, std::string_view weight_name) {
     if (static_cast<int64_t>(view.shape.size()) != expected_rank) {
         return Status::InvalidArgument("Invalid tensor rank: tensor=" + std::string(weight_name) +
@@ -432,6 +477,11 @@ Status ValidateUniformLinearDType(std::string_view weight_name,
                                   const RawWeightView& view,
                                   bool* has_linear_dtype,
                                   DataType* linear_dtype) {
+    // Block-quantized weights pack into their own format whatever the
+    // checkpoint's dense dtype is.
+    if (view.IsBlockQuantized()) {
+        return Status::Ok();
+    }
     if (!*has_linear_dtype) {
         *linear_dtype = view.dtype;
         *has_linear_dtype = true;
@@ -454,7 +504,7 @@ Status ValidateResolvedModelDTypes(const HfModelConfig& config,
     DataType linear_dtype{};
 
     const auto validate_linear = [&](std::string_view weight_name, const RawWeightView& view) -> Status {
-        AM_RETURN_IF_ERROR(ValidateWeightDType(view, weight_name));
+        AM_RETURN_IF_ERROR(ValidateLinearWeightDType(view, weight_name));
         if (options.require_uniform_linear_dtype) {
             AM_RETURN_IF_ERROR(ValidateUniformLinearDType(weight_name, view, &has_linear_dtype, &linear_dtype));
         }
@@ -465,11 +515,14 @@ Status ValidateResolvedModelDTypes(const HfModelConfig& config,
         return ValidateWeightDType(view, weight_name);
     };
 
+    // Embeddings are gathered rather than packed, so they must be dense; the
+    // GGUF reader decodes quantized ones at load.
+    AM_RETURN_IF_ERROR(ValidateWeightDType(resolved.embed_tokens, "model.embed_tokens.weight"));
     AM_RETURN_IF_ERROR(validate_linear("model.embed_tokens.weight", resolved.embed_tokens));
     AM_RETURN_IF_ERROR(validate_norm("model.norm.weight", resolved.final_norm));
 
     if (resolved.lm_head.has_value()) {
-        AM_RETURN_IF_ERROR(ValidateWeightDType(*resolved.lm_head, "lm_head.weight"));
+        AM_RETURN_IF_ERROR(ValidateLinearWeightDType(*resolved.lm_head, "lm_head.weight"));
         if (config.tie_word_embeddings && resolved.lm_head->dtype != resolved.embed_tokens.dtype) {
             return Status::InvalidArgument(
                     "Tied embedding dtype mismatch: tensor=lm_head.weight, expected=" +
@@ -620,9 +673,8 @@ Status HfModelValidator::ValidateWeightSet(const HfModelConfig& config,
             const std::string name = "model.layers." + std::to_string(i) + std::string(suffix);
             AM_RETURN_IF_ERROR(ValidateWeight(weights, name));
             const auto& view = weights.at(name);
-            AM_RETURN_IF_ERROR(ValidateWeightDType(view, name));
-
             const bool is_norm = IsLayerNormSuffix(suffix);
+            AM_RETURN_IF_ERROR(is_norm ? ValidateWeightDType(view, name) : ValidateLinearWeightDType(view, name));
             AM_RETURN_IF_ERROR(ExpectRank(view, is_norm ? 1 : 2, name));
             if (options.require_uniform_linear_dtype && !is_norm) {
                 AM_RETURN_IF_ERROR(ValidateUniformLinearDType(name, view, &has_linear_dtype, &linear_dtype));
@@ -632,7 +684,7 @@ Status HfModelValidator::ValidateWeightSet(const HfModelConfig& config,
 
     if (const auto lm_head_it = weights.find("lm_head.weight"); lm_head_it != weights.end()) {
         AM_RETURN_IF_ERROR(ValidateWeightViewIntegrity(lm_head_it->second, "lm_head.weight"));
-        AM_RETURN_IF_ERROR(ValidateWeightDType(lm_head_it->second, "lm_head.weight"));
+        AM_RETURN_IF_ERROR(ValidateLinearWeightDType(lm_head_it->second, "lm_head.weight"));
         AM_RETURN_IF_ERROR(ExpectRank(lm_head_it->second, 2, "lm_head.weight"));
         if (options.require_uniform_linear_dtype) {
             AM_RETURN_IF_ERROR(ValidateUniformLinearDType("lm_head.weight", lm_head_it->second, &has_linear_dtype, &linear_dtype));
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <span>
@@ -38,6 +39,16 @@ public:
         return mmap_.Advise(advice);
     }
 
+    AM_NODISCARD Status Advise(const std::byte* data,
+                               size_t bytes,
+                               MemoryMappedFile::Advice advice) const override {
+        const std::byte* begin = mmap_.ByteData();
+        if (std::less<>()(data, begin) || std::less<>()(begin + mmap_.size(), data)) {
+            return Status::InvalidArgument("Advised range is outside the safetensors mapping");
+        }
+        return mmap_.AdviseRange(static_cast<size_t>(data - begin), bytes, advice);
+    }
+
 private:
     // RawWeightView instances may keep this mapping alive after Open returns.
     // The checkpoint file must not be truncated while mapped; later reads could SIGBUS.
@@ -322,7 +322,8 @@ Status ValidateInputs(const HfModelConfig& config, const ResolvedModelWeights& w
 }// namespace
 
 StatusOr<ModelGraph> ModelGraphBuilder::BuildLlamaDense(const HfModelConfig& config,
-                                                        const ResolvedModelWeights& weights) {
+                                                        const ResolvedModelWeights& weights,
+                                                        const std::optional<SampleParams>& sampling) {
     AM_RETURN_IF_ERROR(ValidateInputs(config, weights));
     const DataType act_dtype = config.weight_dtype_hint.IsUndefined()
                                        ? DataType::Float32()
@@ -408,11 +409,9 @@ StatusOr<ModelGraph> ModelGraphBuilder::BuildLlamaDense(const HfModelConfig& con
                                                              TransformerWeightRole::kLmHead),
                                 WeightDebugName(TransformerWeightRole::kLmHead, std::nullopt)));
     AM_ASSIGN_OR_RETURN(const GraphValueId output_tokens,
-                        AddArgmax(graph,
-                                  std::nullopt,
-                                  logits,
-                                  -1,
-                                  "argmax"));
+                        sampling.has_value()
+                                ? AddSample(graph, std::nullopt, logits, *sampling, "sample")
+                                : AddArgmax(graph, std::nullopt, logits, -1, "argmax"));
     graph.MarkOutput(output_tokens);
     AM_RETURN_IF_ERROR(graph.Validate());
     return graph;
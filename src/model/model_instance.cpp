@@ -30,8 +30,28 @@ const PackedWeights* ModelInstance::FindPackedWeights(
     return backend_sidecar_.Find(op_type, selector);
 }
 
+const PackedWeights* ModelInstance::FindPackedWeights(
+        std::optional<uint32_t> decoder_layer_index,
+        WeightRole role) const noexcept {
+    return backend_sidecar_.Find(decoder_layer_index, role);
+}
+
 Status ModelInstance::StorePackedWeights(std::unique_ptr<PackedWeights> packed_weights) noexcept {
     return backend_sidecar_.Store(std::move(packed_weights));
 }
 
+Status ModelInstance::StorePackedWeights(std::optional<uint32_t> decoder_layer_index,
+                                         WeightRole role,
+                                         std::unique_ptr<PackedWeights> packed_weights) noexcept {
+    return backend_sidecar_.Store(decoder_layer_index, role, std::move(packed_weights));
+}
+
+const std::vector<WeightQuantizationReport>& ModelInstance::GetWeightQuantizationReports() const noexcept {
+    return quantization_reports_;
+}
+
+void ModelInstance::SetWeightQuantizationReports(std::vector<WeightQuantizationReport> reports) noexcept {
+    quantization_reports_ = std::move(reports);
+}
+
 }// namespace aethermind
@@ -1,30 +1,124 @@
 #include "aethermind/model/model_loader.h"
+#include "aethermind/backend/cpu/cpu_weight_prepacker.h"
+#include "aethermind/model/formats/gguf/gguf_reader.h"
 #include "aethermind/model/formats/hf/hf_directory_reader.h"
 #include "aethermind/model/formats/hf/hf_model_validator.h"
 #include "aethermind/model/formats/hf/hf_weight_resolver.h"
 #include "aethermind/model/model_instance.h"
 #include "aethermind/model/model_instance_builder.h"
+#include "aethermind/model/packed_weight_cache.h"
+#include "aethermind/model/parallel_load.h"
 #include "aethermind/model/weight_prepack_planner.h"
 #include "aethermind/base/macros.h"
 
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <system_error>
+#include <vector>
+
 namespace aethermind {
 
-StatusOr<std::unique_ptr<ModelInstance>> ModelLoader::Load(const ModelLoadOptions& options,
-                                                           const Backend& backend,
-                                                           const KernelRegistry& registry) {
-    auto reader = HfDirectoryReader::Open(options.model_dir);
-    if (!reader.ok()) {
-        return reader.status();
+namespace {
+
+std::filesystem::path PackedWeightCachePath(const std::filesystem::path& cache_dir,
+                                            const PackedWeightCacheKey& key) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "packed-%016llx-v%u.ampw",
+                  static_cast<unsigned long long>(key.checkpoint_fingerprint),
+                  static_cast<unsigned>(key.pack_format_version));
+    return cache_dir / name;
+}
+
+void LogQuantizationReports(const std::vector<WeightQuantizationReport>& reports) {
+    if (reports.empty()) {
+        return;
+    }
+    const WeightQuantizationReport* worst = &reports.front();
+    for (const auto& report: reports) {
+        spdlog::debug("Quantized {} of layer {} with {}: max_abs_error={:.6g}, rms_error={:.6g}",
+                      ToString(report.role),
+                      report.decoder_layer_index.has_value() ? std::to_string(*report.decoder_layer_index) : "-",
+                      ToString(report.config.scheme),
+                      report.error.max_abs_error,
+                      report.error.rms_error);
+        if (report.error.rms_error > worst->error.rms_error) {
+            worst = &report;
+        }
     }
+    spdlog::info("Quantized {} weights; worst rms_error={:.6g} ({} of layer {})",
+                 reports.size(),
+                 worst->error.rms_error,
+                 ToString(worst->role),
+                 worst->decoder_layer_index.has_value() ? std::to_string(*worst->decoder_layer_index) : "-");
+}
+
+// The cache holds one artifact per request, written in request order.
+// Returns false when `cached` does not line up with `requests`, so the caller
+// packs from scratch.
+bool CachedWeightsMatch(const std::vector<WeightPrepackPlanner::Request>& requests,
+                        const std::vector<std::unique_ptr<PackedWeights>>& cached) noexcept {
+    if (cached.size() != requests.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (cached[i]->op_type() != requests[i].op_type || cached[i]->selector() != requests[i].selector) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Expands `reports`, which cover only the quantized requests in request
+// order, into one error per request for the packed-weight cache.
+std::vector<WeightQuantizationError> RequestErrors(const std::vector<WeightPrepackPlanner::Request>& requests,
+                                                   const std::vector<WeightQuantizationReport>& reports) {
+    std::vector<WeightQuantizationError> errors(requests.size());
+    size_t next = 0;
+    for (size_t i = 0; i < requests.size() && next < reports.size(); ++i) {
+        if (requests[i].quantization.scheme != WeightQuantScheme::kNone) {
+            errors[i] = reports[next++].error;
+        }
+    }
+    return errors;
+}
 
-    auto config = reader->ParseConfig();
+// Rebuilds the reports Prepack would have produced from the per-request
+// errors recorded in the packed-weight cache.
+std::vector<WeightQuantizationReport> CachedReports(const std::vector<WeightPrepackPlanner::Request>& requests,
+                                                    const std::vector<WeightQuantizationError>& errors) {
+    std::vector<WeightQuantizationReport> reports;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& req = requests[i];
+        if (req.quantization.scheme != WeightQuantScheme::kNone) {
+            reports.push_back(WeightQuantizationReport{
+                    .decoder_layer_index = req.decoder_layer_index,
+                    .role = req.role,
+                    .config = req.quantization,
+                    .error = errors[i],
+            });
+        }
+    }
+    return reports;
+}
+
+// Runs the format-independent pipeline over an opened HfDirectoryReader or
+// GgufReader: validation, resolution, prepacking and the packed-weight cache.
+template<typename Reader>
+StatusOr<std::unique_ptr<ModelInstance>> LoadWithReader(const Reader& reader,
+                                                        const ModelLoadOptions& options,
+                                                        const Backend& backend,
+                                                        const KernelRegistry& registry) {
+    auto config = reader.ParseConfig();
     if (!config.ok()) {
         return config.status();
     }
 
     AM_RETURN_IF_ERROR(HfModelValidator::ValidateConfig(*config));
 
-    auto raw_weights = reader->LoadRawWeightTable();
+    auto raw_weights = reader.LoadRawWeightTable();
     if (!raw_weights.ok()) {
         return raw_weights.status();
     }
@@ -44,14 +138,72 @@ StatusOr<std::unique_ptr<ModelInstance>> ModelLoader::Load(const ModelLoadOption
     }
 
     auto requests = WeightPrepackPlanner::BuildRequests(
-            (*model)->GetConfig(), (*model)->GetResolvedWeights(), backend, registry);
+            (*model)->GetConfig(), (*model)->GetResolvedWeights(), backend, registry,
+            options.quantization);
     if (!requests.ok()) {
         return requests.status();
     }
 
-    AM_RETURN_IF_ERROR(WeightPrepackPlanner::PrepackAndStore(**model, *requests));
+    PackedWeightCacheKey cache_key;
+    std::filesystem::path cache_path;
+    if (!options.packed_weight_cache_dir.empty()) {
+        AM_ASSIGN_OR_RETURN(const uint64_t fingerprint, reader.ComputeFingerprint());
+        // Group sizes are not part of the selectors the cache entries record.
+        cache_key.checkpoint_fingerprint = options.quantization.Hash(fingerprint);
+        cache_key.pack_format_version = CpuWeightPrepacker::kFormatVersion;
+        cache_path = PackedWeightCachePath(options.packed_weight_cache_dir, cache_key);
+        // A missing, stale or unreadable cache only means packing from scratch.
+        std::vector<WeightQuantizationError> cached_errors;
+        auto cached = LoadPackedWeightCache(cache_path, cache_key, &cached_errors);
+        if (cached.ok() && CachedWeightsMatch(*requests, *cached)) {
+            // The cache file is already one execution-ordered block; its
+            // mapping is kept so processes share the page-cache pages.
+            (*model)->SetWeightQuantizationReports(CachedReports(*requests, cached_errors));
+            AM_RETURN_IF_ERROR(WeightPrepackPlanner::Store(**model, *requests, std::move(*cached)));
+            return model;
+        }
+    }
+
+    const size_t num_threads = ResolveLoadThreadCount(options.num_threads);
+    if (options.prefault_weights) {
+        AM_RETURN_IF_ERROR(PrefaultRawWeights(*raw_weights, num_threads));
+    }
 
+    std::vector<WeightQuantizationReport> reports;
+    AM_ASSIGN_OR_RETURN(auto packed, WeightPrepackPlanner::Prepack(*requests, num_threads, &reports,
+                                                                  options.packed_weight_arena));
+    LogQuantizationReports(reports);
+    if (!cache_path.empty()) {
+        std::vector<const PackedWeights*> artifacts;
+        artifacts.reserve(packed.size());
+        for (const auto& weights: packed) {
+            artifacts.push_back(weights.get());
+        }
+        std::error_code ignored;
+        std::filesystem::create_directories(options.packed_weight_cache_dir, ignored);
+        const auto errors = RequestErrors(*requests, reports);
+        const Status saved = SavePackedWeightCache(artifacts, cache_key, cache_path, errors);
+        if (!saved.ok()) {
+            spdlog::warn("Failed to write packed-weight cache: {}", saved.ToString());
+        }
+    }
+    (*model)->SetWeightQuantizationReports(std::move(reports));
+    AM_RETURN_IF_ERROR(WeightPrepackPlanner::Store(**model, *requests, std::move(packed)));
     return model;
 }
 
+}// namespace
+
+StatusOr<std::unique_ptr<ModelInstance>> ModelLoader::Load(const ModelLoadOptions& options,
+                                                           const Backend& backend,
+                                                           const KernelRegistry& registry) {
+    if (options.model_dir.extension() == ".gguf") {
+        AM_ASSIGN_OR_RETURN(const GgufReader reader, GgufReader::Open(options.model_dir));
+        return LoadWithReader(reader, options, backend, registry);
+    }
+
+    AM_ASSIGN_OR_RETURN(const HfDirectoryReader reader, HfDirectoryReader::Open(options.model_dir));
+    return LoadWithReader(reader, options, backend, registry);
+}
+
 }// namespace aethermind
@@ -0,0 +1,135 @@
+#include "aethermind/model/packed_weight_arena.h"
+#include "alignment.h"
+#include "utils/overflow_check.h"
+
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+
+namespace aethermind {
+
+struct PackedWeightArena::Mapping {
+    Mapping(void* base, size_t nbytes) noexcept : base(base), nbytes(nbytes) {}
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping() {
+        munmap(base, nbytes);
+    }
+
+    void* base = nullptr;
+    size_t nbytes = 0;
+};
+
+namespace {
+
+// Tries explicit 2 MB pages first: they are reserved up front and never
+// split, but only exist when the administrator set aside a pool.
+void* MapHugeTlb(size_t nbytes) noexcept {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    void* base = mmap(nullptr, nbytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+    return base == MAP_FAILED ? nullptr : base;
+#else
+    (void) nbytes;
+    return nullptr;
+#endif
+}
+
+// Over-maps by one huge page and trims both ends, so the arena starts on a
+// 2 MB boundary and every 2 MB of it can become one transparent huge page.
+void* MapHugePageAligned(size_t nbytes) noexcept {
+    const size_t padded = nbytes + PackedWeightArena::kHugePageSize;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    auto* begin = static_cast<std::byte*>(raw);
+    const auto address = reinterpret_cast<uintptr_t>(raw);
+    auto* base = begin + (AlignUp(address, PackedWeightArena::kHugePageSize) - address);
+    if (base != begin) {
+        munmap(begin, static_cast<size_t>(base - begin));
+    }
+    const size_t tail = padded - static_cast<size_t>(base - begin) - nbytes;
+    if (tail != 0) {
+        munmap(base + nbytes, tail);
+    }
+    return base;
+}
+
+}// namespace
+
+const char* ToString(PackedWeightArenaBacking backing) noexcept {
+    switch (backing) {
+        case PackedWeightArenaBacking::kHugeTlb:
+            return "hugetlb";
+        case PackedWeightArenaBacking::kTransparentHugePages:
+            return "transparent huge pages";
+        case PackedWeightArenaBacking::kBasePages:
+            return "base pages";
+    }
+    return "unknown";
+}
+
+StatusOr<PackedWeightArena> PackedWeightArena::Create(std::span<const size_t> slot_sizes) {
+    PackedWeightArena arena;
+    arena.offsets_.reserve(slot_sizes.size());
+    arena.slot_sizes_.assign(slot_sizes.begin(), slot_sizes.end());
+    size_t size = 0;
+    for (const size_t slot_size: slot_sizes) {
+        const size_t offset = AlignUp(size, kSlotAlignment);
+        if (offset < size || CheckOverflowAdd(offset, slot_size, &size)) {
+            return Status::ResourceExhausted("Packed weights overflow the arena size");
+        }
+        arena.offsets_.push_back(offset);
+    }
+
+    arena.size_ = size;
+    if (size == 0) {
+        return arena;
+    }
+
+    const size_t mapped_size = AlignUp(size, kHugePageSize);
+    if (mapped_size < size) {
+        return Status::ResourceExhausted("Packed weights overflow the arena size");
+    }
+    void* base = MapHugeTlb(mapped_size);
+    if (base != nullptr) {
+        arena.backing_ = PackedWeightArenaBacking::kHugeTlb;
+    } else {
+        base = MapHugePageAligned(mapped_size);
+        if (base == nullptr) {
+            return Status::ResourceExhausted("Failed to map the packed-weight arena");
+        }
+#ifdef MADV_HUGEPAGE
+        if (madvise(base, mapped_size, MADV_HUGEPAGE) == 0) {
+            arena.backing_ = PackedWeightArenaBacking::kTransparentHugePages;
+        } else {
+            spdlog::debug("madvise(MADV_HUGEPAGE) failed for the packed-weight arena");
+        }
+#endif
+    }
+    arena.mapping_ = std::make_shared<Mapping>(base, mapped_size);
+    return arena;
+}
+
+const std::byte* PackedWeightArena::data() const noexcept {
+    return mapping_ == nullptr ? nullptr : static_cast<const std::byte*>(mapping_->base);
+}
+
+Buffer PackedWeightArena::Slot(size_t index) const {
+    if (mapping_ == nullptr || index >= offsets_.size()) {
+        return Buffer{};
+    }
+    // Each slot's buffer holds one reference to the shared mapping.
+    MemoryHandle handle = MemoryHandle::Shared(static_cast<std::byte*>(mapping_->base) + offsets_[index],
+                                               mapping_,
+                                               Device::CPU(),
+                                               kSlotAlignment);
+    if (!handle) {
+        return Buffer{};
+    }
+    return Buffer(slot_sizes_[index], std::move(handle));
+}
+
+}// namespace aethermind
@@ -0,0 +1,207 @@
+#include "aethermind/model/packed_weight_cache.h"
+#include "aethermind/base/binary_file.h"
+#include "aethermind/base/mmap_file.h"
+#include "alignment.h"
+#include "utils/overflow_check.h"
+
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace aethermind {
+namespace {
+
+constexpr uint32_t kPackedWeightCacheMagic = 0x57504D41;// "AMPW"
+// Version 2 writes the header and entries field by field instead of as raw
+// structs; version 3 adds each entry's quantization error.
+constexpr uint32_t kPackedWeightCacheVersion = 3;
+
+// Visits the header fields in their on-disk order.
+struct HeaderFields {
+    template<typename Header, typename Fn>
+    constexpr void operator()(Header& header, Fn&& fn) const {
+        fn(header.magic);
+        fn(header.version);
+        fn(header.checkpoint_fingerprint);
+        fn(header.pack_format_version);
+        fn(header.num_entries);
+    }
+};
+
+// Visits the entry fields in their on-disk order.
+struct EntryFields {
+    template<typename Entry, typename Fn>
+    constexpr void operator()(Entry& entry, Fn&& fn) const {
+        fn(entry.op_type);
+        fn(entry.device_type);
+        fn(entry.weight_format);
+        fn(entry.isa);
+        fn(entry.phase);
+        fn(entry.kv_layout);
+        fn(entry.act_dtype.code);
+        fn(entry.act_dtype.bits);
+        fn(entry.act_dtype.lanes);
+        fn(entry.weight_dtype.code);
+        fn(entry.weight_dtype.bits);
+        fn(entry.weight_dtype.lanes);
+        fn(entry.offset);
+        fn(entry.nbytes);
+        fn(entry.max_abs_error);
+        fn(entry.rms_error);
+    }
+};
+
+constexpr size_t kEncodedHeaderBytes = EncodedFieldBytes<PackedWeightCacheHeader>(HeaderFields{});
+constexpr size_t kEncodedEntryBytes = EncodedFieldBytes<PackedWeightCacheEntry>(EntryFields{});
+
+size_t EntryTableEnd(size_t num_entries) noexcept {
+    return kEncodedHeaderBytes + num_entries * kEncodedEntryBytes;
+}
+
+PackedWeightCacheEntry MakeEntry(const PackedWeights& weights, uint64_t offset) noexcept {
+    const KernelSelector& selector = weights.selector();
+    return PackedWeightCacheEntry{
+            .op_type = static_cast<uint32_t>(weights.op_type()),
+            .device_type = static_cast<uint8_t>(selector.device_type),
+            .weight_format = static_cast<uint8_t>(selector.weight_format),
+            .isa = static_cast<uint8_t>(selector.isa),
+            .phase = static_cast<uint8_t>(selector.phase),
+            .kv_layout = static_cast<uint8_t>(selector.kv_layout),
+            .act_dtype = selector.act_dtype,
+            .weight_dtype = selector.weight_dtype,
+            .offset = offset,
+            .nbytes = weights.storage().nbytes(),
+    };
+}
+
+KernelSelector EntrySelector(const PackedWeightCacheEntry& entry) {
+    return KernelSelector{
+            .device_type = static_cast<DeviceType>(entry.device_type),
+            .act_dtype = DataType(entry.act_dtype),
+            .weight_dtype = DataType(entry.weight_dtype),
+            .weight_format = static_cast<WeightFormat>(entry.weight_format),
+            .isa = static_cast<IsaLevel>(entry.isa),
+            .phase = static_cast<ExecPhase>(entry.phase),
+            .kv_layout = static_cast<KVLayoutOrder>(entry.kv_layout),
+    };
+}
+
+}// namespace
+
+Status SavePackedWeightCache(std::span<const PackedWeights* const> weights,
+                             const PackedWeightCacheKey& key,
+                             const std::filesystem::path& path,
+                             std::span<const WeightQuantizationError> errors) {
+    if (!errors.empty() && errors.size() != weights.size()) {
+        return Status::InvalidArgument("Packed-weight cache errors do not match the artifacts");
+    }
+    PackedWeightCacheHeader header;
+    header.magic = kPackedWeightCacheMagic;
+    header.version = kPackedWeightCacheVersion;
+    header.checkpoint_fingerprint = key.checkpoint_fingerprint;
+    header.pack_format_version = key.pack_format_version;
+    header.num_entries = static_cast<uint32_t>(weights.size());
+
+    std::vector<PackedWeightCacheEntry> entries;
+    entries.reserve(weights.size());
+    size_t offset = AlignUp(EntryTableEnd(weights.size()), kPackedWeightCacheAlignment);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        const PackedWeights* packed = weights[i];
+        if (packed == nullptr || !packed->storage().is_initialized()) {
+            return Status::InvalidArgument("Cannot cache uninitialized packed weights");
+        }
+        entries.push_back(MakeEntry(*packed, offset));
+        if (!errors.empty()) {
+            entries.back().max_abs_error = errors[i].max_abs_error;
+            entries.back().rms_error = errors[i].rms_error;
+        }
+        offset = AlignUp(offset + packed->storage().nbytes(), kPackedWeightCacheAlignment);
+    }
+
+    return WriteFileAtomically(path, "packed-weight cache", [&](std::ofstream& out) {
+        std::vector<std::byte> table;
+        table.reserve(EntryTableEnd(entries.size()));
+        AppendFields(header, HeaderFields{}, table);
+        for (const auto& entry: entries) {
+            AppendFields(entry, EntryFields{}, table);
+        }
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size()));
+
+        const std::vector<char> padding(kPackedWeightCacheAlignment, 0);
+        size_t written = table.size();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            out.write(padding.data(), static_cast<std::streamsize>(entries[i].offset - written));
+            out.write(static_cast<const char*>(weights[i]->storage().data()),
+                      static_cast<std::streamsize>(entries[i].nbytes));
+            written = entries[i].offset + entries[i].nbytes;
+        }
+        return Status::Ok();
+    });
+}
+
+StatusOr<std::vector<std::unique_ptr<PackedWeights>>> LoadPackedWeightCache(
+        const std::filesystem::path& path,
+        const PackedWeightCacheKey& key,
+        std::vector<WeightQuantizationError>* errors) {
+    AM_ASSIGN_OR_RETURN(MemoryMappedFile mapped, MemoryMappedFile::Map(path));
+    if (mapped.size() < kEncodedHeaderBytes) {
+        return Status::InvalidArgument("Packed-weight cache file is too small: " + path.string());
+    }
+
+    PackedWeightCacheHeader header;
+    const std::byte* cursor = DecodeFields(header, HeaderFields{}, mapped.ByteData());
+    if (header.magic != kPackedWeightCacheMagic) {
+        return Status::InvalidArgument("Not a packed-weight cache file: " + path.string());
+    }
+    if (header.version != kPackedWeightCacheVersion) {
+        return Status::InvalidArgument("Unsupported packed-weight cache version " +
+                                       std::to_string(header.version));
+    }
+    if (header.checkpoint_fingerprint != key.checkpoint_fingerprint ||
+        header.pack_format_version != key.pack_format_version) {
+        return Status::FailedPrecondition("Packed-weight cache was written for a different checkpoint or "
+                                          "packing format: " + path.string());
+    }
+    if (mapped.size() < EntryTableEnd(header.num_entries)) {
+        return Status::InvalidArgument("Packed-weight cache entry table is truncated: " + path.string());
+    }
+
+    std::vector<PackedWeightCacheEntry> entries(header.num_entries);
+    for (auto& entry: entries) {
+        cursor = DecodeFields(entry, EntryFields{}, cursor);
+        uint64_t end = 0;
+        if (entry.offset % kPackedWeightCacheAlignment != 0 ||
+            CheckOverflowAdd(entry.offset, entry.nbytes, &end) || end > mapped.size()) {
+            return Status::InvalidArgument("Corrupt packed-weight cache entry: " + path.string());
+        }
+    }
+
+    const auto mapping = std::make_shared<const MemoryMappedFile>(std::move(mapped));
+    std::vector<std::unique_ptr<PackedWeights>> weights;
+    weights.reserve(entries.size());
+    for (const auto& entry: entries) {
+        // Each artifact's buffer holds one reference to the shared mapping.
+        // The mapping is PROT_READ, so the buffer refuses mutable access.
+        MemoryHandle handle = MemoryHandle::SharedReadOnly(mapping->ByteData() + entry.offset,
+                                                           mapping,
+                                                           Device::CPU(),
+                                                           kPackedWeightCacheAlignment);
+        if (!handle) {
+            return Status::ResourceExhausted("Failed to allocate packed-weight cache storage");
+        }
+        Buffer storage(static_cast<size_t>(entry.nbytes), std::move(handle));
+        weights.push_back(std::make_unique<BufferPackedWeights>(
+                static_cast<OpType>(entry.op_type), EntrySelector(entry), std::move(storage)));
+    }
+    if (errors != nullptr) {
+        errors->clear();
+        errors->reserve(entries.size());
+        for (const auto& entry: entries) {
+            errors->push_back(WeightQuantizationError{.max_abs_error = entry.max_abs_error,
+                                                      .rms_error = entry.rms_error});
+        }
+    }
+    return weights;
+}
+
+}// namespace aethermind
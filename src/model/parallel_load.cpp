@@ -0,0 +1,136 @@
+#include "aethermind/model/parallel_load.h"
+#include "aethermind/base/mmap_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aethermind {
+
+namespace {
+
+// Upper bound on the bytes one prefault task touches.
+constexpr size_t kPrefaultChunkBytes = size_t{64} << 20;
+
+struct PrefaultRange {
+    const RawStorage* storage = nullptr;
+    const std::byte* data = nullptr;
+    size_t bytes = 0;
+};
+
+// Reads one byte per page; the volatile loads cannot be elided, and the
+// final read covers a trailing page the stride steps over.
+void TouchPages(const std::byte* data, size_t bytes) noexcept {
+    const size_t page_size = PageSize();
+    const volatile std::byte* bytes_view = data;
+    for (size_t offset = 0; offset < bytes; offset += page_size) {
+        (void) bytes_view[offset];
+    }
+    (void) bytes_view[bytes - 1];
+}
+
+}// namespace
+
+size_t ResolveLoadThreadCount(size_t requested) noexcept {
+    if (requested != 0) {
+        return requested;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+Status RunLoadTasks(size_t num_tasks,
+                    size_t num_threads,
+                    const std::function<Status(size_t)>& task) {
+    if (num_tasks == 0) {
+        return Status::Ok();
+    }
+
+    std::vector<Status> statuses(num_tasks);
+    std::atomic<size_t> next_task{0};
+    std::atomic<bool> failed{false};
+    const auto drain = [&]() noexcept {
+        while (!failed.load(std::memory_order_relaxed)) {
+            const size_t index = next_task.fetch_add(1, std::memory_order_relaxed);
+            if (index >= num_tasks) {
+                return;
+            }
+            // Tasks report failures as Status, but the ones that allocate
+            // can still run out of memory; a throw here would terminate.
+            try {
+                statuses[index] = task(index);
+            } catch (const std::bad_alloc&) {
+                statuses[index] = Status::ResourceExhausted("Out of memory in load task " + std::to_string(index));
+            }
+            if (!statuses[index].ok()) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    const size_t num_workers = std::min(std::max<size_t>(num_threads, 1), num_tasks);
+    std::vector<std::thread> workers;
+    try {
+        workers.reserve(num_workers - 1);
+        for (size_t i = 1; i < num_workers; ++i) {
+            workers.emplace_back(drain);
+        }
+    } catch (const std::exception&) {
+        // Fewer workers only slow the pass down; the calling thread drains
+        // whatever the started ones do not.
+    }
+    drain();
+    for (auto& worker: workers) {
+        worker.join();
+    }
+
+    for (auto& status: statuses) {
+        if (!status.ok()) {
+            return std::move(status);
+        }
+    }
+    return Status::Ok();
+}
+
+Status PrefaultRawWeights(const RawWeightTable& raw_weights, size_t num_threads) {
+    std::vector<PrefaultRange> tensors;
+    tensors.reserve(raw_weights.size());
+    for (const auto& [name, view]: raw_weights) {
+        if (view.data != nullptr && view.bytes > 0) {
+            tensors.push_back(PrefaultRange{
+                    .storage = view.storage.get(),
+                    .data = view.data,
+                    .bytes = view.bytes,
+            });
+        }
+    }
+    // RawWeightTable is unordered; group by shard and walk each in file order.
+    std::sort(tensors.begin(), tensors.end(), [](const PrefaultRange& lhs, const PrefaultRange& rhs) {
+        if (lhs.storage != rhs.storage) {
+            return std::less<>()(lhs.storage, rhs.storage);
+        }
+        return std::less<>()(lhs.data, rhs.data);
+    });
+
+    std::vector<PrefaultRange> chunks;
+    for (const auto& tensor: tensors) {
+        for (size_t offset = 0; offset < tensor.bytes; offset += kPrefaultChunkBytes) {
+            chunks.push_back(PrefaultRange{
+                    .storage = tensor.storage,
+                    .data = tensor.data + offset,
+                    .bytes = std::min(kPrefaultChunkBytes, tensor.bytes - offset),
+            });
+        }
+    }
+
+    return RunLoadTasks(chunks.size(), num_threads, [&chunks](size_t index) {
+        TouchPages(chunks[index].data, chunks[index].bytes);
+        return Status::Ok();
+    });
+}
+
+}// namespace aethermind
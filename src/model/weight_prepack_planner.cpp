@@ -5,16 +5,25 @@
 #include "aethermind/backend/kernel_registry.h"
 #include "aethermind/base/tensor_view.h"
 #include "aethermind/model/model_instance.h"
+#include "aethermind/model/packed_weight_arena.h"
+#include "aethermind/model/parallel_load.h"
 #include "aethermind/base/macros.h"
 
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <string>
 #include <vector>
 
 namespace aethermind {
 
 namespace {
 
-KernelSelector MakePackedSelector(const Backend& backend, const DataType& weight_dtype) {
-    return KernelSelector{
+KernelSelector MakePackedSelector(const Backend& backend,
+                                  const DataType& weight_dtype,
+                                  const WeightQuantConfig& quantization) {
+    KernelSelector selector{
             .device_type = backend.device_type(),
             .act_dtype = DataType::Float32(),
             .weight_dtype = weight_dtype,
@@ -22,6 +31,92 @@ KernelSelector MakePackedSelector(const Backend& backend, const DataType& weight
             .isa = IsaLevel::kAVX2,
             .phase = ExecPhase::kBoth,
     };
+    switch (quantization.scheme) {
+        case WeightQuantScheme::kNone:
+            break;
+        case WeightQuantScheme::kInt8PerChannel:
+            selector.weight_dtype = DataType::Int(8);
+            selector.weight_format = WeightFormat::kQuantizedInt8;
+            break;
+        case WeightQuantScheme::kInt4Grouped:
+            selector.weight_dtype = DataType::Int(4);
+            selector.weight_format = WeightFormat::kQuantizedInt4;
+            break;
+    }
+    return selector;
+}
+
+KernelSelector MakeBlockQuantizedSelector(const Backend& backend, const RawWeightView& weight) {
+    KernelSelector selector = MakePackedSelector(backend, weight.dtype, WeightQuantConfig{});
+    selector.weight_format = weight.encoding == RawWeightEncoding::kGgmlQ8_0 ? WeightFormat::kQuantizedInt8
+                                                                             : WeightFormat::kQuantizedInt4;
+    return selector;
+}
+
+size_t QuantGroupSize(const WeightQuantConfig& quantization) noexcept {
+    return quantization.scheme == WeightQuantScheme::kInt4Grouped ? quantization.group_size : 0;
+}
+
+// Row-major strides of a contiguous weight of `shape`.
+std::vector<int64_t> RowMajorStrides(const std::vector<int64_t>& shape) {
+    std::vector<int64_t> strides(shape.size());
+    if (!strides.empty()) {
+        strides.back() = 1;
+        for (int64_t i = static_cast<int64_t>(strides.size()) - 2; i >= 0; --i) {
+            strides[i] = strides[i + 1] * shape[i + 1];
+        }
+    }
+    return strides;
+}
+
+// Whether `req` wraps its checkpoint bytes instead of being packed: its
+// packed layout matches the mapping, so duplicating it would only cost RSS.
+bool AliasesCheckpoint(const CpuWeightPrepacker& prepacker,
+                       const WeightPrepackPlanner::Request& req,
+                       TensorView view) noexcept {
+    const RawWeightView& weight = req.raw_weight;
+    return weight.interleaved_rope_heads == 0 && !weight.IsBlockQuantized() &&
+           req.quantization.scheme == WeightQuantScheme::kNone && weight.is_contiguous &&
+           weight.storage != nullptr && prepacker.CanAlias(req.op_type, view, req.selector);
+}
+
+// Bytes the prepacker writes for a request it does not alias.
+StatusOr<size_t> PackedNBytes(const WeightPrepackPlanner::Request& req, TensorView view) {
+    const auto& shape = req.raw_weight.shape;
+    if (!req.raw_weight.IsBlockQuantized() && req.quantization.scheme == WeightQuantScheme::kNone) {
+        return view.logical_nbytes();
+    }
+    if (shape.size() != 2) {
+        return Status::InvalidArgument("Quantized linear weights must be rank 2");
+    }
+    const size_t group_size = req.raw_weight.IsBlockQuantized() ? CpuWeightPrepacker::kGgmlBlockSize
+                                                                : QuantGroupSize(req.quantization);
+    AM_ASSIGN_OR_RETURN(const CpuQuantizedWeightLayout layout,
+                        CpuQuantizedWeightLayout::Make(req.selector.weight_format, shape[0], shape[1], group_size));
+    return layout.nbytes;
+}
+
+// Copies `weight` with each head's rows moved from llama.cpp's interleaved
+// rotary order back to the Hugging Face one. Rows move whole, so dense and
+// block-quantized encodings are handled alike.
+StatusOr<std::vector<std::byte>> RestoreRopeRowOrder(const RawWeightView& weight) {
+    const size_t heads = weight.interleaved_rope_heads;
+    const size_t rows = weight.shape.empty() ? 0 : static_cast<size_t>(weight.shape[0]);
+    if (weight.shape.size() != 2 || rows == 0 || rows % (2 * heads) != 0 || weight.bytes % rows != 0) {
+        return Status::InvalidArgument("Interleaved rotary rows do not split into " + std::to_string(heads) +
+                                       " heads");
+    }
+    const size_t row_bytes = weight.bytes / rows;
+    const size_t head_rows = rows / heads;
+    const size_t half = head_rows / 2;
+    std::vector<std::byte> reordered(weight.bytes);
+    for (size_t row = 0; row < rows; ++row) {
+        const size_t head = row / head_rows;
+        const size_t within = row % head_rows;
+        const size_t source = head * head_rows + 2 * (within % half) + within / half;
+        std::memcpy(reordered.data() + row * row_bytes, weight.data + source * row_bytes, row_bytes);
+    }
+    return reordered;
 }
 
 }// namespace
@@ -30,89 +125,180 @@ StatusOr<std::vector<WeightPrepackPlanner::Request>> WeightPrepackPlanner::Build
         const HfModelConfig& config,
         const ResolvedModelWeights& resolved_weights,
         const Backend& backend,
-        const KernelRegistry& registry) {
-    UNUSED(config);
+        const KernelRegistry& registry,
+        const WeightQuantizationPolicy& policy) {
     UNUSED(registry);
+    AM_RETURN_IF_ERROR(policy.Validate());
+
+    // A tied checkpoint has no lm_head tensor; the lm_head Linear node reads
+    // the token embedding instead and still binds a kLmHead artifact.
+    const RawWeightView* lm_head = resolved_weights.lm_head.has_value() ? &*resolved_weights.lm_head
+                                   : config.tie_word_embeddings      ? &resolved_weights.embed_tokens
+                                                                     : nullptr;
 
     std::vector<Request> requests;
     const size_t num_layers = resolved_weights.layers.size();
-    requests.reserve(num_layers * 7 + (resolved_weights.lm_head.has_value() ? 1 : 0));
-
-    for (const auto& layer: resolved_weights.layers) {
-        const auto add = [&](const RawWeightView& weight) {
-            requests.push_back(Request{
-                    .op_type = OpType::kLinear,
-                    .raw_weight = weight,
-                    .selector = MakePackedSelector(backend, weight.dtype),
-            });
-        };
-        add(layer.attn.q_proj);
-        add(layer.attn.k_proj);
-        add(layer.attn.v_proj);
-        add(layer.attn.o_proj);
-        add(layer.mlp.gate_proj);
-        add(layer.mlp.up_proj);
-        add(layer.mlp.down_proj);
-    }
+    requests.reserve(num_layers * 7 + (lm_head != nullptr ? 1 : 0));
 
-    if (resolved_weights.lm_head.has_value()) {
+    const auto add = [&](const RawWeightView& weight,
+                         WeightRole role,
+                         std::optional<uint32_t> layer_index) {
+        // Weights quantized ahead of time keep their checkpoint levels; the
+        // policy only applies to full-precision weights.
+        const WeightQuantConfig quantization =
+                weight.IsBlockQuantized() ? WeightQuantConfig{} : policy.Resolve(layer_index, role);
         requests.push_back(Request{
                 .op_type = OpType::kLinear,
-                .raw_weight = *resolved_weights.lm_head,
-                .selector = MakePackedSelector(backend, resolved_weights.lm_head->dtype),
+                .raw_weight = weight,
+                .selector = weight.IsBlockQuantized() ? MakeBlockQuantizedSelector(backend, weight)
+                                                      : MakePackedSelector(backend, weight.dtype, quantization),
+                .role = role,
+                .decoder_layer_index = layer_index,
+                .quantization = quantization,
         });
+    };
+
+    for (size_t i = 0; i < num_layers; ++i) {
+        const auto& layer = resolved_weights.layers[i];
+        const auto layer_index = static_cast<uint32_t>(i);
+        add(layer.attn.q_proj, WeightRole::kQProj, layer_index);
+        add(layer.attn.k_proj, WeightRole::kKProj, layer_index);
+        add(layer.attn.v_proj, WeightRole::kVProj, layer_index);
+        add(layer.attn.o_proj, WeightRole::kOProj, layer_index);
+        add(layer.mlp.gate_proj, WeightRole::kGateProj, layer_index);
+        add(layer.mlp.up_proj, WeightRole::kUpProj, layer_index);
+        add(layer.mlp.down_proj, WeightRole::kDownProj, layer_index);
+    }
+
+    if (lm_head != nullptr) {
+        add(*lm_head, WeightRole::kLmHead, std::nullopt);
     }
 
     return requests;
 }
 
-Status WeightPrepackPlanner::PrepackAndStore(ModelInstance& model_instance,
-                                             const std::vector<Request>& requests) {
-    CpuWeightPrepacker prepacker;
-
-    struct PackKey {
-        OpType op_type;
-        KernelSelector selector;
+StatusOr<std::vector<std::unique_ptr<PackedWeights>>> WeightPrepackPlanner::Prepack(
+        const std::vector<Request>& requests,
+        size_t num_threads,
+        std::vector<WeightQuantizationReport>* reports,
+        bool use_arena) {
+    const CpuWeightPrepacker prepacker;
+    std::vector<std::vector<int64_t>> strides(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        strides[i] = RowMajorStrides(requests[i].raw_weight.shape);
+    }
+    const auto view_of = [&](size_t index, const std::byte* data) {
+        const RawWeightView& weight = requests[index].raw_weight;
+        return TensorView(data, weight.dtype, IntArrayView(weight.shape), IntArrayView(strides[index]), 0);
     };
-    std::vector<PackKey> stored;
-
-    for (const auto& req : requests) {
-        bool duplicate = false;
-        for (const auto& key : stored) {
-            if (key.op_type == req.op_type && key.selector == req.selector) {
-                duplicate = true;
-                break;
+
+    // Every slot is sized before anything is packed, so each weight is
+    // packed straight into the arena and never also held on the heap.
+    // Weights aliased to the checkpoint get no slot and stay mapped.
+    constexpr size_t kNoSlot = static_cast<size_t>(-1);
+    std::vector<size_t> slots(requests.size(), kNoSlot);
+    std::optional<PackedWeightArena> arena;
+    if (use_arena) {
+        std::vector<size_t> slot_sizes;
+        slot_sizes.reserve(requests.size());
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const TensorView view = view_of(i, requests[i].raw_weight.data);
+            if (AliasesCheckpoint(prepacker, requests[i], view)) {
+                continue;
             }
+            AM_ASSIGN_OR_RETURN(const size_t nbytes, PackedNBytes(requests[i], view));
+            slots[i] = slot_sizes.size();
+            slot_sizes.push_back(nbytes);
         }
-        if (duplicate) {
-            continue;
-        }
+        AM_ASSIGN_OR_RETURN(arena, PackedWeightArena::Create(slot_sizes));
+    }
 
+    std::vector<std::unique_ptr<PackedWeights>> packed(requests.size());
+    std::vector<WeightQuantizationError> errors(requests.size());
+    AM_RETURN_IF_ERROR(RunLoadTasks(requests.size(), num_threads, [&](size_t index) -> Status {
+        const Request& req = requests[index];
         const auto& shape = req.raw_weight.shape;
-        std::vector<int64_t> strides(shape.size());
-        if (!strides.empty()) {
-            strides.back() = 1;
-            for (int64_t i = static_cast<int64_t>(strides.size()) - 2; i >= 0; --i) {
-                strides[i] = strides[i + 1] * shape[i + 1];
+        Buffer storage = slots[index] == kNoSlot ? Buffer{} : arena->Slot(slots[index]);
+        // Scratch copy in Hugging Face row order; it never outlives packing.
+        std::vector<std::byte> reordered;
+        const std::byte* data = req.raw_weight.data;
+        if (req.raw_weight.interleaved_rope_heads != 0) {
+            AM_ASSIGN_OR_RETURN(reordered, RestoreRopeRowOrder(req.raw_weight));
+            data = reordered.data();
+        }
+        if (req.raw_weight.IsBlockQuantized()) {
+            if (shape.size() != 2) {
+                return Status::InvalidArgument("Block-quantized linear weights must be rank 2");
             }
+            AM_ASSIGN_OR_RETURN(packed[index],
+                                prepacker.PackQuantizedBlocks(req.op_type, data, req.raw_weight.bytes,
+                                                              shape[0], shape[1], req.selector,
+                                                              std::move(storage)));
+            return Status::Ok();
+        }
+
+        const TensorView view = view_of(index, data);
+        if (req.quantization.scheme != WeightQuantScheme::kNone) {
+            AM_ASSIGN_OR_RETURN(packed[index],
+                                prepacker.PackQuantized(req.op_type, view, req.selector,
+                                                        QuantGroupSize(req.quantization), &errors[index],
+                                                        std::move(storage)));
+            return Status::Ok();
+        }
+
+        auto result = AliasesCheckpoint(prepacker, req, view)
+                              ? prepacker.Alias(req.op_type, view, req.selector, req.raw_weight.storage)
+                              : prepacker.Pack(req.op_type, view, req.selector, std::move(storage));
+        if (!result.ok()) {
+            return result.status();
         }
+        packed[index] = std::move(*result);
+        return Status::Ok();
+    }));
 
-        TensorView view(req.raw_weight.data,
-                        req.raw_weight.dtype,
-                        IntArrayView(shape),
-                        IntArrayView(strides),
-                        0);
+    if (arena.has_value()) {
+        spdlog::info("Packed {} weights into a {:.1f} MiB arena on {}; {} stay aliased to the checkpoint",
+                     arena->num_slots(),
+                     static_cast<double>(arena->size()) / (1 << 20),
+                     ToString(arena->backing()),
+                     requests.size() - arena->num_slots());
+    }
 
-        auto packed = prepacker.Pack(req.op_type, view, req.selector);
-        if (!packed.ok()) {
-            return packed.status();
+    if (reports != nullptr) {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const Request& req = requests[i];
+            if (req.quantization.scheme != WeightQuantScheme::kNone) {
+                reports->push_back(WeightQuantizationReport{
+                        .decoder_layer_index = req.decoder_layer_index,
+                        .role = req.role,
+                        .config = req.quantization,
+                        .error = errors[i],
+                });
+            }
         }
+    }
+    return packed;
+}
 
-        AM_RETURN_IF_ERROR(model_instance.StorePackedWeights(std::move(*packed)));
-        stored.push_back({req.op_type, req.selector});
+Status WeightPrepackPlanner::Store(ModelInstance& model_instance,
+                                   const std::vector<Request>& requests,
+                                   std::vector<std::unique_ptr<PackedWeights>> packed) {
+    if (packed.size() != requests.size()) {
+        return Status::InvalidArgument("Packed weights do not match the prepack requests");
     }
 
-    return {};
+    for (size_t i = 0; i < requests.size(); ++i) {
+        AM_RETURN_IF_ERROR(model_instance.StorePackedWeights(
+                requests[i].decoder_layer_index, requests[i].role, std::move(packed[i])));
+    }
+    return Status::Ok();
+}
+
+Status WeightPrepackPlanner::PrepackAndStore(ModelInstance& model_instance,
+                                             const std::vector<Request>& requests,
+                                             size_t num_threads) {
+    AM_ASSIGN_OR_RETURN(auto packed, Prepack(requests, num_threads, nullptr, /*use_arena=*/true));
+    return Store(model_instance, requests, std::move(packed));
 }
 
 }// namespace aethermind
@@ -0,0 +1,95 @@
+#include "aethermind/model/weight_quantization_policy.h"
+#include "utils/hash.h"
+
+#include <cstdint>
+#include <string>
+
+namespace aethermind {
+
+namespace {
+
+uint64_t HashConfig(uint64_t hash, const WeightQuantConfig& config) noexcept {
+    const auto scheme = static_cast<uint8_t>(config.scheme);
+    hash = HashBytes(hash, &scheme, sizeof(scheme));
+    return HashBytes(hash, &config.group_size, sizeof(config.group_size));
+}
+
+Status ValidateConfig(const WeightQuantConfig& config, const char* context) {
+    if (config.scheme == WeightQuantScheme::kInt4Grouped && config.group_size == 0) {
+        return Status::InvalidArgument(std::string(context) + " uses INT4 with a zero group size");
+    }
+    return Status::Ok();
+}
+
+}// namespace
+
+const char* ToString(WeightRole role) noexcept {
+    switch (role) {
+        case WeightRole::kQProj:
+            return "q_proj";
+        case WeightRole::kKProj:
+            return "k_proj";
+        case WeightRole::kVProj:
+            return "v_proj";
+        case WeightRole::kOProj:
+            return "o_proj";
+        case WeightRole::kGateProj:
+            return "gate_proj";
+        case WeightRole::kUpProj:
+            return "up_proj";
+        case WeightRole::kDownProj:
+            return "down_proj";
+        case WeightRole::kLmHead:
+            return "lm_head";
+    }
+    return "unknown";
+}
+
+const char* ToString(WeightQuantScheme scheme) noexcept {
+    switch (scheme) {
+        case WeightQuantScheme::kNone:
+            return "None";
+        case WeightQuantScheme::kInt8PerChannel:
+            return "Int8PerChannel";
+        case WeightQuantScheme::kInt4Grouped:
+            return "Int4Grouped";
+    }
+    return "Unknown";
+}
+
+WeightQuantConfig WeightQuantizationPolicy::Resolve(std::optional<uint32_t> decoder_layer_index,
+                                                    WeightRole role) const noexcept {
+    WeightQuantConfig config = role == WeightRole::kLmHead ? lm_head : default_config;
+    for (const WeightQuantOverride& entry: overrides) {
+        const bool layer_matches = !entry.decoder_layer_index.has_value() ||
+                                   entry.decoder_layer_index == decoder_layer_index;
+        const bool role_matches = !entry.role.has_value() || entry.role == role;
+        if (layer_matches && role_matches) {
+            config = entry.config;
+        }
+    }
+    return config;
+}
+
+Status WeightQuantizationPolicy::Validate() const {
+    AM_RETURN_IF_ERROR(ValidateConfig(default_config, "Weight quantization default config"));
+    AM_RETURN_IF_ERROR(ValidateConfig(lm_head, "Weight quantization lm_head config"));
+    for (const WeightQuantOverride& entry: overrides) {
+        AM_RETURN_IF_ERROR(ValidateConfig(entry.config, "Weight quantization override"));
+    }
+    return Status::Ok();
+}
+
+uint64_t WeightQuantizationPolicy::Hash(uint64_t seed) const noexcept {
+    uint64_t hash = HashConfig(HashConfig(seed, default_config), lm_head);
+    for (const WeightQuantOverride& entry: overrides) {
+        const uint32_t layer = entry.decoder_layer_index.value_or(UINT32_MAX);
+        const uint8_t role = entry.role.has_value() ? static_cast<uint8_t>(*entry.role) : UINT8_MAX;
+        hash = HashBytes(hash, &layer, sizeof(layer));
+        hash = HashBytes(hash, &role, sizeof(role));
+        hash = HashConfig(hash, entry.config);
+    }
+    return hash;
+}
+
+}// namespace aethermind
@@ -5,9 +5,9 @@ namespace aethermind::detail {
 
 namespace {
 
-// Reports the first unsupported dtype among k/v/cache and enforces that all
-// four inputs share the same dtype. Mixed dtypes between activations and cache
-// are rejected: no implicit conversion is declared.
+// Reports the first unsupported dtype among k/v/cache. k and v share one
+// activation dtype; the caches share either that dtype or one quantized
+// storage dtype, which is the only declared conversion.
 Status ValidateKVCacheUpdateDTypes(std::span<const TensorSpec> inputs) {
     const TensorSpec& k = inputs[0];
     const TensorSpec& v = inputs[1];
@@ -24,14 +24,14 @@ Status ValidateKVCacheUpdateDTypes(std::span<const TensorSpec> inputs) {
                 "KVCacheUpdate v dtype must match k dtype");
     }
 
-    if (k_cache.dtype != k.dtype) {
+    if (k_cache.dtype != k.dtype && !IsKVCacheUpdateQuantizedCacheDType(k_cache.dtype)) {
         return Status::InvalidArgument(
-                "KVCacheUpdate k_cache_in dtype must match k dtype");
+                "KVCacheUpdate k_cache_in dtype must match k dtype or be int8/float8 storage");
     }
 
-    if (v_cache.dtype != k.dtype) {
+    if (v_cache.dtype != k_cache.dtype) {
         return Status::InvalidArgument(
-                "KVCacheUpdate v_cache_in dtype must match k dtype");
+                "KVCacheUpdate v_cache_in dtype must match k_cache_in dtype");
     }
     return Status::Ok();
 }
@@ -150,8 +150,8 @@ StatusOr<InferenceResult> InferKVCacheUpdate(const OpParams& params,
     AM_RETURN_IF_ERROR(ValidateKVCacheUpdateDTypes(inputs));
     AM_RETURN_IF_ERROR(ValidateKVCacheUpdateShapes(inputs));
 
-    // Cache-out follows cache-in verbatim (shape and dtype). The dtype is now
-    // guaranteed to match k/v by ValidateKVCacheUpdateDTypes.
+    // Cache-out follows cache-in verbatim (shape and dtype), including
+    // quantized storage dtypes.
     return InferenceResult{
             .outputs = {inputs[2], inputs[3]},
     };
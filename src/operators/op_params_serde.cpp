@@ -31,6 +31,21 @@ StatusOr<int64_t> ParseInt64(const FieldMap& fields, std::string_view name) {
     return value;
 }
 
+StatusOr<uint64_t> ParseUInt64(const FieldMap& fields, std::string_view name) {
+    const auto it = fields.find(std::string(name));
+    if (it == fields.end()) {
+        return Status::InvalidArgument("ParseOpParams: missing integer field");
+    }
+
+    uint64_t value = 0;
+    const std::string& text = it->second;
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc{} || result.ptr != text.data() + text.size()) {
+        return Status::InvalidArgument("ParseOpParams: invalid integer field");
+    }
+    return value;
+}
+
 StatusOr<float> ParseFloat(const FieldMap& fields, std::string_view name) {
     const auto it = fields.find(std::string(name));
     if (it == fields.end()) {
@@ -377,6 +392,7 @@ const char* OpParamsKindName(const OpParams& params) noexcept {
             [](const ReshapeParams&) noexcept { return "Reshape"; },
             [](const PermuteParams&) noexcept { return "Permute"; },
             [](const ReorderParams&) noexcept { return "Reorder"; },
+            [](const SampleParams&) noexcept { return "Sample"; },
     };
     return std::visit(visitor, params);
 }
@@ -425,6 +441,12 @@ Status SerializeOpParams(const OpParams& params, std::ostream& os) {
                 SerializePermutation(p.permutation, os);
             },
             [&](const ReorderParams&) { os << "Reorder"; },
+            [&](const SampleParams& p) {
+                os << "Sample temperature=" << p.temperature
+                   << " top_k=" << p.top_k
+                   << " top_p=" << p.top_p
+                   << " seed=" << p.seed;
+            },
     };
     std::visit(visitor, params);
     return Status::Ok();
@@ -574,6 +596,22 @@ StatusOr<OpParams> ParseOpParams(std::string_view text) {
         return OpParams{ReorderParams{}};
     }
 
+    if (kind == "Sample") {
+        AM_RETURN_IF_ERROR(EnsureNoExtraFields(fields, 4));
+        StatusOr<float> temperature = ParseFloat(fields, "temperature");
+        AM_RETURN_IF_ERROR(temperature.status());
+        StatusOr<int64_t> top_k = ParseInt64(fields, "top_k");
+        AM_RETURN_IF_ERROR(top_k.status());
+        StatusOr<float> top_p = ParseFloat(fields, "top_p");
+        AM_RETURN_IF_ERROR(top_p.status());
+        StatusOr<uint64_t> seed = ParseUInt64(fields, "seed");
+        AM_RETURN_IF_ERROR(seed.status());
+        return OpParams{SampleParams{.temperature = *temperature,
+                                     .top_k = *top_k,
+                                     .top_p = *top_p,
+                                     .seed = *seed}};
+    }
+
     return Status::InvalidArgument("ParseOpParams: unknown parameter kind");
 }
 
@@ -40,6 +40,8 @@ const char* ToString(OpType op_type) noexcept {
             return "Permute";
         case OpType::kReorder:
             return "Reorder";
+        case OpType::kSample:
+            return "Sample";
         default:
             return "Unknown";
     }
@@ -34,10 +34,11 @@ constexpr OperatorTraits RuntimeOnly() noexcept {
             .compile_time_evaluable = false};
 }
 
-constexpr OperatorTraits CompileTimeEvaluable() noexcept {
+constexpr OperatorTraits Elementwise() noexcept {
     return {.has_side_effects = false,
             .deterministic = true,
-            .compile_time_evaluable = true};
+            .compile_time_evaluable = true,
+            .elementwise = true};
 }
 
 constexpr OperatorTraits Stateful() noexcept {
@@ -62,7 +63,7 @@ StatusOr<uint32_t> FindPortIndex(std::span<const Port> ports,
 // every registered operator. Graph validation (graph.cpp) reads these schemas
 // to verify node arity, port kinds, and payload consistency at build time.
 // Add a new entry here when introducing a new OpType.
-const std::array<OperatorSchema, 16> kOperatorSchemas{
+const std::array<OperatorSchema, 17> kOperatorSchemas{
         OperatorSchema{
                 .op_type = OpType::kEmbedding,
                 .input_ports = {Input(0, "tokens", OperatorPortKind::kModelInput),
@@ -111,27 +112,27 @@ const std::array<OperatorSchema, 16> kOperatorSchemas{
                 .input_ports = {Input(0, "lhs", OperatorPortKind::kActivation),
                                 Input(1, "rhs", OperatorPortKind::kActivation)},
                 .output_ports = {Output(0, "output")},
-                .traits = CompileTimeEvaluable(),
+                .traits = Elementwise(),
         },
         OperatorSchema{
                 .op_type = OpType::kSiluMul,
                 .input_ports = {Input(0, "gate", OperatorPortKind::kActivation),
                                 Input(1, "up", OperatorPortKind::kActivation)},
                 .output_ports = {Output(0, "output")},
-                .traits = CompileTimeEvaluable(),
+                .traits = Elementwise(),
         },
         OperatorSchema{
                 .op_type = OpType::kSilu,
                 .input_ports = {Input(0, "input", OperatorPortKind::kActivation)},
                 .output_ports = {Output(0, "output")},
-                .traits = CompileTimeEvaluable(),
+                .traits = Elementwise(),
         },
         OperatorSchema{
                 .op_type = OpType::kElementwiseMul,
                 .input_ports = {Input(0, "lhs", OperatorPortKind::kActivation),
                                 Input(1, "rhs", OperatorPortKind::kActivation)},
                 .output_ports = {Output(0, "output")},
-                .traits = CompileTimeEvaluable(),
+                .traits = Elementwise(),
         },
         OperatorSchema{
                 .op_type = OpType::kArgmax,
@@ -139,6 +140,14 @@ const std::array<OperatorSchema, 16> kOperatorSchemas{
                 .output_ports = {Output(0, "output")},
                 .traits = RuntimeOnly(),
         },
+        OperatorSchema{
+                .op_type = OpType::kSample,
+                .input_ports = {Input(0, "logits", OperatorPortKind::kActivation)},
+                .output_ports = {Output(0, "output")},
+                // Deterministic: the RNG is keyed by params, session seed and
+                // position, so equal Sample nodes draw equal tokens.
+                .traits = RuntimeOnly(),
+        },
         OperatorSchema{
                 .op_type = OpType::kKVCacheUpdate,
                 .input_ports = {Input(0, "k", OperatorPortKind::kActivation),
@@ -239,4 +248,14 @@ bool IsCompileTimeEvaluable(const OperatorSchema& schema) noexcept {
     return IsPureOperator(schema) && schema.traits.compile_time_evaluable;
 }
 
+// In-place execution requires that every output element is written only
+// after the same-index input elements were read, and that schema ports map
+// one-to-one onto the compact runtime tensor bindings.
+bool SupportsInPlaceActivation(const OperatorSchema& schema) noexcept {
+    return IsPureOperator(schema) && schema.traits.elementwise &&
+           std::ranges::all_of(schema.input_ports, [](const OperatorInputPort& port) {
+               return port.contributes_tensor_spec;
+           });
+}
+
 }// namespace aethermind
@@ -0,0 +1,178 @@
+#include "aethermind/operators/sample_op.h"
+#include "aethermind/backend/backend.h"
+#include "aethermind/backend/kernel_context.h"
+#include "aethermind/execution/runtime_binding_context.h"
+#include "aethermind/operators/operator_inference.h"
+#include "aethermind/operators/operator_registry.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace aethermind {
+
+Status ValidateSampleParams(const SampleParams& params) noexcept {
+    if (!std::isfinite(params.temperature) || params.temperature < 0.0F) {
+        return Status::InvalidArgument("Sample temperature must be finite and non-negative");
+    }
+    // Kernels scale logits by 1 / temperature; a subnormal temperature would
+    // overflow that to inf and turn every weight into inf or NaN.
+    if (params.temperature > 0.0F && !std::isfinite(1.0F / params.temperature)) {
+        return Status::InvalidArgument("Sample temperature is too small to invert");
+    }
+    if (params.top_k < 0) {
+        return Status::InvalidArgument("Sample top_k must be non-negative");
+    }
+    if (!(params.top_p > 0.0F && params.top_p <= 1.0F)) {
+        return Status::InvalidArgument("Sample top_p must be in (0, 1]");
+    }
+    return Status::Ok();
+}
+
+Status SampleOp::Prepare(OperatorContext& ctx) {
+    if (ctx.backend == nullptr) {
+        return Status::InvalidArgument("Sample Prepare requires OperatorContext.backend");
+    }
+    AM_RETURN_IF_ERROR(ValidateSampleParams(params_));
+
+    const auto resolved = ctx.backend->ResolveKernelInfo(
+            OpType::kSample,
+            ctx.selector);
+    if (!resolved.ok()) {
+        return resolved.status();
+    }
+
+    resolved_kernel_ = resolved.value();
+    if (resolved_kernel_.fn == nullptr) {
+        return Status::Internal("Sample Prepare resolved a kernel with null fn");
+    }
+    return Status::Ok();
+}
+
+Status SampleOp::Run(KernelContext& ctx,
+                     const RuntimeBindingContext& bindings,
+                     size_t step_index) const noexcept {
+    if (resolved_kernel_.fn == nullptr) {
+        return Status::FailedPrecondition("Sample Run called before Prepare");
+    }
+
+    const auto binding = bindings.GetStepTensorBinding(step_index);
+    if (!binding.ok()) {
+        return binding.status();
+    }
+
+    const auto* b = binding.value();
+    if (b->inputs.size() != 1) {
+        return Status::InvalidArgument(
+                "Sample requires 1 input tensor binding, got " +
+                std::to_string(b->inputs.size()));
+    }
+
+    if (b->outputs.size() != 1) {
+        return Status::InvalidArgument(
+                "Sample requires 1 output tensor binding, got " +
+                std::to_string(b->outputs.size()));
+    }
+
+    SampleKernelAttrs attrs{
+            .temperature = params_.temperature,
+            .top_p = params_.top_p,
+            .top_k = params_.top_k,
+            .seed = params_.seed,
+    };
+    if (bindings.HasDecodeBatchBinding()) {
+        return RunDecodeBatch(ctx, bindings, *b, attrs);
+    }
+
+    const RuntimeSequenceState& sequence = bindings.sequence_state();
+    attrs.stream = sequence.sampling_seed;
+    attrs.counter = sequence.current_pos;
+    ctx.attrs = std::as_bytes(std::span{&attrs, size_t{1}});
+    return InvokeResolvedKernel(ctx, b->inputs, b->outputs);
+}
+
+// Every row belongs to a different session, so rows are sampled one at a
+// time with that session's stream and position.
+Status SampleOp::RunDecodeBatch(KernelContext& ctx,
+                                const RuntimeBindingContext& bindings,
+                                const StepTensorBinding& binding,
+                                SampleKernelAttrs attrs) const noexcept {
+    const DecodeBatchBinding& batch = bindings.decode_batch_binding();
+    const TensorView& logits = binding.inputs[0];
+    const MutableTensorView& output = binding.outputs[0];
+    if (logits.rank() != 2 || !logits.is_contiguous() || !output.is_contiguous()) {
+        return Status::InvalidArgument("Batched Sample requires contiguous [batch, vocab] logits");
+    }
+    const auto batch_size = static_cast<int64_t>(batch.batch_size());
+    if (logits.dim(0) != batch_size || output.numel() != batch_size) {
+        return Status::InvalidArgument("Batched Sample logits rows must match the decode batch size");
+    }
+    if (!batch.sampling_seeds.empty() && batch.sampling_seeds.size() != batch.batch_size()) {
+        return Status::InvalidArgument("Decode batch sampling seeds must cover every row");
+    }
+
+    const int64_t vocab = logits.dim(1);
+    const int64_t row_shape[2] = {1, vocab};
+    const int64_t row_strides[2] = {vocab, 1};
+    const int64_t token_shape[1] = {1};
+    const int64_t token_strides[1] = {1};
+    const auto* logits_data = static_cast<const std::byte*>(logits.data());
+    auto* output_data = static_cast<std::byte*>(output.data());
+    for (int64_t row = 0; row < batch_size; ++row) {
+        const auto index = static_cast<size_t>(row);
+        const TensorView row_logits{logits_data + index * static_cast<size_t>(vocab) * logits.itemsize(),
+                                    logits.dtype(), row_shape, row_strides};
+        const MutableTensorView row_token{output_data + index * output.itemsize(),
+                                          output.dtype(), token_shape, token_strides};
+        attrs.stream = batch.sampling_seeds.empty() ? 0 : batch.sampling_seeds[index];
+        attrs.counter = batch.positions[index];
+        ctx.attrs = std::as_bytes(std::span{&attrs, size_t{1}});
+        AM_RETURN_IF_ERROR(InvokeResolvedKernel(ctx,
+                                                std::span{&row_logits, size_t{1}},
+                                                std::span{&row_token, size_t{1}}));
+    }
+    return Status::Ok();
+}
+
+AM_REGISTER_OPERATOR(OpType::kSample, SampleOp)
+
+
+namespace detail {
+
+StatusOr<InferenceResult> InferSample(const OpParams& params,
+                                      std::span<const TensorSpec> inputs) {
+    const auto* sample_params = std::get_if<SampleParams>(&params);
+    if (sample_params == nullptr) {
+        return Status::InvalidArgument("Sample node requires SampleParams");
+    }
+    AM_RETURN_IF_ERROR(ValidateSampleParams(*sample_params));
+    AM_RETURN_IF_ERROR(ValidateInferenceInputCount(OpType::kSample, inputs));
+    const auto& input_spec = inputs[0];
+
+    if (input_spec.dtype != DataType::Float32()) {
+        return Status::InvalidArgument("Sample logits only support float32 dtype");
+    }
+
+    InferenceResult result;
+    if (!input_spec.shape.IsRanked()) {
+        result.outputs.emplace_back(DataType::Int(64), SymbolicShape(std::nullopt));
+        return result;
+    }
+
+    const auto rank = *input_spec.shape.rank();
+    if (rank == 0) {
+        return Status::InvalidArgument("Sample logits must have rank >= 1");
+    }
+
+    // One token per row: the vocabulary (last) axis is reduced.
+    std::vector<ShapeSymbol> output_dims;
+    output_dims.reserve(rank - 1);
+    for (size_t i = 0; i + 1 < rank; ++i) {
+        output_dims.push_back(input_spec.shape[i]);
+    }
+    result.outputs.emplace_back(DataType::Int(64), SymbolicShape(output_dims));
+    return result;
+}
+
+}// namespace detail
+
+}// namespace aethermind
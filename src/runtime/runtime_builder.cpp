@@ -92,12 +92,40 @@ KVCacheManager RuntimeBuilder::BuildKVCacheManager() {
         return manager;
     }
 
-    const Status status = manager.Init(options.num_layers,
-                                       options.num_kv_heads,
-                                       options.max_tokens,
-                                       options.head_dim,
-                                       options.kv_dtype,
-                                       options.alignment);
+    Status status;
+    if (options.block_tokens != 0) {
+        status = manager.InitPaged(options.num_layers,
+                                   options.num_kv_heads,
+                                   options.max_tokens,
+                                   options.head_dim,
+                                   options.kv_dtype,
+                                   options.block_tokens,
+                                   options.num_blocks,
+                                   options.alignment,
+                                   options.num_slots,
+                                   options.layout_order);
+        if (status.ok() && !options.offload_path.empty()) {
+            status = manager.EnableDiskOffload(options.offload_path);
+        }
+    } else if (options.sliding_window) {
+        status = manager.InitSlidingWindow(options.num_layers,
+                                           options.num_kv_heads,
+                                           options.max_tokens,
+                                           options.head_dim,
+                                           options.kv_dtype,
+                                           options.alignment,
+                                           options.num_slots,
+                                           options.layout_order);
+    } else {
+        status = manager.Init(options.num_layers,
+                              options.num_kv_heads,
+                              options.max_tokens,
+                              options.head_dim,
+                              options.kv_dtype,
+                              options.alignment,
+                              options.num_slots,
+                              options.layout_order);
+    }
     AM_CHECK(status.ok(),
              "Failed to initialize runtime KVCacheManager: {}",
              status.ToString().c_str());
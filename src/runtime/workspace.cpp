@@ -0,0 +1,224 @@
+#include "aethermind/runtime/workspace.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace aethermind {
+namespace {
+
+// One requirement that still needs an offset, together with the step range
+// during which its slice must not be shared.
+struct PlacementCandidate {
+    size_t index = 0;
+    WorkspaceLiveRange range{};
+};
+
+AM_NODISCARD bool Overlaps(const WorkspaceLiveRange& lhs,
+                           const WorkspaceLiveRange& rhs) noexcept {
+    return lhs.first_step <= rhs.last_step && rhs.first_step <= lhs.last_step;
+}
+
+AM_NODISCARD bool SpansWholePlan(const WorkspaceLiveRange& range,
+                                 size_t num_steps) noexcept {
+    return range.first_step == 0 && range.last_step + 1 == num_steps;
+}
+
+// Finds the last step of the contiguous run of steps that share `layer`.
+size_t FindLayerEnd(size_t step,
+                    uint32_t layer,
+                    std::span<const std::optional<uint32_t>> step_layers) noexcept {
+    size_t last = step;
+    while (last + 1 < step_layers.size() && step_layers[last + 1] == layer) {
+        ++last;
+    }
+    return last;
+}
+
+}// namespace
+
+StatusOr<std::vector<WorkspaceLiveRange>> ComputeWorkspaceLiveRanges(
+        std::span<const WorkspaceRequirement> requirements,
+        std::span<const std::optional<uint32_t>> step_layers) {
+    if (!step_layers.empty() && step_layers.size() != requirements.size()) {
+        return Status::InvalidArgument(
+                "Workspace step layer annotations must cover every requirement");
+    }
+
+    const size_t num_steps = requirements.size();
+    const WorkspaceLiveRange whole_plan{
+            .first_step = 0,
+            .last_step = num_steps == 0 ? 0 : num_steps - 1,
+    };
+
+    std::vector<WorkspaceLiveRange> ranges;
+    ranges.reserve(num_steps);
+    for (size_t step = 0; step < num_steps; ++step) {
+        const WorkspaceRequirement& requirement = requirements[step];
+        const WorkspaceLiveRange own_step{.first_step = step, .last_step = step};
+
+        if (requirement.empty()) {
+            ranges.push_back(own_step);
+            continue;
+        }
+        if (!requirement.reusable) {
+            ranges.push_back(whole_plan);
+            continue;
+        }
+
+        switch (requirement.lifetime) {
+            case WorkspaceLifetime::kPerOperator:
+                ranges.push_back(own_step);
+                break;
+            case WorkspaceLifetime::kPerLayer: {
+                const std::optional<uint32_t> layer =
+                        step_layers.empty() ? std::nullopt : step_layers[step];
+                if (!layer.has_value()) {
+                    // Without a layer annotation the layer boundary is unknown;
+                    // keep the slice live until the end of the plan.
+                    ranges.push_back({.first_step = step, .last_step = whole_plan.last_step});
+                    break;
+                }
+                ranges.push_back({.first_step = step,
+                                  .last_step = FindLayerEnd(step, *layer, step_layers)});
+                break;
+            }
+            case WorkspaceLifetime::kNone:
+            case WorkspaceLifetime::kPerToken:
+            case WorkspaceLifetime::kPerSequence:
+            case WorkspaceLifetime::kPersistent:
+                // One plan run is one token step, so token-, sequence- and
+                // runtime-scoped scratch must survive the whole plan. kNone
+                // with non-zero bytes carries no lifetime contract and is
+                // planned conservatively.
+                ranges.push_back(whole_plan);
+                break;
+        }
+    }
+    return ranges;
+}
+
+StatusOr<WorkspacePlanLayout> PlanWorkspaceRequirementsForLiveRanges(
+        std::span<WorkspaceRequirement> requirements,
+        std::span<const WorkspaceLiveRange> ranges) {
+    if (ranges.size() != requirements.size()) {
+        return Status::InvalidArgument(
+                "Workspace live ranges must cover every requirement");
+    }
+
+    size_t num_steps = 0;
+    for (size_t i = 0; i < requirements.size(); ++i) {
+        if (!IsValidWorkspaceAlignment(requirements[i].alignment)) {
+            return Status::InvalidArgument(
+                    "Workspace requirement alignment must be a non-zero power of two");
+        }
+        if (ranges[i].first_step > ranges[i].last_step) {
+            return Status::InvalidArgument(
+                    "Workspace live range must not end before it starts");
+        }
+        num_steps = std::max(num_steps, ranges[i].last_step + 1);
+    }
+
+    // The naive sequential layout is the reference the reuse plan is measured
+    // against; plan it on a copy so offsets stay untouched on failure.
+    std::vector<WorkspaceRequirement> sequential(requirements.begin(), requirements.end());
+    AM_ASSIGN_OR_RETURN(const WorkspacePlanLayout naive,
+                        PlanWorkspaceRequirements(std::span(sequential)));
+
+    const size_t num_requirements = requirements.size();
+    std::vector<size_t> offsets(num_requirements, 0);
+    std::vector<PlacementCandidate> placed;
+    std::vector<PlacementCandidate> pending;
+    placed.reserve(num_requirements);
+    pending.reserve(num_requirements);
+
+    WorkspacePlanLayout layout;
+    layout.naive_total_bytes = naive.total_bytes;
+    layout.required_alignment = naive.required_alignment;
+
+    // Slices live for the whole plan can never share memory. Stack them at the
+    // bottom of the arena in input order, exactly as the sequential planner does.
+    for (size_t i = 0; i < num_requirements; ++i) {
+        const WorkspaceRequirement& requirement = requirements[i];
+        if (requirement.empty()) {
+            continue;
+        }
+        if (!SpansWholePlan(ranges[i], num_steps)) {
+            pending.push_back({.index = i, .range = ranges[i]});
+            continue;
+        }
+
+        AM_ASSIGN_OR_RETURN(offsets[i], AlignWorkspaceOffset(layout.total_bytes, requirement.alignment));
+        if (CheckOverflowAdd(offsets[i], requirement.bytes, &layout.total_bytes)) {
+            return Status::Overflow("Workspace planning exceeded size_t capacity");
+        }
+        placed.push_back({.index = i, .range = ranges[i]});
+    }
+
+    // Greedy-by-size interval coloring: place the largest short-lived slices
+    // first, each into the tightest gap left by slices whose live ranges
+    // overlap it, or above all of them when no gap fits.
+    std::stable_sort(pending.begin(), pending.end(),
+                     [&](const PlacementCandidate& lhs, const PlacementCandidate& rhs) noexcept {
+                         return requirements[lhs.index].bytes > requirements[rhs.index].bytes;
+                     });
+
+    std::vector<const PlacementCandidate*> conflicts;
+    for (const PlacementCandidate& candidate: pending) {
+        const WorkspaceRequirement& requirement = requirements[candidate.index];
+
+        conflicts.clear();
+        for (const PlacementCandidate& other: placed) {
+            if (Overlaps(candidate.range, other.range)) {
+                conflicts.push_back(&other);
+            }
+        }
+        std::sort(conflicts.begin(), conflicts.end(),
+                  [&](const PlacementCandidate* lhs, const PlacementCandidate* rhs) noexcept {
+                      return offsets[lhs->index] < offsets[rhs->index];
+                  });
+
+        std::optional<size_t> best_offset;
+        size_t best_gap = 0;
+        size_t cursor = 0;
+        for (const PlacementCandidate* other: conflicts) {
+            const size_t other_offset = offsets[other->index];
+            AM_ASSIGN_OR_RETURN(const size_t aligned, AlignWorkspaceOffset(cursor, requirement.alignment));
+            if (aligned <= other_offset && other_offset - aligned >= requirement.bytes) {
+                const size_t gap = other_offset - cursor;
+                if (!best_offset.has_value() || gap < best_gap) {
+                    best_offset = aligned;
+                    best_gap = gap;
+                }
+            }
+            cursor = std::max(cursor, other_offset + requirements[other->index].bytes);
+        }
+
+        if (!best_offset.has_value()) {
+            AM_ASSIGN_OR_RETURN(best_offset, AlignWorkspaceOffset(cursor, requirement.alignment));
+        }
+
+        offsets[candidate.index] = *best_offset;
+        size_t end = 0;
+        if (CheckOverflowAdd(*best_offset, requirement.bytes, &end)) {
+            return Status::Overflow("Workspace planning exceeded size_t capacity");
+        }
+        layout.total_bytes = std::max(layout.total_bytes, end);
+        placed.push_back(candidate);
+    }
+
+    // Zero-byte requirements consume no space; they are anchored at the base.
+    for (size_t i = 0; i < num_requirements; ++i) {
+        requirements[i].offset = requirements[i].empty() ? 0 : offsets[i];
+    }
+    return layout;
+}
+
+StatusOr<WorkspacePlanLayout> PlanWorkspaceRequirementsWithReuse(
+        std::span<WorkspaceRequirement> requirements,
+        std::span<const std::optional<uint32_t>> step_layers) {
+    AM_ASSIGN_OR_RETURN(const std::vector<WorkspaceLiveRange> ranges,
+                        ComputeWorkspaceLiveRanges(requirements, step_layers));
+    return PlanWorkspaceRequirementsForLiveRanges(requirements, ranges);
+}
+
+}// namespace aethermind
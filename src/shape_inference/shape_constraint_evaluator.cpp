@@ -3,6 +3,9 @@
 #include "utils/overflow_check.h"
 #include "utils/variant_utils.h"
 
+#include <optional>
+#include <vector>
+
 namespace aethermind {
 namespace {
 
@@ -334,6 +337,37 @@ AM_NODISCARD ShapeConstraintEvaluationResult EvaluateRuntimeRankAtLeastConstrain
                                        : ShapeConstraintEvaluationResult::kViolated;
 }
 
+AM_NODISCARD std::vector<SymbolicShape> SubstituteStaticBindings(
+        const std::span<const SymbolicShape> shapes,
+        const SymbolConstraintSolver& solver) {
+    std::vector<SymbolicShape> substituted;
+    substituted.reserve(shapes.size());
+    for (const SymbolicShape& shape: shapes) {
+        if (!shape.IsRanked()) {
+            substituted.push_back(shape);
+            continue;
+        }
+        std::vector<ShapeSymbol> dims;
+        dims.reserve(*shape.rank());
+        for (const ShapeSymbol& dim: shape) {
+            const std::optional<int64_t> binding = solver.GetStaticBinding(dim);
+            dims.push_back(binding.has_value() ? ShapeSymbol::CreateFromValue(*binding) : dim);
+        }
+        substituted.emplace_back(std::move(dims));
+    }
+    return substituted;
+}
+
+AM_NODISCARD bool AreSolverEqualDims(const DimLocator& lhs_locator,
+                                     const DimLocator& rhs_locator,
+                                     const std::span<const SymbolicShape> inputs,
+                                     const std::span<const SymbolicShape> outputs,
+                                     const SymbolConstraintSolver& solver) {
+    const auto lhs = ResolveSymbolicDim(lhs_locator, inputs, outputs);
+    const auto rhs = ResolveSymbolicDim(rhs_locator, inputs, outputs);
+    return lhs && rhs && solver.AreEqual(*lhs, *rhs);
+}
+
 }// namespace
 
 ShapeConstraintEvaluationResult EvaluateShapeConstraint(const ShapeConstraint& constraint,
@@ -362,6 +396,51 @@ ShapeConstraintEvaluationResult EvaluateShapeConstraint(const ShapeConstraint& c
     return std::visit(visitor, constraint.condition);
 }
 
+ShapeConstraintEvaluationResult EvaluateShapeConstraint(const ShapeConstraint& constraint,
+                                                        const std::span<const SymbolicShape> inputs,
+                                                        const std::span<const SymbolicShape> outputs,
+                                                        const SymbolConstraintSolver& solver) {
+    const std::vector<SymbolicShape> bound_inputs = SubstituteStaticBindings(inputs, solver);
+    const std::vector<SymbolicShape> bound_outputs = SubstituteStaticBindings(outputs, solver);
+    const auto result = EvaluateShapeConstraint(constraint, bound_inputs, bound_outputs);
+    if (result != ShapeConstraintEvaluationResult::kDeferred) {
+        return result;
+    }
+
+    // Statically bound symbols are already substituted; what remains is
+    // equality between distinct symbols of one solver class.
+    const auto satisfied_if = [](bool proven) {
+        return proven ? ShapeConstraintEvaluationResult::kSatisfied
+                      : ShapeConstraintEvaluationResult::kDeferred;
+    };
+    auto visitor = overloaded{
+            [&](const DimEqualConstraint& dim_equal) {
+                return satisfied_if(AreSolverEqualDims(dim_equal.lhs, dim_equal.rhs,
+                                                       bound_inputs, bound_outputs, solver));
+            },
+            [&](const DimBroadcastableConstraint& broadcastable) {
+                return satisfied_if(AreSolverEqualDims(broadcastable.lhs, broadcastable.rhs,
+                                                       bound_inputs, bound_outputs, solver));
+            },
+            [&](const VolumeEqualConstraint& volume_equal) {
+                if (volume_equal.lhs_dims.size() != volume_equal.rhs_dims.size()) {
+                    return ShapeConstraintEvaluationResult::kDeferred;
+                }
+                for (size_t i = 0; i < volume_equal.lhs_dims.size(); ++i) {
+                    if (!AreSolverEqualDims(volume_equal.lhs_dims[i], volume_equal.rhs_dims[i],
+                                            bound_inputs, bound_outputs, solver)) {
+                        return ShapeConstraintEvaluationResult::kDeferred;
+                    }
+                }
+                return ShapeConstraintEvaluationResult::kSatisfied;
+            },
+            [](const auto&) {
+                return ShapeConstraintEvaluationResult::kDeferred;
+            },
+    };
+    return std::visit(visitor, constraint.condition);
+}
+
 ShapeConstraintEvaluationResult EvaluateShapeConstraint(const ShapeConstraint& constraint,
                                                         const std::span<const TensorView> inputs,
                                                         const std::span<const MutableTensorView> outputs) {
@@ -0,0 +1,107 @@
+#include "aethermind/execution/kv_cache_manager.h"
+#include "aethermind/execution/kv_decode_attention.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr size_t kNumKVHeads = 8;
+constexpr size_t kHeadDim = 128;
+constexpr size_t kMaxTokens = 8192;
+
+KVLayoutOrder OrderArg(const benchmark::State& state) {
+    return state.range(0) == 0 ? KVLayoutOrder::kHeadMajor : KVLayoutOrder::kTokenMajor;
+}
+
+// Appends `count` tokens at `first_pos` for every head, the way a KV update
+// kernel copies one projected token row per head.
+bool AppendTokens(KVCacheView& view, size_t first_pos, size_t count, const std::vector<float>& row) {
+    for (size_t pos = first_pos; pos < first_pos + count; ++pos) {
+        for (size_t head = 0; head < kNumKVHeads; ++head) {
+            StatusOr<void*> key = view.MutableKeyData(0, head, pos);
+            StatusOr<void*> value = view.MutableValueData(0, head, pos);
+            if (!key.ok() || !value.ok()) {
+                return false;
+            }
+            std::memcpy(*key, row.data(), kHeadDim * sizeof(float));
+            std::memcpy(*value, row.data(), kHeadDim * sizeof(float));
+        }
+    }
+    return true;
+}
+
+std::vector<float> MakeRow() {
+    std::vector<float> row(kHeadDim);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        row[d] = std::sin(static_cast<float>(d)) * 0.1F;
+    }
+    return row;
+}
+
+void BM_KVLayout_PrefillAppend(benchmark::State& state) {
+    const auto chunk = static_cast<size_t>(state.range(1));
+    KVCacheManager manager;
+    if (!manager.Init(1, kNumKVHeads, kMaxTokens, kHeadDim, DataType::Float32(), 64, 1, OrderArg(state)).ok()) {
+        state.SkipWithError("KVCacheManager::Init failed");
+        return;
+    }
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(kMaxTokens, 0);
+    const std::vector<float> row = MakeRow();
+
+    size_t pos = 0;
+    for (auto _: state) {
+        if (pos + chunk > kMaxTokens) {
+            pos = 0;
+        }
+        const bool ok = AppendTokens(*view, pos, chunk, row);
+        benchmark::DoNotOptimize(ok);
+        pos += chunk;
+    }
+    const auto bytes = static_cast<std::int64_t>(2 * chunk * kNumKVHeads * kHeadDim * sizeof(float));
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+void BM_KVLayout_DecodeScan(benchmark::State& state) {
+    const auto seq_len = static_cast<size_t>(state.range(1));
+    KVCacheManager manager;
+    if (!manager.Init(1, kNumKVHeads, kMaxTokens, kHeadDim, DataType::Float32(), 64, 1, OrderArg(state)).ok()) {
+        state.SkipWithError("KVCacheManager::Init failed");
+        return;
+    }
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(seq_len, 0);
+    const std::vector<float> row = MakeRow();
+    if (!AppendTokens(*view, 0, seq_len, row) || !view->CommitUntil(seq_len).ok()) {
+        state.SkipWithError("KV prefill failed");
+        return;
+    }
+
+    const std::vector<float> query = MakeRow();
+    std::vector<float> output(kHeadDim);
+    const float softmax_scale = 1.0F / std::sqrt(static_cast<float>(kHeadDim));
+    for (auto _: state) {
+        for (size_t head = 0; head < kNumKVHeads; ++head) {
+            const bool ok = DecodeAttention(*view, 0, head, query, softmax_scale, output).ok();
+            benchmark::DoNotOptimize(ok);
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+    const auto bytes = static_cast<std::int64_t>(2 * seq_len * kNumKVHeads * kHeadDim * sizeof(float));
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// order: 0 = head-major, 1 = token-major.
+BENCHMARK(BM_KVLayout_PrefillAppend)
+        ->ArgsProduct({{0, 1}, {1, 64, 512}})
+        ->ArgNames({"order", "chunk"});
+
+BENCHMARK(BM_KVLayout_DecodeScan)
+        ->ArgsProduct({{0, 1}, {512, 2048, 8192}})
+        ->ArgNames({"order", "seq_len"});
+
+}// namespace
@@ -0,0 +1,283 @@
+#include "aethermind/backend/cpu/cpu_backend.h"
+#include "aethermind/backend/kernel_context.h"
+#include "aethermind/base/tensor_view.h"
+#include "aethermind/execution/execution_plan.h"
+#include "aethermind/execution/execution_plan_builder.h"
+#include "aethermind/execution/executor.h"
+#include "aethermind/execution/runtime_binding_context.h"
+#include "aethermind/operators/op_params.h"
+#include "aethermind/operators/operator_inference.h"
+#include "aethermind/operators/sample_op.h"
+#include "aethermind/runtime/runtime_builder.h"
+#include "backend/cpu/kernels/sample/sample_internal.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr IsaLevel kIsas[] = {IsaLevel::kScalar, IsaLevel::kAVX2};
+
+KernelFunc ResolveSampleEntry(IsaLevel isa) {
+    CpuBackend backend;
+    return backend.ResolveKernel(OpType::kSample,
+                                 KernelSelector{
+                                         .device_type = DeviceType::kCPU,
+                                         .act_dtype = DataType::Float32(),
+                                         .weight_dtype = DataType::Float32(),
+                                         .weight_format = WeightFormat::kPlain,
+                                         .isa = isa,
+                                         .phase = ExecPhase::kBoth,
+                                 });
+}
+
+// Samples every row of `[rows, vocab]` logits through the registered entry.
+StatusOr<std::vector<int64_t>> RunSample(IsaLevel isa,
+                                         const std::vector<float>& logits,
+                                         int64_t vocab,
+                                         const SampleKernelAttrs& attrs) {
+    const KernelFunc fn = ResolveSampleEntry(isa);
+    if (fn == nullptr) {
+        return Status::NotFound("Sample kernel entry is not registered");
+    }
+    const int64_t rows = static_cast<int64_t>(logits.size()) / vocab;
+    std::vector<int64_t> tokens(static_cast<size_t>(rows), -1);
+    const int64_t logits_shape[2] = {rows, vocab};
+    const int64_t logits_strides[2] = {vocab, 1};
+    const int64_t token_shape[1] = {rows};
+    const int64_t token_strides[1] = {1};
+    const cpu::detail::SampleParams params{
+            .logits = TensorView{logits.data(), DataType::Float32(), logits_shape, logits_strides},
+            .output = MutableTensorView{tokens.data(), DataType::Int(64), token_shape, token_strides},
+    };
+    AM_RETURN_IF_ERROR(fn(KernelContext{
+            .kernel_params = &params,
+            .attrs = std::as_bytes(std::span{&attrs, size_t{1}}),
+    }));
+    return tokens;
+}
+
+// One row of `vocab` logits repeated `rows` times.
+std::vector<float> RepeatRow(const std::vector<float>& row, size_t rows) {
+    std::vector<float> logits;
+    for (size_t r = 0; r < rows; ++r) {
+        logits.insert(logits.end(), row.begin(), row.end());
+    }
+    return logits;
+}
+
+std::vector<float> PseudoRandomRow(size_t vocab) {
+    std::vector<float> row(vocab);
+    for (size_t i = 0; i < vocab; ++i) {
+        row[i] = static_cast<float>((i * 7919U) % 1000U) / 100.0F;
+    }
+    return row;
+}
+
+TEST(CPUKernelSample, ZeroTemperatureIsArgmax) {
+    std::vector<float> row = PseudoRandomRow(1000);
+    row[123] = 50.0F;
+    row[777] = 50.0F;
+    for (const IsaLevel isa: kIsas) {
+        const auto tokens = RunSample(isa, RepeatRow(row, 3), 1000, SampleKernelAttrs{.temperature = 0.0F});
+        ASSERT_TRUE(tokens.ok()) << tokens.status().ToString();
+        EXPECT_EQ(*tokens, (std::vector<int64_t>{123, 123, 123}));
+    }
+}
+
+TEST(CPUKernelSample, TopKOnlyDrawsTheLargestLogits) {
+    const std::vector<float> row = PseudoRandomRow(1000);
+    std::vector<float> sorted = row;
+    std::sort(sorted.begin(), sorted.end(), std::greater<>());
+    const float fifth = sorted[4];
+
+    for (const IsaLevel isa: kIsas) {
+        const auto tokens = RunSample(isa, RepeatRow(row, 200), 1000,
+                                      SampleKernelAttrs{.temperature = 5.0F, .top_k = 5, .seed = 1});
+        ASSERT_TRUE(tokens.ok()) << tokens.status().ToString();
+        std::set<int64_t> drawn(tokens->begin(), tokens->end());
+        EXPECT_GT(drawn.size(), 1U);
+        for (const int64_t token: drawn) {
+            EXPECT_GE(row[static_cast<size_t>(token)], fifth) << token;
+        }
+    }
+}
+
+TEST(CPUKernelSample, TopPKeepsTheSmallestNucleus) {
+    // Probabilities 0.5, 0.3 and 0.2 spread over 298 tail tokens: top_p = 0.7
+    // keeps exactly the first two.
+    std::vector<float> row(300, std::log(0.2F / 298.0F));
+    row[10] = std::log(0.5F);
+    row[20] = std::log(0.3F);
+    for (const IsaLevel isa: kIsas) {
+        const auto tokens = RunSample(isa, RepeatRow(row, 200), 300,
+                                      SampleKernelAttrs{.top_p = 0.7F, .seed = 2});
+        ASSERT_TRUE(tokens.ok()) << tokens.status().ToString();
+        const std::set<int64_t> drawn(tokens->begin(), tokens->end());
+        EXPECT_EQ(drawn, (std::set<int64_t>{10, 20}));
+    }
+}
+
+TEST(CPUKernelSample, TopPGrowsTheCandidateSetBeyondTheFirstRound) {
+    // A flat row needs 270 of 300 tokens to reach 0.9; ties keep index order.
+    const std::vector<float> row(300, 1.0F);
+    for (const IsaLevel isa: kIsas) {
+        const auto tokens = RunSample(isa, RepeatRow(row, 400), 300,
+                                      SampleKernelAttrs{.top_p = 0.9F, .seed = 3});
+        ASSERT_TRUE(tokens.ok()) << tokens.status().ToString();
+        EXPECT_LT(*std::max_element(tokens->begin(), tokens->end()), 270);
+        EXPECT_GE(*std::max_element(tokens->begin(), tokens->end()), 64);
+    }
+}
+
+TEST(CPUKernelSample, FollowsTheSoftmaxDistribution) {
+    const std::vector<float> row = {std::log(0.25F), std::log(0.75F)};
+    const auto tokens = RunSample(IsaLevel::kScalar, RepeatRow(row, 4000), 2, SampleKernelAttrs{.seed = 4});
+    ASSERT_TRUE(tokens.ok()) << tokens.status().ToString();
+    const auto ones = std::count(tokens->begin(), tokens->end(), 1);
+    EXPECT_NEAR(static_cast<double>(ones) / 4000.0, 0.75, 0.03);
+}
+
+TEST(CPUKernelSample, StreamIsCounterBasedAndIsaIndependent) {
+    const std::vector<float> logits = RepeatRow(PseudoRandomRow(1000), 8);
+    const SampleKernelAttrs attrs{.temperature = 2.0F, .top_p = 0.9F, .top_k = 50, .seed = 9, .stream = 5};
+
+    const auto scalar = RunSample(IsaLevel::kScalar, logits, 1000, attrs);
+    const auto avx2 = RunSample(IsaLevel::kAVX2, logits, 1000, attrs);
+    ASSERT_TRUE(scalar.ok() && avx2.ok());
+    EXPECT_EQ(*scalar, *avx2);
+
+    // Row r uses counter `counter + r`: starting three counters later replays
+    // the tail of the first run.
+    SampleKernelAttrs shifted = attrs;
+    shifted.counter = 3;
+    const auto replay = RunSample(IsaLevel::kScalar, RepeatRow(PseudoRandomRow(1000), 5), 1000, shifted);
+    ASSERT_TRUE(replay.ok());
+    EXPECT_TRUE(std::equal(replay->begin(), replay->end(), scalar->begin() + 3));
+
+    SampleKernelAttrs other_stream = attrs;
+    other_stream.stream = 6;
+    const auto other = RunSample(IsaLevel::kScalar, logits, 1000, other_stream);
+    ASSERT_TRUE(other.ok());
+    EXPECT_NE(*other, *scalar);
+}
+
+TEST(CPUKernelSampleEntry, RejectsInvalidAttrsAndViews) {
+    const std::vector<float> logits(8, 0.0F);
+    EXPECT_EQ(RunSample(IsaLevel::kScalar, logits, 8, SampleKernelAttrs{.top_p = 0.0F}).status().code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_EQ(RunSample(IsaLevel::kScalar, logits, 8, SampleKernelAttrs{.top_k = -2}).status().code(),
+              StatusCode::kInvalidArgument);
+
+    const KernelFunc fn = ResolveSampleEntry(IsaLevel::kScalar);
+    ASSERT_NE(fn, nullptr);
+    const SampleKernelAttrs attrs{};
+    EXPECT_FALSE(fn(KernelContext{.attrs = std::as_bytes(std::span{&attrs, size_t{1}})}).ok());
+
+    // Output must hold one token per row.
+    int64_t tokens[1] = {};
+    const int64_t logits_shape[2] = {2, 4};
+    const int64_t logits_strides[2] = {4, 1};
+    const int64_t token_shape[1] = {1};
+    const int64_t token_strides[1] = {1};
+    const cpu::detail::SampleParams params{
+            .logits = TensorView{logits.data(), DataType::Float32(), logits_shape, logits_strides},
+            .output = MutableTensorView{tokens, DataType::Int(64), token_shape, token_strides},
+    };
+    EXPECT_FALSE(fn(KernelContext{.kernel_params = &params,
+                                  .attrs = std::as_bytes(std::span{&attrs, size_t{1}})})
+                         .ok());
+}
+
+class SampleOperatorTest : public ::testing::Test {
+protected:
+    static constexpr int64_t kVocab = 1000;
+    static constexpr SampleParams kParams{.temperature = 1.5F, .top_k = 20, .top_p = 0.95F, .seed = 11};
+
+    void SetUp() override {
+        const std::vector<TensorSpec> inputs = {
+                TensorSpec{.dtype = DataType::Float32(), .shape = SymbolicShape(IntArrayView{shape_})},
+        };
+        const auto analyzed = InferOperator(OpType::kSample, OpParams{kParams}, inputs);
+        ASSERT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+        std::vector<ExecutionPlanNodeSpec> nodes;
+        nodes.push_back(ExecutionPlanNodeSpec{
+                .op_type = OpType::kSample,
+                .device_type = DeviceType::kCPU,
+                .act_dtype = DataType::Float32(),
+                .weight_dtype = DataType::Float32(),
+                .weight_format = WeightFormat::kPlain,
+                .isa = IsaLevel::kScalar,
+                .phase = ExecPhase::kBoth,
+                .input_specs = inputs,
+                .output_specs = analyzed->outputs,
+                .op_params = OpParams{kParams},
+        });
+        StatusOr<ExecutionPlan> plan = ExecutionPlanBuilder::Build(runtime_, nodes);
+        ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+        plan_.emplace(std::move(*plan));
+
+        logits_ = RepeatRow(PseudoRandomRow(kVocab), 2);
+        bindings_.SetStepTensorBinding(0, StepTensorBinding{
+                                                  .inputs = {TensorView{logits_.data(), DataType::Float32(), shape_, strides_}},
+                                                  .outputs = {MutableTensorView{tokens_, DataType::Int(64), token_shape_, token_strides_}},
+                                          });
+    }
+
+    SampleKernelAttrs Attrs(uint64_t stream, uint64_t counter) const {
+        return SampleKernelAttrs{.temperature = kParams.temperature,
+                                 .top_p = kParams.top_p,
+                                 .top_k = kParams.top_k,
+                                 .seed = kParams.seed,
+                                 .stream = stream,
+                                 .counter = counter};
+    }
+
+    RuntimeContext runtime_ = RuntimeBuilder().Build();
+    std::optional<ExecutionPlan> plan_;
+    RuntimeBindingContext bindings_;
+    std::vector<float> logits_;
+    int64_t tokens_[2] = {-1, -1};
+    const int64_t shape_[2] = {2, kVocab};
+    const int64_t strides_[2] = {kVocab, 1};
+    const int64_t token_shape_[1] = {2};
+    const int64_t token_strides_[1] = {1};
+};
+
+TEST_F(SampleOperatorTest, DrawsFromTheSessionStreamAtItsPosition) {
+    RuntimeSequenceState& sequence = bindings_.mutable_sequence_state();
+    sequence.current_pos = 17;
+    sequence.sampling_seed = 42;
+    ASSERT_TRUE(Executor::Execute(*plan_, bindings_).ok());
+
+    const auto expected = RunSample(IsaLevel::kScalar, logits_, kVocab, Attrs(42, 17));
+    ASSERT_TRUE(expected.ok());
+    EXPECT_EQ(std::vector<int64_t>(tokens_, tokens_ + 2), *expected);
+}
+
+TEST_F(SampleOperatorTest, DecodeBatchRowsUseTheirOwnSessionStream) {
+    std::vector<KVCacheView> views(2);
+    const size_t positions[2] = {4, 9};
+    const uint64_t seeds[2] = {100, 200};
+    bindings_.SetDecodeBatchBinding(DecodeBatchBinding{
+            .kv_cache_views = views,
+            .positions = positions,
+            .sampling_seeds = seeds,
+    });
+    ASSERT_TRUE(Executor::Execute(*plan_, bindings_).ok());
+
+    const std::vector<float> row(logits_.begin(), logits_.begin() + kVocab);
+    for (size_t b = 0; b < 2; ++b) {
+        const auto expected = RunSample(IsaLevel::kScalar, row, kVocab, Attrs(seeds[b], positions[b]));
+        ASSERT_TRUE(expected.ok());
+        EXPECT_EQ(tokens_[b], (*expected)[0]) << b;
+    }
+}
+
+}// namespace
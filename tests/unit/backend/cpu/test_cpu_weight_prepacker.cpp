@@ -4,11 +4,19 @@
 #include "aethermind/backend/packed_weights.h"
 #include "aethermind/base/status.h"
 #include "aethermind/base/tensor.h"
+#include "aethermind/dtypes/bfloat16.h"
 #include "aethermind/memory/buffer.h"
 #include "aethermind/operators/op_type.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <gtest/gtest.h>
+#include <memory>
+#include <vector>
 
 namespace {
 
@@ -50,6 +58,13 @@ KernelSelector MakePackedCpuSelector() {
     };
 }
 
+KernelSelector MakeQuantizedCpuSelector(WeightFormat format) {
+    KernelSelector selector = MakePackedCpuSelector();
+    selector.weight_dtype = format == WeightFormat::kQuantizedInt8 ? DataType::Int(8) : DataType::Int(4);
+    selector.weight_format = format;
+    return selector;
+}
+
 TEST(CpuWeightPrepacker, PackBuildsPackedWeightsWithCpuStorageAndSelectorMetadata) {
     CpuWeightPrepacker prepacker;
     const Tensor logical_weight = MakeLogicalWeightTensor(4, 8);
@@ -92,4 +107,237 @@ TEST(CpuWeightPrepacker, PackAcceptsLogicalWeightTensorView) {
     EXPECT_EQ((*packed)->storage().nbytes(), logical_weight.logical_nbytes());
 }
 
+TEST(CpuWeightPrepacker, PackWritesIntoTheGivenStorage) {
+    CpuWeightPrepacker prepacker;
+    const std::vector<float> values = {1.0F, -2.0F, 3.0F, -4.0F};
+    const int64_t shape[2] = {2, 2};
+    const int64_t strides[2] = {2, 1};
+    const TensorView view(values.data(), DataType::Float32(), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+
+    const Buffer storage = MakeTestBuffer(sizeof(float) * values.size());
+    const auto packed = prepacker.Pack(OpType::kLinear, view, MakePackedCpuSelector(), storage);
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    EXPECT_EQ((*packed)->storage().data(), storage.data());
+    EXPECT_EQ(std::memcmp(storage.data(), values.data(), storage.nbytes()), 0);
+
+    const auto layout = CpuQuantizedWeightLayout::Make(WeightFormat::kQuantizedInt8, 2, 2, 0);
+    ASSERT_TRUE(layout.ok());
+    const Buffer quantized_storage = MakeTestBuffer(layout->nbytes);
+    const auto quantized = prepacker.PackQuantized(OpType::kLinear, view,
+                                                   MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt8), 0,
+                                                   nullptr, quantized_storage);
+    ASSERT_TRUE(quantized.ok()) << quantized.status().ToString();
+    EXPECT_EQ((*quantized)->storage().data(), quantized_storage.data());
+
+    // Storage that does not hold exactly the packed bytes is rejected.
+    EXPECT_EQ(prepacker.Pack(OpType::kLinear, view, MakePackedCpuSelector(), MakeTestBuffer(8)).status().code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(CpuWeightPrepacker, AliasWrapsLogicalBytesAndKeepsTheOwnerAlive) {
+    CpuWeightPrepacker prepacker;
+    struct alignas(64) Values {
+        float data[4] = {1.0F, 2.0F, 3.0F, 4.0F};
+    };
+    auto owner = std::make_shared<Values>();
+    const std::weak_ptr<Values> observer = owner;
+    const int64_t shape[2] = {2, 2};
+    const int64_t strides[2] = {2, 1};
+    const TensorView view(owner->data, DataType::Float32(), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    const KernelSelector selector = MakePackedCpuSelector();
+    ASSERT_TRUE(prepacker.CanAlias(OpType::kLinear, view, selector));
+
+    auto packed = prepacker.Alias(OpType::kLinear, view, selector, std::move(owner));
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    EXPECT_EQ((*packed)->storage().data(), view.data());
+    EXPECT_EQ((*packed)->storage().nbytes(), 4 * sizeof(float));
+    EXPECT_EQ((*packed)->storage().alignment(), CpuWeightPrepacker::kStorageAlignment);
+    // Checkpoint bytes are never handed out for writing.
+    EXPECT_TRUE((*packed)->storage().read_only());
+    EXPECT_EQ(Buffer((*packed)->storage()).mutable_data(), nullptr);
+    EXPECT_EQ((*packed)->selector(), selector);
+    EXPECT_FALSE(observer.expired());
+    packed->reset();
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST(CpuWeightPrepacker, CanAliasRejectsLayoutsThatNeedACopy) {
+    CpuWeightPrepacker prepacker;
+    alignas(64) float values[9] = {};
+    const int64_t shape[2] = {2, 2};
+    const int64_t strides[2] = {2, 1};
+    const int64_t transposed_strides[2] = {1, 2};
+    const KernelSelector selector = MakePackedCpuSelector();
+
+    const TensorView misaligned(reinterpret_cast<const std::byte*>(values) + 2, DataType::Float32(),
+                                IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    EXPECT_FALSE(prepacker.CanAlias(OpType::kLinear, misaligned, selector));
+    // Element-aligned is not enough: packed storage promises 64 bytes.
+    const TensorView element_aligned(values + 1, DataType::Float32(), IntArrayView(shape, 2),
+                                     IntArrayView(strides, 2), 0);
+    EXPECT_FALSE(prepacker.CanAlias(OpType::kLinear, element_aligned, selector));
+
+    const TensorView transposed(values, DataType::Float32(), IntArrayView(shape, 2),
+                                IntArrayView(transposed_strides, 2), 0);
+    EXPECT_FALSE(prepacker.CanAlias(OpType::kLinear, transposed, selector));
+
+    const TensorView plain(values, DataType::Float32(), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    KernelSelector bf16_selector = selector;
+    bf16_selector.weight_dtype = DataType::BFloat(16);
+    EXPECT_FALSE(prepacker.CanAlias(OpType::kLinear, plain, bf16_selector));
+    EXPECT_FALSE(prepacker.Alias(OpType::kLinear, plain, bf16_selector, std::make_shared<int>(0)).ok());
+    EXPECT_FALSE(prepacker.Alias(OpType::kLinear, plain, selector, nullptr).ok());
+}
+
+TEST(CpuWeightPrepacker, PackQuantizedInt8StoresPerChannelScalesAndReportsError) {
+    CpuWeightPrepacker prepacker;
+    const std::vector<float> values = {0.5F, -1.0F, 0.25F, 0.0F, 10.0F, 3.3F, -7.1F, 2.0F};
+    const int64_t shape[2] = {2, 4};
+    const int64_t strides[2] = {4, 1};
+    const TensorView view(values.data(), DataType::Float32(), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    WeightQuantizationError error;
+
+    const auto packed = prepacker.PackQuantized(
+            OpType::kLinear, view, MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt8), 0, &error);
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    const auto layout = CpuQuantizedWeightLayout::Make(WeightFormat::kQuantizedInt8, 2, 4, 0);
+    ASSERT_TRUE(layout.ok());
+    EXPECT_EQ(layout->groups_per_row, 1U);
+    ASSERT_EQ((*packed)->storage().nbytes(), layout->nbytes);
+    const auto* bytes = static_cast<const std::byte*>((*packed)->storage().data());
+    const auto* levels = reinterpret_cast<const int8_t*>(bytes);
+    const auto* scales = reinterpret_cast<const float*>(bytes + layout->scales_offset);
+    EXPECT_FLOAT_EQ(scales[0], 1.0F / 127.0F);
+    EXPECT_FLOAT_EQ(scales[1], 10.0F / 127.0F);
+    EXPECT_EQ(levels[1], -127);
+    EXPECT_EQ(levels[4], 127);
+
+    float max_error = 0.0F;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const float restored = static_cast<float>(levels[i]) * scales[i / 4];
+        EXPECT_LE(std::fabs(restored - values[i]), scales[i / 4] / 2 + 1e-6F) << i;
+        max_error = std::max(max_error, std::fabs(restored - values[i]));
+    }
+    EXPECT_FLOAT_EQ(error.max_abs_error, max_error);
+    EXPECT_GT(error.rms_error, 0.0F);
+    EXPECT_LE(error.rms_error, error.max_abs_error);
+}
+
+TEST(CpuWeightPrepacker, PackQuantizedInt4PacksNibblesWithAShortLastGroup) {
+    CpuWeightPrepacker prepacker;
+    // One row of five bfloat16 values in groups of two: {7, -7}, {2, 1.2}, {-3}.
+    const std::vector<BFloat16> values = {7.0F, -7.0F, 2.0F, 1.2F, -3.0F};
+    const int64_t shape[2] = {1, 5};
+    const int64_t strides[2] = {5, 1};
+    const TensorView view(values.data(), DataType::BFloat(16), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    WeightQuantizationError error;
+
+    const auto packed = prepacker.PackQuantized(
+            OpType::kLinear, view, MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt4), 2, &error);
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    const auto layout = CpuQuantizedWeightLayout::Make(WeightFormat::kQuantizedInt4, 1, 5, 2);
+    ASSERT_TRUE(layout.ok());
+    EXPECT_EQ(layout->groups_per_row, 3U);
+    EXPECT_EQ(layout->row_bytes, 3U);
+    const auto* bytes = static_cast<const uint8_t*>((*packed)->storage().data());
+    const auto* scales = reinterpret_cast<const float*>(bytes + layout->scales_offset);
+    EXPECT_FLOAT_EQ(scales[0], 1.0F);
+    EXPECT_FLOAT_EQ(scales[1], 2.0F / 7.0F);
+    EXPECT_FLOAT_EQ(scales[2], 3.0F / 7.0F);
+    EXPECT_EQ(bytes[0], 0x97);// -7 (0x9) high, 7 low
+    EXPECT_EQ(bytes[1], 0x47);// round(1.2 * 3.5) = 4 high, 7 low
+    EXPECT_EQ(bytes[2], 0x09);// -7 low, unused high nibble
+    EXPECT_NEAR(error.max_abs_error, static_cast<float>(values[3]) - 4.0F * scales[1], 1e-6F);
+}
+
+TEST(CpuWeightPrepacker, PackQuantizedRejectsUnsupportedRequests) {
+    CpuWeightPrepacker prepacker;
+    const std::vector<float> values(4, 1.0F);
+    const int64_t shape[2] = {2, 2};
+    const int64_t strides[2] = {2, 1};
+    const TensorView view(values.data(), DataType::Float32(), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    const std::vector<int8_t> int_values(4, 1);
+    const TensorView int_view(int_values.data(), DataType::Int(8), IntArrayView(shape, 2), IntArrayView(strides, 2), 0);
+    const TensorView vector_view(values.data(), DataType::Float32(), IntArrayView(shape, 1), IntArrayView(strides + 1, 1), 0);
+
+    EXPECT_FALSE(prepacker.PackQuantized(OpType::kLinear, view, MakePackedCpuSelector(), 0).ok());
+    EXPECT_FALSE(prepacker.PackQuantized(
+                                  OpType::kLinear, int_view, MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt8), 0)
+                         .ok());
+    EXPECT_FALSE(prepacker.PackQuantized(
+                                  OpType::kLinear, vector_view, MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt4), 2)
+                         .ok());
+}
+
+// One GGML block: a little-endian float16 scale followed by `levels`.
+void AppendGgmlBlock(std::vector<std::byte>& blocks, uint16_t scale_bits, const std::vector<uint8_t>& levels) {
+    blocks.push_back(static_cast<std::byte>(scale_bits & 0xFFU));
+    blocks.push_back(static_cast<std::byte>(scale_bits >> 8U));
+    for (const uint8_t level: levels) {
+        blocks.push_back(static_cast<std::byte>(level));
+    }
+}
+
+TEST(CpuWeightPrepacker, PackQuantizedBlocksCopiesQ8_0LevelsAndScales) {
+    CpuWeightPrepacker prepacker;
+    // One row of two blocks scaled by 1 and 2.
+    std::vector<uint8_t> first(32);
+    std::vector<uint8_t> second(32);
+    for (size_t i = 0; i < 32; ++i) {
+        first[i] = static_cast<uint8_t>(static_cast<int8_t>(static_cast<int>(i) - 16));
+        second[i] = static_cast<uint8_t>(static_cast<int8_t>(-static_cast<int>(i)));
+    }
+    std::vector<std::byte> blocks;
+    AppendGgmlBlock(blocks, 0x3C00, first);
+    AppendGgmlBlock(blocks, 0x4000, second);
+
+    const auto packed = prepacker.PackQuantizedBlocks(OpType::kLinear, blocks.data(), blocks.size(), 1, 64,
+                                                      MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt8));
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    const auto layout = CpuQuantizedWeightLayout::Make(WeightFormat::kQuantizedInt8, 1, 64, 32);
+    ASSERT_TRUE(layout.ok());
+    ASSERT_EQ((*packed)->storage().nbytes(), layout->nbytes);
+    const auto* bytes = static_cast<const uint8_t*>((*packed)->storage().data());
+    EXPECT_TRUE(std::equal(first.begin(), first.end(), bytes));
+    EXPECT_TRUE(std::equal(second.begin(), second.end(), bytes + 32));
+    const auto* scales = reinterpret_cast<const float*>(bytes + layout->scales_offset);
+    EXPECT_EQ(scales[0], 1.0F);
+    EXPECT_EQ(scales[1], 2.0F);
+}
+
+TEST(CpuWeightPrepacker, PackQuantizedBlocksReordersQ4_0NibblesIntoSignedPairs) {
+    CpuWeightPrepacker prepacker;
+    // Byte j holds element j low and j + 16 high, offset by 8. Element 0 is
+    // 7, elements 1 and 16 are -8 and the rest are 0.
+    std::vector<uint8_t> levels(16, 0x88);
+    levels[0] = 0x0F;
+    levels[1] = 0x80;
+    std::vector<std::byte> blocks;
+    AppendGgmlBlock(blocks, 0x3800, levels);
+
+    const auto packed = prepacker.PackQuantizedBlocks(OpType::kLinear, blocks.data(), blocks.size(), 1, 32,
+                                                      MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt4));
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    const auto layout = CpuQuantizedWeightLayout::Make(WeightFormat::kQuantizedInt4, 1, 32, 32);
+    ASSERT_TRUE(layout.ok());
+    const auto* bytes = static_cast<const uint8_t*>((*packed)->storage().data());
+    for (size_t i = 0; i < layout->row_bytes; ++i) {
+        const uint8_t expected = i == 0 ? 0x87 : (i == 8 ? 0x08 : 0x00);
+        EXPECT_EQ(bytes[i], expected) << "byte " << i;
+    }
+    EXPECT_EQ(reinterpret_cast<const float*>(bytes + layout->scales_offset)[0], 0.5F);
+
+    EXPECT_FALSE(prepacker.PackQuantizedBlocks(OpType::kLinear, blocks.data(), blocks.size() - 1, 1, 32,
+                                               MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt4))
+                         .ok());
+    EXPECT_FALSE(prepacker.PackQuantizedBlocks(OpType::kLinear, blocks.data(), blocks.size(), 2, 16,
+                                               MakeQuantizedCpuSelector(WeightFormat::kQuantizedInt4))
+                         .ok());
+}
+
 }// namespace
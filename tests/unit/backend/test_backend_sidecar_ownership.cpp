@@ -11,6 +11,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <optional>
 
 namespace {
 
@@ -145,4 +146,39 @@ TEST(BackendSidecarOwnership, StoreRejectsDuplicatePackedWeightEntries) {
     EXPECT_EQ(duplicate_status.code(), StatusCode::kAlreadyExists);
 }
 
+TEST(BackendSidecarOwnership, StoresWeightsUnderTheirLayerAndRole) {
+    BackendSidecar sidecar;
+    const KernelSelector selector = MakePackedCpuSelector();
+    const auto make = [&] {
+        return std::make_unique<CountingPackedWeights>(OpType::kLinear, selector, MakeTestBuffer(64), nullptr);
+    };
+    auto layer0_q = make();
+    auto layer3_down = make();
+    auto lm_head = make();
+    const PackedWeights* layer0_q_ptr = layer0_q.get();
+    const PackedWeights* layer3_down_ptr = layer3_down.get();
+    const PackedWeights* lm_head_ptr = lm_head.get();
+
+    // Layers share a selector; keyed entries never collide on it.
+    ASSERT_TRUE(sidecar.Store(0, WeightRole::kQProj, std::move(layer0_q)).ok());
+    ASSERT_TRUE(sidecar.Store(3, WeightRole::kDownProj, std::move(layer3_down)).ok());
+    ASSERT_TRUE(sidecar.Store(std::nullopt, WeightRole::kLmHead, std::move(lm_head)).ok());
+    EXPECT_EQ(sidecar.size(), 3U);
+
+    EXPECT_EQ(sidecar.Find(0, WeightRole::kQProj), layer0_q_ptr);
+    EXPECT_EQ(sidecar.Find(3, WeightRole::kDownProj), layer3_down_ptr);
+    EXPECT_EQ(sidecar.Find(std::nullopt, WeightRole::kLmHead), lm_head_ptr);
+    EXPECT_EQ(sidecar.Find(0, WeightRole::kKProj), nullptr);
+    EXPECT_EQ(sidecar.Find(7, WeightRole::kQProj), nullptr);
+    EXPECT_EQ(sidecar.Find(0, WeightRole::kLmHead), nullptr);
+    // The first weight stored for the pair answers the selector lookup.
+    EXPECT_EQ(sidecar.Find(OpType::kLinear, selector), layer0_q_ptr);
+
+    EXPECT_EQ(sidecar.Store(3, WeightRole::kDownProj, make()).code(), StatusCode::kAlreadyExists);
+    EXPECT_EQ(sidecar.Store(std::nullopt, WeightRole::kQProj, make()).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(sidecar.Store(1, WeightRole::kLmHead, make()).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(sidecar.Store(1, WeightRole::kQProj, nullptr).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(sidecar.size(), 3U);
+}
+
 }// namespace
@@ -113,6 +113,30 @@ TEST(KernelSelectorToString, ContainsAllFieldNames) {
     EXPECT_TRUE(str.find("weight_format=") != std::string::npos);
     EXPECT_TRUE(str.find("isa=") != std::string::npos);
     EXPECT_TRUE(str.find("phase=") != std::string::npos);
+    EXPECT_TRUE(str.find("kv_layout=") != std::string::npos);
+}
+
+TEST(KVLayoutOrderToString, AllKnownOrdersHaveStringRepresentation) {
+    EXPECT_STREQ(ToString(KVLayoutOrder::kAny), "Any");
+    EXPECT_STREQ(ToString(KVLayoutOrder::kHeadMajor), "HeadMajor");
+    EXPECT_STREQ(ToString(KVLayoutOrder::kTokenMajor), "TokenMajor");
+    EXPECT_STREQ(ToString(static_cast<KVLayoutOrder>(255)), "Unknown");
+}
+
+TEST(KernelSelector, KVLayoutAnyMatchesEitherOrder) {
+    const KernelSelector request{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .kv_layout = KVLayoutOrder::kTokenMajor,
+    };
+    KernelSelector candidate = request;
+    EXPECT_TRUE(SelectorMatches(candidate, request));
+    candidate.kv_layout = KVLayoutOrder::kAny;
+    EXPECT_TRUE(SelectorMatches(candidate, request));
+    candidate.kv_layout = KVLayoutOrder::kHeadMajor;
+    EXPECT_FALSE(SelectorMatches(candidate, request));
+    EXPECT_NE(candidate, request);
 }
 
 }// namespace
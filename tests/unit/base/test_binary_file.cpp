@@ -0,0 +1,120 @@
+#include "aethermind/base/binary_file.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+class TempDirectory {
+public:
+    TempDirectory() {
+        static size_t counter = 0;
+        const auto unique_id = std::to_string(
+                                       std::chrono::steady_clock::now().time_since_epoch().count()) +
+                               "_" + std::to_string(counter++);
+        path_ = std::filesystem::temp_directory_path() /
+                ("aethermind_binary_file_test_" + unique_id);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    AM_NODISCARD const std::filesystem::path& path() const noexcept {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_{};
+};
+
+struct TestRecord {
+    uint32_t magic = 0;
+    uint8_t flag = 0;
+    uint64_t offset = 0;
+    float scale = 0.0F;
+};
+
+struct TestRecordFields {
+    template<typename Record, typename Fn>
+    constexpr void operator()(Record& record, Fn&& fn) const {
+        fn(record.magic);
+        fn(record.flag);
+        fn(record.offset);
+        fn(record.scale);
+    }
+};
+
+std::string ReadFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+size_t CountFiles(const std::filesystem::path& dir) {
+    return static_cast<size_t>(std::distance(std::filesystem::directory_iterator(dir),
+                                             std::filesystem::directory_iterator()));
+}
+
+TEST(BinaryFile, EncodesFieldsWithoutPadding) {
+    static_assert(EncodedFieldBytes<TestRecord>(TestRecordFields{}) == 17);
+    const TestRecord record{.magic = 0x41424344, .flag = 7, .offset = 1ULL << 40, .scale = 0.25F};
+
+    std::vector<std::byte> appended;
+    AppendFields(record, TestRecordFields{}, appended);
+    ASSERT_EQ(appended.size(), 17U);
+    std::array<std::byte, 17> encoded{};
+    EXPECT_EQ(EncodeFields(record, TestRecordFields{}, encoded.data()), encoded.data() + encoded.size());
+    EXPECT_TRUE(std::equal(encoded.begin(), encoded.end(), appended.begin()));
+
+    TestRecord decoded;
+    EXPECT_EQ(DecodeFields(decoded, TestRecordFields{}, appended.data()), appended.data() + appended.size());
+    EXPECT_EQ(decoded.magic, record.magic);
+    EXPECT_EQ(decoded.flag, record.flag);
+    EXPECT_EQ(decoded.offset, record.offset);
+    EXPECT_EQ(decoded.scale, record.scale);
+}
+
+TEST(BinaryFile, WriteFileAtomicallyPublishesTheWrittenBytes) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "out.bin";
+
+    ASSERT_TRUE(WriteFileAtomically(path, "test", [](std::ofstream& out) {
+                    out << "payload";
+                    return Status::Ok();
+                }).ok());
+
+    EXPECT_EQ(ReadFile(path), "payload");
+    EXPECT_EQ(CountFiles(temp_dir.path()), 1U);
+}
+
+TEST(BinaryFile, WriteFileAtomicallyLeavesTheOldFileOnFailure) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "out.bin";
+    std::ofstream(path, std::ios::binary) << "old";
+
+    const Status status = WriteFileAtomically(path, "test", [](std::ofstream& out) {
+        out << "partial";
+        return Status::Internal("writer failed");
+    });
+
+    EXPECT_EQ(status.code(), StatusCode::kInternal);
+    EXPECT_EQ(ReadFile(path), "old");
+    EXPECT_EQ(CountFiles(temp_dir.path()), 1U);
+}
+
+}// namespace
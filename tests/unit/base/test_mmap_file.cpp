@@ -4,10 +4,13 @@
 #include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <fcntl.h>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <string>
+#include <sys/mman.h>
+#include <unistd.h>
 #include <vector>
 
 namespace {
@@ -195,6 +198,75 @@ TEST(MemoryMappedFile, AdvisesMappedFileAccessPattern) {
     EXPECT_TRUE(mmap->Advise(MemoryMappedFile::Advice::kSequential).ok());
     EXPECT_TRUE(mmap->Advise(MemoryMappedFile::Advice::kWillNeed).ok());
     EXPECT_TRUE(mmap->Advise(MemoryMappedFile::Advice::kDontNeed).ok());
+    EXPECT_TRUE(mmap->Advise(MemoryMappedFile::Advice::kPageOut).ok());
+}
+
+TEST(MemoryMappedFile, AdvisesUnalignedSubrangesWithinTheMapping) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "advise_range.bin";
+    WriteFile(path, std::string(3 * 4096 + 100, 'r'));
+
+    auto mmap = MemoryMappedFile::Map(path);
+    ASSERT_TRUE(mmap.ok()) << mmap.status().ToString();
+
+    EXPECT_TRUE(mmap->AdviseRange(5, 4096, MemoryMappedFile::Advice::kWillNeed).ok());
+    EXPECT_TRUE(mmap->AdviseRange(4097, mmap->size() - 4097, MemoryMappedFile::Advice::kDontNeed).ok());
+    EXPECT_TRUE(mmap->AdviseRange(mmap->size(), 0, MemoryMappedFile::Advice::kWillNeed).ok());
+    EXPECT_EQ(mmap->AdviseRange(4096, mmap->size(), MemoryMappedFile::Advice::kWillNeed).code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_EQ(MemoryMappedFile().AdviseRange(0, 1, MemoryMappedFile::Advice::kWillNeed).code(),
+              StatusCode::kInvalidArgument);
+    // Pages dropped by kDontNeed fault back in from the file.
+    EXPECT_EQ(static_cast<const char*>(mmap->data())[mmap->size() - 1], 'r');
+}
+
+// Pages of the mapping that are in RAM, according to mincore().
+size_t ResidentPages(const MemoryMappedFile& mmap) {
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> residency((mmap.size() + page_size - 1) / page_size);
+    EXPECT_EQ(mincore(const_cast<void*>(mmap.data()), mmap.size(), residency.data()), 0);
+    return static_cast<size_t>(std::ranges::count_if(residency, [](unsigned char page) {
+        return (page & 1U) != 0;
+    }));
+}
+
+TEST(MemoryMappedFile, PageOutKeepsMappedBytesIntact) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "page_out.bin";
+    const std::string content(64 * 4096, 'p');
+    // Only clean pages can be reclaimed, so write the file back first.
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    ASSERT_EQ(fsync(fd), 0);
+    ASSERT_EQ(close(fd), 0);
+
+    auto mmap = MemoryMappedFile::Map(path);
+    ASSERT_TRUE(mmap.ok()) << mmap.status().ToString();
+    size_t checksum = 0;
+    for (const std::byte byte: mmap->Bytes()) {
+        checksum += std::to_integer<size_t>(byte);
+    }
+    ASSERT_EQ(checksum, content.size() * 'p');
+    const size_t resident = ResidentPages(*mmap);
+    ASSERT_GT(resident, 0U);
+
+    ASSERT_TRUE(mmap->AdviseRange(0, mmap->size(), MemoryMappedFile::Advice::kPageOut).ok());
+    const size_t remaining = ResidentPages(*mmap);
+
+    // Dropped pages fault back in from the file unchanged.
+    checksum = 0;
+    for (const std::byte byte: mmap->Bytes()) {
+        checksum += std::to_integer<size_t>(byte);
+    }
+    EXPECT_EQ(checksum, content.size() * 'p');
+
+    // Reclaim is best-effort: swapless tmpfs keeps shmem pages, the
+    // MADV_DONTNEED fallback leaves them cached, and the journal may still
+    // pin them right after fsync.
+    if (remaining >= resident) {
+        GTEST_SKIP() << "The kernel kept all " << resident << " pages resident after kPageOut";
+    }
 }
 
 TEST(MemoryMappedFile, MoveConstructionTransfersOwnership) {
@@ -0,0 +1,174 @@
+#include "aethermind/execution/chunked_prefill.h"
+
+#include "aethermind/execution/kv_cache_manager.h"
+#include "../test_utils/plan_fixtures.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+// What a kernel observed when it ran: the chunk it was handed and how much of
+// the prompt the KV cache exposed at that time.
+struct ObservedChunk {
+    int bucket = 0;
+    size_t current_pos = 0;
+    size_t step_tokens = 0;
+    size_t committed_tokens = 0;
+};
+
+using Probe = test_utils::KernelProbe<ObservedChunk>;
+
+Status Record(int bucket) noexcept {
+    if (Probe::ConsumeFailure()) {
+        return Status::Internal("injected chunk failure");
+    }
+    const RuntimeSequenceState& sequence = Probe::bindings->sequence_state();
+    Probe::observed->push_back(ObservedChunk{
+            .bucket = bucket,
+            .current_pos = sequence.current_pos,
+            .step_tokens = sequence.step_tokens,
+            .committed_tokens = Probe::bindings->kv_cache_view().committed_tokens(),
+    });
+    return Status::Ok();
+}
+
+Status DecodeKernel(const KernelContext&) noexcept {
+    return Record(1);
+}
+
+Status PrefillKernel(const KernelContext&) noexcept {
+    return Record(2);
+}
+
+// Decode bucket for one token and one prefill bucket for [2, 4] tokens.
+ExecutionPlanFamily MakeFamily() {
+    return test_utils::MakeTwoBucketFamily(&DecodeKernel, &PrefillKernel);
+}
+
+class ChunkedPrefillTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(manager_.Init(1, 1, 32, 8, DataType::Float32(), 64).ok());
+        Probe::Attach(&bindings_, &observed_);
+    }
+
+    void TearDown() override {
+        Probe::Detach();
+    }
+
+    void BindKVCache(size_t prompt_len) {
+        StatusOr<KVCacheView> view = manager_.ReserveForChunkedPrefill(prompt_len, 4);
+        ASSERT_TRUE(view.ok()) << view.status().ToString();
+        EXPECT_EQ(view->committed_tokens(), 0U);
+        bindings_.SetKVCacheView(*view);
+    }
+
+    KVCacheManager manager_;
+    RuntimeBindingContext bindings_;
+    std::vector<ObservedChunk> observed_;
+};
+
+TEST_F(ChunkedPrefillTest, CommitsPromptChunkByChunk) {
+    BindKVCache(10);
+    const ExecutionPlanFamily family = MakeFamily();
+    StatusOr<ChunkedPrefill> prefill = ChunkedPrefill::Create(10, 4);
+    ASSERT_TRUE(prefill.ok()) << prefill.status().ToString();
+    EXPECT_EQ(prefill->remaining_chunks(), 3U);
+
+    while (!prefill->done()) {
+        ASSERT_TRUE(prefill->RunNextChunk(family, bindings_).ok());
+        EXPECT_EQ(bindings_.kv_cache_view().committed_tokens(), prefill->committed_tokens());
+    }
+
+    // Every chunk sees exactly the earlier chunks as committed KV history.
+    ASSERT_EQ(observed_.size(), 3U);
+    EXPECT_EQ(observed_[0].current_pos, 0U);
+    EXPECT_EQ(observed_[0].step_tokens, 4U);
+    EXPECT_EQ(observed_[0].committed_tokens, 0U);
+    EXPECT_EQ(observed_[1].current_pos, 4U);
+    EXPECT_EQ(observed_[1].committed_tokens, 4U);
+    EXPECT_EQ(observed_[2].current_pos, 8U);
+    EXPECT_EQ(observed_[2].step_tokens, 2U);
+    EXPECT_EQ(observed_[2].committed_tokens, 8U);
+    EXPECT_EQ(observed_[2].bucket, 2);
+
+    EXPECT_EQ(bindings_.kv_cache_view().committed_tokens(), 10U);
+    EXPECT_TRUE(bindings_.sequence_state().prefill_done);
+    EXPECT_EQ(bindings_.sequence_state().current_pos, 10U);
+    EXPECT_EQ(bindings_.sequence_state().step_tokens, 0U);
+    EXPECT_EQ(prefill->RunNextChunk(family, bindings_).code(), StatusCode::kFailedPrecondition);
+}
+
+TEST_F(ChunkedPrefillTest, TrailingSingleTokenUsesDecodeBucket) {
+    BindKVCache(5);
+    const ExecutionPlanFamily family = MakeFamily();
+    StatusOr<ChunkedPrefill> prefill = ChunkedPrefill::Create(5, 4);
+    ASSERT_TRUE(prefill.ok());
+
+    ASSERT_TRUE(prefill->RunNextChunk(family, bindings_).ok());
+    EXPECT_EQ(prefill->next_chunk().begin, 4U);
+    EXPECT_EQ(prefill->next_chunk().num_tokens, 1U);
+    ASSERT_TRUE(prefill->RunNextChunk(family, bindings_).ok());
+
+    ASSERT_EQ(observed_.size(), 2U);
+    EXPECT_EQ(observed_[0].bucket, 2);
+    EXPECT_EQ(observed_[1].bucket, 1);
+}
+
+TEST_F(ChunkedPrefillTest, FailedChunkCommitsNothingAndCanBeRetried) {
+    BindKVCache(8);
+    const ExecutionPlanFamily family = MakeFamily();
+    StatusOr<ChunkedPrefill> prefill = ChunkedPrefill::Create(8, 4);
+    ASSERT_TRUE(prefill.ok());
+    ASSERT_TRUE(prefill->RunNextChunk(family, bindings_).ok());
+
+    Probe::fail_next = true;
+    EXPECT_EQ(prefill->RunNextChunk(family, bindings_).code(), StatusCode::kInternal);
+    EXPECT_EQ(prefill->committed_tokens(), 4U);
+    EXPECT_EQ(bindings_.kv_cache_view().committed_tokens(), 4U);
+
+    ASSERT_TRUE(prefill->RunNextChunk(family, bindings_).ok());
+    EXPECT_TRUE(prefill->done());
+}
+
+TEST_F(ChunkedPrefillTest, RejectsChunksLargerThanTheFamily) {
+    BindKVCache(16);
+    const ExecutionPlanFamily family = MakeFamily();
+    StatusOr<ChunkedPrefill> prefill = ChunkedPrefill::Create(16, 8);
+    ASSERT_TRUE(prefill.ok());
+
+    EXPECT_FALSE(prefill->RunNextChunk(family, bindings_).ok());
+    EXPECT_EQ(bindings_.kv_cache_view().committed_tokens(), 0U);
+}
+
+TEST_F(ChunkedPrefillTest, RejectsKVCacheOutOfSyncWithProgress) {
+    const ExecutionPlanFamily family = MakeFamily();
+    StatusOr<ChunkedPrefill> prefill = ChunkedPrefill::Create(8, 4);
+    ASSERT_TRUE(prefill.ok());
+    EXPECT_EQ(prefill->RunNextChunk(family, bindings_).code(), StatusCode::kFailedPrecondition);
+
+    // ReserveForSession() already commits the whole prompt.
+    StatusOr<KVCacheView> view = manager_.ReserveForSession(8, 4);
+    ASSERT_TRUE(view.ok());
+    bindings_.SetKVCacheView(*view);
+    EXPECT_EQ(prefill->RunNextChunk(family, bindings_).code(), StatusCode::kFailedPrecondition);
+    EXPECT_TRUE(observed_.empty());
+}
+
+TEST(ChunkedPrefill, CreateValidatesArguments) {
+    EXPECT_EQ(ChunkedPrefill::Create(0, 4).status().code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ChunkedPrefill::Create(8, 0).status().code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(ChunkedPrefill::Create(8, 4, 9).status().code(), StatusCode::kOutOfRange);
+
+    const StatusOr<ChunkedPrefill> resumed = ChunkedPrefill::Create(8, 4, 6);
+    ASSERT_TRUE(resumed.ok());
+    EXPECT_EQ(resumed->next_chunk().begin, 6U);
+    EXPECT_EQ(resumed->next_chunk().num_tokens, 2U);
+    EXPECT_EQ(resumed->remaining_chunks(), 1U);
+}
+
+}// namespace
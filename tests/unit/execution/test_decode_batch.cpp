@@ -0,0 +1,307 @@
+#include "aethermind/execution/decode_batch.h"
+
+#include "aethermind/execution/kv_cache_manager.h"
+#include "aethermind/execution/kv_decode_attention.h"
+#include "../test_utils/plan_fixtures.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr size_t kHeadDim = 4;
+
+// What the batched kernel observed: the bucket it ran in and, per row, the
+// decode position and the KV history already committed for that session.
+struct ObservedStep {
+    int bucket = 0;
+    size_t step_tokens = 0;
+    std::vector<size_t> positions;
+    std::vector<size_t> committed_tokens;
+};
+
+using Probe = test_utils::KernelProbe<ObservedStep>;
+// When set, the kernel releases the last row's session, leaving its view stale.
+KVCacheManager* g_release_last_row = nullptr;
+
+std::vector<float> Row(float base) {
+    std::vector<float> row(kHeadDim);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        row[d] = base * std::cos(static_cast<float>(d + 1));
+    }
+    return row;
+}
+
+// Writes every row's new token into its own session, as a KV update kernel
+// of a batched decode step does.
+Status Record(int bucket) noexcept {
+    if (Probe::ConsumeFailure()) {
+        return Status::Internal("injected decode failure");
+    }
+    const DecodeBatchBinding& batch = Probe::bindings->decode_batch_binding();
+    ObservedStep step{.bucket = bucket, .step_tokens = Probe::bindings->sequence_state().step_tokens};
+    for (size_t row = 0; row < batch.batch_size(); ++row) {
+        KVCacheView& view = batch.kv_cache_views[row];
+        const size_t pos = batch.positions[row];
+        step.positions.push_back(pos);
+        step.committed_tokens.push_back(view.committed_tokens());
+        const std::vector<float> token = Row(static_cast<float>(pos + 1));
+        AM_RETURN_IF_ERROR(view.WriteToken(0, 0, pos, token, token));
+    }
+    if (g_release_last_row != nullptr) {
+        KVCacheView released = batch.kv_cache_views[batch.batch_size() - 1];
+        AM_RETURN_IF_ERROR(g_release_last_row->ReleaseSession(released));
+        g_release_last_row = nullptr;
+    }
+    Probe::observed->push_back(std::move(step));
+    return Status::Ok();
+}
+
+Status SingleKernel(const KernelContext&) noexcept {
+    return Record(1);
+}
+
+Status BatchedKernel(const KernelContext&) noexcept {
+    return Record(4);
+}
+
+// Buckets for one session and for two to four sessions.
+ExecutionPlanFamily MakeFamily() {
+    return test_utils::MakeTwoBucketFamily(&SingleKernel, &BatchedKernel, OpType::kKVCacheUpdate);
+}
+
+RuntimeSequenceState PrefilledState(size_t prompt_len) {
+    RuntimeSequenceState state;
+    state.prefill_done = true;
+    state.prompt_len = prompt_len;
+    state.current_pos = prompt_len;
+    return state;
+}
+
+class DecodeBatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(manager_.InitPaged(1, 1, 64, kHeadDim, DataType::Float32(), 4, 32, 64, 4).ok());
+        Probe::Attach(&bindings_, &observed_);
+        g_release_last_row = nullptr;
+    }
+
+    void TearDown() override {
+        Probe::Detach();
+    }
+
+    KVCacheView Prefill(size_t prompt_len) {
+        StatusOr<KVCacheView> view = manager_.ReserveForChunkedPrefill(prompt_len, 8);
+        EXPECT_TRUE(view.ok()) << view.status().ToString();
+        for (size_t pos = 0; pos < prompt_len; ++pos) {
+            const std::vector<float> token = Row(static_cast<float>(pos + 1));
+            EXPECT_TRUE(view->WriteToken(0, 0, pos, token, token).ok());
+        }
+        EXPECT_TRUE(view->CommitUntil(prompt_len).ok());
+        return *view;
+    }
+
+    KVCacheManager manager_;
+    RuntimeBindingContext bindings_;
+    std::vector<ObservedStep> observed_;
+};
+
+TEST_F(DecodeBatchTest, DecodesSessionsOfDifferentLengthsInOneStep) {
+    StatusOr<DecodeBatch> batch = DecodeBatch::Create(4);
+    ASSERT_TRUE(batch.ok());
+    ASSERT_TRUE(batch->Join(7, Prefill(3), PrefilledState(3)).ok());
+    ASSERT_TRUE(batch->Join(9, Prefill(6), PrefilledState(6)).ok());
+    const ExecutionPlanFamily family = MakeFamily();
+
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+
+    ASSERT_EQ(observed_.size(), 2U);
+    EXPECT_EQ(observed_[0].bucket, 4);
+    EXPECT_EQ(observed_[0].step_tokens, 2U);
+    EXPECT_EQ(observed_[0].positions, (std::vector<size_t>{3, 6}));
+    EXPECT_EQ(observed_[0].committed_tokens, (std::vector<size_t>{3, 6}));
+    EXPECT_EQ(observed_[1].positions, (std::vector<size_t>{4, 7}));
+
+    EXPECT_EQ(batch->kv_cache_views()[0].committed_tokens(), 5U);
+    EXPECT_EQ(batch->kv_cache_views()[1].committed_tokens(), 8U);
+    StatusOr<RuntimeSequenceState> state = batch->sequence_state(9);
+    ASSERT_TRUE(state.ok());
+    EXPECT_EQ(state->current_pos, 8U);
+    EXPECT_EQ(state->generated_len, 2U);
+    EXPECT_FALSE(bindings_.HasDecodeBatchBinding());
+    EXPECT_EQ(bindings_.sequence_state().step_tokens, 0U);
+}
+
+TEST_F(DecodeBatchTest, SessionsJoinAndLeaveBetweenSteps) {
+    StatusOr<DecodeBatch> batch = DecodeBatch::Create(4);
+    ASSERT_TRUE(batch.ok());
+    const ExecutionPlanFamily family = MakeFamily();
+    ASSERT_TRUE(batch->Join(1, Prefill(2), PrefilledState(2)).ok());
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+
+    ASSERT_TRUE(batch->Join(2, Prefill(5), PrefilledState(5)).ok());
+    ASSERT_TRUE(batch->Join(3, Prefill(1), PrefilledState(1)).ok());
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+
+    ASSERT_TRUE(batch->Leave(1).ok());
+    EXPECT_EQ(*batch->Row(3), 1U);
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+    EXPECT_EQ(batch->Leave(1).code(), StatusCode::kNotFound);
+
+    ASSERT_EQ(observed_.size(), 3U);
+    EXPECT_EQ(observed_[0].bucket, 1);
+    EXPECT_EQ(observed_[0].positions, (std::vector<size_t>{2}));
+    EXPECT_EQ(observed_[1].positions, (std::vector<size_t>{3, 5, 1}));
+    EXPECT_EQ(observed_[2].positions, (std::vector<size_t>{6, 2}));
+}
+
+TEST_F(DecodeBatchTest, FailedStepCommitsNothingAndCanBeRetried) {
+    StatusOr<DecodeBatch> batch = DecodeBatch::Create(2);
+    ASSERT_TRUE(batch.ok());
+    ASSERT_TRUE(batch->Join(1, Prefill(4), PrefilledState(4)).ok());
+    ASSERT_TRUE(batch->Join(2, Prefill(2), PrefilledState(2)).ok());
+    const ExecutionPlanFamily family = MakeFamily();
+
+    Probe::fail_next = true;
+    EXPECT_EQ(batch->RunStep(family, bindings_).code(), StatusCode::kInternal);
+    EXPECT_EQ(batch->kv_cache_views()[0].committed_tokens(), 4U);
+    EXPECT_EQ(batch->kv_cache_views()[1].committed_tokens(), 2U);
+    StatusOr<RuntimeSequenceState> state = batch->sequence_state(1);
+    ASSERT_TRUE(state.ok());
+    EXPECT_EQ(state->generated_len, 0U);
+    EXPECT_FALSE(bindings_.HasDecodeBatchBinding());
+
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+    EXPECT_EQ(batch->kv_cache_views()[0].committed_tokens(), 5U);
+}
+
+TEST_F(DecodeBatchTest, StaleRowLeavesEveryRowUncommitted) {
+    StatusOr<DecodeBatch> batch = DecodeBatch::Create(2);
+    ASSERT_TRUE(batch.ok());
+    ASSERT_TRUE(batch->Join(1, Prefill(4), PrefilledState(4)).ok());
+    ASSERT_TRUE(batch->Join(2, Prefill(2), PrefilledState(2)).ok());
+    const ExecutionPlanFamily family = MakeFamily();
+
+    g_release_last_row = &manager_;
+    EXPECT_EQ(batch->RunStep(family, bindings_).code(), StatusCode::kFailedPrecondition);
+    // The first row was valid, but nothing is committed once any row fails.
+    EXPECT_EQ(batch->kv_cache_views()[0].committed_tokens(), 4U);
+    StatusOr<RuntimeSequenceState> state = batch->sequence_state(1);
+    ASSERT_TRUE(state.ok());
+    EXPECT_EQ(state->current_pos, 4U);
+    EXPECT_EQ(state->generated_len, 0U);
+
+    ASSERT_TRUE(batch->Leave(2).ok());
+    ASSERT_TRUE(batch->RunStep(family, bindings_).ok());
+    EXPECT_EQ(batch->kv_cache_views()[0].committed_tokens(), 5U);
+}
+
+TEST_F(DecodeBatchTest, JoinValidatesSessions) {
+    StatusOr<DecodeBatch> batch = DecodeBatch::Create(1);
+    ASSERT_TRUE(batch.ok());
+    const KVCacheView view = Prefill(3);
+
+    RuntimeSequenceState prefilling = PrefilledState(3);
+    prefilling.prefill_done = false;
+    EXPECT_EQ(batch->Join(1, view, prefilling).code(), StatusCode::kFailedPrecondition);
+    EXPECT_EQ(batch->Join(1, view, PrefilledState(2)).code(), StatusCode::kFailedPrecondition);
+    EXPECT_EQ(batch->Join(1, KVCacheView{}, PrefilledState(3)).code(), StatusCode::kFailedPrecondition);
+
+    ASSERT_TRUE(batch->Join(1, view, PrefilledState(3)).ok());
+    EXPECT_EQ(batch->Join(1, view, PrefilledState(3)).code(), StatusCode::kAlreadyExists);
+    EXPECT_EQ(batch->Join(2, Prefill(2), PrefilledState(2)).code(), StatusCode::kResourceExhausted);
+
+    StatusOr<DecodeBatch> empty = DecodeBatch::Create(2);
+    ASSERT_TRUE(empty.ok());
+    EXPECT_EQ(empty->RunStep(MakeFamily(), bindings_).code(), StatusCode::kFailedPrecondition);
+    EXPECT_EQ(DecodeBatch::Create(0).status().code(), StatusCode::kInvalidArgument);
+}
+
+TEST(BatchedDecodeAttention, MatchesPerSessionAttentionWithGroupedHeads) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 2, 32, kHeadDim, DataType::Float32(), 64, 3).ok());
+    std::vector<KVCacheView> views;
+    std::vector<size_t> positions;
+    for (const size_t len: {3U, 11U, 6U}) {
+        StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(len, 1);
+        ASSERT_TRUE(view.ok());
+        // The row at `len` is the token being decoded: written, not committed.
+        for (size_t head = 0; head < 2; ++head) {
+            for (size_t pos = 0; pos <= len; ++pos) {
+                const float base = static_cast<float>(pos + 1) * (head == 0 ? 0.1F : -0.2F);
+                ASSERT_TRUE(view->WriteToken(0, head, pos, Row(base), Row(base * 0.5F + 1.0F)).ok());
+            }
+        }
+        ASSERT_TRUE(view->CommitUntil(len).ok());
+        views.push_back(*view);
+        positions.push_back(len);
+    }
+
+    // Four query heads share two KV heads.
+    constexpr size_t kQHeads = 4;
+    std::vector<float> queries(views.size() * kQHeads * kHeadDim);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        queries[i] = std::sin(static_cast<float>(i));
+    }
+    std::vector<float> output(queries.size());
+    ASSERT_TRUE(BatchedDecodeAttention(views, positions, 0, kQHeads, queries, 0.5F, output).ok());
+
+    // Committing the decoded row afterwards must not change what it saw.
+    std::vector<float> expected(kHeadDim);
+    for (size_t b = 0; b < views.size(); ++b) {
+        ASSERT_TRUE(views[b].CommitUntil(positions[b] + 1).ok());
+        for (size_t h = 0; h < kQHeads; ++h) {
+            const size_t offset = (b * kQHeads + h) * kHeadDim;
+            ASSERT_TRUE(DecodeAttention(views[b], 0, h / 2,
+                                        std::span<const float>(queries).subspan(offset, kHeadDim),
+                                        0.5F, expected)
+                                .ok());
+            for (size_t d = 0; d < kHeadDim; ++d) {
+                EXPECT_FLOAT_EQ(output[offset + d], expected[d]);
+            }
+        }
+    }
+
+    EXPECT_EQ(BatchedDecodeAttention(views, positions, 0, 3, queries, 0.5F, output).code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_EQ(BatchedDecodeAttention(views, std::span<const size_t>(positions).first(2), 0, kQHeads, queries,
+                                     0.5F, output)
+                      .code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_EQ(BatchedDecodeAttention(views, positions, 0, kQHeads, std::span<const float>(queries).first(8), 0.5F,
+                                     output)
+                      .code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(BatchedDecodeAttention, DecodedTokenAttendsToItsOwnUncommittedRow) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, kHeadDim, DataType::Float32(), 4, 4, 64, 1).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(4, 1);
+    ASSERT_TRUE(view.ok());
+    for (size_t pos = 0; pos < 4; ++pos) {
+        ASSERT_TRUE(view->WriteToken(0, 0, pos, Row(0.0F), Row(0.0F)).ok());
+    }
+    ASSERT_TRUE(view->CommitUntil(4).ok());
+    // Position 4 starts a new block that only the decode step has mapped.
+    ASSERT_TRUE(view->ReserveTokens(5).ok());
+    ASSERT_TRUE(view->WriteToken(0, 0, 4, Row(0.0F), Row(8.0F)).ok());
+
+    const std::vector<KVCacheView> views = {*view};
+    const std::vector<size_t> positions = {4};
+    std::vector<float> output(kHeadDim);
+    ASSERT_TRUE(BatchedDecodeAttention(views, positions, 0, 1, Row(1.0F), 1.0F, output).ok());
+    // Five equal scores: one fifth of the new value row, none of it lost.
+    const std::vector<float> expected = Row(8.0F / 5.0F);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        EXPECT_NEAR(output[d], expected[d], 1e-5F);
+    }
+    EXPECT_EQ(view->committed_tokens(), 4U);
+}
+
+}// namespace
@@ -156,6 +156,39 @@ public:
     }
 };
 
+// Resolves kKVCacheUpdate only for token-major KV caches.
+class TokenMajorKVBackend final : public Backend {
+public:
+    DeviceType device_type() const noexcept override { return DeviceType::kCPU; }
+    const BackendCapabilities& capabilities() const noexcept override { return caps_; }
+    KernelFunc ResolveKernel(OpType op_type, const KernelSelector& selector) const noexcept override {
+        return Matches(op_type, selector) ? &SoftmaxTestKernel : nullptr;
+    }
+    StatusOr<ResolvedKernel> ResolveKernelInfo(OpType op_type,
+                                               const KernelSelector& selector) const noexcept override {
+        if (!Matches(op_type, selector)) {
+            return Status::NotFound("TokenMajorKVBackend only resolves token-major KV updates");
+        }
+        return ResolvedKernel{.op_type = op_type, .fn = &SoftmaxTestKernel, .attrs = {}, .debug_name = "test::kv_update_kernel"};
+    }
+    const KernelRegistry* TryGetKernelRegistryForDebug() const noexcept override { return nullptr; }
+
+private:
+    static bool Matches(OpType op_type, const KernelSelector& selector) noexcept {
+        return op_type == OpType::kKVCacheUpdate && selector.kv_layout == KVLayoutOrder::kTokenMajor;
+    }
+
+    BackendCapabilities caps_{};
+};
+
+class TokenMajorKVBackendFactory final : public BackendFactory {
+public:
+    DeviceType device_type() const noexcept override { return DeviceType::kCPU; }
+    std::unique_ptr<Backend> Create() const override {
+        return std::make_unique<TokenMajorKVBackend>();
+    }
+};
+
 ExecutionPlanNodeSpec MakeRmsNormNodeSpec(std::span<const std::byte> attrs = {}) {
     return ExecutionPlanNodeSpec{
             .op_type = OpType::kRmsNorm,
@@ -486,6 +519,49 @@ TEST(ExecutionPlanBuilder, BuildPlansWorkspaceOffsetsAcrossNodes) {
     EXPECT_EQ(plan->steps()[1].workspace_requirement.offset, 64U);
 }
 
+TEST(ExecutionPlanBuilder, BuildSharesWorkspaceAcrossPerOperatorSteps) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+
+    const SymbolicShape act_shape = StaticShape({4, 8});
+    const SymbolicShape weight_shape = StaticShape({8});
+    const auto analyzed = InferRmsNorm(1.0e-5F, act_shape, weight_shape);
+    ASSERT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+
+    std::vector<ExecutionPlanNodeSpec> nodes;
+    for (const auto& req: {WorkspaceRequirement{.bytes = 32, .alignment = 16, .lifetime = WorkspaceLifetime::kPerOperator},
+                           WorkspaceRequirement{.bytes = 8, .alignment = 64, .lifetime = WorkspaceLifetime::kPerOperator}}) {
+        ExecutionPlanNodeSpec node{
+                .op_type = OpType::kRmsNorm,
+                .device_type = DeviceType::kCPU,
+                .act_dtype = DataType::Float32(),
+                .weight_dtype = DataType::Float32(),
+                .weight_format = WeightFormat::kPlain,
+                .isa = IsaLevel::kScalar,
+                .phase = ExecPhase::kBoth,
+                .workspace_requirement = req,
+        };
+        node.op_params = OpParams{RmsNormParams{.eps = 1.0e-5F}};
+        node.input_specs = {
+                TensorSpec{.dtype = DataType::Float32(), .shape = act_shape},
+                TensorSpec{.dtype = DataType::Float32(), .shape = weight_shape},
+        };
+        node.output_specs = analyzed->outputs;
+        node.runtime_checks = analyzed->runtime_checks;
+        nodes.push_back(std::move(node));
+    }
+
+    const StatusOr<ExecutionPlan> plan = ExecutionPlanBuilder::Build(runtime, nodes);
+
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    ASSERT_EQ(plan->size(), 2U);
+    EXPECT_EQ(plan->steps()[0].workspace_requirement.offset, 0U);
+    EXPECT_EQ(plan->steps()[1].workspace_requirement.offset, 0U);
+    EXPECT_EQ(plan->workspace_layout().total_bytes, 32U);
+    EXPECT_EQ(plan->workspace_layout().naive_total_bytes, 72U);
+    EXPECT_EQ(plan->workspace_layout().required_alignment, 64U);
+}
+
 TEST(ExecutionPlanBuilder, BuildBindsPackedWeightsFromModelInstanceSidecar) {
     RuntimeBuilder builder;
     builder.RegisterBackendFactory(DeviceType::kCPU,
@@ -540,6 +616,114 @@ TEST(ExecutionPlanBuilder, BuildBindsPackedWeightsFromModelInstanceSidecar) {
               model_instance.FindPackedWeights(OpType::kRmsNorm, selector)->storage().data());
 }
 
+TEST(ExecutionPlanBuilder, BuildBindsEachLinearNodeToItsLayerAndRole) {
+    RuntimeBuilder builder;
+    builder.RegisterBackendFactory(DeviceType::kCPU,
+                                   std::make_unique<PackedTestBackendFactory>());
+    RuntimeContext runtime = builder.Build();
+    const KernelSelector selector{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .weight_format = WeightFormat::kPacked,
+            .isa = IsaLevel::kScalar,
+            .phase = ExecPhase::kBoth,
+    };
+    const std::optional<uint32_t> layers[] = {0, 1, std::nullopt};
+    const WeightRole roles[] = {WeightRole::kQProj, WeightRole::kQProj, WeightRole::kLmHead};
+    ModelInstance model_instance;
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(model_instance
+                            .StorePackedWeights(layers[i], roles[i],
+                                                std::make_unique<TestPackedWeights>(OpType::kLinear, selector,
+                                                                                    MakeTestBuffer(128)))
+                            .ok());
+    }
+
+    std::vector<TensorSpec> inputs = {
+            TensorSpec{.dtype = DataType::Float32(), .shape = StaticShape({4, 8})},
+            TensorSpec{.dtype = DataType::Float32(), .shape = StaticShape({16, 8})},
+    };
+    const auto analyzed = InferOperator(OpType::kLinear, OpParams{LinearParams{}}, inputs);
+    ASSERT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+    const TransformerWeightRole node_roles[] = {TransformerWeightRole::kAttentionQ,
+                                                TransformerWeightRole::kAttentionQ,
+                                                TransformerWeightRole::kLmHead};
+    std::vector<ExecutionPlanNodeSpec> nodes;
+    for (size_t i = 0; i < 3; ++i) {
+        ExecutionPlanNodeSpec node{
+                .op_type = OpType::kLinear,
+                .device_type = DeviceType::kCPU,
+                .act_dtype = DataType::Float32(),
+                .weight_dtype = DataType::Float32(),
+                .weight_format = WeightFormat::kPacked,
+                .isa = IsaLevel::kScalar,
+                .phase = ExecPhase::kBoth,
+                .decoder_layer_index = layers[i],
+                .weight_role = node_roles[i],
+        };
+        node.op_params = OpParams{LinearParams{}};
+        node.input_specs = inputs;
+        node.output_specs = analyzed->outputs;
+        nodes.push_back(std::move(node));
+    }
+
+    const StatusOr<ExecutionPlan> plan = ExecutionPlanBuilder::Build(runtime, model_instance, nodes);
+
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    ASSERT_EQ(plan->size(), 3U);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(plan->steps()[i].packed_weights,
+                  model_instance.FindPackedWeights(layers[i], roles[i])->storage().data())
+                << "step " << i;
+    }
+    EXPECT_NE(plan->steps()[0].packed_weights, plan->steps()[1].packed_weights);
+
+    // A layer without its artifact, or one packed for another kernel, fails.
+    nodes[1].decoder_layer_index = 7;
+    EXPECT_EQ(ExecutionPlanBuilder::Build(runtime, model_instance, nodes).status().code(),
+              StatusCode::kNotFound);
+    nodes[1].decoder_layer_index = 1;
+    nodes[1].isa = IsaLevel::kAVX2;
+    EXPECT_EQ(ExecutionPlanBuilder::Build(runtime, model_instance, nodes).status().code(),
+              StatusCode::kFailedPrecondition);
+}
+
+TEST(ExecutionPlanBuilder, BuildRejectsQuantizedWeightFormatsWithoutAConsumer) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    ModelInstance model_instance;
+
+    const SymbolicShape act_shape = StaticShape({4, 8});
+    const SymbolicShape weight_shape = StaticShape({8});
+    const auto analyzed = InferRmsNorm(1.0e-5F, act_shape, weight_shape);
+    ASSERT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+
+    for (const WeightFormat format: {WeightFormat::kQuantizedInt8, WeightFormat::kQuantizedInt4}) {
+        std::vector<ExecutionPlanNodeSpec> nodes;
+        ExecutionPlanNodeSpec node{
+                .op_type = OpType::kRmsNorm,
+                .device_type = DeviceType::kCPU,
+                .act_dtype = DataType::Float32(),
+                .weight_dtype = DataType::Int(8),
+                .weight_format = format,
+                .isa = IsaLevel::kScalar,
+                .phase = ExecPhase::kBoth,
+        };
+        node.op_params = OpParams{RmsNormParams{.eps = 1.0e-5F}};
+        node.input_specs = {
+                TensorSpec{.dtype = DataType::Float32(), .shape = act_shape},
+                TensorSpec{.dtype = DataType::Float32(), .shape = weight_shape},
+        };
+        node.output_specs = analyzed->outputs;
+        node.runtime_checks = analyzed->runtime_checks;
+        nodes.push_back(std::move(node));
+
+        EXPECT_EQ(ExecutionPlanBuilder::Build(runtime, model_instance, nodes).status().code(),
+                  StatusCode::kUnimplemented);
+    }
+}
+
 TEST(ExecutionPlanBuilder, BuildRejectsPackedWeightNodeWithoutModelInstanceSidecar) {
     RuntimeBuilder builder;
     RuntimeContext runtime = builder.Build();
@@ -610,6 +794,7 @@ TEST(ExecutionPlanBuilder, BuildFromLoweredGraphStoresRuntimeStateAliasPlan) {
     lowered.steps.push_back(std::move(step));
     lowered.step_bindings.push_back(LoweredStepBinding{
             .node = GraphNodeId{.index = 0},
+            .decoder_layer_index = 3,
             .input_values = {GraphValueId{.index = 0}, GraphValueId{.index = 1}},
             .output_values = {GraphValueId{.index = 2}},
     });
@@ -627,6 +812,8 @@ TEST(ExecutionPlanBuilder, BuildFromLoweredGraphStoresRuntimeStateAliasPlan) {
     ASSERT_TRUE(plan.ok()) << plan.status().ToString();
     EXPECT_EQ(plan->state_alias_plan().size(), 1U);
     EXPECT_FALSE(plan->state_alias_plan().empty());
+    ASSERT_EQ(plan->steps().size(), 1U);
+    EXPECT_EQ(plan->steps()[0].decoder_layer_index, std::optional<uint32_t>(3));
 }
 
 TEST(ExecutionPlanBuilder, BuildFromLoweredGraphPropagatesTrustedMetadata) {
@@ -861,4 +1048,40 @@ TEST(ExecutionPlanBuilder, BuildFromRawNodesPreservesFunctionOperatorMetadata) {
     EXPECT_EQ(step.runtime_checks, analyzed->runtime_checks);
 }
 
+TEST(ExecutionPlanBuilder, BuildAdvertisesRuntimeKVLayoutToKVCacheKernels) {
+    for (const KVLayoutOrder order: {KVLayoutOrder::kHeadMajor, KVLayoutOrder::kTokenMajor}) {
+        RuntimeOptions options;
+        options.kv_cache = KVCacheRuntimeOptions{
+                .enable_manager = true,
+                .num_layers = 1,
+                .num_kv_heads = 2,
+                .max_tokens = 16,
+                .head_dim = 4,
+                .kv_dtype = DataType::Float32(),
+                .layout_order = order,
+        };
+        RuntimeBuilder builder;
+        builder.WithOptions(options);
+        builder.RegisterBackendFactory(DeviceType::kCPU,
+                                       std::make_unique<TokenMajorKVBackendFactory>());
+        RuntimeContext runtime = builder.Build();
+
+        LoweredGraph lowered;
+        lowered.steps.push_back(ExecutionPlanNodeSpec{
+                .op_type = OpType::kKVCacheUpdate,
+                .device_type = DeviceType::kCPU,
+                .act_dtype = DataType::Float32(),
+                .weight_dtype = DataType::Float32(),
+        });
+
+        const StatusOr<ExecutionPlan> plan = ExecutionPlanBuilder::Build(runtime, lowered);
+        if (order == KVLayoutOrder::kHeadMajor) {
+            EXPECT_EQ(plan.status().code(), StatusCode::kNotFound);
+            continue;
+        }
+        ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+        EXPECT_EQ(plan->steps()[0].selector.kv_layout, KVLayoutOrder::kTokenMajor);
+    }
+}
+
 }// namespace
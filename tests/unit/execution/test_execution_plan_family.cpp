@@ -0,0 +1,233 @@
+#include "aethermind/execution/execution_plan_builder.h"
+#include "aethermind/execution/execution_plan_family.h"
+
+#include "aethermind/runtime/runtime_builder.h"
+#include "aethermind/shape_inference/symbol_constraint_solver.h"
+#include "../test_utils/plan_fixtures.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+using test_utils::MakeSequenceRmsNormGraph;
+using test_utils::SequenceRmsNormGraph;
+
+TEST(ExecutionPlanFamily, BuildsDecodeAndPowerOfTwoPrefillBuckets) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered,
+            PlanBucketConfig{.min_prefill_bucket = 16, .max_prefill_tokens = 40});
+
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+    ASSERT_EQ(family->size(), 4U);
+    const auto& buckets = family->buckets();
+    EXPECT_EQ(buckets[0].min_tokens, 1U);
+    EXPECT_EQ(buckets[0].max_tokens, 1U);
+    EXPECT_EQ(buckets[1].min_tokens, 2U);
+    EXPECT_EQ(buckets[1].max_tokens, 16U);
+    EXPECT_EQ(buckets[2].min_tokens, 17U);
+    EXPECT_EQ(buckets[2].max_tokens, 32U);
+    EXPECT_EQ(buckets[3].min_tokens, 33U);
+    EXPECT_EQ(buckets[3].max_tokens, 64U);
+    EXPECT_EQ(family->max_tokens(), 64U);
+}
+
+TEST(ExecutionPlanFamily, DecodeBucketFoldsSequenceDimension) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered, PlanBucketConfig{.max_prefill_tokens = 16});
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+
+    const StatusOr<const ExecutionPlan*> decode = family->Select(1);
+    ASSERT_TRUE(decode.ok()) << decode.status().ToString();
+    const ExecutionStep& step = (*decode)->steps().front();
+    EXPECT_EQ(step.selector.phase, ExecPhase::kDecode);
+    ASSERT_EQ(step.input_specs[0].shape.rank(), 1U);
+    ASSERT_TRUE(step.input_specs[0].shape[0].IsStatic());
+    EXPECT_EQ(step.input_specs[0].shape[0].GetStaticValue(), 1);
+    ASSERT_TRUE(step.output_specs[0].shape[0].IsStatic());
+    EXPECT_EQ(step.output_specs[0].shape[0].GetStaticValue(), 1);
+
+    // Positivity of the folded dimension is proven; the weight-length
+    // equality still involves a runtime symbol and stays deferred.
+    ASSERT_EQ(step.runtime_checks.size(), 1U);
+    EXPECT_TRUE(std::holds_alternative<DimEqualConstraint>(step.runtime_checks[0].condition));
+}
+
+TEST(ExecutionPlanFamily, PrefillBucketKeepsSymbolAndDischargesPositivity) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered, PlanBucketConfig{.max_prefill_tokens = 16});
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+
+    const StatusOr<const ExecutionPlan*> prefill = family->Select(9);
+    ASSERT_TRUE(prefill.ok()) << prefill.status().ToString();
+    const ExecutionStep& step = (*prefill)->steps().front();
+    EXPECT_EQ(step.selector.phase, ExecPhase::kPrefill);
+    EXPECT_EQ(step.input_specs[0].shape[0], graph.seq_len);
+    ASSERT_EQ(step.runtime_checks.size(), 1U);
+    EXPECT_TRUE(std::holds_alternative<DimEqualConstraint>(step.runtime_checks[0].condition));
+}
+
+TEST(ExecutionPlanFamily, ProvenFactsCompileOutDischargedChecks) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+    SymbolConstraintSolver solver;
+    ASSERT_TRUE(solver.AddEqual(graph.seq_len, graph.weight_len).ok());
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered, PlanBucketConfig{.max_prefill_tokens = 16, .proven_facts = &solver});
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+
+    // The prefill bucket keeps the sequence symbol, which the solver ties to
+    // the weight length, so LayerRunner has nothing left to check.
+    EXPECT_TRUE((*family->Select(9))->steps().front().runtime_checks.empty());
+    // The decode bucket folds the symbol to 1; the weight length is unbound.
+    const auto& decode_checks = (*family->Select(1))->steps().front().runtime_checks;
+    ASSERT_EQ(decode_checks.size(), 1U);
+    EXPECT_TRUE(std::holds_alternative<DimEqualConstraint>(decode_checks[0].condition));
+}
+
+TEST(ExecutionPlanFamily, ProvenFactsContradictingABucketFailTheBuild) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+    SymbolConstraintSolver solver;
+    ASSERT_TRUE(solver.AddEqual(graph.weight_len, int64_t{8}).ok());
+
+    // A one-token activation can never match an 8-element weight.
+    const auto family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered, PlanBucketConfig{.max_prefill_tokens = 16, .proven_facts = &solver});
+    EXPECT_EQ(family.status().code(), StatusCode::kInvalidArgument);
+}
+
+TEST(ExecutionPlanFamily, SelectPicksSmallestCoveringBucket) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered,
+            PlanBucketConfig{.min_prefill_bucket = 4, .max_prefill_tokens = 8});
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+    const auto& buckets = family->buckets();
+
+    EXPECT_EQ(*family->Select(1), &buckets[0].plan);
+    EXPECT_EQ(*family->Select(2), &buckets[1].plan);
+    EXPECT_EQ(*family->Select(4), &buckets[1].plan);
+    EXPECT_EQ(*family->Select(5), &buckets[2].plan);
+    EXPECT_EQ(*family->Select(8), &buckets[2].plan);
+
+    EXPECT_EQ(family->Select(0).status().code(), StatusCode::kOutOfRange);
+    EXPECT_EQ(family->Select(9).status().code(), StatusCode::kOutOfRange);
+}
+
+TEST(ExecutionPlanFamily, WithoutDecodeFirstPrefillBucketStartsAtOneToken) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered,
+            PlanBucketConfig{.include_decode = false, .max_prefill_tokens = 16});
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+    ASSERT_EQ(family->size(), 1U);
+    EXPECT_EQ(family->buckets()[0].min_tokens, 1U);
+    EXPECT_EQ(family->buckets()[0].max_tokens, 16U);
+    EXPECT_EQ(family->buckets()[0].plan.steps().front().selector.phase, ExecPhase::kPrefill);
+}
+
+TEST(ExecutionPlanFamily, RejectsInvalidBucketConfig) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const auto no_limit = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered, PlanBucketConfig{});
+    EXPECT_EQ(no_limit.status().code(), StatusCode::kInvalidArgument);
+
+    const auto not_power_of_two = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered,
+            PlanBucketConfig{.min_prefill_bucket = 12, .max_prefill_tokens = 64});
+    EXPECT_EQ(not_power_of_two.status().code(), StatusCode::kInvalidArgument);
+
+    const auto static_seq = ExecutionPlanBuilder::BuildBucketed(
+            runtime, graph.lowered,
+            PlanBucketConfig{.seq_len = ShapeSymbol::CreateFromValue(4),
+                             .max_prefill_tokens = 64});
+    EXPECT_EQ(static_seq.status().code(), StatusCode::kInvalidArgument);
+}
+
+TEST(ExecutionPlanFamily, DecodeBatchedFamilyUsesDecodeKernelsForEveryBatchSize) {
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ExecutionPlanFamily> family = ExecutionPlanBuilder::BuildDecodeBatched(
+            runtime, graph.lowered, DecodeBatchConfig{.max_batch = 6});
+    ASSERT_TRUE(family.ok()) << family.status().ToString();
+    ASSERT_EQ(family->size(), 4U);
+    const auto& buckets = family->buckets();
+    EXPECT_EQ(buckets[1].min_tokens, 2U);
+    EXPECT_EQ(buckets[1].max_tokens, 2U);
+    EXPECT_EQ(buckets[2].min_tokens, 3U);
+    EXPECT_EQ(buckets[2].max_tokens, 4U);
+    EXPECT_EQ(buckets[3].max_tokens, 8U);
+    for (const ExecutionPlanBucket& bucket: buckets) {
+        EXPECT_EQ(bucket.plan.steps().front().selector.phase, ExecPhase::kDecode);
+    }
+
+    // The exact batch-of-two bucket folds the token axis to a static size.
+    const ExecutionStep& pair = buckets[1].plan.steps().front();
+    ASSERT_TRUE(pair.input_specs[0].shape[0].IsStatic());
+    EXPECT_EQ(pair.input_specs[0].shape[0].GetStaticValue(), 2);
+
+    const auto empty = ExecutionPlanBuilder::BuildDecodeBatched(
+            runtime, graph.lowered, DecodeBatchConfig{});
+    EXPECT_EQ(empty.status().code(), StatusCode::kInvalidArgument);
+}
+
+TEST(ExecutionPlanFamily, PlanActivationsBoundsSequenceByLargestBucket) {
+    const SequenceRmsNormGraph graph = MakeSequenceRmsNormGraph();
+
+    const StatusOr<ActivationPlan> plan = ExecutionPlanBuilder::PlanActivations(graph.lowered, 64);
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    ASSERT_EQ(plan->size(), 1U);
+    const PlannedActivation* output = plan->Find(0, 0);
+    ASSERT_NE(output, nullptr);
+    EXPECT_EQ(output->bytes, 64U * sizeof(float));
+    EXPECT_EQ(plan->total_bytes, 64U * sizeof(float));
+
+    EXPECT_EQ(ExecutionPlanBuilder::PlanActivations(graph.lowered, 0).status().code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(ExecutionPlanFamily, CreateRejectsOverlappingBuckets) {
+    std::vector<ExecutionPlanBucket> buckets(2);
+    buckets[0].min_tokens = 1;
+    buckets[0].max_tokens = 8;
+    buckets[1].min_tokens = 8;
+    buckets[1].max_tokens = 16;
+
+    const auto family = ExecutionPlanFamily::Create(std::move(buckets));
+    EXPECT_EQ(family.status().code(), StatusCode::kInvalidArgument);
+
+    const auto empty = ExecutionPlanFamily::Create({});
+    EXPECT_EQ(empty.status().code(), StatusCode::kInvalidArgument);
+}
+
+}// namespace
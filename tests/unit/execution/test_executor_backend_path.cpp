@@ -198,6 +198,9 @@ public:
                 return &FailingKernel;
             case OpType::kAttention:
                 return &FirstKernel;
+            case OpType::kAdd:
+                // Elementwise, so the activation-alias tests may run it in place.
+                return &FirstKernel;
             case OpType::kRmsNorm:
                 // Used by the runtime shape-constraint tests: RmsNorm produces a
                 // DimEqualConstraint via InferOperator that Executor::Execute
@@ -238,6 +241,8 @@ private:
                 return "test::failing_kernel";
             case OpType::kAttention:
                 return "test::runtime_constraint_kernel";
+            case OpType::kAdd:
+                return "test::in_place_add_kernel";
             case OpType::kRmsNorm:
                 return "test::rmsnorm_constraint_kernel";
             default:
@@ -545,4 +550,245 @@ TEST(ExecutorBackendPath, ExecuteRunsWhenRuntimeShapeConstraintIsSatisfied) {
     EXPECT_EQ(execution_order.size(), 1U);
 }
 
+StatusOr<ExecutionPlan> MakeInPlaceAddPlan(RuntimeContext& runtime) {
+    const SymbolicShape shape = SymbolicShape(IntArrayView{std::vector<int64_t>{4, 8}});
+    std::vector<TensorSpec> inputs = {
+            TensorSpec{.dtype = DataType::Float32(), .shape = shape},
+            TensorSpec{.dtype = DataType::Float32(), .shape = shape},
+    };
+    const auto analyzed = InferOperator(OpType::kAdd, OpParams{AddParams{}}, inputs);
+    AM_RETURN_IF_ERROR(analyzed.status());
+
+    ExecutionPlanNodeSpec node{
+            .op_type = OpType::kAdd,
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+    };
+    node.op_params = OpParams{AddParams{}};
+    node.input_specs = inputs;
+    node.output_specs = analyzed->outputs;
+
+    AM_ASSIGN_OR_RETURN(const ExecutionPlan built,
+                        ExecutionPlanBuilder::Build(runtime, std::vector<ExecutionPlanNodeSpec>{node}));
+    // Add is elementwise, so its output may overwrite its first input.
+    return ExecutionPlan::Create(
+            built.steps(),
+            StateAliasPlan{.aliases = {ResolvedStateAlias{
+                                   .step_index = 0,
+                                   .input_port = 0,
+                                   .output_port = 0,
+                                   .kind = StateAliasKind::kActivation,
+                           }}});
+}
+
+TEST(ExecutorBackendPath, ExecuteRejectsActivationAliasWithDistinctStorage) {
+    RuntimeContext runtime = MakeRuntime();
+    RuntimeBindingContext bindings;
+    std::vector<int> execution_order;
+    g_execution_order = &execution_order;
+
+    const StatusOr<ExecutionPlan> plan = MakeInPlaceAddPlan(runtime);
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+
+    RuntimeTensorStorage input{std::vector<int64_t>{4, 8}};
+    RuntimeTensorStorage other{std::vector<int64_t>{4, 8}};
+    RuntimeTensorStorage output{std::vector<int64_t>{4, 8}};
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {input.View(), other.View()},
+                                             .outputs = {output.MutableView()},
+                                     });
+
+    const Status status = Executor::Execute(*plan, bindings);
+
+    g_execution_order = nullptr;
+    EXPECT_EQ(status.code(), StatusCode::kInvalidArgument);
+    EXPECT_TRUE(execution_order.empty());
+}
+
+TEST(ExecutorBackendPath, ExecuteRunsActivationAliasSharingStorage) {
+    RuntimeContext runtime = MakeRuntime();
+    RuntimeBindingContext bindings;
+    std::vector<int> execution_order;
+    g_execution_order = &execution_order;
+
+    const StatusOr<ExecutionPlan> plan = MakeInPlaceAddPlan(runtime);
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+
+    RuntimeTensorStorage activation{std::vector<int64_t>{4, 8}};
+    RuntimeTensorStorage other{std::vector<int64_t>{4, 8}};
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {activation.View(), other.View()},
+                                             .outputs = {activation.MutableView()},
+                                     });
+
+    const Status status = Executor::Execute(*plan, bindings);
+
+    g_execution_order = nullptr;
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    EXPECT_EQ(execution_order.size(), 1U);
+}
+
+StatusOr<ExecutionPlan> MakeSymbolicRmsNormPlan(RuntimeContext& runtime,
+                                                ShapeSymbol hidden,
+                                                ShapeSymbol weight_dim) {
+    const SymbolicShape act_shape(std::vector<ShapeSymbol>{ShapeSymbol::Create(), hidden});
+    const SymbolicShape weight_shape(std::vector<ShapeSymbol>{weight_dim});
+    AM_ASSIGN_OR_RETURN(const auto analyzed, InferRmsNorm(1.0e-5F, act_shape, weight_shape));
+
+    ExecutionPlanNodeSpec node{
+            .op_type = OpType::kRmsNorm,
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+    };
+    node.op_params = OpParams{RmsNormParams{.eps = 1.0e-5F}};
+    node.input_specs = {
+            TensorSpec{.dtype = DataType::Float32(), .shape = act_shape},
+            TensorSpec{.dtype = DataType::Float32(), .shape = weight_shape},
+    };
+    node.output_specs = analyzed.outputs;
+    node.runtime_checks = analyzed.runtime_checks;
+    return ExecutionPlanBuilder::Build(runtime, std::vector<ExecutionPlanNodeSpec>{node});
+}
+
+TEST(ExecutorBackendPath, CachedShapeChecksRunOncePerShapeSignature) {
+    RuntimeContext runtime = MakeRuntime();
+    RuntimeBindingContext bindings;
+    bindings.SetShapeCheckMode(RuntimeShapeCheckMode::kCached);
+    std::vector<int> execution_order;
+    g_execution_order = &execution_order;
+
+    const StatusOr<ExecutionPlan> plan =
+            MakeSymbolicRmsNormPlan(runtime, ShapeSymbol::Create(), ShapeSymbol::Create());
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    ASSERT_FALSE(plan->steps().front().runtime_checks.empty());
+
+    RuntimeTensorStorage token{std::vector<int64_t>{1, 8}};
+    RuntimeTensorStorage weight{std::vector<int64_t>{8}};
+    RuntimeTensorStorage token_out{std::vector<int64_t>{1, 8}};
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {token.View(), weight.View()},
+                                             .outputs = {token_out.MutableView()},
+                                     });
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(Executor::Execute(*plan, bindings).ok());
+    }
+    EXPECT_EQ(bindings.shape_check_cache().miss_count(), 1U);
+    EXPECT_EQ(bindings.shape_check_cache().hit_count(), 2U);
+
+    // A new shape class is verified again before it is trusted.
+    RuntimeTensorStorage chunk{std::vector<int64_t>{4, 8}};
+    RuntimeTensorStorage chunk_out{std::vector<int64_t>{4, 8}};
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {chunk.View(), weight.View()},
+                                             .outputs = {chunk_out.MutableView()},
+                                     });
+    ASSERT_TRUE(Executor::Execute(*plan, bindings).ok());
+    EXPECT_EQ(bindings.shape_check_cache().miss_count(), 2U);
+
+    g_execution_order = nullptr;
+    EXPECT_EQ(execution_order.size(), 4U);
+}
+
+TEST(ExecutorBackendPath, CachedShapeChecksStillRejectViolations) {
+    RuntimeContext runtime = MakeRuntime();
+    RuntimeBindingContext bindings;
+    bindings.SetShapeCheckMode(RuntimeShapeCheckMode::kCached);
+    std::vector<int> execution_order;
+    g_execution_order = &execution_order;
+
+    const StatusOr<ExecutionPlan> plan =
+            MakeSymbolicRmsNormPlan(runtime, ShapeSymbol::Create(), ShapeSymbol::Create());
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+
+    RuntimeTensorStorage input{std::vector<int64_t>{2, 8}};
+    RuntimeTensorStorage good_weight{std::vector<int64_t>{8}};
+    RuntimeTensorStorage bad_weight{std::vector<int64_t>{16}};
+    RuntimeTensorStorage output{std::vector<int64_t>{2, 8}};
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {input.View(), good_weight.View()},
+                                             .outputs = {output.MutableView()},
+                                     });
+    ASSERT_TRUE(Executor::Execute(*plan, bindings).ok());
+
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {input.View(), bad_weight.View()},
+                                             .outputs = {output.MutableView()},
+                                     });
+    for (int i = 0; i < 2; ++i) {
+        const Status status = Executor::Execute(*plan, bindings);
+        EXPECT_EQ(status.code(), StatusCode::kInvalidArgument);
+    }
+
+    g_execution_order = nullptr;
+    EXPECT_EQ(execution_order.size(), 1U);
+}
+
+TEST(ExecutorBackendPath, CachedShapeChecksKeepAlternatingSignatures) {
+    RuntimeContext runtime = MakeRuntime();
+    RuntimeBindingContext bindings;
+    bindings.SetShapeCheckMode(RuntimeShapeCheckMode::kCached);
+    std::vector<int> execution_order;
+    g_execution_order = &execution_order;
+
+    const StatusOr<ExecutionPlan> plan =
+            MakeSymbolicRmsNormPlan(runtime, ShapeSymbol::Create(), ShapeSymbol::Create());
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+
+    // A prefill chunk and a decode token share step 0 in turn, as a chunked
+    // prompt followed by decoding does.
+    RuntimeTensorStorage weight{std::vector<int64_t>{8}};
+    RuntimeTensorStorage chunk{std::vector<int64_t>{4, 8}};
+    RuntimeTensorStorage chunk_out{std::vector<int64_t>{4, 8}};
+    RuntimeTensorStorage token{std::vector<int64_t>{1, 8}};
+    RuntimeTensorStorage token_out{std::vector<int64_t>{1, 8}};
+    for (int i = 0; i < 3; ++i) {
+        bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                                 .inputs = {chunk.View(), weight.View()},
+                                                 .outputs = {chunk_out.MutableView()},
+                                         });
+        ASSERT_TRUE(Executor::Execute(*plan, bindings).ok());
+        bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                                 .inputs = {token.View(), weight.View()},
+                                                 .outputs = {token_out.MutableView()},
+                                         });
+        ASSERT_TRUE(Executor::Execute(*plan, bindings).ok());
+    }
+    EXPECT_EQ(bindings.shape_check_cache().miss_count(), 2U);
+    EXPECT_EQ(bindings.shape_check_cache().hit_count(), 4U);
+
+    g_execution_order = nullptr;
+    EXPECT_EQ(execution_order.size(), 6U);
+}
+
+TEST(ExecutorBackendPath, ShapeCheckCacheSeparatesPlansByIdentity) {
+    RuntimeContext runtime = MakeRuntime();
+    const StatusOr<ExecutionPlan> first =
+            MakeSymbolicRmsNormPlan(runtime, ShapeSymbol::Create(), ShapeSymbol::Create());
+    const StatusOr<ExecutionPlan> second =
+            MakeSymbolicRmsNormPlan(runtime, ShapeSymbol::Create(), ShapeSymbol::Create());
+    ASSERT_TRUE(first.ok()) << first.status().ToString();
+    ASSERT_TRUE(second.ok()) << second.status().ToString();
+    EXPECT_NE(first->id(), second->id());
+
+    const ExecutionPlan copy = *first;
+    EXPECT_EQ(copy.id(), first->id());
+
+    RuntimeTensorStorage input{std::vector<int64_t>{2, 8}};
+    RuntimeTensorStorage output{std::vector<int64_t>{2, 8}};
+    const std::vector<TensorView> inputs = {input.View()};
+    const std::vector<MutableTensorView> outputs = {output.MutableView()};
+    ShapeCheckCache cache;
+    cache.Reserve(0, inputs, outputs);
+    cache.MarkVerified(first->id(), 0, inputs, outputs);
+    // Unreserved steps are never remembered rather than grown in place.
+    cache.MarkVerified(first->id(), 1, inputs, outputs);
+
+    EXPECT_TRUE(cache.IsVerified(copy.id(), 0, inputs, outputs));
+    EXPECT_FALSE(cache.IsVerified(second->id(), 0, inputs, outputs));
+    EXPECT_FALSE(cache.IsVerified(first->id(), 1, inputs, outputs));
+    EXPECT_FALSE(cache.IsVerified(first->id(), 0, inputs, {}));
+}
+
 }// namespace
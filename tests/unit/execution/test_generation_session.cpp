@@ -0,0 +1,357 @@
+#include "aethermind/execution/generation_session.h"
+
+#include "aethermind/runtime/runtime_builder.h"
+#include "../test_utils/plan_fixtures.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+// The binder publishes the session's bindings; kernels read their step
+// tensors and sequence state through them and record decode positions.
+using Probe = test_utils::KernelProbe<size_t>;
+size_t g_target_passes = 0;
+const RuntimeBindingContext* g_draft_bindings = nullptr;
+// The draft guesses wrong after every token that is 3 mod 4.
+bool g_draft_diverges = false;
+
+// Toy language model: the next token of every row is its input token plus one.
+Status NextToken(int bucket) noexcept {
+    ++g_target_passes;
+    StatusOr<const StepTensorBinding*> binding = Probe::bindings->GetStepTensorBinding(0);
+    if (!binding.ok()) {
+        return binding.status();
+    }
+    const StepTensorBinding& step = **binding;
+    const size_t num_tokens = Probe::bindings->sequence_state().step_tokens;
+    if (static_cast<size_t>(step.inputs[0].numel()) != num_tokens) {
+        return Status::Internal("step tensors are not bound for this step shape");
+    }
+    const int64_t* tokens = step.inputs[0].data<int64_t>();
+    const int64_t* positions = step.inputs[1].data<int64_t>();
+    int64_t* out = step.outputs[0].data<int64_t>();
+    for (size_t i = 0; i < num_tokens; ++i) {
+        out[i] = tokens[i] + 1;
+    }
+    if (bucket == 1 && Probe::observed != nullptr) {
+        Probe::observed->push_back(static_cast<size_t>(positions[0]));
+        if (Probe::bindings->kv_cache_view().committed_tokens() != static_cast<size_t>(positions[0])) {
+            return Status::Internal("decode position is not the committed KV length");
+        }
+    }
+    return Status::Ok();
+}
+
+Status DecodeKernel(const KernelContext&) noexcept {
+    return NextToken(1);
+}
+
+Status PrefillKernel(const KernelContext&) noexcept {
+    return NextToken(2);
+}
+
+Status DraftKernel(const KernelContext&) noexcept {
+    StatusOr<const StepTensorBinding*> binding = g_draft_bindings->GetStepTensorBinding(0);
+    if (!binding.ok()) {
+        return binding.status();
+    }
+    const StepTensorBinding& step = **binding;
+    const int64_t* tokens = step.inputs[0].data<int64_t>();
+    const int64_t* positions = step.inputs[1].data<int64_t>();
+    int64_t* out = step.outputs[0].data<int64_t>();
+    for (size_t i = 0; i < g_draft_bindings->sequence_state().step_tokens; ++i) {
+        out[i] = tokens[i] + (g_draft_diverges && tokens[i] % 4 == 3 ? 5 : 1);
+    }
+    // Rejected drafts must have been rolled back before the draft moves on.
+    if (g_draft_bindings->kv_cache_view().committed_tokens() != static_cast<size_t>(positions[0])) {
+        return Status::Internal("draft position is not the committed KV length");
+    }
+    return Status::Ok();
+}
+
+ExecutionPlanFamily MakeFamily(KernelFunc decode = &DecodeKernel, KernelFunc prefill = &PrefillKernel) {
+    return test_utils::MakeTwoBucketFamily(decode, prefill);
+}
+
+Status BindTokens(const GenerationStepIO& io, RuntimeBindingContext& bindings) {
+    Probe::bindings = &bindings;
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {io.token_ids, io.position_ids},
+                                             .outputs = {io.output_tokens},
+                                     });
+    return Status::Ok();
+}
+
+Status BindDraftTokens(const GenerationStepIO& io, RuntimeBindingContext& bindings) {
+    g_draft_bindings = &bindings;
+    bindings.SetStepTensorBinding(0, StepTensorBinding{
+                                             .inputs = {io.token_ids, io.position_ids},
+                                             .outputs = {io.output_tokens},
+                                     });
+    return Status::Ok();
+}
+
+RuntimeContext MakeRuntime(bool sliding_window = false) {
+    RuntimeOptions options;
+    options.kv_cache.enable_manager = true;
+    options.kv_cache.num_layers = 1;
+    options.kv_cache.num_kv_heads = 1;
+    options.kv_cache.max_tokens = 64;
+    options.kv_cache.head_dim = 4;
+    options.kv_cache.kv_dtype = DataType::Float32();
+    options.kv_cache.sliding_window = sliding_window;
+    RuntimeBuilder builder;
+    builder.WithOptions(options);
+    return builder.Build();
+}
+
+class GenerationSessionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Probe::Attach(nullptr, &decode_positions_);
+        g_target_passes = 0;
+        g_draft_diverges = false;
+        StatusOr<GenerationSession> session = GenerationSession::Create(
+                runtime_, MakeFamily(),
+                GenerationSessionOptions{.logits_bytes = 256, .binder = &BindTokens});
+        ASSERT_TRUE(session.ok()) << session.status().ToString();
+        session_ = std::make_unique<GenerationSession>(std::move(session).value());
+    }
+
+    void TearDown() override {
+        Probe::Detach();
+        g_draft_bindings = nullptr;
+    }
+
+    GenerationSession MakeDraft() {
+        StatusOr<GenerationSession> draft = GenerationSession::Create(
+                draft_runtime_, MakeFamily(&DraftKernel, &DraftKernel),
+                GenerationSessionOptions{.binder = &BindDraftTokens});
+        EXPECT_TRUE(draft.ok()) << draft.status().ToString();
+        return std::move(draft).value();
+    }
+
+    RuntimeContext runtime_ = MakeRuntime();
+    RuntimeContext draft_runtime_ = MakeRuntime();
+    std::unique_ptr<GenerationSession> session_;
+    std::vector<size_t> decode_positions_;
+};
+
+TEST_F(GenerationSessionTest, StreamsPrefillTokenThenDecodeTokens) {
+    const std::vector<int64_t> prompt = {10, 11, 12, 13, 14, 15};
+    std::vector<int64_t> streamed;
+    const StatusOr<GenerationResult> result = session_->Generate(
+            prompt, GenerationConfig{.max_new_tokens = 4},
+            [&](int64_t token) {
+                streamed.push_back(token);
+                return true;
+            });
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+
+    EXPECT_EQ(result->tokens, (std::vector<int64_t>{16, 17, 18, 19}));
+    EXPECT_EQ(streamed, result->tokens);
+    EXPECT_EQ(result->finish_reason, FinishReason::kLength);
+    // The last generated token is returned but never fed back.
+    EXPECT_EQ(decode_positions_, (std::vector<size_t>{6, 7, 8}));
+
+    const GenerationStats& stats = result->stats;
+    EXPECT_EQ(stats.prompt_tokens, 6U);
+    EXPECT_EQ(stats.generated_tokens, 4U);
+    EXPECT_GE(stats.ttft_ms, 0.0);
+    EXPECT_GE(stats.total_ms, stats.ttft_ms);
+    EXPECT_GT(stats.decode_tokens_per_second, 0.0);
+}
+
+TEST_F(GenerationSessionTest, BindsStepTensorsOncePerShape) {
+    const std::vector<int64_t> prompt = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    const StatusOr<GenerationResult> result = session_->Generate(prompt, GenerationConfig{.max_new_tokens = 8});
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+    EXPECT_EQ(result->tokens.size(), 8U);
+
+    // Chunks of 4, 4 and 2 prompt tokens, then seven decode steps: one bind
+    // for the full chunks, one for the tail and one for the whole decode loop.
+    EXPECT_EQ(result->stats.tensor_bind_calls, 3U);
+    EXPECT_EQ(runtime_.GetKVCacheManager()->active_sessions(), 0U);
+
+    // A later request rebinds only when the step shape changes.
+    const StatusOr<GenerationResult> again = session_->Generate(
+            std::vector<int64_t>{4, 5}, GenerationConfig{.max_new_tokens = 3});
+    ASSERT_TRUE(again.ok()) << again.status().ToString();
+    EXPECT_EQ(again->tokens, (std::vector<int64_t>{6, 7, 8}));
+    EXPECT_EQ(again->stats.tensor_bind_calls, 2U);
+}
+
+TEST_F(GenerationSessionTest, StopsAtEosAndIncludesIt) {
+    const StatusOr<GenerationResult> result = session_->Generate(
+            std::vector<int64_t>{1, 2}, GenerationConfig{.max_new_tokens = 16, .eos_token_id = 5});
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+    EXPECT_EQ(result->tokens, (std::vector<int64_t>{3, 4, 5}));
+    EXPECT_EQ(result->finish_reason, FinishReason::kEos);
+
+    // An EOS straight out of prefill is a normal stop without decoding.
+    decode_positions_.clear();
+    const StatusOr<GenerationResult> immediate = session_->Generate(
+            std::vector<int64_t>{3, 4}, GenerationConfig{.max_new_tokens = 16, .eos_token_id = 5});
+    ASSERT_TRUE(immediate.ok()) << immediate.status().ToString();
+    EXPECT_EQ(immediate->tokens, (std::vector<int64_t>{5}));
+    EXPECT_EQ(immediate->finish_reason, FinishReason::kEos);
+    EXPECT_TRUE(decode_positions_.empty());
+    EXPECT_EQ(immediate->stats.decode_tokens_per_second, 0.0);
+}
+
+TEST_F(GenerationSessionTest, CallbackCancelsGeneration) {
+    size_t seen = 0;
+    const StatusOr<GenerationResult> result = session_->Generate(
+            std::vector<int64_t>{1, 2, 3}, GenerationConfig{.max_new_tokens = 16},
+            [&](int64_t) { return ++seen < 2; });
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+    EXPECT_EQ(result->tokens, (std::vector<int64_t>{4, 5}));
+    EXPECT_EQ(result->finish_reason, FinishReason::kCancelled);
+    EXPECT_EQ(runtime_.GetKVCacheManager()->active_sessions(), 0U);
+}
+
+TEST_F(GenerationSessionTest, ValidatesRequests) {
+    EXPECT_EQ(session_->Generate({}, GenerationConfig{.max_new_tokens = 1}).status().code(),
+              StatusCode::kInvalidArgument);
+    const std::vector<int64_t> prompt = {1, 2};
+    EXPECT_EQ(session_->Generate(prompt, GenerationConfig{.max_new_tokens = 1, .prefill_chunk_tokens = 8})
+                      .status()
+                      .code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_FALSE(session_->Generate(prompt, GenerationConfig{.max_new_tokens = 200}).ok());
+    EXPECT_EQ(runtime_.GetKVCacheManager()->active_sessions(), 0U);
+
+    const StatusOr<GenerationResult> none = session_->Generate(prompt, GenerationConfig{});
+    ASSERT_TRUE(none.ok());
+    EXPECT_TRUE(none->tokens.empty());
+}
+
+TEST_F(GenerationSessionTest, SpeculativeDecodingVerifiesAcceptedDraftsInOnePass) {
+    GenerationSession draft = MakeDraft();
+    const std::vector<int64_t> prompt = {1, 2};
+    const StatusOr<GenerationResult> result = session_->GenerateSpeculative(
+            draft, prompt, GenerationConfig{.max_new_tokens = 9}, SpeculativeConfig{.num_draft_tokens = 3});
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+
+    EXPECT_EQ(result->tokens, (std::vector<int64_t>{3, 4, 5, 6, 7, 8, 9, 10, 11}));
+    EXPECT_EQ(result->finish_reason, FinishReason::kLength);
+    // Prefill plus two verification passes of four tokens each, instead of
+    // prefill plus eight decode steps.
+    EXPECT_EQ(g_target_passes, 3U);
+    EXPECT_EQ(result->stats.draft_tokens, 6U);
+    EXPECT_EQ(result->stats.accepted_draft_tokens, 6U);
+    EXPECT_EQ(runtime_.GetKVCacheManager()->active_sessions(), 0U);
+    EXPECT_EQ(draft_runtime_.GetKVCacheManager()->active_sessions(), 0U);
+}
+
+TEST_F(GenerationSessionTest, SpeculativeDecodingMatchesGreedyWhenDraftsAreRejected) {
+    const std::vector<int64_t> prompt = {5, 6, 7, 8, 9};
+    const GenerationConfig config{.max_new_tokens = 12, .eos_token_id = 30};
+    const StatusOr<GenerationResult> greedy = session_->Generate(prompt, config);
+    ASSERT_TRUE(greedy.ok()) << greedy.status().ToString();
+
+    g_draft_diverges = true;
+    GenerationSession draft = MakeDraft();
+    std::vector<int64_t> streamed;
+    const StatusOr<GenerationResult> result = session_->GenerateSpeculative(
+            draft, prompt, config, SpeculativeConfig{.num_draft_tokens = 3},
+            [&](int64_t token) {
+                streamed.push_back(token);
+                return true;
+            });
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+
+    EXPECT_EQ(result->tokens, greedy->tokens);
+    EXPECT_EQ(streamed, greedy->tokens);
+    EXPECT_GT(result->stats.accepted_draft_tokens, 0U);
+    EXPECT_LT(result->stats.accepted_draft_tokens, result->stats.draft_tokens);
+}
+
+TEST_F(GenerationSessionTest, SpeculativeDecodingValidatesDraftLength) {
+    GenerationSession draft = MakeDraft();
+    const std::vector<int64_t> prompt = {1, 2};
+    const GenerationConfig config{.max_new_tokens = 4};
+    EXPECT_EQ(session_->GenerateSpeculative(draft, prompt, config, SpeculativeConfig{.num_draft_tokens = 0})
+                      .status()
+                      .code(),
+              StatusCode::kInvalidArgument);
+    // The target's largest bucket holds four tokens: three drafts plus one.
+    EXPECT_EQ(session_->GenerateSpeculative(draft, prompt, config, SpeculativeConfig{.num_draft_tokens = 4})
+                      .status()
+                      .code(),
+              StatusCode::kInvalidArgument);
+    EXPECT_EQ(session_->GenerateSpeculative(*session_, prompt, config, SpeculativeConfig{}).status().code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST_F(GenerationSessionTest, SpeculativeDecodingRejectsSlidingWindowCaches) {
+    RuntimeContext ring = MakeRuntime(true);
+    StatusOr<GenerationSession> draft = GenerationSession::Create(
+            ring, MakeFamily(&DraftKernel, &DraftKernel), GenerationSessionOptions{.binder = &BindDraftTokens});
+    ASSERT_TRUE(draft.ok()) << draft.status().ToString();
+    const std::vector<int64_t> prompt = {1, 2};
+    EXPECT_EQ(session_->GenerateSpeculative(*draft, prompt, GenerationConfig{.max_new_tokens = 4},
+                                            SpeculativeConfig{.num_draft_tokens = 3})
+                      .status()
+                      .code(),
+              StatusCode::kFailedPrecondition);
+    EXPECT_EQ(g_target_passes, 0U);
+    EXPECT_EQ(runtime_.GetKVCacheManager()->active_sessions(), 0U);
+}
+
+Status RecordActivationArena(const GenerationStepIO& io, RuntimeBindingContext&) {
+    Probe::observed->push_back(io.activation_arena == nullptr ? 0 : io.activation_plan->total_bytes);
+    return Status::Ok();
+}
+
+TEST(GenerationSession, PlansActivationArenaForLargestBucket) {
+    std::vector<size_t> arena_bytes;
+    Probe::Attach(nullptr, &arena_bytes);
+    RuntimeContext runtime = MakeRuntime();
+    const test_utils::SequenceRmsNormGraph graph = test_utils::MakeSequenceRmsNormGraph();
+    StatusOr<GenerationSession> session = GenerationSession::Create(
+            runtime, graph.lowered,
+            GenerationSessionOptions{.max_prefill_tokens = 16,
+                                     .plan_activations = true,
+                                     .binder = &RecordActivationArena});
+    ASSERT_TRUE(session.ok()) << session.status().ToString();
+    // The RmsNorm output is the only intermediate: 16 float rows.
+    EXPECT_EQ(session->activation_plan().total_bytes, 16U * sizeof(float));
+
+    // The arena reaches the binder; the unbound plan itself fails to run.
+    EXPECT_FALSE(session->Generate(std::vector<int64_t>{1, 2}, GenerationConfig{.max_new_tokens = 1}).ok());
+    ASSERT_EQ(arena_bytes.size(), 1U);
+    EXPECT_EQ(arena_bytes[0], 16U * sizeof(float));
+    Probe::Detach();
+}
+
+TEST(GenerationSession, AdoptedFamilyCannotPlanActivations) {
+    RuntimeContext runtime = MakeRuntime();
+    EXPECT_EQ(GenerationSession::Create(runtime, MakeFamily(),
+                                        GenerationSessionOptions{.plan_activations = true,
+                                                                 .binder = &BindTokens})
+                      .status()
+                      .code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(GenerationSession, CreateRequiresKVCacheAndBinder) {
+    RuntimeBuilder builder;
+    RuntimeContext no_kv = builder.Build();
+    EXPECT_EQ(GenerationSession::Create(no_kv, MakeFamily(),
+                                        GenerationSessionOptions{.binder = &BindTokens})
+                      .status()
+                      .code(),
+              StatusCode::kFailedPrecondition);
+
+    RuntimeContext runtime = MakeRuntime();
+    EXPECT_EQ(GenerationSession::Create(runtime, MakeFamily(), GenerationSessionOptions{}).status().code(),
+              StatusCode::kInvalidArgument);
+}
+
+}// namespace
@@ -1,7 +1,18 @@
 #include "aethermind/execution/kv_cache_manager.h"
+#include "aethermind/execution/kv_decode_attention.h"
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 namespace {
 
 using namespace aethermind;
@@ -50,6 +61,20 @@ TEST(KVCacheManager, InitAndReserveCreatesValidView) {
     EXPECT_GT(manager.total_bytes(), 0U);
 }
 
+TEST(KVCacheManager, ReserveForChunkedPrefillCommitsNoPromptTokens) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 32, 8, MakeKVType(), 64).ok());
+
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(8, 8);
+
+    ASSERT_TRUE(view.ok());
+    EXPECT_EQ(view->token_capacity(), 16U);
+    EXPECT_EQ(view->committed_tokens(), 0U);
+    EXPECT_FALSE(view->KeyData(0, 0, 0).ok());
+    ASSERT_TRUE(view->CommitUntil(4).ok());
+    EXPECT_TRUE(view->KeyData(0, 0, 3).ok());
+}
+
 TEST(KVCacheManager, ReserveRejectsSecondActiveSession) {
     KVCacheManager manager;
     ASSERT_TRUE(manager.Init(1, 1, 16, 8, MakeKVType(), 64).ok());
@@ -95,6 +120,31 @@ TEST(KVCacheManager, ResetSessionRewindsToPromptLength) {
     EXPECT_EQ(view->current_pos(), 6U);
 }
 
+TEST(KVCacheManager, RollbackDiscardsTokensButKeepsBlocksMapped) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, 4, DataType::Float32(), 4, 8, 64, 1).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(4, 8);
+    ASSERT_TRUE(view.ok()) << view.status().ToString();
+    ASSERT_TRUE(view->CommitUntil(10).ok());
+    const size_t free_blocks = manager.Occupancy().free_blocks;
+
+    ASSERT_TRUE(view->RollbackTo(7).ok());
+    EXPECT_EQ(view->committed_tokens(), 7U);
+    EXPECT_EQ(view->KeyData(0, 0, 7).status().code(), StatusCode::kOutOfRange);
+    EXPECT_EQ(manager.Occupancy().free_blocks, free_blocks);
+    EXPECT_EQ(view->RollbackTo(8).code(), StatusCode::kInvalidArgument);
+    ASSERT_TRUE(view->CommitUntil(9).ok());
+
+    KVCacheManager ring;
+    ASSERT_TRUE(ring.InitSlidingWindow(1, 1, 8, 1, DataType::Float32()).ok());
+    StatusOr<KVCacheView> window = ring.ReserveForChunkedPrefill(4, 16);
+    ASSERT_TRUE(window.ok());
+    ASSERT_TRUE(window->CommitUntil(8).ok());
+    ASSERT_TRUE(window->RollbackTo(6).ok());
+    ASSERT_TRUE(window->CommitUntil(9).ok());
+    EXPECT_EQ(window->RollbackTo(8).code(), StatusCode::kFailedPrecondition);
+}
+
 TEST(KVCacheManager, ReleaseInvalidatesViewAndAllowsNewReservation) {
     KVCacheManager manager;
     ASSERT_TRUE(manager.Init(1, 2, 24, 8, MakeKVType(), 64).ok());
@@ -120,4 +170,459 @@ TEST(KVCacheManager, ReserveRejectsRequestsBeyondPhysicalCapacity) {
     EXPECT_EQ(view.status().code(), StatusCode::kOutOfRange);
 }
 
+TEST(KVCacheManager, MultiSlotManagerServesConcurrentSessions) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(2, 2, 16, 8, MakeKVType(), 64, 3).ok());
+    EXPECT_EQ(manager.num_slots(), 3U);
+
+    std::vector<KVCacheView> views;
+    for (size_t i = 0; i < 3; ++i) {
+        StatusOr<KVCacheView> view = manager.ReserveForSession(4, 4);
+        ASSERT_TRUE(view.ok()) << view.status().ToString();
+        views.push_back(*view);
+    }
+    EXPECT_EQ(manager.ReserveForSession(4, 4).status().code(), StatusCode::kResourceExhausted);
+
+    // Each session writes into its own region of the shared planes.
+    std::set<size_t> slots;
+    std::set<void*> keys;
+    for (KVCacheView& view: views) {
+        slots.insert(view.slot_index());
+        const StatusOr<void*> key = view.MutableKeyData(1, 1, 7);
+        ASSERT_TRUE(key.ok()) << key.status().ToString();
+        keys.insert(*key);
+    }
+    EXPECT_EQ(slots.size(), 3U);
+    EXPECT_EQ(keys.size(), 3U);
+
+    const KVCacheOccupancy occupancy = manager.Occupancy();
+    EXPECT_EQ(occupancy.num_slots, 3U);
+    EXPECT_EQ(occupancy.active_slots, 3U);
+    EXPECT_EQ(occupancy.peak_active_slots, 3U);
+    EXPECT_EQ(occupancy.reserved_tokens, 24U);
+    EXPECT_EQ(occupancy.capacity_tokens, 48U);
+}
+
+TEST(KVCacheManager, ReusedSlotLeavesEarlierViewsStale) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 16, 8, MakeKVType(), 64, 2).ok());
+    StatusOr<KVCacheView> first = manager.ReserveForSession(2, 2);
+    StatusOr<KVCacheView> second = manager.ReserveForSession(2, 2);
+    ASSERT_TRUE(first.ok());
+    ASSERT_TRUE(second.ok());
+
+    const KVCacheView stale = *first;
+    ASSERT_TRUE(manager.ReleaseSession(*first).ok());
+    EXPECT_EQ(manager.active_sessions(), 1U);
+
+    StatusOr<KVCacheView> third = manager.ReserveForSession(2, 2);
+    ASSERT_TRUE(third.ok());
+    EXPECT_EQ(third->slot_index(), stale.slot_index());
+    EXPECT_FALSE(stale.valid());
+    EXPECT_TRUE(second->valid());
+    EXPECT_TRUE(third->valid());
+    EXPECT_EQ(manager.Occupancy().reserved_tokens, 8U);
+}
+
+TEST(KVCacheManager, RejectsViewsOwnedByAnotherManager) {
+    KVCacheManager manager;
+    KVCacheManager other;
+    ASSERT_TRUE(manager.Init(1, 1, 16, 8, MakeKVType(), 64, 2).ok());
+    ASSERT_TRUE(other.Init(1, 1, 16, 8, MakeKVType(), 64, 2).ok());
+    StatusOr<KVCacheView> view = other.ReserveForSession(2, 2);
+    ASSERT_TRUE(view.ok());
+
+    EXPECT_EQ(manager.ReleaseSession(*view).code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(manager.ResetSession(*view).code(), StatusCode::kInvalidArgument);
+    EXPECT_TRUE(view->valid());
+}
+
+TEST(KVCacheManager, MovedManagerKeepsItsViewsUsable) {
+    KVCacheManager original;
+    ASSERT_TRUE(original.Init(1, 1, 16, 1, DataType::Float32(), 64, 2).ok());
+    StatusOr<KVCacheView> view = original.ReserveForSession(2, 2);
+    ASSERT_TRUE(view.ok());
+    *static_cast<float*>(*view->MutableKeyData(0, 0, 1)) = 3.0F;
+
+    KVCacheManager moved = std::move(original);
+    EXPECT_FALSE(original.is_initialized());
+    EXPECT_EQ(original.ReleaseSession(*view).code(), StatusCode::kFailedPrecondition);
+
+    ASSERT_TRUE(moved.is_initialized());
+    EXPECT_EQ(moved.layout().head_dim, 1U);
+    ASSERT_TRUE(view->valid());
+    EXPECT_EQ(*static_cast<const float*>(*view->KeyData(0, 0, 1)), 3.0F);
+    ASSERT_TRUE(moved.ResetSession(*view).ok());
+    ASSERT_TRUE(moved.ReleaseSession(*view).ok());
+    EXPECT_EQ(moved.active_sessions(), 0U);
+}
+
+TEST(KVCacheManager, ConcurrentReserveAndReleaseNeverShareSlots) {
+    constexpr size_t kSlots = 4;
+    constexpr size_t kThreads = 8;
+    constexpr int kRounds = 200;
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 4, 1, DataType::Float32(), 64, kSlots).ok());
+
+    std::atomic<bool> shared_slot{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            const float tag = static_cast<float>(t + 1);
+            for (int round = 0; round < kRounds; ++round) {
+                StatusOr<KVCacheView> view = manager.ReserveForSession(1, 1);
+                if (!view.ok()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                auto* key = static_cast<float*>(*view->MutableKeyData(0, 0, 0));
+                *key = tag;
+                std::this_thread::yield();
+                if (*key != tag) {
+                    shared_slot.store(true);
+                }
+                if (!manager.ReleaseSession(*view).ok()) {
+                    shared_slot.store(true);
+                }
+            }
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(shared_slot.load());
+    EXPECT_EQ(manager.active_sessions(), 0U);
+    EXPECT_EQ(manager.Occupancy().reserved_tokens, 0U);
+    EXPECT_LE(manager.Occupancy().peak_active_slots, kSlots);
+}
+
+TEST(KVBlockPool, AllocatesEveryBlockOnceAndReusesReleasedBlocks) {
+    KVBlockPool pool;
+    pool.Reset(3);
+
+    std::set<uint32_t> blocks;
+    for (int i = 0; i < 3; ++i) {
+        blocks.insert(pool.Allocate());
+    }
+    EXPECT_EQ(blocks, (std::set<uint32_t>{0, 1, 2}));
+    EXPECT_EQ(pool.Allocate(), KVBlockPool::kInvalidBlock);
+    EXPECT_EQ(pool.free_blocks(), 0U);
+
+    pool.Retain(1);
+    EXPECT_EQ(pool.ref_count(1), 2U);
+    pool.Release(1);
+    EXPECT_EQ(pool.free_blocks(), 0U);
+    pool.Release(1);
+    EXPECT_EQ(pool.free_blocks(), 1U);
+    EXPECT_EQ(pool.ref_count(1), 0U);
+    EXPECT_EQ(pool.Allocate(), 1U);
+}
+
+TEST(KVCacheManager, PagedViewTranslatesPositionsThroughBlockTable) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(2, 2, 16, 4, DataType::Float32(), 4, 8, 64, 2).ok());
+    EXPECT_TRUE(manager.layout().paged());
+    EXPECT_EQ(manager.layout().block_stride, 2U * 2U * 4U * 4U * sizeof(float));
+
+    StatusOr<KVCacheView> first = manager.ReserveForSession(5, 3);
+    StatusOr<KVCacheView> second = manager.ReserveForSession(3, 1);
+    ASSERT_TRUE(first.ok()) << first.status().ToString();
+    ASSERT_TRUE(second.ok()) << second.status().ToString();
+    EXPECT_EQ(manager.Occupancy().free_blocks, 8U - 3U);
+
+    // Positions inside one block are contiguous; the next block may live anywhere.
+    auto* pos3 = static_cast<std::byte*>(*first->MutableKeyData(1, 1, 3));
+    auto* pos2 = static_cast<std::byte*>(*first->MutableKeyData(1, 1, 2));
+    EXPECT_EQ(pos3 - pos2, static_cast<std::ptrdiff_t>(manager.layout().token_stride));
+
+    auto* first_key = static_cast<float*>(*first->MutableKeyData(1, 1, 4, 2));
+    auto* second_key = static_cast<float*>(*second->MutableKeyData(1, 1, 0, 2));
+    *first_key = 1.0F;
+    *second_key = 2.0F;
+    EXPECT_EQ(*static_cast<const float*>(*first->KeyData(1, 1, 4, 2)), 1.0F);
+    EXPECT_EQ(*static_cast<const float*>(*second->KeyData(1, 1, 0, 2)), 2.0F);
+}
+
+TEST(KVCacheManager, PagedCommittedBlocksCoverSessionHistory) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, 1, DataType::Float32(), 4, 4).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(10, 0);
+    ASSERT_TRUE(view.ok());
+    ASSERT_TRUE(view->CommitUntil(10).ok());
+    for (size_t pos = 0; pos < 10; ++pos) {
+        *static_cast<float*>(*view->MutableKeyData(0, 0, pos)) = static_cast<float>(pos);
+    }
+
+    ASSERT_EQ(view->num_committed_blocks(), 3U);
+    size_t visited = 0;
+    for (size_t b = 0; b < view->num_committed_blocks(); ++b) {
+        const StatusOr<KVCacheBlock> block = view->CommittedBlock(0, 0, b);
+        ASSERT_TRUE(block.ok()) << block.status().ToString();
+        EXPECT_EQ(block->first_pos, b * 4);
+        for (size_t t = 0; t < block->num_tokens; ++t) {
+            const auto* key = static_cast<const std::byte*>(block->key) + t * block->token_stride;
+            EXPECT_EQ(*reinterpret_cast<const float*>(key), static_cast<float>(block->first_pos + t));
+            ++visited;
+        }
+    }
+    EXPECT_EQ(visited, 10U);
+    EXPECT_EQ(view->CommittedBlock(0, 0, 3).status().code(), StatusCode::kOutOfRange);
+}
+
+TEST(KVCacheManager, PagedPoolAdmitsMoreShortSessionsThanDenseSlots) {
+    KVCacheManager manager;
+    // 8 blocks of 4 tokens back 32 tokens, yet 4 sessions of up to 32 tokens fit
+    // as long as their committed history is short.
+    ASSERT_TRUE(manager.InitPaged(1, 1, 32, 8, MakeKVType(), 4, 8, 64, 4).ok());
+    std::vector<KVCacheView> views;
+    for (int i = 0; i < 4; ++i) {
+        StatusOr<KVCacheView> view = manager.ReserveForSession(8, 24);
+        ASSERT_TRUE(view.ok()) << view.status().ToString();
+        views.push_back(*view);
+    }
+    EXPECT_EQ(manager.Occupancy().free_blocks, 0U);
+
+    const size_t pos = views[0].committed_tokens();
+    EXPECT_EQ(views[0].CommitUntil(pos + 1).code(), StatusCode::kResourceExhausted);
+    EXPECT_EQ(views[0].committed_tokens(), pos);
+
+    ASSERT_TRUE(manager.ReleaseSession(views[1]).ok());
+    EXPECT_EQ(manager.Occupancy().free_blocks, 2U);
+    EXPECT_TRUE(views[0].CommitUntil(pos + 1).ok());
+}
+
+TEST(KVCacheManager, PagedReservationRollsBackWhenPoolIsExhausted) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, 8, MakeKVType(), 4, 3, 64, 2).ok());
+    StatusOr<KVCacheView> first = manager.ReserveForSession(8, 0);
+    ASSERT_TRUE(first.ok());
+
+    StatusOr<KVCacheView> second = manager.ReserveForSession(8, 0);
+    EXPECT_EQ(second.status().code(), StatusCode::kResourceExhausted);
+    EXPECT_EQ(manager.active_sessions(), 1U);
+    EXPECT_EQ(manager.Occupancy().free_blocks, 1U);
+
+    ASSERT_TRUE(manager.ResetSession(*first).ok());
+    ASSERT_TRUE(manager.ReleaseSession(*first).ok());
+    EXPECT_EQ(manager.Occupancy().free_blocks, 3U);
+}
+
+TEST(KVCacheManager, SlidingWindowWrapsPositionsIntoAFixedRing) {
+    KVCacheManager dense;
+    KVCacheManager manager;
+    ASSERT_TRUE(dense.Init(1, 1, 8, 1, DataType::Float32()).ok());
+    ASSERT_TRUE(manager.InitSlidingWindow(1, 1, 8, 1, DataType::Float32()).ok());
+    EXPECT_EQ(manager.total_bytes(), dense.total_bytes());
+
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(4, 16);
+    ASSERT_TRUE(view.ok()) << view.status().ToString();
+    for (size_t pos = 0; pos < 20; ++pos) {
+        *static_cast<float*>(*view->MutableKeyData(0, 0, pos)) = static_cast<float>(pos);
+        ASSERT_TRUE(view->CommitUntil(pos + 1).ok());
+    }
+
+    EXPECT_EQ(view->window_begin(), 12U);
+    EXPECT_EQ(*static_cast<const float*>(*view->KeyData(0, 0, 12)), 12.0F);
+    EXPECT_EQ(*static_cast<const float*>(*view->KeyData(0, 0, 19)), 19.0F);
+    EXPECT_EQ(view->KeyData(0, 0, 11).status().code(), StatusCode::kOutOfRange);
+    EXPECT_EQ(view->ValidateWrite(0, 0, 20, 9).code(), StatusCode::kOutOfRange);
+    EXPECT_EQ(manager.ResetSession(*view).code(), StatusCode::kFailedPrecondition);
+}
+
+TEST(KVCacheManager, SlidingWindowBlocksListResidentTokensInOrder) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitSlidingWindow(1, 1, 8, 1, DataType::Float32()).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(0, 20);
+    ASSERT_TRUE(view.ok());
+    for (size_t pos = 0; pos < 13; ++pos) {
+        *static_cast<float*>(*view->MutableKeyData(0, 0, pos)) = static_cast<float>(pos);
+    }
+    ASSERT_TRUE(view->CommitUntil(13).ok());
+
+    // Resident positions 5..12 occupy ring rows 5..7 then 0..4.
+    ASSERT_EQ(view->num_committed_blocks(), 2U);
+    std::vector<float> seen;
+    for (size_t b = 0; b < view->num_committed_blocks(); ++b) {
+        const StatusOr<KVCacheBlock> block = view->CommittedBlock(0, 0, b);
+        ASSERT_TRUE(block.ok()) << block.status().ToString();
+        for (size_t t = 0; t < block->num_tokens; ++t) {
+            const auto* key = static_cast<const std::byte*>(block->key) + t * block->token_stride;
+            EXPECT_EQ(*reinterpret_cast<const float*>(key), static_cast<float>(block->first_pos + t));
+            seen.push_back(*reinterpret_cast<const float*>(key));
+        }
+    }
+    EXPECT_EQ(seen, (std::vector<float>{5, 6, 7, 8, 9, 10, 11, 12}));
+}
+
+TEST(KVCacheManager, SlidingWindowInt8ScaleBlocksDivideTheRing) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitSlidingWindow(1, 1, 48, 4, DataType::Int(8)).ok());
+    EXPECT_EQ(manager.layout().walk_block_tokens, 24U);
+}
+
+std::filesystem::path SpillPath(const char* name) {
+    return std::filesystem::temp_directory_path() / (std::string("aethermind_kv_spill_") + name);
+}
+
+TEST(KVCacheManager, OffloadedSessionRoundTripsThroughDisk) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(2, 1, 16, 4, DataType::Int(8), 4, 4, 64, 2).ok());
+    ASSERT_TRUE(manager.EnableDiskOffload(SpillPath("round_trip")).ok());
+    EXPECT_FALSE(std::filesystem::exists(SpillPath("round_trip")));
+
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(10, 0);
+    ASSERT_TRUE(view.ok());
+    for (size_t pos = 0; pos < 10; ++pos) {
+        const float base = static_cast<float>(pos) - 4.5F;
+        const std::vector<float> key{base, -base, 2 * base, 0.5F};
+        ASSERT_TRUE(view->WriteToken(1, 0, pos, key, key).ok());
+    }
+    ASSERT_TRUE(view->CommitUntil(10).ok());
+
+    const StatusOr<size_t> offloaded = manager.OffloadSession(*view);
+    ASSERT_TRUE(offloaded.ok()) << offloaded.status().ToString();
+    EXPECT_EQ(*offloaded, 3U);
+    EXPECT_EQ(manager.Occupancy().free_blocks, 4U);
+    EXPECT_EQ(manager.Occupancy().offloaded_blocks, 3U);
+    std::vector<float> key(4);
+    std::vector<float> value(4);
+    EXPECT_EQ(view->ReadToken(1, 0, 3, key, value).code(), StatusCode::kFailedPrecondition);
+
+    // Another session may use the freed blocks while this one is parked.
+    StatusOr<KVCacheView> other = manager.ReserveForSession(12, 0);
+    ASSERT_TRUE(other.ok());
+    ASSERT_TRUE(manager.ReleaseSession(*other).ok());
+
+    std::future<Status> prefetch = manager.PrefetchSession(*view);
+    ASSERT_TRUE(prefetch.get().ok());
+    EXPECT_EQ(manager.Occupancy().offloaded_blocks, 0U);
+    EXPECT_EQ(manager.Occupancy().free_blocks, 1U);
+    ASSERT_TRUE(view->ReadToken(1, 0, 9, key, value).ok());
+    EXPECT_NEAR(key[0], 4.5F, 9.0F / 127.0F);
+    EXPECT_NEAR(value[2], 9.0F, 9.0F / 127.0F);
+}
+
+TEST(KVCacheManager, PrefetchFailsWhenThePoolIsFullAndCanBeRetried) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, 1, DataType::Float32(), 4, 4, 64, 2).ok());
+    ASSERT_TRUE(manager.EnableDiskOffload(SpillPath("retry")).ok());
+
+    StatusOr<KVCacheView> parked = manager.ReserveForSession(8, 0);
+    ASSERT_TRUE(parked.ok());
+    *static_cast<float*>(*parked->MutableKeyData(0, 0, 7)) = 7.0F;
+    ASSERT_TRUE(manager.OffloadSession(*parked).ok());
+
+    StatusOr<KVCacheView> busy = manager.ReserveForSession(12, 0);
+    ASSERT_TRUE(busy.ok());
+    EXPECT_EQ(manager.PrefetchSession(*parked).get().code(), StatusCode::kResourceExhausted);
+    EXPECT_EQ(manager.Occupancy().offloaded_blocks, 1U);
+
+    ASSERT_TRUE(manager.ReleaseSession(*busy).ok());
+    ASSERT_TRUE(manager.PrefetchSession(*parked).get().ok());
+    EXPECT_EQ(*static_cast<const float*>(*parked->KeyData(0, 0, 7)), 7.0F);
+}
+
+TEST(KVCacheManager, PrefetchOutlivesAMoveOfItsManager) {
+    KVCacheManager original;
+    ASSERT_TRUE(original.InitPaged(1, 1, 16, 1, DataType::Float32(), 4, 4, 64, 2).ok());
+    ASSERT_TRUE(original.EnableDiskOffload(SpillPath("moved")).ok());
+    StatusOr<KVCacheView> view = original.ReserveForSession(8, 0);
+    ASSERT_TRUE(view.ok());
+    *static_cast<float*>(*view->MutableKeyData(0, 0, 7)) = 7.0F;
+    ASSERT_TRUE(original.OffloadSession(*view).ok());
+
+    std::future<Status> prefetch = original.PrefetchSession(*view);
+    KVCacheManager moved = std::move(original);
+    ASSERT_TRUE(prefetch.get().ok());
+
+    EXPECT_EQ(moved.Occupancy().offloaded_blocks, 0U);
+    EXPECT_EQ(*static_cast<const float*>(*view->KeyData(0, 0, 7)), 7.0F);
+    ASSERT_TRUE(moved.ReleaseSession(*view).ok());
+}
+
+TEST(KVCacheManager, OffloadKeepsSharedBlocksAndReleaseFreesRecords) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, 1, DataType::Float32(), 4, 8, 64, 2).ok());
+    StatusOr<KVCacheView> idle = manager.ReserveForSession(1, 0);
+    ASSERT_TRUE(idle.ok());
+    EXPECT_EQ(manager.OffloadSession(*idle).status().code(), StatusCode::kFailedPrecondition);
+    // The disk tier is only added while no session holds a slot.
+    EXPECT_EQ(manager.EnableDiskOffload(SpillPath("shared")).code(), StatusCode::kFailedPrecondition);
+    ASSERT_TRUE(manager.ReleaseSession(*idle).ok());
+    ASSERT_TRUE(manager.EnableDiskOffload(SpillPath("shared")).ok());
+
+    const std::vector<int32_t> prompt = {1, 2, 3, 4, 5, 6};
+    StatusOr<KVCacheView> view = manager.ReserveWithPrefix(prompt, 2);
+    ASSERT_TRUE(view.ok());
+    ASSERT_TRUE(view->CommitUntil(prompt.size()).ok());
+    ASSERT_TRUE(manager.PublishPrefix(*view, prompt).ok());
+
+    const StatusOr<size_t> offloaded = manager.OffloadSession(*view);
+    ASSERT_TRUE(offloaded.ok());
+    EXPECT_EQ(*offloaded, 1U);
+    EXPECT_EQ(manager.Occupancy().cached_blocks, 1U);
+    ASSERT_TRUE(manager.ReleaseSession(*view).ok());
+    EXPECT_EQ(manager.Occupancy().offloaded_blocks, 0U);
+
+    KVCacheManager dense;
+    ASSERT_TRUE(dense.Init(1, 1, 16, 1, DataType::Float32()).ok());
+    EXPECT_EQ(dense.EnableDiskOffload(SpillPath("dense")).code(), StatusCode::kFailedPrecondition);
+}
+
+TEST(KVCacheManager, TokenMajorLayoutKeepsATokensHeadsContiguous) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(2, 4, 16, 8, DataType::Float32(), 64, 1, KVLayoutOrder::kTokenMajor).ok());
+    const KVCacheLayout& layout = manager.layout();
+    EXPECT_EQ(layout.order, KVLayoutOrder::kTokenMajor);
+    EXPECT_EQ(layout.head_stride, 8 * sizeof(float));
+    EXPECT_EQ(layout.token_stride, 4 * 8 * sizeof(float));
+    EXPECT_EQ(layout.layer_stride, 16 * 4 * 8 * sizeof(float));
+
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(2, 0);
+    ASSERT_TRUE(view.ok());
+    const auto* head0 = static_cast<std::byte*>(*view->MutableKeyData(1, 0, 1));
+    const auto* head3 = static_cast<std::byte*>(*view->MutableKeyData(1, 3, 1));
+    EXPECT_EQ(head3 - head0, static_cast<std::ptrdiff_t>(3 * layout.head_stride));
+
+    EXPECT_EQ(manager.Init(1, 1, 4, 4, DataType::Float32(), 64, 1, KVLayoutOrder::kAny).code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(KVCacheManager, DecodeAttentionAgreesAcrossLayoutOrders) {
+    constexpr size_t kHeads = 2;
+    constexpr size_t kDim = 4;
+    constexpr size_t kTokens = 11;
+    const std::vector<float> query{0.5F, -0.25F, 1.0F, 0.75F};
+
+    std::vector<std::vector<float>> outputs;
+    for (const KVLayoutOrder order: {KVLayoutOrder::kHeadMajor, KVLayoutOrder::kTokenMajor}) {
+        for (const bool paged: {false, true}) {
+            KVCacheManager manager;
+            ASSERT_TRUE((paged ? manager.InitPaged(1, kHeads, 16, kDim, DataType::Float32(), 4, 4, 64, 1, order)
+                               : manager.Init(1, kHeads, 16, kDim, DataType::Float32(), 64, 1, order))
+                                .ok());
+            StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(kTokens, 0);
+            ASSERT_TRUE(view.ok());
+            for (size_t pos = 0; pos < kTokens; ++pos) {
+                for (size_t head = 0; head < kHeads; ++head) {
+                    const float base = std::sin(static_cast<float>(pos * kHeads + head));
+                    const std::vector<float> row{base, -base, 0.5F * base, 1.0F};
+                    ASSERT_TRUE(view->WriteToken(0, head, pos, row, row).ok());
+                }
+            }
+            ASSERT_TRUE(view->CommitUntil(kTokens).ok());
+
+            std::vector<float> output(kDim);
+            ASSERT_TRUE(DecodeAttention(*view, 0, 1, query, 0.5F, output).ok());
+            outputs.push_back(output);
+        }
+    }
+    for (const std::vector<float>& output: outputs) {
+        for (size_t d = 0; d < kDim; ++d) {
+            EXPECT_NEAR(output[d], outputs[0][d], 1e-6F);
+        }
+    }
+}
+
 }// namespace
@@ -0,0 +1,156 @@
+#include "aethermind/execution/kv_prefix_cache.h"
+
+#include "aethermind/execution/kv_cache_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+std::vector<int32_t> Tokens(size_t count, int32_t first = 0) {
+    std::vector<int32_t> tokens(count);
+    std::iota(tokens.begin(), tokens.end(), first);
+    return tokens;
+}
+
+std::vector<uint32_t> AllocateBlocks(KVBlockPool& pool, size_t count) {
+    std::vector<uint32_t> blocks;
+    for (size_t i = 0; i < count; ++i) {
+        blocks.push_back(pool.Allocate());
+    }
+    return blocks;
+}
+
+TEST(KVPrefixCache, AcquiresLongestCachedFullBlockPrefix) {
+    KVBlockPool pool;
+    pool.Reset(8);
+    KVPrefixCache cache(&pool, 4);
+    const std::vector<int32_t> prompt = Tokens(10);
+    const std::vector<uint32_t> blocks = AllocateBlocks(pool, 2);
+
+    EXPECT_EQ(cache.Insert(prompt, blocks), 2U);
+    EXPECT_EQ(cache.Insert(prompt, blocks), 0U);
+    EXPECT_EQ(cache.num_cached_blocks(), 2U);
+    EXPECT_EQ(pool.ref_count(blocks[0]), 2U);
+
+    std::vector<int32_t> diverged = Tokens(12);
+    diverged[5] = 99;
+    const std::vector<uint32_t> hit = cache.Acquire(diverged);
+    ASSERT_EQ(hit.size(), 1U);
+    EXPECT_EQ(hit[0], blocks[0]);
+    EXPECT_EQ(pool.ref_count(blocks[0]), 3U);
+    EXPECT_TRUE(cache.Acquire(Tokens(8, 1)).empty());
+    EXPECT_EQ(cache.hit_blocks(), 1U);
+}
+
+TEST(KVPrefixCache, EvictsLeastRecentlyUsedUnreferencedLeavesFirst) {
+    KVBlockPool pool;
+    pool.Reset(8);
+    {
+        KVPrefixCache cache(&pool, 2);
+        const std::vector<uint32_t> a = AllocateBlocks(pool, 2);
+        const std::vector<uint32_t> b = AllocateBlocks(pool, 1);
+        ASSERT_EQ(cache.Insert(Tokens(4, 0), a), 2U);
+        ASSERT_EQ(cache.Insert(Tokens(2, 100), b), 1U);
+        for (const uint32_t block: {a[0], a[1], b[0]}) {
+            pool.Release(block);
+        }
+        // Touch the `a` chain so `b` becomes the oldest leaf.
+        for (const uint32_t block: cache.Acquire(Tokens(4, 0))) {
+            pool.Release(block);
+        }
+
+        EXPECT_EQ(cache.Evict(1), 1U);
+        EXPECT_EQ(pool.ref_count(b[0]), 0U);
+
+        // A session still references the leaf of `a`, so nothing is evictable.
+        const std::vector<uint32_t> held = cache.Acquire(Tokens(4, 0));
+        EXPECT_EQ(cache.Evict(4), 0U);
+        for (const uint32_t block: held) {
+            pool.Release(block);
+        }
+        EXPECT_EQ(cache.Evict(4), 2U);
+        EXPECT_EQ(cache.num_cached_blocks(), 0U);
+    }
+    EXPECT_EQ(pool.free_blocks(), 8U);
+}
+
+TEST(KVPrefixCache, SessionsReuseAPublishedPrefix) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 32, 1, DataType::Float32(), 4, 8, 64, 2).ok());
+    const std::vector<int32_t> prompt = Tokens(10);
+
+    StatusOr<KVCacheView> first = manager.ReserveWithPrefix(prompt, 2);
+    ASSERT_TRUE(first.ok()) << first.status().ToString();
+    EXPECT_EQ(first->committed_tokens(), 0U);
+    for (size_t pos = 0; pos < prompt.size(); ++pos) {
+        *static_cast<float*>(*first->MutableKeyData(0, 0, pos)) = static_cast<float>(pos);
+    }
+    ASSERT_TRUE(first->CommitUntil(prompt.size()).ok());
+    ASSERT_TRUE(manager.PublishPrefix(*first, prompt).ok());
+    EXPECT_EQ(manager.Occupancy().cached_blocks, 2U);
+
+    StatusOr<KVCacheView> second = manager.ReserveWithPrefix(prompt, 2);
+    ASSERT_TRUE(second.ok()) << second.status().ToString();
+    EXPECT_EQ(second->committed_tokens(), 8U);
+    EXPECT_EQ(*static_cast<const float*>(*second->KeyData(0, 0, 7)), 7.0F);
+    // The second session maps no block of its own until it prefills token 8.
+    EXPECT_EQ(manager.Occupancy().free_blocks, 8U - 3U);
+}
+
+TEST(KVPrefixCache, WritingIntoASharedBlockCopiesIt) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 32, 1, DataType::Float32(), 4, 8, 64, 2).ok());
+    const std::vector<int32_t> prompt = Tokens(8);
+
+    StatusOr<KVCacheView> first = manager.ReserveWithPrefix(prompt, 1);
+    ASSERT_TRUE(first.ok());
+    for (size_t pos = 0; pos < prompt.size(); ++pos) {
+        *static_cast<float*>(*first->MutableKeyData(0, 0, pos)) = static_cast<float>(pos);
+    }
+    ASSERT_TRUE(first->CommitUntil(prompt.size()).ok());
+    ASSERT_TRUE(manager.PublishPrefix(*first, prompt).ok());
+    ASSERT_TRUE(manager.ReleaseSession(*first).ok());
+    EXPECT_EQ(manager.Occupancy().free_blocks, 6U);
+
+    // The whole prompt is cached, but its last token is left to recompute.
+    StatusOr<KVCacheView> second = manager.ReserveWithPrefix(prompt, 1);
+    ASSERT_TRUE(second.ok());
+    ASSERT_EQ(second->committed_tokens(), 7U);
+    *static_cast<float*>(*second->MutableKeyData(0, 0, 7)) = -1.0F;
+    EXPECT_EQ(*static_cast<const float*>(*second->KeyData(0, 0, 6)), 6.0F);
+    EXPECT_EQ(manager.Occupancy().free_blocks, 5U);
+
+    StatusOr<KVCacheView> third = manager.ReserveWithPrefix(prompt, 1);
+    ASSERT_TRUE(third.ok());
+    EXPECT_EQ(*static_cast<const float*>(*third->KeyData(0, 0, 6)), 6.0F);
+    const StatusOr<KVCacheBlock> shared = third->CommittedBlock(0, 0, 1);
+    ASSERT_TRUE(shared.ok());
+    EXPECT_EQ(shared->num_tokens, 3U);
+}
+
+TEST(KVPrefixCache, PoolPressureEvictsUnreferencedPrefixes) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, 1, DataType::Float32(), 4, 4).ok());
+    const std::vector<int32_t> prompt = Tokens(12);
+
+    StatusOr<KVCacheView> first = manager.ReserveWithPrefix(prompt, 0);
+    ASSERT_TRUE(first.ok());
+    ASSERT_TRUE(first->CommitUntil(prompt.size()).ok());
+    ASSERT_TRUE(manager.PublishPrefix(*first, prompt).ok());
+    ASSERT_TRUE(manager.ReleaseSession(*first).ok());
+    EXPECT_EQ(manager.Occupancy().free_blocks, 1U);
+
+    StatusOr<KVCacheView> other = manager.ReserveWithPrefix(Tokens(16, 50), 0);
+    ASSERT_TRUE(other.ok());
+    EXPECT_TRUE(other->CommitUntil(16).ok());
+    EXPECT_EQ(manager.Occupancy().cached_blocks, 0U);
+    EXPECT_EQ(manager.Occupancy().free_blocks, 0U);
+}
+
+}// namespace
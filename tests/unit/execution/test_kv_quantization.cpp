@@ -0,0 +1,181 @@
+#include "aethermind/execution/kv_quantization.h"
+
+#include "aethermind/execution/kv_cache_manager.h"
+#include "aethermind/execution/kv_decode_attention.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr size_t kHeadDim = 8;
+
+std::vector<float> Row(float base) {
+    std::vector<float> row(kHeadDim);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        row[d] = base * std::sin(static_cast<float>(d + 1));
+    }
+    return row;
+}
+
+void ExpectNear(const std::vector<float>& actual, const std::vector<float>& expected, float tolerance) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_NEAR(actual[i], expected[i], tolerance) << "element " << i;
+    }
+}
+
+TEST(KVQuantization, RejectsUnsupportedStorageDType) {
+    KVCacheManager manager;
+    EXPECT_EQ(manager.Init(1, 1, 16, kHeadDim, DataType::Int(32)).code(), StatusCode::kInvalidArgument);
+    EXPECT_TRUE(IsSupportedKVStorageDType(DataType::Float8E5M2()));
+    EXPECT_TRUE(IsScaledKVStorageDType(DataType::Int(8)));
+    EXPECT_FALSE(IsScaledKVStorageDType(DataType::Float8E4M3FN()));
+}
+
+TEST(KVQuantization, Int8CacheUsesAQuarterOfFloat32Memory) {
+    KVCacheManager f32;
+    KVCacheManager int8;
+    ASSERT_TRUE(f32.Init(2, 4, 256, 64, DataType::Float32()).ok());
+    ASSERT_TRUE(int8.Init(2, 4, 256, 64, DataType::Int(8)).ok());
+
+    EXPECT_EQ(int8.layout().walk_block_tokens, kKVDenseWalkBlockTokens);
+    // Payload plus one float scale per (token, layer, head) and plane.
+    EXPECT_EQ(int8.total_bytes(), f32.total_bytes() / 4 + 2 * 256 * 2 * 4 * sizeof(float));
+}
+
+TEST(KVQuantization, Int8RowsKeepTheirScaleWhenALaterRowGrows) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 2, 16, kHeadDim, DataType::Int(8)).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(4, 0);
+    ASSERT_TRUE(view.ok());
+
+    ASSERT_TRUE(view->WriteToken(0, 1, 0, Row(0.5F), Row(-0.25F)).ok());
+    ASSERT_TRUE(view->WriteToken(0, 1, 1, Row(4.0F), Row(2.0F)).ok());
+    ASSERT_TRUE(view->CommitUntil(2).ok());
+
+    std::vector<float> key(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE(view->ReadToken(0, 1, 0, key, value).ok());
+    // Token 0 keeps its own, smaller scale: the outlier in token 1 costs it
+    // no precision.
+    ExpectNear(key, Row(0.5F), 0.5F / 254.0F);
+    ExpectNear(value, Row(-0.25F), 0.25F / 254.0F);
+    ASSERT_TRUE(view->ReadToken(0, 1, 1, key, value).ok());
+    ExpectNear(key, Row(4.0F), 4.0F / 254.0F);
+
+    const StatusOr<KVCacheBlock> block = view->CommittedBlock(0, 1, 0);
+    ASSERT_TRUE(block.ok());
+    EXPECT_EQ(block->kv_dtype, DataType::Int(8));
+    ASSERT_NE(block->key_scales, nullptr);
+    EXPECT_FLOAT_EQ(block->key_scales[0], ComputeKVInt8Scale(Row(0.5F)));
+    EXPECT_FLOAT_EQ(block->key_scales[1], ComputeKVInt8Scale(Row(4.0F)));
+}
+
+TEST(KVQuantization, Int8RewritesNeverCompoundEarlierRows) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 16, kHeadDim, DataType::Int(8)).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(8, 0);
+    ASSERT_TRUE(view.ok());
+    ASSERT_TRUE(view->WriteToken(0, 0, 0, Row(0.3F), Row(0.3F)).ok());
+    ASSERT_TRUE(view->CommitUntil(1).ok());
+    std::vector<float> before(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE(view->ReadToken(0, 0, 0, before, value).ok());
+
+    // Ever larger rows in the same walk block leave row 0 bit-identical.
+    for (size_t pos = 1; pos < 8; ++pos) {
+        const float magnitude = static_cast<float>(pos) * 1.7F;
+        ASSERT_TRUE(view->WriteToken(0, 0, pos, Row(magnitude), Row(magnitude)).ok());
+    }
+    ASSERT_TRUE(view->CommitUntil(8).ok());
+    std::vector<float> after(kHeadDim);
+    ASSERT_TRUE(view->ReadToken(0, 0, 0, after, value).ok());
+    EXPECT_EQ(after, before);
+}
+
+TEST(KVQuantization, Fp8StorageSaturatesInsteadOfOverflowing) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 8, kHeadDim, DataType::Float8E4M3FN()).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(1, 0);
+    ASSERT_TRUE(view.ok());
+
+    std::vector<float> large = Row(1.0F);
+    large[0] = 1.0e6F;
+    ASSERT_TRUE(view->WriteToken(0, 0, 0, large, Row(1.0F)).ok());
+    ASSERT_TRUE(view->CommitUntil(1).ok());
+
+    std::vector<float> key(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE(view->ReadToken(0, 0, 0, key, value).ok());
+    EXPECT_EQ(key[0], 448.0F);
+    EXPECT_NEAR(key[1], large[1], 0.07F);
+    ExpectNear(value, Row(1.0F), 0.07F);
+}
+
+TEST(KVQuantization, PagedCopyOnWriteCarriesBlockScales) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 1, 16, kHeadDim, DataType::Int(8), 4, 4, 64, 2).ok());
+    const std::vector<int32_t> prompt = {1, 2, 3, 4};
+
+    StatusOr<KVCacheView> first = manager.ReserveWithPrefix(prompt, 1);
+    ASSERT_TRUE(first.ok());
+    for (size_t pos = 0; pos < prompt.size(); ++pos) {
+        ASSERT_TRUE(first->WriteToken(0, 0, pos, Row(1.0F + pos), Row(1.0F)).ok());
+    }
+    ASSERT_TRUE(first->CommitUntil(prompt.size()).ok());
+    ASSERT_TRUE(manager.PublishPrefix(*first, prompt).ok());
+
+    StatusOr<KVCacheView> second = manager.ReserveWithPrefix(prompt, 1);
+    ASSERT_TRUE(second.ok());
+    ASSERT_EQ(second->committed_tokens(), 3U);
+    ASSERT_TRUE(second->WriteToken(0, 0, 3, Row(1.0F), Row(1.0F)).ok());
+
+    std::vector<float> key(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE(second->ReadToken(0, 0, 2, key, value).ok());
+    ExpectNear(key, Row(3.0F), 4.0F / 127.0F);
+}
+
+TEST(KVQuantization, DecodeAttentionDequantizesInsideTheKernel) {
+    constexpr size_t kTokens = 40;
+    const float softmax_scale = 1.0F / std::sqrt(static_cast<float>(kHeadDim));
+    const std::vector<float> query = Row(0.75F);
+
+    std::vector<float> reference;
+    for (const DataType dtype: {DataType::Float32(), DataType::Int(8), DataType::Float8E4M3FN()}) {
+        KVCacheManager manager;
+        ASSERT_TRUE(manager.Init(1, 1, 64, kHeadDim, dtype).ok());
+        StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(kTokens, 0);
+        ASSERT_TRUE(view.ok());
+        for (size_t pos = 0; pos < kTokens; ++pos) {
+            const float base = 0.1F * static_cast<float>(pos % 7) - 0.3F;
+            ASSERT_TRUE(view->WriteToken(0, 0, pos, Row(base), Row(base + 0.5F)).ok());
+        }
+        ASSERT_TRUE(view->CommitUntil(kTokens).ok());
+
+        std::vector<float> output(kHeadDim);
+        ASSERT_TRUE(DecodeAttention(*view, 0, 0, query, softmax_scale, output).ok());
+        if (reference.empty()) {
+            reference = output;
+        } else {
+            ExpectNear(output, reference, 0.03F);
+        }
+    }
+}
+
+TEST(KVQuantization, DecodeAttentionRequiresCommittedTokens) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 8, kHeadDim, DataType::Float32()).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(2, 0);
+    ASSERT_TRUE(view.ok());
+    std::vector<float> output(kHeadDim);
+    EXPECT_EQ(DecodeAttention(*view, 0, 0, Row(1.0F), 1.0F, output).code(),
+              StatusCode::kFailedPrecondition);
+}
+
+}// namespace
@@ -0,0 +1,274 @@
+#include "aethermind/execution/kv_snapshot.h"
+
+#include "aethermind/execution/kv_cache_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr size_t kHeadDim = 8;
+
+class TempDirectory {
+public:
+    TempDirectory() {
+        static size_t counter = 0;
+        const auto unique_id = std::to_string(
+                                       std::chrono::steady_clock::now().time_since_epoch().count()) +
+                               "_" + std::to_string(counter++);
+        path_ = std::filesystem::temp_directory_path() /
+                ("aethermind_kv_snapshot_test_" + unique_id);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    AM_NODISCARD const std::filesystem::path& path() const noexcept {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_{};
+};
+
+std::vector<float> Row(float base) {
+    std::vector<float> row(kHeadDim);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        row[d] = base * std::cos(static_cast<float>(d + 1));
+    }
+    return row;
+}
+
+// Fills positions [begin, end) of every (layer, head) and commits them.
+void Prefill(KVCacheView& view, size_t begin, size_t end) {
+    for (size_t layer = 0; layer < view.num_layers(); ++layer) {
+        for (size_t head = 0; head < view.num_kv_heads(); ++head) {
+            for (size_t pos = begin; pos < end; ++pos) {
+                const float base = static_cast<float>(pos + 1) + 0.5F * static_cast<float>(layer * 2 + head);
+                ASSERT_TRUE(view.WriteToken(layer, head, pos, Row(base), Row(-base)).ok());
+            }
+        }
+    }
+    ASSERT_TRUE(view.CommitUntil(end).ok());
+}
+
+void ExpectSameRows(const KVCacheView& expected, const KVCacheView& actual, float tolerance) {
+    ASSERT_EQ(expected.committed_tokens(), actual.committed_tokens());
+    ASSERT_EQ(expected.window_begin(), actual.window_begin());
+    std::vector<float> key[2] = {std::vector<float>(kHeadDim), std::vector<float>(kHeadDim)};
+    std::vector<float> value[2] = {std::vector<float>(kHeadDim), std::vector<float>(kHeadDim)};
+    for (size_t layer = 0; layer < expected.num_layers(); ++layer) {
+        for (size_t head = 0; head < expected.num_kv_heads(); ++head) {
+            for (size_t pos = expected.window_begin(); pos < expected.committed_tokens(); ++pos) {
+                ASSERT_TRUE(expected.ReadToken(layer, head, pos, key[0], value[0]).ok());
+                ASSERT_TRUE(actual.ReadToken(layer, head, pos, key[1], value[1]).ok());
+                for (size_t d = 0; d < kHeadDim; ++d) {
+                    EXPECT_NEAR(key[1][d], key[0][d], tolerance) << "pos " << pos;
+                    EXPECT_NEAR(value[1][d], value[0][d], tolerance) << "pos " << pos;
+                }
+            }
+        }
+    }
+}
+
+RuntimeSequenceState DecodingState(size_t prompt_len, size_t current_pos) {
+    RuntimeSequenceState state;
+    state.prepared = true;
+    state.prefill_done = true;
+    state.prompt_len = prompt_len;
+    state.generated_len = current_pos - prompt_len;
+    state.current_pos = current_pos;
+    return state;
+}
+
+TEST(KVSnapshot, RestoresCommittedRowsAndSequenceState) {
+    TempDirectory dir;
+    const std::filesystem::path path = dir.path() / "session.kvs";
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(2, 2, 32, kHeadDim, DataType::Float32(), 64, 2).ok());
+    StatusOr<KVCacheView> original = manager.ReserveForChunkedPrefill(6, 8);
+    ASSERT_TRUE(original.ok());
+    Prefill(*original, 0, 9);
+    ASSERT_TRUE(manager.SaveSession(*original, DecodingState(6, 9), path).ok());
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir.path()),
+                            std::filesystem::directory_iterator()),
+              1);
+
+    RuntimeSequenceState state;
+    StatusOr<KVCacheView> restored = manager.RestoreSession(path, 4, &state);
+    ASSERT_TRUE(restored.ok()) << restored.status().ToString();
+    ExpectSameRows(*original, *restored, 0.0F);
+    EXPECT_EQ(restored->token_capacity(), 9U + 4U);
+    EXPECT_FALSE(state.prepared);
+    EXPECT_TRUE(state.prefill_done);
+    EXPECT_EQ(state.prompt_len, 6U);
+    EXPECT_EQ(state.generated_len, 3U);
+    EXPECT_EQ(state.current_pos, 9U);
+
+    // The restored slot keeps the saved prompt, so a reset drops only generated tokens.
+    ASSERT_TRUE(manager.ResetSession(*restored).ok());
+    EXPECT_EQ(restored->committed_tokens(), 6U);
+}
+
+TEST(KVSnapshot, FailedSaveRemovesItsStagingFile) {
+    TempDirectory dir;
+    // A directory in the way makes the final rename fail.
+    const std::filesystem::path path = dir.path() / "session.kvs";
+    std::filesystem::create_directory(path);
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 8, kHeadDim, DataType::Float32(), 16, 1).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(4, 4);
+    ASSERT_TRUE(view.ok());
+    Prefill(*view, 0, 4);
+
+    EXPECT_EQ(manager.SaveSession(*view, DecodingState(4, 4), path).code(), StatusCode::kInternal);
+    for (const auto& entry: std::filesystem::directory_iterator(dir.path())) {
+        EXPECT_EQ(entry.path(), path);
+    }
+}
+
+TEST(KVSnapshot, Int8SnapshotOfFloatCacheIsAQuarterOfTheSize) {
+    TempDirectory dir;
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 2, 64, kHeadDim, DataType::Float32(), 64, 2).ok());
+    StatusOr<KVCacheView> original = manager.ReserveForChunkedPrefill(40, 0);
+    ASSERT_TRUE(original.ok());
+    Prefill(*original, 0, 40);
+
+    const std::filesystem::path full = dir.path() / "full.kvs";
+    const std::filesystem::path packed = dir.path() / "int8.kvs";
+    ASSERT_TRUE(manager.SaveSession(*original, DecodingState(40, 40), full).ok());
+    ASSERT_TRUE(manager.SaveSession(*original, DecodingState(40, 40), packed,
+                                    KVSnapshotOptions{DataType::Int(8)})
+                        .ok());
+    const size_t header = kKVSnapshotHeaderBytes;
+    // One float scale per int8 row.
+    EXPECT_EQ(std::filesystem::file_size(packed) - header,
+              (std::filesystem::file_size(full) - header) / 4 + 2 * 2 * 40 * sizeof(float));
+
+    ASSERT_TRUE(manager.ReleaseSession(*original).ok());
+    StatusOr<KVCacheView> restored = manager.RestoreSession(packed, 1);
+    ASSERT_TRUE(restored.ok()) << restored.status().ToString();
+    std::vector<float> key(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE(restored->ReadToken(0, 1, 39, key, value).ok());
+    const std::vector<float> expected = Row(40.5F);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        EXPECT_NEAR(key[d], expected[d], 40.5F / 127.0F);
+    }
+}
+
+TEST(KVSnapshot, WrappedSlidingWindowRestoresOnlyResidentRows) {
+    TempDirectory dir;
+    const std::filesystem::path path = dir.path() / "window.kvs";
+    KVCacheManager sliding;
+    ASSERT_TRUE(sliding.InitSlidingWindow(1, 1, 8, kHeadDim, DataType::Float(16), 64, 2).ok());
+    StatusOr<KVCacheView> original = sliding.ReserveForChunkedPrefill(4, 16);
+    ASSERT_TRUE(original.ok());
+    Prefill(*original, 0, 8);
+    Prefill(*original, 8, 13);
+    ASSERT_EQ(original->window_begin(), 5U);
+    ASSERT_TRUE(sliding.SaveSession(*original, DecodingState(4, 13), path).ok());
+
+    StatusOr<KVCacheView> restored = sliding.RestoreSession(path, 2);
+    ASSERT_TRUE(restored.ok()) << restored.status().ToString();
+    ExpectSameRows(*original, *restored, 0.0F);
+
+    KVCacheManager dense;
+    ASSERT_TRUE(dense.Init(1, 1, 32, kHeadDim, DataType::Float(16)).ok());
+    EXPECT_EQ(dense.RestoreSession(path, 2).status().code(), StatusCode::kFailedPrecondition);
+    EXPECT_EQ(dense.active_sessions(), 0U);
+}
+
+TEST(KVSnapshot, PagedManagerRestoresIntoFreshBlocks) {
+    TempDirectory dir;
+    const std::filesystem::path path = dir.path() / "paged.kvs";
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.InitPaged(1, 2, 32, kHeadDim, DataType::Int(8), 4, 8, 64, 2).ok());
+    StatusOr<KVCacheView> original = manager.ReserveForChunkedPrefill(10, 2);
+    ASSERT_TRUE(original.ok());
+    Prefill(*original, 0, 10);
+    ASSERT_TRUE(manager.SaveSession(*original, DecodingState(10, 10), path).ok());
+    ASSERT_TRUE(manager.ReleaseSession(*original).ok());
+    EXPECT_EQ(manager.Occupancy().free_blocks, 8U);
+
+    StatusOr<KVCacheView> restored = manager.RestoreSession(path, 2);
+    ASSERT_TRUE(restored.ok()) << restored.status().ToString();
+    EXPECT_EQ(restored->committed_tokens(), 10U);
+    EXPECT_EQ(manager.Occupancy().free_blocks, 8U - 3U);
+    std::vector<float> key(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE(restored->ReadToken(0, 1, 9, key, value).ok());
+    const std::vector<float> expected = Row(-10.5F);
+    for (size_t d = 0; d < kHeadDim; ++d) {
+        EXPECT_NEAR(value[d], expected[d], 2 * 10.5F / 127.0F);
+    }
+}
+
+TEST(KVSnapshot, HeaderIsWrittenFieldByFieldWithZeroedTail) {
+    TempDirectory dir;
+    const std::filesystem::path path = dir.path() / "header.kvs";
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(2, 3, 16, kHeadDim, DataType::Float32()).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(5, 0);
+    ASSERT_TRUE(view.ok());
+    Prefill(*view, 0, 5);
+    ASSERT_TRUE(manager.SaveSession(*view, DecodingState(5, 5), path).ok());
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<unsigned char> bytes(kKVSnapshotHeaderBytes);
+    ASSERT_TRUE(in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())));
+    const auto read_u64 = [&](size_t offset) {
+        uint64_t value = 0;
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    };
+    EXPECT_EQ(read_u64(8), 2U);  // num_layers
+    EXPECT_EQ(read_u64(16), 3U); // num_kv_heads
+    EXPECT_EQ(read_u64(24), kHeadDim);
+    // The dtype packs into four bytes right after head_dim.
+    EXPECT_EQ(bytes[32], static_cast<unsigned char>(DLDataTypeCode::kFloat));
+    EXPECT_EQ(bytes[33], 32U);
+    EXPECT_EQ(read_u64(44), 5U); // committed_tokens
+    EXPECT_EQ(bytes[68], 1U);    // prefill_done
+    for (size_t i = 69; i < kKVSnapshotHeaderBytes; ++i) {
+        EXPECT_EQ(bytes[i], 0U) << "byte " << i;
+    }
+}
+
+TEST(KVSnapshot, RejectsMismatchedOrCorruptFiles) {
+    TempDirectory dir;
+    const std::filesystem::path path = dir.path() / "session.kvs";
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 16, kHeadDim, DataType::Float32()).ok());
+    StatusOr<KVCacheView> view = manager.ReserveForChunkedPrefill(3, 0);
+    ASSERT_TRUE(view.ok());
+    Prefill(*view, 0, 3);
+    EXPECT_EQ(manager.SaveSession(*view, DecodingState(3, 2), path).code(), StatusCode::kInvalidArgument);
+    ASSERT_TRUE(manager.SaveSession(*view, DecodingState(3, 3), path).ok());
+
+    KVCacheManager other;
+    ASSERT_TRUE(other.Init(1, 2, 16, kHeadDim, DataType::Float32()).ok());
+    EXPECT_EQ(other.RestoreSession(path, 1).status().code(), StatusCode::kInvalidArgument);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_EQ(KVSnapshot::Open(path).status().code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(KVSnapshot::Open(dir.path() / "missing.kvs").status().code(), StatusCode::kNotFound);
+}
+
+}// namespace
@@ -0,0 +1,167 @@
+#include "aethermind/execution/layer_weight_streamer.h"
+
+#include "aethermind/execution/execution_plan.h"
+#include "aethermind/execution/layer_runner.h"
+#include "aethermind/execution/runtime_binding_context.h"
+#include "aethermind/operators/function_operator.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr size_t kLayerBytes = 1024;
+
+struct AdviceRecord {
+    size_t offset = 0;
+    size_t bytes = 0;
+    MemoryMappedFile::Advice advice = MemoryMappedFile::Advice::kNormal;
+
+    bool operator==(const AdviceRecord&) const = default;
+};
+
+class RecordingStorage final : public RawStorage {
+public:
+    explicit RecordingStorage(size_t nbytes) : data_(nbytes) {}
+
+    Status Advise(const std::byte* data, size_t bytes, MemoryMappedFile::Advice advice) const override {
+        std::lock_guard lock(mutex_);
+        records_.push_back({static_cast<size_t>(data - data_.data()), bytes, advice});
+        return Status::Ok();
+    }
+
+    const std::byte* at(size_t offset) const noexcept {
+        return data_.data() + offset;
+    }
+
+    std::vector<AdviceRecord> TakeRecords() const {
+        std::lock_guard lock(mutex_);
+        return std::exchange(records_, {});
+    }
+
+private:
+    std::vector<std::byte> data_;
+    mutable std::mutex mutex_;
+    mutable std::vector<AdviceRecord> records_;
+};
+
+RawWeightView MakeView(const std::shared_ptr<RecordingStorage>& storage, size_t offset, size_t bytes) {
+    return RawWeightView{.data = storage->at(offset),
+                         .bytes = bytes,
+                         .dtype = DataType::Float32(),
+                         .shape = {static_cast<int64_t>(bytes / 4)},
+                         .storage = storage};
+}
+
+// Layer l occupies [l * kLayerBytes, (l + 1) * kLayerBytes), split across
+// tensors listed out of file order.
+ResolvedModelWeights MakeWeights(const std::shared_ptr<RecordingStorage>& storage, size_t num_layers) {
+    ResolvedModelWeights weights;
+    for (size_t layer = 0; layer < num_layers; ++layer) {
+        const size_t base = layer * kLayerBytes;
+        DecoderLayerRawWeights raw;
+        raw.mlp.down_proj = MakeView(storage, base + 512, 512);
+        raw.attn.q_proj = MakeView(storage, base, 256);
+        raw.attn.k_proj = MakeView(storage, base + 256, 256);
+        weights.layers.push_back(std::move(raw));
+    }
+    return weights;
+}
+
+AdviceRecord LayerRecord(size_t layer, MemoryMappedFile::Advice advice) {
+    return {layer * kLayerBytes, kLayerBytes, advice};
+}
+
+constexpr auto kWillNeed = MemoryMappedFile::Advice::kWillNeed;
+constexpr auto kPageOut = MemoryMappedFile::Advice::kPageOut;
+
+TEST(LayerWeightStreamer, PrefetchesTheNextLayerAndEvictsFinishedOnes) {
+    const auto storage = std::make_shared<RecordingStorage>(4 * kLayerBytes);
+    auto streamer = LayerWeightStreamer::Create(MakeWeights(storage, 4));
+    ASSERT_TRUE(streamer.ok()) << streamer.status().ToString();
+
+    (*streamer)->OnLayerBegin(0);
+    (*streamer)->WaitIdle();
+    EXPECT_EQ(storage->TakeRecords(), (std::vector<AdviceRecord>{LayerRecord(1, kWillNeed)}));
+
+    (*streamer)->OnLayerBegin(1);
+    (*streamer)->WaitIdle();
+    EXPECT_EQ(storage->TakeRecords(),
+              (std::vector<AdviceRecord>{LayerRecord(0, kPageOut), LayerRecord(2, kWillNeed)}));
+
+    // The last layer fetches the first one for the next token.
+    (*streamer)->OnLayerBegin(2);
+    (*streamer)->WaitIdle();
+    storage->TakeRecords();
+    (*streamer)->OnLayerBegin(3);
+    (*streamer)->WaitIdle();
+    EXPECT_EQ(storage->TakeRecords(),
+              (std::vector<AdviceRecord>{LayerRecord(2, kPageOut), LayerRecord(0, kWillNeed)}));
+    EXPECT_TRUE((*streamer)->status().ok());
+}
+
+TEST(LayerWeightStreamer, KeepsLayersResidentWhenEvictionIsDisabled) {
+    const auto storage = std::make_shared<RecordingStorage>(3 * kLayerBytes);
+    auto streamer = LayerWeightStreamer::Create(
+            MakeWeights(storage, 3),
+            LayerWeightStreamerOptions{.lookahead_layers = 5, .evict_finished_layers = false});
+    ASSERT_TRUE(streamer.ok()) << streamer.status().ToString();
+
+    for (uint32_t round = 0; round < 2; ++round) {
+        for (uint32_t layer = 0; layer < 3; ++layer) {
+            (*streamer)->OnLayerBegin(layer);
+            (*streamer)->WaitIdle();
+        }
+    }
+    // The lookahead is clamped to the other two layers, each advised once.
+    EXPECT_EQ(storage->TakeRecords(),
+              (std::vector<AdviceRecord>{LayerRecord(1, kWillNeed), LayerRecord(2, kWillNeed)}));
+}
+
+TEST(LayerWeightStreamer, RejectsModelsWithoutLayersAndEmptyLookahead) {
+    EXPECT_EQ(LayerWeightStreamer::Create(ResolvedModelWeights{}).status().code(),
+              StatusCode::kInvalidArgument);
+    const auto storage = std::make_shared<RecordingStorage>(kLayerBytes);
+    EXPECT_EQ(LayerWeightStreamer::Create(MakeWeights(storage, 1),
+                                          LayerWeightStreamerOptions{.lookahead_layers = 0})
+                      .status()
+                      .code(),
+              StatusCode::kInvalidArgument);
+}
+
+struct RecordingObserver final : LayerExecutionObserver {
+    void OnLayerBegin(uint32_t layer_index) noexcept override {
+        layers.push_back(layer_index);
+    }
+    std::vector<uint32_t> layers;
+};
+
+Status NoopKernel(const KernelContext&) noexcept {
+    return Status::Ok();
+}
+
+TEST(LayerWeightStreamer, LayerRunnerReportsEachLayerTransitionOnce) {
+    const std::optional<uint32_t> step_layers[] = {std::nullopt, 0, 0, 1, 1, 1, std::nullopt};
+    std::vector<ExecutionStep> steps;
+    for (const auto& layer: step_layers) {
+        steps.push_back({.op = std::make_shared<FunctionOperator>(OpType::kAdd, &NoopKernel),
+                         .decoder_layer_index = layer});
+    }
+    auto plan = ExecutionPlan::Create(std::move(steps));
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+
+    RecordingObserver observer;
+    RuntimeBindingContext bindings;
+    bindings.SetLayerObserver(&observer);
+    ASSERT_TRUE(LayerRunner::Run(*plan, bindings).ok());
+    ASSERT_TRUE(LayerRunner::Run(*plan, bindings).ok());
+    EXPECT_EQ(observer.layers, (std::vector<uint32_t>{0, 1, 0, 1}));
+}
+
+}// namespace
@@ -152,4 +152,26 @@ TEST(RuntimeBackendIntegration, KVCacheManagerCanBeBuiltFromRuntimeOptions) {
     EXPECT_EQ(view->token_capacity(), 16U);
 }
 
+TEST(RuntimeBackendIntegration, KVCacheManagerHonorsSlotCountOption) {
+    RuntimeOptions options;
+    options.kv_cache.enable_manager = true;
+    options.kv_cache.num_layers = 1;
+    options.kv_cache.num_kv_heads = 1;
+    options.kv_cache.max_tokens = 16;
+    options.kv_cache.head_dim = 8;
+    options.kv_cache.kv_dtype = DataType(DLDataTypeCode::kFloat, 16, 1);
+    options.kv_cache.num_slots = 4;
+
+    RuntimeBuilder builder;
+    builder.WithOptions(options);
+    RuntimeContext context = builder.Build();
+
+    KVCacheManager* manager = context.GetKVCacheManager();
+    ASSERT_NE(manager, nullptr);
+    EXPECT_EQ(manager->num_slots(), 4U);
+    EXPECT_TRUE(manager->ReserveForSession(4, 4).ok());
+    EXPECT_TRUE(manager->ReserveForSession(4, 4).ok());
+    EXPECT_EQ(manager->active_sessions(), 2U);
+}
+
 }// namespace
@@ -0,0 +1,244 @@
+#include "aethermind/execution/session_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+constexpr size_t kHeadDim = 4;
+
+std::vector<float> Row(float base) {
+    return std::vector<float>(kHeadDim, base);
+}
+
+// Commits positions up to `end` of a running session, as prefill and decode
+// steps of the engine would.
+void Advance(SessionScheduler& scheduler, uint64_t session_id, size_t end) {
+    StatusOr<KVCacheView*> view = scheduler.view(session_id);
+    ASSERT_TRUE(view.ok()) << view.status().ToString();
+    for (size_t pos = (*view)->committed_tokens(); pos < end; ++pos) {
+        ASSERT_TRUE((*view)->WriteToken(0, 0, pos, Row(static_cast<float>(pos)), Row(-1.0F)).ok());
+    }
+    ASSERT_TRUE((*view)->CommitUntil(end).ok());
+}
+
+SessionPhase PhaseOf(const SessionScheduler& scheduler, uint64_t session_id) {
+    StatusOr<SessionPhase> phase = scheduler.phase(session_id);
+    EXPECT_TRUE(phase.ok()) << phase.status().ToString();
+    return phase.ok() ? *phase : SessionPhase::kWaiting;
+}
+
+SchedulePlan Schedule(SessionScheduler& scheduler) {
+    StatusOr<SchedulePlan> plan = scheduler.Schedule();
+    EXPECT_TRUE(plan.ok()) << plan.status().ToString();
+    return plan.ok() ? *plan : SchedulePlan{};
+}
+
+class SessionSchedulerTest : public ::testing::Test {
+protected:
+    // 8 blocks of 4 tokens: a 8-token prompt with 4 new tokens projects 3 blocks.
+    void SetUp() override {
+        ASSERT_TRUE(manager_.InitPaged(1, 1, 64, kHeadDim, DataType::Float32(), 4, 8, 64, 4).ok());
+    }
+
+    KVCacheManager manager_;
+};
+
+TEST_F(SessionSchedulerTest, AdmitsByProjectedBlocksAndQueuesTheRest) {
+    SessionScheduler scheduler(manager_, SessionSchedulerOptions{.max_prefills_per_step = 4});
+    for (uint64_t id = 1; id <= 3; ++id) {
+        ASSERT_TRUE(scheduler.Submit({.session_id = id, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    }
+
+    SchedulePlan plan = Schedule(scheduler);
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{1, 2}));
+    EXPECT_TRUE(plan.decode.empty());
+    EXPECT_EQ(scheduler.reserved_blocks(), 6U);
+    EXPECT_EQ(PhaseOf(scheduler, 3), SessionPhase::kWaiting);
+    // The pool still has free blocks, but not for session 3's whole lifetime.
+    EXPECT_EQ(manager_.Occupancy().free_blocks, 8U);
+
+    ASSERT_TRUE(scheduler.Finish(1).ok());
+    plan = Schedule(scheduler);
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{2, 3}));
+    EXPECT_EQ(scheduler.reserved_blocks(), 6U);
+    EXPECT_EQ(scheduler.Finish(1).code(), StatusCode::kNotFound);
+}
+
+TEST_F(SessionSchedulerTest, DecodeStepsComeBeforeNewPrefills) {
+    SessionScheduler scheduler(manager_, SessionSchedulerOptions{.max_prefills_per_step = 1});
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 2, .max_new_tokens = 2}).ok());
+    ASSERT_EQ(Schedule(scheduler).prefill, (std::vector<uint64_t>{1}));
+    Advance(scheduler, 1, 2);
+
+    ASSERT_TRUE(scheduler.Submit({.session_id = 2, .prompt_len = 2, .max_new_tokens = 2}).ok());
+    ASSERT_TRUE(scheduler.Submit({.session_id = 3, .prompt_len = 2, .max_new_tokens = 2}).ok());
+    SchedulePlan plan = Schedule(scheduler);
+    EXPECT_EQ(plan.decode, (std::vector<uint64_t>{1}));
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{2}));
+    EXPECT_EQ(PhaseOf(scheduler, 3), SessionPhase::kWaiting);
+
+    Advance(scheduler, 1, 3);
+    Advance(scheduler, 2, 2);
+    plan = Schedule(scheduler);
+    EXPECT_EQ(plan.decode, (std::vector<uint64_t>{1, 2}));
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{3}));
+
+    // A session that generated all its tokens is no longer decoded.
+    Advance(scheduler, 1, 4);
+    plan = Schedule(scheduler);
+    EXPECT_EQ(plan.decode, (std::vector<uint64_t>{2}));
+}
+
+TEST_F(SessionSchedulerTest, HigherPriorityRequestSwapsOutTheNewestLowPrioritySession) {
+    const std::filesystem::path spill = std::filesystem::temp_directory_path() /
+                                        ("aethermind_scheduler_spill_" +
+                                         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    ASSERT_TRUE(manager_.EnableDiskOffload(spill).ok());
+    SessionScheduler scheduler(manager_, SessionSchedulerOptions{.max_prefills_per_step = 4});
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    ASSERT_TRUE(scheduler.Submit({.session_id = 2, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    Schedule(scheduler);
+    Advance(scheduler, 1, 8);
+    Advance(scheduler, 2, 8);
+
+    ASSERT_TRUE(scheduler.Submit({.session_id = 3, .prompt_len = 12, .max_new_tokens = 4, .priority = 1}).ok());
+    SchedulePlan plan = Schedule(scheduler);
+    EXPECT_EQ(plan.preempted, (std::vector<uint64_t>{2}));
+    EXPECT_EQ(plan.decode, (std::vector<uint64_t>{1}));
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{3}));
+    EXPECT_EQ(PhaseOf(scheduler, 2), SessionPhase::kSwapped);
+    EXPECT_EQ(scheduler.view(2).status().code(), StatusCode::kFailedPrecondition);
+    EXPECT_EQ(manager_.Occupancy().offloaded_blocks, 2U);
+
+    // Once the high-priority session leaves, the swapped one resumes with its
+    // KV history intact instead of prefilling again.
+    ASSERT_TRUE(scheduler.Finish(3).ok());
+    for (int i = 0; i < 1000 && PhaseOf(scheduler, 2) != SessionPhase::kRunning; ++i) {
+        plan = Schedule(scheduler);
+    }
+    ASSERT_EQ(PhaseOf(scheduler, 2), SessionPhase::kRunning);
+    EXPECT_EQ(manager_.Occupancy().offloaded_blocks, 0U);
+    StatusOr<KVCacheView*> view = scheduler.view(2);
+    ASSERT_TRUE(view.ok());
+    EXPECT_EQ((*view)->committed_tokens(), 8U);
+    std::vector<float> key(kHeadDim);
+    std::vector<float> value(kHeadDim);
+    ASSERT_TRUE((*view)->ReadToken(0, 0, 7, key, value).ok());
+    EXPECT_EQ(key[0], 7.0F);
+}
+
+TEST_F(SessionSchedulerTest, SwappingASessionKeepsItsPrefixSharedBlocksReserved) {
+    const std::filesystem::path spill = std::filesystem::temp_directory_path() /
+                                        ("aethermind_scheduler_pinned_" +
+                                         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    ASSERT_TRUE(manager_.EnableDiskOffload(spill).ok());
+    SessionScheduler scheduler(manager_, SessionSchedulerOptions{.max_prefills_per_step = 4});
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    ASSERT_TRUE(scheduler.Submit({.session_id = 2, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    Schedule(scheduler);
+    Advance(scheduler, 1, 8);
+    Advance(scheduler, 2, 8);
+    // The prefix cache now shares both of session 2's prompt blocks, so a
+    // swap cannot move them out of RAM.
+    const std::vector<int32_t> prompt = {1, 2, 3, 4, 5, 6, 7, 8};
+    ASSERT_TRUE(manager_.PublishPrefix(**scheduler.view(2), prompt).ok());
+
+    ASSERT_TRUE(scheduler.Submit({.session_id = 3, .prompt_len = 12, .max_new_tokens = 4, .priority = 1}).ok());
+    const SchedulePlan plan = Schedule(scheduler);
+    // Swapping session 2 frees one of its three projected blocks; session 3
+    // still does not fit until session 1 goes too.
+    EXPECT_EQ(plan.preempted, (std::vector<uint64_t>{2, 1}));
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{3}));
+    EXPECT_EQ(manager_.Occupancy().offloaded_blocks, 2U);
+    EXPECT_EQ(scheduler.reserved_blocks(), 2U + 4U);
+
+    ASSERT_TRUE(scheduler.Finish(2).ok());
+    EXPECT_EQ(scheduler.reserved_blocks(), 4U);
+}
+
+TEST_F(SessionSchedulerTest, DoesNotSwapVictimsWhosePrefixSharedBlocksCannotMakeRoom) {
+    const std::filesystem::path spill = std::filesystem::temp_directory_path() /
+                                        ("aethermind_scheduler_futile_" +
+                                         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    ASSERT_TRUE(manager_.EnableDiskOffload(spill).ok());
+    SessionScheduler scheduler(manager_, SessionSchedulerOptions{.max_prefills_per_step = 4});
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    ASSERT_TRUE(scheduler.Submit({.session_id = 2, .prompt_len = 8, .max_new_tokens = 4}).ok());
+    Schedule(scheduler);
+    Advance(scheduler, 1, 8);
+    Advance(scheduler, 2, 8);
+    ASSERT_TRUE(manager_.PublishPrefix(**scheduler.view(1), std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7, 8}).ok());
+    ASSERT_TRUE(manager_.PublishPrefix(**scheduler.view(2), std::vector<int32_t>{9, 10, 11, 12, 13, 14, 15, 16}).ok());
+
+    // Swapping both sessions frees only one block each, two short of the six
+    // session 3 projects, so nobody is swapped out for nothing.
+    ASSERT_TRUE(scheduler.Submit({.session_id = 3, .prompt_len = 20, .max_new_tokens = 4, .priority = 1}).ok());
+    const SchedulePlan plan = Schedule(scheduler);
+    EXPECT_TRUE(plan.preempted.empty());
+    EXPECT_EQ(PhaseOf(scheduler, 1), SessionPhase::kRunning);
+    EXPECT_EQ(PhaseOf(scheduler, 2), SessionPhase::kRunning);
+    EXPECT_EQ(PhaseOf(scheduler, 3), SessionPhase::kWaiting);
+    EXPECT_EQ(manager_.Occupancy().offloaded_blocks, 0U);
+}
+
+TEST_F(SessionSchedulerTest, EqualPriorityRequestsWaitInsteadOfPreempting) {
+    SessionScheduler scheduler(manager_, SessionSchedulerOptions{.max_prefills_per_step = 4});
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 16, .max_new_tokens = 8, .priority = 2}).ok());
+    Schedule(scheduler);
+    ASSERT_TRUE(scheduler.Submit({.session_id = 2, .prompt_len = 8, .max_new_tokens = 4, .priority = 2}).ok());
+    ASSERT_TRUE(scheduler.Submit({.session_id = 3, .prompt_len = 2, .max_new_tokens = 1, .priority = 1}).ok());
+
+    // Session 3 would fit, but may not overtake the blocked session 2.
+    const SchedulePlan plan = Schedule(scheduler);
+    EXPECT_TRUE(plan.preempted.empty());
+    EXPECT_EQ(PhaseOf(scheduler, 2), SessionPhase::kWaiting);
+    EXPECT_EQ(PhaseOf(scheduler, 3), SessionPhase::kWaiting);
+}
+
+TEST(SessionScheduler, RecomputePreemptionFoldsGeneratedTokensIntoThePrompt) {
+    KVCacheManager manager;
+    ASSERT_TRUE(manager.Init(1, 1, 16, kHeadDim, DataType::Float32(), 64, 2).ok());
+    SessionScheduler scheduler(manager, SessionSchedulerOptions{.max_prefills_per_step = 2});
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 4, .max_new_tokens = 8}).ok());
+    ASSERT_TRUE(scheduler.Submit({.session_id = 2, .prompt_len = 4, .max_new_tokens = 8}).ok());
+    Schedule(scheduler);
+    Advance(scheduler, 1, 6);
+    Advance(scheduler, 2, 7);
+
+    // Dense slots have no disk tier, so kSwap falls back to recompute.
+    ASSERT_TRUE(scheduler.Submit({.session_id = 3, .prompt_len = 4, .max_new_tokens = 4, .priority = 5}).ok());
+    SchedulePlan plan = Schedule(scheduler);
+    EXPECT_EQ(plan.preempted, (std::vector<uint64_t>{2}));
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{3}));
+    EXPECT_EQ(PhaseOf(scheduler, 2), SessionPhase::kWaiting);
+    StatusOr<ScheduleRequest> requeued = scheduler.request(2);
+    ASSERT_TRUE(requeued.ok());
+    EXPECT_EQ(requeued->prompt_len, 7U);
+    EXPECT_EQ(requeued->max_new_tokens, 5U);
+
+    ASSERT_TRUE(scheduler.Finish(3).ok());
+    plan = Schedule(scheduler);
+    EXPECT_EQ(plan.prefill, (std::vector<uint64_t>{2}));
+    EXPECT_EQ(plan.decode, (std::vector<uint64_t>{1}));
+}
+
+TEST_F(SessionSchedulerTest, SubmitRejectsDuplicateAndOversizedRequests) {
+    SessionScheduler scheduler(manager_);
+    ASSERT_TRUE(scheduler.Submit({.session_id = 1, .prompt_len = 4, .max_new_tokens = 4}).ok());
+    EXPECT_EQ(scheduler.Submit({.session_id = 1, .prompt_len = 4, .max_new_tokens = 4}).code(),
+              StatusCode::kAlreadyExists);
+    EXPECT_EQ(scheduler.Submit({.session_id = 2, .prompt_len = 40, .max_new_tokens = 4}).code(),
+              StatusCode::kResourceExhausted);
+    EXPECT_EQ(scheduler.Submit({.session_id = 3, .prompt_len = 60, .max_new_tokens = 8}).code(),
+              StatusCode::kOutOfRange);
+    EXPECT_EQ(scheduler.num_sessions(), 1U);
+}
+
+}// namespace
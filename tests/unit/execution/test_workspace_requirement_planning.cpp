@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <optional>
 #include <vector>
 
 namespace {
@@ -101,4 +102,128 @@ TEST(WorkspaceRequirementPlanning, DetectsOffsetOverflowDuringPlanning) {
     EXPECT_EQ(layout.status().code(), StatusCode::kOverflow);
 }
 
+TEST(WorkspaceRequirementPlanning, SequentialPlanReportsNaiveTotal) {
+    std::vector<WorkspaceRequirement> requirements = {
+            {.bytes = 32, .alignment = 16},
+            {.bytes = 16, .alignment = 16},
+    };
+
+    const StatusOr<WorkspacePlanLayout> layout = PlanWorkspaceRequirements(requirements);
+
+    ASSERT_TRUE(layout.ok());
+    EXPECT_EQ(layout->total_bytes, 48U);
+    EXPECT_EQ(layout->naive_total_bytes, 48U);
+}
+
+TEST(WorkspaceRequirementPlanning, ComputesLiveRangesFromLifetime) {
+    const std::vector<WorkspaceRequirement> requirements = {
+            {.bytes = 8, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 8, .lifetime = WorkspaceLifetime::kPerLayer},
+            {.bytes = 8, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 8, .lifetime = WorkspaceLifetime::kPerToken},
+            {.bytes = 8, .lifetime = WorkspaceLifetime::kPerOperator, .reusable = false},
+    };
+    const std::vector<std::optional<uint32_t>> layers = {0U, 0U, 0U, 1U, 1U};
+
+    const auto ranges = ComputeWorkspaceLiveRanges(requirements, layers);
+
+    ASSERT_TRUE(ranges.ok()) << ranges.status().ToString();
+    ASSERT_EQ(ranges->size(), 5U);
+    EXPECT_EQ((*ranges)[0].first_step, 0U);
+    EXPECT_EQ((*ranges)[0].last_step, 0U);
+    EXPECT_EQ((*ranges)[1].first_step, 1U);
+    EXPECT_EQ((*ranges)[1].last_step, 2U);
+    EXPECT_EQ((*ranges)[3].first_step, 0U);
+    EXPECT_EQ((*ranges)[3].last_step, 4U);
+    EXPECT_EQ((*ranges)[4].first_step, 0U);
+    EXPECT_EQ((*ranges)[4].last_step, 4U);
+
+    const std::vector<std::optional<uint32_t>> short_layers = {0U};
+    EXPECT_EQ(ComputeWorkspaceLiveRanges(requirements, short_layers).status().code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(WorkspaceRequirementPlanning, ReusePlanSharesPerLayerScratchAcrossLayers) {
+    // Four decoder layers, each with two operators sharing one per-layer
+    // buffer. Only one layer's scratch is ever live.
+    std::vector<WorkspaceRequirement> requirements;
+    std::vector<std::optional<uint32_t>> layers;
+    for (uint32_t layer = 0; layer < 4; ++layer) {
+        requirements.push_back({.bytes = 256, .lifetime = WorkspaceLifetime::kPerLayer});
+        requirements.push_back({.bytes = 64, .lifetime = WorkspaceLifetime::kPerOperator});
+        layers.push_back(layer);
+        layers.push_back(layer);
+    }
+
+    const auto layout = PlanWorkspaceRequirementsWithReuse(requirements, layers);
+
+    ASSERT_TRUE(layout.ok()) << layout.status().ToString();
+    EXPECT_EQ(layout->naive_total_bytes, 4U * (256U + 64U));
+    EXPECT_EQ(layout->total_bytes, 320U);
+    for (uint32_t layer = 0; layer < 4; ++layer) {
+        EXPECT_EQ(requirements[2 * layer].offset, 0U);
+        EXPECT_EQ(requirements[2 * layer + 1].offset, 256U);
+    }
+}
+
+TEST(WorkspaceRequirementPlanning, ReusePlanKeepsWholePlanSlicesDisjoint) {
+    std::vector<WorkspaceRequirement> requirements = {
+            {.bytes = 64, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 32, .alignment = 32, .lifetime = WorkspaceLifetime::kPersistent},
+            {.bytes = 0, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 128, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 16, .alignment = 16, .lifetime = WorkspaceLifetime::kPerOperator, .reusable = false},
+    };
+
+    const auto layout = PlanWorkspaceRequirementsWithReuse(requirements);
+
+    ASSERT_TRUE(layout.ok()) << layout.status().ToString();
+    // Whole-plan slices are stacked first in step order.
+    EXPECT_EQ(requirements[1].offset, 0U);
+    EXPECT_EQ(requirements[4].offset, 32U);
+    // Short-lived slices share the space above them.
+    EXPECT_EQ(requirements[0].offset, 64U);
+    EXPECT_EQ(requirements[3].offset, 64U);
+    EXPECT_EQ(requirements[2].offset, 0U);
+    EXPECT_EQ(layout->total_bytes, 192U);
+    EXPECT_EQ(layout->required_alignment, 64U);
+}
+
+TEST(WorkspaceRequirementPlanning, ReusePlanFillsGapBelowOverlappingSlice) {
+    // The layer buffer overlaps the large operator scratch of step 1 and is
+    // pushed above it. Step 2 only overlaps the layer buffer, so it reuses
+    // the hole step 1 leaves behind instead of growing the arena.
+    std::vector<WorkspaceRequirement> requirements = {
+            {.bytes = 128, .lifetime = WorkspaceLifetime::kPerLayer},
+            {.bytes = 256, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 64, .lifetime = WorkspaceLifetime::kPerOperator},
+            {.bytes = 8, .lifetime = WorkspaceLifetime::kPerOperator},
+    };
+    const std::vector<std::optional<uint32_t>> layers = {0U, 0U, 0U, 1U};
+
+    const auto layout = PlanWorkspaceRequirementsWithReuse(requirements, layers);
+
+    ASSERT_TRUE(layout.ok()) << layout.status().ToString();
+    EXPECT_EQ(requirements[1].offset, 0U);
+    EXPECT_EQ(requirements[0].offset, 256U);
+    EXPECT_EQ(requirements[2].offset, 0U);
+    EXPECT_EQ(requirements[3].offset, 0U);
+    EXPECT_EQ(layout->total_bytes, 384U);
+    EXPECT_EQ(layout->naive_total_bytes, 456U);
+}
+
+TEST(WorkspaceRequirementPlanning, ReusePlanLeavesOffsetsUntouchedOnError) {
+    std::vector<WorkspaceRequirement> requirements = {
+            {.bytes = 8, .alignment = 8, .lifetime = WorkspaceLifetime::kPerOperator, .offset = 7},
+            {.bytes = 8, .alignment = 3, .lifetime = WorkspaceLifetime::kPerOperator, .offset = 9},
+    };
+
+    const auto layout = PlanWorkspaceRequirementsWithReuse(requirements);
+
+    ASSERT_FALSE(layout.ok());
+    EXPECT_EQ(layout.status().code(), StatusCode::kInvalidArgument);
+    EXPECT_EQ(requirements[0].offset, 7U);
+    EXPECT_EQ(requirements[1].offset, 9U);
+}
+
 }// namespace
@@ -0,0 +1,187 @@
+#include "../test_graph_helpers.h"
+#include "aethermind/graph/compilation/activation_planner.h"
+
+#include "aethermind/graph/compilation/graph_lowering.h"
+#include "aethermind/shape_inference/shape_symbol.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+GraphValueId Value(uint32_t index) {
+    return GraphValueId{.index = index};
+}
+
+void AddStep(LoweredGraph& lowered,
+             OpType op_type,
+             std::vector<GraphValueId> inputs,
+             std::vector<TensorSpec> input_specs,
+             GraphValueId output,
+             TensorSpec output_spec) {
+    lowered.steps.push_back(ExecutionPlanNodeSpec{
+            .op_type = op_type,
+            .input_specs = std::move(input_specs),
+            .output_specs = {std::move(output_spec)},
+    });
+    lowered.step_bindings.push_back(LoweredStepBinding{
+            .input_values = std::move(inputs),
+            .output_values = {output},
+    });
+}
+
+// Llama-style MLP block over [4, 8] float32 activations (128 bytes each):
+//   s0: h = RmsNorm(x, w_norm)          -> v2
+//   s1: g = Linear(h, w_gate)           -> v4
+//   s2: u = Linear(h, w_up)             -> v6
+//   s3: m = SiluMul(g, u)               -> v7
+//   s4: y = Add(h, m)   (model output)  -> v8
+LoweredGraph MakeMlpBlock(const TensorSpec& act) {
+    const TensorSpec weight = Spec(DataType::Float32(), {8});
+    const TensorSpec matrix = Spec(DataType::Float32(), {8, 8});
+
+    LoweredGraph lowered;
+    AddStep(lowered, OpType::kRmsNorm, {Value(0), Value(1)}, {act, weight}, Value(2), act);
+    AddStep(lowered, OpType::kLinear, {Value(2), Value(3)}, {act, matrix}, Value(4), act);
+    AddStep(lowered, OpType::kLinear, {Value(2), Value(5)}, {act, matrix}, Value(6), act);
+    AddStep(lowered, OpType::kSiluMul, {Value(4), Value(6)}, {act, act}, Value(7), act);
+    AddStep(lowered, OpType::kAdd, {Value(2), Value(7)}, {act, act}, Value(8), act);
+    lowered.model_inputs = {Value(0)};
+    lowered.model_outputs = {Value(8)};
+    return lowered;
+}
+
+TEST(ActivationPlanner, AliasesDeadElementwiseInputs) {
+    LoweredGraph lowered = MakeMlpBlock(Spec(DataType::Float32(), {4, 8}));
+
+    ASSERT_TRUE(AddInPlaceActivationAliases(lowered).ok());
+
+    ASSERT_EQ(lowered.state_aliases.size(), 2U);
+    EXPECT_EQ(lowered.state_aliases[0].input, Value(4));
+    EXPECT_EQ(lowered.state_aliases[0].output, Value(7));
+    EXPECT_EQ(lowered.state_aliases[0].kind, StateAliasKind::kActivation);
+    EXPECT_EQ(lowered.state_aliases[1].input, Value(2));
+    EXPECT_EQ(lowered.state_aliases[1].output, Value(8));
+
+    const StatusOr<StateAliasPlan> alias_plan = ResolveStateAliases(lowered);
+    ASSERT_TRUE(alias_plan.ok()) << alias_plan.status().ToString();
+    const auto silu_mul_aliases = alias_plan->ForStep(3);
+    ASSERT_EQ(silu_mul_aliases.size(), 1U);
+    EXPECT_EQ(silu_mul_aliases[0].input_port, 0U);
+    EXPECT_EQ(silu_mul_aliases[0].output_port, 0U);
+    EXPECT_EQ(silu_mul_aliases[0].kind, StateAliasKind::kActivation);
+}
+
+TEST(ActivationPlanner, AddingAliasesTwiceDoesNotDuplicateThem) {
+    LoweredGraph lowered = MakeMlpBlock(Spec(DataType::Float32(), {4, 8}));
+
+    ASSERT_TRUE(AddInPlaceActivationAliases(lowered).ok());
+    ASSERT_TRUE(AddInPlaceActivationAliases(lowered).ok());
+
+    EXPECT_EQ(lowered.state_aliases.size(), 2U);
+}
+
+TEST(ActivationPlanner, DoesNotAliasLiveInputsOrShapeChanges) {
+    const TensorSpec act = Spec(DataType::Float32(), {4, 8});
+    const TensorSpec row = Spec(DataType::Float32(), {8});
+
+    LoweredGraph lowered;
+    AddStep(lowered, OpType::kSilu, {Value(0)}, {act}, Value(1), act);
+    AddStep(lowered, OpType::kSilu, {Value(0)}, {act}, Value(2), act);
+    // v1 is still read by step 3 when step 2 runs.
+    AddStep(lowered, OpType::kAdd, {Value(1), Value(2)}, {act, act}, Value(3), act);
+    AddStep(lowered, OpType::kSilu, {Value(1)}, {act}, Value(4), row);
+    lowered.model_inputs = {Value(0)};
+    lowered.model_outputs = {Value(3), Value(4)};
+
+    ASSERT_TRUE(AddInPlaceActivationAliases(lowered).ok());
+
+    // Steps 0 and 1 read a model input, step 2 may only reuse v2, and step 3
+    // changes the activation shape.
+    ASSERT_EQ(lowered.state_aliases.size(), 1U);
+    EXPECT_EQ(lowered.state_aliases[0].input, Value(2));
+    EXPECT_EQ(lowered.state_aliases[0].output, Value(3));
+}
+
+TEST(ActivationPlanner, PlansArenaWithLivenessReuseAndInPlaceOutputs) {
+    LoweredGraph lowered = MakeMlpBlock(Spec(DataType::Float32(), {4, 8}));
+    ASSERT_TRUE(AddInPlaceActivationAliases(lowered).ok());
+
+    const StatusOr<ActivationPlan> plan = PlanActivationBuffers(lowered);
+
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    ASSERT_EQ(plan->size(), 5U);
+    EXPECT_EQ(plan->naive_total_bytes, 5U * 128U);
+    EXPECT_EQ(plan->total_bytes, 3U * 128U);
+    EXPECT_EQ(plan->required_alignment, 64U);
+
+    const PlannedActivation* h = plan->Find(0, 0);
+    const PlannedActivation* g = plan->Find(1, 0);
+    const PlannedActivation* u = plan->Find(2, 0);
+    const PlannedActivation* m = plan->Find(3, 0);
+    const PlannedActivation* y = plan->Find(4, 0);
+    ASSERT_NE(h, nullptr);
+    ASSERT_NE(g, nullptr);
+    ASSERT_NE(u, nullptr);
+    ASSERT_NE(m, nullptr);
+    ASSERT_NE(y, nullptr);
+    EXPECT_EQ(h->bytes, 128U);
+    EXPECT_EQ(m->offset, g->offset);
+    EXPECT_EQ(y->offset, h->offset);
+    EXPECT_NE(g->offset, h->offset);
+    EXPECT_NE(u->offset, h->offset);
+    EXPECT_NE(u->offset, g->offset);
+    EXPECT_EQ(plan->Find(1, 1), nullptr);
+}
+
+TEST(ActivationPlanner, ReusesSlicesOfDeadActivationsWithoutAliases) {
+    const TensorSpec act = Spec(DataType::Float32(), {4, 8});
+    const TensorSpec weight = Spec(DataType::Float32(), {8});
+
+    // A chain of RmsNorm steps: each activation dies once the next is produced.
+    LoweredGraph lowered;
+    AddStep(lowered, OpType::kRmsNorm, {Value(0), Value(1)}, {act, weight}, Value(2), act);
+    AddStep(lowered, OpType::kRmsNorm, {Value(2), Value(1)}, {act, weight}, Value(3), act);
+    AddStep(lowered, OpType::kRmsNorm, {Value(3), Value(1)}, {act, weight}, Value(4), act);
+    AddStep(lowered, OpType::kRmsNorm, {Value(4), Value(1)}, {act, weight}, Value(5), act);
+    lowered.model_inputs = {Value(0)};
+    lowered.model_outputs = {Value(5)};
+
+    const StatusOr<ActivationPlan> plan = PlanActivationBuffers(lowered);
+
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    EXPECT_EQ(plan->naive_total_bytes, 4U * 128U);
+    EXPECT_EQ(plan->total_bytes, 2U * 128U);
+    EXPECT_EQ(plan->Find(0, 0)->offset, plan->Find(2, 0)->offset);
+}
+
+TEST(ActivationPlanner, SizesSymbolicActivationsFromBounds) {
+    const ShapeSymbol seq_len = ShapeSymbol::Create();
+    const TensorSpec act{
+            .dtype = DataType::Float32(),
+            .shape = SymbolicShape(std::vector<ShapeSymbol>{seq_len, ShapeSymbol::CreateFromValue(8)}),
+    };
+    const LoweredGraph lowered = MakeMlpBlock(act);
+
+    const StatusOr<ActivationPlan> unbounded = PlanActivationBuffers(lowered);
+    EXPECT_EQ(unbounded.status().code(), StatusCode::kInvalidArgument);
+
+    const StatusOr<ActivationPlan> bounded = PlanActivationBuffers(
+            lowered, ActivationPlannerConfig{.symbol_bounds = {{.symbol = seq_len, .max_value = 16}}});
+    ASSERT_TRUE(bounded.ok()) << bounded.status().ToString();
+    EXPECT_EQ(bounded->Find(0, 0)->bytes, 16U * 8U * sizeof(float));
+}
+
+TEST(ActivationPlanner, RejectsInvalidAlignment) {
+    const LoweredGraph lowered = MakeMlpBlock(Spec(DataType::Float32(), {4, 8}));
+
+    const StatusOr<ActivationPlan> plan =
+            PlanActivationBuffers(lowered, ActivationPlannerConfig{.alignment = 24});
+
+    EXPECT_EQ(plan.status().code(), StatusCode::kInvalidArgument);
+}
+
+}// namespace
@@ -312,6 +312,55 @@ TEST(GraphLowering, LowersFullLlamaDenseGraph) {
     for (size_t i = 0; i < lowered->steps.size(); ++i) {
         EXPECT_EQ(lowered->steps[i].output_specs.size(), lowered->step_bindings[i].output_values.size());
     }
+
+    // Every Linear step names the layer and role of its weight, so plan
+    // building can bind that layer's own packed artifact.
+    size_t q_projections = 0;
+    for (const ExecutionPlanNodeSpec& step: lowered->steps) {
+        if (step.op_type != OpType::kLinear) {
+            continue;
+        }
+        ASSERT_TRUE(step.weight_role.has_value());
+        if (*step.weight_role == TransformerWeightRole::kLmHead) {
+            EXPECT_FALSE(step.decoder_layer_index.has_value());
+        } else {
+            ASSERT_TRUE(step.decoder_layer_index.has_value());
+        }
+        if (*step.weight_role == TransformerWeightRole::kAttentionQ) {
+            EXPECT_EQ(step.decoder_layer_index, std::optional<uint32_t>(q_projections));
+            ++q_projections;
+        }
+    }
+    EXPECT_EQ(q_projections, 2U);
+}
+
+TEST(GraphLowering, InPlaceActivationsAddAliasesForElementwiseSteps) {
+    const HfModelConfig config = MakeLlamaConfig(2);
+    const ResolvedModelWeights weights = MakeWeights(config);
+    const StatusOr<ModelGraph> graph = ModelGraphBuilder::BuildLlamaDense(config, weights);
+    ASSERT_TRUE(graph.ok()) << graph.status().ToString();
+
+    const StatusOr<LoweredGraph> lowered =
+            LowerModelGraph(*graph, GraphLoweringConfig{.in_place_activations = true});
+
+    ASSERT_TRUE(lowered.ok()) << lowered.status().ToString();
+    const size_t kv_aliases = static_cast<size_t>(config.num_hidden_layers) * 2U;
+    ASSERT_GT(lowered->state_aliases.size(), kv_aliases);
+
+    const StatusOr<StateAliasPlan> alias_plan = ResolveStateAliases(*lowered);
+    ASSERT_TRUE(alias_plan.ok()) << alias_plan.status().ToString();
+    size_t activation_aliases = 0;
+    for (const ResolvedStateAlias& alias: alias_plan->aliases) {
+        if (alias.kind != StateAliasKind::kActivation) {
+            continue;
+        }
+        ++activation_aliases;
+        const StatusOr<OperatorSchema> schema =
+                GetOperatorSchema(lowered->steps[alias.step_index].op_type);
+        ASSERT_TRUE(schema.ok());
+        EXPECT_TRUE(SupportsInPlaceActivation(*schema));
+    }
+    EXPECT_EQ(activation_aliases, lowered->state_aliases.size() - kv_aliases);
 }
 
 TEST(GraphLowering, ResolveStateAliasesConvertsLoweringTimeRecordsToRuntimePlan) {
@@ -232,6 +232,7 @@ TEST(GraphDump, DumpsEveryOpParamsVariant) {
             ArgmaxParams{.axis = -1},
             ReshapeParams{.target_shape = {ReshapeInputDim{0}, ReshapeInputDim{1}, ReshapeLiteralDim{32}, ReshapeInferDim{}}},
             PermuteParams{.permutation = {2, 0, 1}},
+            SampleParams{.temperature = 0.5F, .top_k = 40, .top_p = 0.9F, .seed = 7},
     };
 
     std::ostringstream os;
@@ -250,6 +251,7 @@ TEST(GraphDump, DumpsEveryOpParamsVariant) {
     EXPECT_NE(dump.find("ArgmaxParams{axis=-1}"), std::string::npos);
     EXPECT_NE(dump.find("ReshapeParams{target_shape=[@0,@1,32,*]}"), std::string::npos);
     EXPECT_NE(dump.find("PermuteParams{permutation=[2,0,1]}"), std::string::npos);
+    EXPECT_NE(dump.find("SampleParams{temperature=0.5, top_k=40, top_p=0.9, seed=7}"), std::string::npos);
 }
 
 }// namespace
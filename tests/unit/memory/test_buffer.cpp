@@ -80,6 +80,17 @@ TEST(Buffer, MoveSemantics) {
     EXPECT_TRUE(b2.data() == original_ptr);
 }
 
+TEST(Buffer, ReadOnlyHandleHidesMutableData) {
+    static const int kValues[4] = {1, 2, 3, 4};
+    Buffer b(sizeof(kValues), MemoryHandle::ReadOnly(kValues, nullptr, nullptr, Device::CPU(), alignof(int)));
+
+    EXPECT_TRUE(b.is_initialized());
+    EXPECT_TRUE(b.read_only());
+    EXPECT_EQ(b.data(), kValues);
+    EXPECT_EQ(b.mutable_data(), nullptr);
+    EXPECT_FALSE(detail::make_test_buffer(16).read_only());
+}
+
 TEST(Buffer, AlignmentTracking) {
     Buffer b = detail::make_test_buffer(512, 128);
     EXPECT_TRUE(b.alignment() == 128);
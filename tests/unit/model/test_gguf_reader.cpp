@@ -0,0 +1,427 @@
+#include "aethermind/model/formats/gguf/gguf_reader.h"
+
+#include "aethermind/backend/cpu/cpu_backend.h"
+#include "aethermind/backend/cpu/cpu_weight_prepacker.h"
+#include "aethermind/backend/kernel_registry.h"
+#include "aethermind/backend/kernel_selector.h"
+#include "aethermind/execution/execution_plan_builder.h"
+#include "aethermind/model/model_instance.h"
+#include "aethermind/model/model_loader.h"
+#include "aethermind/operators/operator_inference.h"
+#include "aethermind/runtime/runtime_builder.h"
+#include "test_utils.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+// Serializes a GGUF v3 file: header, metadata, tensor table, then the
+// tensor data padded to `alignment`.
+class GgufFileBuilder {
+public:
+    void AddUInt32(std::string_view key, uint32_t value) {
+        AddKey(metadata_, key, GgufValueType::kUInt32);
+        AppendLittleEndian(metadata_, value, sizeof(value));
+        ++kv_count_;
+    }
+
+    void AddFloat32(std::string_view key, float value) {
+        AddKey(metadata_, key, GgufValueType::kFloat32);
+        AppendLittleEndian(metadata_, std::bit_cast<uint32_t>(value), sizeof(value));
+        ++kv_count_;
+    }
+
+    void AddString(std::string_view key, std::string_view value) {
+        AddKey(metadata_, key, GgufValueType::kString);
+        AppendString(metadata_, value);
+        ++kv_count_;
+    }
+
+    void AddStringArray(std::string_view key, const std::vector<std::string>& values) {
+        AddKey(metadata_, key, GgufValueType::kArray);
+        AppendLittleEndian(metadata_, static_cast<uint32_t>(GgufValueType::kString), sizeof(uint32_t));
+        AppendLittleEndian(metadata_, values.size(), sizeof(uint64_t));
+        for (const auto& value: values) {
+            AppendString(metadata_, value);
+        }
+        ++kv_count_;
+    }
+
+    // `shape` is row-major; the file stores it innermost first.
+    void AddTensor(std::string_view name,
+                   GgufTensorType type,
+                   const std::vector<uint64_t>& shape,
+                   const std::vector<std::byte>& bytes) {
+        while (data_.size() % kAlignment != 0) {
+            data_.push_back(std::byte{0});
+        }
+        AppendString(tensors_, name);
+        AppendLittleEndian(tensors_, shape.size(), sizeof(uint32_t));
+        for (auto it = shape.rbegin(); it != shape.rend(); ++it) {
+            AppendLittleEndian(tensors_, *it, sizeof(uint64_t));
+        }
+        AppendLittleEndian(tensors_, static_cast<uint32_t>(type), sizeof(uint32_t));
+        AppendLittleEndian(tensors_, data_.size(), sizeof(uint64_t));
+        data_.insert(data_.end(), bytes.begin(), bytes.end());
+        ++tensor_count_;
+    }
+
+    std::vector<std::byte> Build(uint32_t version = 3) const {
+        std::vector<std::byte> file;
+        AppendLittleEndian(file, 0x46554747U, sizeof(uint32_t));
+        AppendLittleEndian(file, version, sizeof(uint32_t));
+        AppendLittleEndian(file, tensor_count_, sizeof(uint64_t));
+        AppendLittleEndian(file, kv_count_, sizeof(uint64_t));
+        file.insert(file.end(), metadata_.begin(), metadata_.end());
+        file.insert(file.end(), tensors_.begin(), tensors_.end());
+        while (file.size() % kAlignment != 0) {
+            file.push_back(std::byte{0});
+        }
+        file.insert(file.end(), data_.begin(), data_.end());
+        return file;
+    }
+
+private:
+    static constexpr size_t kAlignment = 32;
+
+    static void AppendLittleEndian(std::vector<std::byte>& out, uint64_t value, size_t width) {
+        for (size_t i = 0; i < width; ++i) {
+            out.push_back(static_cast<std::byte>((value >> (i * 8U)) & 0xFFU));
+        }
+    }
+
+    static void AppendString(std::vector<std::byte>& out, std::string_view value) {
+        AppendLittleEndian(out, value.size(), sizeof(uint64_t));
+        for (const char c: value) {
+            out.push_back(static_cast<std::byte>(c));
+        }
+    }
+
+    static void AddKey(std::vector<std::byte>& out, std::string_view key, GgufValueType type) {
+        AppendString(out, key);
+        AppendLittleEndian(out, static_cast<uint32_t>(type), sizeof(uint32_t));
+    }
+
+    std::vector<std::byte> metadata_;
+    std::vector<std::byte> tensors_;
+    std::vector<std::byte> data_;
+    uint64_t kv_count_ = 0;
+    uint64_t tensor_count_ = 0;
+};
+
+constexpr uint64_t kHidden = 32;
+constexpr uint64_t kVocab = 3;
+
+// `rows` Q8_0 rows of `kHidden` levels each, where row r holds r + 1.
+std::vector<std::byte> MakeQ8_0Rows(uint64_t rows) {
+    std::vector<std::byte> bytes;
+    for (uint64_t row = 0; row < rows; ++row) {
+        bytes.push_back(std::byte{0x00});
+        bytes.push_back(std::byte{0x3C});// scale 1.0
+        bytes.insert(bytes.end(), kHidden, static_cast<std::byte>(row + 1));
+    }
+    return bytes;
+}
+
+// `rows` Q4_0 rows whose levels are all 1 with scale 0.5.
+std::vector<std::byte> MakeQ4_0Rows(uint64_t rows) {
+    std::vector<std::byte> bytes;
+    for (uint64_t row = 0; row < rows; ++row) {
+        bytes.push_back(std::byte{0x00});
+        bytes.push_back(std::byte{0x38});
+        bytes.insert(bytes.end(), kHidden / 2, std::byte{0x99});
+    }
+    return bytes;
+}
+
+// A one-layer llama with tied embeddings: Q8_0 attention, Q4_0 MLP. The
+// embedding is F32 unless `embed_type` asks for Q8_0 or Q4_0.
+GgufFileBuilder MakeTinyLlama(GgufTensorType embed_type = GgufTensorType::kF32) {
+    GgufFileBuilder builder;
+    builder.AddString("general.architecture", "llama");
+    builder.AddUInt32("general.alignment", 32);
+    builder.AddUInt32("llama.embedding_length", kHidden);
+    builder.AddUInt32("llama.feed_forward_length", kHidden);
+    builder.AddUInt32("llama.block_count", 1);
+    builder.AddUInt32("llama.attention.head_count", 1);
+    builder.AddUInt32("llama.context_length", 16);
+    builder.AddFloat32("llama.attention.layer_norm_rms_epsilon", 1e-5F);
+    builder.AddFloat32("llama.rope.freq_base", 500000.0F);
+    builder.AddStringArray("tokenizer.ggml.tokens", {"<s>", "</s>", "a"});
+
+    if (embed_type == GgufTensorType::kQ8_0) {
+        builder.AddTensor("token_embd.weight", embed_type, {kVocab, kHidden}, MakeQ8_0Rows(kVocab));
+    } else if (embed_type == GgufTensorType::kQ4_0) {
+        builder.AddTensor("token_embd.weight", embed_type, {kVocab, kHidden}, MakeQ4_0Rows(kVocab));
+    } else {
+        builder.AddTensor("token_embd.weight", GgufTensorType::kF32, {kVocab, kHidden},
+                          FloatArrayToBytes(std::vector<float>(kVocab * kHidden, 0.25F)));
+    }
+    builder.AddTensor("output_norm.weight", GgufTensorType::kF32, {kHidden},
+                      FloatArrayToBytes(std::vector<float>(kHidden, 1.0F)));
+    builder.AddTensor("blk.0.attn_norm.weight", GgufTensorType::kF32, {kHidden},
+                      FloatArrayToBytes(std::vector<float>(kHidden, 1.0F)));
+    builder.AddTensor("blk.0.ffn_norm.weight", GgufTensorType::kF32, {kHidden},
+                      FloatArrayToBytes(std::vector<float>(kHidden, 1.0F)));
+    for (const char* name: {"blk.0.attn_q.weight", "blk.0.attn_k.weight", "blk.0.attn_v.weight",
+                            "blk.0.attn_output.weight"}) {
+        builder.AddTensor(name, GgufTensorType::kQ8_0, {kHidden, kHidden}, MakeQ8_0Rows(kHidden));
+    }
+    for (const char* name: {"blk.0.ffn_gate.weight", "blk.0.ffn_up.weight", "blk.0.ffn_down.weight"}) {
+        builder.AddTensor(name, GgufTensorType::kQ4_0, {kHidden, kHidden}, MakeQ4_0Rows(kHidden));
+    }
+    return builder;
+}
+
+std::filesystem::path WriteGguf(const TempDirectory& dir, const GgufFileBuilder& builder) {
+    const auto path = dir.path() / "model.gguf";
+    WriteRawFile(path, builder.Build());
+    return path;
+}
+
+TEST(GgufReader, ParsesConfigFromArchitectureMetadata) {
+    TempDirectory temp_dir;
+    const auto reader = GgufReader::Open(WriteGguf(temp_dir, MakeTinyLlama()));
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    EXPECT_EQ(reader->version(), 3U);
+
+    const auto config = reader->ParseConfig();
+    ASSERT_TRUE(config.ok()) << config.status().ToString();
+    EXPECT_EQ(config->model_type, "llama");
+    EXPECT_EQ(config->architectures, std::vector<std::string>{"LlamaForCausalLM"});
+    EXPECT_EQ(config->hidden_size, 32);
+    EXPECT_EQ(config->intermediate_size, 32);
+    EXPECT_EQ(config->num_hidden_layers, 1);
+    EXPECT_EQ(config->num_attention_heads, 1);
+    EXPECT_EQ(config->num_key_value_heads, 1);
+    EXPECT_EQ(config->max_position_embeddings, 16);
+    EXPECT_EQ(config->vocab_size, 3);
+    EXPECT_FLOAT_EQ(static_cast<float>(config->rms_norm_eps), 1e-5F);
+    EXPECT_DOUBLE_EQ(config->rope.theta, 500000.0);
+    EXPECT_TRUE(config->tie_word_embeddings);
+}
+
+TEST(GgufReader, ExposesTensorsAsZeroCopyViewsUnderHfNames) {
+    TempDirectory temp_dir;
+    const auto reader = GgufReader::Open(WriteGguf(temp_dir, MakeTinyLlama()));
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    const auto weights = reader->LoadRawWeightTable();
+    ASSERT_TRUE(weights.ok()) << weights.status().ToString();
+    EXPECT_EQ(weights->size(), 11U);
+
+    const RawWeightView& embed = weights->at("model.embed_tokens.weight");
+    EXPECT_EQ(embed.dtype, DataType::Float32());
+    EXPECT_EQ(embed.shape, (std::vector<int64_t>{3, 32}));
+    EXPECT_FALSE(embed.IsBlockQuantized());
+    EXPECT_EQ(ReadFloat(embed.data), 0.25F);
+
+    const RawWeightView& q_proj = weights->at("model.layers.0.self_attn.q_proj.weight");
+    EXPECT_EQ(q_proj.encoding, RawWeightEncoding::kGgmlQ8_0);
+    EXPECT_EQ(q_proj.dtype, DataType::Int(8));
+    EXPECT_EQ(q_proj.shape, (std::vector<int64_t>{32, 32}));
+    EXPECT_EQ(q_proj.bytes, 32U * 34U);
+    EXPECT_EQ(q_proj.data[2 + 34], std::byte{2});// second row's first level
+
+    const RawWeightView& down_proj = weights->at("model.layers.0.mlp.down_proj.weight");
+    EXPECT_EQ(down_proj.encoding, RawWeightEncoding::kGgmlQ4_0);
+    EXPECT_EQ(down_proj.bytes, 32U * 18U);
+    EXPECT_TRUE(weights->contains("model.layers.0.post_attention_layernorm.weight"));
+    EXPECT_TRUE(weights->contains("model.norm.weight"));
+
+    // Every view aliases the one mapping the reader holds.
+    EXPECT_EQ(embed.storage, q_proj.storage);
+    EXPECT_EQ(embed.storage, down_proj.storage);
+    EXPECT_TRUE(q_proj.IsAligned(32));
+}
+
+TEST(GgufReader, DecodesQuantizedTokenEmbeddingsAtLoad) {
+    TempDirectory temp_dir;
+    const auto reader = GgufReader::Open(WriteGguf(temp_dir, MakeTinyLlama(GgufTensorType::kQ8_0)));
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    const auto weights = reader->LoadRawWeightTable();
+    ASSERT_TRUE(weights.ok()) << weights.status().ToString();
+
+    const RawWeightView& embed = weights->at("model.embed_tokens.weight");
+    EXPECT_FALSE(embed.IsBlockQuantized());
+    EXPECT_EQ(embed.dtype, DataType::Float32());
+    EXPECT_EQ(embed.shape, (std::vector<int64_t>{3, 32}));
+    EXPECT_EQ(embed.bytes, 3U * 32U * sizeof(float));
+    EXPECT_NE(embed.storage, weights->at("model.norm.weight").storage);
+    // Row r of MakeQ8_0Rows holds level r + 1 at scale 1.
+    EXPECT_EQ(ReadFloat(embed.data), 1.0F);
+    EXPECT_EQ(ReadFloat(embed.data + (2 * 32 + 31) * sizeof(float)), 3.0F);
+
+    // Q4_0: nibble 9 at scale 0.5. The tied lm_head reads the same rows.
+    const auto path = WriteGguf(temp_dir, MakeTinyLlama(GgufTensorType::kQ4_0));
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto model = ModelLoader::Load(ModelLoadOptions{.model_dir = path, .num_threads = 1}, backend, registry);
+    ASSERT_TRUE(model.ok()) << model.status().ToString();
+    const RawWeightView& loaded = (*model)->GetResolvedWeights().embed_tokens;
+    EXPECT_EQ(loaded.dtype, DataType::Float32());
+    EXPECT_EQ(ReadFloat(loaded.data + 40 * sizeof(float)), 0.5F);
+    EXPECT_TRUE((*model)->GetConfig().tie_word_embeddings);
+    EXPECT_FALSE((*model)->GetResolvedWeights().lm_head.has_value());
+}
+
+TEST(GgufReader, RestoresHuggingFaceRowOrderOfLlamaQueryAndKey) {
+    TempDirectory temp_dir;
+    const auto path = WriteGguf(temp_dir, MakeTinyLlama());
+    const auto reader = GgufReader::Open(path);
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    const auto weights = reader->LoadRawWeightTable();
+    ASSERT_TRUE(weights.ok()) << weights.status().ToString();
+    EXPECT_EQ(weights->at("model.layers.0.self_attn.q_proj.weight").interleaved_rope_heads, 1U);
+    EXPECT_EQ(weights->at("model.layers.0.self_attn.k_proj.weight").interleaved_rope_heads, 1U);
+    EXPECT_EQ(weights->at("model.layers.0.self_attn.v_proj.weight").interleaved_rope_heads, 0U);
+
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto model = ModelLoader::Load(ModelLoadOptions{.model_dir = path, .num_threads = 1}, backend, registry);
+    ASSERT_TRUE(model.ok()) << model.status().ToString();
+    // Level of the first element of packed row `row`; file row r holds r + 1.
+    const auto first_level = [&](WeightRole role, size_t row) {
+        const PackedWeights* packed = (*model)->FindPackedWeights(0U, role);
+        EXPECT_NE(packed, nullptr);
+        return packed == nullptr ? 0 : static_cast<const int8_t*>(packed->storage().data())[row * 32];
+    };
+    // One 32-row head: Hugging Face row s * 16 + i is file row 2 * i + s.
+    for (const WeightRole role: {WeightRole::kQProj, WeightRole::kKProj}) {
+        EXPECT_EQ(first_level(role, 0), 1);
+        EXPECT_EQ(first_level(role, 1), 3);
+        EXPECT_EQ(first_level(role, 15), 31);
+        EXPECT_EQ(first_level(role, 16), 2);
+        EXPECT_EQ(first_level(role, 31), 32);
+    }
+    EXPECT_EQ(first_level(WeightRole::kVProj, 1), 2);
+}
+
+TEST(GgufReader, RejectsMalformedFiles) {
+    TempDirectory temp_dir;
+    std::vector<std::byte> bytes = MakeTinyLlama().Build();
+
+    auto bad_magic = bytes;
+    bad_magic[0] = std::byte{'X'};
+    WriteRawFile(temp_dir.path() / "magic.gguf", bad_magic);
+    EXPECT_EQ(GgufReader::Open(temp_dir.path() / "magic.gguf").status().code(), StatusCode::kInvalidArgument);
+
+    WriteRawFile(temp_dir.path() / "version.gguf", MakeTinyLlama().Build(1));
+    EXPECT_EQ(GgufReader::Open(temp_dir.path() / "version.gguf").status().code(), StatusCode::kUnimplemented);
+
+    // Dropping the last bytes leaves the last tensor past the end of the file.
+    bytes.resize(bytes.size() - 1);
+    WriteRawFile(temp_dir.path() / "truncated.gguf", bytes);
+    EXPECT_EQ(GgufReader::Open(temp_dir.path() / "truncated.gguf").status().code(), StatusCode::kInvalidArgument);
+
+    bytes.resize(40);
+    WriteRawFile(temp_dir.path() / "header.gguf", bytes);
+    EXPECT_EQ(GgufReader::Open(temp_dir.path() / "header.gguf").status().code(), StatusCode::kInvalidArgument);
+}
+
+TEST(GgufReader, RejectsTensorTypesTheLoaderCannotRead) {
+    TempDirectory temp_dir;
+    GgufFileBuilder builder;
+    builder.AddString("general.architecture", "llama");
+    builder.AddTensor("blk.0.attn_q.weight", GgufTensorType::kQ4_K, {1, 256},
+                      std::vector<std::byte>(144));
+    const auto reader = GgufReader::Open(WriteGguf(temp_dir, builder));
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    ASSERT_EQ(reader->Tensors().size(), 1U);
+    EXPECT_EQ(reader->Tensors()[0].type, GgufTensorType::kQ4_K);
+    EXPECT_EQ(reader->Tensors()[0].bytes, 144U);
+
+    EXPECT_EQ(reader->LoadRawWeightTable().status().code(), StatusCode::kUnimplemented);
+}
+
+TEST(GgufReader, ModelLoaderPacksBlockQuantizedWeightsWithoutRequantizing) {
+    TempDirectory temp_dir;
+    const auto path = WriteGguf(temp_dir, MakeTinyLlama());
+
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto model = ModelLoader::Load(ModelLoadOptions{.model_dir = path, .num_threads = 1}, backend, registry);
+    ASSERT_TRUE(model.ok()) << model.status().ToString();
+    EXPECT_TRUE((*model)->GetConfig().tie_word_embeddings);
+    EXPECT_TRUE((*model)->GetWeightQuantizationReports().empty());
+
+    KernelSelector selector{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Int(8),
+            .weight_format = WeightFormat::kQuantizedInt8,
+            .isa = IsaLevel::kAVX2,
+            .phase = ExecPhase::kBoth,
+    };
+    const PackedWeights* int8 = (*model)->FindPackedWeights(OpType::kLinear, selector);
+    ASSERT_NE(int8, nullptr);
+    const auto int8_layout = CpuQuantizedWeightLayout::Make(WeightFormat::kQuantizedInt8, 32, 32, 32);
+    ASSERT_TRUE(int8_layout.ok());
+    const auto* int8_bytes = static_cast<const int8_t*>(int8->storage().data());
+    EXPECT_EQ(int8_bytes[0], 1);
+    EXPECT_EQ(int8_bytes[31 * 32], 32);
+    EXPECT_EQ(reinterpret_cast<const float*>(reinterpret_cast<const std::byte*>(int8_bytes) +
+                                             int8_layout->scales_offset)[31],
+              1.0F);
+
+    selector.weight_dtype = DataType::Int(4);
+    selector.weight_format = WeightFormat::kQuantizedInt4;
+    const PackedWeights* int4 = (*model)->FindPackedWeights(OpType::kLinear, selector);
+    ASSERT_NE(int4, nullptr);
+    // Q4_0 nibble 9 is level 1 in both halves of every byte.
+    EXPECT_EQ(static_cast<const uint8_t*>(int4->storage().data())[0], 0x11);
+}
+
+TEST(GgufReader, BlockQuantizedWeightsLoadButDoNotBuildAPlan) {
+    TempDirectory temp_dir;
+    const auto path = WriteGguf(temp_dir, MakeTinyLlama());
+
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto model = ModelLoader::Load(ModelLoadOptions{.model_dir = path, .num_threads = 1}, backend, registry);
+    ASSERT_TRUE(model.ok()) << model.status().ToString();
+    const PackedWeights* q_proj = (*model)->FindPackedWeights(0U, WeightRole::kQProj);
+    ASSERT_NE(q_proj, nullptr);
+    EXPECT_EQ(q_proj->selector().weight_format, WeightFormat::kQuantizedInt8);
+
+    // A Linear node lowered for packed weights binds the Q8_0 q_proj artifact,
+    // which no kernel reads yet.
+    const std::vector<int64_t> act_dims{4, static_cast<int64_t>(kHidden)};
+    const std::vector<int64_t> weight_dims{static_cast<int64_t>(kHidden), static_cast<int64_t>(kHidden)};
+    std::vector<TensorSpec> inputs = {
+            TensorSpec{.dtype = DataType::Float32(), .shape = SymbolicShape(IntArrayView{act_dims})},
+            TensorSpec{.dtype = DataType::Float32(), .shape = SymbolicShape(IntArrayView{weight_dims})},
+    };
+    const auto analyzed = InferOperator(OpType::kLinear, OpParams{LinearParams{}}, inputs);
+    ASSERT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+    ExecutionPlanNodeSpec node{
+            .op_type = OpType::kLinear,
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .weight_format = WeightFormat::kPacked,
+            .isa = IsaLevel::kAVX2,
+            .phase = ExecPhase::kBoth,
+            .decoder_layer_index = 0U,
+            .weight_role = TransformerWeightRole::kAttentionQ,
+    };
+    node.op_params = OpParams{LinearParams{}};
+    node.input_specs = inputs;
+    node.output_specs = analyzed->outputs;
+
+    RuntimeBuilder builder;
+    RuntimeContext runtime = builder.Build();
+    const auto plan = ExecutionPlanBuilder::Build(runtime, **model, std::vector<ExecutionPlanNodeSpec>{node});
+    EXPECT_EQ(plan.status().code(), StatusCode::kUnimplemented) << plan.status().ToString();
+}
+
+}// namespace
@@ -64,6 +64,34 @@ TEST(ModelLoader_HfDirectoryReaderTest, LoadsSingleFileRawWeightTable) {
     EXPECT_FLOAT_EQ(ReadFloat(it->second.data + sizeof(float)), 2.0f);
 }
 
+TEST(ModelLoader_HfDirectoryReaderTest, FingerprintIsStableAndTracksCheckpointFiles) {
+    TempDirectory temp_dir;
+    WriteTextFile(temp_dir.path() / "config.json", "{}");
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         R"({"weight":{"dtype":"F32","shape":[2],"data_offsets":[0,8]}})",
+                         FloatArrayToBytes(std::array<float, 2>{1.0f, 2.0f}));
+
+    auto reader = HfDirectoryReader::Open(temp_dir.path());
+    ASSERT_TRUE(reader.ok()) << reader.status().ToString();
+    const auto first = reader->ComputeFingerprint();
+    const auto second = reader->ComputeFingerprint();
+    ASSERT_TRUE(first.ok()) << first.status().ToString();
+    ASSERT_TRUE(second.ok());
+    EXPECT_EQ(*first, *second);
+
+    WriteTextFile(temp_dir.path() / "config.json", R"({"hidden_size": 2})");
+    const auto edited_config = reader->ComputeFingerprint();
+    ASSERT_TRUE(edited_config.ok());
+    EXPECT_NE(*edited_config, *first);
+
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         R"({"weight":{"dtype":"F32","shape":[3],"data_offsets":[0,12]}})",
+                         FloatArrayToBytes(std::array<float, 3>{1.0f, 2.0f, 3.0f}));
+    const auto resized_weights = reader->ComputeFingerprint();
+    ASSERT_TRUE(resized_weights.ok());
+    EXPECT_NE(*resized_weights, *edited_config);
+}
+
 TEST(ModelLoader_HfDirectoryReaderTest, RejectsMissingConfigJson) {
     TempDirectory temp_dir;
     WriteBinaryFile(temp_dir.path() / "model.safetensors");
@@ -271,4 +271,25 @@ TEST(ModelLoader_HfSafetensorsFileTest, KeepsMappedViewAliveAfterFileIsRemoved)
     EXPECT_FLOAT_EQ(ReadFloat(view.data + sizeof(float)), 8.0f);
 }
 
+TEST(ModelLoader_HfSafetensorsFileTest, AdvisesTensorRangesOfTheMapping) {
+    TempDirectory temp_dir;
+    const auto raw_bytes = FloatArrayToBytes(std::array<float, 2>{1.0f, 2.0f});
+    const auto path = WriteSafetensorsFile(
+            temp_dir.Path(),
+            R"({"weight":{"dtype":"F32","shape":[2],"data_offsets":[0,8]}})",
+            raw_bytes);
+
+    const auto file = HfSafetensorsFile::Open(path);
+    ASSERT_TRUE(file.ok()) << file.status().ToString();
+    const RawWeightView& view = file->Find("weight")->view;
+
+    EXPECT_TRUE(view.storage->Advise(view.data, view.bytes, MemoryMappedFile::Advice::kWillNeed).ok());
+    EXPECT_TRUE(view.storage->Advise(view.data, view.bytes, MemoryMappedFile::Advice::kDontNeed).ok());
+    EXPECT_FLOAT_EQ(ReadFloat(view.data + sizeof(float)), 2.0f);
+
+    const std::byte outside{};
+    EXPECT_EQ(view.storage->Advise(&outside, 1, MemoryMappedFile::Advice::kWillNeed).code(),
+              StatusCode::kInvalidArgument);
+}
+
 }// namespace
@@ -274,6 +274,23 @@ TEST(ModelGraphBuilder, RecordsTypedParamsForAllGraphOps) {
     EXPECT_EQ(argmax_params->axis, -1);
 }
 
+TEST(ModelGraphBuilder, EndsInSampleWhenSamplingIsRequested) {
+    const HfModelConfig config = MakeLlamaConfig(1);
+    const ResolvedModelWeights weights = MakeWeights(config);
+    const SampleParams sampling{.temperature = 0.8F, .top_k = 40, .top_p = 0.95F, .seed = 3};
+
+    const StatusOr<ModelGraph> graph = ModelGraphBuilder::BuildLlamaDense(config, weights, sampling);
+
+    ASSERT_TRUE(graph.ok()) << graph.status().ToString();
+    const auto nodes = graph->GetNodes();
+    EXPECT_EQ(nodes.back().op_type, OpType::kSample);
+    const auto* sample_params = std::get_if<SampleParams>(&nodes.back().op_params);
+    ASSERT_NE(sample_params, nullptr);
+    EXPECT_EQ(*sample_params, sampling);
+    EXPECT_EQ(graph->GetValue(graph->GetOutputs()[0].value).name, "sample");
+    EXPECT_EQ(graph->GetValue(graph->GetOutputs()[0].value).spec.dtype, DataType::Int(64));
+}
+
 TEST(ModelGraphBuilder, TracesResidualDataflowInAttention) {
     const HfModelConfig config = MakeLlamaConfig(1);
     const ResolvedModelWeights weights = MakeWeights(config);
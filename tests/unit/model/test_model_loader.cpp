@@ -1,14 +1,25 @@
 #include "aethermind/model/model_loader.h"
 
+#include "aethermind/backend/backend.h"
+#include "aethermind/backend/backend_factory.h"
 #include "aethermind/backend/cpu/cpu_backend.h"
+#include "aethermind/backend/kernel_context.h"
 #include "aethermind/backend/kernel_registry.h"
 #include "aethermind/backend/kernel_selector.h"
+#include "aethermind/execution/execution_plan_builder.h"
 #include "aethermind/model/model_instance.h"
+#include "aethermind/model/packed_weight_cache.h"
+#include "aethermind/operators/operator_inference.h"
+#include "aethermind/runtime/runtime_builder.h"
 #include "test_utils.h"
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <filesystem>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <gtest/gtest.h>
 #include <span>
 #include <string>
@@ -19,8 +30,8 @@ namespace {
 
 using namespace aethermind;
 
-std::string MakeMinimalLlamaConfigJson() {
-    return R"({
+std::string MakeMinimalLlamaConfigJson(bool tie_word_embeddings = false) {
+    return std::string(R"({
         "architectures": ["LlamaForCausalLM"],
         "model_type": "llama",
         "hidden_size": 1,
@@ -31,8 +42,8 @@ std::string MakeMinimalLlamaConfigJson() {
         "max_position_embeddings": 1,
         "vocab_size": 1,
         "rms_norm_eps": 1e-6,
-        "tie_word_embeddings": false
-    })";
+        "tie_word_embeddings": )") +
+           (tie_word_embeddings ? "true" : "false") + "\n    }";
 }
 
 std::vector<std::string> MakeCompleteTensorNames(int64_t num_layers) {
@@ -120,6 +131,63 @@ std::vector<std::byte> ZeroFloatBytes(size_t count) {
     return FloatArrayToBytes(values);
 }
 
+Status PackedLinearTestKernel(const KernelContext&) noexcept {
+    return Status::Ok();
+}
+
+// Resolves every packed Linear selector to a no-op kernel so a plan can be
+// built over loader-produced artifacts before a real Linear kernel exists.
+class PackedLinearTestBackend final : public Backend {
+public:
+    DeviceType device_type() const noexcept override {
+        return DeviceType::kCPU;
+    }
+
+    const BackendCapabilities& capabilities() const noexcept override {
+        return capabilities_;
+    }
+
+    KernelFunc ResolveKernel(OpType op_type,
+                             const KernelSelector& selector) const noexcept override {
+        if (op_type != OpType::kLinear || selector.weight_format != WeightFormat::kPacked) {
+            return nullptr;
+        }
+        return &PackedLinearTestKernel;
+    }
+
+    StatusOr<ResolvedKernel> ResolveKernelInfo(
+            OpType op_type,
+            const KernelSelector& selector) const noexcept override {
+        if (ResolveKernel(op_type, selector) == nullptr) {
+            return Status::NotFound("Packed Linear test backend only resolves packed Linear selectors");
+        }
+        return ResolvedKernel{
+                .op_type = op_type,
+                .fn = &PackedLinearTestKernel,
+                .attrs = {},
+                .debug_name = "test::packed_linear_kernel",
+        };
+    }
+
+    const KernelRegistry* TryGetKernelRegistryForDebug() const noexcept override {
+        return nullptr;
+    }
+
+private:
+    BackendCapabilities capabilities_{};
+};
+
+class PackedLinearTestBackendFactory final : public BackendFactory {
+public:
+    DeviceType device_type() const noexcept override {
+        return DeviceType::kCPU;
+    }
+
+    std::unique_ptr<Backend> Create() const override {
+        return std::make_unique<PackedLinearTestBackend>();
+    }
+};
+
 TEST(ModelLoader_PipelineTest, ValidSingleFileDirectoryReachesModelInstanceBoundary) {
     TempDirectory temp_dir;
     WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson());
@@ -225,6 +293,268 @@ TEST(ModelLoader_PipelineTest, ValidShardedDirectoryReachesModelInstanceBoundary
     EXPECT_GT(packed->storage().nbytes(), 0U);
 }
 
+TEST(ModelLoader_PipelineTest, ParallelLoadPacksTheSameBytesAsSerialLoad) {
+    TempDirectory temp_dir;
+    WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson());
+    std::array<float, 12> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) + 0.5F;
+    }
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         MakeCompleteTensorHeader(1),
+                         FloatArrayToBytes(values));
+
+    const KernelSelector selector{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .weight_format = WeightFormat::kPacked,
+            .isa = IsaLevel::kAVX2,
+            .phase = ExecPhase::kBoth,
+    };
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto serial = ModelLoader::Load(
+            ModelLoadOptions{.model_dir = temp_dir.path(), .num_threads = 1}, backend, registry);
+    const auto parallel = ModelLoader::Load(
+            ModelLoadOptions{.model_dir = temp_dir.path(), .num_threads = 4}, backend, registry);
+    const auto lazy = ModelLoader::Load(
+            ModelLoadOptions{.model_dir = temp_dir.path(), .num_threads = 4, .prefault_weights = false},
+            backend, registry);
+    ASSERT_TRUE(serial.ok()) << serial.status().message();
+    ASSERT_TRUE(parallel.ok()) << parallel.status().message();
+    ASSERT_TRUE(lazy.ok()) << lazy.status().message();
+
+    const PackedWeights* expected = (*serial)->FindPackedWeights(OpType::kLinear, selector);
+    ASSERT_NE(expected, nullptr);
+    for (const auto* model: {&*parallel, &*lazy}) {
+        const PackedWeights* packed = (*model)->FindPackedWeights(OpType::kLinear, selector);
+        ASSERT_NE(packed, nullptr);
+        ASSERT_EQ(packed->storage().nbytes(), expected->storage().nbytes());
+        EXPECT_EQ(std::memcmp(packed->storage().data(), expected->storage().data(),
+                              expected->storage().nbytes()),
+                  0);
+    }
+}
+
+TEST(ModelLoader_PipelineTest, WarmStartMapsPackedWeightsFromTheCache) {
+    TempDirectory temp_dir;
+    TempDirectory cache_dir;
+    WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson());
+    std::array<float, 12> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) - 3.0F;
+    }
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         MakeCompleteTensorHeader(1),
+                         FloatArrayToBytes(values));
+
+    const KernelSelector selector{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .weight_format = WeightFormat::kPacked,
+            .isa = IsaLevel::kAVX2,
+            .phase = ExecPhase::kBoth,
+    };
+    const ModelLoadOptions options{.model_dir = temp_dir.path(),
+                                   .packed_weight_cache_dir = cache_dir.path() / "packed"};
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto cold = ModelLoader::Load(options, backend, registry);
+    ASSERT_TRUE(cold.ok()) << cold.status().message();
+    const auto cache_files = std::distance(std::filesystem::directory_iterator(cache_dir.path() / "packed"),
+                                           std::filesystem::directory_iterator());
+    EXPECT_EQ(cache_files, 1);
+
+    const auto warm = ModelLoader::Load(options, backend, registry);
+    ASSERT_TRUE(warm.ok()) << warm.status().message();
+    const PackedWeights* packed = (*cold)->FindPackedWeights(OpType::kLinear, selector);
+    const PackedWeights* mapped = (*warm)->FindPackedWeights(OpType::kLinear, selector);
+    ASSERT_NE(packed, nullptr);
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(mapped->storage().alignment(), kPackedWeightCacheAlignment);
+    ASSERT_EQ(mapped->storage().nbytes(), packed->storage().nbytes());
+    EXPECT_EQ(std::memcmp(mapped->storage().data(), packed->storage().data(), packed->storage().nbytes()), 0);
+}
+
+TEST(ModelLoader_PipelineTest, WarmStartRestoresQuantizationReportsFromTheCache) {
+    TempDirectory temp_dir;
+    TempDirectory cache_dir;
+    WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson());
+    std::array<float, 12> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) * 0.3F - 1.5F;
+    }
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         MakeCompleteTensorHeader(1),
+                         FloatArrayToBytes(values));
+
+    ModelLoadOptions options{.model_dir = temp_dir.path(),
+                             .packed_weight_cache_dir = cache_dir.path() / "packed"};
+    options.quantization.default_config = {.scheme = WeightQuantScheme::kInt8PerChannel};
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto cold = ModelLoader::Load(options, backend, registry);
+    ASSERT_TRUE(cold.ok()) << cold.status().message();
+    const auto warm = ModelLoader::Load(options, backend, registry);
+    ASSERT_TRUE(warm.ok()) << warm.status().message();
+
+    const auto& expected = (*cold)->GetWeightQuantizationReports();
+    const auto& restored = (*warm)->GetWeightQuantizationReports();
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(restored.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(restored[i].decoder_layer_index, expected[i].decoder_layer_index) << "report " << i;
+        EXPECT_EQ(restored[i].role, expected[i].role) << "report " << i;
+        EXPECT_EQ(restored[i].config.scheme, expected[i].config.scheme) << "report " << i;
+        EXPECT_EQ(restored[i].error.max_abs_error, expected[i].error.max_abs_error) << "report " << i;
+        EXPECT_EQ(restored[i].error.rms_error, expected[i].error.rms_error) << "report " << i;
+    }
+}
+
+TEST(ModelLoader_PipelineTest, StoresPackedWeightsInAnExecutionOrderedArena) {
+    TempDirectory temp_dir;
+    WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson());
+    std::array<float, 12> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) + 1.0F;
+    }
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         MakeCompleteTensorHeader(1),
+                         FloatArrayToBytes(values));
+
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto arena = ModelLoader::Load(ModelLoadOptions{.model_dir = temp_dir.path()}, backend, registry);
+    const auto separate = ModelLoader::Load(
+            ModelLoadOptions{.model_dir = temp_dir.path(), .packed_weight_arena = false}, backend, registry);
+    ASSERT_TRUE(arena.ok()) << arena.status().message();
+    ASSERT_TRUE(separate.ok()) << separate.status().message();
+
+    const std::array<WeightRole, 7> layer_roles = {
+            WeightRole::kQProj, WeightRole::kKProj, WeightRole::kVProj, WeightRole::kOProj,
+            WeightRole::kGateProj, WeightRole::kUpProj, WeightRole::kDownProj};
+    std::vector<const PackedWeights*> order;
+    for (const WeightRole role: layer_roles) {
+        order.push_back((*arena)->FindPackedWeights(0, role));
+    }
+    order.push_back((*arena)->FindPackedWeights(std::nullopt, WeightRole::kLmHead));
+    // Weights aliased to the checkpoint mapping are read-only and get no
+    // slot; the rest follow each other in 64-byte slots.
+    const std::byte* previous = nullptr;
+    for (const PackedWeights* packed: order) {
+        ASSERT_NE(packed, nullptr);
+        if (packed->storage().read_only()) {
+            continue;
+        }
+        const auto* data = static_cast<const std::byte*>(packed->storage().data());
+        if (previous != nullptr) {
+            EXPECT_EQ(data, previous + 64);
+        }
+        previous = data;
+    }
+    EXPECT_NE(previous, nullptr);
+
+    for (const WeightRole role: layer_roles) {
+        const PackedWeights* expected = (*separate)->FindPackedWeights(0, role);
+        const PackedWeights* packed = (*arena)->FindPackedWeights(0, role);
+        ASSERT_NE(expected, nullptr);
+        ASSERT_EQ(packed->storage().nbytes(), expected->storage().nbytes());
+        EXPECT_EQ(std::memcmp(packed->storage().data(), expected->storage().data(), expected->storage().nbytes()),
+                  0);
+    }
+}
+
+TEST(ModelLoader_PipelineTest, QuantizesWeightsWhilePackingAndReportsTheirError) {
+    TempDirectory temp_dir;
+    WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson());
+    std::array<float, 12> values{};
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) * 0.3F - 1.5F;
+    }
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         MakeCompleteTensorHeader(1),
+                         FloatArrayToBytes(values));
+
+    ModelLoadOptions options{.model_dir = temp_dir.path(), .num_threads = 2};
+    options.quantization.default_config = {.scheme = WeightQuantScheme::kInt8PerChannel};
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto model = ModelLoader::Load(options, backend, registry);
+    ASSERT_TRUE(model.ok()) << model.status().message();
+
+    const KernelSelector selector{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Int(8),
+            .weight_format = WeightFormat::kQuantizedInt8,
+            .isa = IsaLevel::kAVX2,
+            .phase = ExecPhase::kBoth,
+    };
+    EXPECT_NE((*model)->FindPackedWeights(OpType::kLinear, selector), nullptr);
+    const auto& reports = (*model)->GetWeightQuantizationReports();
+    ASSERT_FALSE(reports.empty());
+    for (const auto& report: reports) {
+        EXPECT_EQ(report.config.scheme, WeightQuantScheme::kInt8PerChannel);
+        EXPECT_LE(report.error.rms_error, report.error.max_abs_error);
+    }
+}
+
+TEST(ModelLoader_PipelineTest, TiedEmbeddingsPackLmHeadAndBuildAPlan) {
+    TempDirectory temp_dir;
+    WriteTextFile(temp_dir.path() / "config.json", MakeMinimalLlamaConfigJson(true));
+    std::vector<std::string> names = MakeCompleteTensorNames(1);
+    std::erase(names, "lm_head.weight");
+    std::vector<float> values(names.size());
+    values[0] = 0.5F;// model.embed_tokens.weight
+    WriteSafetensorsFile(temp_dir.path() / "model.safetensors",
+                         MakeTensorHeaderForNames(names),
+                         FloatArrayToBytes(values));
+
+    CpuBackend backend;
+    KernelRegistry registry;
+    const auto model = ModelLoader::Load(ModelLoadOptions{.model_dir = temp_dir.path(), .num_threads = 2},
+                                         backend, registry);
+    ASSERT_TRUE(model.ok()) << model.status().message();
+    const PackedWeights* lm_head = (*model)->FindPackedWeights(std::nullopt, WeightRole::kLmHead);
+    ASSERT_NE(lm_head, nullptr);
+    EXPECT_EQ(lm_head->op_type(), OpType::kLinear);
+    EXPECT_EQ(lm_head->selector().weight_format, WeightFormat::kPacked);
+
+    const std::vector<int64_t> act_dims{4, 1};
+    const std::vector<int64_t> weight_dims{1, 1};
+    std::vector<TensorSpec> inputs = {
+            TensorSpec{.dtype = DataType::Float32(), .shape = SymbolicShape(IntArrayView{act_dims})},
+            TensorSpec{.dtype = DataType::Float32(), .shape = SymbolicShape(IntArrayView{weight_dims})},
+    };
+    const auto analyzed = InferOperator(OpType::kLinear, OpParams{LinearParams{}}, inputs);
+    ASSERT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+    const KernelSelector& selector = lm_head->selector();
+    ExecutionPlanNodeSpec node{
+            .op_type = OpType::kLinear,
+            .device_type = selector.device_type,
+            .act_dtype = selector.act_dtype,
+            .weight_dtype = selector.weight_dtype,
+            .weight_format = selector.weight_format,
+            .isa = selector.isa,
+            .phase = selector.phase,
+            .weight_role = TransformerWeightRole::kLmHead,
+    };
+    node.op_params = OpParams{LinearParams{}};
+    node.input_specs = inputs;
+    node.output_specs = analyzed->outputs;
+
+    RuntimeBuilder builder;
+    builder.RegisterBackendFactory(DeviceType::kCPU,
+                                   std::make_unique<PackedLinearTestBackendFactory>());
+    RuntimeContext runtime = builder.Build();
+    const auto plan = ExecutionPlanBuilder::Build(runtime, **model, std::vector<ExecutionPlanNodeSpec>{node});
+    ASSERT_TRUE(plan.ok()) << plan.status().ToString();
+    ASSERT_EQ(plan->size(), 1U);
+    EXPECT_EQ(plan->steps().front().packed_weights, lm_head->storage().data());
+}
+
 TEST(ModelLoader_PipelineTest, RejectsUnsupportedModelFamily) {
     TempDirectory temp_dir;
     WriteTextFile(temp_dir.path() / "config.json", R"({
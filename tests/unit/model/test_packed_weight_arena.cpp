@@ -0,0 +1,78 @@
+#include "aethermind/model/packed_weight_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+TEST(PackedWeightArena, LaysSlotsOutBackToBackInTheGivenOrder) {
+    const size_t slot_sizes[] = {100, 64, 1};
+
+    auto arena = PackedWeightArena::Create(slot_sizes);
+
+    ASSERT_TRUE(arena.ok()) << arena.status().ToString();
+    ASSERT_NE(arena->data(), nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arena->data()) % PackedWeightArena::kHugePageSize, 0U);
+    // 100 bytes round up to the next 64-byte slot.
+    EXPECT_EQ(arena->size(), 128U + 64U + 1U);
+    ASSERT_EQ(arena->num_slots(), 3U);
+
+    const size_t offsets[] = {0, 128, 192};
+    for (size_t i = 0; i < arena->num_slots(); ++i) {
+        Buffer slot = arena->Slot(i);
+        ASSERT_TRUE(slot.is_initialized());
+        EXPECT_EQ(static_cast<const std::byte*>(slot.data()), arena->data() + offsets[i]);
+        EXPECT_EQ(slot.nbytes(), slot_sizes[i]);
+        EXPECT_EQ(slot.alignment(), PackedWeightArena::kSlotAlignment);
+        ASSERT_NE(slot.mutable_data(), nullptr);
+        std::memset(slot.mutable_data(), static_cast<int>(i + 1), slot.nbytes());
+    }
+    EXPECT_EQ(arena->data()[99], std::byte{1});
+    EXPECT_EQ(arena->data()[128], std::byte{2});
+    EXPECT_EQ(arena->data()[192], std::byte{3});
+    EXPECT_FALSE(arena->Slot(3).is_initialized());
+}
+
+TEST(PackedWeightArena, SlotsKeepTheMappingAliveAfterTheArenaIsGone) {
+    const size_t slot_sizes[] = {256};
+
+    Buffer slot;
+    {
+        auto arena = PackedWeightArena::Create(slot_sizes);
+        ASSERT_TRUE(arena.ok()) << arena.status().ToString();
+        slot = arena->Slot(0);
+    }
+
+    ASSERT_TRUE(slot.is_initialized());
+    std::memset(slot.mutable_data(), 0x5A, slot.nbytes());
+    const auto* bytes = static_cast<const uint8_t*>(slot.data());
+    EXPECT_EQ(bytes[0], 0x5A);
+    EXPECT_EQ(bytes[255], 0x5A);
+}
+
+TEST(PackedWeightArena, AcceptsEmptySlotsAndAnEmptyList) {
+    auto empty = PackedWeightArena::Create({});
+    ASSERT_TRUE(empty.ok());
+    EXPECT_EQ(empty->data(), nullptr);
+    EXPECT_EQ(empty->size(), 0U);
+    EXPECT_EQ(empty->num_slots(), 0U);
+
+    const size_t zero_sizes[] = {0, 0};
+    auto zeros = PackedWeightArena::Create(zero_sizes);
+    ASSERT_TRUE(zeros.ok());
+    EXPECT_EQ(zeros->data(), nullptr);
+    EXPECT_EQ(zeros->num_slots(), 2U);
+    EXPECT_FALSE(zeros->Slot(0).is_initialized());
+}
+
+TEST(PackedWeightArena, RejectsSizesThatOverflow) {
+    const size_t slot_sizes[] = {1, static_cast<size_t>(-1)};
+    EXPECT_EQ(PackedWeightArena::Create(slot_sizes).status().code(), StatusCode::kResourceExhausted);
+}
+
+}// namespace
@@ -0,0 +1,135 @@
+#include "aethermind/model/packed_weight_cache.h"
+
+#include "aethermind/backend/cpu/cpu_weight_prepacker.h"
+#include "test_utils.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+KernelSelector MakePackedSelector(IsaLevel isa) {
+    return KernelSelector{
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .weight_format = WeightFormat::kPacked,
+            .isa = isa,
+            .phase = ExecPhase::kBoth,
+    };
+}
+
+std::unique_ptr<PackedWeights> PackValues(const std::vector<float>& values, IsaLevel isa) {
+    const int64_t shape[2] = {static_cast<int64_t>(values.size()), 1};
+    const int64_t strides[2] = {1, 1};
+    auto packed = CpuWeightPrepacker().Pack(
+            OpType::kLinear,
+            TensorView(values.data(), DataType::Float32(), IntArrayView(shape, 2), IntArrayView(strides, 2), 0),
+            MakePackedSelector(isa));
+    EXPECT_TRUE(packed.ok()) << packed.status().ToString();
+    return packed.ok() ? std::move(*packed) : nullptr;
+}
+
+constexpr PackedWeightCacheKey kKey{.checkpoint_fingerprint = 0x1234, .pack_format_version = 1};
+
+TEST(ModelLoader_PackedWeightCacheTest, RoundTripsArtifactsAsPageAlignedMappings) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "weights.ampw";
+    const std::vector<float> first = {1.0F, 2.0F, 3.0F};
+    const std::vector<float> second(5000, 0.25F);
+    const auto packed_first = PackValues(first, IsaLevel::kAVX2);
+    const auto packed_second = PackValues(second, IsaLevel::kScalar);
+    ASSERT_NE(packed_first, nullptr);
+    ASSERT_NE(packed_second, nullptr);
+    const PackedWeights* artifacts[] = {packed_first.get(), packed_second.get()};
+    ASSERT_TRUE(SavePackedWeightCache(artifacts, kKey, path).ok());
+
+    auto loaded = LoadPackedWeightCache(path, kKey);
+    ASSERT_TRUE(loaded.ok()) << loaded.status().ToString();
+    ASSERT_EQ(loaded->size(), 2U);
+    for (size_t i = 0; i < 2; ++i) {
+        const PackedWeights& mapped = *(*loaded)[i];
+        EXPECT_EQ(mapped.op_type(), artifacts[i]->op_type());
+        EXPECT_EQ(mapped.selector(), artifacts[i]->selector());
+        ASSERT_EQ(mapped.storage().nbytes(), artifacts[i]->storage().nbytes());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.storage().data()) % kPackedWeightCacheAlignment, 0U);
+        EXPECT_TRUE(mapped.storage().read_only());
+        EXPECT_EQ(std::memcmp(mapped.storage().data(), artifacts[i]->storage().data(),
+                              mapped.storage().nbytes()),
+                  0);
+    }
+
+    // Each artifact keeps the shared mapping alive on its own.
+    std::unique_ptr<PackedWeights> survivor = std::move((*loaded)[1]);
+    loaded->clear();
+    EXPECT_EQ(static_cast<const float*>(survivor->storage().data())[4999], 0.25F);
+}
+
+TEST(ModelLoader_PackedWeightCacheTest, EncodesTheEntryTableWithoutPadding) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "weights.ampw";
+    const auto packed = PackValues(std::vector<float>(100, 1.0F), IsaLevel::kAVX2);
+    const PackedWeights* artifacts[] = {packed.get()};
+    ASSERT_TRUE(SavePackedWeightCache(artifacts, kKey, path).ok());
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes(kPackedWeightCacheAlignment);
+    ASSERT_TRUE(in.read(bytes.data(), static_cast<std::streamsize>(bytes.size())));
+
+    // 24 header bytes, then the entry: 9 bytes of op/selector enums, two
+    // 4-byte dtypes, and the 8-byte offset and size. Everything after it up
+    // to the first payload is zero fill.
+    constexpr size_t kEntryBegin = 24;
+    constexpr size_t kOffsetPos = kEntryBegin + 9 + 8;
+    uint64_t offset = 0;
+    uint64_t nbytes = 0;
+    std::memcpy(&offset, bytes.data() + kOffsetPos, sizeof(offset));
+    std::memcpy(&nbytes, bytes.data() + kOffsetPos + sizeof(offset), sizeof(nbytes));
+    EXPECT_EQ(offset, kPackedWeightCacheAlignment);
+    EXPECT_EQ(nbytes, packed->storage().nbytes());
+    for (size_t i = kOffsetPos + 16; i < bytes.size(); ++i) {
+        ASSERT_EQ(bytes[i], 0) << "byte " << i;
+    }
+}
+
+TEST(ModelLoader_PackedWeightCacheTest, RejectsAnotherCheckpointOrPackingFormat) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "weights.ampw";
+    const auto packed = PackValues({1.0F}, IsaLevel::kAVX2);
+    const PackedWeights* artifacts[] = {packed.get()};
+    ASSERT_TRUE(SavePackedWeightCache(artifacts, kKey, path).ok());
+
+    EXPECT_EQ(LoadPackedWeightCache(path, PackedWeightCacheKey{.checkpoint_fingerprint = 0x1235,
+                                                               .pack_format_version = 1})
+                      .status()
+                      .code(),
+              StatusCode::kFailedPrecondition);
+    EXPECT_EQ(LoadPackedWeightCache(path, PackedWeightCacheKey{.checkpoint_fingerprint = 0x1234,
+                                                               .pack_format_version = 2})
+                      .status()
+                      .code(),
+              StatusCode::kFailedPrecondition);
+}
+
+TEST(ModelLoader_PackedWeightCacheTest, RejectsTruncatedAndForeignFiles) {
+    TempDirectory temp_dir;
+    const auto path = temp_dir.path() / "weights.ampw";
+    const auto packed = PackValues(std::vector<float>(100, 1.0F), IsaLevel::kAVX2);
+    const PackedWeights* artifacts[] = {packed.get()};
+    ASSERT_TRUE(SavePackedWeightCache(artifacts, kKey, path).ok());
+
+    std::filesystem::resize_file(path, kPackedWeightCacheAlignment + 16);
+    EXPECT_EQ(LoadPackedWeightCache(path, kKey).status().code(), StatusCode::kInvalidArgument);
+
+    WriteTextFile(path, std::string(64, 'x'));
+    EXPECT_EQ(LoadPackedWeightCache(path, kKey).status().code(), StatusCode::kInvalidArgument);
+}
+
+}// namespace
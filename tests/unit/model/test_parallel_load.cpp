@@ -0,0 +1,89 @@
+#include "aethermind/model/parallel_load.h"
+
+#include <atomic>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace aethermind;
+
+struct TestStorage : RawStorage {
+    explicit TestStorage(size_t nbytes) : data(nbytes) {}
+    std::vector<std::byte> data;
+};
+
+TEST(ModelLoader_ParallelLoadTest, ResolveLoadThreadCountNeverReturnsZero) {
+    EXPECT_EQ(ResolveLoadThreadCount(3), 3U);
+    EXPECT_GE(ResolveLoadThreadCount(0), 1U);
+}
+
+TEST(ModelLoader_ParallelLoadTest, RunsEveryTaskExactlyOnce) {
+    constexpr size_t kTasks = 257;
+    std::vector<std::atomic<int>> runs(kTasks);
+    const Status status = RunLoadTasks(kTasks, 8, [&runs](size_t index) {
+        runs[index].fetch_add(1);
+        return Status::Ok();
+    });
+
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    for (size_t i = 0; i < kTasks; ++i) {
+        EXPECT_EQ(runs[i].load(), 1) << i;
+    }
+}
+
+TEST(ModelLoader_ParallelLoadTest, SingleThreadRunsTasksInIndexOrder) {
+    std::vector<size_t> order;
+    ASSERT_TRUE(RunLoadTasks(5, 1, [&order](size_t index) {
+                    order.push_back(index);
+                    return Status::Ok();
+                }).ok());
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(ModelLoader_ParallelLoadTest, ReportsTheLowestFailingTask) {
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        const Status status = RunLoadTasks(64, 8, [](size_t index) {
+            if (index == 9 || index == 40) {
+                return Status::InvalidArgument("task " + std::to_string(index));
+            }
+            return Status::Ok();
+        });
+        ASSERT_FALSE(status.ok());
+        EXPECT_EQ(status.message(), "task 9");
+    }
+}
+
+TEST(ModelLoader_ParallelLoadTest, ReportsOutOfMemoryInATaskAsResourceExhausted) {
+    const Status status = RunLoadTasks(16, 4, [](size_t index) -> Status {
+        if (index == 5) {
+            throw std::bad_alloc();
+        }
+        return Status::Ok();
+    });
+    EXPECT_EQ(status.code(), StatusCode::kResourceExhausted);
+}
+
+TEST(ModelLoader_ParallelLoadTest, PrefaultTouchesEveryTensorIncludingEmptyOnes) {
+    auto storage = std::make_shared<TestStorage>(3 * 4096 + 17);
+    auto other_shard = std::make_shared<TestStorage>(100);
+    RawWeightTable table;
+    table.emplace("a", RawWeightView{.data = storage->data.data(),
+                                     .bytes = storage->data.size(),
+                                     .dtype = DataType::Float32(),
+                                     .storage = storage});
+    table.emplace("b", RawWeightView{.data = other_shard->data.data() + 4,
+                                     .bytes = 96,
+                                     .dtype = DataType::Float32(),
+                                     .storage = other_shard});
+    table.emplace("empty", RawWeightView{.dtype = DataType::Float32(), .storage = other_shard});
+
+    EXPECT_TRUE(PrefaultRawWeights(table, 4).ok());
+    EXPECT_TRUE(PrefaultRawWeights(RawWeightTable{}, 4).ok());
+}
+
+}// namespace
@@ -3,10 +3,14 @@
 #include "aethermind/backend/cpu/cpu_backend.h"
 #include "aethermind/model/model_instance.h"
 #include "aethermind/model/model_instance_builder.h"
+#include "aethermind/model/packed_weight_arena.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace {
@@ -198,15 +202,68 @@ TEST(ModelLoader_WeightPrepackPlannerTest, PrepackAndStoreSkipsDuplicateSelector
     ASSERT_TRUE(requests.ok());
     EXPECT_EQ(requests->size(), 14);
 
-    // PrepackAndStore should succeed — duplicates are skipped, not rejected.
+    // PrepackAndStore should succeed — a shared selector is not a duplicate.
     Status status = WeightPrepackPlanner::PrepackAndStore(**model, *requests);
     ASSERT_TRUE(status.ok());
 
-    // Only the first unique (op_type, selector) pair is stored.
+    // Every weight is stored under its layer and role; the selector lookup
+    // answers with the first one.
     const KernelSelector expected_selector = MakeExpectedSelector();
     const PackedWeights* found = (*model)->FindPackedWeights(
             OpType::kLinear, expected_selector);
     ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found, (*model)->FindPackedWeights(0, WeightRole::kQProj));
+    EXPECT_EQ((*model)->GetBackendSidecar().size(), 14U);
+    EXPECT_NE((*model)->FindPackedWeights(1, WeightRole::kQProj), found);
+}
+
+TEST(ModelLoader_WeightPrepackPlannerTest, PrepackAndStoreLaysWeightsOutInExecutionOrder) {
+    auto storage = std::make_shared<TestStorage>(320);
+    for (size_t i = 0; i < storage->data.size(); ++i) {
+        storage->data[i] = static_cast<std::byte>(i);
+    }
+    // Layer weights sit 4 bytes off every 64-byte boundary and are packed;
+    // lm_head starts on one and stays aliased to the checkpoint.
+    const auto address = reinterpret_cast<uintptr_t>(storage->data.data());
+    const size_t aligned = (64 - address % 64) % 64;
+
+    ResolvedModelWeights index;
+    index.embed_tokens = MakeWeightView(storage, 0, 8, DataType::Float32(), {2, 1});
+    index.final_norm = MakeWeightView(storage, 8, 8, DataType::Float32(), {2, 1});
+    index.lm_head = MakeWeightView(storage, aligned + 192, 8, DataType::Float32(), {2, 1});
+    index.layers.push_back(MakeTestLayer(storage, aligned + 4));
+    index.layers.push_back(MakeTestLayer(storage, aligned + 100));
+
+    auto model = ModelInstanceBuilder::Create(MakeLlamaConfig(2), std::move(index));
+    ASSERT_TRUE(model.ok());
+
+    CpuBackend backend;
+    KernelRegistry registry;
+    auto requests = WeightPrepackPlanner::BuildRequests(
+            (*model)->GetConfig(), (*model)->GetResolvedWeights(), backend, registry);
+    ASSERT_TRUE(requests.ok());
+    ASSERT_TRUE(WeightPrepackPlanner::PrepackAndStore(**model, *requests, 2).ok());
+
+    // Layer 0 q..down, then layer 1 q..down, one 64-byte arena slot each.
+    const std::byte* expected = nullptr;
+    for (const auto& req: *requests) {
+        const PackedWeights* packed = (*model)->FindPackedWeights(req.decoder_layer_index, req.role);
+        ASSERT_NE(packed, nullptr);
+        const auto* data = static_cast<const std::byte*>(packed->storage().data());
+        if (req.role == WeightRole::kLmHead) {
+            EXPECT_EQ(data, req.raw_weight.data);
+            EXPECT_TRUE(packed->storage().read_only());
+            continue;
+        }
+        if (expected == nullptr) {
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % PackedWeightArena::kHugePageSize, 0U);
+        } else {
+            EXPECT_EQ(data, expected);
+        }
+        EXPECT_NE(data, req.raw_weight.data);
+        EXPECT_EQ(std::memcmp(data, req.raw_weight.data, req.raw_weight.bytes), 0);
+        expected = data + PackedWeightArena::kSlotAlignment;
+    }
 }
 
 TEST(ModelLoader_WeightPrepackPlannerTest, RawViewsStillAccessibleAfterPrepack) {
@@ -237,4 +294,130 @@ TEST(ModelLoader_WeightPrepackPlannerTest, RawViewsStillAccessibleAfterPrepack)
     EXPECT_TRUE(resolved_weights.layers[0].norm.input_rmsnorm.IsValid());
 }
 
+TEST(ModelLoader_WeightPrepackPlannerTest, PrepackAliasesAlignedRawWeightsAndCopiesTheRest) {
+    auto storage = std::make_shared<TestStorage>(256);
+    // First offset whose bytes start on a 64-byte boundary.
+    const auto address = reinterpret_cast<uintptr_t>(storage->data.data());
+    const size_t aligned = (64 - address % 64) % 64;
+    std::vector<WeightPrepackPlanner::Request> requests(2);
+    requests[0] = WeightPrepackPlanner::Request{
+            .op_type = OpType::kLinear,
+            .raw_weight = MakeWeightView(storage, aligned, 8, DataType::Float32(), {2, 1}),
+            .selector = MakeExpectedSelector(),
+    };
+    // Same op and dtype, different selector: float32 bytes off the 64-byte
+    // boundary packed storage guarantees are copied.
+    requests[1] = requests[0];
+    requests[1].raw_weight = MakeWeightView(storage, aligned + 68, 8, DataType::Float32(), {2, 1});
+    requests[1].selector.isa = IsaLevel::kScalar;
+
+    auto packed = WeightPrepackPlanner::Prepack(requests, 2);
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    ASSERT_EQ(packed->size(), 2U);
+    EXPECT_EQ((*packed)[0]->storage().data(), storage->data.data() + aligned);
+    EXPECT_TRUE((*packed)[0]->storage().read_only());
+    EXPECT_NE((*packed)[1]->storage().data(), storage->data.data() + aligned + 68);
+    EXPECT_EQ((*packed)[1]->storage().nbytes(), 8U);
+
+    // The aliased artifact shares ownership of the raw storage.
+    const std::weak_ptr<TestStorage> observer = storage;
+    requests.clear();
+    storage.reset();
+    EXPECT_FALSE(observer.expired());
+    packed->clear();
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST(ModelLoader_WeightPrepackPlannerTest, BuildRequestsAppliesTheQuantizationPolicy) {
+    auto storage = std::make_shared<TestStorage>(256);
+    ResolvedModelWeights index;
+    index.embed_tokens = MakeWeightView(storage, 0, 8, DataType::Float32(), {2, 1});
+    index.final_norm = MakeWeightView(storage, 8, 8, DataType::Float32(), {2, 1});
+    index.lm_head = MakeWeightView(storage, 16, 8, DataType::Float32(), {2, 1});
+    index.layers.push_back(MakeTestLayer(storage, 24));
+    index.layers.push_back(MakeTestLayer(storage, 100));
+
+    const WeightQuantizationPolicy policy{
+            .default_config = {.scheme = WeightQuantScheme::kInt4Grouped, .group_size = 32},
+            .overrides = {
+                    {.role = WeightRole::kDownProj,
+                     .config = {.scheme = WeightQuantScheme::kInt8PerChannel}},
+                    {.decoder_layer_index = 1, .config = {}},
+            },
+    };
+    CpuBackend backend;
+    KernelRegistry registry;
+    auto requests = WeightPrepackPlanner::BuildRequests(
+            MakeLlamaConfig(2), index, backend, registry, policy);
+
+    ASSERT_TRUE(requests.ok()) << requests.status().ToString();
+    ASSERT_EQ(requests->size(), 15U);
+    const auto& q_proj = (*requests)[0];
+    EXPECT_EQ(q_proj.role, WeightRole::kQProj);
+    EXPECT_EQ(q_proj.decoder_layer_index, std::optional<uint32_t>(0));
+    EXPECT_EQ(q_proj.quantization.scheme, WeightQuantScheme::kInt4Grouped);
+    EXPECT_EQ(q_proj.selector.weight_format, WeightFormat::kQuantizedInt4);
+    EXPECT_EQ(q_proj.selector.weight_dtype, DataType::Int(4));
+
+    const auto& down_proj = (*requests)[6];
+    EXPECT_EQ(down_proj.role, WeightRole::kDownProj);
+    EXPECT_EQ(down_proj.selector.weight_format, WeightFormat::kQuantizedInt8);
+
+    // The later layer override keeps all of layer 1 at checkpoint precision.
+    for (size_t i = 7; i < 14; ++i) {
+        EXPECT_EQ((*requests)[i].decoder_layer_index, std::optional<uint32_t>(1));
+        EXPECT_EQ((*requests)[i].selector, MakeExpectedSelector());
+    }
+    const auto& lm_head = requests->back();
+    EXPECT_EQ(lm_head.role, WeightRole::kLmHead);
+    EXPECT_FALSE(lm_head.decoder_layer_index.has_value());
+    EXPECT_EQ(lm_head.selector, MakeExpectedSelector());
+
+    const WeightQuantizationPolicy invalid{
+            .default_config = {.scheme = WeightQuantScheme::kInt4Grouped, .group_size = 0}};
+    EXPECT_EQ(WeightPrepackPlanner::BuildRequests(MakeLlamaConfig(2), index, backend, registry, invalid)
+                      .status()
+                      .code(),
+              StatusCode::kInvalidArgument);
+}
+
+TEST(ModelLoader_WeightPrepackPlannerTest, PrepackQuantizesRequestsAndReportsTheirError) {
+    auto storage = std::make_shared<TestStorage>(256);
+    auto* values = reinterpret_cast<float*>(storage->data.data());
+    for (size_t i = 0; i < 8; ++i) {
+        values[i] = static_cast<float>(i) * 0.37F - 1.0F;
+    }
+    std::vector<WeightPrepackPlanner::Request> requests(2);
+    requests[0] = WeightPrepackPlanner::Request{
+            .op_type = OpType::kLinear,
+            .raw_weight = MakeWeightView(storage, 0, 32, DataType::Float32(), {2, 4}),
+            .selector = MakeExpectedSelector(),
+            .role = WeightRole::kUpProj,
+            .decoder_layer_index = 3,
+            .quantization = {.scheme = WeightQuantScheme::kInt8PerChannel},
+    };
+    requests[0].selector.weight_dtype = DataType::Int(8);
+    requests[0].selector.weight_format = WeightFormat::kQuantizedInt8;
+    requests[1] = WeightPrepackPlanner::Request{
+            .op_type = OpType::kLinear,
+            .raw_weight = MakeWeightView(storage, 0, 32, DataType::Float32(), {2, 4}),
+            .selector = MakeExpectedSelector(),
+            .role = WeightRole::kLmHead,
+    };
+
+    std::vector<WeightQuantizationReport> reports;
+    auto packed = WeightPrepackPlanner::Prepack(requests, 2, &reports);
+
+    ASSERT_TRUE(packed.ok()) << packed.status().ToString();
+    ASSERT_EQ(packed->size(), 2U);
+    EXPECT_EQ((*packed)[0]->selector().weight_format, WeightFormat::kQuantizedInt8);
+    EXPECT_EQ((*packed)[1]->storage().data(), storage->data.data());
+    ASSERT_EQ(reports.size(), 1U);
+    EXPECT_EQ(reports[0].role, WeightRole::kUpProj);
+    EXPECT_EQ(reports[0].decoder_layer_index, std::optional<uint32_t>(3));
+    EXPECT_GT(reports[0].error.max_abs_error, 0.0F);
+    EXPECT_LE(reports[0].error.max_abs_error, 1.6F / 127.0F);
+}
+
 }// namespace
@@ -10,7 +10,8 @@ using namespace aethermind;
 // KVCacheUpdate contract (matches graph_builder.cpp):
 //   k, v             : rank 2, shape [T, Hkv*D]
 //   k_cache, v_cache : rank 3, shape [Hkv, C, D]
-//   All four inputs share the same dtype in {Float32, Float16, BFloat16}.
+//   k and v share a dtype in {Float32, Float16, BFloat16}; the caches share
+//   that dtype or one quantized storage dtype in {Int8, Float8E4M3FN, Float8E5M2}.
 // Tests use Hkv=8, D=64, C=1024, T=1 (so Hkv*D=512).
 
 // Helper: build a consistent 4-input set with the given dtype and cache_len.
@@ -79,6 +80,25 @@ TEST(KVCacheUpdateInference, RejectsMismatchedKVAndCacheDtype) {
     EXPECT_FALSE(InferOperator(OpType::kKVCacheUpdate, KVCacheUpdateParams{}, inputs).ok());
 }
 
+TEST(KVCacheUpdateInference, AcceptsQuantizedCacheStorage) {
+    for (const DataType cache_dtype: {DataType::Int(8), DataType::Float8E4M3FN(), DataType::Float8E5M2()}) {
+        auto inputs = MakeConsistentInputs(DataType::Float32());
+        inputs[2] = {cache_dtype, inputs[2].shape};
+        inputs[3] = {cache_dtype, inputs[3].shape};
+        auto result = InferOperator(OpType::kKVCacheUpdate, KVCacheUpdateParams{}, inputs);
+        ASSERT_TRUE(result.ok()) << result.status().ToString();
+        EXPECT_EQ(result->outputs[0].dtype, cache_dtype);
+        EXPECT_EQ(result->outputs[1].dtype, cache_dtype);
+    }
+}
+
+TEST(KVCacheUpdateInference, RejectsMismatchedQuantizedCacheDtypes) {
+    auto inputs = MakeConsistentInputs(DataType::Float32());
+    inputs[2] = {DataType::Int(8), inputs[2].shape};
+    inputs[3] = {DataType::Float8E4M3FN(), inputs[3].shape};
+    EXPECT_FALSE(InferOperator(OpType::kKVCacheUpdate, KVCacheUpdateParams{}, inputs).ok());
+}
+
 TEST(KVCacheUpdateInference, RejectsMismatchedKAndVDtype) {
     auto inputs = MakeConsistentInputs(DataType::Float32());
     inputs[1] = {DataType::Float(16), inputs[1].shape};
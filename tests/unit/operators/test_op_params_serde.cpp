@@ -55,6 +55,8 @@ TEST(OpParamsSerde, RoundTripsEveryVariant) {
             PermuteParams{.permutation = {0}},
             PermuteParams{.permutation = {2, 0, 1}},
             PermuteParams{.permutation = {0, 0}},
+            SampleParams{},
+            SampleParams{.temperature = 0.7F, .top_k = 40, .top_p = 0.9F, .seed = 18446744073709551615ULL},
     };
 
     for (const OpParams& param: params) {
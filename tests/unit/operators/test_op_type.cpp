@@ -22,6 +22,7 @@ TEST(Operators_OpType, AllKnownTypesHaveStringRepresentation) {
     EXPECT_STREQ(ToString(OpType::kReshape), "Reshape");
     EXPECT_STREQ(ToString(OpType::kPermute), "Permute");
     EXPECT_STREQ(ToString(OpType::kReorder), "Reorder");
+    EXPECT_STREQ(ToString(OpType::kSample), "Sample");
 }
 
 TEST(Operators_OpType, InvalidValueReturnsUnknown) {
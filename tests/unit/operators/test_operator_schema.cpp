@@ -11,7 +11,7 @@ using namespace aethermind;
 TEST(OperatorSchema, ContainsAllM1Ops) {
     const auto schemas = GetOperatorSchemas();
 
-    ASSERT_EQ(schemas.size(), 16U);
+    ASSERT_EQ(schemas.size(), 17U);
     EXPECT_TRUE(GetOperatorSchema(OpType::kEmbedding).ok());
     EXPECT_TRUE(GetOperatorSchema(OpType::kRmsNorm).ok());
     EXPECT_TRUE(GetOperatorSchema(OpType::kLinear).ok());
@@ -28,6 +28,7 @@ TEST(OperatorSchema, ContainsAllM1Ops) {
     EXPECT_TRUE(GetOperatorSchema(OpType::kReshape).ok());
     EXPECT_TRUE(GetOperatorSchema(OpType::kPermute).ok());
     EXPECT_TRUE(GetOperatorSchema(OpType::kReorder).ok());
+    EXPECT_TRUE(GetOperatorSchema(OpType::kSample).ok());
 }
 
 TEST(OperatorSchema, RejectsUnknownOpType) {
@@ -138,6 +139,7 @@ TEST(OperatorSchema, ActivationOnlyOpsUseExpectedArities) {
             ExpectedArity{.op_type = OpType::kReshape, .inputs = 1, .outputs = 1},
             ExpectedArity{.op_type = OpType::kPermute, .inputs = 1, .outputs = 1},
             ExpectedArity{.op_type = OpType::kReorder, .inputs = 1, .outputs = 1},
+            ExpectedArity{.op_type = OpType::kSample, .inputs = 1, .outputs = 1},
     };
 
     for (const ExpectedArity expected: kExpected) {
@@ -193,6 +195,7 @@ TEST(OperatorSchema, RuntimeOnlyPureOpsAreNotCompileTimeEvaluable) {
             OpType::kReshape,
             OpType::kPermute,
             OpType::kReorder,
+            OpType::kSample,
     };
 
     for (const OpType op_type: kRuntimeOnlyOps) {
@@ -0,0 +1,54 @@
+#include "aethermind/operators/op_params.h"
+#include "aethermind/operators/operator_inference.h"
+#include "test_operator_inference_helpers.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+namespace {
+using namespace aethermind;
+
+TEST(SampleInference, ReducesVocabAxisToInt64Tokens) {
+    auto input = MakeSpec(DataType::Float32(), {4, 256});
+    std::vector<TensorSpec> inputs = {input};
+    auto result = InferOperator(OpType::kSample, SampleParams{.top_k = 40, .top_p = 0.9F}, inputs);
+    ASSERT_TRUE(result.ok()) << result.status().ToString();
+    ASSERT_EQ(result->outputs.size(), 1U);
+    EXPECT_EQ(result->outputs[0].dtype, DataType::Int(64));
+    ASSERT_EQ(result->outputs[0].shape.rank().value(), 1U);
+    EXPECT_EQ(result->outputs[0].shape[0].GetStaticValue(), 4);
+}
+
+TEST(SampleInference, RejectsNonFloat32Logits) {
+    auto input = MakeSpec(DataType::BFloat(16), {4, 256});
+    std::vector<TensorSpec> inputs = {input};
+    EXPECT_FALSE(InferOperator(OpType::kSample, SampleParams{}, inputs).ok());
+}
+
+TEST(SampleInference, RejectsOutOfRangeParams) {
+    auto input = MakeSpec(DataType::Float32(), {4, 256});
+    std::vector<TensorSpec> inputs = {input};
+    EXPECT_FALSE(InferOperator(OpType::kSample, SampleParams{.temperature = -1.0F}, inputs).ok());
+    EXPECT_FALSE(InferOperator(OpType::kSample,
+                               SampleParams{.temperature = std::numeric_limits<float>::infinity()},
+                               inputs)
+                         .ok());
+    // 1 / denorm_min overflows, which would turn every sampling weight into inf.
+    EXPECT_FALSE(InferOperator(OpType::kSample,
+                               SampleParams{.temperature = std::numeric_limits<float>::denorm_min()},
+                               inputs)
+                         .ok());
+    EXPECT_FALSE(InferOperator(OpType::kSample, SampleParams{.top_k = -1}, inputs).ok());
+    EXPECT_FALSE(InferOperator(OpType::kSample, SampleParams{.top_p = 0.0F}, inputs).ok());
+    EXPECT_FALSE(InferOperator(OpType::kSample, SampleParams{.top_p = 1.5F}, inputs).ok());
+    EXPECT_TRUE(InferOperator(OpType::kSample, SampleParams{.temperature = 0.0F}, inputs).ok());
+}
+
+TEST(SampleInference, RequiresSampleParams) {
+    auto input = MakeSpec(DataType::Float32(), {4, 256});
+    std::vector<TensorSpec> inputs = {input};
+    EXPECT_FALSE(InferOperator(OpType::kSample, ArgmaxParams{}, inputs).ok());
+}
+
+}// namespace
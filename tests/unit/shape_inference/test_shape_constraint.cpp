@@ -266,6 +266,45 @@ TEST(ShapeConstraintEvaluator, EvaluatesSymbolicAndRuntimeDimPositive) {
               ShapeConstraintEvaluationResult::kViolated);
 }
 
+TEST(ShapeConstraintEvaluator, DischargesDeferredConstraintsWithSolverFacts) {
+    const ShapeSymbol hidden = ShapeSymbol::Create();
+    const ShapeSymbol weight_len = ShapeSymbol::Create();
+    const ShapeSymbol seq = ShapeSymbol::Create();
+    std::vector<SymbolicShape> inputs{
+            SymbolicShape(std::vector<ShapeSymbol>{seq, hidden}),
+            SymbolicShape(std::vector<ShapeSymbol>{weight_len}),
+    };
+    const ShapeConstraint dim_equal{
+            .condition = DimEqualConstraint{.lhs = InputDim(0, 1), .rhs = InputDim(1, 0)},
+            .error_context = "hidden size mismatch",
+    };
+    const ShapeConstraint positive{
+            .condition = DimPositiveConstraint{.dim = InputDim(0, 1)},
+            .error_context = "must be positive",
+    };
+    const std::span<const SymbolicShape> in(inputs);
+
+    SymbolConstraintSolver solver;
+    EXPECT_EQ(EvaluateShapeConstraint(dim_equal, in, {}, solver),
+              ShapeConstraintEvaluationResult::kDeferred);
+
+    ASSERT_TRUE(solver.AddEqual(hidden, weight_len).ok());
+    EXPECT_EQ(EvaluateShapeConstraint(dim_equal, in, {}, solver),
+              ShapeConstraintEvaluationResult::kSatisfied);
+    EXPECT_EQ(EvaluateShapeConstraint(positive, in, {}, solver),
+              ShapeConstraintEvaluationResult::kDeferred);
+
+    ASSERT_TRUE(solver.AddEqual(weight_len, int64_t{4096}).ok());
+    EXPECT_EQ(EvaluateShapeConstraint(positive, in, {}, solver),
+              ShapeConstraintEvaluationResult::kSatisfied);
+
+    SymbolConstraintSolver conflicting;
+    ASSERT_TRUE(conflicting.AddEqual(hidden, int64_t{8}).ok());
+    ASSERT_TRUE(conflicting.AddEqual(weight_len, int64_t{16}).ok());
+    EXPECT_EQ(EvaluateShapeConstraint(dim_equal, in, {}, conflicting),
+              ShapeConstraintEvaluationResult::kViolated);
+}
+
 TEST(ShapeConstraintEvaluator, ValidateShapeConstraintsReturnsConstraintContext) {
     RuntimeTensorStorage input{std::vector<int64_t>{2, 8}};
     RuntimeTensorStorage weight{std::vector<int64_t>{16}};
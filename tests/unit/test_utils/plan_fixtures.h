@@ -0,0 +1,113 @@
+#ifndef AETHERMIND_TEST_UTILS_PLAN_FIXTURES_H
+#define AETHERMIND_TEST_UTILS_PLAN_FIXTURES_H
+
+#include "aethermind/execution/execution_plan_family.h"
+#include "aethermind/execution/runtime_binding_context.h"
+#include "aethermind/graph/compilation/graph_lowering.h"
+#include "aethermind/operators/function_operator.h"
+#include "aethermind/operators/operator_inference.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace aethermind::test_utils {
+
+/// State shared with the capture-less kernels of fake plans: the bindings a
+/// kernel reads, where it records what it observed, and a one-shot injected
+/// failure. Fixtures Attach() in SetUp and Detach() in TearDown; each
+/// observation type gets its own set of globals.
+template<typename Observation>
+struct KernelProbe {
+    static inline RuntimeBindingContext* bindings = nullptr;
+    static inline std::vector<Observation>* observed = nullptr;
+    static inline bool fail_next = false;
+
+    static void Attach(RuntimeBindingContext* probe_bindings, std::vector<Observation>* probe_observed) noexcept {
+        bindings = probe_bindings;
+        observed = probe_observed;
+        fail_next = false;
+    }
+
+    static void Detach() noexcept {
+        bindings = nullptr;
+        observed = nullptr;
+        fail_next = false;
+    }
+
+    /// True once after a test set `fail_next`.
+    static bool ConsumeFailure() noexcept {
+        return std::exchange(fail_next, false);
+    }
+};
+
+/// One-step plan that runs `fn` as an `op_type` operator.
+inline ExecutionPlan MakeSingleKernelPlan(KernelFunc fn, OpType op_type = OpType::kAttention) {
+    std::vector<ExecutionStep> steps(1);
+    steps[0].op = std::make_shared<FunctionOperator>(op_type, fn);
+    StatusOr<ExecutionPlan> plan = ExecutionPlan::Create(std::move(steps));
+    EXPECT_TRUE(plan.ok()) << plan.status().ToString();
+    return std::move(plan).value();
+}
+
+/// A one-token bucket running `single` and a [2, 4]-token bucket running
+/// `multi`, as BuildBucketed() produces with max_prefill_tokens == 4.
+inline ExecutionPlanFamily MakeTwoBucketFamily(KernelFunc single,
+                                               KernelFunc multi,
+                                               OpType op_type = OpType::kAttention) {
+    std::vector<ExecutionPlanBucket> buckets;
+    buckets.push_back({.min_tokens = 1, .max_tokens = 1, .plan = MakeSingleKernelPlan(single, op_type)});
+    buckets.push_back({.min_tokens = 2, .max_tokens = 4, .plan = MakeSingleKernelPlan(multi, op_type)});
+    StatusOr<ExecutionPlanFamily> family = ExecutionPlanFamily::Create(std::move(buckets));
+    EXPECT_TRUE(family.ok()) << family.status().ToString();
+    return std::move(family).value();
+}
+
+/// One RmsNorm step over a rank-1 activation whose only dimension is the
+/// sequence symbol. InferOperator defers two checks for it: positivity of the
+/// sequence dimension and equality with the symbolic weight length.
+struct SequenceRmsNormGraph {
+    ShapeSymbol seq_len = ShapeSymbol::Create();
+    ShapeSymbol weight_len = ShapeSymbol::Create();
+    LoweredGraph lowered{};
+};
+
+inline SequenceRmsNormGraph MakeSequenceRmsNormGraph() {
+    SequenceRmsNormGraph graph;
+    const SymbolicShape act_shape(std::vector<ShapeSymbol>{graph.seq_len});
+    const SymbolicShape weight_shape(std::vector<ShapeSymbol>{graph.weight_len});
+    std::vector<TensorSpec> inputs = {
+            TensorSpec{.dtype = DataType::Float32(), .shape = act_shape},
+            TensorSpec{.dtype = DataType::Float32(), .shape = weight_shape},
+    };
+    auto analyzed = InferOperator(OpType::kRmsNorm,
+                                  OpParams{RmsNormParams{.eps = 1.0e-5F}},
+                                  inputs);
+    EXPECT_TRUE(analyzed.ok()) << analyzed.status().ToString();
+    EXPECT_EQ(analyzed->runtime_checks.size(), 2U);
+
+    graph.lowered.steps.push_back(ExecutionPlanNodeSpec{
+            .op_type = OpType::kRmsNorm,
+            .device_type = DeviceType::kCPU,
+            .act_dtype = DataType::Float32(),
+            .weight_dtype = DataType::Float32(),
+            .input_specs = inputs,
+            .output_specs = analyzed->outputs,
+            .runtime_checks = analyzed->runtime_checks,
+            .op_params = OpParams{RmsNormParams{.eps = 1.0e-5F}},
+    });
+    graph.lowered.step_bindings.push_back(LoweredStepBinding{
+            .node = GraphNodeId{.index = 0},
+            .input_values = {GraphValueId{.index = 0}, GraphValueId{.index = 1}},
+            .output_values = {GraphValueId{.index = 2}},
+    });
+    graph.lowered.model_inputs = {GraphValueId{.index = 0}};
+    graph.lowered.model_outputs = {GraphValueId{.index = 2}};
+    return graph;
+}
+
+}// namespace aethermind::test_utils
+
+#endif// AETHERMIND_TEST_UTILS_PLAN_FIXTURES_H